@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDebug>
 #include <QDir>
 #include <QProcess>
+#include <QThread>
 #include <chrono>
 #include <ctime>
 #include <filesystem>
@@ -52,10 +53,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "ProjNavigator/tcl_command_integration.h"
 #include "TaskManager.h"
 #include "Utils/FileUtils.h"
+#include "Utils/JobPool.h"
 #include "Utils/LogUtils.h"
 #include "Utils/ProcessUtils.h"
 #include "Utils/QtUtils.h"
 #include "Utils/StringUtils.h"
+#include "Utils/Tracer.h"
 #include "scope_guard.hpp"
 
 extern FOEDAG::Session* GlobalSession;
@@ -117,9 +120,6 @@ Compiler::Compiler(TclInterpreter* interp, std::ostream* out,
       m_tclInterpreterHandler(tclInterpreterHandler) {
   if (m_tclInterpreterHandler) m_tclInterpreterHandler->setCompiler(this);
   SetConstraints(new Constraints{this});
-  IPCatalog* catalog = new IPCatalog();
-  SetIPGenerator(new IPGenerator(catalog, this));
-  m_simulator = new Simulator(m_interp, this, m_out, m_tclInterpreterHandler);
   m_netlistEditData = new NetlistEditData();
   m_name = "dummy";
 }
@@ -149,32 +149,47 @@ std::string Compiler::GetMessagePrefix() const {
 }
 
 void Compiler::SetIPGenerator(IPGenerator* generator) {
+  std::scoped_lock lock{m_subsystemsLock};
+  setIPGenerator(generator);
+}
+
+void Compiler::setIPGenerator(IPGenerator* generator) {
   m_IPGenerator = generator;
   if (m_tclCmdIntegration) m_tclCmdIntegration->setIPGenerator(m_IPGenerator);
 }
 
+void Compiler::SetSimulator(Simulator* simulator) {
+  std::scoped_lock lock{m_subsystemsLock};
+  m_simulator = simulator;
+}
+
 void Compiler::Message(const std::string& message,
                        const std::string& messagePrefix, bool raw) const {
-  if (m_out) {
+  // compile actions running concurrently have their own sinks
+  auto context = ExecutionContext::Current();
+  std::ostream* out = context ? context->Out() : m_out;
+  if (out) {
     const std::string prefix =
         messagePrefix.empty() ? GetMessagePrefix() : messagePrefix;
     if (raw) {
-      (*m_out) << prefix << message;
+      (*out) << prefix << message;
     } else {
-      (*m_out) << "INFO: " << prefix << message << std::endl;
+      (*out) << "INFO: " << prefix << message << std::endl;
     }
   }
 }
 
 void Compiler::ErrorMessage(const std::string& message, bool append,
                             const std::string& messagePrefix, bool raw) const {
-  if (m_err) {
+  auto context = ExecutionContext::Current();
+  std::ostream* err = context ? context->Err() : m_err;
+  if (err) {
     const std::string prefix =
         messagePrefix.empty() ? GetMessagePrefix() : messagePrefix;
     if (raw) {
-      (*m_err) << prefix << message;
+      (*err) << prefix << message;
     } else {
-      (*m_err) << "ERROR: " << prefix << message << std::endl;
+      (*err) << "ERROR: " << prefix << message << std::endl;
     }
   }
   if (m_interp != nullptr)
@@ -253,13 +268,7 @@ tcl_interp_clone
 
 bool Compiler::BuildLiteXIPCatalog(std::filesystem::path litexPath,
                                    bool namesOnly) {
-  if (m_IPGenerator == nullptr) {
-    IPCatalog* catalog = new IPCatalog();
-    SetIPGenerator(new IPGenerator(catalog, this));
-  }
-  if (m_simulator == nullptr) {
-    m_simulator = new Simulator(m_interp, this, m_out, m_tclInterpreterHandler);
-  }
+  GetSimulator();
   IPCatalogBuilder builder(this);
   bool result = builder.buildLiteXCatalog(GetIPGenerator()->Catalog(),
                                           litexPath, namesOnly);
@@ -313,38 +322,65 @@ static int openRunProjectImpl(void* clientData, Tcl_Interp* interp, int argc,
   return TCL_OK;
 }
 
+// stages running concurrently may be the first users of a subsystem
 Simulator* Compiler::GetSimulator() {
+  std::scoped_lock lock{m_subsystemsLock};
   if (m_simulator == nullptr) {
     m_simulator = new Simulator(m_interp, this, m_out, m_tclInterpreterHandler);
   }
   return m_simulator;
 }
 
-bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
+IPGenerator* Compiler::GetIPGenerator() {
+  std::scoped_lock lock{m_subsystemsLock};
   if (m_IPGenerator == nullptr) {
     IPCatalog* catalog = new IPCatalog();
-    SetIPGenerator(new IPGenerator(catalog, this));
-  }
-  if (m_DesignQuery == nullptr) {
-    m_DesignQuery = new DesignQuery(this);
-  }
-  if (m_simulator == nullptr) {
-    m_simulator = new Simulator(m_interp, this, m_out, m_tclInterpreterHandler);
+    setIPGenerator(new IPGenerator(catalog, this));
   }
-  m_simulator->RegisterCommands(m_interp);
-  m_IPGenerator->RegisterCommands(interp, batchMode);
-  m_DesignQuery->RegisterCommands(interp, batchMode);
+  return m_IPGenerator;
+}
+
+bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
+  // subsystems are constructed and their commands created on first use of
+  // any of the commands to keep startup short
+  m_interp->registerLazyCmds(
+      "simulator", Simulator::CommandNames(), [this]() { GetSimulator(); },
+      [this]() { m_simulator->RegisterCommands(m_interp); });
+  interp->registerLazyCmds(
+      "ip_generator", IPGenerator::CommandNames(),
+      [this]() { GetIPGenerator(); },
+      [this, interp, batchMode]() {
+        m_IPGenerator->RegisterCommands(interp, batchMode);
+      });
+  interp->registerLazyCmds(
+      "design_query", DesignQuery::CommandNames(),
+      [this]() { GetDesignQuery(); },
+      [this, interp, batchMode]() {
+        m_DesignQuery->RegisterCommands(interp, batchMode);
+      });
   if (m_constraints == nullptr) {
     SetConstraints(new Constraints{this});
   }
   if (m_configuration == nullptr) {
-    SetConfiguration(new CFGCompiler(this));
-    GetConfiguration()->RegisterCommands(interp, batchMode);
-  }
-  if (m_DeviceModeling == nullptr) {
-    m_DeviceModeling = new DeviceModeling(this);
-  }
-  m_DeviceModeling->RegisterCommands(interp, batchMode);
+    interp->registerLazyCmds(
+        "configuration", CFGCompiler::CommandNames(),
+        [this]() {
+          if (m_configuration == nullptr)
+            SetConfiguration(new CFGCompiler(this));
+        },
+        [this, interp, batchMode]() {
+          GetConfiguration()->RegisterCommands(interp, batchMode);
+        });
+  }
+  interp->registerLazyCmds(
+      "device_modeling", DeviceModeling::CommandNames(),
+      [this]() {
+        if (m_DeviceModeling == nullptr)
+          m_DeviceModeling = new DeviceModeling(this);
+      },
+      [this, interp, batchMode]() {
+        m_DeviceModeling->RegisterCommands(interp, batchMode);
+      });
 
   auto device_file = [](void* clientData, Tcl_Interp* interp, int argc,
                         const char* argv[]) -> int {
@@ -958,6 +994,136 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   };
   interp->registerCmd("verify_synth_ports", verify_synth_ports, this, nullptr);
 
+  auto telemetry = [](void* clientData, Tcl_Interp* interp, int argc,
+                      const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    TelemetryStore& store = compiler->Telemetry();
+    const std::string usage{
+        "telemetry on/off/clear/check, telemetry history ?-stage <stage>? "
+        "?-last <count>? or telemetry -window <runs> -threshold <percent>"};
+    if (argc < 2) {
+      compiler->ErrorMessage(usage);
+      return TCL_ERROR;
+    }
+    const std::string command = argv[1];
+    if (command == "history") {
+      std::string stage;
+      size_t last{0};
+      for (int i = 2; i < argc; i++) {
+        const std::string arg = argv[i];
+        if ((arg == "-stage") && (i < argc - 1)) {
+          stage = argv[++i];
+        } else if ((arg == "-last") && (i < argc - 1)) {
+          last = std::strtoul(argv[++i], 0, 10);
+        } else {
+          compiler->ErrorMessage(usage);
+          return TCL_ERROR;
+        }
+      }
+      // list of key/value lists, one per record
+      for (const auto& record : store.Read(stage, last)) {
+        std::stringstream stream;
+        stream << "run " << record.run << " time " << record.timestamp
+               << " stage " << record.stage << " success " << record.success
+               << " wall_ms " << record.wallTime << " cpu_ms "
+               << record.cpuTime << " rss_kib " << record.peakRss
+               << " read_bytes " << record.readBytes << " write_bytes "
+               << record.writeBytes;
+        for (const auto& [name, value] : record.qor)
+          stream << " " << name << " " << value;
+        Tcl_AppendElement(interp, stream.str().c_str());
+      }
+      return TCL_OK;
+    }
+    if (command == "check") {
+      // most recent record of every stage against its baseline
+      std::map<std::string, TelemetryRecord> latest;
+      for (auto& record : store.Read()) latest[record.stage] = record;
+      size_t count{0};
+      for (const auto& [stage, record] : latest) {
+        if (!record.success) continue;
+        for (const auto& flag : store.Check(record)) {
+          compiler->Message(stage + " run " + std::to_string(record.run) +
+                            ": " + TelemetryStore::ToString(flag));
+          count++;
+        }
+      }
+      Tcl_SetResult(interp, (char*)std::to_string(count).c_str(),
+                    TCL_VOLATILE);
+      return TCL_OK;
+    }
+    for (int i = 1; i < argc; i++) {
+      const std::string arg = argv[i];
+      if (arg == "on") {
+        store.Enabled(true);
+      } else if (arg == "off") {
+        store.Enabled(false);
+      } else if (arg == "clear") {
+        store.Clear();
+      } else if ((arg == "-window") && (i < argc - 1)) {
+        store.Window(std::strtoul(argv[++i], 0, 10));
+      } else if ((arg == "-threshold") && (i < argc - 1)) {
+        store.Threshold(std::strtod(argv[++i], 0));
+      } else {
+        compiler->ErrorMessage(usage);
+        return TCL_ERROR;
+      }
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("telemetry", telemetry, this, nullptr);
+
+  auto perf_trace = [](void* clientData, Tcl_Interp* interp, int argc,
+                       const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    Tracer* tracer = Tracer::Instance();
+    const std::string usage{
+        "perf_trace on ?-memory <ms>?, perf_trace off, perf_trace clear or "
+        "perf_trace dump <file>"};
+    const std::string command = argc > 1 ? argv[1] : "";
+    if (command == "on") {
+      uint32_t interval{100};
+      for (int i = 2; i < argc; i++) {
+        const std::string arg = argv[i];
+        if ((arg == "-memory") && (i < argc - 1)) {
+          interval = std::strtoul(argv[++i], 0, 10);
+        } else {
+          compiler->ErrorMessage(usage);
+          return TCL_ERROR;
+        }
+      }
+      tracer->Enable(interval);
+      if (compiler->TclInterp()) compiler->TclInterp()->traceCmds(true);
+      return TCL_OK;
+    }
+    if (command == "off" && argc == 2) {
+      if (compiler->TclInterp()) compiler->TclInterp()->traceCmds(false);
+      tracer->Disable();
+      return TCL_OK;
+    }
+    if (command == "clear" && argc == 2) {
+      tracer->Clear();
+      return TCL_OK;
+    }
+    if (command == "dump") {
+      if (argc != 3) {
+        compiler->ErrorMessage(usage);
+        return TCL_ERROR;
+      }
+      if (!tracer->Write(argv[2])) {
+        compiler->ErrorMessage(std::string{"Failed to write trace "} +
+                               argv[2]);
+        return TCL_ERROR;
+      }
+      Tcl_SetResult(interp, (char*)std::to_string(tracer->EventCount()).c_str(),
+                    TCL_VOLATILE);
+      return TCL_OK;
+    }
+    compiler->ErrorMessage(usage);
+    return TCL_ERROR;
+  };
+  interp->registerCmd("perf_trace", perf_trace, this, nullptr);
+
   // Long runtime commands have to have different scheduling in batch and GUI
   // modes
   if (batchMode) {
@@ -968,6 +1134,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
         std::string arg = argv[i];
         if (arg == "clean") {
           compiler->IPGenOpt(Compiler::IPGenerateOpt::Clean);
+        } else if (arg == "-jobs") {
+          if (!compiler->IPGenJobs(++i < argc ? argv[i] : "")) return TCL_ERROR;
         } else {
           compiler->ErrorMessage("Unknown option: " + arg);
         }
@@ -1295,6 +1463,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
                 "'-modules' tag");
             return TCL_ERROR;
           }
+        } else if (arg == "-jobs") {
+          if (!compiler->IPGenJobs(++i < argc ? argv[i] : "")) return TCL_ERROR;
         } else {
           compiler->ErrorMessage("Unknown option: " + arg);
         }
@@ -1882,6 +2052,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
         compiler->ErrorMessage("IP name missed.");
         return TCL_ERROR;
       }
+      // IP generator may not be constructed yet, there are no IPs then
+      compiler->GetIPGenerator();
       for (int i = 1; i < argc; i++) {
         std::stringstream out;
         const std::string ipName = argv[i];
@@ -2176,10 +2348,10 @@ bool Compiler::HasInternalError() const {
 }
 
 void Compiler::SetError(const std::string& message) {
-  m_errorState = ErrorState{message};
+  Context().SetError(message);
 }
 
-void Compiler::ResetError() { m_errorState = ErrorState{}; }
+void Compiler::ResetError() { Context().ResetError(); }
 
 std::filesystem::path Compiler::FilePath(Action action) const {
   if (!ProjManager()) return {};
@@ -2237,7 +2409,11 @@ std::vector<std::string> Compiler::TopModules(
   return topModules;
 }
 
-DesignQuery* Compiler::GetDesignQuery() { return m_DesignQuery; }
+DesignQuery* Compiler::GetDesignQuery() {
+  std::scoped_lock lock{m_subsystemsLock};
+  if (m_DesignQuery == nullptr) m_DesignQuery = new DesignQuery(this);
+  return m_DesignQuery;
+}
 
 void Compiler::Compile2bits(bool compile2bits) {
   m_compile2bits = compile2bits;
@@ -2278,6 +2454,42 @@ void Compiler::ClbPackingOption(ClbPacking clbPacking) {
 
 ClbPacking Compiler::ClbPackingOption() const { return m_clbPacking; }
 
+// name of the flow stage, nullptr for actions running no tool
+static const char* stageName(Compiler::Action action) {
+  switch (action) {
+    case Compiler::Action::IPGen:
+      return "ipgenerate";
+    case Compiler::Action::Analyze:
+      return "analyze";
+    case Compiler::Action::Synthesis:
+      return "synthesis";
+    case Compiler::Action::Pack:
+      return "packing";
+    case Compiler::Action::Global:
+      return "global_placement";
+    case Compiler::Action::Placement:
+      return "placement";
+    case Compiler::Action::Routing:
+      return "routing";
+    case Compiler::Action::STA:
+      return "sta";
+    case Compiler::Action::Power:
+      return "power";
+    case Compiler::Action::Bitstream:
+      return "bitstream";
+    case Compiler::Action::SimulateRTL:
+      return "simulate_rtl";
+    case Compiler::Action::SimulateGate:
+      return "simulate_gate";
+    case Compiler::Action::SimulatePNR:
+      return "simulate_pnr";
+    case Compiler::Action::SimulateBitstream:
+      return "simulate_bitstream";
+    default:
+      return nullptr;
+  }
+}
+
 bool Compiler::Compile(Action action) {
   uint task{toTaskId(static_cast<int>(action), this)};
   if (m_stop) {
@@ -2288,22 +2500,128 @@ bool Compiler::Compile(Action action) {
     return false;
   }
   ResetStopFlag();
+  const char* stage = stageName(action);
+  if (stage) {
+    std::scoped_lock lock{m_contextsLock};
+    if (!m_runningActions.insert(action).second) {
+      ErrorMessage(std::string{stage} + " is already running");
+      return false;
+    }
+  }
+  auto running = sg::make_scope_guard([this, action, stage]() {
+    if (!stage) return;
+    std::scoped_lock lock{m_contextsLock};
+    m_runningActions.erase(action);
+  });
   bool res{false};
   if (task != TaskManager::invalid_id && m_taskManager) {
     m_taskManager->task(task)->setStatus(TaskStatus::InProgress);
     m_taskManager->task(task)->setEnable(true);
   }
-  m_utils = {};
+  ProcessUtilization utils{};
+  ProcessUtilization total{};
+  TraceScope scope{stage ? stage : "compile", "compiler"};
+  const auto start = std::chrono::steady_clock::now();
   res = SwitchCompileContext(
-      action, [this, action]() { return RunCompileTask(action); });
+      action, [this, action]() { return RunCompileTask(action); }, &utils,
+      &total);
+  const auto wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  RecordTelemetry(action, res, wallTime.count(), total);
   if (task != TaskManager::invalid_id && m_taskManager) {
     m_taskManager->task(task)->setStatus(res ? TaskStatus::Success
                                              : TaskStatus::Fail);
-    if (res) m_taskManager->task(task)->setUtilization(m_utils);
+    if (res) m_taskManager->task(task)->setUtilization(utils);
   }
   return res;
 }
 
+TelemetryStore& Compiler::Telemetry() {
+  std::filesystem::path file;
+  if (ProjManager() && !ProjManager()->projectPath().empty()) {
+    file = fs::path{ProjManager()->projectPath()} /
+           (ProjManager()->projectName() + ".telemetry");
+  }
+  m_telemetry.File(file);
+  return m_telemetry;
+}
+
+void Compiler::RecordTelemetry(Action action, bool success, uint wallTime,
+                               const ProcessUtilization& total) {
+  const char* stage = stageName(action);
+  // clean and up to date actions run no tool, they would skew the baseline
+  if (!m_telemetry.Enabled() || !stage || total.duration == 0) return;
+  std::unique_lock lock{m_telemetryLock};
+  TelemetryStore& store = Telemetry();
+  if (store.File().empty()) return;
+  // flow starts over when action doesn't follow the previous one
+  if (m_telemetryRun == 0 || action <= m_telemetryAction)
+    m_telemetryRun = store.NextRun();
+  m_telemetryAction = action;
+
+  TelemetryRecord record;
+  record.run = m_telemetryRun;
+  record.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+  record.stage = stage;
+  record.success = success;
+  record.wallTime = wallTime;
+  record.cpuTime = total.cpuTime;
+  record.peakRss = total.peakRss;
+  record.readBytes = total.readBytes;
+  record.writeBytes = total.writeBytes;
+  if (success) record.qor = TelemetryQoR(action);
+  std::string error;
+  if (!store.Append(record, &error)) {
+    lock.unlock();
+    Message("WARNING: " + error);
+    return;
+  }
+  const auto flags = success ? store.Check(record)
+                             : std::vector<TelemetryFlag>{};
+  lock.unlock();
+  for (const auto& flag : flags)
+    Message("WARNING: " + record.stage + " " + TelemetryStore::ToString(flag));
+}
+
+std::map<std::string, double> Compiler::TelemetryQoR(Action action) const {
+  std::map<std::string, double> qor;
+  const uint task{toTaskId(static_cast<int>(action), this)};
+  if (!m_taskManager || task == TaskManager::invalid_id) return qor;
+  auto manager =
+      m_taskManager->getReportManagerRegistry().getReportManager(task);
+  if (!manager) return qor;
+  auto collect = [&qor, manager]() {
+    manager->getMessages();  // parses log if needed
+    const Resources used = manager->usedResources();
+    auto add = [&qor](const std::string& name, double value) {
+      if (value != 0) qor[name] = value;
+    };
+    add("lut", used.logic.lut5 + used.logic.lut6);
+    add("ff", used.logic.dff);
+    add("bram", used.bram.bram_18k + used.bram.bram_36k);
+    add("dsp", used.dsp.dsp_9_10 + used.dsp.dsp_18_20);
+    add("io", used.inouts.io);
+    // single value or "clock:fmax" list, worst clock counts
+    double fmax{0};
+    for (const auto& clock : manager->FMax().split(", ", Qt::SkipEmptyParts)) {
+      const double value = clock.section(':', -1).toDouble();
+      if (value != 0 && (fmax == 0 || value < fmax)) fmax = value;
+    }
+    add("fmax", fmax);
+  };
+  // report managers belong to GUI thread, main thread is blocked in batch mode
+  const bool gui = GetSession() && (GetSession()->CmdLine()->WithQt() ||
+                                    GetSession()->CmdLine()->WithQml());
+  if (gui && QThread::currentThread() != manager->thread())
+    QMetaObject::invokeMethod(manager.get(), collect,
+                              Qt::BlockingQueuedConnection);
+  else
+    collect();
+  return qor;
+}
+
 void Compiler::GenerateReport(int action) {
   Action act = static_cast<Action>(action);
   auto files = FileUtils::FindFilesByExtension(FilePath(act), ".rpt");
@@ -2360,11 +2678,19 @@ void Compiler::GenerateReport(int action) {
 void Compiler::Stop() {
   m_stop = true;
   ErrorMessage("Interrupted by user");
-  if (m_process) m_process->terminate();
+  m_context.Stop();
+  {
+    std::scoped_lock lock{m_contextsLock};
+    for (auto context : m_contexts) context->Stop();
+  }
+  JobPool::StopAll();
   FileUtils::terminateSystemCommand();
 }
 
-void Compiler::ResetStopFlag() { m_stop = false; }
+void Compiler::ResetStopFlag() {
+  m_stop = false;
+  m_context.ResetStop();
+}
 
 bool Compiler::Analyze() {
   if (!m_projManager->HasDesign()) {
@@ -2379,8 +2705,7 @@ bool Compiler::Analyze() {
   }
   Message("Analyzing design: " + m_projManager->projectName());
 
-  auto currentPath = std::filesystem::current_path();
-  auto it = std::filesystem::directory_iterator{currentPath};
+  auto it = std::filesystem::directory_iterator{Context().WorkingDir()};
   for (int i = 0; i < 100; i = i + 10) {
     std::stringstream outStr;
     outStr << std::setw(2) << i << "%";
@@ -2420,8 +2745,7 @@ bool Compiler::Synthesize() {
   for (auto keep : m_constraints->GetKeeps()) {
     Message("Keep name: " + keep);
   }
-  auto currentPath = std::filesystem::current_path();
-  auto it = std::filesystem::directory_iterator{currentPath};
+  auto it = std::filesystem::directory_iterator{Context().WorkingDir()};
   for (int i = 0; i < 100; i = i + 10) {
     std::stringstream outStr;
     outStr << std::setw(2) << i << "%";
@@ -2500,7 +2824,14 @@ void Compiler::finish() {
 }
 
 bool Compiler::RunCompileTask(Action action) {
-  auto currentTask = m_taskManager->currentTask();
+  // task of this action, the current task belongs to the last started one
+  const Task* currentTask{nullptr};
+  if (m_taskManager) {
+    const uint task{toTaskId(static_cast<int>(action), this)};
+    currentTask = (task != TaskManager::invalid_id)
+                      ? m_taskManager->task(task)
+                      : m_taskManager->currentTask();
+  }
   // Use Scope Guard to add headers to new logs whenever this function exits
   auto guard = sg::make_scope_guard([this, currentTask, action] {
     AddHeadersToLogs(action);
@@ -2547,7 +2878,7 @@ bool Compiler::RunCompileTask(Action action) {
           Simulator::SimulationType::BitstreamBackDoor,
           GetSimulator()->GetSimulatorType(), m_waveformFile);
     case Action::Configuration:
-      return GetConfiguration()->Configure();
+      return GetConfiguration() && GetConfiguration()->Configure();
     default:
       break;
   }
@@ -2555,22 +2886,46 @@ bool Compiler::RunCompileTask(Action action) {
 }
 
 bool Compiler::SwitchCompileContext(Action action,
-                                    const std::function<bool()>& fn) {
+                                    const std::function<bool()>& fn,
+                                    ProcessUtilization* utils,
+                                    ProcessUtilization* total) {
   auto compilePath = FilePath(action);
-  auto current_path = fs::current_path();
-  if (!compilePath.empty()) {
-    // make sure path exists
-    bool ok = FileUtils::MkDirs(compilePath);
-    if (ok) {
-      // switch actions context here
-      std::filesystem::current_path(compilePath);
-    }
-  }
+  if (compilePath.empty() && ProjManager())
+    compilePath = ProjManager()->projectPath();
+  // make sure path exists
+  if (!compilePath.empty()) FileUtils::MkDirs(compilePath);
+  ExecutionContext context{compilePath, m_out, m_err};
+  for (const auto& [name, value] : m_environmentVariableMap)
+    context.SetEnvironmentVariable(name, value);
+  RegisterContext(&context);
+  auto guard =
+      sg::make_scope_guard([this, &context]() { UnregisterContext(&context); });
+  ExecutionContext::Scope scope{context};
   auto res = fn();
-  if (!compilePath.empty()) fs::current_path(current_path);
+  if (utils) *utils = context.Utilization();
+  if (total) *total = context.TotalUtilization();
   return res;
 }
 
+void Compiler::RegisterContext(ExecutionContext* context) {
+  std::scoped_lock lock{m_contextsLock};
+  m_contexts.insert(context);
+  // Stop() came before the context was known
+  if (m_stop) context->Stop();
+}
+
+void Compiler::UnregisterContext(ExecutionContext* context) {
+  std::scoped_lock lock{m_contextsLock};
+  m_contexts.erase(context);
+}
+
+ExecutionContext& Compiler::Context() {
+  auto context = ExecutionContext::Current();
+  if (context) return *context;
+  m_context.Sinks(m_out, m_err);
+  return m_context;
+}
+
 void Compiler::setTaskManager(TaskManager* newTaskManager) {
   m_taskManager = newTaskManager;
   if (m_taskManager) {
@@ -2634,7 +2989,8 @@ void Compiler::setGuiTclSync(TclCommandIntegration* tclCommands) {
   m_tclCmdIntegration = tclCommands;
   if (m_tclCmdIntegration) {
     m_projManager = m_tclCmdIntegration->GetProjectManager();
-    m_tclCmdIntegration->setIPGenerator(GetIPGenerator());
+    // IP generator is passed on when it is constructed
+    m_tclCmdIntegration->setIPGenerator(m_IPGenerator);
   }
 }
 
@@ -2644,6 +3000,16 @@ TclCommandIntegration* Compiler::GuiTclSync() const {
   return m_tclCmdIntegration;
 }
 
+bool Compiler::IPGenJobs(const std::string& jobs) {
+  auto [value, ok] = StringUtils::to_number<uint32_t>(jobs);
+  if (!ok) {
+    ErrorMessage("Incorrect syntax for ipgenerate -jobs <num>, got: " + jobs);
+    return false;
+  }
+  GetIPGenerator()->Jobs(value);
+  return true;
+}
+
 bool Compiler::IPGenerate() {
   if (!m_projManager->HasDesign()) {
     ErrorMessage("No design specified");
@@ -2872,128 +3238,33 @@ void Compiler::SetConstraints(Constraints* c) {
 void Compiler::SetEnvironmentVariable(const std::string variable,
                                       const std::string value) {
   m_environmentVariableMap.emplace(variable, value);
+  Context().SetEnvironmentVariable(variable, value);
 }
 
 int Compiler::ExecuteAndMonitorSystemCommand(
     const std::string& command, const std::string logFile, bool appendLog,
     const std::filesystem::path& workingDir) {
-  if (m_errorState) {
-    ErrorMessage(m_errorState.message);
-    ResetError();
+  ExecutionContext& context = Context();
+  if (context.HasError()) {
+    ErrorMessage(context.Error());
+    context.ResetError();
     return -1;
   }
-  auto start = Time::now();
   PERF_LOG("Command: " + command);
-  (*m_out) << "Command: " << command << std::endl;
-  std::error_code ec;
-  auto path = std::filesystem::current_path();  // getting path
-  std::filesystem::current_path(
-      workingDir.empty() ? fs::path{ProjManager()->projectPath()} : workingDir,
-      ec);  // setting path
-  // new QProcess must be created here to avoid issues related to creating
-  // QObjects in different threads
-  m_process = new QProcess;
-  if (!workingDir.empty()) {
-    m_process->setWorkingDirectory(QString::fromStdString(workingDir.string()));
-    FileUtils::MkDirs(workingDir);
-  }
-  QStringList env = QProcess::systemEnvironment();
-  if (!m_environmentVariableMap.empty()) {
-    for (std::map<std::string, std::string>::iterator itr =
-             m_environmentVariableMap.begin();
-         itr != m_environmentVariableMap.end(); itr++) {
-      env << strdup(((*itr).first + "=" + (*itr).second).c_str());
-    }
-  }
-  m_process->setEnvironment(env);
-  std::ofstream ofs;
-  if (!logFile.empty()) {
-    std::ios_base::openmode openMode{std::ios_base::out};
-    if (appendLog) openMode = std::ios_base::out | std::ios_base::app;
-    ofs.open(logFile, openMode);
-    QObject::connect(m_process, &QProcess::readyReadStandardOutput,
-                     [this, &ofs]() {
-                       qint64 bytes = m_process->bytesAvailable();
-                       QByteArray bufout = m_process->readAllStandardOutput();
-                       ofs.write(bufout, bytes);
-                       m_out->write(bufout, bytes);
-                     });
-    QObject::connect(m_process, &QProcess::readyReadStandardError,
-                     [this, &ofs]() {
-                       QByteArray data = m_process->readAllStandardError();
-                       int bytes = data.size();
-                       ofs.write(data, bytes);
-                       m_err->write(data, bytes);
-                     });
-  } else {
-    QObject::connect(m_process, &QProcess::readyReadStandardOutput, [this]() {
-      m_out->write(m_process->readAllStandardOutput(),
-                   m_process->bytesAvailable());
-    });
-    QObject::connect(m_process, &QProcess::readyReadStandardError, [this]() {
-      QByteArray data = m_process->readAllStandardError();
-      m_err->write(data, data.size());
-    });
-  }
-  ProcessUtils utils;
-  QObject::connect(m_process, &QProcess::started,
-                   [&utils, this]() { utils.Start(m_process->processId()); });
-
-  QString cmd{command.c_str()};
-  QStringList args = QtUtils::StringSplit(cmd, ' ');
-  QStringList adjustedArgs;
-
-  QString program = args.first();
-  args.pop_front();  // remove program
-  QString current_arg;
-  for (int i = 0; i < args.size(); i++) {
-    QString arg = args[i];
-    if (args[i].front() == '\"' &&
-        args[i].back() != '\"') {      // Starting single-quote
-      current_arg = arg.remove(0, 1);  // remove leading quote
-    } else if (args[i].front() != '\"' &&
-               args[i].back() == '\"') {    // Ending single-quote
-      current_arg += " " + arg.chopped(1);  // remove trailing quote
-      adjustedArgs.push_back(current_arg);
-      current_arg = "";
-    } else if (args[i].front() == '\"' &&
-               args[i].back() == '\"') {  // Single-quoted argument
-      current_arg += " " + arg;
-      adjustedArgs.push_back(current_arg);
-      current_arg = "";
-    } else if (!current_arg.isEmpty()) {  // Continuing single-quoted argument
-      current_arg += " " + arg;
-    } else {  // Non-quoted argument
-      adjustedArgs.push_back(arg);
-    }
-  }
-
-  m_process->start(program, adjustedArgs);
-  std::filesystem::current_path(path);
-  m_process->waitForFinished(-1);
-  utils.Stop();
-  // DEBUG: (*m_out) << "Changed path to: " << (path).string() << std::endl;
-  uint max_utiliation{utils.Utilization()};
-  auto status = m_process->exitStatus();
-  auto exitCode = m_process->exitCode();
-  delete m_process;
-  m_process = nullptr;
-  if (!logFile.empty()) {
-    ofs.close();
-  }
-  auto end = Time::now();
-  auto fs = end - start;
-  ms d = std::chrono::duration_cast<ms>(fs);
+  fs::path dir = workingDir;
+  if (dir.empty() && ProjManager()) dir = ProjManager()->projectPath();
+  // project paths are relative to the process directory, it is never changed
+  if (!dir.empty()) dir = fs::absolute(dir);
+  const int status = context.Execute(command, logFile, appendLog, dir);
+  const ProcessUtilization utils = context.Utilization();
   std::stringstream stream;
-  stream << "Duration: " << d.count() << " ms. Max utilization: ";
-  if (max_utiliation <= 1024)
-    stream << max_utiliation << " kiB";
+  stream << "Duration: " << utils.duration << " ms. Max utilization: ";
+  if (utils.utilization <= 1024)
+    stream << utils.utilization << " kiB";
   else
-    stream << max_utiliation / 1024 << " MB";
-  m_utils.utilization = max_utiliation;
-  m_utils.duration = d.count();
+    stream << utils.utilization / 1024 << " MB";
   PERF_LOG(stream.str());
-  return (status == QProcess::NormalExit) ? exitCode : -1;
+  return status;
 }
 
 std::string Compiler::ReplaceAll(std::string_view str, std::string_view from,
@@ -45,14 +45,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <unistd.h>
 #endif
 
+#include <atomic>
 #include <filesystem>
 #include <iostream>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "Command/Command.h"
 #include "Command/CommandStack.h"
+#include "Compiler/ExecutionContext.h"
+#include "Compiler/TelemetryStore.h"
 #include "IPGenerate/IPGenerator.h"
 #include "Main/CommandLine.h"
 #include "NetlistEditData.h"
@@ -192,8 +197,9 @@ class Compiler {
   void SetParserType(ParserType type) { m_parserType = type; }
   ParserType GetParserType() { return m_parserType; }
   void SetIPGenerator(IPGenerator* generator);
-  IPGenerator* GetIPGenerator() { return m_IPGenerator; }
-  void SetSimulator(Simulator* simulator) { m_simulator = simulator; }
+  // subsystems are constructed on first use, thread safe
+  IPGenerator* GetIPGenerator();
+  void SetSimulator(Simulator* simulator);
   Simulator* GetSimulator();
 
   bool BuildLiteXIPCatalog(std::filesystem::path litexPath,
@@ -261,6 +267,7 @@ class Compiler {
 
   const std::string& IPGenMoreOpt() { return m_ipGenMoreOpt; }
   void IPGenMoreOpt(const std::string& opt) { m_ipGenMoreOpt = opt; }
+  bool IPGenJobs(const std::string& jobs);
 
   void PnROpt(const std::string& opt) { m_pnrOpt = opt; }
   const std::string& PnROpt() { return m_pnrOpt; }
@@ -309,6 +316,20 @@ class Compiler {
       const std::string& command, const std::string logFile = std::string{},
       bool appendLog = false, const fs::path& workingDir = {});
 
+  /*!
+   * \brief Context
+   * \return execution context of the compile action running in the calling
+   * thread or the compiler default context outside of compile actions.
+   */
+  ExecutionContext& Context();
+
+  /*!
+   * \brief Telemetry
+   * \return per-stage performance history of the current project. When
+   * enabled with 'telemetry on', every compile action appends one record.
+   */
+  TelemetryStore& Telemetry();
+
   void ProgrammerToolExecPath(const std::filesystem::path& path) {
     m_programmerToolExecutablePath = path;
   }
@@ -378,9 +399,26 @@ class Compiler {
       bool cleanup = false);
 
   /* Compiler class utilities */
+  // caller holds m_subsystemsLock
+  void setIPGenerator(IPGenerator* generator);
   bool RunBatch();
   bool RunCompileTask(Action action);
-  bool SwitchCompileContext(Action action, const std::function<bool(void)>& fn);
+  /*!
+   * \brief SwitchCompileContext
+   * Run \a fn with a new execution context bound to the calling thread. The
+   * context working directory is the \a action directory. \a utils receives
+   * utilization of the last command the context executed, \a total of all
+   * of them.
+   */
+  bool SwitchCompileContext(Action action, const std::function<bool(void)>& fn,
+                            ProcessUtilization* utils = nullptr,
+                            ProcessUtilization* total = nullptr);
+  // registered context is stopped by Stop(), thread safe
+  void RegisterContext(ExecutionContext* context);
+  void UnregisterContext(ExecutionContext* context);
+  void RecordTelemetry(Action action, bool success, uint wallTime,
+                       const ProcessUtilization& total);
+  std::map<std::string, double> TelemetryQoR(Action action) const;
 
   void SetEnvironmentVariable(const std::string variable,
                               const std::string value);
@@ -412,8 +450,9 @@ class Compiler {
   TclInterpreter* m_interp = nullptr;
   Session* m_session = nullptr;
   class ProjectManager* m_projManager = nullptr;
-  bool m_stop = false;
-  State m_state = State::None;
+  // shared by compile actions running concurrently
+  std::atomic_bool m_stop{false};
+  std::atomic<State> m_state{State::None};
   std::ostream* m_out = &std::cout;
   std::ostream* m_err = &std::cerr;
   std::string m_batchScript;
@@ -459,12 +498,13 @@ class Compiler {
   std::string m_mapToTechnology;
   bool m_bitstreamEnabled = true;
   bool m_pin_constraintEnabled = true;
-  class QProcess* m_process = nullptr;
   class DeviceModeling* m_DeviceModeling = nullptr;
   // Sub engines
   IPGenerator* m_IPGenerator = nullptr;
   Simulator* m_simulator = nullptr;
   class DesignQuery* m_DesignQuery = nullptr;
+  // guards construction of the sub engines above
+  std::mutex m_subsystemsLock;
   CFGCompiler* m_configuration = nullptr;
   // Error message severity
   std::map<std::string, MsgSeverity> m_severityMap;
@@ -481,8 +521,18 @@ class Compiler {
   std::filesystem::path m_programmerToolExecutablePath{};
   std::filesystem::path m_configFileSearchDir{};
   std::string m_name;
-  ProcessUtilization m_utils;
-  struct ErrorState m_errorState;
+  // used outside of compile actions
+  ExecutionContext m_context{{}};
+  // contexts of running compile actions, Stop() terminates them
+  std::mutex m_contextsLock;
+  std::set<ExecutionContext*> m_contexts;
+  // an action never runs twice at the same time, its stage state is shared
+  std::set<Action> m_runningActions;
+  std::mutex m_telemetryLock;
+  TelemetryStore m_telemetry;
+  // run of the last recorded action, stages of one flow share the run
+  uint32_t m_telemetryRun{0};
+  Action m_telemetryAction{Action::NoAction};
   bool m_compile2bits{false};
   std::filesystem::path m_deviceFile{};
   bool m_deviceFileLocal{false};
@@ -35,6 +35,7 @@
 #include "Configuration/CFGCommon/CFGCommon.h"
 #include "Log.h"
 #include "Main/Settings.h"
+#include "NewProject/ProjectManager/DeviceCatalog.h"
 #include "NewProject/ProjectManager/config.h"
 #include "NewProject/ProjectManager/project_manager.h"
 #include "ProjNavigator/tcl_command_integration.h"
@@ -502,6 +503,180 @@ bool CompilerOpenFPGA::RegisterCommands(TclInterpreter* interp,
   };
   interp->registerCmd("use_vpr_latest", use_vpr_latest, this, 0);
 
+  auto rr_graph_cache = [](void* clientData, Tcl_Interp* interp, int argc,
+                           const char* argv[]) -> int {
+    CompilerOpenFPGA* compiler = (CompilerOpenFPGA*)clientData;
+    RRGraphCache& cache = compiler->RoutingGraphCache();
+    const std::string usage{
+        "rr_graph_cache on/off/clear/info or rr_graph_cache -dir <path> "
+        "-max_entries <count> -max_size <MB>"};
+    if (argc < 2) {
+      compiler->ErrorMessage(usage);
+      return TCL_ERROR;
+    }
+    for (int i = 1; i < argc; i++) {
+      const std::string arg = argv[i];
+      if (arg == "on") {
+        cache.Enabled(true);
+      } else if (arg == "off") {
+        cache.Enabled(false);
+      } else if (arg == "clear") {
+        auto count = cache.Clear();
+        compiler->Message("Removed " + std::to_string(count) +
+                          " cached routing graph(s)");
+      } else if (arg == "info") {
+        auto stats = cache.Statistics();
+        compiler->Message(
+            "Routing graph cache: " +
+            std::string{cache.Enabled() ? "on" : "off"} + ", " +
+            cache.Directory().string() + ", " + std::to_string(stats.entries) +
+            " entries, " + std::to_string(stats.sizeBytes / (1024 * 1024)) +
+            " MB");
+      } else if ((arg == "-dir") && (i < argc - 1)) {
+        cache.Directory(fs::absolute(argv[++i]));
+      } else if ((arg == "-max_entries") && (i < argc - 1)) {
+        cache.MaxEntries(std::strtoul(argv[++i], 0, 10));
+        cache.Evict();
+      } else if ((arg == "-max_size") && (i < argc - 1)) {
+        cache.MaxSizeBytes(std::strtoull(argv[++i], 0, 10) * 1024 * 1024);
+        cache.Evict();
+      } else {
+        compiler->ErrorMessage(usage);
+        return TCL_ERROR;
+      }
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("rr_graph_cache", rr_graph_cache, this, 0);
+
+  auto sta_session = [](void* clientData, Tcl_Interp* interp, int argc,
+                        const char* argv[]) -> int {
+    CompilerOpenFPGA* compiler = (CompilerOpenFPGA*)clientData;
+    StaSession& session = compiler->TimingSession();
+    const std::string usage{
+        "sta_session on/off/stop/info or sta_session -timeout <ms> or "
+        "sta_session query <command>"};
+    if (argc < 2) {
+      compiler->ErrorMessage(usage);
+      return TCL_ERROR;
+    }
+    if (std::string{argv[1]} == "query") {
+      if (argc < 3) {
+        compiler->ErrorMessage(usage);
+        return TCL_ERROR;
+      }
+      if (!compiler->ProjManager()->HasDesign()) {
+        compiler->ErrorMessage("Create a design first: create_design <name>");
+        return TCL_ERROR;
+      }
+      // several words are quoted back into one command
+      std::string command = argv[2];
+      if (argc > 3) {
+        char* words = Tcl_Merge(argc - 2, argv + 2);
+        command = words;
+        Tcl_Free(words);
+      }
+      std::string report;
+      std::string error;
+      if (!compiler->LoadTimingSession(&error) ||
+          !session.Query(command, report, &error)) {
+        compiler->ErrorMessage(error);
+        return TCL_ERROR;
+      }
+      compiler->TclInterp()->setResult(report);
+      return TCL_OK;
+    }
+    for (int i = 1; i < argc; i++) {
+      const std::string arg = argv[i];
+      if (arg == "on") {
+        compiler->TimingSessionEnabled(true);
+      } else if (arg == "off") {
+        compiler->TimingSessionEnabled(false);
+        session.Stop();
+      } else if (arg == "stop") {
+        session.Stop();
+      } else if (arg == "info") {
+        auto stats = session.Statistics();
+        compiler->Message(
+            "STA session: " +
+            std::string{compiler->TimingSessionEnabled() ? "on" : "off"} +
+            ", " + (session.Running() ? "running" : "stopped") + ", " +
+            std::to_string(stats.starts) + " starts, " +
+            std::to_string(stats.links) + " links, " +
+            std::to_string(stats.sdfReads) + " SDF reads, " +
+            std::to_string(stats.queries) + " queries");
+      } else if ((arg == "-timeout") && (i < argc - 1)) {
+        session.Timeout(std::strtoul(argv[++i], 0, 10));
+      } else {
+        compiler->ErrorMessage(usage);
+        return TCL_ERROR;
+      }
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("sta_session", sta_session, this, 0);
+
+  auto timing_corners = [](void* clientData, Tcl_Interp* interp, int argc,
+                           const char* argv[]) -> int {
+    CompilerOpenFPGA* compiler = (CompilerOpenFPGA*)clientData;
+    TimingCornerAnalysis& corners = compiler->TimingCorners();
+    const std::string usage{
+        "timing_corners corner <name> ?-liberty <file>? ?-sdf <file>?, "
+        "timing_corners mode <name> ?-sdc <file>?, timing_corners jobs <n>, "
+        "timing_corners clear or timing_corners info"};
+    if (argc < 2) {
+      compiler->ErrorMessage(usage);
+      return TCL_ERROR;
+    }
+    const std::string arg = argv[1];
+    bool accepted{true};
+    if (arg == "corner" || arg == "mode") {
+      if (argc < 3 || (argc % 2) == 0) {
+        compiler->ErrorMessage(usage);
+        return TCL_ERROR;
+      }
+      TimingCorner corner{argv[2], {}, {}};
+      TimingMode mode{argv[2], {}};
+      for (int i = 3; i < argc; i += 2) {
+        const std::string option = argv[i];
+        const fs::path file = fs::absolute(argv[i + 1]);
+        if (arg == "corner" && option == "-liberty") {
+          corner.liberty = file;
+        } else if (arg == "corner" && option == "-sdf") {
+          corner.sdf = file;
+        } else if (arg == "mode" && option == "-sdc") {
+          mode.sdc = file;
+        } else {
+          compiler->ErrorMessage(usage);
+          return TCL_ERROR;
+        }
+      }
+      accepted =
+          (arg == "corner") ? corners.AddCorner(corner) : corners.AddMode(mode);
+    } else if (arg == "jobs" && argc == 3) {
+      accepted = corners.Jobs(std::strtoul(argv[2], 0, 10));
+    } else if (arg == "clear") {
+      accepted = corners.Clear();
+    } else if (arg == "info") {
+      std::string info{"Timing corners:"};
+      for (const auto& corner : corners.Corners()) info += " " + corner.name;
+      info += ", modes:";
+      for (const auto& mode : corners.Modes()) info += " " + mode.name;
+      info += ", jobs: " + std::to_string(corners.Jobs());
+      compiler->Message(info);
+    } else {
+      compiler->ErrorMessage(usage);
+      return TCL_ERROR;
+    }
+    if (!accepted) {
+      compiler->ErrorMessage(
+          "Timing corners cannot change while timing analysis is running");
+      return TCL_ERROR;
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("timing_corners", timing_corners, this, 0);
+
   auto message_severity = [](void* clientData, Tcl_Interp* interp, int argc,
                              const char* argv[]) -> int {
     CompilerOpenFPGA* compiler = (CompilerOpenFPGA*)clientData;
@@ -638,6 +813,26 @@ bool CompilerOpenFPGA::RegisterCommands(TclInterpreter* interp,
   };
   interp->registerCmd("parser_type", parser_type, this, 0);
 
+  auto rtl_checkpoint = [](void* clientData, Tcl_Interp* interp, int argc,
+                           const char* argv[]) -> int {
+    CompilerOpenFPGA* compiler = (CompilerOpenFPGA*)clientData;
+    if (argc != 2) {
+      compiler->ErrorMessage("Specify: rtl_checkpoint on/off");
+      return TCL_ERROR;
+    }
+    std::string arg = argv[1];
+    if (arg == "on") {
+      compiler->RtlCheckpointEnabled(true);
+    } else if (arg == "off") {
+      compiler->RtlCheckpointEnabled(false);
+    } else {
+      compiler->ErrorMessage("Specify: rtl_checkpoint on/off");
+      return TCL_ERROR;
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("rtl_checkpoint", rtl_checkpoint, this, 0);
+
   auto target_device = [](void* clientData, Tcl_Interp* interp, int argc,
                           const char* argv[]) -> int {
     CompilerOpenFPGA* compiler = (CompilerOpenFPGA*)clientData;
@@ -790,15 +985,14 @@ bool CompilerOpenFPGA::VerifyTargetDevice() const {
 }
 
 std::filesystem::path CompilerOpenFPGA::copyLog(
-    FOEDAG::ProjectManager* projManager, const std::string& srcFileName,
+    const std::filesystem::path& dir, const std::string& srcFileName,
     const std::string& destFileName) {
   std::filesystem::path dest{};
 
-  if (projManager) {
-    std::filesystem::path projectPath(fs::current_path());
-    std::filesystem::path src = projectPath / srcFileName;
+  if (!dir.empty()) {
+    std::filesystem::path src = dir / srcFileName;
     if (FileUtils::FileExists(src)) {
-      dest = projectPath / destFileName;
+      dest = dir / destFileName;
       std::filesystem::remove(dest);
       std::filesystem::copy_file(src, dest);
     }
@@ -1141,9 +1335,34 @@ std::string CompilerOpenFPGA::InitAnalyzeScript() {
       break;
     }
   }
+  if (m_rtlCheckpoint && (GetParserType() != ParserType::Verific)) {
+    // Dump elaborated design, Synthesize() reads it instead of the sources
+    if (ProjManager()->DesignTopModule().empty()) {
+      analysisScript += "hierarchy -auto-top\n";
+    } else {
+      analysisScript += "hierarchy -top " + ProjManager()->DesignTopModule();
+      analysisScript += "\n";
+    }
+    analysisScript += "write_rtlil " + RtlCheckpointFile() + "\n";
+  }
   return analysisScript;
 }
 
+std::string CompilerOpenFPGA::RtlCheckpointFile() const {
+  return ProjManager()->projectName() + "_analyzed.il";
+}
+
+std::filesystem::path CompilerOpenFPGA::RtlCheckpoint() {
+  if (!m_rtlCheckpoint || (GetParserType() == ParserType::Verific)) return {};
+  // Same validity rule as analysis reuse, but against the checkpoint itself
+  std::string analysisScript = FinishAnalyzeScript(InitAnalyzeScript());
+  auto scriptPath =
+      FilePath(Action::Analyze, ProjManager()->projectName() + "_analyzer.cmd");
+  auto checkpoint = FilePath(Action::Analyze, RtlCheckpointFile());
+  if (DesignChanged(analysisScript, scriptPath, checkpoint)) return {};
+  return checkpoint;
+}
+
 std::string CompilerOpenFPGA::FinishAnalyzeScript(const std::string& script) {
   std::string result = script;
   return result;
@@ -1235,7 +1454,7 @@ bool CompilerOpenFPGA::Analyze() {
   FileUtils::WriteToFile(script_path, analysisScript, false);
   std::string command;
   int status = 0;
-  std::filesystem::path analyse_path = ANALYSIS_LOG;
+  std::filesystem::path analyse_path = FilePath(Action::Analyze, ANALYSIS_LOG);
   if (GetParserType() == ParserType::Default ||
       GetParserType() == ParserType::Surelog ||
       GetParserType() == ParserType::GHDL) {
@@ -1805,93 +2024,7 @@ std::string CompilerOpenFPGA::YosysDesignParsingCommmands() {
   return designFiles;
 }
 
-bool CompilerOpenFPGA::Synthesize() {
-  // Using a Scope Guard so this will fire even if we exit mid function
-  // This will fire when the containing function goes out of scope
-  auto guard = sg::make_scope_guard([this] {
-    std::filesystem::path configJsonPath =
-        FilePath(Action::Synthesis) / "config.json";
-    std::filesystem::path fabricJsonPath =
-        FilePath(Compiler::Action::Synthesis) / "fabric_netlist_info.json";
-    getNetlistEditData()->ReadData(configJsonPath, fabricJsonPath);
-
-    // Rename log file
-    copyLog(ProjManager(), ProjManager()->projectName() + "_synth.log",
-            SYNTHESIS_LOG);
-  });
-
-  if (!m_projManager->HasDesign()) {
-    ErrorMessage("No design specified");
-    return false;
-  }
-  if (SynthOpt() == SynthesisOpt::Clean) {
-    Message("Cleaning synthesis results for " + ProjManager()->projectName());
-    m_state = State::IPGenerated;
-    SynthOpt(SynthesisOpt::None);
-    CleanFiles(Action::Synthesis);
-    return true;
-  }
-  if (!HasTargetDevice()) return false;
-
-  PERF_LOG("Synthesize has started");
-  Message("##################################################");
-  Message("Synthesis for design: " + ProjManager()->projectName());
-  Message("##################################################");
-  std::string yosysScript = InitSynthesisScript();
-
-  // update constraints
-  const auto& constrFiles = ProjManager()->getConstrFiles();
-  m_constraints->reset();
-  for (const auto& file : constrFiles) {
-    int res{TCL_OK};
-    auto status =
-        m_interp->evalCmd(std::string("read_sdc {" + file + "}").c_str(), &res);
-    if (res != TCL_OK) {
-      ErrorMessage(status);
-      return false;
-    }
-  }
-
-  const std::string sdcOut =
-      "pin_location_" + ProjManager()->projectName() + ".sdc";
-  std::ofstream ofssdc(sdcOut);
-  for (auto constraint : m_constraints->getConstraints()) {
-    constraint = m_constraints->UnmangleName(constraint);
-    // pin location constraints have to be translated to .place:
-    if ((constraint.find("set_pin_loc") != std::string::npos)) {
-      ofssdc << constraint << std::endl;
-    } else if (constraint.find("set_mode") != std::string::npos) {
-      ofssdc << constraint << std::endl;
-    } else if ((constraint.find("set_property") != std::string::npos) &&
-               (constraint.find(" mode ") != std::string::npos)) {
-      constraint = ReplaceAll(constraint, " mode ", " ");
-      constraint = ReplaceAll(constraint, "set_property", "set_mode");
-      ofssdc << constraint << std::endl;
-    }
-  }
-  ofssdc.close();
-
-  if (GetParserType() == ParserType::Default) {
-    bool hasVhdl = false;
-    for (const auto& lang_file : ProjManager()->DesignFiles()) {
-      switch (lang_file.first.language) {
-        case Design::Language::VHDL_1987:
-        case Design::Language::VHDL_1993:
-        case Design::Language::VHDL_2000:
-        case Design::Language::VHDL_2008:
-        case Design::Language::VHDL_2019:
-          hasVhdl = true;
-          break;
-        default:
-          break;
-      }
-    }
-    if (hasVhdl) {
-      // For GHDL parser
-      SetParserType(ParserType::GHDL);
-    }
-  }
-
+bool CompilerOpenFPGA::SynthesisDesignParsing(std::string& yosysScript) {
   switch (GetParserType()) {
     case ParserType::Verific: {
       // Verific parser
@@ -2078,6 +2211,106 @@ bool CompilerOpenFPGA::Synthesize() {
     default:
       break;
   }
+  return true;
+}
+
+bool CompilerOpenFPGA::Synthesize() {
+  // Using a Scope Guard so this will fire even if we exit mid function
+  // This will fire when the containing function goes out of scope
+  auto guard = sg::make_scope_guard([this] {
+    std::filesystem::path configJsonPath =
+        FilePath(Action::Synthesis) / "config.json";
+    std::filesystem::path fabricJsonPath =
+        FilePath(Compiler::Action::Synthesis) / "fabric_netlist_info.json";
+    getNetlistEditData()->ReadData(configJsonPath, fabricJsonPath);
+
+    // Rename log file
+    copyLog(FilePath(Action::Synthesis),
+            ProjManager()->projectName() + "_synth.log", SYNTHESIS_LOG);
+  });
+
+  if (!m_projManager->HasDesign()) {
+    ErrorMessage("No design specified");
+    return false;
+  }
+  if (SynthOpt() == SynthesisOpt::Clean) {
+    Message("Cleaning synthesis results for " + ProjManager()->projectName());
+    m_state = State::IPGenerated;
+    SynthOpt(SynthesisOpt::None);
+    CleanFiles(Action::Synthesis);
+    return true;
+  }
+  if (!HasTargetDevice()) return false;
+
+  PERF_LOG("Synthesize has started");
+  Message("##################################################");
+  Message("Synthesis for design: " + ProjManager()->projectName());
+  Message("##################################################");
+  std::string yosysScript = InitSynthesisScript();
+
+  // update constraints
+  const auto& constrFiles = ProjManager()->getConstrFiles();
+  m_constraints->reset();
+  for (const auto& file : constrFiles) {
+    int res{TCL_OK};
+    auto status =
+        m_interp->evalCmd(std::string("read_sdc {" + file + "}").c_str(), &res);
+    if (res != TCL_OK) {
+      ErrorMessage(status);
+      return false;
+    }
+  }
+
+  const std::filesystem::path sdcOut =
+      FilePath(Action::Synthesis,
+               "pin_location_" + ProjManager()->projectName() + ".sdc");
+  std::ofstream ofssdc(sdcOut);
+  for (auto constraint : m_constraints->getConstraints()) {
+    constraint = m_constraints->UnmangleName(constraint);
+    // pin location constraints have to be translated to .place:
+    if ((constraint.find("set_pin_loc") != std::string::npos)) {
+      ofssdc << constraint << std::endl;
+    } else if (constraint.find("set_mode") != std::string::npos) {
+      ofssdc << constraint << std::endl;
+    } else if ((constraint.find("set_property") != std::string::npos) &&
+               (constraint.find(" mode ") != std::string::npos)) {
+      constraint = ReplaceAll(constraint, " mode ", " ");
+      constraint = ReplaceAll(constraint, "set_property", "set_mode");
+      ofssdc << constraint << std::endl;
+    }
+  }
+  ofssdc.close();
+
+  if (GetParserType() == ParserType::Default) {
+    bool hasVhdl = false;
+    for (const auto& lang_file : ProjManager()->DesignFiles()) {
+      switch (lang_file.first.language) {
+        case Design::Language::VHDL_1987:
+        case Design::Language::VHDL_1993:
+        case Design::Language::VHDL_2000:
+        case Design::Language::VHDL_2008:
+        case Design::Language::VHDL_2019:
+          hasVhdl = true;
+          break;
+        default:
+          break;
+      }
+    }
+    if (hasVhdl) {
+      // For GHDL parser
+      SetParserType(ParserType::GHDL);
+    }
+  }
+
+  // the checkpoint replaces reading of the sources
+  const std::filesystem::path checkpoint = RtlCheckpoint();
+  if (!checkpoint.empty()) {
+    Message("Reusing analyzed design: " + checkpoint.string());
+    yosysScript = ReplaceAll(yosysScript, "${READ_DESIGN_FILES}",
+                             "read_rtlil " + checkpoint.string());
+  } else if (!SynthesisDesignParsing(yosysScript)) {
+    return false;
+  }
   if (!ProjManager()->DesignTopModule().empty()) {
     yosysScript = ReplaceAll(yosysScript, "${TOP_MODULE_DIRECTIVE}",
                              "-top " + ProjManager()->DesignTopModule());
@@ -2153,6 +2386,7 @@ bool CompilerOpenFPGA::Synthesize() {
                  std::string("fabric_" + ProjManager()->projectName() +
                              "_post_synth.edif"));
 
+  const std::filesystem::path synthPath = FilePath(Action::Synthesis);
   std::string script_path = ProjManager()->projectName() + ".ys";
   std::string output_path;
   switch (GetNetlistType()) {
@@ -2174,20 +2408,21 @@ bool CompilerOpenFPGA::Synthesize() {
       break;
   }
 
-  if (!DesignChanged(yosysScript, script_path, output_path)) {
+  if (!DesignChanged(yosysScript, synthPath / script_path,
+                     synthPath / output_path)) {
     m_state = State::Synthesized;
     Message("Design didn't change: " + ProjManager()->projectName() +
             ", skipping synthesis.");
     return true;
   }
-  std::filesystem::remove(
-      std::string(ProjManager()->projectName() + "_post_synth.blif"));
-  std::filesystem::remove(
-      std::string(ProjManager()->projectName() + "_post_synth.eblif"));
-  std::filesystem::remove(
-      std::string(ProjManager()->projectName() + "_post_synth.v"));
+  std::filesystem::remove(synthPath /
+                          (ProjManager()->projectName() + "_post_synth.blif"));
+  std::filesystem::remove(synthPath /
+                          (ProjManager()->projectName() + "_post_synth.eblif"));
+  std::filesystem::remove(synthPath /
+                          (ProjManager()->projectName() + "_post_synth.v"));
   // Create Yosys command and execute
-  FileUtils::WriteToFile(script_path, yosysScript, false);
+  FileUtils::WriteToFile(synthPath / script_path, yosysScript, false);
   if (!FileUtils::FileExists(m_yosysExecutablePath)) {
     ErrorMessage("Cannot find executable: " + m_yosysExecutablePath.string());
     return false;
@@ -2197,11 +2432,11 @@ bool CompilerOpenFPGA::Synthesize() {
       std::string(script_path + " -l " + ProjManager()->projectName() +
                   "_synth.log");
   Message("Synthesis command: " + command);
-  int status = ExecuteAndMonitorSystemCommand(
-      command, {}, false, FilePath(Action::Synthesis).string());
+  int status = ExecuteAndMonitorSystemCommand(command, {}, false, synthPath);
   if (status) {
     if (GetParserType() == ParserType::Default) {
-      std::ifstream raptor_log(ProjManager()->projectName() + "_synth.log");
+      std::ifstream raptor_log(synthPath /
+                               (ProjManager()->projectName() + "_synth.log"));
       if (raptor_log.good()) {
         std::stringstream buffer;
         buffer << raptor_log.rdbuf();
@@ -2336,18 +2571,103 @@ std::string CompilerOpenFPGA::BaseVprCommand(BaseVprDefaults defaults) {
   if (m_flatRouting) {
     command += " --flat_routing on";
   }
-  if (!m_routingGraphFile.empty()) {
+  processCustomLayout();
+  // cached graph is added by ExecuteAndMonitorSystemCommand() otherwise
+  if (!m_routingGraphFile.empty())
     command += " --read_rr_graph " + m_routingGraphFile.string();
-  }
   command += " --net_file " + FilePath(Action::Pack, name + ".net").string();
   command +=
       " --place_file " + FilePath(Action::Placement, name + ".place").string();
   command +=
       " --route_file " + FilePath(Action::Routing, name + ".route").string();
-  processCustomLayout();
   return command;
 }
 
+std::string CompilerOpenFPGA::RoutingGraphCacheOptions(
+    PendingRoutingGraph& pending) {
+  if (!m_rrGraphCache.Enabled()) return {};
+  // Without fixed device size VPR sizes the device from the netlist, the
+  // graph is design specific then
+  if (m_deviceSize.empty() || PackOpt() == PackingOpt::Debug) return {};
+
+  RRGraphCache::Key key;
+  key.architecture = m_architectureFile;
+  key.customLayout =
+      fs::path{ProjectManager::implPath(ProjManager()->projectPath())} /
+      "custom_layout.txt";
+  key.channelWidth = m_channel_width;
+  key.deviceSize = m_deviceSize;
+  key.flatRouting = m_flatRouting;
+  key.vprVersion = RRGraphCache::VprVersion(m_vprExecutablePath);
+  if (key.vprVersion.empty()) return {};
+  const std::string hash = m_rrGraphCache.Hash(key);
+  if (hash.empty()) return {};
+
+  auto cached = m_rrGraphCache.Lookup(hash);
+  if (!cached.empty()) {
+    Message("Reusing cached routing graph: " + cached.string());
+    return " --read_rr_graph " + cached.string();
+  }
+  if (!FileUtils::MkDirs(m_rrGraphCache.Directory())) return {};
+  pending = {m_rrGraphCache.PendingFile(hash), hash, key};
+  return " --write_rr_graph " + pending.file.string();
+}
+
+// VPR builds the routing graph for placement, routing and analysis only
+static bool buildsRoutingGraph(const std::string& command,
+                               const fs::path& vpr) {
+  if (command.compare(0, vpr.string().size() + 1, vpr.string() + " ") != 0)
+    return false;
+  std::istringstream words{command};
+  std::string word;
+  bool stage{false};
+  while (words >> word) {
+    if (word == "--read_rr_graph" || word == "--write_rr_graph") return false;
+    if (word == "--place" || word == "--route" || word == "--analysis")
+      stage = true;
+  }
+  return stage;
+}
+
+int CompilerOpenFPGA::ExecuteAndMonitorSystemCommand(
+    const std::string& command, const std::string logFile, bool appendLog,
+    const fs::path& workingDir) {
+  // cache options are added to the command actually run, so no pending graph
+  // is left behind by commands which are only written to .cmd files
+  PendingRoutingGraph pending;
+  std::string cacheOptions;
+  if (buildsRoutingGraph(command, m_vprExecutablePath))
+    cacheOptions = RoutingGraphCacheOptions(pending);
+  int status = Compiler::ExecuteAndMonitorSystemCommand(
+      command + cacheOptions, logFile, appendLog, workingDir);
+  if (pending.file.empty()) return status;
+  if (status == 0 &&
+      m_rrGraphCache.Commit(pending.file, pending.hash, pending.key)) {
+    Message("Routing graph cached: " +
+            m_rrGraphCache.Lookup(pending.hash).string());
+  } else {
+    FileUtils::removeFile(pending.file);
+  }
+  return status;
+}
+
+StaDesign CompilerOpenFPGA::TimingDesign() {
+  const std::string projName = ProjManager()->projectName();
+  StaDesign design;
+  design.liberty = FilePath(Action::STA, projName + ".lib");
+  design.netlist = FilePath(Action::STA, projName + "_post_route.v");
+  design.sdf = FilePath(Action::STA, projName + "_post_route.sdf");
+  design.sdc = FilePath(Action::STA, "fabric_" + projName + ".sdc");
+  design.top = projName;
+  return design;
+}
+
+bool CompilerOpenFPGA::LoadTimingSession(std::string* error) {
+  m_staSession.Executable(m_staExecutablePath);
+  m_staSession.WorkingDir(FilePath(Action::STA));
+  return m_staSession.Load(TimingDesign(), error);
+}
+
 std::string CompilerOpenFPGA::BaseStaCommand() {
   std::string command =
       m_staExecutablePath.string() +
@@ -2369,7 +2689,9 @@ std::string CompilerOpenFPGA::BaseStaScript(std::string libFileName,
       std::string("\n") + std::string("read_sdc ") + sdcFileName +
       std::string("\n") +
       std::string("report_checks\n");  // to do: add more check/report flavors
-  const std::string openStaFile = ProjManager()->projectName() + "_opensta.tcl";
+  const std::string openStaFile =
+      FilePath(Action::STA, ProjManager()->projectName() + "_opensta.tcl")
+          .string();
   FileUtils::WriteToFile(openStaFile, script);
   return openStaFile;
 }
@@ -2395,8 +2717,9 @@ bool CompilerOpenFPGA::WriteTimingConstraints() {
     }
   }
 
-  const std::string sdcOut =
-      "fabric_" + ProjManager()->projectName() + "_openfpga.sdc";
+  // same file BaseVprCommand() passes to VPR
+  const std::filesystem::path sdcOut = FilePath(
+      Action::Pack, "fabric_" + ProjManager()->projectName() + "_openfpga.sdc");
   std::ofstream ofssdc(sdcOut);
   // TODO: Massage the SDC so VPR can understand them
   for (auto constraint : m_constraints->getConstraints()) {
@@ -2444,7 +2767,7 @@ bool CompilerOpenFPGA::Packing() {
   // This will fire when the containing function goes out of scope
   auto guard = sg::make_scope_guard([this] {
     // Rename log file
-    copyLog(ProjManager(), "vpr_stdout.log", PACKING_LOG);
+    copyLog(FilePath(Action::Pack), "vpr_stdout.log", PACKING_LOG);
   });
 
   if (!ProjManager()->HasDesign()) {
@@ -2490,13 +2813,16 @@ bool CompilerOpenFPGA::Packing() {
   PackOpt(PackingOpt::None);
 
   std::string command = BaseVprCommand({}) + " --pack";
-  auto file = ProjManager()->projectName() + "_pack.cmd";
+  auto file =
+      FilePath(Action::Pack, ProjManager()->projectName() + "_pack.cmd");
   FileUtils::WriteToFile(file, command);
 
   fs::path netlistPath = GetNetlistPath();
   netlistPath = netlistPath.filename();
-  if (FileUtils::IsUptoDate(GetNetlistPath(),
-                            netlistPath.stem().string() + ".net") &&
+  if (FileUtils::IsUptoDate(
+          GetNetlistPath(),
+          FilePath(Action::Pack, netlistPath.stem().string() + ".net")
+              .string()) &&
       (prevOpt != PackingOpt::Debug)) {
     m_state = State::Packed;
     Message("Design " + ProjManager()->projectName() + " packing reused");
@@ -2554,7 +2880,7 @@ bool CompilerOpenFPGA::Placement() {
   // This will fire when the containing function goes out of scope
   auto guard = sg::make_scope_guard([this] {
     // Rename log file
-    copyLog(ProjManager(), "vpr_stdout.log", PLACEMENT_LOG);
+    copyLog(FilePath(Action::Placement), "vpr_stdout.log", PLACEMENT_LOG);
   });
 
   if (!ProjManager()->HasDesign()) {
@@ -2584,7 +2910,9 @@ bool CompilerOpenFPGA::Placement() {
     return false;
   }
 
-  const std::string pcfOut = ProjManager()->projectName() + "_openfpga.pcf";
+  const std::filesystem::path placementPath = FilePath(Action::Placement);
+  const std::filesystem::path pcfOut =
+      placementPath / (ProjManager()->projectName() + "_openfpga.pcf");
   std::string previousConstraints;
   std::ifstream ifspcf(pcfOut);
   if (ifspcf.good()) {
@@ -2813,7 +3141,7 @@ bool CompilerOpenFPGA::Placement() {
     if (!set_clks.empty() && repackConstraint) {
       const std::string repack_out =
           ProjManager()->projectName() + ".temp_file_clkmap";
-      std::ofstream ofsclkmap(repack_out);
+      std::ofstream ofsclkmap(placementPath / repack_out);
 
       for (auto constraint : set_clks) {
         ofsclkmap << constraint << "\n";
@@ -2835,12 +3163,11 @@ bool CompilerOpenFPGA::Placement() {
 
     std::string pin_loc_constraint_file;
 
-    auto file = ProjManager()->projectName() + "_pin_loc.cmd";
+    auto file = placementPath / (ProjManager()->projectName() + "_pin_loc.cmd");
     FileUtils::WriteToFile(file, pincommand);
 
-    auto workingDir = FilePath(Action::Placement);
     int status =
-        ExecuteAndMonitorSystemCommand(pincommand, {}, false, workingDir);
+        ExecuteAndMonitorSystemCommand(pincommand, {}, false, placementPath);
 
     if (status) {
       ErrorMessage("Design " + ProjManager()->projectName() +
@@ -2856,10 +3183,10 @@ bool CompilerOpenFPGA::Placement() {
     }
   }
 
-  auto file = ProjManager()->projectName() + "_place.cmd";
+  auto file = placementPath / (ProjManager()->projectName() + "_place.cmd");
   FileUtils::WriteToFile(file, command);
-  auto workingDir = FilePath(Action::Placement);
-  int status = ExecuteAndMonitorSystemCommand(command, {}, false, workingDir);
+  int status =
+      ExecuteAndMonitorSystemCommand(command, {}, false, placementPath);
   if (status) {
     ErrorMessage("Design " + ProjManager()->projectName() +
                  " placement failed");
@@ -2974,8 +3301,8 @@ bool CompilerOpenFPGA::Route() {
   ProcessUtilization routingUtilization{};
   auto guard = sg::make_scope_guard([this, &routingUtilization] {
     // Rename log file
-    m_utils = routingUtilization;
-    copyLog(ProjManager(), "vpr_stdout.log", ROUTING_LOG);
+    Context().Utilization(routingUtilization);
+    copyLog(FilePath(Action::Routing), "vpr_stdout.log", ROUTING_LOG);
     RenamePostSynthesisFiles(Action::Routing);
   });
 
@@ -3019,8 +3346,8 @@ bool CompilerOpenFPGA::Route() {
   FileUtils::WriteToFile(
       routingPath / std::string(ProjManager()->projectName() + "_route.cmd"),
       command);
-  routingUtilization = m_utils;
   int status = ExecuteAndMonitorSystemCommand(command, {}, false, routingPath);
+  routingUtilization = Context().Utilization();
   if (status) {
     ErrorMessage("Design " + ProjManager()->projectName() + " routing failed");
     return false;
@@ -3063,12 +3390,30 @@ bool CompilerOpenFPGA::Route() {
   return true;
 }
 
+// path and content hash, edited file is a different input
+static std::string timingCornerFile(const fs::path& file) {
+  if (file.empty()) return {};
+  return file.string() + "#" + FileUtils::FileHash(file);
+}
+
+// command recorded for the corner matrix, changes when any corner or mode or
+// content of their files does
+static std::string timingCornersCommand(const TimingCornerAnalysis& corners) {
+  std::string command{"timing_corners"};
+  for (const auto& corner : corners.Corners())
+    command += " {" + corner.name + " " + timingCornerFile(corner.liberty) +
+               " " + timingCornerFile(corner.sdf) + "}";
+  for (const auto& mode : corners.Modes())
+    command += " {" + mode.name + " " + timingCornerFile(mode.sdc) + "}";
+  return command;
+}
+
 bool CompilerOpenFPGA::TimingAnalysis() {
   // Using a Scope Guard so this will fire even if we exit mid function
   // This will fire when the containing function goes out of scope
   auto guard = sg::make_scope_guard([this] {
     // Rename log file
-    copyLog(ProjManager(), "vpr_stdout.log", TIMING_ANALYSIS_LOG);
+    copyLog(FilePath(Action::STA), "vpr_stdout.log", TIMING_ANALYSIS_LOG);
     RenamePostSynthesisFiles(Action::STA);
   });
 
@@ -3112,10 +3457,22 @@ bool CompilerOpenFPGA::TimingAnalysis() {
 
   fs::path netlistPath = GetNetlistPath();
   auto netlistFileName = netlistPath.filename().stem().string();
-  if (FileUtils::IsUptoDate(
-          FilePath(Action::Routing, netlistFileName + ".route").string(),
-          FilePath(Action::STA, ProjManager()->projectName() + "_sta.cmd")
-              .string())) {
+  const fs::path staCmd =
+      FilePath(Action::STA, ProjManager()->projectName() + "_sta.cmd");
+  bool upToDate = FileUtils::IsUptoDate(
+      FilePath(Action::Routing, netlistFileName + ".route").string(),
+      staCmd.string());
+  if (upToDate && TimingAnalysisEngineOpt() == STAEngineOpt::Opensta) {
+    // results of another corner matrix are stale
+    std::ifstream stream(staCmd);
+    std::string recorded;
+    std::getline(stream, recorded);
+    const std::string corners = timingCornersCommand(m_timingCorners);
+    upToDate = m_timingCorners.Empty()
+                   ? recorded.compare(0, corners.size(), corners) != 0
+                   : recorded == corners;
+  }
+  if (upToDate) {
     Message("Design " + ProjManager()->projectName() + " timing didn't change");
     return true;
   }
@@ -3126,7 +3483,8 @@ bool CompilerOpenFPGA::TimingAnalysis() {
     // allows SDF to be generated for OpenSTA
     std::string command =
         BaseVprCommand({}) + " --gen_post_synthesis_netlist on";
-    auto file = std::string(ProjManager()->projectName() + "_sta.cmd");
+    auto file =
+        FilePath(Action::STA, ProjManager()->projectName() + "_sta.cmd");
     FileUtils::WriteToFile(file, command);
     int status = ExecuteAndMonitorSystemCommand(command, {}, false, workingDir);
     if (status) {
@@ -3136,24 +3494,44 @@ bool CompilerOpenFPGA::TimingAnalysis() {
     }
     RenamePostSynthesisFiles(Action::STA);
     // find files
-    auto projName = ProjManager()->projectName();
-    auto libFileName = FilePath(Action::STA, projName + ".lib");
-    auto netlistFileName = FilePath(Action::STA, projName + "_post_route.v");
-    auto sdfFileName = FilePath(Action::STA, projName + "_post_route.sdf");
-    auto sdcFileName = FilePath(Action::STA, "fabric_" + projName + ".sdc");
-    if (std::filesystem::is_regular_file(libFileName) &&
-        std::filesystem::is_regular_file(netlistFileName) &&
-        std::filesystem::is_regular_file(sdfFileName) &&
-        std::filesystem::is_regular_file(sdcFileName)) {
+    const StaDesign design = TimingDesign();
+    if (std::filesystem::is_regular_file(design.liberty) &&
+        std::filesystem::is_regular_file(design.netlist) &&
+        std::filesystem::is_regular_file(design.sdf) &&
+        std::filesystem::is_regular_file(design.sdc)) {
+      if (!m_timingCorners.Empty()) {
+        FileUtils::WriteToFile(file, timingCornersCommand(m_timingCorners));
+        return CornerTimingAnalysis(design);
+      }
+      if (m_staSessionEnabled) {
+        // inputs which did not change are not read again
+        FileUtils::WriteToFile(file, "sta_session report_checks");
+        std::string report;
+        std::string error;
+        if (!LoadTimingSession(&error) ||
+            !m_staSession.Query("report_checks", report, &error)) {
+          ErrorMessage(error);
+          ErrorMessage("Design " + ProjManager()->projectName() +
+                       " timing analysis failed");
+          return false;
+        }
+        FileUtils::WriteToFile(
+            FilePath(Action::STA, ProjManager()->projectName() + "_sta.rpt"),
+            report);
+        Message(report, {}, true);
+        Message("Design " + ProjManager()->projectName() +
+                " is timing analysed");
+        return true;
+      }
       taCommand = BaseStaCommand() + " " +
-                  BaseStaScript(libFileName.string(), netlistFileName.string(),
-                                sdfFileName.string(), sdcFileName.string());
-      auto file = std::string(ProjManager()->projectName() + "_sta.cmd");
+                  BaseStaScript(design.liberty.string(),
+                                design.netlist.string(), design.sdf.string(),
+                                design.sdc.string());
       FileUtils::WriteToFile(file, taCommand);
     } else {
       auto fileList =
-          StringUtils::join({libFileName.string(), netlistFileName.string(),
-                             sdfFileName.string(), sdcFileName.string()},
+          StringUtils::join({design.liberty.string(), design.netlist.string(),
+                             design.sdf.string(), design.sdc.string()},
                             "\n");
       ErrorMessage(
           "No required design info generated for user design, required for "
@@ -3162,8 +3540,11 @@ bool CompilerOpenFPGA::TimingAnalysis() {
       return false;
     }
   } else {  // use vpr/tatum engine
+    if (!m_timingCorners.Empty())
+      Message("Timing corners need OpenSTA engine, design corner is analysed");
     taCommand = BaseVprCommand({}) + " --analysis";
-    auto file = std::string(ProjManager()->projectName() + "_sta.cmd");
+    auto file =
+        FilePath(Action::STA, ProjManager()->projectName() + "_sta.cmd");
     FileUtils::WriteToFile(file, taCommand + " --disp on");
   }
 
@@ -3178,12 +3559,67 @@ bool CompilerOpenFPGA::TimingAnalysis() {
   return true;
 }
 
+bool CompilerOpenFPGA::CornerTimingAnalysis(const StaDesign& design) {
+  const std::string projName = ProjManager()->projectName();
+  auto prepare = [this, &design](CornerRun& run) {
+    const fs::path liberty =
+        run.corner.liberty.empty() ? design.liberty : run.corner.liberty;
+    const fs::path sdf = run.corner.sdf.empty() ? design.sdf : run.corner.sdf;
+    const fs::path sdc = run.mode.sdc.empty() ? design.sdc : run.mode.sdc;
+    for (const auto& input : {liberty, sdf, sdc}) {
+      if (!fs::is_regular_file(input)) {
+        ErrorMessage("Corner " + run.corner.name + ", mode " + run.mode.name +
+                     ": cannot find " + input.string());
+        return false;
+      }
+    }
+    // every path group and endpoint is reported for the merged table
+    const std::string script =
+        "read_liberty {" + liberty.string() + "}\n" +
+        "read_verilog {" + design.netlist.string() + "}\n" +
+        "link_design " + design.top + "\n" + "read_sdf {" + sdf.string() +
+        "}\n" + "read_sdc {" + sdc.string() + "}\n" +
+        "report_checks -path_delay min_max -group_count 100000 "
+        "-endpoint_count 1 -unique_paths_to_endpoint\n";
+    const fs::path scriptFile = run.dir / "corner_opensta.tcl";
+    FileUtils::WriteToFile(scriptFile, script);
+    run.command = BaseStaCommand() + " " + scriptFile.string();
+    return true;
+  };
+  auto finished = [this](const CornerRun& run) {
+    Message("Timing corner " + run.corner.name + ", mode " + run.mode.name +
+            (run.passed ? " is analysed"
+                        : " failed, see " + run.log.string()));
+  };
+  // Stop() terminates the tools of all runs
+  auto hook = [this](ExecutionContext* context, bool added) {
+    if (added)
+      RegisterContext(context);
+    else
+      UnregisterContext(context);
+  };
+  const bool passed = m_timingCorners.Run(FilePath(Action::STA) / "corners",
+                                          prepare, finished, hook);
+
+  const std::string table = m_timingCorners.Table();
+  FileUtils::WriteToFile(FilePath(Action::STA, "timing_corners.rpt"), table);
+  FileUtils::WriteToFile(FilePath(Action::STA, "timing_corners.json"),
+                         m_timingCorners.Summary());
+  Message(table, {}, true);
+  if (!passed) {
+    ErrorMessage("Design " + projName + " timing analysis failed");
+    return false;
+  }
+  Message("Design " + projName + " is timing analysed");
+  return true;
+}
+
 bool CompilerOpenFPGA::PowerAnalysis() {
   // Using a Scope Guard so this will fire even if we exit mid function
   // This will fire when the containing function goes out of scope
   auto guard = sg::make_scope_guard([this] {
     // Rename log file
-    copyLog(ProjManager(), "vpr_stdout.log", POWER_ANALYSIS_LOG);
+    copyLog(FilePath(Action::Power), "vpr_stdout.log", POWER_ANALYSIS_LOG);
   });
 
   if (!ProjManager()->HasDesign()) {
@@ -3222,7 +3658,8 @@ bool CompilerOpenFPGA::PowerAnalysis() {
     return false;
   }
 
-  auto file = ProjManager()->projectName() + "_power.cmd";
+  auto file =
+      FilePath(Action::Power, ProjManager()->projectName() + "_power.cmd");
   FileUtils::WriteToFile(file, command);
 
   int status = ExecuteAndMonitorSystemCommand(command, {}, false,
@@ -3450,25 +3887,27 @@ std::string CompilerOpenFPGA::FinishOpenFPGAScript(const std::string& script) {
   result = ReplaceAll(result, "${OPENFPGA_SIM_SETTING_FILE}",
                       m_OpenFpgaSimSettingFile.string());
   // VPR an OpenFPGA pb_pin_fixup settings are mutually exclusive
+  std::string pbPinFixup = m_pb_pin_fixup;
   if (m_bitstreamMoreOpt.find("pb_pin_fixup") != std::string::npos)
-    m_pb_pin_fixup = "pb_pin_fixup";
-  result = ReplaceAll(result, "${PB_PIN_FIXUP}", m_pb_pin_fixup);
-  if (m_pb_pin_fixup == "pb_pin_fixup") {
+    pbPinFixup = "pb_pin_fixup";
+  result = ReplaceAll(result, "${PB_PIN_FIXUP}", pbPinFixup);
+  if (pbPinFixup == "pb_pin_fixup") {
     // Skip
     result = ReplaceAll(result, "${VPR_PB_PIN_FIXUP}", "on");
   } else {
     // Don't skip
     result = ReplaceAll(result, "${VPR_PB_PIN_FIXUP}", "off");
   }
-  if (m_runtime_OpenFpgaBitstreamSettingFile.string().empty()) {
+  // set by the bitstream stage running this script
+  const std::string bitstreamSettingFile =
+      Context().StageValue("bitstream_setting_file");
+  if (bitstreamSettingFile.empty()) {
     result = ReplaceAll(result, "${OPENFPGA_BITSTREAM_SETTING_FILE}", "");
   } else {
     result = ReplaceAll(result, "${OPENFPGA_BITSTREAM_SETTING_FILE}",
                         "read_openfpga_bitstream_setting -f " +
-                            m_runtime_OpenFpgaBitstreamSettingFile.string());
+                            bitstreamSettingFile);
   }
-  result = ReplaceAll(result, "${OPENFPGA_BITSTREAM_SETTING_FILE}",
-                      m_runtime_OpenFpgaBitstreamSettingFile.string());
 
   // Use run time generated clk pin XML if exists
   std::filesystem::path clk_pin_xml =
@@ -3532,7 +3971,7 @@ bool CompilerOpenFPGA::GenerateBitstream() {
   // This will fire when the containing function goes out of scope
   auto guard = sg::make_scope_guard([this] {
     // Rename log file
-    copyLog(ProjManager(), "vpr_stdout.log", BITSTREAM_LOG);
+    copyLog(FilePath(Action::Bitstream), "vpr_stdout.log", BITSTREAM_LOG);
     m_compile2bits = false;
   });
 
@@ -3572,7 +4011,7 @@ bool CompilerOpenFPGA::GenerateBitstream() {
   }
 
   if (BitsFlags() == BitstreamFlags::EnableSimulation) {
-    std::filesystem::path bit_path = "BIT_SIM";
+    std::filesystem::path bit_path = FilePath(Action::Bitstream, "BIT_SIM");
     std::filesystem::create_directory(bit_path);
   }
 
@@ -3607,14 +4046,19 @@ bool CompilerOpenFPGA::GenerateBitstream() {
         FilePath(Action::Synthesis, "design_edit.sdc");
     if (std::filesystem::exists(design_edit_sdc) && !m_PinMapCSV.empty() &&
         std::filesystem::exists(m_PinMapCSV)) {
+      const std::string settingFile =
+          FilePath(Action::Bitstream, "bitstream_setting.xml").string();
       std::string command = CFG_print(
           "model_config gen_bitstream_setting_xml -device_size %s -design %s "
           "-pin %s "
-          "%s bitstream_setting.xml",
+          "%s %s",
           io_status.second.c_str(), design_edit_sdc.c_str(),
-          m_PinMapCSV.c_str(), m_OpenFpgaBitstreamSettingFile.c_str());
-      auto file =
-          ProjManager()->projectName() + "_gen_bitstream_setting_xml_cmd.tcl";
+          m_PinMapCSV.c_str(), m_OpenFpgaBitstreamSettingFile.c_str(),
+          settingFile.c_str());
+      auto file = FilePath(Action::Bitstream,
+                           ProjManager()->projectName() +
+                               "_gen_bitstream_setting_xml_cmd.tcl")
+                      .string();
       FileUtils::WriteToFile(file, command);
       command = CFG_print("source %s", file.c_str());
       int status = TCL_OK;
@@ -3624,13 +4068,15 @@ bool CompilerOpenFPGA::GenerateBitstream() {
                      " Bitstream Setting XML generation failed");
         return false;
       } else {
-        m_runtime_OpenFpgaBitstreamSettingFile = "bitstream_setting.xml";
+        Context().StageValue("bitstream_setting_file", settingFile);
       }
     } else {
-      m_runtime_OpenFpgaBitstreamSettingFile = m_OpenFpgaBitstreamSettingFile;
+      Context().StageValue("bitstream_setting_file",
+                           m_OpenFpgaBitstreamSettingFile.string());
     }
   } else {
-    m_runtime_OpenFpgaBitstreamSettingFile = m_OpenFpgaBitstreamSettingFile;
+    Context().StageValue("bitstream_setting_file",
+                         m_OpenFpgaBitstreamSettingFile.string());
   }
 
   std::string command = m_openFpgaExecutablePath.string() + " -batch -f " +
@@ -3651,21 +4097,22 @@ bool CompilerOpenFPGA::GenerateBitstream() {
     script = StringUtils::replaceAll(script, "--analysis", {});
   }
 
+  auto workingDir = FilePath(Action::Bitstream);
   std::string script_path = ProjManager()->projectName() + ".openfpga";
 
-  std::filesystem::remove("fabric_bitstream.bit");
-  std::filesystem::remove("fabric_independent_bitstream.xml");
+  std::filesystem::remove(workingDir / "fabric_bitstream.bit");
+  std::filesystem::remove(workingDir / "fabric_independent_bitstream.xml");
   // Create OpenFpga command and execute
-  FileUtils::WriteToFile(script_path, script, false);
+  FileUtils::WriteToFile(workingDir / script_path, script, false);
   if (!FileUtils::FileExists(m_openFpgaExecutablePath)) {
     ErrorMessage("Cannot find executable: " +
                  m_openFpgaExecutablePath.string());
     return false;
   }
 
-  auto file = ProjManager()->projectName() + "_bitstream.cmd";
+  auto file =
+      (workingDir / (ProjManager()->projectName() + "_bitstream.cmd")).string();
   FileUtils::WriteToFile(file, command);
-  auto workingDir = FilePath(Action::Bitstream);
   int status = ExecuteAndMonitorSystemCommand(command, {}, false, workingDir);
   if (status) {
     ErrorMessage("Design " + ProjManager()->projectName() +
@@ -3763,18 +4210,26 @@ bool CompilerOpenFPGA::GenerateBitstream() {
         }
       }
     }
+    // all files are written into bitstream directory, current directory of
+    // the process is left untouched
+    auto inWorkingDir = [&workingDir](const std::string& name) {
+      return CFG_change_directory_to_linux_format((workingDir / name).string());
+    };
+    const std::string propertyJson = inWorkingDir("model_config.property.json");
+    const std::string ppdbJson = inWorkingDir("model_config.ppdb.json");
+    const std::string postPpdbJson =
+        inWorkingDir("model_config.post.ppdb.json");
     // update constraints
-    command = CFG_print("cd %s", workingDir.c_str());
-    command = CFG_print("%s\nclear_property", command.c_str());
+    command = "clear_property";
     m_constraints->reset();
     for (const auto& file : ProjManager()->getConstrFiles()) {
       command = CFG_print("%s\nread_sdc {%s}", command.c_str(), file.c_str());
     }
-    command = CFG_print("%s\nwrite_property model_config.property.json",
-                        command.c_str());
+    command = CFG_print("%s\nwrite_property %s", command.c_str(),
+                        propertyJson.c_str());
     command = CFG_print(
-        "%s\nwrite_simplified_property model_config.simplified.property.json",
-        command.c_str());
+        "%s\nwrite_simplified_property %s", command.c_str(),
+        inWorkingDir("model_config.simplified.property.json").c_str());
     command = CFG_print("%s\nundefine_device PERIPHERY", command.c_str());
     command = CFG_print("%s\nsource %s", command.c_str(), ric_model.c_str());
     command = CFG_print("%s\nmodel_config set_model -feature IO PERIPHERY",
@@ -3788,38 +4243,39 @@ bool CompilerOpenFPGA::GenerateBitstream() {
                             command.c_str(), filepath.c_str());
       }
     }
-    command = CFG_print("%s\nmodel_config dump_ric PERIPHERY io_ric.txt",
-                        command.c_str());
+    command = CFG_print("%s\nmodel_config dump_ric PERIPHERY %s",
+                        command.c_str(), inWorkingDir("io_ric.txt").c_str());
     uint32_t gen_bitstream_count = 1;
     if (CFG_find_string_in_vector({"Gemini", "Virgo"}, device_data.series) >=
         0) {
       command = CFG_print(
           "%s\nmodel_config gen_ppdb -netlist_ppdb \"%s\" -config_mapping "
-          "\"%s\" -property_json model_config.property.json -routing_config "
-          "\"%s\" -routing_config_model \"%s\" -pll_workaround 0 "
-          "model_config.ppdb.json",
+          "\"%s\" -property_json %s -routing_config "
+          "\"%s\" -routing_config_model \"%s\" -pll_workaround 0 %s",
           command.c_str(), netlist_ppdb.c_str(), config_mapping.c_str(),
-          routing_exe.c_str(), routing_model.c_str());
+          propertyJson.c_str(), routing_exe.c_str(), routing_model.c_str(),
+          ppdbJson.c_str());
       command = CFG_print(
           "%s\nmodel_config gen_ppdb -netlist_ppdb \"%s\" -config_mapping "
-          "\"%s\" -property_json model_config.property.json -routing_config "
-          "\"%s\" -routing_config_model \"%s\" -pll_workaround 1 "
-          "model_config.post.ppdb.json",
+          "\"%s\" -property_json %s -routing_config "
+          "\"%s\" -routing_config_model \"%s\" -pll_workaround 1 %s",
           command.c_str(), netlist_ppdb.c_str(), config_mapping.c_str(),
-          routing_exe.c_str(), routing_model.c_str());
+          propertyJson.c_str(), routing_exe.c_str(), routing_model.c_str(),
+          postPpdbJson.c_str());
       gen_bitstream_count = 2;
     } else {
       command = CFG_print(
           "%s\nmodel_config gen_ppdb -netlist_ppdb \"%s\" -config_mapping "
-          "\"%s\" -property_json model_config.property.json -routing_config "
-          "\"%s\" -routing_config_model \"%s\" model_config.ppdb.json",
+          "\"%s\" -property_json %s -routing_config "
+          "\"%s\" -routing_config_model \"%s\" %s",
           command.c_str(), netlist_ppdb.c_str(), config_mapping.c_str(),
-          routing_exe.c_str(), routing_model.c_str());
+          propertyJson.c_str(), routing_exe.c_str(), routing_model.c_str(),
+          ppdbJson.c_str());
     }
-    std::string design = "model_config.ppdb.json";
-    std::string bit_file = "io_bitstream.bit";
-    std::string detail_file = "io_bitstream.detail.bit";
-    std::string backdoor_file = "io_bitstream.backdoor.txt";
+    std::string design = ppdbJson;
+    std::string bit_file = inWorkingDir("io_bitstream.bit");
+    std::string detail_file = inWorkingDir("io_bitstream.detail.bit");
+    std::string backdoor_file = inWorkingDir("io_bitstream.backdoor.txt");
     for (uint32_t i = 0; i < gen_bitstream_count; i++) {
       command = CFG_print("%s\nmodel_config set_design -feature IO %s",
                           command.c_str(), design.c_str());
@@ -3840,13 +4296,13 @@ bool CompilerOpenFPGA::GenerateBitstream() {
       if (i == 0 && gen_bitstream_count == 2) {
         command =
             CFG_print("%s\nmodel_config reset -feature IO", command.c_str());
-        design = "model_config.post.ppdb.json";
-        bit_file = "io_bitstream.post.bit";
-        detail_file = "io_bitstream.post.detail.bit";
-        backdoor_file = "io_bitstream.post.backdoor.txt";
+        design = postPpdbJson;
+        bit_file = inWorkingDir("io_bitstream.post.bit");
+        detail_file = inWorkingDir("io_bitstream.post.detail.bit");
+        backdoor_file = inWorkingDir("io_bitstream.post.backdoor.txt");
       }
     }
-    file = ProjManager()->projectName() + "_io_bitstream_cmd.tcl";
+    file = inWorkingDir(ProjManager()->projectName() + "_io_bitstream_cmd.tcl");
     FileUtils::WriteToFile(file, command);
     command = CFG_print("source %s", file.c_str());
     m_interp->evalCmd(command, &status);
@@ -3910,178 +4366,143 @@ bool CompilerOpenFPGA::LoadDeviceData(
     const std::string& deviceName, const std::filesystem::path& deviceListFile,
     const std::filesystem::path& devicesBase, bool& deviceFound) {
   bool status = true;
-  QFile file(deviceListFile.string().c_str());
-  if (!file.open(QFile::ReadOnly)) {
-    ErrorMessage("Cannot open device file: " + deviceListFile.string());
-    return false;
-  }
-
-  QDomDocument doc;
-  if (!doc.setContent(&file)) {
-    file.close();
-    ErrorMessage("Incorrect device file: " + deviceListFile.string());
+  std::string error;
+  auto deviceList =
+      DeviceCatalog::Instance()->load(deviceListFile, devicesBase, &error);
+  if (!deviceList) {
+    ErrorMessage(error);
     return false;
   }
-  file.close();
 
-  QDomElement docElement = doc.documentElement();
-  QDomNode node = docElement.firstChild();
-  while (!node.isNull()) {
-    if (node.isElement()) {
-      QDomElement e = node.toElement();
-
-      std::string name = e.attribute("name").toStdString();
-      std::string family = e.attribute("family").toStdString();
-      std::string series = e.attribute("series").toStdString();
-      std::string package = e.attribute("package").toStdString();
-      if (name == deviceName) {
-        setDeviceData({family, series, package});
-        deviceFound = true;
-        BaseDeviceName(deviceName);
-        QDomNodeList list = e.childNodes();
-        for (int i = 0; i < list.count(); i++) {
-          QDomNode n = list.at(i);
-          if (!n.isNull() && n.isElement()) {
-            if (n.nodeName() == "internal") {
-              std::string file_type =
-                  n.toElement().attribute("type").toStdString();
-              std::string file = n.toElement().attribute("file").toStdString();
-              std::string name = n.toElement().attribute("name").toStdString();
-              std::string num = n.toElement().attribute("num").toStdString();
-              std::filesystem::path fullPath;
-              if (!file.empty()) {
-                if (FileUtils::FileExists(file)) {
-                  fullPath = file;  // Absolute path
-                } else {
-                  fullPath = devicesBase / file;
-                }
-                if (!FileUtils::FileExists(fullPath.string())) {
-                  ErrorMessage("Invalid device config file: " +
-                               fullPath.string() + "\n");
-                  status = false;
-                }
-              }
-              if (file_type == "vpr_arch") {
-                ArchitectureFile(fullPath.string());
-              } else if (file_type == "openfpga_arch") {
-                OpenFpgaArchitectureFile(fullPath.string());
-              } else if (file_type == "bitstream_settings") {
-                OpenFpgaBitstreamSettingFile(fullPath.string());
-              } else if (file_type == "routing_graph") {
-                RoutingGraphFile(fullPath.string());
-              } else if (file_type == "sim_settings") {
-                OpenFpgaSimSettingFile(fullPath.string());
-              } else if (file_type == "repack_settings") {
-                OpenFpgaRepackConstraintsFile(fullPath.string());
-              } else if (file_type == "fabric_key") {
-                OpenFpgaFabricKeyFile(fullPath.string());
-              } else if (file_type == "pinmap_xml") {
-                OpenFpgaPinmapXMLFile(fullPath.string());
-              } else if (file_type == "pcf_xml") {
-                OpenFpgaPinConstraintFile(fullPath.string());
-              } else if (file_type == "ric_model_dir") {
-                OpenFpgaRICModelDir(fullPath.string());
-              } else if (file_type == "pb_pin_fixup") {
-                PbPinFixup(name);
-              } else if (file_type == "pinmap_csv") {
-                PinmapCSVFile(fullPath);
-              } else if (file_type == "plugin_lib") {
-                YosysPluginLibName(name);
-              } else if (file_type == "plugin_func") {
-                YosysPluginName(name);
-              } else if (file_type == "technology") {
-                YosysMapTechnology(name);
-              } else if (file_type == "tag_version") {
-                DeviceTagVersion(name);
-              } else if (file_type == "synth_type") {
-                if (name == "QL")
-                  SynthType(SynthesisType::QL);
-                else if (name == "RS")
-                  SynthType(SynthesisType::RS);
-                else if (name == "Yosys")
-                  SynthType(SynthesisType::Yosys);
-                else {
-                  ErrorMessage("Invalid synthesis type: " + name + "\n");
-                  status = false;
-                }
-              } else if (file_type == "synth_opts") {
-                PerDeviceSynthOptions(name);
-              } else if (file_type == "vpr_opts") {
-                PerDevicePnROptions(name);
-              } else if (file_type == "device_size") {
-                DeviceSize(name);
-              } else if (file_type == "lut_size") {
-                LutSize(std::strtoul(num.c_str(), nullptr, 10));
-              } else if (file_type == "channel_width") {
-                ChannelWidth(std::strtoul(num.c_str(), nullptr, 10));
-              } else if (file_type == "bitstream_enabled") {
-                if (num == "true") {
-                  BitstreamEnabled(true);
-                } else if (num == "false") {
-                  BitstreamEnabled(false);
-                } else {
-                  ErrorMessage("Invalid bitstream_enabled num (true, false): " +
-                               num + "\n");
-                  status = false;
-                }
-              } else if (file_type == "pin_constraint_enabled") {
-                if (num == "true") {
-                  PinConstraintEnabled(true);
-                } else if (num == "false") {
-                  PinConstraintEnabled(false);
-                } else {
-                  ErrorMessage(
-                      "Invalid pin_constraint_enabled num (true, false): " +
-                      num + "\n");
-                  status = false;
-                }
-              } else if (file_type == "flat_routing") {
-                if (num == "true") {
-                  FlatRouting(true);
-                } else if (num == "false") {
-                  FlatRouting(false);
-                } else {
-                  ErrorMessage(
-                      "Invalid flat_routing num (true, false): " + num + "\n");
-                  status = false;
-                }
-              } else if (file_type == "base_device") {
-                BaseDeviceName(name);
-                // field is used for identify base for custom device
-                // no action so far
-              } else if (file_type == "power_data") {
-                // field will be used for power data config, skip for now.
-              } else {
-                ErrorMessage("Invalid device config type: " + file_type + "\n");
-                status = false;
-              }
-            } else if (n.nodeName() == "resource") {
-              std::string file_type =
-                  n.toElement().attribute("type").toStdString();
-              std::string num = n.toElement().attribute("num").toStdString();
-              if (file_type == "dsp") {
-                MaxDeviceDSPCount(std::strtoul(num.c_str(), nullptr, 10));
-                MaxUserDSPCount(MaxDeviceDSPCount());
-              } else if (file_type == "bram") {
-                MaxDeviceBRAMCount(std::strtoul(num.c_str(), nullptr, 10));
-                MaxUserBRAMCount(MaxDeviceBRAMCount());
-              } else if (file_type == "carry_length") {
-                MaxDeviceCarryLength(std::strtoul(num.c_str(), nullptr, 10));
-                MaxUserCarryLength(MaxDeviceCarryLength());
-              } else if (file_type == "lut") {
-                MaxDeviceLUTCount(std::strtoul(num.c_str(), nullptr, 10));
-              } else if (file_type == "ff") {
-                MaxDeviceFFCount(std::strtoul(num.c_str(), nullptr, 10));
-              } else if (file_type == "io") {
-                MaxDeviceIOCount(std::strtoul(num.c_str(), nullptr, 10));
-              }
-            }
-          }
+  const DeviceRecord* device = deviceList->find(deviceName);
+  if (device) {
+    setDeviceData({device->family, device->series, device->package});
+    deviceFound = true;
+    BaseDeviceName(deviceName);
+    for (const auto& internal : device->internals) {
+      const std::string& file_type = internal.type;
+      const std::string& name = internal.name;
+      const std::string& num = internal.num;
+      const std::filesystem::path& fullPath = internal.fullPath;
+      if (!fullPath.empty() && !FileUtils::FileExists(fullPath.string())) {
+        ErrorMessage("Invalid device config file: " + fullPath.string() +
+                     "\n");
+        status = false;
+      }
+      if (file_type == "vpr_arch") {
+        ArchitectureFile(fullPath.string());
+      } else if (file_type == "openfpga_arch") {
+        OpenFpgaArchitectureFile(fullPath.string());
+      } else if (file_type == "bitstream_settings") {
+        OpenFpgaBitstreamSettingFile(fullPath.string());
+      } else if (file_type == "routing_graph") {
+        RoutingGraphFile(fullPath.string());
+      } else if (file_type == "sim_settings") {
+        OpenFpgaSimSettingFile(fullPath.string());
+      } else if (file_type == "repack_settings") {
+        OpenFpgaRepackConstraintsFile(fullPath.string());
+      } else if (file_type == "fabric_key") {
+        OpenFpgaFabricKeyFile(fullPath.string());
+      } else if (file_type == "pinmap_xml") {
+        OpenFpgaPinmapXMLFile(fullPath.string());
+      } else if (file_type == "pcf_xml") {
+        OpenFpgaPinConstraintFile(fullPath.string());
+      } else if (file_type == "ric_model_dir") {
+        OpenFpgaRICModelDir(fullPath.string());
+      } else if (file_type == "pb_pin_fixup") {
+        PbPinFixup(name);
+      } else if (file_type == "pinmap_csv") {
+        PinmapCSVFile(fullPath);
+      } else if (file_type == "plugin_lib") {
+        YosysPluginLibName(name);
+      } else if (file_type == "plugin_func") {
+        YosysPluginName(name);
+      } else if (file_type == "technology") {
+        YosysMapTechnology(name);
+      } else if (file_type == "tag_version") {
+        DeviceTagVersion(name);
+      } else if (file_type == "synth_type") {
+        if (name == "QL")
+          SynthType(SynthesisType::QL);
+        else if (name == "RS")
+          SynthType(SynthesisType::RS);
+        else if (name == "Yosys")
+          SynthType(SynthesisType::Yosys);
+        else {
+          ErrorMessage("Invalid synthesis type: " + name + "\n");
+          status = false;
         }
+      } else if (file_type == "synth_opts") {
+        PerDeviceSynthOptions(name);
+      } else if (file_type == "vpr_opts") {
+        PerDevicePnROptions(name);
+      } else if (file_type == "device_size") {
+        DeviceSize(name);
+      } else if (file_type == "lut_size") {
+        LutSize(std::strtoul(num.c_str(), nullptr, 10));
+      } else if (file_type == "channel_width") {
+        ChannelWidth(std::strtoul(num.c_str(), nullptr, 10));
+      } else if (file_type == "bitstream_enabled") {
+        if (num == "true") {
+          BitstreamEnabled(true);
+        } else if (num == "false") {
+          BitstreamEnabled(false);
+        } else {
+          ErrorMessage("Invalid bitstream_enabled num (true, false): " + num +
+                       "\n");
+          status = false;
+        }
+      } else if (file_type == "pin_constraint_enabled") {
+        if (num == "true") {
+          PinConstraintEnabled(true);
+        } else if (num == "false") {
+          PinConstraintEnabled(false);
+        } else {
+          ErrorMessage("Invalid pin_constraint_enabled num (true, false): " +
+                       num + "\n");
+          status = false;
+        }
+      } else if (file_type == "flat_routing") {
+        if (num == "true") {
+          FlatRouting(true);
+        } else if (num == "false") {
+          FlatRouting(false);
+        } else {
+          ErrorMessage("Invalid flat_routing num (true, false): " + num +
+                       "\n");
+          status = false;
+        }
+      } else if (file_type == "base_device") {
+        BaseDeviceName(name);
+        // field is used for identify base for custom device
+        // no action so far
+      } else if (file_type == "power_data") {
+        // field will be used for power data config, skip for now.
+      } else {
+        ErrorMessage("Invalid device config type: " + file_type + "\n");
+        status = false;
+      }
+    }
+    for (const auto& resource : device->resources) {
+      const std::string& file_type = resource.type;
+      const std::string& num = resource.num;
+      if (file_type == "dsp") {
+        MaxDeviceDSPCount(std::strtoul(num.c_str(), nullptr, 10));
+        MaxUserDSPCount(MaxDeviceDSPCount());
+      } else if (file_type == "bram") {
+        MaxDeviceBRAMCount(std::strtoul(num.c_str(), nullptr, 10));
+        MaxUserBRAMCount(MaxDeviceBRAMCount());
+      } else if (file_type == "carry_length") {
+        MaxDeviceCarryLength(std::strtoul(num.c_str(), nullptr, 10));
+        MaxUserCarryLength(MaxDeviceCarryLength());
+      } else if (file_type == "lut") {
+        MaxDeviceLUTCount(std::strtoul(num.c_str(), nullptr, 10));
+      } else if (file_type == "ff") {
+        MaxDeviceFFCount(std::strtoul(num.c_str(), nullptr, 10));
+      } else if (file_type == "io") {
+        MaxDeviceIOCount(std::strtoul(num.c_str(), nullptr, 10));
       }
     }
-
-    node = node.nextSibling();
   }
   if (!deviceFound) {
     status = false;
@@ -27,6 +27,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <vector>
 
 #include "Compiler/Compiler.h"
+#include "Compiler/RRGraphCache.h"
+#include "Compiler/StaSession.h"
+#include "Compiler/TimingCorners.h"
 
 namespace FOEDAG {
 enum class SynthesisType { Yosys, QL, RS };
@@ -135,6 +138,10 @@ class CompilerOpenFPGA : public Compiler {
 
   void SynthType(SynthesisType type) { m_synthType = type; }
 
+  // Reuse of the design elaborated by Analyze() in Synthesize()
+  void RtlCheckpointEnabled(bool on) { m_rtlCheckpoint = on; }
+  bool RtlCheckpointEnabled() const { return m_rtlCheckpoint; }
+
   const std::string& PerDevicePnROptions() { return m_perDevicePnROptions; }
   void PerDevicePnROptions(const std::string& options) {
     m_perDevicePnROptions = options;
@@ -146,6 +153,24 @@ class CompilerOpenFPGA : public Compiler {
                                                   bool regex, bool input_only);
 
   std::string BaseVprCommand();
+  RRGraphCache& RoutingGraphCache() { return m_rrGraphCache; }
+  StaSession& TimingSession() { return m_staSession; }
+  bool TimingSessionEnabled() const { return m_staSessionEnabled; }
+  void TimingSessionEnabled(bool enabled) { m_staSessionEnabled = enabled; }
+  /*!
+   * \brief TimingDesign
+   * \return OpenSTA inputs generated by the timing analysis stage, files may
+   * not exist yet.
+   */
+  StaDesign TimingDesign();
+  // start or update the session with the current timing design
+  bool LoadTimingSession(std::string* error = nullptr);
+  TimingCornerAnalysis& TimingCorners() { return m_timingCorners; }
+
+  int ExecuteAndMonitorSystemCommand(const std::string& command,
+                                     const std::string logFile = std::string{},
+                                     bool appendLog = false,
+                                     const fs::path& workingDir = {}) override;
 
  protected:
   virtual bool IPGenerate();
@@ -158,6 +183,8 @@ class CompilerOpenFPGA : public Compiler {
   virtual bool WriteTimingConstraints();
   virtual bool Route();
   virtual bool TimingAnalysis();
+  // every corner and mode of TimingCorners() analysed by OpenSTA
+  virtual bool CornerTimingAnalysis(const StaDesign& design);
   virtual bool PowerAnalysis();
   virtual bool GenerateBitstream();
   virtual bool LoadDeviceData(const std::string& deviceName);
@@ -184,12 +211,22 @@ class CompilerOpenFPGA : public Compiler {
   std::string YosysDesignParsingCommmands();
   std::string SurelogDesignParsingCommmands();
   std::string GhdlDesignParsingCommmands();
-  static std::filesystem::path copyLog(FOEDAG::ProjectManager* projManager,
+  // replace ${READ_DESIGN_FILES} of \a yosysScript with the parser commands
+  bool SynthesisDesignParsing(std::string& yosysScript);
+  // copy \a srcFileName to \a destFileName, both relative to \a dir
+  static std::filesystem::path copyLog(const std::filesystem::path& dir,
                                        const std::string& srcFileName,
                                        const std::string& destFileName);
   bool DesignChangedForAnalysis(std::string& synth_script,
                                 std::filesystem::path& synth_scrypt_path,
                                 std::filesystem::path& outputFile);
+  std::string RtlCheckpointFile() const;
+  /*!
+   * \brief RtlCheckpoint
+   * \return RTLIL file dumped by Analyze() if it is still valid for the
+   * current design inputs, otherwise empty path.
+   */
+  std::filesystem::path RtlCheckpoint();
   void processCustomLayout();
   void RenamePostSynthesisFiles(Action action);
   std::filesystem::path m_yosysExecutablePath = "yosys";
@@ -217,7 +254,6 @@ class CompilerOpenFPGA : public Compiler {
   std::filesystem::path m_routingGraphFile = "";
   std::filesystem::path m_OpenFpgaSimSettingFile = "";
   std::filesystem::path m_OpenFpgaBitstreamSettingFile = "";
-  std::filesystem::path m_runtime_OpenFpgaBitstreamSettingFile = "";
   std::filesystem::path m_OpenFpgaRepackConstraintsFile = "";
   std::filesystem::path m_OpenFpgaFabricKeyFile = "";
   std::filesystem::path m_OpenFpgaPinMapXml = "";
@@ -238,10 +274,22 @@ class CompilerOpenFPGA : public Compiler {
   int32_t m_maxUserBRAMCount = -1;
   int32_t m_maxUserCarryLength = -1;
   bool m_flatRouting = false;
+  bool m_rtlCheckpoint = false;
   struct BaseVprDefaults {
     bool gen_post_synthesis_netlist{true};
   };
   virtual std::string BaseVprCommand(BaseVprDefaults defaults);
+  struct PendingRoutingGraph {
+    std::filesystem::path file;
+    std::string hash;
+    RRGraphCache::Key key;
+  };
+  /*!
+   * \brief RoutingGraphCacheOptions
+   * \return VPR options reading the cached routing graph, or writing it to
+   * \a pending file when it is not cached yet.
+   */
+  std::string RoutingGraphCacheOptions(PendingRoutingGraph& pending);
   virtual std::string BaseStaCommand();
   virtual std::string BaseStaScript(std::string libFileName,
                                     std::string netlistFileName,
@@ -249,6 +297,24 @@ class CompilerOpenFPGA : public Compiler {
                                     std::string sdcFileName);
   bool m_keepAllSignals = false;
   std::string m_DeviceNameforLicense;
+  /*!
+   * \brief m_rrGraphCache
+   * Used when the device does not provide routing_graph file.
+   */
+  RRGraphCache m_rrGraphCache;
+  /*!
+   * \brief m_staSession
+   * OpenSTA kept running between timing analysis runs and sta_session
+   * queries when m_staSessionEnabled is set.
+   */
+  StaSession m_staSession;
+  bool m_staSessionEnabled = false;
+  /*!
+   * \brief m_timingCorners
+   * Corners and constraint modes analysed by OpenSTA in parallel instead of
+   * the single design corner, set by timing_corners command.
+   */
+  TimingCornerAnalysis m_timingCorners;
 };
 
 }  // namespace FOEDAG
@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Compiler/Constraints.h"
 
 #include "Compiler/Compiler.h"
+#include "Compiler/ExecutionContext.h"
 #include "Configuration/CFGCommon/CFGCommon.h"
 #include "DesignQuery/DesignQuery.h"
 #include "MainWindow/Session.h"
@@ -31,6 +32,13 @@ using namespace FOEDAG;
 
 constexpr auto TimingLimitErrorMessage{"Invalid setting for -period: 0.1 1000"};
 
+// process current directory is not the stage directory, relative file
+// written while a stage runs goes to the stage directory
+static std::filesystem::path stagePath(const std::string& file) {
+  ExecutionContext* context = ExecutionContext::Current();
+  return context ? context->Path(file) : std::filesystem::path{file};
+}
+
 Constraints::Constraints(Compiler* compiler) : m_compiler(compiler) {
   m_interp = new TclInterpreter("");
   registerCommands(m_interp);
@@ -1208,7 +1216,7 @@ void Constraints::registerCommands(TclInterpreter* interp) {
     }
     std::string fileName = argv[1];
     std::ofstream stream;
-    stream.open(fileName);
+    stream.open(stagePath(fileName));
     if (!stream.good()) {
       Tcl_AppendResult(
           interp,
@@ -1296,14 +1304,14 @@ void Constraints::write_property(const std::string& filepath) {
   nlohmann::json instances = get_property_by_json();
   nlohmann::json json = nlohmann::json::object();
   json["instances"] = instances;
-  std::ofstream file(filepath);
+  std::ofstream file(stagePath(filepath));
   file << json.dump(2);
   file.close();
 }
 
 void Constraints::write_simplified_property(const std::string& filepath) {
   nlohmann::json properties = get_simplified_property_json();
-  std::ofstream file(filepath);
+  std::ofstream file(stagePath(filepath));
   file << properties.dump(2);
   file.close();
 }
@@ -0,0 +1,212 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ExecutionContext.h"
+
+#include <QProcess>
+#include <chrono>
+#include <fstream>
+
+#include "Utils/FileUtils.h"
+#include "Utils/ProcessUtils.h"
+#include "Utils/QtUtils.h"
+#include "Utils/Tracer.h"
+
+namespace fs = std::filesystem;
+using Time = std::chrono::high_resolution_clock;
+using ms = std::chrono::milliseconds;
+
+namespace FOEDAG {
+
+static thread_local ExecutionContext* s_current{nullptr};
+
+ExecutionContext::ExecutionContext(const fs::path& workingDir,
+                                   std::ostream* out, std::ostream* err)
+    : m_out(out), m_err(err) {
+  WorkingDir(workingDir);
+}
+
+void ExecutionContext::WorkingDir(const fs::path& dir) {
+  m_workingDir = dir.empty() ? fs::path{} : fs::absolute(dir);
+}
+
+fs::path ExecutionContext::Path(const fs::path& path) const {
+  if (path.empty() || path.is_absolute() || m_workingDir.empty()) return path;
+  return m_workingDir / path;
+}
+
+void ExecutionContext::SetEnvironmentVariable(const std::string& name,
+                                              const std::string& value) {
+  m_environment.insert_or_assign(name, value);
+}
+
+void ExecutionContext::StageValue(const std::string& name,
+                                  const std::string& value) {
+  m_stageValues[name] = value;
+}
+
+std::string ExecutionContext::StageValue(const std::string& name) const {
+  auto it = m_stageValues.find(name);
+  return (it != m_stageValues.end()) ? it->second : std::string{};
+}
+
+void ExecutionContext::Sinks(std::ostream* out, std::ostream* err) {
+  m_out = out;
+  m_err = err;
+}
+
+void ExecutionContext::SetError(const std::string& message) {
+  m_hasError = true;
+  m_error = message;
+}
+
+void ExecutionContext::ResetError() {
+  m_hasError = false;
+  m_error.clear();
+}
+
+void ExecutionContext::Stop() { m_stop = true; }
+
+// Split command line on spaces, double quoted arguments are kept together
+static QStringList splitCommand(const std::string& command) {
+  QStringList args = QtUtils::StringSplit(QString::fromStdString(command), ' ');
+  QStringList adjustedArgs;
+  QString current_arg;
+  for (int i = 0; i < args.size(); i++) {
+    QString arg = args[i];
+    if (args[i].front() == '\"' &&
+        args[i].back() != '\"') {      // Starting single-quote
+      current_arg = arg.remove(0, 1);  // remove leading quote
+    } else if (args[i].front() != '\"' &&
+               args[i].back() == '\"') {    // Ending single-quote
+      current_arg += " " + arg.chopped(1);  // remove trailing quote
+      adjustedArgs.push_back(current_arg);
+      current_arg = "";
+    } else if (args[i].front() == '\"' &&
+               args[i].back() == '\"') {  // Single-quoted argument
+      current_arg += " " + arg;
+      adjustedArgs.push_back(current_arg);
+      current_arg = "";
+    } else if (!current_arg.isEmpty()) {  // Continuing single-quoted argument
+      current_arg += " " + arg;
+    } else {  // Non-quoted argument
+      adjustedArgs.push_back(arg);
+    }
+  }
+  return adjustedArgs;
+}
+
+int ExecutionContext::Execute(const std::string& command,
+                              const std::string& logFile, bool appendLog,
+                              const fs::path& workingDir) {
+  if (m_stop) return -1;
+  auto start = Time::now();
+  if (m_out) (*m_out) << "Command: " << command << std::endl;
+  QStringList args = splitCommand(command);
+  if (args.isEmpty()) return -1;
+  const fs::path dir = workingDir.empty() ? m_workingDir : Path(workingDir);
+
+  // new QProcess must be created here to avoid issues related to creating
+  // QObjects in different threads
+  QProcess process;
+  if (!dir.empty()) {
+    FileUtils::MkDirs(dir);
+    process.setWorkingDirectory(QString::fromStdString(dir.string()));
+  }
+  QStringList env = QProcess::systemEnvironment();
+  for (const auto& [name, value] : m_environment)
+    env << QString::fromStdString(name + "=" + value);
+  process.setEnvironment(env);
+
+  std::ofstream ofs;
+  if (!logFile.empty()) {
+    std::ios_base::openmode openMode{std::ios_base::out};
+    if (appendLog) openMode = std::ios_base::out | std::ios_base::app;
+    fs::path log{logFile};
+    if (log.is_relative() && !dir.empty()) log = dir / log;
+    ofs.open(log, openMode);
+  }
+  QObject::connect(&process, &QProcess::readyReadStandardOutput,
+                   [this, &process, &ofs]() {
+                     QByteArray data = process.readAllStandardOutput();
+                     if (ofs.is_open()) ofs.write(data, data.size());
+                     if (m_out) m_out->write(data, data.size());
+                   });
+  QObject::connect(&process, &QProcess::readyReadStandardError,
+                   [this, &process, &ofs]() {
+                     QByteArray data = process.readAllStandardError();
+                     if (ofs.is_open()) ofs.write(data, data.size());
+                     if (m_err) m_err->write(data, data.size());
+                   });
+  ProcessUtils utils;
+  int64_t processId{0};
+  int64_t traceStart{0};
+  QObject::connect(&process, &QProcess::started,
+                   [&utils, &process, &processId, &traceStart]() {
+                     processId = process.processId();
+                     traceStart = Tracer::Instance()->Now();
+                     utils.Start(processId);
+                   });
+
+  // relative program is resolved against the working directory, same as the
+  // process current directory used to be switched before the start
+  fs::path program = args.takeFirst().toStdString();
+  if (program.has_parent_path() && program.is_relative() && !dir.empty())
+    program = dir / program;
+  process.start(QString::fromStdString(program.string()), args);
+  // process is owned by the calling thread, Stop() only sets the flag
+  while (process.state() != QProcess::NotRunning &&
+         !process.waitForFinished(100)) {
+    if (m_stop) {
+      process.terminate();
+      process.waitForFinished(-1);
+    }
+  }
+  utils.Stop();
+  ms d = std::chrono::duration_cast<ms>(Time::now() - start);
+  m_utils.utilization = utils.Utilization();
+  m_utils.duration = d.count();
+  m_utils.cpuTime = utils.CpuTime();
+  m_utils.peakRss = utils.PeakRss();
+  m_utils.readBytes = utils.ReadBytes();
+  m_utils.writeBytes = utils.WriteBytes();
+  m_total.append(m_utils);
+  if (ofs.is_open()) ofs.close();
+  if (process.error() == QProcess::FailedToStart) return -1;
+  const int status = (process.exitStatus() == QProcess::NormalExit)
+                         ? process.exitCode()
+                         : -1;
+  Tracer* tracer = Tracer::Instance();
+  if (tracer->Enabled())
+    tracer->Process(processId, command, traceStart,
+                    tracer->Now() - traceStart, status, m_utils.peakRss);
+  return status;
+}
+
+ExecutionContext* ExecutionContext::Current() { return s_current; }
+
+ExecutionContext::Scope::Scope(ExecutionContext& context)
+    : m_previous(s_current) {
+  s_current = &context;
+}
+
+ExecutionContext::Scope::~Scope() { s_current = m_previous; }
+
+}  // namespace FOEDAG
@@ -0,0 +1,140 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "Compiler/Task.h"
+
+namespace FOEDAG {
+
+/*!
+ * \brief The ExecutionContext class
+ * State of one compile invocation: working directory, environment, log sinks,
+ * running child process, its utilization, error state, stop token and stage
+ * values. Tools are started in the context working directory, process current
+ * directory is never changed, so several contexts can run concurrently in one
+ * process. Compiler runs different stages concurrently, one stage never runs
+ * twice at the same time.
+ */
+class ExecutionContext {
+ public:
+  /*!
+   * \brief ExecutionContext
+   * \param workingDir - made absolute, created on first Execute()
+   */
+  ExecutionContext(const std::filesystem::path& workingDir,
+                   std::ostream* out = &std::cout,
+                   std::ostream* err = &std::cerr);
+  ExecutionContext(const ExecutionContext&) = delete;
+  ExecutionContext& operator=(const ExecutionContext&) = delete;
+
+  const std::filesystem::path& WorkingDir() const { return m_workingDir; }
+  void WorkingDir(const std::filesystem::path& dir);
+
+  // \a path resolved against the working directory, commands writing files
+  // during a stage use it for relative file names
+  std::filesystem::path Path(const std::filesystem::path& path) const;
+
+  // existing variable is overridden
+  void SetEnvironmentVariable(const std::string& name,
+                              const std::string& value);
+  const std::map<std::string, std::string>& Environment() const {
+    return m_environment;
+  }
+
+  // values a stage body hands to the scripts and reports it generates
+  void StageValue(const std::string& name, const std::string& value);
+  std::string StageValue(const std::string& name) const;
+
+  std::ostream* Out() const { return m_out; }
+  std::ostream* Err() const { return m_err; }
+  void Sinks(std::ostream* out, std::ostream* err);
+
+  // utilization of the last executed command
+  ProcessUtilization Utilization() const { return m_utils; }
+  void Utilization(const ProcessUtilization& utils) { m_utils = utils; }
+  // utilization of all commands executed in this context
+  ProcessUtilization TotalUtilization() const { return m_total; }
+
+  // error reported by the next Execute() call instead of running the command
+  void SetError(const std::string& message);
+  void ResetError();
+  bool HasError() const { return m_hasError; }
+  const std::string& Error() const { return m_error; }
+
+  /*!
+   * \brief Stop
+   * Thread safe. Running command is terminated by the thread that executes
+   * it, following Execute() calls fail.
+   */
+  void Stop();
+  void ResetStop() { m_stop = false; }
+  bool Stopped() const { return m_stop; }
+
+  /*!
+   * \brief Execute
+   * Run \a command and wait for it. Output goes to the context sinks and to
+   * \a logFile if given. Relative \a workingDir is resolved against the
+   * context working directory, relative \a logFile against the directory the
+   * command runs in.
+   * \return exit code of the command or -1 if it crashed or was not started
+   */
+  int Execute(const std::string& command, const std::string& logFile = {},
+              bool appendLog = false,
+              const std::filesystem::path& workingDir = {});
+
+  // context bound to the calling thread, nullptr if none
+  static ExecutionContext* Current();
+
+  /*!
+   * \brief The Scope class
+   * Binds context to the calling thread for the scope lifetime.
+   */
+  class Scope {
+   public:
+    explicit Scope(ExecutionContext& context);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    ExecutionContext* m_previous{nullptr};
+  };
+
+ private:
+  std::filesystem::path m_workingDir;
+  std::map<std::string, std::string> m_environment;
+  std::map<std::string, std::string> m_stageValues;
+  std::ostream* m_out{nullptr};
+  std::ostream* m_err{nullptr};
+  ProcessUtilization m_utils{};
+  ProcessUtilization m_total{};
+  bool m_hasError{false};
+  std::string m_error;
+  std::atomic_bool m_stop{false};
+};
+
+}  // namespace FOEDAG
@@ -0,0 +1,213 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RRGraphCache.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <vector>
+
+#include "Utils/FileUtils.h"
+#include "nlohmann_json/json.hpp"
+
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+std::mutex RRGraphCache::m_vprVersionsLock{};
+std::map<std::string, std::string> RRGraphCache::m_vprVersions{};
+
+RRGraphCache::RRGraphCache() : m_directory(DefaultDirectory()) {}
+
+std::string RRGraphCache::Hash(const Key& key) const {
+  const std::string archHash = FileUtils::FileHash(key.architecture);
+  if (archHash.empty()) return {};
+  std::string layoutHash;
+  if (!key.customLayout.empty() && FileUtils::FileExists(key.customLayout))
+    layoutHash = FileUtils::FileHash(key.customLayout);
+
+  QCryptographicHash hash{QCryptographicHash::Sha1};
+  auto add = [&hash](const std::string& field) {
+    hash.addData(QByteArray::fromStdString(field));
+    hash.addData(QByteArray{1, '\0'});  // field separator
+  };
+  add(archHash);
+  add(layoutHash);
+  add(std::to_string(key.channelWidth));
+  add(key.deviceSize);
+  add(key.flatRouting ? "flat" : "");
+  add(key.vprVersion);
+  return hash.result().toHex().toStdString();
+}
+
+fs::path RRGraphCache::Lookup(const std::string& hash) const {
+  if (hash.empty()) return {};
+  const fs::path graph = m_directory / (hash + GraphExtension);
+  std::error_code ec;
+  if (!fs::is_regular_file(graph, ec) || fs::file_size(graph, ec) == 0)
+    return {};
+  fs::last_write_time(graph, fs::file_time_type::clock::now(), ec);
+  return graph;
+}
+
+fs::path RRGraphCache::PendingFile(const std::string& hash) const {
+  // concurrent stages of one process may build the same graph
+  static std::atomic_uint32_t counter{0};
+  std::stringstream name;
+  name << hash << "." << QCoreApplication::applicationPid() << "."
+       << counter++ << ".tmp" << GraphExtension;
+  return m_directory / name.str();
+}
+
+bool RRGraphCache::Commit(const fs::path& pending, const std::string& hash,
+                          const Key& key) {
+  std::error_code ec;
+  if (!fs::is_regular_file(pending, ec) || fs::file_size(pending, ec) == 0) {
+    FileUtils::removeFile(pending);
+    return false;
+  }
+  const fs::path graph = m_directory / (hash + GraphExtension);
+  // rename is atomic, another process could commit the same key meanwhile
+  fs::rename(pending, graph, ec);
+  if (ec) {
+    FileUtils::removeFile(pending);
+    return false;
+  }
+  nlohmann::json info;
+  info["architecture"] = key.architecture.string();
+  info["custom_layout"] = key.customLayout.string();
+  info["channel_width"] = key.channelWidth;
+  info["device_size"] = key.deviceSize;
+  info["flat_routing"] = key.flatRouting;
+  info["vpr_version"] = key.vprVersion;
+  FileUtils::WriteToFile(m_directory / (hash + InfoExtension), info.dump(2));
+  Evict();
+  return true;
+}
+
+struct CacheEntry {
+  fs::path graph;
+  fs::file_time_type time;
+  uint64_t size{0};
+};
+
+static std::vector<CacheEntry> cacheEntries(const fs::path& dir) {
+  std::vector<CacheEntry> entries;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator{dir, ec}) {
+    const auto& path = entry.path();
+    if (path.extension() != RRGraphCache::GraphExtension) continue;
+    // skip graphs not committed yet
+    if (path.stem().extension() == ".tmp") continue;
+    entries.push_back(
+        {path, entry.last_write_time(ec), FileUtils::FileSize(path)});
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const CacheEntry& e1, const CacheEntry& e2) {
+              return e1.time < e2.time;
+            });
+  return entries;
+}
+
+// pending graphs whose VPR run has ended long ago
+static void removeStalePending(const fs::path& dir) {
+  const auto oldest =
+      fs::file_time_type::clock::now() - RRGraphCache::PendingLifetime;
+  std::error_code ec;
+  std::vector<fs::path> stale;
+  for (const auto& entry : fs::directory_iterator{dir, ec}) {
+    const auto& path = entry.path();
+    if (path.extension() != RRGraphCache::GraphExtension) continue;
+    if (path.stem().extension() != ".tmp") continue;
+    if (entry.last_write_time(ec) < oldest) stale.push_back(path);
+  }
+  for (const auto& path : stale) FileUtils::removeFile(path);
+}
+
+static void removeEntry(const fs::path& graph) {
+  FileUtils::removeFile(graph);
+  auto info = graph;
+  FileUtils::removeFile(info.replace_extension(RRGraphCache::InfoExtension));
+}
+
+uint32_t RRGraphCache::Evict() {
+  removeStalePending(m_directory);
+  auto entries = cacheEntries(m_directory);
+  uint64_t total{0};
+  for (const auto& e : entries) total += e.size;
+  uint32_t removed{0};
+  for (const auto& e : entries) {
+    const bool tooMany =
+        (m_maxEntries != 0) && (entries.size() - removed > m_maxEntries);
+    const bool tooBig = (m_maxSizeBytes != 0) && (total > m_maxSizeBytes);
+    if (!tooMany && !tooBig) break;
+    removeEntry(e.graph);
+    total -= e.size;
+    removed++;
+  }
+  return removed;
+}
+
+uint32_t RRGraphCache::Clear() {
+  auto entries = cacheEntries(m_directory);
+  for (const auto& e : entries) removeEntry(e.graph);
+  return static_cast<uint32_t>(entries.size());
+}
+
+RRGraphCache::Stats RRGraphCache::Statistics() const {
+  Stats stats;
+  for (const auto& e : cacheEntries(m_directory)) {
+    stats.entries++;
+    stats.sizeBytes += e.size;
+  }
+  return stats;
+}
+
+std::string RRGraphCache::VprVersion(const fs::path& vpr) {
+  const std::string key =
+      vpr.string() + ":" + std::to_string(FileUtils::Mtime(vpr));
+  {
+    std::scoped_lock lock{m_vprVersionsLock};
+    auto it = m_vprVersions.find(key);
+    if (it != m_vprVersions.end()) return it->second;
+  }
+  // stages asking at the same time may both run VPR, results are the same
+  std::ostringstream out;
+  auto result = FileUtils::ExecuteSystemCommand(vpr.string(), {"--version"},
+                                                &out, 10000);
+  std::string version = (result.code == 0) ? out.str() : std::string{};
+  std::scoped_lock lock{m_vprVersionsLock};
+  m_vprVersions.emplace(key, version);
+  return version;
+}
+
+fs::path RRGraphCache::DefaultDirectory() {
+  if (const char* dir = std::getenv("FOEDAG_RR_GRAPH_CACHE")) return dir;
+  const QString cache =
+      QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+  if (cache.isEmpty()) return fs::temp_directory_path() / "foedag" / "rr_graph";
+  return fs::path{cache.toStdString()} / "foedag" / "rr_graph";
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,135 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The RRGraphCache class
+ * Per-user cache of binary VPR routing resource graphs. Entries are keyed by
+ * everything that affects the graph VPR builds: architecture content, channel
+ * width, device size, flat routing and the VPR version. First VPR run for a
+ * key writes the graph (--write_rr_graph), next runs read it back
+ * (--read_rr_graph) instead of rebuilding it from the architecture.
+ * Disabled by default, the graphs take hundreds of MB each.
+ */
+class RRGraphCache {
+ public:
+  struct Key {
+    std::filesystem::path architecture;
+    std::filesystem::path customLayout;
+    uint32_t channelWidth{0};
+    std::string deviceSize;
+    bool flatRouting{false};
+    std::string vprVersion;
+  };
+
+  RRGraphCache();
+
+  bool Enabled() const { return m_enabled; }
+  void Enabled(bool enabled) { m_enabled = enabled; }
+
+  const std::filesystem::path& Directory() const { return m_directory; }
+  void Directory(const std::filesystem::path& dir) { m_directory = dir; }
+
+  // 0 means no limit
+  uint32_t MaxEntries() const { return m_maxEntries; }
+  void MaxEntries(uint32_t entries) { m_maxEntries = entries; }
+
+  // 0 means no limit
+  uint64_t MaxSizeBytes() const { return m_maxSizeBytes; }
+  void MaxSizeBytes(uint64_t bytes) { m_maxSizeBytes = bytes; }
+
+  /*!
+   * \brief Hash
+   * \return unique name of the cache entry for \a key or empty string if
+   * architecture file can't be read.
+   */
+  std::string Hash(const Key& key) const;
+
+  /*!
+   * \brief Lookup
+   * \return path to the cached graph for \a hash or empty path. Hit updates
+   * the entry timestamp so eviction keeps the recently used graphs.
+   */
+  std::filesystem::path Lookup(const std::string& hash) const;
+
+  /*!
+   * \brief PendingFile
+   * \return unique temporary file VPR should write the graph to, new one on
+   * every call.
+   * Call Commit() once VPR succeeded.
+   */
+  std::filesystem::path PendingFile(const std::string& hash) const;
+
+  /*!
+   * \brief Commit
+   * Move \a pending graph into the cache under \a hash and apply the limits.
+   */
+  bool Commit(const std::filesystem::path& pending, const std::string& hash,
+              const Key& key);
+
+  /*!
+   * \brief Evict
+   * Remove least recently used entries until the cache fits the limits and
+   * pending files left by runs that were killed.
+   * \return number of removed entries.
+   */
+  uint32_t Evict();
+
+  uint32_t Clear();
+
+  struct Stats {
+    uint32_t entries{0};
+    uint64_t sizeBytes{0};
+  };
+  Stats Statistics() const;
+
+  /*!
+   * \brief VprVersion
+   * Run '<vpr> --version' once per executable and return its output.
+   */
+  static std::string VprVersion(const std::filesystem::path& vpr);
+
+  static std::filesystem::path DefaultDirectory();
+
+  static constexpr const char* GraphExtension{".bin"};
+  static constexpr const char* InfoExtension{".json"};
+  // pending file older than this is not written by any running VPR
+  static constexpr std::chrono::hours PendingLifetime{24};
+
+ private:
+  bool m_enabled{false};
+  std::filesystem::path m_directory;
+  uint32_t m_maxEntries{8};
+  uint64_t m_maxSizeBytes{8ull * 1024 * 1024 * 1024};
+  static std::mutex m_vprVersionsLock;
+  static std::map<std::string, std::string> m_vprVersions;
+};
+
+}  // namespace FOEDAG
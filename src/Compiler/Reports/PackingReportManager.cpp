@@ -9,6 +9,7 @@
 #include "DefaultTaskReport.h"
 #include "TableReport.h"
 #include "Utils/FileUtils.h"
+#include "Utils/Tracer.h"
 
 namespace {
 // report names
@@ -103,6 +104,7 @@ void PackingReportManager::splitTimingData(const QString &timingStr) {
 }
 
 void PackingReportManager::parseLogFile() {
+  TraceScope scope{"parse packing log", "report"};
   clean();
   auto logFile = createLogFile();
   if (!logFile) return;
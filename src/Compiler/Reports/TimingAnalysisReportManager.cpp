@@ -24,12 +24,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QFile>
 #include <QRegularExpression>
 #include <QTextStream>
+#include <map>
 
 #include "Compiler.h"
 #include "CompilerDefines.h"
 #include "DefaultTaskReport.h"
 #include "TableReport.h"
 #include "Utils/FileUtils.h"
+#include "Utils/Tracer.h"
 
 namespace {
 static constexpr const char *DESIGN_STAT_REPORT_NAME{"STA - Design statistics"};
@@ -272,6 +274,7 @@ void TimingAnalysisReportManager::splitTimingData(const QString &timingStr) {
 }
 
 void TimingAnalysisReportManager::parseLogFile() {
+  TraceScope scope{"parse sta log", "report"};
   clean();
   if (isOpensta()) return;
   auto logFile = createLogFile();
@@ -583,4 +586,64 @@ void TimingAnalysisReportManager::parseInterSetupSection(const QString &line) {
   }
 }
 
+std::vector<EndpointSlack> TimingAnalysisReportManager::ParseEndpointSlacks(
+    const std::filesystem::path &report) {
+  static const QRegularExpression endpointRegex{
+      "^\\s*Endpoint\\s*:\\s*(\\S+)"};
+  static const QRegularExpression pathTypeRegex{
+      "^\\s*Path Type\\s*:\\s*(\\S+)"};
+  // OpenSTA prints slack value before the label, VPR after it
+  static const QRegularExpression slackRegex{
+      QString{"^\\s*(%1\\s+)?slack \\((MET|VIOLATED)[^)]*\\)(\\s+%1)?"}.arg(
+          FloatRegex())};
+
+  std::vector<EndpointSlack> slacks;
+  QFile file{QString::fromStdString(report.string())};
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return slacks;
+  QTextStream in{&file};
+
+  std::map<std::pair<std::string, std::string>, size_t> index;
+  QString line;
+  QString endpoint;
+  QString check;
+  while (in.readLineInto(&line)) {
+    auto match = endpointRegex.match(line);
+    if (match.hasMatch()) {
+      endpoint = match.captured(1);
+      check.clear();
+      continue;
+    }
+    match = pathTypeRegex.match(line);
+    if (match.hasMatch()) {
+      const QString type = match.captured(1).toLower();
+      if (type == "max" || type == "setup")
+        check = "setup";
+      else if (type == "min" || type == "hold")
+        check = "hold";
+      else
+        check = type;
+      continue;
+    }
+    match = slackRegex.match(line);
+    if (!match.hasMatch() || endpoint.isEmpty()) continue;
+    const QString value =
+        match.captured(2).isEmpty() ? match.captured(7) : match.captured(2);
+    bool ok{false};
+    const double slack = value.toDouble(&ok);
+    if (!ok) continue;
+    EndpointSlack data;
+    data.endpoint = endpoint.toStdString();
+    data.check = check.isEmpty() ? "setup" : check.toStdString();
+    data.slack = slack;
+    auto [it, inserted] =
+        index.emplace(std::make_pair(data.check, data.endpoint), slacks.size());
+    if (inserted)
+      slacks.push_back(data);
+    else if (slack < slacks[it->second].slack)
+      slacks[it->second].slack = slack;
+    endpoint.clear();
+  }
+  return slacks;
+}
+
 }  // namespace FOEDAG
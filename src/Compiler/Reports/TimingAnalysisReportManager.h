@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include "AbstractReportManager.h"
+#include "Compiler/TimingCorners.h"
 
 namespace FOEDAG {
 class Compiler;
@@ -34,6 +35,15 @@ class TimingAnalysisReportManager final : public AbstractReportManager {
   TimingAnalysisReportManager(const TaskManager &taskManager,
                               Compiler *compiler);
 
+  /*!
+   * \brief ParseEndpointSlacks
+   * Worst slack of every endpoint and check (setup or hold) in report of
+   * OpenSTA report_checks or VPR report_timing, in order of appearance.
+   * Unconstrained paths have no slack and are skipped.
+   */
+  static std::vector<EndpointSlack> ParseEndpointSlacks(
+      const std::filesystem::path &report);
+
  private:
   bool isOpensta() const;
   void parseStatisticLine(const QString &line) override;
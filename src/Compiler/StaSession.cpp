@@ -0,0 +1,365 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "StaSession.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Utils/FileUtils.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+// Tcl procedure evaluating one command in a frame, one line
+static constexpr const char* FrameProc{
+    "proc foedag_frame {id cmd} {puts \"@@FOEDAG_BEGIN $id\"; "
+    "set status [catch {uplevel #0 $cmd} result]; "
+    "if {$result ne \"\"} {puts $result}; "
+    "puts \"@@FOEDAG_END $id $status\"; flush stdout}\n"};
+
+// command is sent as one braced Tcl word
+static bool balancedBraces(const std::string& command) {
+  int depth{0};
+  for (size_t i = 0; i < command.size(); i++) {
+    if (command[i] == '\\') {
+      if (++i == command.size()) return false;  // would escape the brace
+    } else if (command[i] == '{') {
+      depth++;
+    } else if (command[i] == '}' && --depth < 0) {
+      return false;
+    }
+  }
+  return depth == 0;
+}
+
+static int64_t now() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+StaSession::StaSession(const fs::path& executable)
+    : m_executable(executable) {}
+
+StaSession::~StaSession() { Stop(); }
+
+bool StaSession::Running() const {
+  std::lock_guard<std::mutex> lock{m_lock};
+  return m_pid >= 0;
+}
+
+StaSession::Stats StaSession::Statistics() const {
+  std::lock_guard<std::mutex> lock{m_lock};
+  return m_stats;
+}
+
+void StaSession::Stop() {
+  std::lock_guard<std::mutex> lock{m_lock};
+  stop(true);
+}
+
+StaSession::Stamp StaSession::stamp(const fs::path& file,
+                                    const Stamp& previous) {
+  std::error_code ec;
+  Stamp result;
+  result.time = fs::last_write_time(file, ec);
+  result.size = fs::file_size(file, ec);
+  // flow rewrites its outputs on every run, content tells if they changed
+  if (!previous.hash.empty() && result.time == previous.time &&
+      result.size == previous.size)
+    result.hash = previous.hash;
+  else
+    result.hash = FileUtils::FileHash(file);
+  return result;
+}
+
+bool StaSession::Load(const StaDesign& design, std::string* error) {
+  std::lock_guard<std::mutex> lock{m_lock};
+  for (const auto& file :
+       {design.liberty, design.netlist, design.sdf, design.sdc}) {
+    if (!fs::is_regular_file(file)) {
+      if (error) *error = "Timing input " + file.string() + " does not exist";
+      return false;
+    }
+  }
+  const Stamp liberty = stamp(design.liberty, m_liberty);
+  const Stamp netlist = stamp(design.netlist, m_netlist);
+  const Stamp sdf = stamp(design.sdf, m_sdf);
+  const Stamp sdc = stamp(design.sdc, m_sdc);
+  // liberty can't be replaced in a running session
+  if (m_pid >= 0 &&
+      (m_started != m_executable || design.liberty != m_design.liberty ||
+       !(liberty == m_liberty) || design.top != m_design.top))
+    stop(true);
+  if (m_pid < 0 && !start(error)) return false;
+
+  std::vector<std::string> commands;
+  if (!m_loaded)
+    commands.push_back("read_liberty {" + design.liberty.string() + "}");
+  const bool relink = !m_loaded || design.netlist != m_design.netlist ||
+                      !(netlist == m_netlist) || design.sdc != m_design.sdc ||
+                      !(sdc == m_sdc);
+  const bool annotate =
+      relink || design.sdf != m_design.sdf || !(sdf == m_sdf);
+  if (relink) {
+    commands.push_back("read_verilog {" + design.netlist.string() + "}");
+    commands.push_back("link_design {" + design.top + "}");
+  }
+  if (annotate) commands.push_back("read_sdf {" + design.sdf.string() + "}");
+  if (relink) commands.push_back("read_sdc {" + design.sdc.string() + "}");
+  if (commands.empty()) return true;
+
+  std::string output;
+  for (const auto& command : commands) {
+    if (!eval(command, output, error)) {
+      // partially loaded design is not reused
+      stop(false);
+      return false;
+    }
+  }
+  if (relink) m_stats.links++;
+  if (annotate) m_stats.sdfReads++;
+  m_loaded = true;
+  m_design = design;
+  m_liberty = liberty;
+  m_netlist = netlist;
+  m_sdf = sdf;
+  m_sdc = sdc;
+  return true;
+}
+
+bool StaSession::Query(const std::string& command, std::string& output,
+                       std::string* error) {
+  std::lock_guard<std::mutex> lock{m_lock};
+  output.clear();
+  if (m_pid < 0 || !m_loaded) {
+    if (error) *error = "STA session has no design loaded";
+    return false;
+  }
+  m_stats.queries++;
+  return eval(command, output, error);
+}
+
+#ifndef _WIN32
+
+static bool writeAll(int fd, const std::string& data) {
+  const char* ptr = data.data();
+  size_t size = data.size();
+  while (size > 0) {
+    ssize_t written = ::send(fd, ptr, size, MSG_NOSIGNAL);
+    if (written < 0 && errno == EINTR) continue;
+    if (written <= 0) return false;
+    ptr += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+bool StaSession::start(std::string* error) {
+  int fds[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    if (error)
+      *error = std::string{"Cannot create STA session socket: "} +
+               std::strerror(errno);
+    return false;
+  }
+  ::fcntl(fds[0], F_SETFD, ::fcntl(fds[0], F_GETFD) | FD_CLOEXEC);
+  // nothing may be allocated in the child of a multithreaded process
+  const std::string executable = m_executable.has_parent_path()
+                                     ? fs::absolute(m_executable).string()
+                                     : m_executable.string();
+  const std::string dir = m_workingDir.string();
+  const std::string failure = "Cannot execute " + executable + "\n";
+  const pid_t pid = ::fork();
+  if (pid < 0) {
+    if (error) *error = std::string{"fork failed: "} + std::strerror(errno);
+    ::close(fds[0]);
+    ::close(fds[1]);
+    return false;
+  }
+  if (pid == 0) {
+    // own process group, so tools started by the session are stopped too
+    ::setpgid(0, 0);
+    ::dup2(fds[1], STDIN_FILENO);
+    ::dup2(fds[1], STDOUT_FILENO);
+    ::dup2(fds[1], STDERR_FILENO);
+    if (fds[1] > STDERR_FILENO) ::close(fds[1]);
+    if (dir.empty() || ::chdir(dir.c_str()) == 0)
+      ::execlp(executable.c_str(), executable.c_str(), nullptr);
+    [[maybe_unused]] auto res =
+        ::write(STDOUT_FILENO, failure.data(), failure.size());
+    ::_exit(127);
+  }
+  ::close(fds[1]);
+  m_pid = pid;
+  m_socket = fds[0];
+  m_buffer.clear();
+  m_loaded = false;
+  m_started = m_executable;
+  m_stats.starts++;
+  std::string output;
+  std::string reason;
+  bool ok = writeAll(m_socket, FrameProc);
+  if (ok) {
+    ok = eval({}, output, &reason);
+  } else {
+    // tool exited already, what it printed tells why
+    reason = "STA session terminated";
+    std::string line;
+    const int64_t deadline = now() + 1000;
+    while (readLine(line, deadline, nullptr)) output += line + "\n";
+    if (!output.empty()) reason += ": " + output;
+  }
+  if (!ok) {
+    if (error) *error = "Cannot start STA session: " + reason;
+    stop(false);
+    return false;
+  }
+  return true;
+}
+
+void StaSession::stop(bool graceful) {
+  if (m_pid < 0) return;
+  if (graceful) writeAll(m_socket, "exit\n");
+  ::close(m_socket);
+  bool finished{false};
+  for (int i = 0; graceful && i < 50 && !finished; i++) {
+    finished = ::waitpid(m_pid, nullptr, WNOHANG) == m_pid;
+    if (!finished) std::this_thread::sleep_for(std::chrono::milliseconds{20});
+  }
+  if (!finished) {
+    ::kill(-m_pid, SIGKILL);
+    ::waitpid(m_pid, nullptr, 0);
+  }
+  m_pid = -1;
+  m_socket = -1;
+  m_buffer.clear();
+  m_loaded = false;
+}
+
+bool StaSession::eval(const std::string& command, std::string& output,
+                      std::string* error) {
+  output.clear();
+  if (!balancedBraces(command)) {
+    if (error) *error = "Unbalanced braces in STA command: " + command;
+    return false;
+  }
+  const std::string frame = std::to_string(++m_frame);
+  if (!writeAll(m_socket, "foedag_frame " + frame + " {" + command + "}\n")) {
+    if (error) *error = "STA session terminated";
+    stop(false);
+    return false;
+  }
+  const int64_t deadline = m_timeout ? now() + m_timeout : 0;
+  const std::string begin = std::string{FrameBegin} + " " + frame;
+  const std::string end = std::string{FrameEnd} + " " + frame + " ";
+  std::string line;
+  std::string skipped;
+  bool inFrame{false};
+  while (readLine(line, deadline, error)) {
+    if (!inFrame) {
+      inFrame = (line == begin);
+      if (!inFrame) skipped += line + "\n";
+    } else if (line.compare(0, end.size(), end) == 0) {
+      const bool ok = line.substr(end.size()) == "0";
+      if (!ok && error) *error = command + " failed: " + output;
+      return ok;
+    } else {
+      output += line + "\n";
+    }
+  }
+  // output printed before the frame tells why the tool exited
+  if (error && !skipped.empty()) *error += ": " + skipped;
+  stop(false);
+  return false;
+}
+
+bool StaSession::readLine(std::string& line, int64_t deadline,
+                          std::string* error) {
+  while (true) {
+    const size_t pos = m_buffer.find('\n');
+    if (pos != std::string::npos) {
+      line = m_buffer.substr(0, pos);
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      m_buffer.erase(0, pos + 1);
+      return true;
+    }
+    int wait{-1};
+    if (deadline != 0) {
+      const int64_t left = deadline - now();
+      if (left <= 0) {
+        if (error) *error = "STA command timed out";
+        return false;
+      }
+      wait = static_cast<int>(left);
+    }
+    pollfd fd{m_socket, POLLIN, 0};
+    const int res = ::poll(&fd, 1, wait);
+    if (res < 0 && errno != EINTR) {
+      if (error) *error = std::string{"poll failed: "} + std::strerror(errno);
+      return false;
+    }
+    if (res <= 0) continue;  // interrupted or timed out
+    char chunk[64 * 1024];
+    const ssize_t count = ::read(m_socket, chunk, sizeof(chunk));
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) {
+      if (error) *error = "STA session terminated";
+      return false;
+    }
+    m_buffer.append(chunk, static_cast<size_t>(count));
+  }
+}
+
+#else
+
+bool StaSession::start(std::string* error) {
+  if (error) *error = "STA session is not supported on this platform";
+  return false;
+}
+
+void StaSession::stop(bool) {}
+
+bool StaSession::eval(const std::string&, std::string&, std::string* error) {
+  if (error) *error = "STA session is not supported on this platform";
+  return false;
+}
+
+bool StaSession::readLine(std::string&, int64_t, std::string*) {
+  return false;
+}
+
+#endif
+
+}  // namespace FOEDAG
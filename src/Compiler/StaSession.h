@@ -0,0 +1,141 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+namespace FOEDAG {
+
+// timing inputs of the design, all files must exist
+struct StaDesign {
+  std::filesystem::path liberty;
+  std::filesystem::path netlist;
+  std::filesystem::path sdf;
+  std::filesystem::path sdc;
+  std::string top;
+};
+
+/*!
+ * \brief The StaSession class
+ * Long-lived OpenSTA process fed through its standard input. Design inputs
+ * are read once; Load() re-reads only the inputs whose content changed since
+ * the previous load, files rewritten unchanged are kept: new liberty restarts
+ * the process, new netlist or SDC re-links the design, new SDF is annotated
+ * again. Every
+ * command is evaluated in a numbered frame, so its output is separated from
+ * anything else the tool prints:
+ *   @@FOEDAG_BEGIN <id>
+ *   <output of the command and its Tcl result>
+ *   @@FOEDAG_END <id> <status>
+ * Supported on Unix only, Load() fails elsewhere.
+ */
+class StaSession {
+ public:
+  explicit StaSession(const std::filesystem::path& executable = "sta");
+  ~StaSession();
+  StaSession(const StaSession&) = delete;
+  StaSession& operator=(const StaSession&) = delete;
+
+  // running session is restarted by the next Load() if executable changed
+  const std::filesystem::path& Executable() const { return m_executable; }
+  void Executable(const std::filesystem::path& executable) {
+    m_executable = executable;
+  }
+
+  // directory the process is started in
+  const std::filesystem::path& WorkingDir() const { return m_workingDir; }
+  void WorkingDir(const std::filesystem::path& dir) { m_workingDir = dir; }
+
+  // time in ms one command may take, 0 means no limit
+  uint32_t Timeout() const { return m_timeout; }
+  void Timeout(uint32_t timeout) { m_timeout = timeout; }
+
+  bool Running() const;
+
+  /*!
+   * \brief Load
+   * Start the session if needed and bring it in sync with \a design.
+   */
+  bool Load(const StaDesign& design, std::string* error = nullptr);
+
+  /*!
+   * \brief Query
+   * Evaluate \a command, e.g. report_checks -path_delay min, in the loaded
+   * design. \a output receives everything the command printed.
+   * \return false if the command failed or the session is gone, \a error
+   * tells which one.
+   */
+  bool Query(const std::string& command, std::string& output,
+             std::string* error = nullptr);
+
+  // terminate the process, next Load() starts a new one
+  void Stop();
+
+  struct Stats {
+    uint32_t starts{0};
+    uint32_t links{0};
+    uint32_t sdfReads{0};
+    uint32_t queries{0};
+  };
+  Stats Statistics() const;
+
+  static constexpr const char* FrameBegin{"@@FOEDAG_BEGIN"};
+  static constexpr const char* FrameEnd{"@@FOEDAG_END"};
+
+ private:
+  struct Stamp {
+    std::filesystem::file_time_type time;
+    uintmax_t size{0};
+    std::string hash;
+    bool operator==(const Stamp& other) const {
+      return size == other.size && hash == other.hash;
+    }
+  };
+  // file is hashed again unless time and size match the previous stamp
+  static Stamp stamp(const std::filesystem::path& file, const Stamp& previous);
+  bool start(std::string* error);
+  void stop(bool graceful);
+  bool eval(const std::string& command, std::string& output,
+            std::string* error);
+  bool readLine(std::string& line, int64_t deadline, std::string* error);
+
+  std::filesystem::path m_executable;
+  std::filesystem::path m_started;
+  std::filesystem::path m_workingDir;
+  uint32_t m_timeout{0};
+  int m_pid{-1};
+  int m_socket{-1};
+  std::string m_buffer;
+  uint64_t m_frame{0};
+  bool m_loaded{false};
+  StaDesign m_design;
+  Stamp m_liberty;
+  Stamp m_netlist;
+  Stamp m_sdf;
+  Stamp m_sdc;
+  Stats m_stats;
+  mutable std::mutex m_lock;
+};
+
+}  // namespace FOEDAG
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QIcon>
 #include <QObject>
 #include <QVector>
+#include <algorithm>
 
 namespace FOEDAG {
 
@@ -52,8 +53,21 @@ struct CustomData {
 };
 
 struct ProcessUtilization {
-  uint duration{};
-  uint utilization{};
+  uint duration{};     // wall time, ms
+  uint utilization{};  // max virtual memory, kiB
+  uint cpuTime{};      // user + system time, ms
+  uint peakRss{};      // max resident set size, kiB
+  quint64 readBytes{};
+  quint64 writeBytes{};
+  // sums times and I/O, keeps max of memory usage
+  void append(const ProcessUtilization &other) {
+    duration += other.duration;
+    utilization = std::max(utilization, other.utilization);
+    cpuTime += other.cpuTime;
+    peakRss = std::max(peakRss, other.peakRss);
+    readBytes += other.readBytes;
+    writeBytes += other.writeBytes;
+  }
 };
 
 enum SettingType { SYN, IMPL, GEN };
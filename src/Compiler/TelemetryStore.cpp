@@ -0,0 +1,410 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TelemetryStore.h"
+
+#include <QLockFile>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+// smaller times are dominated by tool startup
+static constexpr double NoiseFloorMs{1000};
+// baseline needs at least this number of runs
+static constexpr size_t MinBaseline{2};
+
+static constexpr char Magic[] = {'F', 'T', 'E', 'L'};
+static constexpr uint32_t Version{1};
+static constexpr size_t HeaderSize{sizeof(Magic) + sizeof(uint32_t)};
+// kind, payload size, payload, checksum
+static constexpr size_t FrameOverhead{1 + 4 + 4};
+
+enum FrameKind : uint8_t { StringFrame = 1, RecordFrame = 2 };
+
+// little endian encoding of fixed width fields
+class Writer {
+ public:
+  template <typename T>
+  void put(T value) {
+    uint64_t bits{0};
+    std::memcpy(&bits, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++)
+      m_data.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+  }
+  void put(const std::string& str) { m_data += str; }
+  const std::string& data() const { return m_data; }
+
+ private:
+  std::string m_data;
+};
+
+class Reader {
+ public:
+  Reader(const char* data, size_t size) : m_data(data), m_size(size) {}
+  template <typename T>
+  bool get(T& value) {
+    if (m_size - m_pos < sizeof(T)) return false;
+    uint64_t bits{0};
+    for (size_t i = 0; i < sizeof(T); i++)
+      bits |= uint64_t{static_cast<uint8_t>(m_data[m_pos + i])} << (8 * i);
+    std::memcpy(&value, &bits, sizeof(T));
+    m_pos += sizeof(T);
+    return true;
+  }
+  bool atEnd() const { return m_pos == m_size; }
+
+ private:
+  const char* m_data;
+  size_t m_size;
+  size_t m_pos{0};
+};
+
+// FNV-1a
+static uint32_t checksum(uint8_t kind, const std::string& payload) {
+  uint32_t hash{2166136261u};
+  auto add = [&hash](uint8_t byte) {
+    hash ^= byte;
+    hash *= 16777619u;
+  };
+  add(kind);
+  for (char c : payload) add(static_cast<uint8_t>(c));
+  return hash;
+}
+
+static void frame(Writer& out, FrameKind kind, const std::string& payload) {
+  out.put(static_cast<uint8_t>(kind));
+  out.put(static_cast<uint32_t>(payload.size()));
+  out.put(payload);
+  out.put(checksum(kind, payload));
+}
+
+static double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  const size_t middle = values.size() / 2;
+  return (values.size() % 2) ? values.at(middle)
+                             : (values.at(middle - 1) + values.at(middle)) / 2;
+}
+
+TelemetryStore::TelemetryStore(const fs::path& file) : m_file(file) {}
+
+void TelemetryStore::File(const fs::path& file) {
+  std::scoped_lock lock{m_lock};
+  if (file == m_file) return;
+  m_file = file;
+  reset();
+}
+
+void TelemetryStore::reset() const {
+  m_loaded = false;
+  m_foreign = false;
+  m_fileSize = 0;
+  m_validSize = 0;
+  m_strings.clear();
+  m_stringIds.clear();
+  m_records.clear();
+  m_stages.clear();
+  m_lastRun = 0;
+}
+
+bool TelemetryStore::load(bool force) const {
+  std::error_code ec;
+  const uintmax_t size = fs::file_size(m_file, ec);
+  if (ec) {
+    // missing file is empty store
+    reset();
+    m_loaded = true;
+    return true;
+  }
+  if (m_loaded && size == m_fileSize && !force) return !m_foreign;
+  if (m_loaded && !m_foreign && m_validSize >= HeaderSize &&
+      size >= m_validSize) {
+    // other sessions only append, frames after the last valid one are read
+    std::ifstream in{m_file, std::ios::binary};
+    in.seekg(m_validSize);
+    std::string data{std::istreambuf_iterator<char>{in},
+                     std::istreambuf_iterator<char>{}};
+    m_fileSize = m_validSize + data.size();
+    parseFrames(data);
+    // otherwise the write was interrupted or the file was replaced
+    if (m_validSize == m_fileSize) return true;
+  }
+  reset();
+  std::ifstream in{m_file, std::ios::binary};
+  std::string data{std::istreambuf_iterator<char>{in},
+                   std::istreambuf_iterator<char>{}};
+  m_loaded = true;
+  m_fileSize = data.size();
+  m_foreign = !parse(data);
+  return !m_foreign;
+}
+
+bool TelemetryStore::parse(const std::string& data) const {
+  if (data.size() < HeaderSize) return data.empty();
+  Reader header{data.data(), HeaderSize};
+  uint32_t version{0};
+  for (char c : Magic) {
+    char byte{0};
+    if (!header.get(byte) || byte != c) return false;
+  }
+  if (!header.get(version) || version != Version) return false;
+  m_validSize = HeaderSize;
+  parseFrames(data.substr(HeaderSize));
+  return true;
+}
+
+void TelemetryStore::parseFrames(const std::string& data) const {
+  size_t pos{0};
+  while (data.size() - pos >= FrameOverhead) {
+    Reader frameHeader{data.data() + pos, 5};
+    uint8_t kind{0};
+    uint32_t size{0};
+    frameHeader.get(kind);
+    frameHeader.get(size);
+    if (data.size() - pos - FrameOverhead < size) break;  // truncated
+    const std::string payload = data.substr(pos + 5, size);
+    Reader tail{data.data() + pos + 5 + size, 4};
+    uint32_t sum{0};
+    tail.get(sum);
+    if (sum != checksum(kind, payload)) break;  // broken frame
+
+    Reader in{payload.data(), payload.size()};
+    if (kind == StringFrame) {
+      m_stringIds.emplace(payload, static_cast<uint32_t>(m_strings.size()));
+      m_strings.push_back(payload);
+    } else if (kind == RecordFrame) {
+      TelemetryRecord record;
+      uint32_t stage{0};
+      uint8_t success{0};
+      uint16_t qorCount{0};
+      bool ok = in.get(record.run) && in.get(record.timestamp) &&
+                in.get(stage) && in.get(success) &&
+                in.get(record.wallTime) && in.get(record.cpuTime) &&
+                in.get(record.peakRss) && in.get(record.readBytes) &&
+                in.get(record.writeBytes) && in.get(qorCount) &&
+                stage < m_strings.size();
+      for (uint16_t i = 0; ok && i < qorCount; i++) {
+        uint32_t name{0};
+        double value{0};
+        ok = in.get(name) && in.get(value) && name < m_strings.size();
+        if (ok) record.qor[m_strings.at(name)] = value;
+      }
+      if (!ok) break;
+      record.stage = m_strings.at(stage);
+      record.success = success != 0;
+      m_lastRun = std::max(m_lastRun, record.run);
+      m_stages[record.stage].push_back(m_records.size());
+      m_records.push_back(std::move(record));
+    }
+    // unknown frames are skipped, newer versions may add them
+    pos += FrameOverhead + size;
+    m_validSize += FrameOverhead + size;
+  }
+}
+
+uint32_t TelemetryStore::NextRun() const {
+  std::scoped_lock lock{m_lock};
+  load();
+  return m_lastRun + 1;
+}
+
+bool TelemetryStore::Append(const TelemetryRecord& record,
+                            std::string* error) {
+  std::scoped_lock lock{m_lock};
+  if (m_file.empty()) {
+    if (error) *error = "Telemetry file is not set";
+    return false;
+  }
+  std::error_code ec;
+  if (m_file.has_parent_path())
+    fs::create_directories(m_file.parent_path(), ec);
+  // String ids are positions in the file. Other sessions append to the same
+  // file, so their frames are read and the write is done under the file
+  // lock.
+  QLockFile fileLock{QString::fromStdString(m_file.string() + ".lock")};
+  if (!fileLock.lock()) {
+    if (error) *error = "Failed to lock telemetry file " + m_file.string();
+    return false;
+  }
+  if (!load(true)) {
+    if (error) *error = m_file.string() + " is not a telemetry file";
+    return false;
+  }
+  // previous write could be interrupted, broken frame is dropped
+  if (m_fileSize > m_validSize) {
+    fs::resize_file(m_file, m_validSize, ec);
+    if (ec) {
+      if (error) *error = "Failed to repair telemetry file " + m_file.string();
+      return false;
+    }
+    m_fileSize = m_validSize;
+  }
+
+  Writer out;
+  if (m_validSize == 0) {
+    for (char c : Magic) out.put(c);
+    out.put(Version);
+  }
+  std::vector<std::string> strings;
+  auto id = [this, &strings, &out](const std::string& str) {
+    auto it = m_stringIds.find(str);
+    if (it != m_stringIds.end()) return it->second;
+    auto added = std::find(strings.begin(), strings.end(), str);
+    if (added == strings.end()) {
+      frame(out, StringFrame, str);
+      added = strings.insert(strings.end(), str);
+    }
+    return static_cast<uint32_t>(m_strings.size() + (added - strings.begin()));
+  };
+  Writer payload;
+  payload.put(record.run);
+  payload.put(record.timestamp);
+  payload.put(id(record.stage));
+  payload.put(static_cast<uint8_t>(record.success));
+  payload.put(record.wallTime);
+  payload.put(record.cpuTime);
+  payload.put(record.peakRss);
+  payload.put(record.readBytes);
+  payload.put(record.writeBytes);
+  payload.put(static_cast<uint16_t>(record.qor.size()));
+  for (const auto& [name, value] : record.qor) {
+    payload.put(id(name));
+    payload.put(value);
+  }
+  frame(out, RecordFrame, payload.data());
+
+  std::ofstream file{m_file, std::ios::binary | std::ios::app};
+  file.write(out.data().data(), out.data().size());
+  file.flush();
+  if (!file) {
+    reset();  // state of the file is unknown
+    if (error) *error = "Failed to write telemetry file " + m_file.string();
+    return false;
+  }
+  for (const auto& str : strings) {
+    m_stringIds.emplace(str, static_cast<uint32_t>(m_strings.size()));
+    m_strings.push_back(str);
+  }
+  m_lastRun = std::max(m_lastRun, record.run);
+  m_stages[record.stage].push_back(m_records.size());
+  m_records.push_back(record);
+  m_validSize += out.data().size();
+  m_fileSize = m_validSize;
+  return true;
+}
+
+std::vector<TelemetryRecord> TelemetryStore::Read(const std::string& stage,
+                                                  size_t last) const {
+  std::scoped_lock lock{m_lock};
+  if (!load()) return {};
+  std::vector<TelemetryRecord> records;
+  if (stage.empty()) {
+    const size_t first =
+        (last != 0 && m_records.size() > last) ? m_records.size() - last : 0;
+    records.assign(m_records.begin() + first, m_records.end());
+    return records;
+  }
+  auto it = m_stages.find(stage);
+  if (it == m_stages.end()) return records;
+  const auto& indexes = it->second;
+  const size_t first =
+      (last != 0 && indexes.size() > last) ? indexes.size() - last : 0;
+  for (size_t i = first; i < indexes.size(); i++)
+    records.push_back(m_records.at(indexes.at(i)));
+  return records;
+}
+
+std::vector<TelemetryFlag> TelemetryStore::Check(
+    const TelemetryRecord& record) const {
+  std::vector<TelemetryRecord> baseline;
+  for (auto& previous : Read(record.stage)) {
+    if (previous.success && previous.run < record.run)
+      baseline.push_back(std::move(previous));
+  }
+  if (m_window != 0 && baseline.size() > m_window)
+    baseline.erase(baseline.begin(), baseline.end() - m_window);
+  std::vector<TelemetryFlag> flags;
+  if (baseline.size() < MinBaseline) return flags;
+
+  const double threshold = m_threshold / 100.0;
+  // higherIsWorse false means lower value is worse
+  auto check = [&](TelemetryFlag::Kind kind, const std::string& metric,
+                   double value, const std::vector<double>& history,
+                   bool higherIsWorse, double floor) {
+    if (history.size() < MinBaseline) return;
+    const double base = median(history);
+    if (base <= 0 || std::max(base, value) < floor) return;
+    const double change = (higherIsWorse ? value - base : base - value) / base;
+    if (change > threshold)
+      flags.push_back({kind, metric, value, base, change * 100.0});
+  };
+  auto history = [&baseline](auto field) {
+    std::vector<double> values;
+    for (const auto& previous : baseline) values.push_back(field(previous));
+    return values;
+  };
+
+  check(TelemetryFlag::Slowdown, "wall_ms", record.wallTime,
+        history([](const TelemetryRecord& r) { return r.wallTime; }), true,
+        NoiseFloorMs);
+  check(TelemetryFlag::Slowdown, "cpu_ms", record.cpuTime,
+        history([](const TelemetryRecord& r) { return r.cpuTime; }), true,
+        NoiseFloorMs);
+  check(TelemetryFlag::Slowdown, "rss_kib", record.peakRss,
+        history([](const TelemetryRecord& r) { return r.peakRss; }), true, 0);
+  for (const auto& [name, value] : record.qor) {
+    if (name == "io") continue;  // defined by design, not by the flow
+    std::vector<double> values;
+    for (const auto& previous : baseline) {
+      auto it = previous.qor.find(name);
+      if (it != previous.qor.end()) values.push_back(it->second);
+    }
+    check(TelemetryFlag::Regression, name, value, values, name != "fmax", 0);
+  }
+  return flags;
+}
+
+bool TelemetryStore::Clear() {
+  std::scoped_lock lock{m_lock};
+  QLockFile fileLock{QString::fromStdString(m_file.string() + ".lock")};
+  if (!m_file.empty()) fileLock.lock();
+  reset();
+  std::error_code ec;
+  fs::remove(m_file, ec);
+  return !ec;
+}
+
+std::string TelemetryStore::ToString(const TelemetryFlag& flag) {
+  std::stringstream stream;
+  stream.precision(4);
+  stream << (flag.kind == TelemetryFlag::Slowdown ? "slowdown" : "regression")
+         << " " << flag.metric << ": " << flag.value << " (baseline "
+         << flag.baseline << ", ";
+  stream.precision(3);
+  stream << flag.change << "% worse)";
+  return stream.str();
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,140 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FOEDAG {
+
+// performance and QoR of one flow stage
+struct TelemetryRecord {
+  uint32_t run{0};
+  int64_t timestamp{0};  // ms since epoch
+  std::string stage;
+  bool success{false};
+  uint32_t wallTime{0};  // ms
+  uint32_t cpuTime{0};   // ms, all tools executed by the stage
+  uint32_t peakRss{0};   // kiB
+  uint64_t readBytes{0};
+  uint64_t writeBytes{0};
+  // fmax (MHz), lut, ff, bram, dsp, io
+  std::map<std::string, double> qor;
+};
+
+struct TelemetryFlag {
+  enum Kind { Slowdown, Regression };
+  Kind kind{Slowdown};
+  std::string metric;
+  double value{0};
+  double baseline{0};
+  double change{0};  // percent, positive is worse
+};
+
+/*!
+ * \brief The TelemetryStore class
+ * Append-only binary history of flow stages. The file is a sequence of
+ * checksummed frames: stage and metric names are stored once as string
+ * frames, records refer to them by id and keep numbers in fixed width little
+ * endian fields. Every append is a single write, interrupted run leaves at
+ * most one broken frame at the end, which is ignored on read and cut off by
+ * the next append. The file is loaded once into memory, when its size
+ * changes only the frames added since are read. Sessions sharing the file
+ * append under a lock file. New record is checked against median of the
+ * previous successful runs of the same stage (rolling baseline).
+ * Recording is off until enabled.
+ */
+class TelemetryStore {
+ public:
+  explicit TelemetryStore(const std::filesystem::path& file = {});
+
+  const std::filesystem::path& File() const { return m_file; }
+  void File(const std::filesystem::path& file);
+
+  bool Enabled() const { return m_enabled; }
+  void Enabled(bool enabled) { m_enabled = enabled; }
+
+  // number of previous runs forming the baseline
+  uint32_t Window() const { return m_window; }
+  void Window(uint32_t window) { m_window = window; }
+
+  // percent of change reported as slowdown or regression
+  double Threshold() const { return m_threshold; }
+  void Threshold(double threshold) { m_threshold = threshold; }
+
+  // identifier of the next run, one after the last stored run
+  uint32_t NextRun() const;
+
+  bool Append(const TelemetryRecord& record, std::string* error = nullptr);
+
+  /*!
+   * \brief Read
+   * \param stage - records of this stage only, all stages if empty
+   * \param last - number of most recent records, all if 0
+   */
+  std::vector<TelemetryRecord> Read(const std::string& stage = {},
+                                    size_t last = 0) const;
+
+  /*!
+   * \brief Check
+   * Compare \a record against baseline of successful records of the same
+   * stage from the earlier runs. Wall time, CPU time and memory flag
+   * slowdowns; fmax decrease and resource usage increase flag regressions.
+   * Times below one second are noise and never flagged.
+   */
+  std::vector<TelemetryFlag> Check(const TelemetryRecord& record) const;
+
+  bool Clear();
+
+  static std::string ToString(const TelemetryFlag& flag);
+
+ private:
+  // file is read again if its size changed or if forced
+  bool load(bool force = false) const;
+  void reset() const;
+  bool parse(const std::string& data) const;
+  // frames following m_validSize
+  void parseFrames(const std::string& data) const;
+
+  std::filesystem::path m_file;
+  bool m_enabled{false};
+  uint32_t m_window{5};
+  double m_threshold{30.0};
+
+  // in-memory copy of the file
+  mutable std::mutex m_lock;
+  mutable bool m_loaded{false};
+  mutable bool m_foreign{false};    // file is not a telemetry store
+  mutable uintmax_t m_fileSize{0};  // size when loaded
+  mutable uintmax_t m_validSize{0};  // end of the last valid frame
+  mutable std::vector<std::string> m_strings;
+  mutable std::unordered_map<std::string, uint32_t> m_stringIds;
+  mutable std::vector<TelemetryRecord> m_records;
+  mutable std::map<std::string, std::vector<size_t>> m_stages;
+  mutable uint32_t m_lastRun{0};
+};
+
+}  // namespace FOEDAG
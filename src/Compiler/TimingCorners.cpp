@@ -0,0 +1,285 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TimingCorners.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "Compiler/ExecutionContext.h"
+#include "Compiler/Reports/TimingAnalysisReportManager.h"
+#include "nlohmann_json/json.hpp"
+#include "scope_guard.hpp"
+
+namespace fs = std::filesystem;
+using json = nlohmann::ordered_json;
+
+namespace FOEDAG {
+
+static constexpr const char* DefaultName{"default"};
+
+template <class T>
+static void addOrReplace(std::vector<T>& items, const T& item) {
+  auto it = std::find_if(items.begin(), items.end(), [&item](const T& other) {
+    return other.name == item.name;
+  });
+  if (it != items.end())
+    *it = item;
+  else
+    items.push_back(item);
+}
+
+TimingCornerAnalysis::TimingCornerAnalysis() = default;
+TimingCornerAnalysis::~TimingCornerAnalysis() = default;
+
+bool TimingCornerAnalysis::Jobs(uint32_t jobs) {
+  std::scoped_lock guard{m_configLock};
+  if (m_running) return false;
+  m_pool.Threads(jobs);
+  return true;
+}
+
+bool TimingCornerAnalysis::AddCorner(const TimingCorner& corner) {
+  std::scoped_lock guard{m_configLock};
+  if (m_running) return false;
+  addOrReplace(m_corners, corner);
+  return true;
+}
+
+bool TimingCornerAnalysis::AddMode(const TimingMode& mode) {
+  std::scoped_lock guard{m_configLock};
+  if (m_running) return false;
+  addOrReplace(m_modes, mode);
+  return true;
+}
+
+bool TimingCornerAnalysis::Clear() {
+  std::scoped_lock guard{m_configLock};
+  if (m_running) return false;
+  m_corners.clear();
+  m_modes.clear();
+  m_runs.clear();
+  return true;
+}
+
+bool TimingCornerAnalysis::Run(const fs::path& workingDir,
+                               const Prepare& prepare, const Finished& finished,
+                               const ContextHook& hook) {
+  std::vector<TimingCorner> corners;
+  std::vector<TimingMode> modes;
+  {
+    std::scoped_lock guard{m_configLock};
+    if (m_running) return false;
+    m_running = true;
+    corners = m_corners;
+    modes = m_modes;
+  }
+  auto running = sg::make_scope_guard([this]() { m_running = false; });
+  m_summary = {};
+  m_runs.clear();
+  auto start = std::chrono::steady_clock::now();
+
+  if (corners.empty()) corners.push_back({DefaultName, {}, {}});
+  if (modes.empty()) modes.push_back({DefaultName, {}});
+  for (const auto& corner : corners) {
+    for (const auto& mode : modes) {
+      CornerRun run;
+      run.corner = corner;
+      run.mode = mode;
+      run.dir = workingDir / (corner.name + "_" + mode.name);
+      run.log = run.dir / "timing.log";
+      m_runs.push_back(run);
+    }
+  }
+  // commands are prepared up front, preparation is not thread safe
+  bool prepared{true};
+  for (auto& run : m_runs) {
+    std::error_code ec;
+    fs::create_directories(run.dir, ec);
+    if (ec || (prepare && !prepare(run)) || run.command.empty()) {
+      run.command.clear();
+      prepared = false;
+    }
+    if (run.report.empty()) run.report = run.log;
+  }
+  {
+    std::scoped_lock guard{m_contextsLock};
+    m_contexts.clear();
+    for (const auto& run : m_runs)
+      m_contexts.emplace_back(new ExecutionContext{run.dir, nullptr, nullptr});
+  }
+  if (hook)
+    for (auto& context : m_contexts) hook(context.get(), true);
+
+  m_pool.Run(
+      m_runs.size(),
+      [this](size_t index) { execute(m_runs[index], *m_contexts[index]); },
+      [this, &finished](size_t index) {
+        const CornerRun& run = m_runs.at(index);
+        // runs are parallel, wall time is measured for all of them below
+        m_summary.append(run.utils);
+        if (finished) finished(run);
+      });
+  if (hook)
+    for (auto& context : m_contexts) hook(context.get(), false);
+  {
+    std::scoped_lock guard{m_contextsLock};
+    m_contexts.clear();
+  }
+
+  m_summary.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  const bool passed =
+      std::all_of(m_runs.begin(), m_runs.end(),
+                  [](const CornerRun& run) { return run.passed; });
+  return prepared && passed;
+}
+
+void TimingCornerAnalysis::Stop() {
+  m_pool.Stop();
+  std::scoped_lock guard{m_contextsLock};
+  for (auto& context : m_contexts) context->Stop();
+}
+
+void TimingCornerAnalysis::execute(CornerRun& run, ExecutionContext& context) {
+  if (run.command.empty()) return;
+  run.exitCode = context.Execute(run.command, run.log.string());
+  run.utils = context.Utilization();
+  run.passed = !m_pool.Stopped() && (run.exitCode == 0);
+  if (!run.passed) return;
+  run.slacks = TimingAnalysisReportManager::ParseEndpointSlacks(run.report);
+  for (auto& slack : run.slacks) {
+    slack.corner = run.corner.name;
+    slack.mode = run.mode.name;
+  }
+}
+
+std::vector<EndpointSlack> TimingCornerAnalysis::WorstSlacks() const {
+  std::map<std::pair<std::string, std::string>, EndpointSlack> worst;
+  for (const auto& run : m_runs) {
+    if (!run.passed) continue;
+    for (const auto& slack : run.slacks) {
+      auto [it, inserted] =
+          worst.emplace(std::make_pair(slack.check, slack.endpoint), slack);
+      if (!inserted && slack.slack < it->second.slack) it->second = slack;
+    }
+  }
+  std::vector<EndpointSlack> slacks;
+  for (auto& [key, slack] : worst) slacks.push_back(std::move(slack));
+  std::stable_sort(slacks.begin(), slacks.end(),
+                   [](const EndpointSlack& a, const EndpointSlack& b) {
+                     return a.slack < b.slack;
+                   });
+  return slacks;
+}
+
+std::string TimingCornerAnalysis::Table() const {
+  const std::vector<EndpointSlack> slacks = WorstSlacks();
+  const std::vector<std::string> header{"Endpoint", "Check", "Slack (ns)",
+                                        "Corner", "Mode"};
+  std::vector<std::vector<std::string>> rows;
+  for (const auto& slack : slacks) {
+    std::stringstream value;
+    value << std::fixed << std::setprecision(3) << slack.slack;
+    rows.push_back(
+        {slack.endpoint, slack.check, value.str(), slack.corner, slack.mode});
+  }
+  std::vector<size_t> widths;
+  for (const auto& name : header) widths.push_back(name.size());
+  for (const auto& row : rows)
+    for (size_t i = 0; i < row.size(); i++)
+      widths[i] = std::max(widths[i], row[i].size());
+
+  std::stringstream table;
+  auto addRow = [&table, &widths](const std::vector<std::string>& row) {
+    for (size_t i = 0; i < row.size(); i++) {
+      // slack is right aligned
+      table << (i == 2 ? std::right : std::left) << std::setw(widths[i])
+            << row[i] << (i + 1 < row.size() ? "  " : "\n");
+    }
+  };
+  addRow(header);
+  size_t width{0};
+  for (auto w : widths) width += w + 2;
+  table << std::string(width - 2, '-') << "\n";
+  for (const auto& row : rows) addRow(row);
+  return table.str();
+}
+
+// worst slack, total negative slack and number of violations of the check
+static json checkSummary(const std::vector<EndpointSlack>& slacks,
+                         const std::string& check) {
+  json data = json::object();
+  const EndpointSlack* worst{nullptr};
+  double tns{0};
+  uint32_t violations{0};
+  for (const auto& slack : slacks) {
+    if (slack.check != check) continue;
+    if (!worst || slack.slack < worst->slack) worst = &slack;
+    if (slack.slack < 0) {
+      tns += slack.slack;
+      violations++;
+    }
+  }
+  if (!worst) return data;
+  data["worst_slack"] = worst->slack;
+  data["tns"] = tns;
+  data["violations"] = violations;
+  data["endpoint"] = worst->endpoint;
+  if (!worst->corner.empty()) data["corner"] = worst->corner;
+  if (!worst->mode.empty()) data["mode"] = worst->mode;
+  return data;
+}
+
+std::string TimingCornerAnalysis::Summary() const {
+  json data;
+  data["jobs"] = Jobs();
+  data["wall_ms"] = m_summary.duration;
+  data["cpu_ms"] = m_summary.cpuTime;
+  data["runs"] = json::array();
+  for (const auto& run : m_runs) {
+    json item;
+    item["corner"] = run.corner.name;
+    item["mode"] = run.mode.name;
+    if (!run.corner.liberty.empty())
+      item["liberty"] = run.corner.liberty.string();
+    if (!run.corner.sdf.empty()) item["sdf"] = run.corner.sdf.string();
+    if (!run.mode.sdc.empty()) item["sdc"] = run.mode.sdc.string();
+    item["passed"] = run.passed;
+    item["exit_code"] = run.exitCode;
+    item["wall_ms"] = run.utils.duration;
+    item["log"] = run.log.string();
+    item["endpoints"] = run.slacks.size();
+    item["setup"] = checkSummary(run.slacks, "setup");
+    item["hold"] = checkSummary(run.slacks, "hold");
+    data["runs"].push_back(item);
+  }
+  const std::vector<EndpointSlack> worst = WorstSlacks();
+  data["endpoints"] = worst.size();
+  data["setup"] = checkSummary(worst, "setup");
+  data["hold"] = checkSummary(worst, "hold");
+  return data.dump(2);
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,148 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Compiler/Task.h"
+#include "Utils/JobPool.h"
+
+namespace FOEDAG {
+
+class ExecutionContext;
+
+// process corner, empty files mean the design defaults
+struct TimingCorner {
+  std::string name;
+  std::filesystem::path liberty;
+  std::filesystem::path sdf;
+};
+
+// constraint mode, empty file means the design default
+struct TimingMode {
+  std::string name;
+  std::filesystem::path sdc;
+};
+
+struct EndpointSlack {
+  std::string endpoint;
+  std::string check;  // setup or hold
+  double slack{0};    // ns
+  std::string corner;
+  std::string mode;
+};
+
+struct CornerRun {
+  TimingCorner corner;
+  TimingMode mode;
+  std::filesystem::path dir;  // own directory of the run
+  std::filesystem::path log;
+  std::string command;
+  std::filesystem::path report;  // log if empty
+  int exitCode{-1};
+  bool passed{false};
+  std::vector<EndpointSlack> slacks;
+  ProcessUtilization utils{};
+};
+
+/*!
+ * \brief The TimingCornerAnalysis class
+ * Analyzes every corner and constraint mode pair with at most Jobs() timing
+ * tools running at the same time. Each run has its own directory and
+ * execution context; its report is parsed by TimingAnalysisReportManager
+ * and the results are merged into the worst slack per endpoint. Missing
+ * corners or modes are one default entry with empty files.
+ */
+class TimingCornerAnalysis {
+ public:
+  // sets command and report of the run, called before any run starts
+  using Prepare = std::function<bool(CornerRun& run)>;
+  // called from the thread that called Run()
+  using Finished = std::function<void(const CornerRun& run)>;
+  // called with the context of every run before the runs start (added) and
+  // after all of them finished
+  using ContextHook =
+      std::function<void(ExecutionContext* context, bool added)>;
+
+  TimingCornerAnalysis();
+  ~TimingCornerAnalysis();
+
+  // setters below fail while Run() is in progress
+  bool Running() const { return m_running; }
+
+  // 0 means number of hardware threads
+  bool Jobs(uint32_t jobs);
+  uint32_t Jobs() const { return m_pool.Threads(); }
+
+  // corner or mode with the same name is replaced
+  bool AddCorner(const TimingCorner& corner);
+  bool AddMode(const TimingMode& mode);
+  const std::vector<TimingCorner>& Corners() const { return m_corners; }
+  const std::vector<TimingMode>& Modes() const { return m_modes; }
+  bool Empty() const { return m_corners.empty() && m_modes.empty(); }
+  bool Clear();
+
+  /*!
+   * \brief Run
+   * \return true if all runs have passed, timing violations are not failures.
+   * false right away if another run is in progress.
+   */
+  bool Run(const std::filesystem::path& workingDir, const Prepare& prepare,
+           const Finished& finished = {}, const ContextHook& hook = {});
+  // thread safe, running tools are terminated by their worker threads
+  void Stop();
+
+  const std::vector<CornerRun>& Runs() const { return m_runs; }
+
+  // worst slack of every endpoint and check over passed runs, most critical
+  // first
+  std::vector<EndpointSlack> WorstSlacks() const;
+
+  // text table of WorstSlacks()
+  std::string Table() const;
+
+  // json summary of the corners, modes, runs and worst slacks
+  std::string Summary() const;
+
+  ProcessUtilization Utilization() const { return m_summary; }
+
+ private:
+  void execute(CornerRun& run, ExecutionContext& context);
+
+  std::vector<TimingCorner> m_corners;
+  std::vector<TimingMode> m_modes;
+  std::vector<CornerRun> m_runs;
+  JobPool m_pool;
+  std::mutex m_contextsLock;
+  std::vector<std::unique_ptr<ExecutionContext>> m_contexts;
+  // corners, modes and jobs do not change while running
+  std::mutex m_configLock;
+  std::atomic_bool m_running{false};
+  ProcessUtilization m_summary{};
+};
+
+}  // namespace FOEDAG
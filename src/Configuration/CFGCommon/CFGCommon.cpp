@@ -23,10 +23,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef _WIN32
 #include <Windows.h>
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
 #include <algorithm>
+#include <bitset>
 #include <cstdarg>
 #include <cstdlib>
 #include <cstring>
@@ -637,33 +641,22 @@ void CFG_read_text_file(const std::string& filepath,
 
 void CFG_read_binary_file(const std::string& filepath,
                           std::vector<uint8_t>& data) {
-  // File size to prepare memory
-  std::ifstream file(filepath.c_str(), std::ios::binary | std::ios::ate);
-  CFG_ASSERT_MSG(file.is_open(), "Fail to open binary file %s",
-                 filepath.c_str());
-  size_t filesize = file.tellg();
-  file.close();
+  std::unique_ptr<CFG_Mapped_File> file = CFG_map_binary_file(filepath);
+  data.assign(file->data(), file->data() + file->size());
+}
 
-  // Read the binary
-  CFG_ASSERT(filesize > 0);
-  if (data.size()) {
-    memset(&data[0], 0, data.size());
-    data.clear();
-  }
-  data.resize(filesize);
-  file = std::ifstream(filepath.c_str(), std::ios::in | std::ios::binary);
-  CFG_ASSERT(file.is_open());
-  file.read((char*)(&data[0]), data.size());
-  file.close();
+std::unique_ptr<CFG_Mapped_File> CFG_map_binary_file(
+    const std::string& filepath) {
+  auto file = std::make_unique<CFG_Mapped_File>(filepath);
+  CFG_ASSERT(file->size() > 0);
+  return file;
 }
 
 void CFG_write_binary_file(const std::string& filepath, const uint8_t* data,
                            const size_t data_size) {
-  std::ofstream file(filepath.c_str(), std::ios::out | std::ios::binary);
-  CFG_ASSERT(file.is_open());
-  file.write((char*)(const_cast<uint8_t*>(data)), data_size);
-  file.flush();
-  file.close();
+  CFG_Binary_Writer writer(filepath);
+  writer.write(data, data_size);
+  writer.close();
 }
 
 bool CFG_compare_two_text_files(const std::string& filepath1,
@@ -717,12 +710,509 @@ bool CFG_compare_two_text_files(const std::string& filepath1,
 
 bool CFG_compare_two_binary_files(const std::string& filepath1,
                                   const std::string& filepath2) {
-  std::vector<uint8_t> data1;
-  std::vector<uint8_t> data2;
-  CFG_read_binary_file(filepath1, data1);
-  CFG_read_binary_file(filepath2, data2);
-  return (data1.size() == data2.size()) &&
-         (data1.size() == 0 || memcmp(&data1[0], &data2[0], data1.size()) == 0);
+  CFG_Mapped_File file1(filepath1);
+  CFG_Mapped_File file2(filepath2);
+  return file1.size() == file2.size() &&
+         CFG_find_mismatch(file1.data(), file2.data(), file1.size()) ==
+             file1.size();
+}
+
+CFG_Mapped_File::CFG_Mapped_File(const std::string& filepath) {
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  CFG_ASSERT_MSG(file != INVALID_HANDLE_VALUE, "Fail to open binary file %s",
+                 filepath.c_str());
+  LARGE_INTEGER filesize;
+  if (GetFileSizeEx(file, &filesize) && filesize.QuadPart > 0) {
+    HANDLE mapping =
+        CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+      void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      if (view != nullptr) {
+        m_data = (const uint8_t*)(view);
+        m_size = (size_t)(filesize.QuadPart);
+        m_mapped = true;
+        m_mapping = mapping;
+        m_file = file;
+      } else {
+        CloseHandle(mapping);
+      }
+    }
+  }
+  if (!m_mapped) {
+    CloseHandle(file);
+  }
+#else
+  int fd = open(filepath.c_str(), O_RDONLY);
+  CFG_ASSERT_MSG(fd >= 0, "Fail to open binary file %s", filepath.c_str());
+  struct stat filestat;
+  if (fstat(fd, &filestat) == 0 && S_ISREG(filestat.st_mode) &&
+      filestat.st_size > 0) {
+    size_t filesize = (size_t)(filestat.st_size);
+    void* view = mmap(nullptr, filesize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view != MAP_FAILED) {
+      madvise(view, filesize, MADV_SEQUENTIAL);
+      m_data = (const uint8_t*)(view);
+      m_size = filesize;
+      m_mapped = true;
+    }
+  }
+  // mapping stays valid after the descriptor is closed
+  close(fd);
+#endif
+  if (!m_mapped) {
+    std::ifstream file(filepath.c_str(), std::ios::in | std::ios::binary);
+    CFG_ASSERT_MSG(file.is_open(), "Fail to open binary file %s",
+                   filepath.c_str());
+    m_buffer.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+  }
+}
+
+CFG_Mapped_File::~CFG_Mapped_File() {
+  if (m_mapped) {
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+  }
+}
+
+CFG_Binary_Writer::CFG_Binary_Writer(const std::string& filepath,
+                                     size_t block_size)
+    : m_filepath(filepath),
+      m_block_size(block_size > 0 ? block_size : 1),
+      m_file(filepath.c_str(), std::ios::out | std::ios::binary) {
+  CFG_ASSERT_MSG(m_file.is_open(), "Fail to open binary file %s",
+                 filepath.c_str());
+  m_block.reserve(m_block_size);
+}
+
+CFG_Binary_Writer::~CFG_Binary_Writer() {
+  if (m_file.is_open()) {
+    flush();
+    m_file.close();
+  }
+}
+
+void CFG_Binary_Writer::write(const uint8_t* data, size_t size) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  append(data, size);
+}
+
+void CFG_Binary_Writer::write_chunk(size_t index,
+                                    std::vector<uint8_t>&& data) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  CFG_ASSERT_MSG(index >= m_next_chunk && m_pending.count(index) == 0,
+                 "Chunk %d of binary file %s is written twice",
+                 (uint32_t)(index), m_filepath.c_str());
+  if (index != m_next_chunk) {
+    m_pending[index] = std::move(data);
+    return;
+  }
+  append(data.data(), data.size());
+  m_next_chunk++;
+  auto iter = m_pending.begin();
+  while (iter != m_pending.end() && iter->first == m_next_chunk) {
+    append(iter->second.data(), iter->second.size());
+    m_next_chunk++;
+    iter = m_pending.erase(iter);
+  }
+}
+
+void CFG_Binary_Writer::close() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_file.is_open()) {
+    return;
+  }
+  CFG_ASSERT_MSG(m_pending.empty(), "Binary file %s is missing chunk %d",
+                 m_filepath.c_str(), (uint32_t)(m_next_chunk));
+  flush();
+  m_file.close();
+  CFG_ASSERT_MSG(!m_file.fail(), "Fail to write binary file %s",
+                 m_filepath.c_str());
+}
+
+void CFG_Binary_Writer::append(const uint8_t* data, size_t size) {
+  m_size += size;
+  if (m_block.size() + size > m_block_size) {
+    flush();
+  }
+  if (size >= m_block_size) {
+    // large data is written as it is
+    m_file.write((const char*)(data), size);
+  } else {
+    m_block.insert(m_block.end(), data, data + size);
+  }
+}
+
+void CFG_Binary_Writer::flush() {
+  if (m_block.size()) {
+    m_file.write((const char*)(m_block.data()), m_block.size());
+    m_block.clear();
+  }
+}
+
+/*
+  Slicing-by-8 tables: table[n][i] is CRC of byte i followed by n zero bytes
+*/
+static const uint32_t* CFG_crc32_table() {
+  static const std::vector<uint32_t> table = []() {
+    std::vector<uint32_t> t(8 * 256);
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 1) ? (0xEDB88320 ^ (crc >> 1)) : (crc >> 1);
+      }
+      t[i] = crc;
+    }
+    for (uint32_t n = 1; n < 8; n++) {
+      for (uint32_t i = 0; i < 256; i++) {
+        uint32_t previous = t[(n - 1) * 256 + i];
+        t[n * 256 + i] = (previous >> 8) ^ t[previous & 0xFF];
+      }
+    }
+    return t;
+  }();
+  return table.data();
+}
+
+uint32_t CFG_crc32(const uint8_t* data, size_t size, uint32_t crc) {
+  const uint32_t* table = CFG_crc32_table();
+  crc = ~crc;
+  while (size >= 8) {
+    uint32_t low = (uint32_t)(data[0]) | ((uint32_t)(data[1]) << 8) |
+                   ((uint32_t)(data[2]) << 16) | ((uint32_t)(data[3]) << 24);
+    uint32_t high = (uint32_t)(data[4]) | ((uint32_t)(data[5]) << 8) |
+                    ((uint32_t)(data[6]) << 16) | ((uint32_t)(data[7]) << 24);
+    low ^= crc;
+    crc = table[7 * 256 + (low & 0xFF)] ^
+          table[6 * 256 + ((low >> 8) & 0xFF)] ^
+          table[5 * 256 + ((low >> 16) & 0xFF)] ^ table[4 * 256 + (low >> 24)] ^
+          table[3 * 256 + (high & 0xFF)] ^
+          table[2 * 256 + ((high >> 8) & 0xFF)] ^
+          table[256 + ((high >> 16) & 0xFF)] ^ table[high >> 24];
+    data += 8;
+    size -= 8;
+  }
+  while (size--) {
+    crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+size_t CFG_find_mismatch(const uint8_t* data1, const uint8_t* data2,
+                         size_t size) {
+  // memcmp is vectorized by the C library, it only narrows down the block
+  const size_t block = 4096;
+  for (size_t i = 0; i < size; i += block) {
+    size_t n = (size - i) < block ? (size - i) : block;
+    if (memcmp(&data1[i], &data2[i], n) != 0) {
+      while (data1[i] == data2[i]) {
+        i++;
+      }
+      return i;
+    }
+  }
+  return size;
+}
+
+CFG_Bitstream_Diff CFG_compare_bitstream(const uint8_t* data1, size_t size1,
+                                         const uint8_t* data2, size_t size2,
+                                         uint64_t frame_bits,
+                                         size_t max_bits) {
+  CFG_Bitstream_Diff diff;
+  diff.size1 = size1;
+  diff.size2 = size2;
+  const size_t size = size1 < size2 ? size1 : size2;
+  // CRC and comparison go block by block while the data is in cache
+  const size_t block = size_t(1) << 16;
+  // after a mismatch, next bytes are compared word by word
+  const size_t span = 64;
+  bool found = false;
+  for (size_t offset = 0; offset < size; offset += block) {
+    const size_t end = (size - offset) < block ? size : (offset + block);
+    diff.crc1 = CFG_crc32(&data1[offset], end - offset, diff.crc1);
+    diff.crc2 = CFG_crc32(&data2[offset], end - offset, diff.crc2);
+    size_t i = offset + CFG_find_mismatch(&data1[offset], &data2[offset],
+                                          end - offset);
+    while (i < end) {
+      if (!found) {
+        uint8_t x = data1[i] ^ data2[i];
+        uint64_t bit = 0;
+        while (!(x & (1 << bit))) {
+          bit++;
+        }
+        diff.first_bit = i * 8 + bit;
+        found = true;
+      }
+      const size_t stop = (end - i) < span ? end : (i + span);
+      for (size_t j = i; j < stop; j += 8) {
+        const size_t n = (stop - j) < 8 ? (stop - j) : 8;
+        uint64_t word1 = 0;
+        uint64_t word2 = 0;
+        memcpy(&word1, &data1[j], n);
+        memcpy(&word2, &data2[j], n);
+        if (word1 == word2) {
+          continue;
+        }
+        diff.diff_bits += std::bitset<64>(word1 ^ word2).count();
+        for (size_t k = j; k < (j + n) && diff.bits.size() < max_bits; k++) {
+          uint8_t x = data1[k] ^ data2[k];
+          for (uint64_t bit = 0; bit < 8 && diff.bits.size() < max_bits;
+               bit++) {
+            if (x & (1 << bit)) {
+              diff.bits.push_back(k * 8 + bit);
+            }
+          }
+        }
+      }
+      i = stop + CFG_find_mismatch(&data1[stop], &data2[stop], end - stop);
+    }
+  }
+  if (size1 > size) {
+    diff.crc1 = CFG_crc32(&data1[size], size1 - size, diff.crc1);
+  }
+  if (size2 > size) {
+    diff.crc2 = CFG_crc32(&data2[size], size2 - size, diff.crc2);
+  }
+  diff.equal = !found && size1 == size2;
+  if (!found) {
+    diff.first_bit = (uint64_t)(size) * 8;
+  }
+  if (frame_bits > 0) {
+    diff.first_frame = diff.first_bit / frame_bits;
+    diff.first_frame_bit = diff.first_bit % frame_bits;
+  } else {
+    diff.first_frame_bit = diff.first_bit;
+  }
+  return diff;
+}
+
+CFG_Bitstream_Diff CFG_compare_bitstream(const std::string& filepath1,
+                                         const std::string& filepath2,
+                                         uint64_t frame_bits,
+                                         size_t max_bits) {
+  CFG_Mapped_File file1(filepath1);
+  CFG_Mapped_File file2(filepath2);
+  return CFG_compare_bitstream(file1.data(), file1.size(), file2.data(),
+                               file2.size(), frame_bits, max_bits);
+}
+
+/*
+  Hold the GIL for the scope, interpreter is initialized on first use
+*/
+class CFG_Python_GIL {
+ public:
+  CFG_Python_GIL() {
+    CFG_Python_Interpreter::get();
+    m_state = PyGILState_Ensure();
+  }
+  ~CFG_Python_GIL() { PyGILState_Release(m_state); }
+
+ private:
+  PyGILState_STATE m_state;
+};
+
+CFG_Python_Interpreter& CFG_Python_Interpreter::get() {
+  // never destroyed, cached code objects must not outlive the interpreter
+  static CFG_Python_Interpreter* interpreter = new CFG_Python_Interpreter;
+  return *interpreter;
+}
+
+CFG_Python_Interpreter::CFG_Python_Interpreter() {
+  bool initialize = !Py_IsInitialized();
+  PyGILState_STATE state = PyGILState_UNLOCKED;
+  if (initialize) {
+    Py_Initialize();
+    // Py_Finalize() is never called to flush Python output, flush every line
+    PyRun_SimpleString(
+        "import sys\n"
+        "for stream in (sys.stdout, sys.stderr):\n"
+        "  if hasattr(stream, 'reconfigure'):\n"
+        "    stream.reconfigure(line_buffering=True)\n");
+  } else {
+    state = PyGILState_Ensure();
+  }
+  for (const char* name :
+       {"prefix", "base_prefix", "exec_prefix", "base_exec_prefix"}) {
+    PyObject* prefix = PySys_GetObject(name);
+    if (prefix != nullptr && PyUnicode_Check(prefix)) {
+      m_prefixes.insert(
+          CFG_change_directory_to_linux_format(PyUnicode_AsUTF8(prefix)));
+    }
+  }
+  if (initialize) {
+    // release the GIL taken by initialization, every call acquires it
+    PyEval_SaveThread();
+  } else {
+    PyGILState_Release(state);
+  }
+}
+
+CFG_Python_Interpreter::FILE_STAMP CFG_Python_Interpreter::file_stamp(
+    const std::filesystem::path& path) {
+  std::error_code ec;
+  FILE_STAMP stamp;
+  stamp.time = std::filesystem::last_write_time(path, ec);
+  stamp.size = std::filesystem::file_size(path, ec);
+  return stamp;
+}
+
+bool CFG_Python_Interpreter::is_local_import(const std::string& name,
+                                             const std::string& file) const {
+  // found next to a loaded file: <dir>/<name>.py or <dir>/<package>/...
+  std::string top = name.substr(0, name.find('.'));
+  std::string path = CFG_change_directory_to_linux_format(file);
+  for (auto& dir : m_paths) {
+    std::string base = dir + "/" + top;
+    if (path == base + ".py" || path.rfind(base + "/", 0) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CFG_Python_Interpreter::is_installed(const std::string& file) const {
+  std::string path = CFG_change_directory_to_linux_format(file);
+  for (auto& prefix : m_prefixes) {
+    if (path.rfind(prefix + "/", 0) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static std::string CFG_Python_module_file(PyObject* module) {
+  std::string file;
+  PyObject* value = PyObject_GetAttrString(module, "__file__");
+  if (value == nullptr) {
+    PyErr_Clear();
+  } else if (PyUnicode_Check(value)) {
+    file = PyUnicode_AsUTF8(value);
+  }
+  Py_XDECREF(value);
+  return file;
+}
+
+static std::set<std::string> CFG_Python_module_names() {
+  std::set<std::string> names;
+  PyObject* modules = PyImport_GetModuleDict();
+  PyObject* key = nullptr;
+  PyObject* value = nullptr;
+  Py_ssize_t pos = 0;
+  while (PyDict_Next(modules, &pos, &key, &value)) {
+    if (PyUnicode_Check(key)) {
+      names.insert(PyUnicode_AsUTF8(key));
+    }
+  }
+  return names;
+}
+
+void CFG_Python_Interpreter::add_path(const std::string& dir) {
+  if (!m_paths.insert(dir).second) {
+    return;
+  }
+  PyObject* path = PySys_GetObject("path");
+  PyObject* item = PyUnicode_FromString(dir.c_str());
+  if (path != nullptr && item != nullptr && PyList_Check(path) &&
+      PySequence_Contains(path, item) == 0) {
+    PyList_Insert(path, 0, item);
+  }
+  Py_XDECREF(item);
+}
+
+void* CFG_Python_Interpreter::load_module(const std::filesystem::path& fullpath,
+                                          const std::string& name) {
+  FILE_STAMP stamp = file_stamp(fullpath);
+  std::string filepath = fullpath.string();
+  auto iter = m_codes.find(filepath);
+  if (iter != m_codes.end() && iter->second.stamp != stamp) {
+    Py_XDECREF((PyObject*)(iter->second.code));
+    m_codes.erase(iter);
+    iter = m_codes.end();
+  }
+  // shared imports edited since they were imported are imported again
+  PyObject* modules = PyImport_GetModuleDict();
+  for (auto import = m_imports.begin(); import != m_imports.end();) {
+    if (file_stamp(import->second.file) != import->second.stamp) {
+      if (PyDict_GetItemString(modules, import->first.c_str()) != nullptr) {
+        PyDict_DelItemString(modules, import->first.c_str());
+      }
+      import = m_imports.erase(import);
+    } else {
+      import++;
+    }
+  }
+  if (iter == m_codes.end()) {
+    std::ifstream file(fullpath, std::ios::binary);
+    if (!file.is_open()) {
+      return nullptr;
+    }
+    std::string source((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+    PyObject* code =
+        Py_CompileString(source.c_str(), filepath.c_str(), Py_file_input);
+    if (code == nullptr) {
+      PyErr_Print();
+      return nullptr;
+    }
+    m_compile_count++;
+    iter = m_codes.insert({filepath, CODE_OBJ{stamp, code}}).first;
+  }
+  PyObject* module = PyModule_New(name.c_str());
+  if (module == nullptr) {
+    return nullptr;
+  }
+  PyObject* dict = PyModule_GetDict(module);
+  PyObject* file = PyUnicode_FromString(filepath.c_str());
+  PyDict_SetItemString(dict, "__file__", file);
+  Py_XDECREF(file);
+  PyDict_SetItemString(dict, "__builtins__", PyEval_GetBuiltins());
+  // registered like an import while the code runs
+  PyDict_SetItemString(modules, name.c_str(), module);
+  std::set<std::string> before = CFG_Python_module_names();
+  PyObject* code = (PyObject*)(iter->second.code);
+  // entry may be dropped by another thread while imports release the GIL
+  Py_INCREF(code);
+  PyObject* result = PyEval_EvalCode(code, dict, dict);
+  Py_DECREF(code);
+  std::vector<std::string> locals = {name};
+  for (auto& import : CFG_Python_module_names()) {
+    if (import == name || before.find(import) != before.end()) {
+      continue;
+    }
+    std::string import_file =
+        CFG_Python_module_file(PyDict_GetItemString(modules, import.c_str()));
+    if (import_file.empty() || is_installed(import_file)) {
+      // built-in, namespace package or part of the installation
+    } else if (is_local_import(import, import_file)) {
+      locals.push_back(import);
+    } else {
+      m_imports[import] = IMPORT_OBJ{import_file, file_stamp(import_file)};
+    }
+  }
+  // referenced by the module globals only
+  for (auto& local : locals) {
+    if (PyDict_GetItemString(modules, local.c_str()) != nullptr) {
+      PyDict_DelItemString(modules, local.c_str());
+    }
+  }
+  if (result == nullptr) {
+    PyErr_Print();
+    Py_DECREF(module);
+    return nullptr;
+  }
+  Py_DECREF(result);
+  return module;
 }
 
 static CFG_Python_OBJ CFG_Python_get_result(PyObject*& value,
@@ -802,9 +1292,9 @@ static void CFG_Python_get_result(PyObject* list,
 std::map<std::string, CFG_Python_OBJ> CFG_Python(
     std::vector<std::string> commands, const std::vector<std::string> results,
     void* dict_ptr) {
+  CFG_Python_GIL gil;
   PyObject* dict = nullptr;
   if (dict_ptr == nullptr) {
-    Py_Initialize();
     dict = PyDict_New();
   } else {
     dict = static_cast<PyObject*>(dict_ptr);
@@ -825,7 +1315,6 @@ std::map<std::string, CFG_Python_OBJ> CFG_Python(
   }
   if (dict_ptr == nullptr) {
     Py_DECREF(dict);
-    Py_Finalize();
   }
   return result_objs;
 }
@@ -937,7 +1426,7 @@ std::vector<std::string> CFG_Python_OBJ::get_strs(const std::string& name) {
 
 CFG_Python_MGR::CFG_Python_MGR(const std::string& filepath,
                                const std::vector<std::string> results) {
-  Py_Initialize();
+  CFG_Python_GIL gil;
   if (filepath.size()) {
     main_module = set_file(filepath, results);
     CFG_ASSERT(main_module.size());
@@ -951,6 +1440,7 @@ CFG_Python_MGR::CFG_Python_MGR(const std::string& filepath,
 }
 
 CFG_Python_MGR::~CFG_Python_MGR() {
+  CFG_Python_GIL gil;
   if (main_module.empty() && dict_ptr != nullptr) {
     PyObject* dict = static_cast<PyObject*>(dict_ptr);
     Py_DECREF(dict);
@@ -959,7 +1449,6 @@ CFG_Python_MGR::~CFG_Python_MGR() {
   for (auto& iter : module_objs) {
     Py_XDECREF((PyObject*)(iter.second));
   }
-  Py_Finalize();
   main_module = "";
 }
 
@@ -975,27 +1464,18 @@ std::string CFG_Python_MGR::set_file(const std::string& file,
   std::filesystem::path dir = fullpath.parent_path();
   std::filesystem::path filename = fullpath.filename();
   std::string standard_dir = CFG_change_directory_to_linux_format(dir.string());
-  PyRun_SimpleString(CFG_print("import sys\n"
-                               "if '%s' not in sys.path:\n"
-                               "  sys.path.insert(0, '%s')\n",
-                               standard_dir.c_str(), standard_dir.c_str())
-                         .c_str());
+  CFG_Python_GIL gil;
+  CFG_Python_Interpreter::get().add_path(standard_dir);
   std::string module =
       filename.string().substr(0, filename.string().size() - 3);
   CFG_ASSERT(module_objs.find(module) == module_objs.end());
-  PyObject* pName = PyUnicode_FromString(module.c_str());
-  if (pName != nullptr) {
-    module_objs[module] = (void*)(PyImport_Import(pName));
-    if (module_objs[module] != nullptr) {
-      // Everything is good
-    } else {
-      CFG_INTERNAL_ERROR("Fail to load module %s", module.c_str());
-    }
+  module_objs[module] =
+      CFG_Python_Interpreter::get().load_module(fullpath, module);
+  if (module_objs[module] != nullptr) {
+    // Everything is good
   } else {
-    CFG_INTERNAL_ERROR("Fail to convert module name %s to PyObject",
-                       module.c_str());
+    CFG_INTERNAL_ERROR("Fail to load module %s", module.c_str());
   }
-  Py_XDECREF(pName);
   if (results.size()) {
     result_objs.clear();
     PyObject* globals = PyModule_GetDict((PyObject*)(module_objs[module]));
@@ -1012,18 +1492,18 @@ void CFG_Python_MGR::run(std::vector<std::string> commands,
   result_objs = CFG_Python(commands, results, dict_ptr);
 }
 
-std::vector<CFG_Python_OBJ> CFG_Python_MGR::run_file(
-    const std::string& module, const std::string& function,
-    std::vector<CFG_Python_OBJ> args) {
-  CFG_ASSERT(dict_ptr != nullptr);
-  CFG_ASSERT_MSG(module_objs.find(module) != module_objs.end(),
-                 "Module %s is not setup", module.c_str());
-  PyObject* pFunc = PyObject_GetAttrString((PyObject*)(module_objs[module]),
-                                           function.c_str());
+static PyObject* CFG_Python_get_function(PyObject* module,
+                                         const std::string& name,
+                                         const std::string& function) {
+  PyObject* pFunc = PyObject_GetAttrString(module, function.c_str());
   CFG_ASSERT_MSG(pFunc != nullptr, "Fail to find function %s from module %s",
-                 function.c_str(), module.c_str());
+                 function.c_str(), name.c_str());
+  return pFunc;
+}
+
+static std::vector<CFG_Python_OBJ> CFG_Python_call(
+    PyObject* pFunc, std::vector<CFG_Python_OBJ>& args) {
   PyObject* pArgs = nullptr;
-  std::vector<CFG_Python_OBJ> results;
   if (args.size()) {
     pArgs = PyTuple_New(args.size());
     CFG_ASSERT_MSG(pArgs, "Fail to PyTuple_New");
@@ -1075,6 +1555,7 @@ std::vector<CFG_Python_OBJ> CFG_Python_MGR::run_file(
       i++;
     }
   }
+  std::vector<CFG_Python_OBJ> results;
   PyObject* pResult = PyObject_CallObject(pFunc, pArgs);
   CFG_Python_get_result(pResult, results);
   if (pResult != nullptr) {
@@ -1083,6 +1564,37 @@ std::vector<CFG_Python_OBJ> CFG_Python_MGR::run_file(
   if (pArgs != nullptr) {
     Py_DECREF(pArgs);
   }
+  return results;
+}
+
+std::vector<CFG_Python_OBJ> CFG_Python_MGR::run_file(
+    const std::string& module, const std::string& function,
+    std::vector<CFG_Python_OBJ> args) {
+  CFG_ASSERT(dict_ptr != nullptr);
+  CFG_ASSERT_MSG(module_objs.find(module) != module_objs.end(),
+                 "Module %s is not setup", module.c_str());
+  CFG_Python_GIL gil;
+  PyObject* pFunc = CFG_Python_get_function((PyObject*)(module_objs[module]),
+                                            module, function);
+  std::vector<CFG_Python_OBJ> results = CFG_Python_call(pFunc, args);
+  Py_XDECREF(pFunc);
+  return results;
+}
+
+std::vector<std::vector<CFG_Python_OBJ>> CFG_Python_MGR::run_file_batch(
+    const std::string& module, const std::string& function,
+    std::vector<std::vector<CFG_Python_OBJ>> args_list) {
+  CFG_ASSERT(dict_ptr != nullptr);
+  CFG_ASSERT_MSG(module_objs.find(module) != module_objs.end(),
+                 "Module %s is not setup", module.c_str());
+  CFG_Python_GIL gil;
+  PyObject* pFunc = CFG_Python_get_function((PyObject*)(module_objs[module]),
+                                            module, function);
+  std::vector<std::vector<CFG_Python_OBJ>> results;
+  results.reserve(args_list.size());
+  for (auto& args : args_list) {
+    results.push_back(CFG_Python_call(pFunc, args));
+  }
   Py_XDECREF(pFunc);
   return results;
 }
@@ -5,10 +5,13 @@
 #include <chrono>
 #include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <regex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -81,6 +84,58 @@ struct CFG_Python_OBJ {
   std::vector<std::string> strs = {};
 };
 
+/*
+  Embedded Python interpreter shared by the whole process. It is initialized
+  on first use and lives until the process exits. The GIL is released
+  between calls, so it can be used from any thread. Module code is compiled
+  once and cached by file path; the entry is dropped when the file
+  modification time or size changes. Each load executes the code in a new
+  module namespace. Modules it imports from the directories of loaded files
+  are removed from sys.modules after the code ran, so every load imports its
+  own copy and loaders never see each other's globals. Other imports stay
+  shared; the ones outside the Python installation are stamped with their
+  file modification time and size and imported again once the file changes.
+*/
+class CFG_Python_Interpreter {
+ public:
+  static CFG_Python_Interpreter& get();
+  // new module object (new reference), caller must hold the GIL
+  void* load_module(const std::filesystem::path& fullpath,
+                    const std::string& name);
+  // prepend directory to sys.path once, caller must hold the GIL
+  void add_path(const std::string& dir);
+  // number of module code compilations, cache misses
+  uint32_t compile_count() const { return m_compile_count; }
+
+ private:
+  CFG_Python_Interpreter();
+  struct FILE_STAMP {
+    std::filesystem::file_time_type time;
+    uintmax_t size = 0;
+    bool operator!=(const FILE_STAMP& other) const {
+      return time != other.time || size != other.size;
+    }
+  };
+  struct CODE_OBJ {
+    FILE_STAMP stamp;
+    void* code = nullptr;
+  };
+  struct IMPORT_OBJ {
+    std::string file;
+    FILE_STAMP stamp;
+  };
+  static FILE_STAMP file_stamp(const std::filesystem::path& path);
+  bool is_local_import(const std::string& name, const std::string& file) const;
+  bool is_installed(const std::string& file) const;
+  std::map<std::string, CODE_OBJ> m_codes;
+  // shared imports by module name
+  std::map<std::string, IMPORT_OBJ> m_imports;
+  std::set<std::string> m_paths;
+  // sys.prefix and friends, modules under them are never stamped
+  std::set<std::string> m_prefixes;
+  uint32_t m_compile_count = 0;
+};
+
 class CFG_Python_MGR {
  public:
   CFG_Python_MGR(const std::string& filepath = "",
@@ -94,6 +149,10 @@ class CFG_Python_MGR {
   std::vector<CFG_Python_OBJ> run_file(const std::string& module,
                                        const std::string& function,
                                        std::vector<CFG_Python_OBJ> args);
+  // call function once per argument tuple, holding the GIL for all calls
+  std::vector<std::vector<CFG_Python_OBJ>> run_file_batch(
+      const std::string& module, const std::string& function,
+      std::vector<std::vector<CFG_Python_OBJ>> args_list);
   const std::map<std::string, CFG_Python_OBJ>& results();
   bool result_bool(const std::string& result);
   uint32_t result_u32(const std::string& result);
@@ -109,6 +168,81 @@ class CFG_Python_MGR {
   std::map<std::string, void*> module_objs;
 };
 
+/*
+  Read-only view of a binary file. The file is memory mapped, so pages are
+  loaded on first access and nothing is copied; files which can not be mapped
+  (empty or special files) are read into memory instead.
+*/
+class CFG_Mapped_File {
+ public:
+  CFG_Mapped_File(const std::string& filepath);
+  ~CFG_Mapped_File();
+  CFG_Mapped_File(const CFG_Mapped_File&) = delete;
+  CFG_Mapped_File& operator=(const CFG_Mapped_File&) = delete;
+  const uint8_t* data() const { return m_data; }
+  size_t size() const { return m_size; }
+  bool mapped() const { return m_mapped; }
+
+ private:
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+  bool m_mapped = false;
+  std::vector<uint8_t> m_buffer;
+#if defined(_WIN32)
+  void* m_file = nullptr;
+  void* m_mapping = nullptr;
+#endif
+};
+
+/*
+  Binary file written in large blocks. write() appends at the current end of
+  file. write_chunk() accepts numbered chunks (0, 1, 2 ...) from any thread and
+  in any order; a chunk is appended once all chunks before it are written, so
+  only the chunks which arrive early are kept in memory. close() asserts that
+  no chunk is missing.
+*/
+class CFG_Binary_Writer {
+ public:
+  CFG_Binary_Writer(const std::string& filepath,
+                    size_t block_size = size_t(1) << 20);
+  ~CFG_Binary_Writer();
+  void write(const uint8_t* data, size_t size);
+  void write_chunk(size_t index, std::vector<uint8_t>&& data);
+  void close();
+  uint64_t size() const { return m_size; }
+
+ private:
+  void append(const uint8_t* data, size_t size);
+  void flush();
+  const std::string m_filepath;
+  const size_t m_block_size;
+  std::ofstream m_file;
+  std::vector<uint8_t> m_block;
+  std::map<size_t, std::vector<uint8_t>> m_pending;
+  size_t m_next_chunk = 0;
+  uint64_t m_size = 0;
+  std::mutex m_mutex;
+};
+
+/*
+  Result of bitstream comparison. Bits are numbered LSB first within a byte,
+  frame is a group of frame_bits consecutive bits (32 by default, one line of
+  the WORD format dump). Only the common part of two bitstreams of different
+  size is compared bit by bit.
+*/
+struct CFG_Bitstream_Diff {
+  bool equal = false;
+  uint64_t size1 = 0;
+  uint64_t size2 = 0;
+  uint32_t crc1 = 0;
+  uint32_t crc2 = 0;
+  uint64_t diff_bits = 0;
+  uint64_t first_bit = 0;  // valid when not equal
+  uint64_t first_frame = 0;
+  uint64_t first_frame_bit = 0;
+  std::vector<uint64_t> bits;  // first mismatching bits, up to max_bits
+};
+
 std::string CFG_print(const char* format_string, ...);
 
 void CFG_assertion(const char* file, const char* func, size_t line,
@@ -241,9 +375,14 @@ void CFG_read_text_file(const std::string& filepath,
                         std::vector<std::string>& data,
                         bool trim_trailer_whitespace);
 
+// copy of the whole file, use CFG_map_binary_file() if data is only read
 void CFG_read_binary_file(const std::string& filepath,
                           std::vector<uint8_t>& data);
 
+// mapped read-only view of the whole file, nothing is copied
+std::unique_ptr<CFG_Mapped_File> CFG_map_binary_file(
+    const std::string& filepath);
+
 void CFG_write_binary_file(const std::string& filepath, const uint8_t* data,
                            const size_t data_size);
 
@@ -254,6 +393,23 @@ bool CFG_compare_two_text_files(const std::string& filepath1,
 bool CFG_compare_two_binary_files(const std::string& filepath1,
                                   const std::string& filepath2);
 
+// CRC-32 (IEEE 802.3, same as zlib), pass previous result to continue
+uint32_t CFG_crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+// index of the first different byte, size if the buffers are equal
+size_t CFG_find_mismatch(const uint8_t* data1, const uint8_t* data2,
+                         size_t size);
+
+CFG_Bitstream_Diff CFG_compare_bitstream(const uint8_t* data1, size_t size1,
+                                         const uint8_t* data2, size_t size2,
+                                         uint64_t frame_bits = 32,
+                                         size_t max_bits = 16);
+
+CFG_Bitstream_Diff CFG_compare_bitstream(const std::string& filepath1,
+                                         const std::string& filepath2,
+                                         uint64_t frame_bits = 32,
+                                         size_t max_bits = 16);
+
 std::map<std::string, CFG_Python_OBJ> CFG_Python(
     std::vector<std::string> commands, const std::vector<std::string> results,
     void* dict_ptr = nullptr);
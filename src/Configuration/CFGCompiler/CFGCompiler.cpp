@@ -77,6 +77,10 @@ CFGCompiler::~CFGCompiler() {
 
 Compiler* CFGCompiler::GetCompiler() const { return m_compiler; }
 
+std::vector<std::string> CFGCompiler::CommandNames() {
+  return {"programmer", "model_config", "compare_bitstream"};
+}
+
 bool CFGCompiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   bool status = true;
   if (batchMode) {
@@ -142,6 +146,83 @@ bool CFGCompiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     };
     interp->registerCmd("model_config", generic, this, 0);
   }
+  // compare_bitstream ?-frame_bits <n>? ?-max_bits <n>? <file1> <file2>
+  auto compare_bitstream = [](void* clientData, Tcl_Interp* interp, int argc,
+                              const char* argv[]) -> int {
+    CFGCompiler* cfgcompiler = (CFGCompiler*)clientData;
+    Compiler* compiler = cfgcompiler->GetCompiler();
+    const std::string usage =
+        "Usage: compare_bitstream ?-frame_bits <n>? ?-max_bits <n>? <file1> "
+        "<file2>";
+    uint64_t frame_bits = 32;
+    uint64_t max_bits = 16;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+      const std::string arg = argv[i];
+      if ((arg == "-frame_bits" || arg == "-max_bits") && (i + 1) < argc) {
+        bool status = false;
+        uint64_t value =
+            CFG_convert_string_to_u64(argv[++i], false, &status, nullptr);
+        if (!status) {
+          compiler->ErrorMessage("Invalid " + arg + " value " + argv[i]);
+          return TCL_ERROR;
+        }
+        (arg == "-frame_bits" ? frame_bits : max_bits) = value;
+      } else {
+        files.push_back(arg);
+      }
+    }
+    if (files.size() != 2) {
+      compiler->ErrorMessage(usage);
+      return TCL_ERROR;
+    }
+    for (const auto& file : files) {
+      if (!std::filesystem::is_regular_file(file)) {
+        compiler->ErrorMessage("Bitstream file " + file + " does not exist");
+        return TCL_ERROR;
+      }
+    }
+    CFG_Bitstream_Diff diff;
+    try {
+      diff = CFG_compare_bitstream(files[0], files[1], frame_bits,
+                                   (size_t)(max_bits));
+    } catch (std::exception& e) {
+      compiler->ErrorMessage(CFG_print("%s", e.what()));
+      return TCL_ERROR;
+    }
+    const std::string crc1 = CFG_print("0x%08X", diff.crc1);
+    const std::string crc2 = CFG_print("0x%08X", diff.crc2);
+    if (diff.equal) {
+      compiler->Message("Bitstreams are identical (" +
+                        std::to_string(diff.size1) + " bytes, CRC " + crc1 +
+                        ")");
+    } else {
+      compiler->Message("Bitstreams differ: " +
+                        std::to_string(diff.diff_bits) +
+                        " differing bits, sizes " + std::to_string(diff.size1) +
+                        " and " + std::to_string(diff.size2) + " bytes");
+      compiler->Message("First mismatch at bit " +
+                        std::to_string(diff.first_bit) + " (frame " +
+                        std::to_string(diff.first_frame) + ", bit " +
+                        std::to_string(diff.first_frame_bit) + ")");
+    }
+    // key value list, bits are positions of the first mismatches
+    std::string bits;
+    for (auto bit : diff.bits) {
+      bits += (bits.empty() ? "" : " ") + std::to_string(bit);
+    }
+    std::string result =
+        "equal " + std::to_string(diff.equal ? 1 : 0) + " size1 " +
+        std::to_string(diff.size1) + " size2 " + std::to_string(diff.size2) +
+        " crc1 " + crc1 + " crc2 " + crc2 + " diff_bits " +
+        std::to_string(diff.diff_bits) + " first_bit " +
+        std::to_string(diff.first_bit) + " first_frame " +
+        std::to_string(diff.first_frame) + " first_frame_bit " +
+        std::to_string(diff.first_frame_bit);
+    compiler->TclInterp()->setResult(result + " bits {" + bits + "}");
+    return TCL_OK;
+  };
+  interp->registerCmd("compare_bitstream", compare_bitstream, this, 0);
   status = RegisterCallbackFunction("programmer", programmer_entry);
   status = RegisterCallbackFunction("model_config", model_config_entry);
   return status;
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "Configuration/CFGCommon/CFGCommon.h"
 
@@ -21,6 +22,8 @@ class CFGCompiler {
   ~CFGCompiler();
   Compiler* GetCompiler() const;
   bool RegisterCommands(TclInterpreter* interp, bool batchMode);
+  // names of the commands RegisterCommands() creates
+  static std::vector<std::string> CommandNames();
   bool RegisterCallbackFunction(std::string name,
                                 cfg_callback_function function);
   bool Configure();
@@ -539,7 +539,16 @@ class ModelConfig_DEVICE {
     uint32_t addr = 0;
     std::vector<uint8_t> data;
     std::ofstream file;
-    if (format != "BIN") {
+    // BIN is streamed in chunks, only one chunk is kept in memory
+    const size_t total_bytes = (m_total_bits + 7) / 8;
+    const size_t chunk_size = size_t(1) << 16;
+    std::unique_ptr<CFG_Binary_Writer> writer;
+    std::vector<uint8_t> chunk;
+    size_t chunk_index = 0;
+    if (format == "BIN") {
+      writer = std::make_unique<CFG_Binary_Writer>(filename);
+      chunk.resize(std::min(chunk_size, total_bytes));
+    } else {
       file.open(filename.c_str());
       CFG_ASSERT(file.is_open());
       CFG_ASSERT(file.good());
@@ -555,7 +564,7 @@ class ModelConfig_DEVICE {
                     .c_str();
       }
     }
-    if (format == "BIT" || format == "WORD" || format == "BIN") {
+    if (format == "BIT" || format == "WORD") {
       for (uint32_t i = 0; i < (((m_total_bits + 31) / 32) * 4); i++) {
         data.push_back(0);
       }
@@ -571,6 +580,20 @@ class ModelConfig_DEVICE {
             data[addr >> 3] |= (1 << (addr & 7));
           }
         }
+      } else if (writer) {
+        for (uint32_t i = 0; i < bitfield->m_size; i++, addr++) {
+          size_t offset = (addr >> 3) - chunk_index * chunk_size;
+          if (offset == chunk_size) {
+            writer->write_chunk(chunk_index++, std::move(chunk));
+            chunk.assign(
+                std::min(chunk_size, total_bytes - chunk_index * chunk_size),
+                0);
+            offset = 0;
+          }
+          if (bitfield->m_value & (1 << i)) {
+            chunk[offset] |= (1 << (addr & 7));
+          }
+        }
       } else if (format == "DETAIL") {
         if (bitfield->m_block_name != block_name) {
           file << CFG_print("Block %s [%s]\n", bitfield->m_block_name.c_str(),
@@ -620,10 +643,12 @@ class ModelConfig_DEVICE {
             file << "\n";
           }
         }
-      } else {
-        CFG_write_binary_file(filename, &data[0], (m_total_bits + 7) / 8);
       }
     }
+    if (writer) {
+      writer->write_chunk(chunk_index, std::move(chunk));
+      writer->close();
+    }
     if (file.is_open()) {
       file.flush();
       file.close();
@@ -49,6 +49,8 @@ class DesignQuery {
   const nlohmann::ordered_json& getHierJson() const { return m_hier_json; }
   const nlohmann::ordered_json& getPortJson() const { return m_port_json; }
   bool RegisterCommands(TclInterpreter* interp, bool batchMode);
+  // names of the commands RegisterCommands() creates
+  static std::vector<std::string> CommandNames();
   std::filesystem::path GetProjDir() const;
   std::filesystem::path GetHierInfoPath() const;
   std::filesystem::path GetPortInfoPath() const;
@@ -27,6 +27,12 @@
 #include "sdtgen.h"
 
 #include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
 
 #include "nlohmann_json/json.hpp"
 
@@ -47,7 +53,7 @@ string node_tab = "\t";
 string subnode_tab = "\t\t";
 string subsubnode_tab = "\t\t\t";
 
-int get_soc_node(nlohmann::json data, SdtSocNode &sdt_soc_node_obj,
+int get_soc_node(SdtJsonView data, SdtSocNode &sdt_soc_node_obj,
                  int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["soc"].empty())) {
     if (!data["root"]["soc"]["#size-cells"].empty()) {
@@ -1730,7 +1736,7 @@ int get_soc_node(nlohmann::json data, SdtSocNode &sdt_soc_node_obj,
 }
 
 // void get_memory_node(json data, SdtMemoryNode &sdt_memory_node_obj) {
-int get_memory_node(nlohmann::json data, SdtMemoryNode &sdt_memory_node_obj,
+int get_memory_node(SdtJsonView data, SdtMemoryNode &sdt_memory_node_obj,
                     int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["memory"].empty())) {
     // this tells that the object has been populated
@@ -1960,7 +1966,7 @@ int get_memory_node(nlohmann::json data, SdtMemoryNode &sdt_memory_node_obj,
 
 // void get_cpus_cluster(json data, SdtCpusClusterNode
 // &sdt_cpus_cluster_node_obj) {
-int get_cpus_cluster_node(nlohmann::json data,
+int get_cpus_cluster_node(SdtJsonView data,
                           SdtCpusClusterNode &sdt_cpus_cluster_node_obj,
                           int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["cpus-cluster"].empty())) {
@@ -2301,7 +2307,7 @@ int get_cpus_cluster_node(nlohmann::json data,
 
 // void get_rootmetadata_node (json data, SdtRootMetaDataNode
 // &sdt_rootmetadata_node_obj) {
-int get_rootmetadata_node(nlohmann::json data,
+int get_rootmetadata_node(SdtJsonView data,
                           SdtRootMetaDataNode &sdt_rootmetadata_node_obj,
                           int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["sdt_root_metadata"].empty())) {
@@ -2371,7 +2377,7 @@ int get_rootmetadata_node(nlohmann::json data,
 }
 
 // void get_cpus (json data, SdtCpusNode &sdt_cpus_node_obj) {
-int get_cpus_node(nlohmann::json data, SdtCpusNode &sdt_cpus_node_obj,
+int get_cpus_node(SdtJsonView data, SdtCpusNode &sdt_cpus_node_obj,
                   int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["cpus"].empty())) {
     if (!data["root"]["cpus"]["#address-cells"].empty()) {
@@ -3032,44 +3038,167 @@ int get_cpus_node(nlohmann::json data, SdtCpusNode &sdt_cpus_node_obj,
   }
 }
 
-string return_string_from_ofstream_file(ofstream &outfile, string file_path) {
-  // first we flush the outfile
-  outfile.flush();
-
-  int size;
-
-  ifstream inputFile;
-
-  inputFile.open(file_path);
-
-  // calculating size of inputFile
-  inputFile.seekg(0, inputFile.end);
-  size = inputFile.tellg();
-  inputFile.seekg(0, inputFile.beg);
-
-  // allocate memory:
-  char *data_file = new char[size];
-
-  // read data as a block:
-  inputFile.read(data_file, size);
-
-  inputFile.close();
-
-  // printf("Printing the read JSON file file \n");
+// file header of every generated sdt
+static const char *sdt_file_header =
+    "/*\n"
+    "     *\n"
+    "     * @author Zaid Tahir "
+    "(zaid.butt.tahir@gmail.com or zaidt@bu.edu"
+    " or https://github.com/zaidtahirbutt)\n"
+    "     * @date 2023-08-30\n"
+    "     * @copyright Copyright 2021 The Foedag team\n"
+    "     \n"
+    "     * GPL License\n"
+    "     \n"
+    "     * Copyright (c) 2021 The Open-Source FPGA Foundation\n"
+    "     \n"
+    "     * This program is free software: you can redistribute it and/or"
+    " modify\n"
+    "     * it under the terms of the GNU General Public License as"
+    " published by\n"
+    "     * the Free Software Foundation, either version 3 of the License, or\n"
+    "     * (at your option) any later version.\n"
+    "     \n"
+    "     * This program is distributed in the hope that it will be useful,\n"
+    "     * but WITHOUT ANY WARRANTY; without even the implied warranty of\n"
+    "     * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"
+    "     * GNU General Public License for more details.\n"
+    "     \n"
+    "     * You should have received a copy of the GNU General Public License\n"
+    "     * along with this program.  If not, see"
+    " <http://www.gnu.org/licenses/>. \n"
+    "*/\n"
+    "\n";
+
+std::shared_ptr<const nlohmann::json> sdt_load_json(const string &file_path,
+                                                    string &error) {
+  struct Entry {
+    std::filesystem::file_time_type mtime;
+    uintmax_t size;
+    std::shared_ptr<const nlohmann::json> data;
+  };
+  static std::mutex lock;
+  static std::map<string, Entry> cache;
+
+  std::error_code ec;
+  const auto mtime = std::filesystem::last_write_time(file_path, ec);
+  const uintmax_t size = ec ? 0 : std::filesystem::file_size(file_path, ec);
+  if (ec) {
+    error = "Cannot open file " + file_path;
+    return nullptr;
+  }
+  std::scoped_lock guard{lock};
+  auto it = cache.find(file_path);
+  if (it != cache.end() && it->second.mtime == mtime &&
+      it->second.size == size) {
+    return it->second.data;
+  }
+  ifstream input{file_path};
+  if (!input.is_open()) {
+    error = "Cannot open file " + file_path;
+    return nullptr;
+  }
+  try {
+    auto data = std::make_shared<const nlohmann::json>(
+        nlohmann::json::parse(input));
+    cache[file_path] = {mtime, size, data};
+    return data;
+  } catch (const nlohmann::json::parse_error &e) {
+    error = "Failed to parse file " + file_path + ": " + e.what();
+    return nullptr;
+  }
+}
 
-  // print content:
-  // cout.write (data_file, size);
+// runs tasks, concurrently if parallel is set, and returns AND of results
+static int sdt_run_tasks(const std::vector<std::function<int()>> &tasks,
+                         bool parallel) {
+  int result = 1;
+  if (!parallel) {
+    for (const auto &task : tasks) result &= task();
+    return result;
+  }
+  std::vector<std::future<int>> futures;
+  for (const auto &task : tasks)
+    futures.push_back(std::async(std::launch::async, task));
+  for (auto &future : futures) result &= future.get();
+  return result;
+}
 
-  string data_file_string = data_file;
-  // string data_file_string = string(data_file);
+int sdt_gen_device_tree(const nlohmann::json &data, int nodes, string &output,
+                        int verbose) {
+  SdtRootMetaDataNode rootmetadata_node_obj;
+  SdtCpusNode cpus_node_obj;
+  SdtCpusClusterNode cpus_cluster_node_obj;
+  SdtMemoryNode memory_node_obj;
+  SdtSocNode soc_node_obj;
+
+  // every getter reads shared json and fills its own node object only
+  const SdtJsonView view{data};
+  std::vector<std::function<int()>> getters;
+  std::vector<std::function<int(ostream &)>> generators;
+  if (nodes & SDT_ROOTMETADATA_NODE) {
+    getters.push_back([&]() {
+      return get_rootmetadata_node(view, rootmetadata_node_obj, verbose);
+    });
+    generators.push_back([&](ostream &out) {
+      return gen_rootmetadata_node(out, rootmetadata_node_obj, verbose);
+    });
+  }
+  if (nodes & SDT_CPUS_NODE) {
+    SdtCpuInstSubNode::total_instances = 0;
+    getters.push_back(
+        [&]() { return get_cpus_node(view, cpus_node_obj, verbose); });
+    generators.push_back([&](ostream &out) {
+      return gen_cpus_node(out, cpus_node_obj, verbose);
+    });
+  }
+  if (nodes & SDT_CPUS_CLUSTER_NODE) {
+    SdtCpuClusterInstSubNode::total_instances = 0;
+    getters.push_back([&]() {
+      return get_cpus_cluster_node(view, cpus_cluster_node_obj, verbose);
+    });
+    generators.push_back([&](ostream &out) {
+      return gen_cpus_cluster_node(out, cpus_cluster_node_obj, verbose);
+    });
+  }
+  if (nodes & SDT_MEMORY_NODE) {
+    SdtMemoryInstSubNode::total_instances = 0;
+    getters.push_back(
+        [&]() { return get_memory_node(view, memory_node_obj, verbose); });
+    generators.push_back([&](ostream &out) {
+      return gen_memory_node(out, memory_node_obj, verbose);
+    });
+  }
+  if (nodes & SDT_SOC_NODE) {
+    SdtSocInstSubNode::total_instances = 0;
+    getters.push_back(
+        [&]() { return get_soc_node(view, soc_node_obj, verbose); });
+    generators.push_back(
+        [&](ostream &out) { return gen_soc_node(out, soc_node_obj, verbose); });
+  }
 
-  return data_file_string;
+  // verbose output of getters and generators must not interleave
+  const bool parallel = !verbose && (getters.size() > 1);
+  int status = sdt_run_tasks(getters, parallel);
+
+  // every node is generated into its own buffer, buffers are joined in order
+  std::vector<stringstream> buffers(generators.size());
+  std::vector<std::function<int()>> tasks;
+  for (size_t i = 0; i < generators.size(); i++)
+    tasks.push_back([&, i]() { return generators[i](buffers[i]); });
+  status &= sdt_run_tasks(tasks, parallel);
+
+  output = sdt_file_header;
+  output += "/dts-v1/;\n\n/ {\n";
+  for (const auto &buffer : buffers) output += buffer.str();
+  output += "\n\n};\n";
+  return status;
 }
 
 // passing &output by ref cx we wana change it
-int gen_rootmetadata_node(ofstream &outfile,
-                          SdtRootMetaDataNode sdt_rootmetadata_node_obj,
-                          int verbose) {
+int gen_rootmetadata_node(
+    ostream &outfile, const SdtRootMetaDataNode &sdt_rootmetadata_node_obj,
+    int verbose) {
   stringstream buffer;
   // https://stackoverflow.com/questions/5193173/getting-cout-output-to-a-stdstring
 
@@ -3120,9 +3249,9 @@ int gen_rootmetadata_node(ofstream &outfile,
 
 // string gen_cpus_cluster_node(ofstream &outfile, SdtCpusClusterNode
 // sdt_cpus_cluster_node_obj, int verbose) {
-int gen_cpus_cluster_node(ofstream &outfile,
-                          SdtCpusClusterNode sdt_cpus_cluster_node_obj,
-                          int verbose) {
+int gen_cpus_cluster_node(
+    ostream &outfile, const SdtCpusClusterNode &sdt_cpus_cluster_node_obj,
+    int verbose) {
   stringstream buffer;
 
   if (sdt_cpus_cluster_node_obj.object_has_been_populated) {
@@ -3493,7 +3622,8 @@ string gen_soc_subsystem_int_controller(
 
 // string gen_soc_node(ofstream &outfile, SdtSocNode sdt_soc_node_obj, int
 // verbose) {
-int gen_soc_node(ofstream &outfile, SdtSocNode sdt_soc_node_obj, int verbose) {
+int gen_soc_node(ostream &outfile, const SdtSocNode &sdt_soc_node_obj,
+                 int verbose) {
   stringstream buffer;
   string generated_soc_subsystem_string;
 
@@ -3601,8 +3731,8 @@ int gen_soc_node(ofstream &outfile, SdtSocNode sdt_soc_node_obj, int verbose) {
 // passing &output by ref cx we wana change it
 // string gen_memory_node(ofstream &outfile, SdtMemoryNode sdt_memory_node_obj,
 // int verbose) {
-int gen_memory_node(ofstream &outfile, SdtMemoryNode sdt_memory_node_obj,
-                    int verbose) {
+int gen_memory_node(ostream &outfile,
+                    const SdtMemoryNode &sdt_memory_node_obj, int verbose) {
   stringstream buffer;
 
   if (sdt_memory_node_obj.object_has_been_populated) {
@@ -3662,7 +3792,7 @@ int gen_memory_node(ofstream &outfile, SdtMemoryNode sdt_memory_node_obj,
 // passing &output by ref cx we wana change it
 // string gen_cpus_node(ofstream &outfile, SdtCpusNode sdt_cpus_node_obj, int
 // verbose) {
-int gen_cpus_node(ofstream &outfile, SdtCpusNode sdt_cpus_node_obj,
+int gen_cpus_node(ostream &outfile, const SdtCpusNode &sdt_cpus_node_obj,
                   int verbose) {
   stringstream buffer;
 
@@ -41,7 +41,9 @@ using namespace std;
 #include <iostream>
 #include <limits>
 #include <sstream>  // header file for stringstream
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
 
 // debugging using GDB
 // §
@@ -725,44 +727,107 @@ class SdtSocNode {
   }
 };
 
+// read-only view of parsed json. Missing keys and indexes give null value
+// instead of inserting it, so one parsed document can be shared by all node
+// getters, also from several threads
+class SdtJsonView {
+ public:
+  SdtJsonView(const nlohmann::json &json) : m_json(&json) {}
+
+  SdtJsonView operator[](const char *key) const {
+    if (m_json->is_object()) {
+      auto it = m_json->find(key);
+      return (it != m_json->end()) ? SdtJsonView{*it} : null();
+    }
+    // same type error as json::operator[] for non object values
+    return m_json->is_null() ? null() : SdtJsonView{(*m_json)[key]};
+  }
+  SdtJsonView operator[](size_t index) const {
+    if (m_json->is_array())
+      return (index < m_json->size()) ? SdtJsonView{(*m_json)[index]} : null();
+    return m_json->is_null() ? null() : SdtJsonView{(*m_json)[index]};
+  }
+
+  bool empty() const { return m_json->empty(); }
+  bool is_array() const { return m_json->is_array(); }
+  bool is_number() const { return m_json->is_number(); }
+  bool is_string() const { return m_json->is_string(); }
+  size_t size() const { return m_json->size(); }
+
+  template <typename T,
+            typename std::enable_if<std::is_same<T, string>::value ||
+                                        std::is_same<T, int>::value,
+                                    int>::type = 0>
+  operator T() const {
+    return m_json->get<T>();
+  }
+
+ private:
+  static SdtJsonView null() {
+    static const nlohmann::json value;
+    return SdtJsonView{value};
+  }
+  const nlohmann::json *m_json;
+};
+
 // void get_soc_node(json data, SdtSocNode &sdt_soc_node_obj) {
-int get_soc_node(nlohmann::json data, SdtSocNode &sdt_soc_node_obj,
+int get_soc_node(SdtJsonView data, SdtSocNode &sdt_soc_node_obj,
                  int verbose = 0);
 
 // void get_memory_node(json data, SdtMemoryNode &sdt_memory_node_obj) {
-int get_memory_node(nlohmann::json data, SdtMemoryNode &sdt_memory_node_obj,
+int get_memory_node(SdtJsonView data, SdtMemoryNode &sdt_memory_node_obj,
                     int verbose = 0);
 
 // void get_cpus_cluster(json data, SdtCpusClusterNode
 // &sdt_cpus_cluster_node_obj) {
-int get_cpus_cluster_node(nlohmann::json data,
+int get_cpus_cluster_node(SdtJsonView data,
                           SdtCpusClusterNode &sdt_cpus_cluster_node_obj,
                           int verbose = 0);
 
 // void get_rootmetadata_node (nlohmann::json data, SdtRootMetaDataNode
 // &sdt_rootmetadata_node_obj) {
-int get_rootmetadata_node(nlohmann::json data,
+int get_rootmetadata_node(SdtJsonView data,
                           SdtRootMetaDataNode &sdt_rootmetadata_node_obj,
                           int verbose = 0);
 
 // void get_cpus (json data, SdtCpusNode &sdt_cpus_node_obj) {
-int get_cpus_node(nlohmann::json data, SdtCpusNode &sdt_cpus_node_obj,
+int get_cpus_node(SdtJsonView data, SdtCpusNode &sdt_cpus_node_obj,
                   int verbose = 0);
 
-string return_string_from_ofstream_file(ofstream &outfile, string file_path);
+// nodes generated by sdt_gen_device_tree
+enum SdtNodes {
+  SDT_ROOTMETADATA_NODE = 1 << 0,
+  SDT_CPUS_NODE = 1 << 1,
+  SDT_CPUS_CLUSTER_NODE = 1 << 2,
+  SDT_MEMORY_NODE = 1 << 3,
+  SDT_SOC_NODE = 1 << 4,
+  SDT_ALL_NODES = SDT_ROOTMETADATA_NODE | SDT_CPUS_NODE |
+                  SDT_CPUS_CLUSTER_NODE | SDT_MEMORY_NODE | SDT_SOC_NODE
+};
+
+// parses json file, parsed document is reused while file is unchanged.
+// Returns nullptr and sets error if file can't be read or parsed.
+std::shared_ptr<const nlohmann::json> sdt_load_json(const string &file_path,
+                                                    string &error);
+
+// builds selected nodes from parsed json and generates complete sdt into
+// output. Nodes are built concurrently unless verbose is set, verbose output
+// keeps its order then. Returns 1 if every node was generated.
+int sdt_gen_device_tree(const nlohmann::json &data, int nodes, string &output,
+                        int verbose = 0);
 
 // passing &output by ref cx we wana change it
 // string gen_rootmetadata_node(ofstream &outfile, SdtRootMetaDataNode
 // sdt_rootmetadata_node_obj, int verbose=0) {
-int gen_rootmetadata_node(ofstream &outfile,
-                          SdtRootMetaDataNode sdt_rootmetadata_node_obj,
-                          int verbose = 0);
+int gen_rootmetadata_node(
+    ostream &outfile, const SdtRootMetaDataNode &sdt_rootmetadata_node_obj,
+    int verbose = 0);
 
 // string gen_cpus_cluster_node(ofstream &outfile, SdtCpusClusterNode
 // sdt_cpus_cluster_node_obj, int verbose=0) {
-int gen_cpus_cluster_node(ofstream &outfile,
-                          SdtCpusClusterNode sdt_cpus_cluster_node_obj,
-                          int verbose = 0);
+int gen_cpus_cluster_node(
+    ostream &outfile, const SdtCpusClusterNode &sdt_cpus_cluster_node_obj,
+    int verbose = 0);
 
 string gen_soc_subsystem_timer(stringstream &buffer_out,
                                SdtSocInstSubNodeTimer *soc_timer_object,
@@ -787,19 +852,19 @@ string gen_soc_subsystem_int_controller(
 
 // string gen_soc_node(ofstream &outfile, SdtSocNode sdt_soc_node_obj, int
 // verbose=0) {
-int gen_soc_node(ofstream &outfile, SdtSocNode sdt_soc_node_obj,
+int gen_soc_node(ostream &outfile, const SdtSocNode &sdt_soc_node_obj,
                  int verbose = 0);
 
 // passing &output by ref cx we wana change it
 // string gen_memory_node(ofstream &outfile, SdtMemoryNode sdt_memory_node_obj,
 // int verbose=0) {
-int gen_memory_node(ofstream &outfile, SdtMemoryNode sdt_memory_node_obj,
-                    int verbose = 0);
+int gen_memory_node(ostream &outfile,
+                    const SdtMemoryNode &sdt_memory_node_obj, int verbose = 0);
 
 // passing &output by ref cx we wana change it
 // string gen_cpus_node(ofstream &outfile, SdtCpusNode sdt_cpus_node_obj, int
 // verbose=0) {
-int gen_cpus_node(ofstream &outfile, SdtCpusNode sdt_cpus_node_obj,
+int gen_cpus_node(ostream &outfile, const SdtCpusNode &sdt_cpus_node_obj,
                   int verbose = 0);
 
 // int SdtCpuInstSubNode::total_instances;
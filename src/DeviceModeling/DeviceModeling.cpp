@@ -95,6 +95,33 @@ std::filesystem::path DeviceModeling::GetProjDir() const {
   return dir;
 }
 
+std::vector<std::string> DeviceModeling::CommandNames() {
+  return {"test_device_modeling_tcl", "example_command_ret_i",
+          "example_command_ret_list", "device_name", "device_version",
+          "schema_version", "define_enum_type", "define_block",
+          "undefine_device", "define_ports", "define_param_type",
+          "define_param", "define_attr", "define_constraint", "create_instance",
+          "create_instances", "define_properties", "get_property",
+          "add_block_to_chain_type", "append_instance_to_chain",
+          "append_instances_to_chain", "create_chain_instance",
+          "create_instance_chain", "define_chain", "define_net", "define_nets",
+          "drive_net", "drive_port", "get_attributes", "get_parameters",
+          "get_parameter_types", "get_block_names", "get_instance_chain_names",
+          "get_instance_chain_by_name", "get_constraint_names",
+          "get_constraint_by_name", "get_instance_block_name",
+          "get_instance_block_type", "get_instance_by_id", "get_instance_id",
+          "get_instance_id_set", "get_instance_names",
+          "get_instance_chains_names", "get_instance_chain",
+          "get_instance_name_set", "get_io_bank", "get_logic_address",
+          "set_logic_address", "get_logic_location", "get_net_sink_set",
+          "get_net_source", "get_parent", "get_phy_address",
+          "get_port_connections", "get_port_connection_sink_set",
+          "get_port_connection_source", "get_port_list", "link_chain",
+          "map_rtl_user_names", "get_rtl_name", "map_model_user_names",
+          "get_model_name", "get_user_name", "set_io_bank",
+          "set_logic_location", "set_phy_address", "set_phy_addresses"};
+}
+
 bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   auto test_device_modeling_tcl = [](void* clientData, Tcl_Interp* interp,
                                      int argc, const char* argv[]) -> int {
@@ -324,6 +351,22 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   };
   interp->registerCmd("create_instance", create_instance, this, 0);
 
+  auto create_instances = [](void* clientData, Tcl_Interp* interp, int argc,
+                             const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      status = Model::get_modler().create_instances(argc, argv);
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+    return (status) ? TCL_OK : TCL_ERROR;
+  };
+  interp->registerCmd("create_instances", create_instances, this, 0);
+
   auto define_properties = [](void* clientData, Tcl_Interp* interp, int argc,
                               const char* argv[]) -> int {
     DeviceModeling* device_modeling = (DeviceModeling*)clientData;
@@ -393,6 +436,23 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   interp->registerCmd("append_instance_to_chain", append_instance_to_chain,
                       this, 0);
 
+  auto append_instances_to_chain = [](void* clientData, Tcl_Interp* interp,
+                                      int argc, const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      status = Model::get_modler().append_instances_to_chain(argc, argv);
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+    return (status) ? TCL_OK : TCL_ERROR;
+  };
+  interp->registerCmd("append_instances_to_chain", append_instances_to_chain,
+                      this, 0);
+
   auto create_chain_instance = [](void* clientData, Tcl_Interp* interp,
                                   int argc, const char* argv[]) -> int {
     // TODO: Implement this API
@@ -454,6 +514,22 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   };
   interp->registerCmd("define_net", define_net, this, 0);
 
+  auto define_nets = [](void* clientData, Tcl_Interp* interp, int argc,
+                        const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      status = Model::get_modler().define_nets(argc, argv);
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+    return (status) ? TCL_OK : TCL_ERROR;
+  };
+  interp->registerCmd("define_nets", define_nets, this, 0);
+
   auto drive_net = [](void* clientData, Tcl_Interp* interp, int argc,
                       const char* argv[]) -> int {
     // TODO: Implement this API
@@ -1159,5 +1235,21 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   };
   interp->registerCmd("set_phy_address", set_phy_address, this, 0);
 
+  auto set_phy_addresses = [](void* clientData, Tcl_Interp* interp, int argc,
+                              const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      status = Model::get_modler().set_phy_addresses(argc, argv);
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+    return (status) ? TCL_OK : TCL_ERROR;
+  };
+  interp->registerCmd("set_phy_addresses", set_phy_addresses, this, 0);
+
   return true;
 }
@@ -51,6 +51,8 @@ class DeviceModeling {
   virtual ~DeviceModeling() {}
   Compiler* GetCompiler() { return m_compiler; }
   bool RegisterCommands(TclInterpreter* interp, bool batchMode);
+  // names of the commands RegisterCommands() creates
+  static std::vector<std::string> CommandNames();
   std::filesystem::path GetProjDir() const;
 
  protected:
@@ -20,6 +20,7 @@
 #include <memory>
 #include <regex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "Configuration/CFGCommon/CFGCommon.h"
 #include "Utils/StringUtils.h"
@@ -315,6 +316,102 @@ class device_modeler {
     return false;
   }
 
+  /**
+   * @brief Expand index ranges of a name pattern.
+   *
+   * Every "[first:last]" or "[first:last:step]" in the pattern is replaced by
+   * the indices of the range, first to last inclusive, descending if first is
+   * greater than last. Several ranges give all combinations, left-most range
+   * varies slowest: "io_[0:1]_[3:2]" expands to io_0_3, io_0_2, io_1_3 and
+   * io_1_2. Brackets without ':' are kept as they are.
+   *
+   * @param pattern The name pattern.
+   * @param names The vector the expanded names are appended to.
+   * @throws std::invalid_argument if a range is malformed.
+   */
+  void expand_name_range(const std::string &pattern,
+                         std::vector<std::string> &names) {
+    struct range {
+      int first;
+      int step;  // negative for descending ranges
+      size_t count;
+    };
+    std::vector<std::string> parts{std::string{}};  // text around ranges
+    std::vector<range> ranges;
+    size_t pos = 0;
+    while (pos < pattern.size()) {
+      size_t open = pattern.find('[', pos);
+      size_t close =
+          (open == std::string::npos) ? open : pattern.find(']', open);
+      if (close == std::string::npos) {
+        parts.back() += pattern.substr(pos);
+        break;
+      }
+      std::string body = pattern.substr(open + 1, close - open - 1);
+      if (body.find(':') == std::string::npos) {
+        parts.back() += pattern.substr(pos, close + 1 - pos);
+        pos = close + 1;
+        continue;
+      }
+      std::vector<std::string> bounds;
+      FOEDAG::StringUtils::tokenize(body, ":", bounds, false);
+      bool valid = (bounds.size() == 2 || bounds.size() == 3);
+      for (const auto &bound : bounds) {
+        valid = valid && !bound.empty() &&
+                std::all_of(bound.begin(), bound.end(), ::isdigit);
+      }
+      if (!valid) {
+        throw std::invalid_argument("Invalid range [" + body + "] in " +
+                                    pattern);
+      }
+      int first = convert_string_to_integer(bounds[0]);
+      int last = convert_string_to_integer(bounds[1]);
+      int step = (bounds.size() == 3) ? convert_string_to_integer(bounds[2])
+                                      : 1;
+      if (step == 0) {
+        throw std::invalid_argument("Zero step of range [" + body + "] in " +
+                                    pattern);
+      }
+      size_t count = std::abs(last - first) / step + 1;
+      ranges.push_back({first, (first <= last) ? step : -step, count});
+      parts.back() += pattern.substr(pos, open - pos);
+      parts.emplace_back();
+      pos = close + 1;
+    }
+    size_t total = 1;
+    for (const auto &r : ranges) total *= r.count;
+    names.reserve(names.size() + total);
+    std::vector<size_t> counters(ranges.size(), 0);
+    while (true) {
+      std::string name = parts[0];
+      for (size_t i = 0; i < ranges.size(); i++) {
+        name += std::to_string(ranges[i].first +
+                               ranges[i].step * static_cast<int>(counters[i]));
+        name += parts[i + 1];
+      }
+      names.push_back(std::move(name));
+      // odometer, right-most range varies fastest
+      size_t i = ranges.size();
+      while (i > 0 && ++counters[i - 1] == ranges[i - 1].count) {
+        counters[--i] = 0;
+      }
+      if (i == 0) break;
+    }
+  }
+
+  /**
+   * @brief Expand a list of name patterns.
+   * @param list White space separated name patterns, see expand_name_range.
+   * @return The expanded names in list order.
+   */
+  std::vector<std::string> expand_name_list(const std::string &list) {
+    std::vector<std::string> names;
+    for (const auto &pattern : split_string_by_space(list)) {
+      expand_name_range(pattern, names);
+    }
+    return names;
+  }
+
   bool define_enum_type(int argc, const char **argv) {
     if (!current_device_) {
       throw std::runtime_error("No current device");
@@ -467,26 +564,46 @@ class device_modeler {
     return true;
   }
 
+  /**
+   * @brief Adds input and output ports to an already defined block.
+   *
+   * Example command: define_ports -block io -in a b -out y
+   *
+   * With -expand, port names are patterns like d_[7:0], see
+   * expand_name_range. Without it names are taken as they are.
+   */
   bool define_ports(int argc, const char **argv) {
     if (!current_device_) {
       throw std::runtime_error("No current device");
     }
     std::string blockName;
     std::vector<std::pair<std::string, std::string>> ports;
+    // names are taken as they are unless -expand is given
+    bool expand = false;
 
     for (int i = 0; i < argc; ++i) {
       if (strcmp(argv[i], "-block") == 0 && i + 1 < argc) {
         blockName = argv[++i];
+      } else if (strcmp(argv[i], "-expand") == 0) {
+        expand = true;
       } else if (strcmp(argv[i], "-in") == 0 || strcmp(argv[i], "-out") == 0) {
         std::string direction = (strcmp(argv[i], "-in") == 0) ? "in" : "out";
         i++;  // skip the "-in" or "-out"
         while (i < argc && argv[i][0] != '-') {
-          std::string portName = argv[i++];
-          ports.emplace_back(direction, portName);
+          ports.emplace_back(direction, argv[i++]);
         }
         if (i < argc) i--;  // back to the last read not a port value
       }
     }
+    if (expand) {
+      std::vector<std::pair<std::string, std::string>> expanded;
+      for (auto &p : ports) {
+        for (auto &portName : expand_name_list(p.second)) {
+          expanded.emplace_back(p.first, std::move(portName));
+        }
+      }
+      ports = std::move(expanded);
+    }
 
     if (blockName.empty()) {
       throw std::invalid_argument("Block name is not provided or invalid");
@@ -503,14 +620,19 @@ class device_modeler {
     }
 
     // Add new ports to the fetched block.
+    std::vector<std::shared_ptr<device_port>> created;
+    created.reserve(ports.size());
+    block->ports().reserve(block->ports().size() + ports.size());
     for (auto &p : ports) {
-      block->add_port(std::make_shared<device_port>(p.second, p.first == "in",
-                                                    nullptr, block.get()));
-      // std::cout << "Done creating port " << p.second << std::endl;
+      created.push_back(std::make_shared<device_port>(
+          p.second, p.first == "in", nullptr, block.get()));
+      block->add_port(created.back());
     }
-    for (auto &p : ports) {
-      auto sg = block->get_port(p.second)->get_signal();
-      block->add_signal(p.second, std::shared_ptr<device_signal>(sg));
+    block->device_signals().reserve(block->device_signals().size() +
+                                    ports.size());
+    for (auto &port : created) {
+      block->add_signal(port->get_name(),
+                        std::shared_ptr<device_signal>(port->get_signal()));
     }
     return true;
   }
@@ -1054,6 +1176,126 @@ class device_modeler {
     parent_block->add_instance(name, parent_block->instance_vector().back());
     return true;
   }
+
+  /**
+   * @brief Creates instances of a block in one call.
+   *
+   * Bulk variant of create_instance. Arguments are read in one pass and the
+   * block and parent are looked up once. Accepted arguments:
+   * - `-block`: The block to instantiate.
+   * - `-name`: List of instance name patterns, see expand_name_range, e.g.
+   * {u_io_[0:1023]}.
+   * - `-parent`: (Optional) The parent block, current device if omitted.
+   * - `-io_bank`: (Optional) The IO bank of every instance.
+   * - `-logic_address`: (Optional) Logic address of the first instance.
+   * - `-address_stride`: (Optional) Address increment between consecutive
+   * instances, 0 by default.
+   * - `-logic_location`: (Optional) "X Y Z" location of the first instance.
+   * - `-location_stride`: (Optional) "DX DY DZ" location increment between
+   * consecutive instances, 0 by default.
+   *
+   * @param argc The number of command-line arguments.
+   * @param argv An array of command-line arguments.
+   * @return True if the instances were successfully created.
+   * @throws std::invalid_argument If an argument is missing or unknown.
+   * @throws std::runtime_error If the block or parent block cannot be found.
+   */
+  bool create_instances(int argc, const char **argv) {
+    if (!current_device_) {
+      throw std::runtime_error("No current device");
+    }
+    std::string block_name;
+    std::string parent;
+    std::string io_bank;
+    std::vector<std::string> names;
+    int logic_address = -1;
+    int address_stride = 0;
+    int location[3] = {-1, -1, -1};
+    int location_stride[3] = {0, 0, 0};
+    auto read_triple = [this](const std::string &value, int *triple) {
+      auto tokens = split_string_by_space(value);
+      for (size_t i = 0; i < tokens.size() && i < 3; i++) {
+        triple[i] = convert_string_to_integer(tokens[i]);
+      }
+    };
+    for (int i = 1; i < argc; i += 2) {
+      std::string arg = argv[i];
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("Missing value of " + arg +
+                                    " in create_instances");
+      }
+      std::string value = argv[i + 1];
+      if (arg == "-block") {
+        block_name = value;
+      } else if (arg == "-name") {
+        for (const auto &pattern : split_string_by_space(value)) {
+          expand_name_range(pattern, names);
+        }
+      } else if (arg == "-parent") {
+        parent = value;
+      } else if (arg == "-io_bank") {
+        io_bank = value;
+      } else if (arg == "-logic_address") {
+        logic_address = convert_string_to_integer(value);
+      } else if (arg == "-address_stride") {
+        address_stride = convert_string_to_integer(value);
+      } else if (arg == "-logic_location") {
+        read_triple(value, location);
+      } else if (arg == "-location_stride") {
+        read_triple(value, location_stride);
+      } else {
+        throw std::invalid_argument("Unknown argument " + arg +
+                                    " in create_instances");
+      }
+    }
+    if (block_name.empty()) {
+      throw std::invalid_argument("Missing necessary argument: -block");
+    }
+    if (names.empty()) {
+      throw std::invalid_argument("Missing necessary argument: -name");
+    }
+    auto block = current_device_->get_block(block_name);
+    if (!block) {
+      throw std::runtime_error("In the definition of Instance " + names[0] +
+                               ", could not find block " + block_name);
+    }
+    device_block *parent_block = parent.empty()
+                                     ? current_device_.get()
+                                     : current_device_->get_block(parent).get();
+    if (!parent_block) {
+      throw std::runtime_error("In the definition of Instance " + names[0] +
+                               ", could not find parent block " + parent);
+    }
+    // checked before any instance is created
+    std::unordered_set<std::string> unique;
+    unique.reserve(names.size());
+    for (const auto &name : names) {
+      if (!unique.insert(name).second ||
+          parent_block->instances().count(name) != 0) {
+        throw std::invalid_argument("Instance " + name +
+                                    " is defined more than once in "
+                                    "create_instances");
+      }
+    }
+    auto &instances = parent_block->instance_vector();
+    instances.reserve(instances.size() + names.size());
+    parent_block->instances().reserve(parent_block->instances().size() +
+                                      names.size());
+    // unset address and location stay unset for every instance
+    auto nth = [](int first, int stride, int n) {
+      return (first == -1) ? -1 : first + stride * n;
+    };
+    for (size_t n = 0; n < names.size(); n++) {
+      const int i = static_cast<int>(n);
+      instances.push_back(std::make_shared<device_block_instance>(
+          block, instances.size(), nth(location[0], location_stride[0], i),
+          nth(location[1], location_stride[1], i),
+          nth(logic_address, address_stride, i), names[n], io_bank,
+          nth(location[2], location_stride[2], i)));
+      parent_block->add_instance(names[n], instances.back());
+    }
+    return true;
+  }
   /**
    * @brief Maps RTL names to user names.
    *
@@ -1258,7 +1500,6 @@ class device_modeler {
    * function.
    */
   bool define_net(int argc, const char **argv) {
-    static int cnt = 0;
     if (argc < 3) {
       throw std::invalid_argument(
           "Insufficient arguments passed to define_net.");
@@ -1267,60 +1508,98 @@ class device_modeler {
     std::string driver_name = get_argument_value("-drive", argc, argv);
     std::string load_names = get_argument_value("-load", argc, argv);
     std::string net_name = get_argument_value("-name", argc, argv);
-    device_block *block = nullptr;
+    if (net_name.empty()) net_name = default_net_name();
+    device_block *block = find_net_block(block_name, net_name);
+    add_net_to_block(block, block_name, net_name, driver_name,
+                     split_string_by_space(load_names));
+    return true;
+  }
 
-    if (net_name.empty()) {
-      stringstream ss;
-      ss << cnt++;
-      net_name = "__DEFAULT__NET__NAME__" + ss.str();
+  /**
+   * @brief Define nets in a device block in one call.
+   *
+   * Bulk variant of define_net. Accepted arguments:
+   * - `-parent`: The block the nets belong to, current device if empty.
+   * - `-name`: (Optional) List of net name patterns, see expand_name_range.
+   * - `-drive`: (Optional) List of driver patterns, one driver per net or a
+   * single driver for all nets.
+   * - `-load`: (Optional) List of load patterns. A pattern expanding to one
+   * name per net gives every net its own load, a single name is a load of
+   * every net.
+   * The number of nets is given by -name or, if omitted, by -drive.
+   *
+   * @param argc Number of command line arguments.
+   * @param argv Array of command line arguments.
+   * @return True if the nets were successfully defined.
+   * @throws std::invalid_argument if arguments are missing, unknown or their
+   * counts don't match.
+   * @throws std::runtime_error if the parent block can't be found.
+   */
+  bool define_nets(int argc, const char **argv) {
+    if (!current_device_) {
+      throw std::runtime_error("No current device");
     }
-
-    if (block_name.empty()) {
-      block = current_device_.get();
-    } else {
-      block = current_device_->get_block(block_name).get();
+    std::string block_name;
+    bool has_parent = false;
+    std::vector<std::string> names;
+    std::vector<std::string> drivers;
+    std::vector<std::vector<std::string>> loads;
+    for (int i = 1; i < argc; i += 2) {
+      std::string arg = argv[i];
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("Missing value of " + arg +
+                                    " in define_nets");
+      }
+      std::string value = argv[i + 1];
+      if (arg == "-parent") {
+        block_name = value;
+        has_parent = true;
+      } else if (arg == "-name") {
+        names = expand_name_list(value);
+      } else if (arg == "-drive") {
+        drivers = expand_name_list(value);
+      } else if (arg == "-load") {
+        for (const auto &pattern : split_string_by_space(value)) {
+          loads.emplace_back();
+          expand_name_range(pattern, loads.back());
+        }
+      } else {
+        throw std::invalid_argument("Unknown argument " + arg +
+                                    " in define_nets");
+      }
     }
-
-    if (!block) {
-      throw std::runtime_error("In the definition of net " + net_name +
-                               ", could not find block " + block_name);
+    if (!has_parent) {
+      throw std::invalid_argument("Missing necessary argument: -parent");
     }
-    auto v = split_string_by_space(load_names);
-    block->add_net(std::make_shared<device_net>(net_name));
-    auto net_ptr = block->get_net(net_name);
-    if (!driver_name.empty()) {
-      std::vector<std::string> xmr_refs =
-          FOEDAG::StringUtils::tokenize(driver_name, ".", false);
-      std::shared_ptr<device_net> drv = nullptr;
-      if (xmr_refs.size() == 2) {
-        auto ins = block->get_instance(xmr_refs[0]);
-        if (ins) drv = ins->get_net(xmr_refs[1]);
-      } else {
-        drv = block->get_net(driver_name);
+    const size_t count = names.empty() ? drivers.size() : names.size();
+    if (count == 0) {
+      throw std::invalid_argument("No nets specified in define_nets");
+    }
+    auto matches = [count](size_t size) { return size == 1 || size == count; };
+    if (!drivers.empty() && !matches(drivers.size())) {
+      throw std::invalid_argument(
+          "Number of drivers doesn't match number of nets in define_nets");
+    }
+    for (const auto &load : loads) {
+      if (!matches(load.size())) {
+        throw std::invalid_argument(
+            "Number of loads doesn't match number of nets in define_nets");
       }
-      if (drv)
-        net_ptr->set_source(drv);
-      else
-        std::cout << "WANRN: The driver \"" << driver_name << "\" for net \""
-                  << net_name << "\" does not exis in block \"" << block_name
-                  << "\"" << std::endl;
     }
-    for (auto &ld_n : v) {
-      std::vector<std::string> xmr_refs =
-          FOEDAG::StringUtils::tokenize(ld_n, ".", false);
-      std::shared_ptr<device_net> load = nullptr;
-      if (xmr_refs.size() == 2) {
-        auto ins = block->get_instance(xmr_refs[0]);
-        if (ins) load = ins->get_net(xmr_refs[1]);
-      } else {
-        load = block->get_net(ld_n);
+    device_block *block = find_net_block(
+        block_name, names.empty() ? std::string{"of define_nets"} : names[0]);
+    block->nets().reserve(block->nets().size() + count);
+    std::vector<std::string> net_loads(loads.size());
+    for (size_t n = 0; n < count; n++) {
+      const std::string net_name = names.empty() ? default_net_name()
+                                                 : names[n];
+      const std::string driver =
+          drivers.empty() ? std::string{}
+                          : drivers[(drivers.size() == 1) ? 0 : n];
+      for (size_t l = 0; l < loads.size(); l++) {
+        net_loads[l] = loads[l][(loads[l].size() == 1) ? 0 : n];
       }
-      if (load)
-        net_ptr->add_sink(load);
-      else
-        std::cout << "WANRN: The load \"" << ld_n << "\" for net \"" << net_name
-                  << "\" does not exis in block \"" << block_name << "\""
-                  << std::endl;
+      add_net_to_block(block, block_name, net_name, driver, net_loads);
     }
     return true;
   }
@@ -2408,6 +2687,70 @@ class device_modeler {
     return true;
   }
 
+  /**
+   * @brief Sets the physical address of several instances in one call.
+   *
+   * Bulk variant of set_phy_address. The command-line arguments are:
+   * - `-inst`: List of hierarchical instance name patterns, see
+   * expand_name_range, e.g. {b_l1.inst_l2.u_io_[0:1023]}.
+   * - `-address`: Physical address of the first instance.
+   * - `-stride`: (Optional) Address increment between consecutive instances,
+   * 0 by default.
+   *
+   * @param argc The number of command-line arguments.
+   * @param argv An array of command-line arguments.
+   * @return True if the physical addresses were successfully set.
+   * @throws std::runtime_error if arguments are missing or an instance cannot
+   * be found.
+   */
+  bool set_phy_addresses(int argc, const char **argv) {
+    if (argc < 5) {
+      throw std::runtime_error(
+          "Need at least 5 arguments for command set_phy_addresses");
+    }
+    std::vector<std::string> names;
+    std::string phy_address;
+    int stride = 0;
+    for (int i = 1; i < argc; i += 2) {
+      std::string arg = argv[i];
+      if (i + 1 >= argc) {
+        throw std::runtime_error("Missing value of " + arg +
+                                 " in set_phy_addresses");
+      }
+      std::string value = argv[i + 1];
+      if (arg == "-inst") {
+        names = expand_name_list(value);
+      } else if (arg == "-address") {
+        phy_address = value;
+      } else if (arg == "-stride") {
+        stride = convert_string_to_integer(value);
+      } else {
+        throw std::runtime_error("Unknown argument " + arg +
+                                 " in set_phy_addresses");
+      }
+    }
+    if (names.empty()) {
+      throw std::runtime_error(
+          "Instance name needed for command set_phy_addresses");
+    }
+    if (phy_address.empty()) {
+      throw std::runtime_error(
+          "Physical address needed for command set_phy_addresses");
+    }
+    int addr_i = convert_string_to_integer(phy_address);
+    auto instances = find_instances_from_hierarchical_names(names);
+    for (size_t n = 0; n < instances.size(); n++) {
+      if (!instances[n]) {
+        throw std::runtime_error("Could not find instance " + names[n]);
+      }
+    }
+    for (auto *inst : instances) {
+      inst->set_phy_address(addr_i);
+      addr_i += stride;
+    }
+    return true;
+  }
+
   /**
    * @brief Retrieves the logical address of a specified instance.
    *
@@ -2763,6 +3106,63 @@ class device_modeler {
     return inst;
   }
 
+  /**
+   * Finds device block instances from their hierarchical names.
+   *
+   * Same as find_instance_from_hierarchical_name for every name, but the
+   * parent of consecutive names sharing it (e.g. expanded from one range) is
+   * resolved once.
+   *
+   * @param instance_names The hierarchical names of the instances.
+   * @return Pointers to the found instances in the order of the names,
+   * nullptr for names not found.
+   */
+  std::vector<device_block_instance *> find_instances_from_hierarchical_names(
+      const std::vector<std::string> &instance_names) {
+    std::vector<device_block_instance *> result;
+    result.reserve(instance_names.size());
+    std::string parent_name;
+    device_block *parent_block = nullptr;
+    device_block_instance *parent_inst = nullptr;
+    bool resolved = false;
+    for (const auto &name : instance_names) {
+      size_t dot = name.rfind('.');
+      if (dot == std::string::npos) {
+        result.push_back(find_instance_from_hierarchical_name(name));
+        continue;
+      }
+      std::string parent = name.substr(0, dot);
+      std::string leaf = name.substr(dot + 1);
+      if (!resolved || parent != parent_name) {
+        parent_name = parent;
+        resolved = true;
+        parent_block = nullptr;
+        parent_inst = nullptr;
+        if (parent.find('.') != std::string::npos) {
+          parent_inst = find_instance_from_hierarchical_name(parent);
+        } else if (parent == current_device_->device_name()) {
+          parent_block = current_device_.get();
+        } else {
+          parent_block = get_device(parent).get();
+          if (!parent_block) {
+            parent_block = current_device_->get_block(parent, false).get();
+          }
+          if (!parent_block) {
+            parent_inst = current_device_->get_instance(parent).get();
+          }
+        }
+      }
+      device_block_instance *inst = nullptr;
+      if (parent_block) {
+        inst = parent_block->get_instance(leaf).get();
+      } else if (parent_inst) {
+        inst = parent_inst->findInstanceByName(leaf).get();
+      }
+      result.push_back(inst);
+    }
+    return result;
+  }
+
   /**
    * @brief Creates an instance chain based on command-line arguments.
    *
@@ -2905,7 +3305,137 @@ class device_modeler {
     return true;
   }
 
+  /**
+   * @brief Appends several instances to an existing chain in one call.
+   *
+   * Bulk variant of append_instance_to_chain, `-instance` takes a list of
+   * hierarchical instance name patterns (see expand_name_range) appended in
+   * list order. Nothing is appended if one of the instances is not found.
+   *
+   * @param argc The number of command-line arguments.
+   * @param argv The array of command-line argument strings.
+   * @return true if the instances are successfully appended to the chain.
+   * @throws std::runtime_error if arguments are missing or unknown, or if the
+   * specified device, block, or instance is not found.
+   */
+  bool append_instances_to_chain(int argc, const char **argv) {
+    if (argc < 5) {
+      throw std::runtime_error(
+          "Need at least 4 arguments for command append_instances_to_chain");
+    }
+    std::string chain_name;
+    std::string block_name;
+    std::string device_name;
+    std::vector<std::string> names;
+    for (int i = 1; i < argc; i += 2) {
+      std::string arg = argv[i];
+      if (i + 1 >= argc) {
+        throw std::runtime_error("Missing value of " + arg +
+                                 " in append_instances_to_chain");
+      }
+      std::string value = argv[i + 1];
+      if (arg == "-chain") {
+        chain_name = value;
+      } else if (arg == "-block") {
+        block_name = value;
+      } else if (arg == "-instance") {
+        names = expand_name_list(value);
+      } else if (arg == "-device") {
+        device_name = value;
+      } else {
+        throw std::runtime_error("Unknown argument " + arg +
+                                 " in append_instances_to_chain");
+      }
+    }
+    if (chain_name.empty()) {
+      throw std::runtime_error(
+          "No chain specified in the command append_instances_to_chain");
+    }
+    device_block *device = device_name.empty()
+                               ? current_device_.get()
+                               : get_device(device_name).get();
+    if (!device) {
+      throw std::runtime_error(
+          "No device found in the command append_instances_to_chain");
+    }
+    device_block *block = nullptr;
+    if (!block_name.empty()) {
+      block = device->get_block(block_name).get();
+    }
+    if (!block) {
+      block = device;
+    }
+    auto instances = find_instances_from_hierarchical_names(names);
+    for (size_t n = 0; n < instances.size(); n++) {
+      if (!instances[n]) {
+        throw std::runtime_error("No instance " + names[n] +
+                                 " found in the command "
+                                 "append_instances_to_chain");
+      }
+    }
+    auto &chain = block->get_chains()[chain_name];
+    chain.reserve(chain.size() + names.size());
+    chain.insert(chain.end(), names.begin(), names.end());
+    return true;
+  }
+
  private:
+  std::string default_net_name() {
+    static int cnt = 0;
+    return "__DEFAULT__NET__NAME__" + std::to_string(cnt++);
+  }
+
+  device_block *find_net_block(const std::string &block_name,
+                               const std::string &net_name) {
+    device_block *block = block_name.empty()
+                              ? current_device_.get()
+                              : current_device_->get_block(block_name).get();
+    if (!block) {
+      throw std::runtime_error("In the definition of net " + net_name +
+                               ", could not find block " + block_name);
+    }
+    return block;
+  }
+
+  // creates net in block and connects driver and loads, a driver or a load
+  // is a net of the block or "instance.net" of its instance
+  void add_net_to_block(device_block *block, const std::string &block_name,
+                        const std::string &net_name,
+                        const std::string &driver_name,
+                        const std::vector<std::string> &load_names) {
+    auto net_ptr = std::make_shared<device_net>(net_name);
+    block->add_net(net_ptr);
+    auto find_net = [block](const std::string &name) {
+      std::shared_ptr<device_net> net = nullptr;
+      size_t dot = name.find('.');
+      if (dot != std::string::npos && name.find('.', dot + 1) == name.npos) {
+        auto ins = block->get_instance(name.substr(0, dot));
+        if (ins) net = ins->get_net(name.substr(dot + 1));
+      } else {
+        net = block->get_net(name);
+      }
+      return net;
+    };
+    if (!driver_name.empty()) {
+      auto drv = find_net(driver_name);
+      if (drv)
+        net_ptr->set_source(drv);
+      else
+        std::cout << "WARNING: The driver \"" << driver_name << "\" for net \""
+                  << net_name << "\" does not exist in block \"" << block_name
+                  << "\"" << std::endl;
+    }
+    for (auto &ld_n : load_names) {
+      auto load = find_net(ld_n);
+      if (load)
+        net_ptr->add_sink(load);
+      else
+        std::cout << "WARNING: The load \"" << ld_n << "\" for net \""
+                  << net_name << "\" does not exist in block \"" << block_name
+                  << "\"" << std::endl;
+    }
+  }
+
   int convert_string_to_integer(const std::string &str) {
     int value = 0;
     try {
@@ -26,17 +26,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QDebug>
 #include <QProcess>
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <filesystem>
+#include <map>
+#include <mutex>
 #include <regex>
 #include <sstream>
 #include <thread>
 
 #include "Compiler/Log.h"
 #include "Compiler/WorkerThread.h"
+#include "IPGenerate/IPCatalogIndex.h"
 #include "MainWindow/Session.h"
 #include "Utils/FileUtils.h"
+#include "Utils/JobPool.h"
 #include "Utils/StringUtils.h"
 #include "nlohmann_json/json.hpp"
 
@@ -63,18 +68,21 @@ void buildMockUpIPDef(IPCatalog* catalog) {
   // catalog->WriteCatalog(std::cout);
 }
 
+IPCatalogBuilder::IPCatalogBuilder(Compiler* compiler)
+    : m_compiler(compiler), m_indexFile(IPCatalogIndex::DefaultFile()) {}
+
 bool IPCatalogBuilder::buildLiteXCatalog(
     IPCatalog* catalog, const std::filesystem::path& litexIPgenPath,
     bool namesOnly) {
   bool result = true;
   if (FileUtils::FileExists(litexIPgenPath)) {
-    int foundCount = 0;
     std::filesystem::path execPath = litexIPgenPath;
     if (!std::filesystem::is_directory(execPath)) {
       execPath = execPath.parent_path();
     }
     m_compiler->Message("IP Catalog, browsing directory for IP generator(s): " +
                         execPath.string());
+    std::vector<std::filesystem::path> generators;
     for (const std::filesystem::path& entry :
          std::filesystem::recursive_directory_iterator(
              execPath,
@@ -82,16 +90,19 @@ bool IPCatalogBuilder::buildLiteXCatalog(
       const std::string& exec_name = entry.string();
       if (exec_name.find("__init__.py") != std::string::npos) continue;
       if (exec_name.find("_gen.py") != std::string::npos) {
-        foundCount++;
-        bool res = namesOnly ? buildLiteXIPFromGeneratorInternal(catalog, entry)
-                             : buildLiteXIPFromGenerator(catalog, entry);
-        if (res == false) {
+        generators.push_back(entry);
+      }
+    }
+    if (namesOnly) {
+      for (const auto& generator : generators) {
+        if (!buildLiteXIPFromGeneratorInternal(catalog, generator))
           result = false;
-        }
       }
+    } else if (!generators.empty()) {
+      result = buildLiteXIPsFromGenerators(catalog, execPath, generators);
     }
-    std::string msg =
-        std::string("IP Catalog, found ") + std::to_string(foundCount) + " IPs";
+    std::string msg = std::string("IP Catalog, found ") +
+                      std::to_string(generators.size()) + " IPs";
     m_compiler->Message(msg);
   } else {
     result = false;
@@ -101,6 +112,99 @@ bool IPCatalogBuilder::buildLiteXCatalog(
   return result;
 }
 
+// Version of the interpreter is part of the index key since generators
+// import litex, json template may change with the environment. Memoized by
+// interpreter path and modification time.
+static std::string interpreterVersion(const std::filesystem::path& python) {
+  static std::mutex lock;
+  static std::map<std::string, std::string> versions;
+  const std::string key =
+      python.string() + ":" + std::to_string(FileUtils::Mtime(python));
+  std::scoped_lock guard{lock};
+  auto it = versions.find(key);
+  if (it != versions.end()) return it->second;
+  std::ostringstream output;
+  FileUtils::ExecuteSystemCommand(python.string(), {"--version"}, &output);
+  return versions[key] = key + ":" + output.str();
+}
+
+static int probeGenerator(const std::filesystem::path& python,
+                          const std::filesystem::path& generator,
+                          std::string& output) {
+  std::ostringstream help;
+  StringVector args{generator.string(), "--json-template"};
+  const int code =
+      FileUtils::ExecuteSystemCommand(python.string(), args, &help).code;
+  output = help.str();
+  return code;
+}
+
+bool IPCatalogBuilder::buildLiteXIPsFromGenerators(
+    IPCatalog* catalog, const std::filesystem::path& root,
+    const std::vector<std::filesystem::path>& generators) {
+  // generator template comes from the index or from a probe, the catalog is
+  // filled afterwards in generator order, so it doesn't depend on the order
+  // the probes finish in
+  struct Template {
+    std::filesystem::path generator;
+    std::string hash;
+    bool indexed{false};
+    int code{0};
+    std::string json;
+  };
+  bool result = true;
+  const std::filesystem::path pythonPath = findPythonPath();
+  const std::string interpreter = interpreterVersion(pythonPath);
+  IPCatalogIndex index{m_indexFile};
+  index.Load();
+  index.Prune(FileUtils::GetFullPath(root));
+
+  std::vector<Template> templates;
+  std::vector<size_t> probes;
+  for (const auto& generator : generators) {
+    const std::filesystem::path fullPath = FileUtils::GetFullPath(generator);
+    Template entry{generator, FileUtils::FileHash(fullPath)};
+    if (auto json = index.Lookup(fullPath, entry.hash, interpreter)) {
+      entry.indexed = true;
+      entry.json = *json;
+    } else {
+      probes.push_back(templates.size());
+    }
+    templates.push_back(entry);
+  }
+
+  if (!probes.empty()) {
+    if (probes.size() > 1)
+      m_compiler->Message("IP Catalog, probing " +
+                          std::to_string(probes.size()) +
+                          " new or modified IP generator(s)");
+    JobPool pool{m_jobs};
+    pool.Run(probes.size(), [&templates, &probes, &pythonPath](size_t i) {
+      Template& entry = templates.at(probes.at(i));
+      entry.code = probeGenerator(pythonPath, entry.generator, entry.json);
+    });
+  }
+
+  // catalog and messages are not thread safe, filled from this thread only
+  for (const Template& entry : templates) {
+    const std::string command = pythonPath.string() + " " +
+                                entry.generator.string() + " --json-template";
+    if (entry.code) {
+      m_compiler->ErrorMessage("IP Catalog, no IP information for " +
+                               entry.generator.string() + "\n" + entry.json);
+      result = false;
+    } else if (!buildLiteXIPFromJson(catalog, entry.generator, entry.json,
+                                     command)) {
+      result = false;
+    } else if (!entry.indexed && !entry.hash.empty()) {
+      index.Update(FileUtils::GetFullPath(entry.generator),
+                   {entry.hash, interpreter, entry.json});
+    }
+  }
+  index.Save();
+  return result;
+}
+
 static std::string& rtrim(std::string& str, char c) {
   auto it1 = std::find_if(str.rbegin(), str.rend(),
                           [c](char ch) { return (ch == c); });
@@ -131,8 +235,7 @@ std::vector<std::string> JsonArrayToStringVector(
   return vals;
 }
 
-bool IPCatalogBuilder::buildLiteXIPFromGenerator(
-    IPCatalog* catalog, const std::filesystem::path& pythonConverterScript) {
+std::filesystem::path IPCatalogBuilder::findPythonPath() {
   // Find path to litex enabled python interpreter
   std::filesystem::path pythonPath = IPCatalog::getPythonPath();
   if (pythonPath.empty()) {
@@ -156,20 +259,14 @@ bool IPCatalogBuilder::buildLiteXIPFromGenerator(
           "interpreter.\n");
     }
   }
+  return pythonPath;
+}
 
-  std::ostringstream help;
-  std::string command = pythonPath.string() + " " +
-                        pythonConverterScript.string() + " --json-template";
-  StringVector args{pythonConverterScript.string(), "--json-template"};
-  if (FileUtils::ExecuteSystemCommand(pythonPath.string(), args, &help).code) {
-    m_compiler->ErrorMessage("IP Catalog, no IP information for " +
-                             pythonConverterScript.string() + "\n" +
-                             help.str());
-    return false;
-  }
-
-  return buildLiteXIPFromJson(catalog, pythonConverterScript, help.str(),
-                              command);
+bool IPCatalogBuilder::buildLiteXIPFromGenerator(
+    IPCatalog* catalog, const std::filesystem::path& pythonConverterScript) {
+  return buildLiteXIPsFromGenerators(catalog,
+                                     pythonConverterScript.parent_path(),
+                                     {pythonConverterScript});
 }
 
 bool IPCatalogBuilder::buildLiteXIPFromJson(
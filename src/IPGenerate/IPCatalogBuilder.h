@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef IPCATALOGBUILDER_H
 #define IPCATALOGBUILDER_H
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -34,7 +35,7 @@ class Compiler;
 
 class IPCatalogBuilder {
  public:
-  IPCatalogBuilder(Compiler* compiler) : m_compiler(compiler) {}
+  IPCatalogBuilder(Compiler* compiler);
   bool buildLiteXCatalog(IPCatalog* catalog,
                          const std::filesystem::path& litexIPgenPath,
                          bool namesOnly = false);
@@ -49,10 +50,24 @@ class IPCatalogBuilder {
                             const std::string& jsonStr,
                             const std::string& command = std::string{});
 
+  // number of generators probed in parallel, 0 means number of cores
+  void Jobs(uint32_t jobs) { m_jobs = jobs; }
+  uint32_t Jobs() const { return m_jobs; }
+
+  // index of generator json templates, empty path disables the index
+  void IndexFile(const std::filesystem::path& file) { m_indexFile = file; }
+  const std::filesystem::path& IndexFile() const { return m_indexFile; }
+
  protected:
   bool buildLiteXIPFromGeneratorInternal(
       IPCatalog* catalog, const std::filesystem::path& pythonConverterScript);
+  bool buildLiteXIPsFromGenerators(
+      IPCatalog* catalog, const std::filesystem::path& root,
+      const std::vector<std::filesystem::path>& generators);
+  std::filesystem::path findPythonPath();
   Compiler* m_compiler = nullptr;
+  uint32_t m_jobs{0};
+  std::filesystem::path m_indexFile;
 };
 
 }  // namespace FOEDAG
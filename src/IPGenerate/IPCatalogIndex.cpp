@@ -0,0 +1,145 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "IPCatalogIndex.h"
+
+#include <QLockFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <fstream>
+
+#include "Utils/FileUtils.h"
+#include "Utils/StringUtils.h"
+#include "nlohmann_json/json.hpp"
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+// increment when index layout changes
+static constexpr int IndexVersion{1};
+
+IPCatalogIndex::IPCatalogIndex() : m_file(DefaultFile()) {}
+
+IPCatalogIndex::IPCatalogIndex(const fs::path& file) : m_file(file) {}
+
+static bool readIndex(const fs::path& file,
+                      std::map<std::string, IPCatalogIndex::Entry>& entries) {
+  entries.clear();
+  if (file.empty()) return false;
+  std::ifstream stream{file};
+  if (!stream.good()) return false;
+  try {
+    json index = json::parse(stream);
+    if (index.value("version", 0) != IndexVersion) return false;
+    for (const auto& [generator, value] :
+         index.value("entries", json::object()).items()) {
+      entries[generator] = {value.value("hash", std::string{}),
+                            value.value("interpreter", std::string{}),
+                            value.value("json", std::string{})};
+    }
+  } catch (json::exception&) {
+    entries.clear();
+    return false;
+  }
+  return true;
+}
+
+bool IPCatalogIndex::Load() {
+  m_changes.clear();
+  return readIndex(m_file, m_entries);
+}
+
+bool IPCatalogIndex::Save() {
+  if (m_changes.empty()) return true;
+  if (m_file.empty() || !FileUtils::MkDirs(m_file.parent_path())) return false;
+  // sessions loading the catalog at the same time merge their changes into
+  // the latest file one after another, lock is released when stale
+  QLockFile lock{QString::fromStdString(m_file.string() + ".lock")};
+  if (!lock.lock()) return false;
+  std::map<std::string, Entry> entries;
+  readIndex(m_file, entries);
+  for (const auto& [generator, entry] : m_changes) {
+    if (entry)
+      entries[generator] = *entry;
+    else
+      entries.erase(generator);
+  }
+  json content = json::object();
+  for (const auto& [generator, entry] : entries) {
+    content[generator] = {{"hash", entry.hash},
+                          {"interpreter", entry.interpreter},
+                          {"json", entry.json}};
+  }
+  const json index{{"version", IndexVersion}, {"entries", content}};
+  // QSaveFile writes into temporary file and renames it on commit, so
+  // sessions loading the index never see partially written one
+  QSaveFile file{QString::fromStdString(m_file.string())};
+  if (!file.open(QFile::WriteOnly)) return false;
+  file.write(QByteArray::fromStdString(index.dump()));
+  if (!file.commit()) return false;
+  m_entries = std::move(entries);
+  m_changes.clear();
+  return true;
+}
+
+const std::string* IPCatalogIndex::Lookup(
+    const fs::path& generator, const std::string& hash,
+    const std::string& interpreter) const {
+  auto it = m_entries.find(generator.string());
+  if (it == m_entries.end()) return nullptr;
+  const Entry& entry = it->second;
+  if (hash.empty() || entry.hash != hash || entry.interpreter != interpreter)
+    return nullptr;
+  return &entry.json;
+}
+
+void IPCatalogIndex::Update(const fs::path& generator, const Entry& entry) {
+  m_entries[generator.string()] = entry;
+  m_changes[generator.string()] = entry;
+}
+
+size_t IPCatalogIndex::Prune(const fs::path& root) {
+  const std::string prefix = root.string();
+  size_t removed{0};
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (StringUtils::startsWith(it->first, prefix) &&
+        !FileUtils::FileExists(it->first)) {
+      m_changes[it->first] = std::nullopt;
+      it = m_entries.erase(it);
+      removed++;
+    } else {
+      ++it;
+    }
+  }
+  return removed;
+}
+
+fs::path IPCatalogIndex::DefaultFile() {
+  if (const char* file = std::getenv("FOEDAG_IP_CATALOG_INDEX")) return file;
+  const QString cache =
+      QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+  if (cache.isEmpty())
+    return fs::temp_directory_path() / "foedag" / "ip_catalog_index.json";
+  return fs::path{cache.toStdString()} / "foedag" / "ip_catalog_index.json";
+}
+
+}  // namespace FOEDAG
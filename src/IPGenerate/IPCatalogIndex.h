@@ -0,0 +1,95 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The IPCatalogIndex class
+ * Persistent index of IP generator json templates. Entries are keyed by
+ * generator path and hold the generator content hash and the interpreter
+ * version the template was produced with, so catalog loading only has to run
+ * '<generator> --json-template' for new or changed generators.
+ */
+class IPCatalogIndex {
+ public:
+  struct Entry {
+    std::string hash;
+    std::string interpreter;
+    std::string json;
+  };
+
+  IPCatalogIndex();
+  explicit IPCatalogIndex(const std::filesystem::path& file);
+
+  const std::filesystem::path& File() const { return m_file; }
+
+  /*!
+   * \brief Load
+   * Read index file. Missing, corrupted or outdated file results in empty
+   * index.
+   */
+  bool Load();
+
+  /*!
+   * \brief Save
+   * Merge entries updated or pruned since Load() into the index file and
+   * write it atomically. Other sessions saving the same file are serialized
+   * by a lock file, so their entries are kept. Does nothing if index was not
+   * modified.
+   */
+  bool Save();
+
+  /*!
+   * \brief Lookup
+   * \return json template of \a generator or nullptr if generator is unknown
+   * or its \a hash or \a interpreter differs from the indexed one.
+   */
+  const std::string* Lookup(const std::filesystem::path& generator,
+                            const std::string& hash,
+                            const std::string& interpreter) const;
+
+  void Update(const std::filesystem::path& generator, const Entry& entry);
+
+  /*!
+   * \brief Prune
+   * Remove entries of generators located in \a root that don't exist anymore.
+   * \return number of removed entries.
+   */
+  size_t Prune(const std::filesystem::path& root);
+
+  size_t Size() const { return m_entries.size(); }
+
+  static std::filesystem::path DefaultFile();
+
+ private:
+  std::filesystem::path m_file;
+  std::map<std::string, Entry> m_entries;
+  // entries updated since Load(), nullopt for removed ones
+  std::map<std::string, std::optional<Entry>> m_changes;
+};
+
+}  // namespace FOEDAG
@@ -24,11 +24,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QProcess>
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <filesystem>
+#include <functional>
+#include <map>
 #include <queue>
 #include <sstream>
 #include <thread>
@@ -40,6 +44,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "MainWindow/Session.h"
 #include "NewProject/ProjectManager/project_manager.h"
 #include "Utils/FileUtils.h"
+#include "Utils/JobPool.h"
 #include "Utils/StringUtils.h"
 
 extern FOEDAG::Session* GlobalSession;
@@ -47,6 +52,11 @@ using namespace FOEDAG;
 using Time = std::chrono::high_resolution_clock;
 using ms = std::chrono::milliseconds;
 
+std::vector<std::string> IPGenerator::CommandNames() {
+  return {"add_litex_ip_catalog", "ip_catalog", "configure_ip", "remove_ip",
+          "delete_ip", "simulate_ip"};
+}
+
 bool IPGenerator::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   auto add_litex_ip_catalog = [](void* clientData, Tcl_Interp* interp, int argc,
                                  const char* argv[]) -> int {
@@ -425,6 +435,50 @@ void IPGenerator::DeleteIPInstance(const std::string& moduleName) {
   DeleteIPInstance(GetIPInstance(moduleName));
 }
 
+struct IPBuildJob {
+  IPInstance* instance{nullptr};
+  std::filesystem::path buildDir;
+  std::filesystem::path json;
+  std::filesystem::path log;
+  std::filesystem::path hashFile;
+  std::string hash;
+  int code{0};
+  std::string output;
+};
+
+// Generator writes the whole build directory, instances sharing it depend on
+// each other and are generated one after another. All other instances are
+// generated in parallel, at most 'jobs' at a time.
+static void buildIPs(std::vector<IPBuildJob>& jobs,
+                     const std::filesystem::path& pythonPath, uint32_t threads,
+                     const std::function<void(const IPBuildJob&)>& finished) {
+  std::map<std::filesystem::path, std::vector<size_t>> groupMap;
+  for (size_t i = 0; i < jobs.size(); i++)
+    groupMap[jobs.at(i).buildDir].push_back(i);
+  JobPool::Groups groups;
+  for (auto& [dir, group] : groupMap) groups.push_back(std::move(group));
+
+  JobPool pool{threads};
+  pool.Run(
+      groups,
+      [&jobs, &pythonPath](size_t index) {
+        IPBuildJob& job = jobs.at(index);
+        StringVector args{job.instance->Definition()->FilePath().string(),
+                          "--build", "--json",
+                          FileUtils::GetFullPath(job.json).string()};
+        std::ostringstream output;
+        job.code =
+            FileUtils::ExecuteSystemCommand(pythonPath.string(), args, &output)
+                .code;
+        job.output = output.str();
+        FileUtils::WriteToFile(job.log, job.output, false);
+        if (job.code == 0)
+          FileUtils::WriteToFile(job.hashFile, job.hash, false);
+      },
+      // report from calling thread, messages are not thread safe
+      [&jobs, &finished](size_t index) { finished(jobs.at(index)); });
+}
+
 bool IPGenerator::Generate() {
   bool status = true;
   Compiler* compiler = GetCompiler();
@@ -445,6 +499,8 @@ bool IPGenerator::Generate() {
     instances = m_instances;
   }
 
+  std::vector<IPBuildJob> jobs;
+  std::filesystem::path pythonPath;
   for (IPInstance* inst : instances) {
     // Create output directory
     const std::filesystem::path& out_path = inst->OutputFile();
@@ -458,113 +514,133 @@ bool IPGenerator::Generate() {
         break;
       }
       case IPDefinition::IPType::LiteXGenerator: {
-        const std::filesystem::path executable = def->FilePath();
-        std::filesystem::path jsonFile = GetCachePath(inst);
-        std::stringstream previousbuffer;
-        if (FileUtils::FileExists(jsonFile)) {
-          std::ifstream previous(jsonFile);
-          std::stringstream buffer;
-          previousbuffer << previous.rdbuf();
-        }
-
-        // Create directory path if it doesn't exist otherwise the following
-        // ofstream command will fail
-        FileUtils::MkDirs(jsonFile.parent_path());
-        std::ofstream jsonF(jsonFile);
-        jsonF << "{" << std::endl;
-        for (const auto& param : inst->Parameters()) {
-          std::string value;
-          // The configure_ip command loses type info because we go from full
-          // json meta data provided by the ip_catalog generators to a single
-          // -Pname=val argument in a tcl command line. As such, we'll use the
-          // ip catalog's definition for parameter type info
-          auto catalogParam = GetCatalogParam(inst, param.Name());
-          if (catalogParam) {
-            switch (catalogParam->GetType()) {
-              case Value::Type::ParamIpVal: {
-                value = param.GetSValue();
-                auto type = ((IPParameter*)catalogParam)->GetParamType();
-                if (type == IPParameter::ParamType::FilePath ||
-                    type == IPParameter::ParamType::String) {
-                  value = "\"" + value + "\"";
-                }
-                break;
-              }
-              case Value::Type::ParamString:
-                value = param.GetSValue();
-                value = "\"" + value + "\"";
-                break;
-              case Value::Type::ParamInt:
-                value = param.GetSValue();
-                break;
-              case Value::Type::ConstInt:
-                value = param.GetSValue();
+        if (pythonPath.empty()) {
+          // Find path to litex enabled python interpreter
+          pythonPath = IPCatalog::getPythonPath();
+          if (pythonPath.empty()) {
+            std::filesystem::path python3Path =
+                FileUtils::LocateExecFile("python3");
+            if (python3Path.empty()) {
+              m_compiler->ErrorMessage(
+                  "IP Generate, unable to find python interpreter in local "
+                  "environment.\n");
+              return false;
+            } else {
+              pythonPath = python3Path;
+              m_compiler->ErrorMessage(
+                  "IP Generate, unable to find python interpreter in local "
+                  "environment, using system copy '" +
+                  python3Path.string() +
+                  "'. Some IP Catalog features might not work with this "
+                  "interpreter.\n");
             }
           }
-          jsonF << "   \"" << param.Name() << "\": " << value << ","
-                << std::endl;
         }
-        jsonF << "   \"build_dir\": " << inst->OutputFile().parent_path() << ","
-              << std::endl;
-        jsonF << "   \"build_name\": " << inst->OutputFile().filename() << ","
-              << std::endl;
-        jsonF << "   \"build\": true," << std::endl;
-        jsonF << "   \"json\": \"" << jsonFile.filename().string() << "\","
-              << std::endl;
-        jsonF << "   \"json_template\": false" << std::endl;
-        jsonF << "}" << std::endl;
-        jsonF.close();
-        std::stringstream newbuffer;
-        if (FileUtils::FileExists(jsonFile)) {
-          std::ifstream newfile(jsonFile);
-          std::stringstream buffer;
-          newbuffer << newfile.rdbuf();
-        }
-        if (newbuffer.str() == previousbuffer.str()) {
+
+        IPBuildJob job;
+        job.instance = inst;
+        job.buildDir = GetBuildDir(inst);
+        job.json = GetCachePath(inst);
+        job.log = GetLogPath(inst);
+        job.hashFile = GetHashPath(inst);
+        const std::string json = LiteXJson(inst, job.json);
+        // generated IP depends on parameters, generator and interpreter
+        QCryptographicHash hash{QCryptographicHash::Sha1};
+        hash.addData(QByteArray::fromStdString(json));
+        hash.addData(QByteArray::fromStdString(
+            FileUtils::FileHash(def->FilePath())));
+        hash.addData(QByteArray::fromStdString(
+            pythonPath.string() + ":" +
+            std::to_string(FileUtils::Mtime(pythonPath))));
+        job.hash = hash.result().toHex().toStdString();
+
+        if (FileUtils::FileExists(job.json) &&
+            FileUtils::GetFileContent(job.hashFile) == job.hash) {
           m_compiler->Message("IP Generate, reusing IP " +
-                              GetBuildDir(inst).string());
+                              job.buildDir.string());
           continue;
         }
 
-        // Find path to litex enabled python interpreter
-        std::filesystem::path pythonPath = IPCatalog::getPythonPath();
-        if (pythonPath.empty()) {
-          std::filesystem::path python3Path =
-              FileUtils::LocateExecFile("python3");
-          if (python3Path.empty()) {
-            m_compiler->ErrorMessage(
-                "IP Generate, unable to find python interpreter in local "
-                "environment.\n");
-            return false;
-          } else {
-            pythonPath = python3Path;
-            m_compiler->ErrorMessage(
-                "IP Generate, unable to find python interpreter in local "
-                "environment, using system copy '" +
-                python3Path.string() +
-                "'. Some IP Catalog features might not work with this "
-                "interpreter.\n");
-          }
-        }
-
-        StringVector args{executable.string(), "--build", "--json",
-                          FileUtils::GetFullPath(jsonFile).string()};
-        std::ostringstream help;
+        // Create directory path if it doesn't exist otherwise writing the
+        // json will fail
+        FileUtils::MkDirs(job.json.parent_path());
+        FileUtils::removeFile(job.hashFile);
+        FileUtils::WriteToFile(job.json, json, false);
         m_compiler->Message("IP Generate, generating IP " +
-                            GetBuildDir(inst).string());
-        if (FileUtils::ExecuteSystemCommand(pythonPath.string(), args, &help)
-                .code) {
-          m_compiler->ErrorMessage("IP Generate, " + help.str());
-          return false;
-        }
-
+                            job.buildDir.string());
+        jobs.push_back(job);
         break;
       }
     }
   }
+  if (jobs.empty()) return status;
+
+  size_t count{0};
+  buildIPs(jobs, pythonPath, m_jobs,
+           [this, &count, &status, &jobs](const IPBuildJob& job) {
+             const std::string progress = " [" + std::to_string(++count) +
+                                          "/" + std::to_string(jobs.size()) +
+                                          "]";
+             if (job.code == 0) {
+               m_compiler->Message("IP Generate, generated IP " +
+                                   job.buildDir.string() + progress);
+             } else {
+               m_compiler->ErrorMessage("IP Generate, " + job.output +
+                                        "\nSee log " + job.log.string() +
+                                        progress);
+               status = false;
+             }
+           });
   return status;
 }
 
+std::string IPGenerator::LiteXJson(IPInstance* inst,
+                                   const std::filesystem::path& jsonFile) {
+  std::ostringstream json;
+  json << "{" << std::endl;
+  for (const auto& param : inst->Parameters()) {
+    std::string value;
+    // The configure_ip command loses type info because we go from full
+    // json meta data provided by the ip_catalog generators to a single
+    // -Pname=val argument in a tcl command line. As such, we'll use the
+    // ip catalog's definition for parameter type info
+    auto catalogParam = GetCatalogParam(inst, param.Name());
+    if (catalogParam) {
+      switch (catalogParam->GetType()) {
+        case Value::Type::ParamIpVal: {
+          value = param.GetSValue();
+          auto type = ((IPParameter*)catalogParam)->GetParamType();
+          if (type == IPParameter::ParamType::FilePath ||
+              type == IPParameter::ParamType::String) {
+            value = "\"" + value + "\"";
+          }
+          break;
+        }
+        case Value::Type::ParamString:
+          value = param.GetSValue();
+          value = "\"" + value + "\"";
+          break;
+        case Value::Type::ParamInt:
+          value = param.GetSValue();
+          break;
+        case Value::Type::ConstInt:
+          value = param.GetSValue();
+      }
+    }
+    json << "   \"" << param.Name() << "\": " << value << "," << std::endl;
+  }
+  json << "   \"build_dir\": " << inst->OutputFile().parent_path() << ","
+       << std::endl;
+  json << "   \"build_name\": " << inst->OutputFile().filename() << ","
+       << std::endl;
+  json << "   \"build\": true," << std::endl;
+  json << "   \"json\": \"" << jsonFile.filename().string() << "\","
+       << std::endl;
+  json << "   \"json_template\": false" << std::endl;
+  json << "}" << std::endl;
+  return json.str();
+}
+
 std::pair<bool, std::string> IPGenerator::IsSimulateIpSupported(
     const std::string& name) const {
   auto it =
@@ -698,6 +774,20 @@ std::filesystem::path IPGenerator::GetTmpCachePath(IPInstance* instance) const {
   return dir;
 }
 
+// Generator output of the last build of this instance
+std::filesystem::path IPGenerator::GetLogPath(IPInstance* instance) const {
+  auto buildDir = GetBuildDir(instance);
+  if (!buildDir.empty()) return buildDir / "ipgenerate.log";
+  return {};
+}
+
+// Hash of the configuration this instance was successfully built with
+std::filesystem::path IPGenerator::GetHashPath(IPInstance* instance) const {
+  auto path = GetCachePath(instance);
+  if (!path.empty()) path.replace_extension(".sha1");
+  return path;
+}
+
 std::filesystem::path IPGenerator::GetTmpPath() const {
   auto projectIPsPath = GetProjectIPsPath();
   if (!projectIPsPath.empty()) return projectIPsPath / ".tmp";
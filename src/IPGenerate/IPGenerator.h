@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef IPGENERATOR_H
 #define IPGENERATOR_H
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -44,6 +45,8 @@ class IPGenerator {
   IPCatalog* Catalog() { return m_catalog; }
   Compiler* GetCompiler() { return m_compiler; }
   bool RegisterCommands(TclInterpreter* interp, bool batchMode);
+  // names of the commands RegisterCommands() creates
+  static std::vector<std::string> CommandNames();
   std::vector<IPInstance*> IPInstances() { return m_instances; }
   bool AddIPInstance(IPInstance* instance);
   IPInstance* GetIPInstance(const std::string& moduleName);
@@ -57,6 +60,9 @@ class IPGenerator {
     m_instances.erase(m_instances.begin(), m_instances.end());
   }
   bool Generate();
+  // number of IPs generated in parallel, 0 means number of hardware threads
+  void Jobs(uint32_t jobs) { m_jobs = jobs; }
+  uint32_t Jobs() const { return m_jobs; }
   std::pair<bool, std::string> IsSimulateIpSupported(
       const std::string& name) const;
   void SimulateIp(const std::string& name);
@@ -67,6 +73,8 @@ class IPGenerator {
   std::filesystem::path GetCachePath(IPInstance* instance) const;
   std::filesystem::path GetTmpCachePath(IPInstance* instance) const;
   std::filesystem::path GetTmpPath() const;
+  std::filesystem::path GetLogPath(IPInstance* instance) const;
+  std::filesystem::path GetHashPath(IPInstance* instance) const;
   std::filesystem::path GetProjectIPsPath() const;
   std::filesystem::path GetMetaPath(const std::filesystem::path& base,
                                     IPInstance* inst) const;
@@ -77,11 +85,14 @@ class IPGenerator {
 
  protected:
   std::pair<bool, std::string> SimulateIpTcl(const std::string& name);
+  std::string LiteXJson(IPInstance* inst,
+                        const std::filesystem::path& jsonFile);
 
  protected:
   IPCatalog* m_catalog = nullptr;
   Compiler* m_compiler = nullptr;
   std::vector<IPInstance*> m_instances;
+  uint32_t m_jobs{0};
 };
 
 }  // namespace FOEDAG
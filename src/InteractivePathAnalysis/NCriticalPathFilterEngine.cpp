@@ -0,0 +1,180 @@
+/**
+  * @file NCriticalPathFilterEngine.cpp
+  * @copyright Copyright 2021 The Foedag team
+
+  * GPL License
+
+  * Copyright (c) 2021 The Open-Source FPGA Foundation
+
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "NCriticalPathFilterEngine.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace FOEDAG {
+
+std::size_t FilterBitset::count() const {
+  std::size_t result = 0;
+  for (uint64_t word : m_words) result += std::bitset<64>(word).count();
+  return result;
+}
+
+FilterBitset& FilterBitset::operator&=(const FilterBitset& rhs) {
+  for (std::size_t i = 0; i < m_words.size(); ++i) {
+    m_words[i] &= (i < rhs.m_words.size()) ? rhs.m_words[i] : 0;
+  }
+  return *this;
+}
+
+CompiledFilterCriteria::CompiledFilterCriteria(const FilterCriteriaConf& conf)
+    : m_isSet(conf.isSet()), m_useRegExp(conf.useRegExp()) {
+  if (!m_isSet) {
+    return;
+  }
+  if (m_useRegExp) {
+    QRegularExpression::PatternOptions options =
+        QRegularExpression::NoPatternOption;
+    if (conf.caseSensetive() == Qt::CaseInsensitive) {
+      options |= QRegularExpression::CaseInsensitiveOption;
+    }
+    m_regExp = QRegularExpression{conf.criteria(), options};
+    m_regExp.optimize();
+  } else {
+    m_matcher = QStringMatcher{conf.criteria(), conf.caseSensetive()};
+  }
+}
+
+bool CompiledFilterCriteria::matches(const QString& line) const {
+  if (!m_isSet) {
+    return true;
+  }
+  if (m_useRegExp) {
+    return m_regExp.match(line).hasMatch();
+  }
+  return m_matcher.indexIn(line) != -1;
+}
+
+void NCriticalPathFilterIndex::addPath(int row, const QString& startPointLine,
+                                       const QString& endPointLine) {
+  addEntry(m_startPoints, m_startPointLookup, startPointLine, row);
+  addEntry(m_endPoints, m_endPointLookup, endPointLine, row);
+  m_pathRows.push_back(row);
+  m_rowCount = std::max(m_rowCount, static_cast<std::size_t>(row) + 1);
+}
+
+void NCriticalPathFilterIndex::addEntry(std::vector<Entry>& entries,
+                                        QHash<QString, std::size_t>& lookup,
+                                        const QString& line, int row) {
+  auto it = lookup.find(line);
+  if (it == lookup.end()) {
+    it = lookup.insert(line, entries.size());
+    entries.push_back(Entry{line, {}});
+  }
+  entries[it.value()].rows.push_back(row);
+}
+
+FilterBitset NCriticalPathFilterIndex::match(
+    const std::vector<Entry>& entries, const CompiledFilterCriteria& criteria,
+    const std::function<bool()>& cancelled) const {
+  FilterBitset bits{m_rowCount};
+  if (!criteria.isSet()) {
+    for (int row : m_pathRows) bits.set(row);
+    return bits;
+  }
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    // checked now and then, matching a line is cheap
+    if (cancelled && (i % 256 == 0) && cancelled()) {
+      break;
+    }
+    if (criteria.matches(entries[i].line)) {
+      for (int row : entries[i].rows) bits.set(row);
+    }
+  }
+  return bits;
+}
+
+FilterBitset NCriticalPathFilterIndex::evaluate(
+    const CompiledFilterCriteria& inputCriteria,
+    const CompiledFilterCriteria& outputCriteria,
+    const std::function<bool()>& cancelled) const {
+  FilterBitset bits = match(m_startPoints, inputCriteria, cancelled);
+  if (outputCriteria.isSet()) {
+    bits &= match(m_endPoints, outputCriteria, cancelled);
+  }
+  return bits;
+}
+
+NCriticalPathFilterWorker::~NCriticalPathFilterWorker() {
+  {
+    QMutexLocker locker{&m_lock};
+    m_stop = true;
+    m_pending.reset();
+  }
+  ++m_latest;
+  m_wakeUp.wakeOne();
+  wait();
+}
+
+void NCriticalPathFilterWorker::request(
+    const NCriticalPathFilterIndexPtr& index,
+    const FilterCriteriaConf& inputCriteria,
+    const FilterCriteriaConf& outputCriteria, quint64 generation) {
+  {
+    QMutexLocker locker{&m_lock};
+    m_pending = Request{index, inputCriteria, outputCriteria, generation};
+  }
+  m_latest = generation;
+  m_wakeUp.wakeOne();
+  if (!isRunning()) {
+    start();
+  }
+}
+
+void NCriticalPathFilterWorker::cancel() {
+  QMutexLocker locker{&m_lock};
+  m_pending.reset();
+  ++m_latest;
+}
+
+void NCriticalPathFilterWorker::run() {
+  while (true) {
+    Request request;
+    {
+      QMutexLocker locker{&m_lock};
+      while (!m_stop && !m_pending) {
+        m_wakeUp.wait(&m_lock);
+      }
+      if (m_stop) {
+        return;
+      }
+      request = std::move(*m_pending);
+      m_pending.reset();
+    }
+    const quint64 generation = request.generation;
+    auto cancelled = [this, generation]() { return m_latest != generation; };
+    CompiledFilterCriteria inputCriteria{request.inputCriteria};
+    CompiledFilterCriteria outputCriteria{request.outputCriteria};
+    auto bits = std::make_shared<const FilterBitset>(
+        request.index->evaluate(inputCriteria, outputCriteria, cancelled));
+    if (!cancelled()) {
+      emit resultReady(generation, bits);
+    }
+  }
+}
+
+}  // namespace FOEDAG
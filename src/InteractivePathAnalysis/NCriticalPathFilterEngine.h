@@ -0,0 +1,175 @@
+/**
+  * @file NCriticalPathFilterEngine.h
+  * @copyright Copyright 2021 The Foedag team
+
+  * GPL License
+
+  * Copyright (c) 2021 The Open-Source FPGA Foundation
+
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringMatcher>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "FilterCriteriaConf.h"
+
+namespace FOEDAG {
+
+/**
+ * @brief Fixed size set of row bits
+ */
+class FilterBitset {
+ public:
+  FilterBitset() = default;
+  explicit FilterBitset(std::size_t size)
+      : m_size(size), m_words((size + 63) / 64, 0) {}
+
+  std::size_t size() const { return m_size; }
+
+  void set(std::size_t pos) { m_words[pos / 64] |= uint64_t{1} << (pos % 64); }
+  bool test(std::size_t pos) const {
+    return (pos < m_size) && (m_words[pos / 64] >> (pos % 64)) & 1;
+  }
+  std::size_t count() const;
+
+  FilterBitset& operator&=(const FilterBitset& rhs);
+
+ private:
+  std::size_t m_size = 0;
+  std::vector<uint64_t> m_words;
+};
+using FilterBitsetPtr = std::shared_ptr<const FilterBitset>;
+
+/**
+ * @brief FilterCriteriaConf compiled once for matching many lines
+ */
+class CompiledFilterCriteria {
+ public:
+  CompiledFilterCriteria() = default;
+  explicit CompiledFilterCriteria(const FilterCriteriaConf& conf);
+
+  bool isSet() const { return m_isSet; }
+  bool matches(const QString& line) const;
+
+ private:
+  bool m_isSet = false;
+  bool m_useRegExp = false;
+  QRegularExpression m_regExp;
+  QStringMatcher m_matcher;
+};
+
+/**
+ * @brief Index of critical path rows by start point and end point lines
+ *
+ * Built once when the report is loaded. Paths sharing the same start (end)
+ * point share one index entry, so the criteria are matched once per distinct
+ * line instead of once per path.
+ */
+class NCriticalPathFilterIndex {
+ public:
+  void addPath(int row, const QString& startPointLine,
+               const QString& endPointLine);
+
+  /// number of source rows covered by the index
+  std::size_t rowCount() const { return m_rowCount; }
+  std::size_t pathCount() const { return m_pathRows.size(); }
+  std::size_t startPointCount() const { return m_startPoints.size(); }
+  std::size_t endPointCount() const { return m_endPoints.size(); }
+
+  /// @return bits of path rows meeting both criteria, incomplete if
+  /// \a cancelled returned true
+  FilterBitset evaluate(const CompiledFilterCriteria& inputCriteria,
+                        const CompiledFilterCriteria& outputCriteria,
+                        const std::function<bool()>& cancelled = {}) const;
+
+ private:
+  struct Entry {
+    QString line;
+    std::vector<int> rows;
+  };
+  std::vector<Entry> m_startPoints;
+  std::vector<Entry> m_endPoints;
+  QHash<QString, std::size_t> m_startPointLookup;
+  QHash<QString, std::size_t> m_endPointLookup;
+  std::vector<int> m_pathRows;
+  std::size_t m_rowCount = 0;
+
+  static void addEntry(std::vector<Entry>& entries,
+                       QHash<QString, std::size_t>& lookup,
+                       const QString& line, int row);
+  FilterBitset match(const std::vector<Entry>& entries,
+                     const CompiledFilterCriteria& criteria,
+                     const std::function<bool()>& cancelled) const;
+};
+using NCriticalPathFilterIndexPtr =
+    std::shared_ptr<const NCriticalPathFilterIndex>;
+
+/**
+ * @brief Evaluates filter criteria over the index on its own thread
+ *
+ * One worker serves all requests of a model. A new request replaces the
+ * pending one and stops the evaluation in progress, only the result of the
+ * latest request is reported.
+ */
+class NCriticalPathFilterWorker : public QThread {
+  Q_OBJECT
+ public:
+  explicit NCriticalPathFilterWorker(QObject* parent = nullptr)
+      : QThread(parent) {}
+  ~NCriticalPathFilterWorker() override;
+
+  void request(const NCriticalPathFilterIndexPtr& index,
+               const FilterCriteriaConf& inputCriteria,
+               const FilterCriteriaConf& outputCriteria, quint64 generation);
+  /// drops pending request and stops the evaluation in progress
+  void cancel();
+
+ signals:
+  void resultReady(quint64 generation, const FOEDAG::FilterBitsetPtr&);
+
+ protected:
+  void run() override final;
+
+ private:
+  struct Request {
+    NCriticalPathFilterIndexPtr index;
+    FilterCriteriaConf inputCriteria;
+    FilterCriteriaConf outputCriteria;
+    quint64 generation = 0;
+  };
+  QMutex m_lock;
+  QWaitCondition m_wakeUp;
+  std::optional<Request> m_pending;
+  bool m_stop = false;
+  // evaluation of any other generation is outdated
+  std::atomic<quint64> m_latest{0};
+};
+
+}  // namespace FOEDAG
+
+Q_DECLARE_METATYPE(FOEDAG::FilterBitsetPtr)
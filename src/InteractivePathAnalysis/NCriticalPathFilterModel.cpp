@@ -27,9 +27,36 @@
 #include "NCriticalPathFilterModel.h"
 
 #include "NCriticalPathItem.h"
+#include "NCriticalPathModel.h"
 
 namespace FOEDAG {
 
+NCriticalPathFilterModel::NCriticalPathFilterModel(QObject* parent)
+    : QSortFilterProxyModel(parent) {
+  qRegisterMetaType<FilterBitsetPtr>(
+      "std::shared_ptr<const FOEDAG::FilterBitset>");
+}
+
+void NCriticalPathFilterModel::setSourceModel(
+    QAbstractItemModel* sourceModel) {
+  disconnect(m_loadFinishedConnection);
+  disconnect(m_clearedConnection);
+  QSortFilterProxyModel::setSourceModel(sourceModel);
+
+  auto pathModel = qobject_cast<NCriticalPathModel*>(sourceModel);
+  setFilterIndex(pathModel ? pathModel->filterIndex() : nullptr);
+  if (pathModel) {
+    m_loadFinishedConnection =
+        connect(pathModel, &NCriticalPathModel::loadFinished, this,
+                [this, pathModel]() {
+                  setFilterIndex(pathModel->filterIndex());
+                });
+    m_clearedConnection =
+        connect(pathModel, &NCriticalPathModel::cleared, this,
+                [this]() { setFilterIndex(nullptr); });
+  }
+}
+
 bool NCriticalPathFilterModel::setFilterCriteria(
     const FilterCriteriaConf& inputCriteriaConf,
     const FilterCriteriaConf& outputCriteriaConf) {
@@ -38,7 +65,9 @@ bool NCriticalPathFilterModel::setFilterCriteria(
 
   bool isChanged = isInputCriteriaChanged || isOutoutCriteriaChanged;
   if (isChanged) {
-    invalidateFilter();
+    m_inputCriteria = CompiledFilterCriteria{m_inputCriteriaConf};
+    m_outputCriteria = CompiledFilterCriteria{m_outputCriteriaConf};
+    evaluate();
   }
   return isChanged;
 }
@@ -55,30 +84,59 @@ bool NCriticalPathFilterModel::filterAcceptsRow(
     return true;  // we don't apply filter on path segments for now
   }
 
-  bool inputMeetsCriteria = true;
-  if (m_inputCriteriaConf.isSet()) {
-    if (m_inputCriteriaConf.useRegExp()) {
-      QRegularExpression pattern(m_inputCriteriaConf.criteria());
-      return pattern.match(item->startPointLine()).hasMatch();
-    } else {
-      inputMeetsCriteria = item->startPointLine().contains(
-          m_inputCriteriaConf.criteria(), m_inputCriteriaConf.caseSensetive());
-    }
+  if (m_result && !sourceParentIndex.isValid()) {
+    return m_result->test(sourceRow);
   }
+  return m_inputCriteria.matches(item->startPointLine()) &&
+         m_outputCriteria.matches(item->endPointLine());
+}
 
-  bool outputMeetsCriteria = true;
-  if (m_outputCriteriaConf.isSet()) {
-    if (m_outputCriteriaConf.useRegExp()) {
-      QRegularExpression pattern(m_outputCriteriaConf.criteria());
-      return pattern.match(item->endPointLine()).hasMatch();
-    } else {
-      outputMeetsCriteria =
-          item->endPointLine().contains(m_outputCriteriaConf.criteria(),
-                                        m_outputCriteriaConf.caseSensetive());
+void NCriticalPathFilterModel::evaluate() {
+  ++m_generation;
+  m_result.reset();
+  if (!m_index || (!m_inputCriteria.isSet() && !m_outputCriteria.isSet())) {
+    if (m_worker) {
+      m_worker->cancel();
     }
+    invalidateFilter();
+    emit filterApplied();
+    return;
   }
 
-  return inputMeetsCriteria && outputMeetsCriteria;
+  if (!m_worker) {
+    m_worker = new NCriticalPathFilterWorker(this);
+    connect(m_worker, &NCriticalPathFilterWorker::resultReady, this,
+            &NCriticalPathFilterModel::applyResult);
+  }
+  m_worker->request(m_index, m_inputCriteriaConf, m_outputCriteriaConf,
+                    m_generation);
+}
+
+void NCriticalPathFilterModel::applyResult(quint64 generation,
+                                           const FilterBitsetPtr& result) {
+  if (generation != m_generation) {
+    return;  // criteria or source data changed meanwhile
+  }
+  m_result = result;
+  invalidateFilter();
+  emit filterApplied();
+}
+
+void NCriticalPathFilterModel::setFilterIndex(
+    const NCriticalPathFilterIndexPtr& index) {
+  if (m_index == index) {
+    return;
+  }
+  m_index = index;
+  if (m_index && (m_inputCriteria.isSet() || m_outputCriteria.isSet())) {
+    evaluate();
+  } else {
+    ++m_generation;
+    m_result.reset();
+    if (m_worker) {
+      m_worker->cancel();
+    }
+  }
 }
 
 void NCriticalPathFilterModel::clear() { resetFilterCriteria(); }
@@ -87,4 +145,4 @@ void NCriticalPathFilterModel::resetFilterCriteria() {
   setFilterCriteria(FilterCriteriaConf{}, FilterCriteriaConf{});
 }
 
-}  // namespace FOEDAG
\ No newline at end of file
+}  // namespace FOEDAG
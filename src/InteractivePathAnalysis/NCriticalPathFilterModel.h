@@ -29,20 +29,36 @@
 #include <QSortFilterProxyModel>
 
 #include "FilterCriteriaConf.h"
+#include "NCriticalPathFilterEngine.h"
 
 namespace FOEDAG {
+
+/**
+ * @brief Proxy model filtering critical paths by start and end points
+ *
+ * Criteria are compiled once per change. When the source is
+ * NCriticalPathModel, they are evaluated over its filter index on one worker
+ * thread, a change cancels the evaluation in progress. The resulting row
+ * bits are applied afterwards, filterApplied() is emitted then. Rows are
+ * matched one by one against the compiled criteria only while no result is
+ * available, e.g. when rows are being loaded.
+ */
 class NCriticalPathFilterModel final : public QSortFilterProxyModel {
   Q_OBJECT
 
  public:
-  explicit NCriticalPathFilterModel(QObject* parent = nullptr)
-      : QSortFilterProxyModel(parent) {}
+  explicit NCriticalPathFilterModel(QObject* parent = nullptr);
   ~NCriticalPathFilterModel() override final = default;
 
+  void setSourceModel(QAbstractItemModel* sourceModel) override final;
+
   bool setFilterCriteria(const FilterCriteriaConf& inputCriteria,
                          const FilterCriteriaConf& outputCriteria);
   void clear();
 
+ signals:
+  void filterApplied();
+
  protected:
   bool filterAcceptsRow(
       int sourceRow, const QModelIndex& sourceParentIndex) const override final;
@@ -50,8 +66,20 @@ class NCriticalPathFilterModel final : public QSortFilterProxyModel {
  private:
   FilterCriteriaConf m_inputCriteriaConf;
   FilterCriteriaConf m_outputCriteriaConf;
+  CompiledFilterCriteria m_inputCriteria;
+  CompiledFilterCriteria m_outputCriteria;
+
+  NCriticalPathFilterIndexPtr m_index;
+  QMetaObject::Connection m_loadFinishedConnection;
+  QMetaObject::Connection m_clearedConnection;
+  FilterBitsetPtr m_result;
+  quint64 m_generation = 0;  // drops results of outdated evaluations
+  NCriticalPathFilterWorker* m_worker = nullptr;  // created on first use
 
   void resetFilterCriteria();
+  void evaluate();
+  void applyResult(quint64 generation, const FOEDAG::FilterBitsetPtr& result);
+  void setFilterIndex(const NCriticalPathFilterIndexPtr& index);
 };
 
 }  // namespace FOEDAG
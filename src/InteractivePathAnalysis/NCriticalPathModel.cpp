@@ -53,6 +53,7 @@ void NCriticalPathModel::clear() {
 
   m_inputNodes.clear();
   m_outputNodes.clear();
+  m_filterIndex.reset();
 
   emit cleared();
 }
@@ -191,6 +192,7 @@ void NCriticalPathModel::loadItems(
   m_outputNodes = std::move(itemsHelperStructPtr->outputNodes);
   itemsHelperStructPtr->inputNodes.clear();
   itemsHelperStructPtr->outputNodes.clear();
+  m_filterIndex = std::move(itemsHelperStructPtr->filterIndex);
 
   emit loadFinished();
   SimpleLogger::instance().debug("load model finished");
@@ -51,6 +51,10 @@ class NCriticalPathModel final : public QAbstractItemModel {
 
   const std::map<QString, int>& inputNodes() const { return m_inputNodes; }
   const std::map<QString, int>& outputNodes() const { return m_outputNodes; }
+  /// index of the loaded paths, null if nothing is loaded
+  const NCriticalPathFilterIndexPtr& filterIndex() const {
+    return m_filterIndex;
+  }
 
   void clear();
 
@@ -82,6 +86,7 @@ class NCriticalPathModel final : public QAbstractItemModel {
 
   std::map<QString, int> m_inputNodes;
   std::map<QString, int> m_outputNodes;
+  NCriticalPathFilterIndexPtr m_filterIndex;
 
   QTimer m_lineLimiterTimer;  // a single-shot timer is used to unite multiple
                               // requests into one
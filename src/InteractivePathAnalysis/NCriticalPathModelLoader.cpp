@@ -73,7 +73,11 @@ void NCriticalPathModelLoader::createItems(
   ItemsHelperStructPtr itemsHelperStructPtr =
       std::make_shared<ItemsHelperStruct>();
 
+  itemsHelperStructPtr->filterIndex =
+      std::make_shared<NCriticalPathFilterIndex>();
+
   NCriticalPathItem* currentPathItem = nullptr;
+  int rootRow = 0;  // row of the next top level item
 
   for (const GroupPtr& group : groups) {
     if (group->isPath()) {
@@ -126,6 +130,9 @@ void NCriticalPathModelLoader::createItems(
                                                   pathId, isSelectable);
           itemsHelperStructPtr->items.emplace_back(
               std::make_pair(currentPathItem, nullptr));
+          itemsHelperStructPtr->filterIndex->addPath(
+              rootRow++, currentPathItem->startPointLine(),
+              currentPathItem->endPointLine());
         } else if (role == SEGMENT) {
           if (currentPathItem) {
             NCriticalPathItem::Type type{NCriticalPathItem::PATH_ELEMENT};
@@ -205,6 +212,7 @@ void NCriticalPathModelLoader::createItems(
               data, val1, val2, type, id, pathId, isSelectable);
           itemsHelperStructPtr->items.emplace_back(
               std::make_pair(newItem, nullptr));
+          rootRow++;
         }
       }
     }
@@ -30,6 +30,7 @@
 #include <map>
 #include <memory>
 
+#include "NCriticalPathFilterEngine.h"
 #include "NCriticalPathReportParser.h"
 
 namespace FOEDAG {
@@ -40,6 +41,7 @@ struct ItemsHelperStruct {
   std::vector<std::pair<NCriticalPathItem*, NCriticalPathItem*>> items;
   std::map<QString, int> inputNodes;
   std::map<QString, int> outputNodes;
+  std::shared_ptr<NCriticalPathFilterIndex> filterIndex;
 };
 using ItemsHelperStructPtr = std::shared_ptr<ItemsHelperStruct>;
 
@@ -44,6 +44,8 @@ constexpr const char* TELEGRAM_ECHO_BODY = "ECHO";
 
 const unsigned char ZLIB_COMPRESSOR_ID = 'z';
 const unsigned char NONE_COMPRESSOR_ID = '\x0';
+// LZ4 block format codec, see TelegramCodec.h
+const unsigned char LZ4_COMPRESSOR_ID = 'l';
 
 constexpr const char* OPTION_PATH_NUM = "path_num";
 constexpr const char* OPTION_PATH_TYPE = "path_type";
@@ -30,8 +30,8 @@
 #include "ConvertUtils.h"
 #include "RequestCreator.h"
 #include "TcpSocket.h"
+#include "TelegramCodec.h"
 #include "TelegramParser.h"
-#include "ZlibUtils.h"
 
 namespace FOEDAG {
 
@@ -68,14 +68,12 @@ void GateIO::startConnectionWatcher() { m_socket.startConnectionWatcher(); }
 
 void GateIO::stopConnectionWatcher() { m_socket.stopConnectionWatcher(); }
 
-void GateIO::handleResponse(const QByteArray& bytes, bool isCompressed) {
+void GateIO::handleResponse(const QByteArray& bytes, uint8_t compressorId) {
   static const std::string echoData{comm::TELEGRAM_ECHO_BODY};
 
-  std::string rawData{bytes.begin(), bytes.end()};
-
   bool isEchoTelegram = false;
-  if (rawData.size() == echoData.size()) {
-    if (rawData == echoData) {
+  if (static_cast<std::size_t>(bytes.size()) == echoData.size()) {
+    if (bytes == echoData.c_str()) {
       sendRequest(
           m_echoTelegram,
           comm::TELEGRAM_ECHO_BODY);  // please don't change initiator else from
@@ -88,13 +86,12 @@ void GateIO::handleResponse(const QByteArray& bytes, bool isCompressed) {
   if (!isEchoTelegram) {
     std::optional<std::string> decompressedTelegramOpt;
 #ifndef FORCE_DISABLE_ZLIB_TELEGRAM_COMPRESSION
-    if (isCompressed) {
-      decompressedTelegramOpt = tryDecompress(rawData);
+    if (compressorId != comm::NONE_COMPRESSOR_ID) {
+      decompressedTelegramOpt = tryDecompress(bytes, compressorId);
     }
 #endif
     if (!decompressedTelegramOpt) {
-      decompressedTelegramOpt = std::move(rawData);
-      rawData.clear();
+      decompressedTelegramOpt = std::string{bytes.begin(), bytes.end()};
     }
 
     const std::string& telegram = decompressedTelegramOpt.value();
@@ -167,6 +164,27 @@ void GateIO::handleResponse(const QByteArray& bytes, bool isCompressed) {
   }
 }
 
+std::optional<std::string> GateIO::tryDecompress(const QByteArray& bytes,
+                                                  uint8_t compressorId) {
+  comm::TelegramCodec* codec = m_codecs.codec(compressorId);
+  if (!codec) {
+    SimpleLogger::instance().error("unknown telegram compressor id",
+                                   static_cast<int>(compressorId));
+    return std::nullopt;
+  }
+  // decompress straight from the received bytes with the reused codec
+  std::string telegram;
+  telegram.reserve(bytes.size() * 4);
+  if (!codec->begin(comm::TelegramCodec::Mode::DECOMPRESS) ||
+      !codec->update(bytes.constData(), bytes.size(), telegram) ||
+      !codec->end(telegram)) {
+    SimpleLogger::instance().error("unable to decompress telegram by",
+                                   codec->name());
+    return std::nullopt;
+  }
+  return telegram;
+}
+
 void GateIO::sendRequest(const comm::TelegramFrame& frame,
                          const QString& initiator) {
   if (!m_socket.isConnected()) {
@@ -37,6 +37,7 @@
 #include "../SimpleLogger.h"
 #include "ConvertUtils.h"
 #include "TcpSocket.h"
+#include "TelegramCodec.h"
 
 namespace FOEDAG {
 
@@ -185,8 +186,12 @@ class GateIO : public QObject {
 
   const comm::TelegramFrame m_echoTelegram;
 
+  comm::TelegramCodecPool m_codecs;
+
   void sendRequest(const comm::TelegramFrame& frame, const QString& initiator);
-  void handleResponse(const QByteArray&, bool isCompressed);
+  void handleResponse(const QByteArray&, uint8_t compressorId);
+  std::optional<std::string> tryDecompress(const QByteArray& bytes,
+                                           uint8_t compressorId);
 };
 
 }  // namespace client
@@ -129,7 +129,7 @@ void TcpSocket::handleDataReady() {
                      telegramFrame->body.size());
     SimpleLogger::instance().log("received",
                                  telegramFrame->header.info().c_str());
-    emit dataRecieved(bytes, telegramFrame->header.isBodyCompressed());
+    emit dataRecieved(bytes, telegramFrame->header.compressorId());
   }
 
   std::vector<std::string> errors;
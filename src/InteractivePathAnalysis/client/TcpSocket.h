@@ -91,7 +91,7 @@ class TcpSocket : public QObject {
 
  signals:
   void connectedChanged(bool);
-  void dataRecieved(QByteArray, bool isCompressed);
+  void dataRecieved(QByteArray, uint8_t compressorId);
 
  private:
   int m_portNum = -1;
@@ -0,0 +1,443 @@
+/**
+  * @file TelegramCodec.cpp
+  * @copyright Copyright 2021 The Foedag team
+
+  * GPL License
+
+  * Copyright (c) 2021 The Open-Source FPGA Foundation
+
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TelegramCodec.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "CommConstants.h"
+
+namespace FOEDAG {
+
+namespace comm {
+
+namespace {
+
+// output chunk of zlib stream, big enough to inflate large reports quickly
+constexpr std::size_t ZLIB_CHUNK_SIZE = 256 * 1024;
+// path list compresses well, reserve this ratio ahead for the decompression
+constexpr std::size_t EXPECTED_RATIO = 4;
+
+// LZ4 block format constants
+constexpr std::size_t MIN_MATCH = 4;
+constexpr std::size_t LAST_LITERALS = 5;
+constexpr std::size_t MF_LIMIT = 12;
+constexpr std::size_t MAX_DISTANCE = 65535;
+constexpr int HASH_LOG = 12;
+
+uint32_t read32(const char* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint32_t readLE32(const char* p) {
+  const auto* b = reinterpret_cast<const unsigned char*>(p);
+  return b[0] | (b[1] << 8) | (b[2] << 16) |
+         (static_cast<uint32_t>(b[3]) << 24);
+}
+
+void appendLE32(std::string& output, uint32_t value) {
+  const char bytes[] = {static_cast<char>(value), static_cast<char>(value >> 8),
+                        static_cast<char>(value >> 16),
+                        static_cast<char>(value >> 24)};
+  output.append(bytes, sizeof(bytes));
+}
+
+uint32_t hashPosition(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+char* writeLength(char* op, std::size_t length) {
+  for (; length >= 255; length -= 255) *op++ = static_cast<char>(255);
+  *op++ = static_cast<char>(length);
+  return op;
+}
+
+bool readLength(const char*& ip, const char* end, std::size_t& length) {
+  unsigned char byte = 0;
+  do {
+    if (ip >= end) return false;
+    byte = static_cast<unsigned char>(*ip++);
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+}  // namespace
+
+bool TelegramCodec::compress(const std::string& input, std::string& output) {
+  return begin(Mode::COMPRESS) &&
+         update(input.data(), input.size(), output) && end(output);
+}
+
+bool TelegramCodec::decompress(const std::string& input, std::string& output) {
+  output.reserve(output.size() + input.size() * EXPECTED_RATIO);
+  return begin(Mode::DECOMPRESS) &&
+         update(input.data(), input.size(), output) && end(output);
+}
+
+std::unique_ptr<TelegramCodec> TelegramCodec::create(uint8_t id, int level) {
+  switch (id) {
+    case NONE_COMPRESSOR_ID:
+      return std::make_unique<NoneCodec>();
+    case ZLIB_COMPRESSOR_ID:
+      return std::make_unique<ZlibCodec>(level);
+    case LZ4_COMPRESSOR_ID:
+      return std::make_unique<Lz4Codec>();
+  }
+  return nullptr;
+}
+
+uint8_t NoneCodec::id() const { return NONE_COMPRESSOR_ID; }
+
+bool NoneCodec::update(const char* data, std::size_t size,
+                       std::string& output) {
+  output.append(data, size);
+  return true;
+}
+
+struct ZlibCodec::Stream {
+  z_stream zs;
+  bool deflateReady = false;
+  bool inflateReady = false;
+};
+
+ZlibCodec::ZlibCodec(int level)
+    : m_stream(std::make_unique<Stream>()), m_level(level) {
+  std::memset(&m_stream->zs, 0, sizeof(m_stream->zs));
+}
+
+ZlibCodec::~ZlibCodec() {
+  if (m_stream->deflateReady) deflateEnd(&m_stream->zs);
+  if (m_stream->inflateReady) inflateEnd(&m_stream->zs);
+}
+
+uint8_t ZlibCodec::id() const { return ZLIB_COMPRESSOR_ID; }
+
+bool ZlibCodec::begin(Mode mode) {
+  m_mode = mode;
+  m_streamEnd = false;
+  m_failed = false;
+  m_chunk.resize(ZLIB_CHUNK_SIZE);
+  // z_stream can't be shared by deflate and inflate, release the other one
+  z_stream& zs = m_stream->zs;
+  if (mode == Mode::COMPRESS) {
+    if (m_stream->inflateReady) {
+      inflateEnd(&zs);
+      m_stream->inflateReady = false;
+    }
+    if (m_stream->deflateReady) {
+      m_failed = deflateReset(&zs) != Z_OK;
+    } else {
+      m_failed = deflateInit(&zs, m_level) != Z_OK;
+      m_stream->deflateReady = !m_failed;
+    }
+  } else {
+    if (m_stream->deflateReady) {
+      deflateEnd(&zs);
+      m_stream->deflateReady = false;
+    }
+    if (m_stream->inflateReady) {
+      m_failed = inflateReset(&zs) != Z_OK;
+    } else {
+      m_failed = inflateInit(&zs) != Z_OK;
+      m_stream->inflateReady = !m_failed;
+    }
+  }
+  return !m_failed;
+}
+
+bool ZlibCodec::update(const char* data, std::size_t size,
+                       std::string& output) {
+  if (m_failed) return false;
+  // data after the end of deflate stream is ignored
+  if (m_streamEnd) return true;
+  z_stream& zs = m_stream->zs;
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  zs.avail_in = static_cast<uInt>(size);
+  return run(Z_NO_FLUSH, output);
+}
+
+bool ZlibCodec::end(std::string& output) {
+  if (m_failed) return false;
+  if (m_mode == Mode::COMPRESS) {
+    m_stream->zs.avail_in = 0;
+    if (!run(Z_FINISH, output)) return false;
+  }
+  return m_streamEnd;
+}
+
+bool ZlibCodec::run(int flush, std::string& output) {
+  z_stream& zs = m_stream->zs;
+  do {
+    zs.next_out = reinterpret_cast<Bytef*>(m_chunk.data());
+    zs.avail_out = static_cast<uInt>(m_chunk.size());
+    const int retCode = (m_mode == Mode::COMPRESS) ? deflate(&zs, flush)
+                                                   : inflate(&zs, flush);
+    output.append(m_chunk.data(), m_chunk.size() - zs.avail_out);
+    if (retCode == Z_STREAM_END) {
+      m_streamEnd = true;
+      return true;
+    }
+    if (retCode == Z_BUF_ERROR) return true;  // needs more input
+    if (retCode != Z_OK) {
+      m_failed = true;
+      return false;
+    }
+  } while (zs.avail_out == 0 || zs.avail_in != 0);
+  return true;
+}
+
+uint8_t Lz4Codec::id() const { return LZ4_COMPRESSOR_ID; }
+
+bool Lz4Codec::begin(Mode mode) {
+  m_mode = mode;
+  m_pending.clear();
+  m_streamEnd = false;
+  m_failed = false;
+  return true;
+}
+
+bool Lz4Codec::update(const char* data, std::size_t size,
+                      std::string& output) {
+  if (m_failed) return false;
+  if (m_mode == Mode::COMPRESS) {
+    // complete pending block, then encode straight from the input
+    if (!m_pending.empty()) {
+      const std::size_t take = std::min(size, BLOCK_SIZE - m_pending.size());
+      m_pending.append(data, take);
+      data += take;
+      size -= take;
+      if (m_pending.size() < BLOCK_SIZE) return true;
+      writeBlock(m_pending.data(), m_pending.size(), output);
+      m_pending.clear();
+    }
+    for (; size >= BLOCK_SIZE; data += BLOCK_SIZE, size -= BLOCK_SIZE)
+      writeBlock(data, BLOCK_SIZE, output);
+    m_pending.assign(data, size);
+    return true;
+  }
+  if (m_streamEnd) return true;
+  std::size_t used = 0;
+  if (m_pending.empty()) {
+    if (!readBlocks(data, size, output, used)) return false;
+    m_pending.assign(data + used, size - used);
+  } else {
+    m_pending.append(data, size);
+    if (!readBlocks(m_pending.data(), m_pending.size(), output, used))
+      return false;
+    m_pending.erase(0, used);
+  }
+  return true;
+}
+
+bool Lz4Codec::end(std::string& output) {
+  if (m_failed) return false;
+  if (m_mode == Mode::COMPRESS) {
+    if (!m_pending.empty())
+      writeBlock(m_pending.data(), m_pending.size(), output);
+    m_pending.clear();
+    appendLE32(output, 0);
+    appendLE32(output, 0);
+    m_streamEnd = true;
+  }
+  return m_streamEnd;
+}
+
+void Lz4Codec::writeBlock(const char* data, std::size_t size,
+                          std::string& output) {
+  // encoded block must be smaller than raw one, else it is stored
+  m_block.resize(size);
+  const std::size_t encoded =
+      compressBlock(data, size, m_block.data(), size - 1);
+  appendLE32(output, static_cast<uint32_t>(size));
+  if (encoded != 0) {
+    appendLE32(output, static_cast<uint32_t>(encoded));
+    output.append(m_block.data(), encoded);
+  } else {
+    appendLE32(output, static_cast<uint32_t>(size) | STORED_FLAG);
+    output.append(data, size);
+  }
+}
+
+bool Lz4Codec::readBlocks(const char* data, std::size_t size,
+                          std::string& output, std::size_t& used) {
+  used = 0;
+  while (size - used >= BLOCK_HEADER_SIZE) {
+    const char* header = data + used;
+    const uint32_t rawSize = readLE32(header);
+    const uint32_t encoded = readLE32(header + sizeof(uint32_t));
+    if (rawSize == 0) {
+      used += BLOCK_HEADER_SIZE;
+      m_streamEnd = true;
+      return true;
+    }
+    const bool stored = encoded & STORED_FLAG;
+    const std::size_t encodedSize = encoded & ~STORED_FLAG;
+    if ((rawSize > BLOCK_SIZE) || (stored && encodedSize != rawSize) ||
+        (!stored && encodedSize >= rawSize)) {
+      m_failed = true;
+      return false;
+    }
+    if (size - used - BLOCK_HEADER_SIZE < encodedSize) break;
+    const char* payload = header + BLOCK_HEADER_SIZE;
+    if (stored) {
+      output.append(payload, rawSize);
+    } else {
+      const std::size_t offset = output.size();
+      output.resize(offset + rawSize);
+      if (!decompressBlock(payload, encodedSize, &output[offset], rawSize)) {
+        output.resize(offset);
+        m_failed = true;
+        return false;
+      }
+    }
+    used += BLOCK_HEADER_SIZE + encodedSize;
+  }
+  return true;
+}
+
+std::size_t Lz4Codec::compressBlock(const char* input, std::size_t size,
+                                    char* output, std::size_t capacity) {
+  const char* ip = input;
+  const char* anchor = input;
+  const char* const end = input + size;
+  char* op = output;
+  char* const opEnd = output + capacity;
+
+  if (size > MF_LIMIT) {
+    std::array<uint32_t, 1 << HASH_LOG> table{};
+    // last match starts MF_LIMIT bytes before end, last bytes are literals
+    const char* const matchStartLimit = end - MF_LIMIT;
+    const char* const matchEndLimit = end - LAST_LITERALS;
+    ++ip;
+    while (ip <= matchStartLimit) {
+      const uint32_t hash = hashPosition(read32(ip));
+      const char* ref = input + table[hash];
+      table[hash] = static_cast<uint32_t>(ip - input);
+      if ((ip - ref > static_cast<std::ptrdiff_t>(MAX_DISTANCE)) ||
+          (read32(ref) != read32(ip))) {
+        // step faster over incompressible data
+        ip += 1 + ((ip - anchor) >> 6);
+        continue;
+      }
+      while ((ip > anchor) && (ref > input) && (ip[-1] == ref[-1])) {
+        --ip;
+        --ref;
+      }
+      const char* matchEnd = ip + MIN_MATCH;
+      const char* refEnd = ref + MIN_MATCH;
+      while ((matchEnd < matchEndLimit) && (*matchEnd == *refEnd)) {
+        ++matchEnd;
+        ++refEnd;
+      }
+      const std::size_t literals = ip - anchor;
+      const std::size_t matchLength = matchEnd - ip - MIN_MATCH;
+      if (op + 1 + literals + literals / 255 + 1 + 2 + matchLength / 255 + 1 >
+          opEnd) {
+        return 0;
+      }
+      char* token = op++;
+      *token = static_cast<char>(std::min<std::size_t>(literals, 15) << 4);
+      if (literals >= 15) op = writeLength(op, literals - 15);
+      std::memcpy(op, anchor, literals);
+      op += literals;
+      const std::size_t offset = ip - ref;
+      *op++ = static_cast<char>(offset);
+      *op++ = static_cast<char>(offset >> 8);
+      *token |= static_cast<char>(std::min<std::size_t>(matchLength, 15));
+      if (matchLength >= 15) op = writeLength(op, matchLength - 15);
+      ip = anchor = matchEnd;
+      if (ip <= matchStartLimit) {
+        table[hashPosition(read32(ip - 2))] =
+            static_cast<uint32_t>(ip - 2 - input);
+      }
+    }
+  }
+  const std::size_t literals = end - anchor;
+  if (op + 1 + literals + literals / 255 + 1 > opEnd) return 0;
+  char* token = op++;
+  *token = static_cast<char>(std::min<std::size_t>(literals, 15) << 4);
+  if (literals >= 15) op = writeLength(op, literals - 15);
+  std::memcpy(op, anchor, literals);
+  op += literals;
+  return op - output;
+}
+
+bool Lz4Codec::decompressBlock(const char* input, std::size_t size,
+                               char* output, std::size_t rawSize) {
+  const char* ip = input;
+  const char* const end = input + size;
+  char* op = output;
+  char* const opEnd = output + rawSize;
+  while (ip < end) {
+    const unsigned char token = static_cast<unsigned char>(*ip++);
+    std::size_t literals = token >> 4;
+    if (literals == 15 && !readLength(ip, end, literals)) return false;
+    if ((literals > static_cast<std::size_t>(end - ip)) ||
+        (literals > static_cast<std::size_t>(opEnd - op))) {
+      return false;
+    }
+    std::memcpy(op, ip, literals);
+    op += literals;
+    ip += literals;
+    if (ip == end) break;  // last sequence has literals only
+    if (end - ip < 2) return false;
+    const std::size_t offset = static_cast<unsigned char>(ip[0]) |
+                               (static_cast<unsigned char>(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<std::size_t>(op - output))
+      return false;
+    std::size_t length = token & 15;
+    if (length == 15 && !readLength(ip, end, length)) return false;
+    length += MIN_MATCH;
+    if (length > static_cast<std::size_t>(opEnd - op)) return false;
+    const char* match = op - offset;
+    if (offset >= length) {
+      std::memcpy(op, match, length);
+      op += length;
+    } else {
+      // overlapped copy repeats the last offset bytes
+      for (std::size_t i = 0; i < length; ++i) *op++ = *match++;
+    }
+  }
+  return op == opEnd;
+}
+
+TelegramCodec* TelegramCodecPool::codec(uint8_t id) {
+  auto it = m_codecs.find(id);
+  if (it == m_codecs.end()) {
+    auto codec = TelegramCodec::create(id, m_zlibLevel);
+    if (!codec) return nullptr;
+    it = m_codecs.emplace(id, std::move(codec)).first;
+  }
+  return it->second.get();
+}
+
+}  // namespace comm
+
+}  // namespace FOEDAG
@@ -0,0 +1,177 @@
+/**
+  * @file TelegramCodec.h
+  * @copyright Copyright 2021 The Foedag team
+
+  * GPL License
+
+  * Copyright (c) 2021 The Open-Source FPGA Foundation
+
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TELEGRAMCODEC_H
+#define TELEGRAMCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace FOEDAG {
+
+namespace comm {
+
+/**
+ * @brief Streaming compressor/decompressor of the telegram body
+ *
+ * Codec is identified by the compressor id byte carried in the telegram
+ * header. Stream is started with begin(), fed by update() in chunks of any
+ * size and completed by end(). Produced bytes are appended to the output
+ * string. Codec object keeps its internal buffers between streams, so reuse
+ * it for consecutive telegrams instead of creating new one.
+ */
+class TelegramCodec {
+ public:
+  enum class Mode { COMPRESS, DECOMPRESS };
+
+  virtual ~TelegramCodec() = default;
+
+  virtual uint8_t id() const = 0;
+  virtual const char* name() const = 0;
+
+  /// starts new stream, state of the previous one is dropped
+  virtual bool begin(Mode mode) = 0;
+  /// consumes chunk of input, may append produced bytes to the output
+  virtual bool update(const char* data, std::size_t size,
+                      std::string& output) = 0;
+  /// flushes pending bytes, fails if compressed stream is incomplete
+  virtual bool end(std::string& output) = 0;
+
+  bool compress(const std::string& input, std::string& output);
+  bool decompress(const std::string& input, std::string& output);
+
+  /**
+   * @brief creates codec for the compressor id
+   *
+   * @param level is compression level for zlib (0..9, -1 is default),
+   * ignored by other codecs.
+   * @return nullptr if id is unknown
+   */
+  static std::unique_ptr<TelegramCodec> create(uint8_t id, int level = -1);
+};
+
+/**
+ * @brief Telegram body stored as is
+ */
+class NoneCodec : public TelegramCodec {
+ public:
+  uint8_t id() const override;
+  const char* name() const override { return "none"; }
+  bool begin(Mode) override { return true; }
+  bool update(const char* data, std::size_t size,
+              std::string& output) override;
+  bool end(std::string&) override { return true; }
+};
+
+/**
+ * @brief Deflate stream, compatible with telegrams of the VPR server
+ */
+class ZlibCodec : public TelegramCodec {
+ public:
+  explicit ZlibCodec(int level = -1);
+  ~ZlibCodec() override;
+
+  uint8_t id() const override;
+  const char* name() const override { return "zlib"; }
+  bool begin(Mode mode) override;
+  bool update(const char* data, std::size_t size,
+              std::string& output) override;
+  bool end(std::string& output) override;
+
+ private:
+  struct Stream;
+  std::unique_ptr<Stream> m_stream;
+  std::vector<char> m_chunk;
+  int m_level = -1;
+  Mode m_mode = Mode::DECOMPRESS;
+  bool m_streamEnd = false;
+  bool m_failed = false;
+
+  bool run(int flush, std::string& output);
+};
+
+/**
+ * @brief Fast LZ77 codec using the LZ4 block format
+ *
+ * Input is split into independent blocks of up to BLOCK_SIZE bytes. Every
+ * block is prefixed with its raw and encoded sizes (little endian uint32),
+ * the top bit of the encoded size marks block stored without compression.
+ * Stream ends with zero raw size. It trades ratio for speed and suits the
+ * large and repetitive path list reports.
+ */
+class Lz4Codec : public TelegramCodec {
+ public:
+  static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+  uint8_t id() const override;
+  const char* name() const override { return "lz4"; }
+  bool begin(Mode mode) override;
+  bool update(const char* data, std::size_t size,
+              std::string& output) override;
+  bool end(std::string& output) override;
+
+  /// encodes block into the output, returns encoded size, 0 if incompressible
+  static std::size_t compressBlock(const char* input, std::size_t size,
+                                   char* output, std::size_t capacity);
+  /// decodes block, returns false on malformed or oversized input
+  static bool decompressBlock(const char* input, std::size_t size,
+                              char* output, std::size_t rawSize);
+
+ private:
+  static constexpr std::size_t BLOCK_HEADER_SIZE = 2 * sizeof(uint32_t);
+  static constexpr uint32_t STORED_FLAG = 0x80000000u;
+
+  Mode m_mode = Mode::COMPRESS;
+  std::string m_pending;
+  std::vector<char> m_block;
+  bool m_streamEnd = false;
+  bool m_failed = false;
+
+  void writeBlock(const char* data, std::size_t size, std::string& output);
+  bool readBlocks(const char* data, std::size_t size, std::string& output,
+                  std::size_t& used);
+};
+
+/**
+ * @brief Lazily created codecs by compressor id, reused between telegrams
+ */
+class TelegramCodecPool {
+ public:
+  explicit TelegramCodecPool(int zlibLevel = -1) : m_zlibLevel(zlibLevel) {}
+
+  /// @return nullptr if id is unknown
+  TelegramCodec* codec(uint8_t id);
+
+ private:
+  int m_zlibLevel = -1;
+  std::map<uint8_t, std::unique_ptr<TelegramCodec>> m_codecs;
+};
+
+}  // namespace comm
+
+}  // namespace FOEDAG
+
+#endif  // TELEGRAMCODEC_H
@@ -0,0 +1,87 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// foedag-client: sends a batch job to a running 'foedag --server <socket>'.
+// Job output is written directly to the standard streams of this process.
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "Main/BatchProtocol.h"
+
+#ifndef _WIN32
+extern char** environ;
+#endif
+
+static int usage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [--socket <socket>] [--cmd \"tcl cmd\"] [--script <script>]"
+            << std::endl
+            << "Socket defaults to FOEDAG_SERVER_SOCKET environment variable."
+            << std::endl;
+  return 1;
+}
+
+int main(int argc, char** argv) {
+  namespace fs = std::filesystem;
+  const char* socket = std::getenv("FOEDAG_SERVER_SOCKET");
+  std::string socketPath{socket ? socket : ""};
+  FOEDAG::BatchRequest request;
+  for (int i = 1; i < argc; i++) {
+    const std::string token{argv[i]};
+    if (i + 1 >= argc) return usage(argv[0]);
+    if (token == "--socket") {
+      socketPath = argv[++i];
+    } else if (token == "--cmd") {
+      request.command = argv[++i];
+    } else if (token == "--script") {
+      std::error_code ec;
+      fs::path script = fs::absolute(argv[++i], ec);
+      if (ec || !fs::is_regular_file(script)) {
+        std::cerr << "ERROR: Cannot open script file: " << argv[i]
+                  << std::endl;
+        return 1;
+      }
+      request.script = script.string();
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (socketPath.empty() ||
+      (request.command.empty() && request.script.empty()))
+    return usage(argv[0]);
+
+  request.workingDir = fs::current_path().string();
+#ifndef _WIN32
+  for (char** variable = environ; *variable; variable++)
+    request.environment.emplace_back(*variable);
+#endif
+  std::string error;
+  int status = FOEDAG::BatchProtocol::RunClient(socketPath, request, &error);
+  if (status < 0) {
+    if (error.empty()) error = "Server failed to run the job";
+    std::cerr << "ERROR: " << error << std::endl;
+    return 1;
+  }
+  return status;
+}
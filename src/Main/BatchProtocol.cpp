@@ -0,0 +1,300 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BatchProtocol.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace FOEDAG {
+
+static constexpr char Magic[]{"FDGB"};
+static constexpr uint32_t Version{1};
+// requests larger than that are treated as garbage
+static constexpr uint32_t MaxRequestSize{16 * 1024 * 1024};
+
+static void setError(std::string* error, const std::string& message) {
+  if (error) *error = message;
+}
+
+static void appendUint(std::string& data, uint32_t value) {
+  const unsigned char bytes[4]{static_cast<unsigned char>(value >> 24),
+                               static_cast<unsigned char>(value >> 16),
+                               static_cast<unsigned char>(value >> 8),
+                               static_cast<unsigned char>(value)};
+  data.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+static void appendString(std::string& data, const std::string& value) {
+  appendUint(data, static_cast<uint32_t>(value.size()));
+  data.append(value);
+}
+
+static bool readUint(const std::string& data, size_t& pos, uint32_t& value) {
+  if (data.size() - pos < 4) return false;
+  const auto bytes = reinterpret_cast<const unsigned char*>(data.data() + pos);
+  value = (uint32_t{bytes[0]} << 24) | (uint32_t{bytes[1]} << 16) |
+          (uint32_t{bytes[2]} << 8) | uint32_t{bytes[3]};
+  pos += 4;
+  return true;
+}
+
+static bool readString(const std::string& data, size_t& pos,
+                       std::string& value) {
+  uint32_t size{0};
+  if (!readUint(data, pos, size) || data.size() - pos < size) return false;
+  value = data.substr(pos, size);
+  pos += size;
+  return true;
+}
+
+std::string BatchProtocol::Encode(const BatchRequest& request) {
+  std::string data{Magic, sizeof(Magic) - 1};
+  appendUint(data, Version);
+  appendString(data, request.workingDir);
+  appendString(data, request.script);
+  appendString(data, request.command);
+  appendUint(data, static_cast<uint32_t>(request.environment.size()));
+  for (const auto& variable : request.environment) appendString(data, variable);
+  return data;
+}
+
+bool BatchProtocol::Decode(const std::string& data, BatchRequest& request) {
+  if (data.compare(0, sizeof(Magic) - 1, Magic) != 0) return false;
+  size_t pos{sizeof(Magic) - 1};
+  uint32_t version{0};
+  if (!readUint(data, pos, version) || version != Version) return false;
+  BatchRequest result;
+  uint32_t count{0};
+  if (!readString(data, pos, result.workingDir) ||
+      !readString(data, pos, result.script) ||
+      !readString(data, pos, result.command) || !readUint(data, pos, count))
+    return false;
+  for (uint32_t i = 0; i < count; i++) {
+    std::string variable;
+    if (!readString(data, pos, variable)) return false;
+    result.environment.push_back(std::move(variable));
+  }
+  if (pos != data.size()) return false;
+  request = std::move(result);
+  return true;
+}
+
+#ifndef _WIN32
+
+bool BatchProtocol::WriteAll(int fd, const void* data, size_t size) {
+  auto ptr = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t written = ::send(fd, ptr, size, MSG_NOSIGNAL);
+    if (written < 0 && errno == ENOTSOCK) written = ::write(fd, ptr, size);
+    if (written < 0 && errno == EINTR) continue;
+    if (written <= 0) return false;
+    ptr += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+bool BatchProtocol::ReadAll(int fd, void* data, size_t size) {
+  auto ptr = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t count = ::read(fd, ptr, size);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) return false;
+    ptr += count;
+    size -= static_cast<size_t>(count);
+  }
+  return true;
+}
+
+bool BatchProtocol::SendRequest(int socket, const BatchRequest& request,
+                                const int (&fds)[DescriptorCount],
+                                std::string* error) {
+  const std::string body = Encode(request);
+  uint32_t size = htonl(static_cast<uint32_t>(body.size()));
+
+  // size goes together with the descriptors, body follows as plain data
+  iovec iov{&size, sizeof(size)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))]{};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* header = CMSG_FIRSTHDR(&message);
+  header->cmsg_level = SOL_SOCKET;
+  header->cmsg_type = SCM_RIGHTS;
+  header->cmsg_len = CMSG_LEN(sizeof(fds));
+  std::memcpy(CMSG_DATA(header), fds, sizeof(fds));
+  ssize_t sent{0};
+  do {
+    sent = ::sendmsg(socket, &message, MSG_NOSIGNAL);
+  } while (sent < 0 && errno == EINTR);
+  if (sent != static_cast<ssize_t>(sizeof(size)) ||
+      !WriteAll(socket, body.data(), body.size())) {
+    setError(error, std::string{"Failed to send request: "} +
+                        std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool BatchProtocol::ReceiveRequest(int socket, BatchRequest& request,
+                                   int (&fds)[DescriptorCount],
+                                   std::string* error) {
+  for (auto& fd : fds) fd = -1;
+  uint32_t size{0};
+  iovec iov{&size, sizeof(size)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))]{};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  ssize_t received{0};
+  do {
+    received = ::recvmsg(socket, &message, 0);
+  } while (received < 0 && errno == EINTR);
+  // descriptors are taken even if the rest of the request is broken, so they
+  // are not leaked
+  for (cmsghdr* header = CMSG_FIRSTHDR(&message); header;
+       header = CMSG_NXTHDR(&message, header)) {
+    if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS &&
+        header->cmsg_len == CMSG_LEN(sizeof(fds)))
+      std::memcpy(fds, CMSG_DATA(header), sizeof(fds));
+  }
+  auto fail = [&fds, error](const std::string& message) {
+    for (auto& fd : fds) {
+      if (fd >= 0) ::close(fd);
+      fd = -1;
+    }
+    setError(error, message);
+    return false;
+  };
+  if (received != static_cast<ssize_t>(sizeof(size)) ||
+      (message.msg_flags & MSG_CTRUNC))
+    return fail("Failed to receive request header");
+  for (auto fd : fds)
+    if (fd < 0) return fail("Request has no standard streams");
+  size = ntohl(size);
+  if (size > MaxRequestSize) return fail("Request is too large");
+  std::string body(size, '\0');
+  if (!ReadAll(socket, body.data(), body.size()))
+    return fail("Failed to receive request");
+  if (!Decode(body, request)) return fail("Malformed request");
+  return true;
+}
+
+bool BatchProtocol::SendStatus(int socket, int status) {
+  uint32_t value = htonl(static_cast<uint32_t>(status));
+  return WriteAll(socket, &value, sizeof(value));
+}
+
+bool BatchProtocol::ReceiveStatus(int socket, int& status) {
+  uint32_t value{0};
+  if (!ReadAll(socket, &value, sizeof(value))) return false;
+  status = static_cast<int>(ntohl(value));
+  return true;
+}
+
+int BatchProtocol::Connect(const std::string& socketPath, std::string* error) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+    setError(error, "Invalid socket path: " + socketPath);
+    return -1;
+  }
+  std::strncpy(address.sun_path, socketPath.c_str(),
+               sizeof(address.sun_path) - 1);
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    setError(error, std::string{"socket: "} + std::strerror(errno));
+    return -1;
+  }
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+      0) {
+    setError(error, "Cannot connect to " + socketPath + ": " +
+                        std::strerror(errno));
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int BatchProtocol::RunClient(const std::string& socketPath,
+                             const BatchRequest& request, std::string* error) {
+  int socket = Connect(socketPath, error);
+  if (socket < 0) return -1;
+  const int fds[DescriptorCount]{STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+  int status{-1};
+  if (SendRequest(socket, request, fds, error)) {
+    if (!ReceiveStatus(socket, status)) {
+      setError(error, "Connection to server lost");
+      status = -1;
+    }
+  }
+  ::close(socket);
+  return status;
+}
+
+#else
+
+bool BatchProtocol::WriteAll(int, const void*, size_t) { return false; }
+bool BatchProtocol::ReadAll(int, void*, size_t) { return false; }
+
+bool BatchProtocol::SendRequest(int, const BatchRequest&,
+                                const int (&)[DescriptorCount],
+                                std::string* error) {
+  setError(error, "Batch server is not supported on this platform");
+  return false;
+}
+
+bool BatchProtocol::ReceiveRequest(int, BatchRequest&,
+                                   int (&)[DescriptorCount],
+                                   std::string* error) {
+  setError(error, "Batch server is not supported on this platform");
+  return false;
+}
+
+bool BatchProtocol::SendStatus(int, int) { return false; }
+bool BatchProtocol::ReceiveStatus(int, int&) { return false; }
+
+int BatchProtocol::Connect(const std::string&, std::string* error) {
+  setError(error, "Batch server is not supported on this platform");
+  return -1;
+}
+
+int BatchProtocol::RunClient(const std::string&, const BatchRequest&,
+                             std::string* error) {
+  setError(error, "Batch server is not supported on this platform");
+  return -1;
+}
+
+#endif
+
+}  // namespace FOEDAG
@@ -0,0 +1,84 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The BatchRequest struct
+ * One job sent by the batch client to the batch server.
+ */
+struct BatchRequest {
+  std::string workingDir;
+  std::string script;
+  std::string command;
+  // NAME=VALUE entries, replace the server environment for the job
+  std::vector<std::string> environment;
+};
+
+/*!
+ * \brief The BatchProtocol class
+ * Wire format between batch server and its clients over a Unix-domain
+ * socket. Client sends the request together with its stdin, stdout and
+ * stderr descriptors (SCM_RIGHTS), so job output goes straight to the client
+ * terminal or pipe. Server answers with the job exit status only.
+ * Not available on Windows, all functions fail there.
+ */
+class BatchProtocol {
+ public:
+  static constexpr int DescriptorCount{3};
+
+  static bool SendRequest(int socket, const BatchRequest& request,
+                          const int (&fds)[DescriptorCount],
+                          std::string* error = nullptr);
+  // received descriptors must be closed by the caller
+  static bool ReceiveRequest(int socket, BatchRequest& request,
+                             int (&fds)[DescriptorCount],
+                             std::string* error = nullptr);
+
+  static bool SendStatus(int socket, int status);
+  static bool ReceiveStatus(int socket, int& status);
+
+  static std::string Encode(const BatchRequest& request);
+  static bool Decode(const std::string& data, BatchRequest& request);
+
+  // connected socket or -1
+  static int Connect(const std::string& socketPath,
+                     std::string* error = nullptr);
+
+  /*!
+   * \brief RunClient
+   * Send \a request with descriptors of the calling process and wait for the
+   * job to finish.
+   * \return job exit status or -1 if server is not reachable or job was lost
+   */
+  static int RunClient(const std::string& socketPath,
+                       const BatchRequest& request,
+                       std::string* error = nullptr);
+
+  static bool WriteAll(int fd, const void* data, size_t size);
+  static bool ReadAll(int fd, void* data, size_t size);
+};
+
+}  // namespace FOEDAG
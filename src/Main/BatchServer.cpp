@@ -0,0 +1,307 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BatchServer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace FOEDAG {
+
+BatchServer::BatchServer(const std::string& socketPath, const Job& job)
+    : m_socketPath(socketPath), m_job(job) {}
+
+uint32_t BatchServer::DefaultMaxJobs() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void BatchServer::Stop() {
+  m_stop = true;
+#ifndef _WIN32
+  if (m_wakeup[1] >= 0) {
+    [[maybe_unused]] auto res = ::write(m_wakeup[1], "s", 1);
+  }
+#endif
+}
+
+#ifndef _WIN32
+
+static void closeOnExec(int fd) {
+  ::fcntl(fd, F_SETFD, ::fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+BatchServer::~BatchServer() {
+  if (m_listen >= 0) ::unlink(m_socketPath.c_str());
+  closeSockets();
+}
+
+void BatchServer::closeSockets() {
+  for (int* fd : {&m_listen, &m_wakeup[0], &m_wakeup[1]}) {
+    if (*fd >= 0) ::close(*fd);
+    *fd = -1;
+  }
+  for (const auto& [pid, job] : m_jobs) {
+    ::close(job.connection);
+    ::close(job.finished);
+  }
+  m_jobs.clear();
+}
+
+bool BatchServer::Listen(std::string* error) {
+  auto fail = [this, error](const std::string& message) {
+    if (error) *error = message + ": " + std::strerror(errno);
+    closeSockets();
+    return false;
+  };
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (m_socketPath.empty() || m_socketPath.size() >= sizeof(address.sun_path)) {
+    if (error) *error = "Invalid socket path: " + m_socketPath;
+    return false;
+  }
+  std::strncpy(address.sun_path, m_socketPath.c_str(),
+               sizeof(address.sun_path) - 1);
+
+  struct stat info {};
+  if (::stat(m_socketPath.c_str(), &info) == 0) {
+    int running = BatchProtocol::Connect(m_socketPath);
+    if (running >= 0) {
+      ::close(running);
+      if (error) *error = "Batch server is already running: " + m_socketPath;
+      return false;
+    }
+    // left by a server which was killed
+    if (S_ISSOCK(info.st_mode)) ::unlink(m_socketPath.c_str());
+  }
+
+  if (::pipe(m_wakeup) != 0) return fail("pipe");
+  for (int fd : m_wakeup) {
+    closeOnExec(fd);
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+  m_listen = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (m_listen < 0) return fail("socket");
+  closeOnExec(m_listen);
+  if (::bind(m_listen, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0)
+    return fail("Cannot bind " + m_socketPath);
+  // every client can run any Tcl command as the server user
+  ::chmod(m_socketPath.c_str(), S_IRUSR | S_IWUSR);
+  if (::listen(m_listen, SOMAXCONN) != 0) {
+    ::unlink(m_socketPath.c_str());
+    return fail("listen");
+  }
+  return true;
+}
+
+bool BatchServer::Run() {
+  if (m_listen < 0) return false;
+  while (!m_stop) {
+    std::vector<pollfd> fds;
+    std::vector<int> pids;
+    const bool accepting = (m_maxJobs == 0) || (m_jobs.size() < m_maxJobs);
+    fds.push_back({m_wakeup[0], POLLIN, 0});
+    // negative descriptor is ignored by poll
+    fds.push_back({accepting ? m_listen : -1, POLLIN, 0});
+    for (const auto& [pid, job] : m_jobs) {
+      pids.push_back(pid);
+      fds.push_back({job.finished, POLLIN, 0});
+      // client going away is reported as POLLHUP, request data is left to
+      // the job process
+      fds.push_back({job.killed ? -1 : job.connection, 0, 0});
+    }
+    // timeout only matters for jobs which passed their descriptor to a child
+    // process, others are reported by 'finished' descriptor
+    int count = ::poll(fds.data(), fds.size(), 1000);
+    if (count < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    if (fds[0].revents) {
+      char buffer[64];
+      while (::read(m_wakeup[0], buffer, sizeof(buffer)) > 0) {
+      }
+    }
+    for (size_t i = 0; i < pids.size(); i++) {
+      const pollfd& finished = fds.at(2 + 2 * i);
+      const pollfd& connection = fds.at(3 + 2 * i);
+      if (finished.revents) {
+        finishJob(pids[i], true);
+      } else if (connection.revents & (POLLHUP | POLLERR)) {
+        // client was interrupted, stop the job and tools it started
+        ::kill(-pids[i], SIGTERM);
+        m_jobs[pids[i]].killed = true;
+      } else {
+        finishJob(pids[i], false);
+      }
+    }
+    if (fds[1].revents & POLLIN) {
+      int connection = ::accept(m_listen, nullptr, nullptr);
+      if (connection >= 0) startJob(connection);
+    }
+  }
+  while (!m_jobs.empty()) finishJob(m_jobs.begin()->first, true);
+  return true;
+}
+
+void BatchServer::startJob(int connection) {
+  closeOnExec(connection);
+  int finished[2]{-1, -1};
+  if (::pipe(finished) != 0) {
+    BatchProtocol::SendStatus(connection, -1);
+    ::close(connection);
+    return;
+  }
+  // job process inherits write end, it is closed when job exits
+  closeOnExec(finished[0]);
+  closeOnExec(finished[1]);
+  // don't duplicate pending output in the job process
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::close(finished[0]);
+    runJob(connection);
+  }
+  ::close(finished[1]);
+  if (pid < 0) {
+    BatchProtocol::SendStatus(connection, -1);
+    ::close(connection);
+    ::close(finished[0]);
+    return;
+  }
+  // job gets its own process group, so the tools it started can be stopped
+  // together with it
+  ::setpgid(pid, pid);
+  m_jobs[pid] = RunningJob{connection, finished[0], false};
+}
+
+static int fail(const std::string& message) {
+  std::cerr << "ERROR: " << message << std::endl;
+  return 1;
+}
+
+void BatchServer::runJob(int connection) {
+  closeSockets();
+  ::setpgid(0, 0);
+  // server stops on these, job is stopped by them
+  ::signal(SIGTERM, SIG_DFL);
+  ::signal(SIGINT, SIG_DFL);
+  int status{1};
+  BatchRequest request;
+  int fds[BatchProtocol::DescriptorCount]{};
+  std::string error;
+  if (!BatchProtocol::ReceiveRequest(connection, request, fds, &error)) {
+    std::cerr << "ERROR: " << error << std::endl;
+    ::_exit(status);
+  }
+  ::close(connection);
+  for (int i = 0; i < BatchProtocol::DescriptorCount; i++)
+    ::dup2(fds[i], i);
+  for (int fd : fds)
+    if (fd >= BatchProtocol::DescriptorCount) ::close(fd);
+
+  if (!request.environment.empty()) {
+    std::vector<std::string> names;
+    for (char** variable = environ; *variable; variable++) {
+      std::string entry{*variable};
+      names.push_back(entry.substr(0, entry.find('=')));
+    }
+    for (const auto& name : names) ::unsetenv(name.c_str());
+    for (const auto& entry : request.environment) {
+      auto pos = entry.find('=');
+      if (pos == std::string::npos || pos == 0) continue;
+      ::setenv(entry.substr(0, pos).c_str(), entry.substr(pos + 1).c_str(), 1);
+    }
+  }
+  if (!request.workingDir.empty() && ::chdir(request.workingDir.c_str()) != 0)
+    status = fail("Cannot change directory to " + request.workingDir);
+  else
+    status = m_job(request);
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+  ::_exit(status);
+}
+
+void BatchServer::finishJob(int pid, bool wait) {
+  auto it = m_jobs.find(pid);
+  if (it == m_jobs.end()) return;
+  int status{0};
+  pid_t res{0};
+  do {
+    res = ::waitpid(pid, &status, wait ? 0 : WNOHANG);
+  } while (res < 0 && errno == EINTR);
+  if (res == 0) return;
+  int exitStatus{-1};
+  if (res == pid) {
+    if (WIFEXITED(status))
+      exitStatus = WEXITSTATUS(status);
+    else if (WIFSIGNALED(status))
+      exitStatus = 128 + WTERMSIG(status);
+  }
+  // client may be gone already
+  BatchProtocol::SendStatus(it->second.connection, exitStatus);
+  ::close(it->second.connection);
+  ::close(it->second.finished);
+  m_jobs.erase(it);
+}
+
+#else
+
+BatchServer::~BatchServer() {}
+
+void BatchServer::closeSockets() {}
+
+bool BatchServer::Listen(std::string* error) {
+  if (error) *error = "Batch server is not supported on this platform";
+  return false;
+}
+
+bool BatchServer::Run() { return false; }
+
+void BatchServer::startJob(int) {}
+
+void BatchServer::runJob(int) { std::exit(1); }
+
+void BatchServer::finishJob(int, bool) {}
+
+#endif
+
+}  // namespace FOEDAG
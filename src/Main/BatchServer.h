@@ -0,0 +1,95 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+#include "Main/BatchProtocol.h"
+
+namespace FOEDAG {
+
+/*!
+ * \brief The BatchServer class
+ * Serves batch jobs over a Unix-domain socket. The server process is
+ * initialized once (Tcl interpreter, registered commands, init files) and
+ * every job runs in a process forked from it, so each job starts from the
+ * same warm state and jobs can't affect each other. The job process takes
+ * working directory, environment and standard streams from the client.
+ *
+ * Job process has only the thread which called Run(). Threads started
+ * before it don't exist there, and locks they held stay locked, so the job
+ * must not wait on them. Starting new threads, thread pools and tool
+ * processes in the job is fine. Stop helper threads before Run().
+ */
+class BatchServer {
+ public:
+  // Called in the job process, return value is the job exit status
+  using Job = std::function<int(const BatchRequest& request)>;
+
+  BatchServer(const std::string& socketPath, const Job& job);
+  ~BatchServer();
+  BatchServer(const BatchServer&) = delete;
+  BatchServer& operator=(const BatchServer&) = delete;
+
+  // stale socket file is replaced, running server is reported as an error
+  bool Listen(std::string* error = nullptr);
+
+  /*!
+   * \brief Run
+   * Serve clients until Stop() is called. Jobs still running are waited for.
+   */
+  bool Run();
+  // thread safe
+  void Stop();
+
+  // max number of concurrent jobs, 0 means no limit
+  void MaxJobs(uint32_t jobs) { m_maxJobs = jobs; }
+  uint32_t MaxJobs() const { return m_maxJobs; }
+  // number of CPUs, at least one
+  static uint32_t DefaultMaxJobs();
+
+  const std::string& SocketPath() const { return m_socketPath; }
+
+ private:
+  struct RunningJob {
+    int connection{-1};
+    int finished{-1};  // closed when the job process exits
+    bool killed{false};
+  };
+  void startJob(int connection);
+  [[noreturn]] void runJob(int connection);
+  void finishJob(int pid, bool wait);
+  void closeSockets();
+
+  std::string m_socketPath;
+  Job m_job;
+  int m_listen{-1};
+  int m_wakeup[2]{-1, -1};
+  uint32_t m_maxJobs{DefaultMaxJobs()};
+  std::atomic_bool m_stop{false};
+  std::map<int, RunningJob> m_jobs;
+};
+
+}  // namespace FOEDAG
@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "CommandLine.h"
 
 #include "Utils/FileUtils.h"
+#include "Utils/StringUtils.h"
 
 using namespace FOEDAG;
 
@@ -95,6 +96,22 @@ void CommandLine::processArgs() {
       m_help = true;
     } else if (token == "--version") {
       m_version = true;
+    } else if (token == "--server") {
+      i++;
+      if (i < m_argc) {
+        m_serverSocket = m_argv[i];
+        m_withQt = false;
+      } else
+        ErrorAndExit("Specify a socket file!");
+    } else if (token == "--max-jobs") {
+      i++;
+      if (i < m_argc) {
+        auto [jobs, ok] = StringUtils::to_number<uint32_t>(m_argv[i]);
+        if (!ok || jobs == 0)
+          ErrorAndExit("--max-jobs expects a positive number!");
+        m_maxJobs = jobs;
+      } else
+        ErrorAndExit("Specify a number of jobs!");
     } else if (token == "--mute") {
       m_mute = true;
     } else if (token == "--device") {
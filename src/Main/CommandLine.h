@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef COMMAND_LINE_H
 #define COMMAND_LINE_H
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -57,6 +58,11 @@ class CommandLine {
 
   const std::string& Device() const { return m_device; }
 
+  // Unix-domain socket of batch server, empty if not in server mode
+  const std::string& ServerSocket() const { return m_serverSocket; }
+  // max number of concurrent batch server jobs, 0 if not given
+  uint32_t MaxJobs() const { return m_maxJobs; }
+
   bool UseVerific() { return m_useVerific; }
 
   bool PrintHelp() { return m_help; }
@@ -81,6 +87,8 @@ class CommandLine {
   std::string m_compilerName;
   std::string m_projectFile;
   std::string m_device;
+  std::string m_serverSocket;
+  uint32_t m_maxJobs = 0;
   bool m_help = false;
   bool m_version = false;
   bool m_useVerific = false;
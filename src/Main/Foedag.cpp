@@ -39,6 +39,7 @@ extern "C" {
 #include <QLabel>
 //#include <QQmlApplicationEngine>
 //#include <QQmlContext>
+#include <csignal>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -47,6 +48,7 @@ extern "C" {
 #include <vector>
 
 #include "Command/CommandStack.h"
+#include "Main/BatchServer.h"
 #include "CommandLine.h"
 #include "Console/StreamBuffer.h"
 #include "Console/TclWorker.h"
@@ -61,6 +63,8 @@ extern "C" {
 #include "ProjectFile/ProjectFileLoader.h"
 #include "Tcl/TclInterpreter.h"
 #include "Utils/FileUtils.h"
+#include "Utils/StartupProfiler.h"
+#include "Utils/Tracer.h"
 #include "qttclnotifier.hpp"
 
 #if defined(_MSC_VER)
@@ -200,28 +204,43 @@ bool Foedag::initGui() {
   int argc = m_cmdLine->Argc();
   QApplication app(argc, m_cmdLine->Argv());
   QApplication::setStyle(new FoedagStyle(app.style()));
-  FOEDAG::TclInterpreter* interpreter =
-      new FOEDAG::TclInterpreter(m_cmdLine->Argv()[0]);
-  Config::Instance()->dataPath(m_context->DataPath());
-  FOEDAG::CommandStack* commands =
-      new FOEDAG::CommandStack(interpreter, m_context->ExecutableName());
+  FOEDAG::TclInterpreter* interpreter{nullptr};
+  FOEDAG::CommandStack* commands{nullptr};
+  {
+    StartupScope scope{"interpreter"};
+    interpreter = new FOEDAG::TclInterpreter(m_cmdLine->Argv()[0]);
+    Config::Instance()->dataPath(m_context->DataPath());
+    commands =
+        new FOEDAG::CommandStack(interpreter, m_context->ExecutableName());
+  }
 
-  loadTclInitFile(commands, m_context);
+  {
+    StartupScope scope{"tcl init file"};
+    loadTclInitFile(commands, m_context);
+  }
 
   QWidget* mainWin = nullptr;
 
-  GlobalSession = new FOEDAG::Session(nullptr, interpreter, commands, m_cmdLine,
-                                      m_context, m_compiler, m_settings);
-  DesignFileWatcher::Instance()->init();
+  {
+    StartupScope scope{"session"};
+    GlobalSession =
+        new FOEDAG::Session(nullptr, interpreter, commands, m_cmdLine,
+                            m_context, m_compiler, m_settings);
+    DesignFileWatcher::Instance()->init();
+  }
   GlobalSession->setGuiType(GUI_TYPE::GT_WIDGET);
   if (m_mainWinBuilder) {
+    StartupScope scope{"main window"};
     mainWin = m_mainWinBuilder(GlobalSession);
     GlobalSession->MainWindow(mainWin);
   }
 
-  registerBasicGuiCommands(GlobalSession);
-  if (m_registerTclFunc) {
-    m_registerTclFunc(GlobalSession->MainWindow(), GlobalSession);
+  {
+    StartupScope scope{"register commands"};
+    registerBasicGuiCommands(GlobalSession);
+    if (m_registerTclFunc) {
+      m_registerTclFunc(GlobalSession->MainWindow(), GlobalSession);
+    }
   }
 
   QtTclNotify::QtTclNotifier::setup();  // Registers notifier with Tcl
@@ -255,6 +274,7 @@ bool Foedag::initGui() {
     } else {
       Tcl_EvalEx(interp, "gui_start", -1, 0);
     }
+    StartupProfiler::Instance()->Prompt();
     return 0;
   };
 
@@ -348,6 +368,17 @@ bool Foedag::initQmlGui() {
     return 0;
   };
 
+  // --server <socket>, doesn't enter the interactive loop
+  if (!m_cmdLine->ServerSocket().empty()) {
+    StartupProfiler::Instance()->Prompt();
+    int res = runBatchServer(interpreter->getInterp());
+    if (res != TCL_OK) GlobalSession->ReturnStatus(res);
+    GlobalSession->ProjectFileLoader()->Save();
+    int returnStatus = GlobalSession->ReturnStatus();
+    delete GlobalSession;
+    return returnStatus;
+  }
+
   // Start Loop
   char** argv = new char*[1];
   argv[0] = strdup(m_cmdLine->Argv()[0]);
@@ -384,19 +415,89 @@ bool Foedag::init(GUI_TYPE guiType) {
   return result;
 }
 
+static BatchServer* s_batchServer{nullptr};
+
+static void stopBatchServer(int) {
+  if (s_batchServer) s_batchServer->Stop();
+}
+
+// --server <socket>
+// Everything initialized so far, including the --cmd warm up command, is
+// shared by the jobs: each job runs in a process forked from this one.
+// Server returns on SIGTERM/SIGINT, after the running jobs are finished.
+static int runBatchServer(Tcl_Interp* interp) {
+  CommandLine* cmdLine = GlobalSession->CmdLine();
+  if (!cmdLine->TclCmd().empty()) {
+    int res = Tcl_EvalEx(interp, cmdLine->TclCmd().c_str(), -1, 0);
+    if (res != TCL_OK) {
+      Tcl_EvalEx(interp, "puts $errorInfo", -1, 0);
+      return res;
+    }
+  }
+  BatchServer server{
+      cmdLine->ServerSocket(), [interp, cmdLine](const BatchRequest& request) {
+        int res{TCL_OK};
+        if (!request.command.empty())
+          res = Tcl_EvalEx(interp, request.command.c_str(), -1, 0);
+        if (res == TCL_OK && !request.script.empty()) {
+          // script_path command reports it
+          cmdLine->Script(request.script);
+          res = Tcl_EvalFile(interp, request.script.c_str());
+        }
+        if (res != TCL_OK) {
+          GlobalSession->ReturnStatus(res);
+          Tcl_EvalEx(interp, "puts $errorInfo", -1, 0);
+        }
+        if (!request.script.empty()) GlobalSession->ProjectFileLoader()->Save();
+        return GlobalSession->ReturnStatus();
+      }};
+  if (cmdLine->MaxJobs() != 0) server.MaxJobs(cmdLine->MaxJobs());
+  std::string error;
+  if (!server.Listen(&error)) {
+    std::cerr << "ERROR: " << error << std::endl;
+    return 1;
+  }
+  // Job process has the forking thread only, see BatchServer. Memory sampler
+  // is the only helper thread running here, it would be lost in the jobs.
+  if (Tracer::Instance()->Enabled()) {
+    Tracer::Instance()->Disable();
+    std::cout << "Tracing is disabled in batch server mode" << std::endl;
+  }
+  std::cout << "Batch server is listening on " << server.SocketPath()
+            << std::endl;
+  s_batchServer = &server;
+  auto term = std::signal(SIGTERM, stopBatchServer);
+  auto interrupt = std::signal(SIGINT, stopBatchServer);
+  const bool res = server.Run();
+  std::signal(SIGTERM, term);
+  std::signal(SIGINT, interrupt);
+  s_batchServer = nullptr;
+  return res ? 0 : 1;
+}
+
 bool Foedag::initBatch() {
   // Batch mode
-  FOEDAG::TclInterpreter* interpreter =
-      new FOEDAG::TclInterpreter(m_cmdLine->Argv()[0]);
+  FOEDAG::TclInterpreter* interpreter{nullptr};
+  FOEDAG::CommandStack* commands{nullptr};
   const bool mute{m_cmdLine->Mute() && !m_cmdLine->Script().empty()};
-  Config::Instance()->dataPath(m_context->DataPath());
-  FOEDAG::CommandStack* commands =
-      new FOEDAG::CommandStack(interpreter, m_context->ExecutableName());
-  GlobalSession =
-      new FOEDAG::Session(m_mainWin, interpreter, commands, m_cmdLine,
-                          m_context, m_compiler, m_settings);
+  {
+    StartupScope scope{"interpreter"};
+    interpreter = new FOEDAG::TclInterpreter(m_cmdLine->Argv()[0]);
+    Config::Instance()->dataPath(m_context->DataPath());
+    commands =
+        new FOEDAG::CommandStack(interpreter, m_context->ExecutableName());
+  }
+  {
+    StartupScope scope{"session"};
+    GlobalSession =
+        new FOEDAG::Session(m_mainWin, interpreter, commands, m_cmdLine,
+                            m_context, m_compiler, m_settings);
+  }
 
-  loadTclInitFile(commands, m_context);
+  {
+    StartupScope scope{"tcl init file"};
+    loadTclInitFile(commands, m_context);
+  }
 
   GlobalSession->setGuiType(GUI_TYPE::GT_NONE);
   m_compiler->setGuiTclSync(
@@ -426,12 +527,17 @@ bool Foedag::initBatch() {
                                                 std::cout, &std::cerr, true);
   }
 
-  registerBasicBatchCommands(GlobalSession);
-  if (m_registerTclFunc) {
-    m_registerTclFunc(nullptr, GlobalSession);
+  {
+    StartupScope scope{"register commands"};
+    registerBasicBatchCommands(GlobalSession);
+    if (m_registerTclFunc) {
+      m_registerTclFunc(nullptr, GlobalSession);
+    }
   }
   // Tcl_AppInit
   auto tcl_init = [](Tcl_Interp* interp) -> int {
+    // interpreter is ready to take commands
+    StartupProfiler::Instance()->Prompt();
     // --cmd \"tcl cmd\"
     if (!GlobalSession->CmdLine()->TclCmd().empty()) {
       int res =
@@ -441,8 +547,10 @@ bool Foedag::initBatch() {
         Tcl_EvalEx(interp, "puts $errorInfo", -1, 0);
       }
       // Allows: --cmd  \"tcl cmd\" --script <script>
-      if (GlobalSession->CmdLine()->Script().empty())
+      if (GlobalSession->CmdLine()->Script().empty()) {
+        GlobalSession->ProjectFileLoader()->Flush();
         exit(GlobalSession->ReturnStatus());
+      }
     }
     // --script <script>
     if (!GlobalSession->CmdLine()->Script().empty()) {
@@ -463,6 +571,17 @@ bool Foedag::initBatch() {
     return 0;
   };
 
+  // --server <socket>, doesn't enter the interactive loop
+  if (!m_cmdLine->ServerSocket().empty()) {
+    StartupProfiler::Instance()->Prompt();
+    int res = runBatchServer(interpreter->getInterp());
+    if (res != TCL_OK) GlobalSession->ReturnStatus(res);
+    GlobalSession->ProjectFileLoader()->Save();
+    int returnStatus = GlobalSession->ReturnStatus();
+    delete GlobalSession;
+    return returnStatus;
+  }
+
   // Start Loop
   char** argv = new char*[1];
   argv[0] = strdup(m_cmdLine->Argv()[0]);
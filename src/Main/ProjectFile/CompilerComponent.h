@@ -31,6 +31,7 @@ class CompilerComponent : public ProjectFileComponent {
  public:
   CompilerComponent(Compiler *cc);
   void Save(QXmlStreamWriter *writer) override;
+  bool NotifiesChanges() const override { return false; }
   ErrorCode Load(QXmlStreamReader *reader) override;
   void LoadDone() override;
 };
@@ -38,8 +38,9 @@ std::pair<bool, QString> FileLoaderMigration::Migrate() const {
 
   auto zipPath = path.parent_path();
   fs::remove(zipPath, ec);
-  auto result =
-      CompressProject::CompressZip(zipPath, path.stem().filename().string());
+  auto result = CompressProject::CompressZip(
+      zipPath.parent_path() / (path.stem().filename().string() + ".zip"),
+      {zipPath});
   if (!result.first) return {false, "Failed to create backup"};
 
   // move <project>.srcs under run_1 folder
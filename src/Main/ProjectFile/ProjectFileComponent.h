@@ -66,6 +66,9 @@ class ProjectFileComponent : public QObject {
   virtual void Save(QXmlStreamWriter *writer);
   virtual ErrorCode Load(QXmlStreamReader *reader) { return {}; }
   virtual void LoadDone() {}
+  // false if saveFile() is not emitted on every change, such component is
+  // serialized on every save
+  virtual bool NotifiesChanges() const { return true; }
 
  signals:
   void saveFile();
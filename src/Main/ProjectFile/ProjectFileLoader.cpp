@@ -20,11 +20,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "ProjectFileLoader.h"
 
+#include <QBuffer>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
 #include <QMessageBox>
+#include <QSaveFile>
 #include <QXmlStreamWriter>
+#include <algorithm>
+#include <tcl.h>
 
 #include "Compiler/CompilerDefines.h"
 #include "FileLoaderOldStructure.h"
@@ -40,31 +45,53 @@ static constexpr bool PASS{false};
 
 ProjectFileLoader::ProjectFileLoader(Project *project, QObject *parent)
     : QObject(parent) {
+  // project data is saved by project manager component
   connect(Project::Instance(), &Project::saveFile, this,
-          &ProjectFileLoader::Save);
+          [this]() { ScheduleSave(ComponentId::ProjectManager); });
   m_components.resize(static_cast<size_t>(ComponentId::Count), nullptr);
+  m_fragments.resize(m_components.size());
+  m_dirty.resize(m_components.size(), true);
+  m_saveTimer.setSingleShot(true);
+  m_saveTimer.setInterval(SaveDelay);
+  connect(&m_saveTimer, &QTimer::timeout, this, &ProjectFileLoader::Flush);
+  // Tcl 'exit' ends the process without destroying the session
+  Tcl_CreateExitHandler(&ProjectFileLoader::ExitHandler, this);
 }
 
 ProjectFileLoader::~ProjectFileLoader() {
+  Tcl_DeleteExitHandler(&ProjectFileLoader::ExitHandler, this);
+  Flush();
   for (const auto &component : m_components) delete component;
 }
 
 void ProjectFileLoader::registerComponent(ProjectFileComponent *comp,
                                           ComponentId id) {
-  connect(comp, &ProjectFileComponent::saveFile, this, [this]() { Save(); });
+  connect(comp, &ProjectFileComponent::saveFile, this,
+          [this, id]() { ScheduleSave(id); });
   m_components[static_cast<size_t>(id)] = comp;
+  m_fragments[static_cast<size_t>(id)].clear();
+  m_dirty[static_cast<size_t>(id)] = true;
 }
 
 ErrorCode ProjectFileLoader::Load(const QString &filename) {
+  // pending changes belong to the project loaded before
+  Flush();
   m_loadDone = false;
   auto result = LoadInternal(filename);
   m_loadDone = true;
+  // cached fragments do not match the loaded data
+  std::fill(m_dirty.begin(), m_dirty.end(), true);
   if (!result.errorCode && result.migrationDoneSuccessfully) Save();
   return result.errorCode;
 }
 
 void ProjectFileLoader::setParentWidget(QWidget *parent) { m_parent = parent; }
 
+void ProjectFileLoader::setSaveDelay(int delay, int maxDelay) {
+  m_saveTimer.setInterval(delay);
+  m_maxSaveDelay = maxDelay;
+}
+
 ProjectFileLoader::LoadResult ProjectFileLoader::LoadInternal(
     const QString &filename) {
   if (filename.isEmpty()) return {{ERROR, "Empty project filename"}};
@@ -212,28 +239,101 @@ QString FOEDAG::ProjectFileLoader::ProjectVersion(const QString &filename) {
 
 void ProjectFileLoader::Save() {
   if (!m_loadDone) return;
+  std::fill(m_dirty.begin(), m_dirty.end(), true);
+  Write();
+}
+
+void ProjectFileLoader::ScheduleSave(ComponentId id) {
+  if (!m_loadDone) return;
+  m_dirty[static_cast<size_t>(id)] = true;
+  if (!m_pending) {
+    m_pending = true;
+    m_pendingSince.start();
+  } else if (m_pendingSince.elapsed() >= m_maxSaveDelay) {
+    // timer may never fire if changes keep coming or there is no event loop
+    Write();
+    return;
+  }
+  // no timers in batch mode, pending changes are written by Flush()
+  if (QCoreApplication::instance()) m_saveTimer.start();
+}
+
+void ProjectFileLoader::Flush() {
+  if (m_pending) Write();
+}
+
+void ProjectFileLoader::ExitHandler(ClientData clientData) {
+  static_cast<ProjectFileLoader *>(clientData)->Flush();
+}
+
+void ProjectFileLoader::Write() {
+  m_pending = false;
+  m_saveTimer.stop();
   QString tmpName = Project::Instance()->projectName();
   QString tmpPath = Project::Instance()->projectPath();
   if (tmpName.isEmpty() || tmpPath.isEmpty()) return;
   QString xmlPath = tmpPath + "/" + tmpName + PROJECT_FILE_FORMAT;
-  QFile file(xmlPath);
-  if (!file.open(QFile::WriteOnly | QFile::Text | QFile::Truncate)) {
-    return;
+
+  QByteArray content = Header();
+  for (size_t i = 0; i < m_components.size(); i++) {
+    auto component = m_components.at(i);
+    if (!component) continue;
+    if (m_dirty.at(i) || !component->NotifiesChanges() ||
+        m_fragments.at(i).isNull()) {
+      m_fragments[i] = Serialize(component);
+      m_dirty[i] = false;
+    }
+    content.append(m_fragments.at(i));
   }
-  QXmlStreamWriter stream(&file);
-  stream.setAutoFormatting(true);
-  stream.writeStartDocument();
-  stream.writeComment(
-      tr("                                                   "));
-  stream.writeComment(
-      tr("Copyright (c) 2021-2022 The Open-Source FPGA Foundation."));
-  stream.writeStartElement(PROJECT_PROJECT);
-  stream.writeAttribute(PROJECT_VERSION, TO_C_STR(FOEDAG_BUILD));
-
-  for (const auto &component : m_components) component->Save(&stream);
-
-  stream.writeEndDocument();
-  file.close();
+  content.append("\n</" PROJECT_PROJECT ">\n");
+  if (xmlPath == m_writtenPath && content == m_written) return;
+
+  // file is replaced on commit, interrupted save keeps the previous one
+  QSaveFile file(xmlPath);
+  if (!file.open(QFile::WriteOnly | QFile::Text)) return;
+  file.write(content);
+  if (!file.commit()) return;
+  m_writtenPath = xmlPath;
+  m_written = content;
+  m_writeCount++;
+}
+
+QByteArray ProjectFileLoader::Header() {
+  QByteArray data;
+  {
+    QBuffer buffer{&data};
+    buffer.open(QIODevice::WriteOnly);
+    QXmlStreamWriter stream(&buffer);
+    stream.setAutoFormatting(true);
+    stream.writeStartDocument();
+    stream.writeComment(
+        tr("                                                   "));
+    stream.writeComment(
+        tr("Copyright (c) 2021-2022 The Open-Source FPGA Foundation."));
+    stream.writeStartElement(PROJECT_PROJECT);
+    stream.writeAttribute(PROJECT_VERSION, TO_C_STR(FOEDAG_BUILD));
+    stream.writeCharacters({});  // close start tag
+  }
+  return data;
+}
+
+QByteArray ProjectFileLoader::Serialize(ProjectFileComponent *component) {
+  QByteArray data;
+  {
+    QBuffer buffer{&data};
+    buffer.open(QIODevice::WriteOnly);
+    QXmlStreamWriter stream(&buffer);
+    stream.setAutoFormatting(true);
+    // same depth as in the document, so indentation matches
+    stream.writeStartElement(PROJECT_PROJECT);
+    component->Save(&stream);
+    stream.writeEndElement();
+  }
+  // strip the wrapping element
+  const auto begin = data.indexOf('>') + 1;
+  const auto end = data.lastIndexOf("\n</");
+  if (begin <= 0 || end < begin) return QByteArray{""};
+  return data.mid(begin, end - begin);
 }
 
 }  // namespace FOEDAG
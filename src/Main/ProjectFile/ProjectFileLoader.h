@@ -19,7 +19,9 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
+#include <QElapsedTimer>
 #include <QObject>
+#include <QTimer>
 
 #include "CompilerComponent.h"
 #include "ProjectManagerComponent.h"
@@ -37,16 +39,41 @@ enum class ComponentId {
 
 class Project;
 class ProjectFileComponent;
+
+/*!
+ * \brief The ProjectFileLoader class
+ * Changes reported by components are coalesced: component is marked dirty and
+ * the file is written once no more changes arrive for save delay. Pending
+ * save older than max save delay is written immediately on the next change,
+ * so the file is kept up to date even without running event loop (batch
+ * mode). Pending changes are flushed when the loader is destroyed and when
+ * Tcl exits the process. Only dirty components are serialized again, the
+ * others reuse their cached fragment. File is replaced atomically and not
+ * written at all if its content did not change.
+ */
 class ProjectFileLoader : public QObject {
  public:
+  static constexpr int SaveDelay{200};      // ms
+  static constexpr int MaxSaveDelay{2000};  // ms
+
   explicit ProjectFileLoader(Project *project, QObject *parent = nullptr);
   ~ProjectFileLoader() override;
   void registerComponent(ProjectFileComponent *comp, ComponentId id);
   ErrorCode Load(const QString &filename);
   void setParentWidget(QWidget *parent);
 
+  void setSaveDelay(int delay, int maxDelay);
+  bool hasPendingSave() const { return m_pending; }
+  // number of times project file was written
+  uint writeCount() const { return m_writeCount; }
+
  public slots:
+  // serialize all components and write the file now
   void Save();
+  // mark component dirty and write the file later
+  void ScheduleSave(ComponentId id);
+  // write pending changes now
+  void Flush();
 
  protected:
   static QString ProjectVersion(const QString &filename);
@@ -60,9 +87,22 @@ class ProjectFileLoader : public QObject {
   static LoadResult LoadXml(
       const QString &filename,
       const std::vector<ProjectFileComponent *> &components);
+  void Write();
+  static void ExitHandler(void *clientData);
+  static QByteArray Header();
+  static QByteArray Serialize(ProjectFileComponent *component);
 
  private:
   std::vector<ProjectFileComponent *> m_components;
+  std::vector<QByteArray> m_fragments;
+  std::vector<bool> m_dirty;
+  bool m_pending{false};
+  QTimer m_saveTimer;
+  QElapsedTimer m_pendingSince;
+  int m_maxSaveDelay{MaxSaveDelay};
+  QString m_writtenPath;
+  QByteArray m_written;
+  uint m_writeCount{0};
   bool m_loadDone{true};
   QWidget *m_parent{nullptr};
 };
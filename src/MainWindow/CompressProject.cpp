@@ -83,20 +83,11 @@ CompressProject::CompressProject(const fs::path &project, QWidget *parent)
 }
 
 std::pair<bool, std::string> CompressProject::CompressZip(
-    const fs::path &path, const std::string &fileName,
-    const std::vector<fs::path> &files) {
-  auto fullFileName = fileName + ".zip";
-  StringVector args{"-r", fullFileName, path.filename().string()};
-  auto result = ExecuteSystemCommand("zip", args, path.parent_path().string());
-  if (!result.first) return result;
-
-  for (const auto &file : files) {
-    args = {"-ur", (path.parent_path() / fullFileName).string(),
-            file.filename().string()};
-    ExecuteSystemCommand("zip", args, file.parent_path().string());
-  }
-
-  return {true, {}};
+    const fs::path &archive, const std::vector<fs::path> &paths,
+    const ArchivePolicy &policy) {
+  std::string error;
+  const bool ok = ZipArchive::Compress(archive, paths, policy, 0, &error);
+  return {ok, error};
 }
 
 void CompressProject::appendPathForArchive(const std::filesystem::path &path) {
@@ -125,22 +116,15 @@ void CompressProject::compressProject() {
       if (auto res = ExecuteSystemCommand("tar", args, projectPath); !res.first)
         showErrorMessage(res.second, this);
     } else {
-      // zip -r foo.zip foo
-      auto result = CompressZip(m_projectPath, projectName, m_additionalPath);
-      if (result.first) {
-        // since zip file is created within original project path we have to
-        // move it to the path user selected. zip doesn't allow to drop parent
-        // folder structure.
-        if (projectPath != originalProjectPath) {
-          StringVector args = {projectName + m_extension.toStdString(),
-                               projectPath};
-          if (auto res = ExecuteSystemCommand("mv", args, originalProjectPath);
-              !res.first)
-            showErrorMessage(res.second, this);
-        }
-      } else {
-        showErrorMessage(result.second, this);
-      }
+      // archive is written right into the selected path, artifacts
+      // regenerated by the flow are left out
+      std::vector<fs::path> paths{m_projectPath};
+      paths.insert(paths.end(), m_additionalPath.begin(),
+                   m_additionalPath.end());
+      auto result = CompressZip(
+          fs::path{projectPath} / (projectName + m_extension.toStdString()),
+          paths, ArchivePolicy::WithoutArtifacts());
+      if (!result.first) showErrorMessage(result.second, this);
     }
   }
 }
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include "Dialog.h"
+#include "Utils/ZipArchive.h"
 
 // include order issue: <filesystem> must go after Dialog.h
 #include <filesystem>
@@ -33,9 +34,10 @@ class CompressProject : public Dialog {
 
  public:
   explicit CompressProject(const fs::path& project, QWidget* parent = nullptr);
+  // write \a paths into \a archive, see ZipArchive::Compress
   static std::pair<bool, std::string> CompressZip(
-      const fs::path& path, const std::string& fileName,
-      const std::vector<fs::path>& files = {});
+      const fs::path& archive, const std::vector<fs::path>& paths,
+      const ArchivePolicy& policy = {});
 
   void appendPathForArchive(const fs::path& path);
 
@@ -22,12 +22,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "MainWindow/Session.h"
 
 #include "Compiler/TaskManager.h"
+#include "Main/ProjectFile/ProjectFileLoader.h"
 #include "Main/TclSimpleParser.h"
 #include "TopLevelInterface.h"
 
 using namespace FOEDAG;
 
 Session::~Session() {
+  if (m_projectFileLoader) m_projectFileLoader->Flush();
   if (m_mainWindow) m_mainWindow->deleteLater();
   delete m_interp;
   delete m_stack;
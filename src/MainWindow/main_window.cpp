@@ -229,6 +229,8 @@ MainWindow::MainWindow(Session* session)
           &MainWindow::onRunProjectRequested, Qt::QueuedConnection);
   connect(DesignFileWatcher::Instance(), &DesignFileWatcher::designFilesChanged,
           this, &MainWindow::onDesignFilesChanged);
+  connect(DesignFileWatcher::Instance(), &DesignFileWatcher::designChanged,
+          this, &MainWindow::onDesignChanged);
   connect(DesignFileWatcher::Instance(), &DesignFileWatcher::designCreated,
           this, &MainWindow::onDesignCreated);
   connect(this, &MainWindow::closeRequest, this, &MainWindow::close,
@@ -740,6 +742,29 @@ void MainWindow::onDesignFilesChanged() {
   setStatusAndProgressText(msg);
 }
 
+void MainWindow::onDesignChanged(const DesignChangeSet& changes) {
+  QStringList compile;
+  QStringList simulation;
+  for (const auto& change : changes) {
+    // permissions don't affect the results
+    if (change.kind == DesignFileChange::Metadata) continue;
+    const QString name = QFileInfo{change.file}.fileName();
+    if (change.source == DesignFile::Simulation)
+      simulation.append(name);
+    else
+      compile.append(name);
+  }
+  if (!compile.isEmpty()) {
+    setStatusAndProgressText(
+        QString{"%1 changed. Recompile might be needed."}.arg(
+            compile.join(", ")));
+  } else if (!simulation.isEmpty()) {
+    setStatusAndProgressText(
+        QString{"%1 changed. Simulation might be needed."}.arg(
+            simulation.join(", ")));
+  }
+}
+
 void MainWindow::onDesignCreated() {
   QString msg = "New Design, compile needed.";
   setStatusAndProgressText(msg);
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QSettings>
 
 #include "Main/AboutWidget.h"
+#include "NewProject/ProjectManager/DesignFileWatcher.h"
 #include "NewProject/new_project_dialog.h"
 #include "PerfomanceTracker.h"
 #include "ProjNavigator/FileExplorer.h"
@@ -104,6 +105,7 @@ class MainWindow : public QMainWindow, public TopLevelInterface {
   void defaultProjectPath();
   void pinPlannerPinName();
   void onDesignFilesChanged();
+  void onDesignChanged(const FOEDAG::DesignChangeSet& changes);
   void onDesignCreated();
   void saveSetting(const QString& setting, const QString& path);
   void openFileFromConsole(const FOEDAG::ErrorInfo& eInfo);
@@ -20,14 +20,30 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "DesignFileWatcher.h"
 
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+
 #include "Compiler/Compiler.h"
 #include "MainWindow/Session.h"
+#include "Utils/FileUtils.h"
 #include "project_manager.h"
 
 extern FOEDAG::Session* GlobalSession;
 
 namespace FOEDAG {
 
+#ifdef __linux__
+// saves, renames over the file (atomic saves), removals and chmod
+static constexpr uint32_t WatchMask{IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE |
+                                    IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO};
+#endif
+
 // ProjectMananager isn't a singleton class so storing a file watcher within it
 // was problematic as the main_window had trouble connecting to all the ProjMan
 // ptrs. As an alternative, we'll create a singleton for the filewatcher itself
@@ -37,39 +53,100 @@ DesignFileWatcher* DesignFileWatcher::Instance() {
 }
 //  return designFileWatcher(); }
 
-void DesignFileWatcher::init() {
-  m_fileWatcher = new QFileSystemWatcher{};
-  QObject::connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, this,
-                   &DesignFileWatcher::designFilesChanged);
+DesignFileWatcher::DesignFileWatcher(QObject* parent) : QObject(parent) {
+  m_settleTimer.setSingleShot(true);
+  m_settleTimer.setInterval(SettleDelay);
+  connect(&m_settleTimer, &QTimer::timeout, this, &DesignFileWatcher::flush);
+  m_hashPool.setMaxThreadCount(1);
+}
+
+DesignFileWatcher::~DesignFileWatcher() {
+  // results of running hash are dropped with the watcher
+  m_hashPool.clear();
+  m_hashPool.waitForDone();
+  // notifier must go before its descriptor
+  delete m_notifier;
+#ifdef __linux__
+  if (m_inotify != -1) ::close(m_inotify);
+#endif
+}
+
+void DesignFileWatcher::init(bool native) {
+  if (isValid()) return;
+#ifdef __linux__
+  if (native) m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotify != -1) {
+    m_notifier = new QSocketNotifier{m_inotify, QSocketNotifier::Read, this};
+    connect(m_notifier, &QSocketNotifier::activated, this,
+            &DesignFileWatcher::readEvents);
+    return;
+  }
+#else
+  Q_UNUSED(native)
+#endif
+  m_fileWatcher = new QFileSystemWatcher{this};
+  connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, this,
+          [this](const QString& file) { schedule(file); });
+  // file replaced or removed is not watched anymore, directory is
+  connect(m_fileWatcher, &QFileSystemWatcher::directoryChanged, this,
+          [this](const QString& directory) {
+            for (const auto& [file, state] : m_files)
+              if (QFileInfo{file}.absolutePath() == directory) schedule(file);
+          });
 }
 
 void DesignFileWatcher::emitDesignCreated() { emit designCreated(); }
 
-void DesignFileWatcher::setFiles(const QStringList& filePaths) {
+void DesignFileWatcher::setFiles(const std::vector<DesignFile>& files) {
   if (!isValid()) return;
+  std::map<QString, FileState> watched;
+  for (const auto& file : files) {
+    // Convert paths incase they have PROJECT_OSRCDIR relative paths
+    QString path{file.file};
+    path.replace(PROJECT_OSRCDIR, Project::Instance()->projectPath());
+    path = QDir::cleanPath(QFileInfo{path}.absoluteFilePath());
+    auto& state = watched[path];
+    state.fileSet = file.fileSet;
+    state.source = file.source;
+  }
   // Do nothing if new file list is the same
-  if (filePaths != m_watchFiles) {
-    // QT prints to terminal if you call removePaths on an empty filewatcher
-    // so we have to check for empty first
-    if (!m_fileWatcher->files().empty()) {
-      // Remove old watchers
-      m_fileWatcher->removePaths(m_fileWatcher->files());
-    }
+  auto same = [](const auto& left, const auto& right) {
+    return left.first == right.first &&
+           left.second.fileSet == right.second.fileSet &&
+           left.second.source == right.second.source;
+  };
+  if (std::equal(watched.begin(), watched.end(), m_files.begin(),
+                 m_files.end(), same))
+    return;
 
-    // Add each file to the watcher
-    // Note that some systems potentially have a max file limit, see qt docs
-    // for details https://doc.qt.io/qt-5/qfilesystemwatcher.html#details
-    for (auto file : filePaths) {
-      // Convert paths incase they have PROJECT_OSRCDIR relative paths
-      file.replace(PROJECT_OSRCDIR, Project::Instance()->projectPath());
-      // Add file to watcher
-      m_fileWatcher->addPath(file);
+  FileStates added;
+  for (auto& [file, state] : watched) {
+    auto known = m_files.find(file);
+    if (known == m_files.end()) {
+      readStat(file, state);
+      if (state.exists) added.push_back({file, state});
+    } else {
+      // pending change is compared against the known state
+      state.exists = known->second.exists;
+      state.permissions = known->second.permissions;
+      state.size = known->second.size;
+      state.modified = known->second.modified;
+      state.hash = known->second.hash;
     }
-    m_watchFiles = filePaths;
-
-    // Consider any change to the design file list (filePaths) a design change
-    emit designFilesChanged();
   }
+  m_files = std::move(watched);
+  for (auto it = m_pending.begin(); it != m_pending.end();)
+    it = (m_files.count(*it) != 0) ? std::next(it) : m_pending.erase(it);
+  watch();
+  if (!added.empty()) hash(added, {}, false);
+
+  // Consider any change to the design file list a design change
+  emit designFilesChanged();
+}
+
+void DesignFileWatcher::setSettleDelay(int delay, int maxDelay) {
+  m_settleTimer.setInterval(delay);
+  m_maxSettleDelay = maxDelay;
 }
 
 void DesignFileWatcher::setDevice(const std::string& device) {
@@ -81,35 +158,36 @@ void DesignFileWatcher::setDevice(const std::string& device) {
 
 void DesignFileWatcher::updateDesignFileWatchers(ProjectManager* pManager) {
   if (!isValid()) return;
-  QStringList files;
+  std::vector<DesignFile> files;
 
   // Watch Design Files
-  files += pManager->getDesignFiles();
+  const QString designSet = pManager->getDesignActiveFileSet();
+  for (const auto& file : pManager->getDesignFiles(designSet))
+    files.push_back({file, designSet, DesignFile::Design});
   // Watch Sim Files
-  files += pManager->getSimulationFiles(pManager->getSimulationActiveFileSet());
+  const QString simSet = pManager->getSimulationActiveFileSet();
+  for (const auto& file : pManager->getSimulationFiles(simSet))
+    files.push_back({file, simSet, DesignFile::Simulation});
   // Watch Constraint Files
-  for (const auto& file : pManager->getConstrFiles()) {
-    files += QString::fromStdString(file);
+  for (const auto& set : pManager->getConstrFileSets()) {
+    for (const auto& file : pManager->getConstrFiles(set))
+      files.push_back({file, set, DesignFile::Constraint});
   }
 
   // Watch IP Files
   Compiler* compiler{};
   IPGenerator* ipGen{};
-  // QSystemFileWatcher works on directories, but not recursively and QT
-  // has intenionally ignored a bug in their directory file watching
-  // that doesn't alert when an immediate child file changes.
-  // https://bugreports.qt.io/browse/QTBUG-24693
-  // As such we have to add a filewatcher to each ip src file and the cache json
+  // IP sources and the cache json of every IP instance, directories are
+  // watched on Linux only
   if (GlobalSession && (compiler = GlobalSession->GetCompiler()) &&
       (ipGen = compiler->GetIPGenerator())) {
     // Step through our IP Instance
     for (auto instance : ipGen->IPInstances()) {
-      auto ipPaths = ipGen->GetDesignAndCacheFiles(instance);
+      const QString name = QString::fromStdString(instance->ModuleName());
       // Loop through each design file of the IP
-      for (const auto& file : ipPaths) {
-        // Store file
-        files += QString::fromStdString(file.string());
-      }
+      for (const auto& file : ipGen->GetDesignAndCacheFiles(instance))
+        files.push_back({QString::fromStdString(file.string()), name,
+                         DesignFile::IP});
     }
   }
 
@@ -117,6 +195,194 @@ void DesignFileWatcher::updateDesignFileWatchers(ProjectManager* pManager) {
   setDevice(pManager->getTargetDevice());
 }
 
-bool DesignFileWatcher::isValid() const { return m_fileWatcher != nullptr; }
+bool DesignFileWatcher::isValid() const {
+  return m_fileWatcher != nullptr || m_notifier != nullptr;
+}
+
+void DesignFileWatcher::flush() {
+  m_settleTimer.stop();
+  DesignChangeSet changes;
+  FileStates changed;
+  for (const auto& file : m_pending) {
+    auto it = m_files.find(file);
+    if (it == m_files.end()) continue;
+    FileState& state = it->second;
+    FileState current{state};
+    readStat(file, current);
+    // content is the same if size and modification time are
+    if (current.exists && (!state.exists || current.size != state.size ||
+                           current.modified != state.modified)) {
+      changed.push_back({file, current});
+      continue;
+    }
+    DesignFileChange change{{file, state.fileSet, state.source}};
+    if (!current.exists) {
+      if (!state.exists) continue;
+      change.kind = DesignFileChange::Removed;
+    } else if (current.permissions != state.permissions) {
+      change.kind = DesignFileChange::Metadata;
+      current.hash = state.hash;
+    } else {
+      continue;  // touched without changes
+    }
+    state = std::move(current);
+    changes.push_back(std::move(change));
+  }
+  m_pending.clear();
+  // file replaced on save has to be watched again
+  if (m_fileWatcher) watch();
+  if (!changed.empty()) {
+    hash(changed, changes, true);
+    return;
+  }
+  if (!changes.empty()) emit designChanged(changes);
+}
+
+void DesignFileWatcher::readStat(const QString& file, FileState& state) {
+  const QFileInfo info{file};
+  state.exists = info.isFile();
+  state.permissions = state.exists ? info.permissions() : QFile::Permissions{};
+  state.size = state.exists ? info.size() : -1;
+  state.modified = state.exists ? info.lastModified() : QDateTime{};
+  state.hash.clear();
+}
+
+bool DesignFileWatcher::compare(const FileState& state,
+                                const FileState& current,
+                                DesignFileChange::Kind& kind) {
+  if (!current.exists) {
+    kind = DesignFileChange::Removed;
+    return state.exists;
+  }
+  // file which was not hashed yet is considered changed
+  if (!state.exists || state.hash.empty() || current.hash != state.hash) {
+    kind = DesignFileChange::Content;
+    return true;
+  }
+  kind = DesignFileChange::Metadata;
+  return current.permissions != state.permissions;
+}
+
+void DesignFileWatcher::hash(const FileStates& files,
+                             const DesignChangeSet& changes, bool report) {
+  m_hashing++;
+  m_hashPool.start([this, files, changes, report]() {
+    FileStates states{files};
+    // stat again, file could change before it is hashed
+    for (auto& [file, state] : states) {
+      readStat(file, state);
+      if (state.exists) state.hash = FileUtils::FileHash(file.toStdString());
+    }
+    QMetaObject::invokeMethod(
+        this, [this, states, changes, report]() {
+          hashed(states, changes, report);
+        },
+        Qt::QueuedConnection);
+  });
+}
+
+void DesignFileWatcher::hashed(const FileStates& files, DesignChangeSet changes,
+                               bool report) {
+  m_hashing--;
+  for (const auto& [file, current] : files) {
+    auto it = m_files.find(file);
+    if (it == m_files.end()) continue;  // not watched anymore
+    FileState& state = it->second;
+    DesignFileChange change{{file, state.fileSet, state.source}};
+    const bool changed = compare(state, current, change.kind);
+    // new file changed after it was listed, change could come before a watch
+    // and is not reported otherwise
+    const bool listedChanged =
+        !report &&
+        (current.exists != state.exists || current.size != state.size ||
+         current.modified != state.modified);
+    state.exists = current.exists;
+    state.permissions = current.permissions;
+    state.size = current.size;
+    state.modified = current.modified;
+    state.hash = current.hash;
+    if ((report || listedChanged) && changed)
+      changes.push_back(std::move(change));
+  }
+  if (!changes.empty()) emit designChanged(changes);
+}
+
+void DesignFileWatcher::schedule(const QString& file) {
+  if (m_files.count(file) == 0) return;
+  if (m_pending.empty()) m_pendingSince.start();
+  m_pending.insert(file);
+  // timer never fires if changes keep coming
+  if (m_pendingSince.elapsed() >= m_maxSettleDelay) {
+    flush();
+    return;
+  }
+  m_settleTimer.start();
+}
+
+void DesignFileWatcher::watch() {
+  std::set<QString> directories;
+  for (const auto& [file, state] : m_files)
+    directories.insert(QFileInfo{file}.absolutePath());
+  if (m_fileWatcher) {
+    QStringList paths;
+    for (const auto& [file, state] : m_files)
+      if (QFileInfo::exists(file)) paths.append(file);
+    for (const auto& directory : directories)
+      if (QFileInfo::exists(directory)) paths.append(directory);
+    // QT prints to terminal if you call removePaths on an empty filewatcher
+    // so we have to check for empty first
+    QStringList watched = m_fileWatcher->files() + m_fileWatcher->directories();
+    QStringList removed;
+    for (const auto& path : watched)
+      if (!paths.contains(path)) removed.append(path);
+    if (!removed.empty()) m_fileWatcher->removePaths(removed);
+    QStringList added;
+    for (const auto& path : paths)
+      if (!watched.contains(path)) added.append(path);
+    // Note that some systems potentially have a max file limit, see qt docs
+    // for details https://doc.qt.io/qt-5/qfilesystemwatcher.html#details
+    if (!added.empty()) m_fileWatcher->addPaths(added);
+    return;
+  }
+#ifdef __linux__
+  // watch of the directory watched already is updated, descriptor is the same
+  std::map<int, QStringList> descriptors;
+  for (const auto& directory : directories) {
+    const int wd = inotify_add_watch(
+        m_inotify, QFile::encodeName(directory).constData(), WatchMask);
+    if (wd != -1) descriptors[wd].append(directory);
+  }
+  for (const auto& [wd, paths] : m_directories)
+    if (descriptors.count(wd) == 0) inotify_rm_watch(m_inotify, wd);
+  m_directories = std::move(descriptors);
+#endif
+}
+
+void DesignFileWatcher::readEvents() {
+#ifdef __linux__
+  alignas(inotify_event) char buffer[4096];
+  ssize_t size{0};
+  while ((size = ::read(m_inotify, buffer, sizeof(buffer))) > 0) {
+    for (char* ptr = buffer; ptr < buffer + size;) {
+      const auto event = reinterpret_cast<const inotify_event*>(ptr);
+      ptr += sizeof(inotify_event) + event->len;
+      if (event->mask & IN_Q_OVERFLOW) {
+        // events are lost, compare all files
+        for (const auto& [file, state] : m_files) schedule(file);
+        continue;
+      }
+      auto directory = m_directories.find(event->wd);
+      if (directory == m_directories.end()) continue;
+      if (event->mask & IN_IGNORED) {
+        m_directories.erase(directory);  // directory removed
+        continue;
+      }
+      if (event->len == 0) continue;  // event of the directory itself
+      const QString name = QFile::decodeName(event->name);
+      for (const auto& path : directory->second) schedule(path + "/" + name);
+    }
+  }
+#endif
+}
 
 }  // namespace FOEDAG
@@ -20,33 +20,120 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QFileSystemWatcher>
+#include <QSocketNotifier>
+#include <QThreadPool>
+#include <QTimer>
+#include <map>
+#include <set>
+#include <vector>
 
 namespace FOEDAG {
 class ProjectManager;
 
+struct DesignFile {
+  enum Source { Design, Constraint, Simulation, IP };
+  QString file;
+  QString fileSet;  // IP instance name for IP files
+  Source source{Design};
+};
+
+struct DesignFileChange : DesignFile {
+  // Metadata: same content, permissions changed
+  enum Kind { Content, Metadata, Removed };
+  Kind kind{Content};
+};
+using DesignChangeSet = std::vector<DesignFileChange>;
+
+/*!
+ * \brief The DesignFileWatcher class
+ * Watches design, constraint, simulation and IP files of the project. Changes
+ * are collected until no new change comes for the settling delay (or the max
+ * delay passes) and reported as one change set. Files whose size or
+ * modification time changed are hashed on a worker thread, so saves which
+ * don't change the content are not reported. On Linux directories of
+ * the files are watched with inotify, which also catches editors replacing
+ * the file on save. QFileSystemWatcher is used elsewhere.
+ */
 class DesignFileWatcher : public QObject {
   Q_OBJECT
 
  public:
+  static constexpr int SettleDelay{200};      // ms
+  static constexpr int MaxSettleDelay{2000};  // ms
+
   static DesignFileWatcher *Instance();
-  void init();
+  explicit DesignFileWatcher(QObject *parent = nullptr);
+  ~DesignFileWatcher() override;
+  // native - inotify if available, QFileSystemWatcher otherwise
+  void init(bool native = true);
   void emitDesignCreated();
   void updateDesignFileWatchers(ProjectManager *pManager);
   bool isValid() const;
+  bool isNative() const { return m_inotify != -1; }
+
+  void setFiles(const std::vector<DesignFile> &files);
+  void setSettleDelay(int delay, int maxDelay);
+  bool hasPendingChanges() const {
+    return !m_pending.empty() || m_hashing != 0;
+  }
+
+ public slots:
+  // check pending changes right away, designChanged follows once changed
+  // files are hashed
+  void flush();
 
  signals:
+  // file list or device changed
   void designFilesChanged();
+  void designChanged(const FOEDAG::DesignChangeSet &changes);
   void designCreated();
 
  private:
-  void setFiles(const QStringList &filePaths);
+  struct FileState {
+    QString fileSet;
+    DesignFile::Source source{DesignFile::Design};
+    bool exists{false};
+    QFile::Permissions permissions{};
+    qint64 size{-1};
+    QDateTime modified;
+    std::string hash;  // empty until hashed
+  };
+  using FileStates = std::vector<std::pair<QString, FileState>>;
+  static void readStat(const QString &file, FileState &state);
+  // false if the file didn't change
+  static bool compare(const FileState &state, const FileState &current,
+                      DesignFileChange::Kind &kind);
+  // files are hashed on m_hashPool, changes are reported after that if
+  // report is set. Otherwise hash is the baseline of new files, file whose
+  // stat differs from the one taken by setFiles is reported still
+  void hash(const FileStates &files, const DesignChangeSet &changes,
+            bool report);
+  void hashed(const FileStates &files, DesignChangeSet changes, bool report);
   void setDevice(const std::string &device);
+  void schedule(const QString &file);
+  void readEvents();
+  void watch();
 
  private:
-  QStringList m_watchFiles{};
+  std::map<QString, FileState> m_files;
   std::string m_device{};
+  std::set<QString> m_pending;
+  QTimer m_settleTimer;
+  QElapsedTimer m_pendingSince;
+  int m_maxSettleDelay{MaxSettleDelay};
   QFileSystemWatcher *m_fileWatcher{nullptr};
+  int m_inotify{-1};
+  QSocketNotifier *m_notifier{nullptr};
+  // inotify watch descriptor to directory, same directory could be watched
+  // by different paths
+  std::map<int, QStringList> m_directories;
+  // one thread, results come in the order of requests
+  QThreadPool m_hashPool;
+  int m_hashing{0};
 };
 
 }  // namespace FOEDAG
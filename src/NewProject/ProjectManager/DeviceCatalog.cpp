@@ -0,0 +1,273 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "DeviceCatalog.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+
+#include "Utils/FileUtils.h"
+#include "config.h"
+
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+static constexpr quint32 CacheMagic{0x46444354};  // FDCT
+// increment when DeviceRecord layout or meaning changes
+static constexpr quint32 CacheVersion{2};
+
+static QDataStream &operator<<(QDataStream &s, const std::string &str) {
+  return s << QByteArray::fromStdString(str);
+}
+
+static QDataStream &operator>>(QDataStream &s, std::string &str) {
+  QByteArray data;
+  s >> data;
+  str = data.toStdString();
+  return s;
+}
+
+static QDataStream &operator<<(QDataStream &s, const DeviceRecord &d) {
+  s << d.name << d.series << d.family << d.package << d.pinCount
+    << d.speedGrade << d.coreVoltage;
+  s << static_cast<quint32>(d.resources.size());
+  for (const auto &r : d.resources) s << r.type << r.label << r.num;
+  s << static_cast<quint32>(d.internals.size());
+  for (const auto &i : d.internals)
+    s << i.type << i.file << i.name << i.num << i.fullPath.string();
+  return s;
+}
+
+static QDataStream &operator>>(QDataStream &s, DeviceRecord &d) {
+  s >> d.name >> d.series >> d.family >> d.package >> d.pinCount >>
+      d.speedGrade >> d.coreVoltage;
+  quint32 count{0};
+  s >> count;
+  d.resources.resize(count);
+  for (auto &r : d.resources) s >> r.type >> r.label >> r.num;
+  s >> count;
+  d.internals.resize(count);
+  for (auto &i : d.internals) {
+    std::string fullPath;
+    s >> i.type >> i.file >> i.name >> i.num >> fullPath;
+    i.fullPath = fullPath;
+  }
+  return s;
+}
+
+const DeviceRecord *DeviceList::find(const std::string &name) const {
+  auto it = m_index.find(name);
+  return (it != m_index.end()) ? &m_devices.at(it->second) : nullptr;
+}
+
+void DeviceList::buildIndex() {
+  m_index.clear();
+  m_index.reserve(m_devices.size());
+  // device data used to be applied for every match, so the last one wins
+  for (size_t i = 0; i < m_devices.size(); i++)
+    m_index.insert_or_assign(m_devices.at(i).name, i);
+}
+
+DeviceCatalog *DeviceCatalog::Instance() {
+  static DeviceCatalog catalog;
+  return &catalog;
+}
+
+std::shared_ptr<const DeviceList> DeviceCatalog::load(
+    const fs::path &deviceXml, const fs::path &devicesBase,
+    std::string *error) {
+  QFileInfo info{QString::fromStdString(deviceXml.string())};
+  QFile file{info.absoluteFilePath()};
+  if (!info.exists() || !file.open(QFile::ReadOnly)) {
+    if (error) *error = "Cannot open device file: " + deviceXml.string();
+    return nullptr;
+  }
+  const std::string key =
+      info.absoluteFilePath().toStdString() + "|" + devicesBase.string();
+  const int64_t mtime = info.lastModified().toMSecsSinceEpoch();
+  const int64_t size = info.size();
+
+  std::unique_lock lock{m_lock};
+  auto it = m_entries.find(key);
+  if (it != m_entries.end() && it->second.mtime == mtime &&
+      it->second.size == size) {
+    return it->second.list;
+  }
+  lock.unlock();
+
+  std::shared_ptr<DeviceList> list = readCache(key, mtime, size, {});
+  if (!list) {
+    const QByteArray content = file.readAll();
+    const QByteArray hash =
+        QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+    // file could be touched only, content hash decides then
+    list = readCache(key, mtime, size, hash);
+    if (!list) {
+      list = parse(content, devicesBase, error);
+      if (!list) {
+        if (error) *error = "Incorrect device file: " + deviceXml.string();
+        return nullptr;
+      }
+    }
+    writeCache(key, mtime, size, hash, *list);
+  }
+
+  lock.lock();
+  m_entries[key] = {mtime, size, list};
+  return list;
+}
+
+std::shared_ptr<DeviceList> DeviceCatalog::parse(const QByteArray &content,
+                                                 const fs::path &devicesBase,
+                                                 std::string *error) {
+  auto list = std::make_shared<DeviceList>();
+  QXmlStreamReader xml{content};
+  auto attribute = [&xml](const char *name) {
+    return xml.attributes().value(QLatin1String{name}).toString().toStdString();
+  };
+  int depth{0};
+  DeviceRecord *device{nullptr};
+  while (!xml.atEnd()) {
+    switch (xml.readNext()) {
+      case QXmlStreamReader::StartElement:
+        depth++;
+        if (depth == 2) {
+          // every element of the root is a device
+          DeviceRecord &d = list->m_devices.emplace_back();
+          d.name = attribute("name");
+          d.series = attribute("series");
+          d.family = attribute("family");
+          d.package = attribute("package");
+          d.pinCount = attribute("pin_count");
+          d.speedGrade = attribute("speedgrade");
+          d.coreVoltage = attribute("core_voltage");
+          device = &d;
+        } else if (depth == 3 && device) {
+          if (xml.name() == QLatin1String{"resource"}) {
+            device->resources.push_back(
+                {attribute("type"), attribute("label"), attribute("num")});
+          } else if (xml.name() == QLatin1String{"internal"}) {
+            DeviceInternal internal{attribute("type"), attribute("file"),
+                                    attribute("name"), attribute("num"), {}};
+            if (!internal.file.empty()) {
+              // never against the current directory, the result is cached
+              const fs::path file{internal.file};
+              internal.fullPath =
+                  file.is_absolute() ? file : devicesBase / file;
+            }
+            device->internals.push_back(std::move(internal));
+          }
+        }
+        break;
+      case QXmlStreamReader::EndElement:
+        if (depth == 2) device = nullptr;
+        depth--;
+        break;
+      default:
+        break;
+    }
+  }
+  if (xml.hasError()) {
+    if (error) *error = xml.errorString().toStdString();
+    return nullptr;
+  }
+  list->buildIndex();
+  return list;
+}
+
+void DeviceCatalog::cacheDirectory(const fs::path &dir) {
+  std::scoped_lock lock{m_lock};
+  m_cacheDir = dir;
+  m_cacheDirSet = true;
+}
+
+fs::path DeviceCatalog::cacheDirectory() const {
+  std::scoped_lock lock{m_lock};
+  if (m_cacheDirSet) return m_cacheDir;
+  return Config::Instance()->userSpacePath() / "cache" / "devices";
+}
+
+void DeviceCatalog::clear() {
+  std::scoped_lock lock{m_lock};
+  m_entries.clear();
+}
+
+fs::path DeviceCatalog::cacheFile(const std::string &key) const {
+  const fs::path dir = cacheDirectory();
+  if (dir.empty()) return {};
+  const QByteArray name = QCryptographicHash::hash(
+      QByteArray::fromStdString(key), QCryptographicHash::Sha1);
+  return dir / (name.toHex().toStdString() + ".bin");
+}
+
+std::shared_ptr<DeviceList> DeviceCatalog::readCache(
+    const std::string &key, int64_t mtime, int64_t size,
+    const QByteArray &hash) const {
+  const fs::path path = cacheFile(key);
+  if (path.empty()) return nullptr;
+  QFile file{QString::fromStdString(path.string())};
+  if (!file.open(QFile::ReadOnly)) return nullptr;
+  QDataStream in{&file};
+  quint32 magic{0};
+  quint32 version{0};
+  std::string cachedKey;
+  qint64 cachedMtime{0};
+  qint64 cachedSize{0};
+  QByteArray cachedHash;
+  in >> magic >> version;
+  if (magic != CacheMagic || version != CacheVersion) return nullptr;
+  in >> cachedKey >> cachedMtime >> cachedSize >> cachedHash;
+  if (cachedKey != key) return nullptr;
+  const bool stamp = (cachedMtime == mtime) && (cachedSize == size);
+  if (!stamp && (hash.isEmpty() || hash != cachedHash)) return nullptr;
+
+  auto list = std::make_shared<DeviceList>();
+  quint32 count{0};
+  in >> count;
+  list->m_devices.resize(count);
+  for (auto &device : list->m_devices) in >> device;
+  if (in.status() != QDataStream::Ok) return nullptr;
+  list->buildIndex();
+  return list;
+}
+
+void DeviceCatalog::writeCache(const std::string &key, int64_t mtime,
+                               int64_t size, const QByteArray &hash,
+                               const DeviceList &list) const {
+  const fs::path path = cacheFile(key);
+  if (path.empty() || !FileUtils::MkDirs(path.parent_path())) return;
+  // QSaveFile writes into temporary file and renames it on commit
+  QSaveFile file{QString::fromStdString(path.string())};
+  if (!file.open(QFile::WriteOnly)) return;
+  QDataStream out{&file};
+  out << CacheMagic << CacheVersion << key << static_cast<qint64>(mtime)
+      << static_cast<qint64>(size) << hash;
+  out << static_cast<quint32>(list.m_devices.size());
+  for (const auto &device : list.m_devices) out << device;
+  file.commit();
+}
+
+}  // namespace FOEDAG
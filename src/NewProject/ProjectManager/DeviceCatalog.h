@@ -0,0 +1,130 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <QByteArray>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FOEDAG {
+
+struct DeviceResource {
+  std::string type;
+  std::string label;
+  std::string num;
+};
+
+struct DeviceInternal {
+  std::string type;
+  std::string file;
+  std::string name;
+  std::string num;
+  // relative 'file' resolved against the devices base directory, empty if no
+  // file
+  std::filesystem::path fullPath;
+};
+
+struct DeviceRecord {
+  std::string name;
+  std::string series;
+  std::string family;
+  std::string package;
+  std::string pinCount;
+  std::string speedGrade;
+  std::string coreVoltage;
+  std::vector<DeviceResource> resources;
+  std::vector<DeviceInternal> internals;
+};
+
+/*!
+ * \brief The DeviceList class
+ * All devices of one device xml file with name index.
+ */
+class DeviceList {
+ public:
+  const std::vector<DeviceRecord> &devices() const { return m_devices; }
+  // last device with given name or nullptr
+  const DeviceRecord *find(const std::string &name) const;
+
+ private:
+  friend class DeviceCatalog;
+  void buildIndex();
+
+  std::vector<DeviceRecord> m_devices;
+  std::unordered_map<std::string, size_t> m_index;
+};
+
+/*!
+ * \brief The DeviceCatalog class
+ * Parses every device xml (device.xml, local device.xml, custom_device.xml)
+ * once with streaming reader and keeps result in memory. Parsed lists are
+ * also stored in compact binary cache, keyed by file size/mtime and content
+ * hash, so next sessions don't parse xml at all.
+ */
+class DeviceCatalog {
+ public:
+  static DeviceCatalog *Instance();
+
+  /*!
+   * \brief load
+   * \param deviceXml - device xml file
+   * \param devicesBase - base directory for relative 'internal' files
+   * \param error - receives error message if return value is nullptr
+   */
+  std::shared_ptr<const DeviceList> load(
+      const std::filesystem::path &deviceXml,
+      const std::filesystem::path &devicesBase, std::string *error = nullptr);
+
+  // empty path disables persistent cache
+  void cacheDirectory(const std::filesystem::path &dir);
+  std::filesystem::path cacheDirectory() const;
+  void clear();
+
+  static std::shared_ptr<DeviceList> parse(
+      const QByteArray &content, const std::filesystem::path &devicesBase,
+      std::string *error);
+
+ private:
+  struct Entry {
+    int64_t mtime{0};
+    int64_t size{0};
+    std::shared_ptr<const DeviceList> list;
+  };
+  std::filesystem::path cacheFile(const std::string &key) const;
+  std::shared_ptr<DeviceList> readCache(const std::string &key, int64_t mtime,
+                                        int64_t size,
+                                        const QByteArray &hash) const;
+  void writeCache(const std::string &key, int64_t mtime, int64_t size,
+                  const QByteArray &hash, const DeviceList &list) const;
+
+  mutable std::mutex m_lock;
+  std::map<std::string, Entry> m_entries;
+  std::filesystem::path m_cacheDir;
+  bool m_cacheDirSet{false};
+};
+
+}  // namespace FOEDAG
@@ -1,10 +1,11 @@
 #include "config.h"
 
 #include <QDir>
-#include <QDomDocument>
 #include <QFile>
 #include <QTextStream>
 
+#include "DeviceCatalog.h"
+
 using namespace FOEDAG;
 
 Q_GLOBAL_STATIC(Config, config)
@@ -12,84 +13,54 @@ Q_GLOBAL_STATIC(Config, config)
 Config *Config::Instance() { return config(); }
 
 int Config::InitConfig(const QString &devicexml) {
-  int ret = 0;
-  QFile file(devicexml);
-  if (!file.open(QFile::ReadOnly)) {
-    return -1;
-  }
-
-  QDomDocument doc;
-  if (!doc.setContent(&file)) {
-    file.close();
-    return -2;
-  }
-  file.close();
+  const std::filesystem::path deviceFile{devicexml.toStdString()};
+  if (!QFile::exists(devicexml)) return -1;
+  auto deviceList =
+      DeviceCatalog::Instance()->load(deviceFile, deviceFile.parent_path());
+  if (!deviceList) return -2;
   m_list_device_item.clear();
 
-  QDomElement docElement = doc.documentElement();
-  QDomNode node = docElement.firstChild();
-  if (!node.isNull() && node.isElement()) {
+  const auto &devices = deviceList->devices();
+  if (!devices.empty()) {
     m_list_device_item.append("Name");
     m_list_device_item.append("Pin Count");
     m_list_device_item.append("Speed Grade");
     m_list_device_item.append("Core Voltage");
-    QDomElement e = node.toElement();
-
-    QDomNodeList list = e.childNodes();
-    for (int i = 0; i < list.count(); i++) {
-      QDomNode n = list.at(i);
-      if (!n.isNull() && n.isElement()) {
-        if (n.nodeName() == "resource") {
-          QString type = n.toElement().attribute("type");
-          QString label = n.toElement().attribute("label");
-          if (label == "") {
-            label = type;
-          }
-          m_list_device_item.append(label);
-        }
+    for (const auto &resource : devices.front().resources) {
+      QString label = QString::fromStdString(resource.label);
+      if (label == "") {
+        label = QString::fromStdString(resource.type);
       }
+      m_list_device_item.append(label);
     }
     m_list_device_item.append("Series");
     m_list_device_item.append("Family");
     m_list_device_item.append("Package");
   }
 
-  while (!node.isNull()) {
-    if (node.isElement()) {
-      QDomElement e = node.toElement();
-
-      QStringList devlist;
-      QString name = e.attribute("name");
-      devlist.append(name);
-      devlist.append(e.attribute("pin_count"));
-      devlist.append(e.attribute("speedgrade"));
-      devlist.append(e.attribute("core_voltage"));
-
-      QDomNodeList list = e.childNodes();
-      for (int i = 0; i < list.count(); i++) {
-        QDomNode n = list.at(i);
-        if (!n.isNull() && n.isElement()) {
-          if (n.nodeName() == "resource")
-            devlist.append(n.toElement().attribute("num"));
-        }
-      }
-      QString series = e.attribute("series");
-      QString family = e.attribute("family");
-      QString package = e.attribute("package");
-      devlist.append(series);
-      devlist.append(family);
-      devlist.append(package);
-
-      // adding name to avoid key collisions when there are multiple devices
-      // with the same series/family/package
-      QString key = series + family + package + "_" + name;
-      m_map_device_info.insert(key, devlist);
-      MakeDeviceMap(series, family, package);
-    }
-
-    node = node.nextSibling();
+  for (const auto &device : devices) {
+    QStringList devlist;
+    QString name = QString::fromStdString(device.name);
+    devlist.append(name);
+    devlist.append(QString::fromStdString(device.pinCount));
+    devlist.append(QString::fromStdString(device.speedGrade));
+    devlist.append(QString::fromStdString(device.coreVoltage));
+    for (const auto &resource : device.resources)
+      devlist.append(QString::fromStdString(resource.num));
+    QString series = QString::fromStdString(device.series);
+    QString family = QString::fromStdString(device.family);
+    QString package = QString::fromStdString(device.package);
+    devlist.append(series);
+    devlist.append(family);
+    devlist.append(package);
+
+    // adding name to avoid key collisions when there are multiple devices
+    // with the same series/family/package
+    QString key = series + family + package + "_" + name;
+    m_map_device_info.insert(key, devlist);
+    MakeDeviceMap(series, family, package);
   }
-  return ret;
+  return 0;
 }
 
 int Config::InitConfigs(const QStringList &devicexmlList) {
@@ -20,6 +20,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "BufferedComboBox.h"
 
+#include <QCompleter>
+#include <QLineEdit>
+#include <QStringListModel>
+
 namespace FOEDAG {
 
 BufferedComboBox::BufferedComboBox(QWidget *parent) : ComboBox(parent) {
@@ -28,8 +32,27 @@ BufferedComboBox::BufferedComboBox(QWidget *parent) : ComboBox(parent) {
 
 QString BufferedComboBox::previousText() const { return m_previousText; }
 
+void BufferedComboBox::setFilter(const Filter &filter) {
+  m_filter = filter;
+  setEditable(true);
+  if (!m_completions) {
+    m_completions = new QStringListModel{this};
+    auto completer = new QCompleter{m_completions, this};
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    setCompleter(completer);
+    connect(lineEdit(), &QLineEdit::textEdited, this,
+            &BufferedComboBox::textEdited);
+  }
+}
+
 void BufferedComboBox::textChanged(int) {
   m_previousText = m_currentText;
   m_currentText = currentText();
 }
+
+void BufferedComboBox::textEdited(const QString &text) {
+  // line edit shows completer popup right after this
+  if (m_filter) m_completions->setStringList(m_filter(text));
+}
 }  // namespace FOEDAG
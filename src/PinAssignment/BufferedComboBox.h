@@ -20,8 +20,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <functional>
+
 #include "ComboBox.h"
 
+class QStringListModel;
+
 namespace FOEDAG {
 
 /*!
@@ -32,15 +36,27 @@ namespace FOEDAG {
 class BufferedComboBox : public ComboBox {
   Q_OBJECT
  public:
+  using Filter = std::function<QStringList(const QString &)>;
   explicit BufferedComboBox(QWidget *parent = nullptr);
   QString previousText() const;
 
+  /*!
+   * \brief setFilter
+   * Makes combo box editable. Completion popup shows items returned by
+   * \a filter for typed text instead of searching the whole item list.
+   * Call it after setModel(), which resets completer model.
+   */
+  void setFilter(const Filter &filter);
+
  private slots:
   void textChanged(int);
+  void textEdited(const QString &text);
 
  private:
   QString m_previousText;
   QString m_currentText;
+  Filter m_filter;
+  QStringListModel *m_completions{nullptr};
 };
 
 }  // namespace FOEDAG
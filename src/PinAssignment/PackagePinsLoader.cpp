@@ -36,32 +36,34 @@ std::pair<bool, QString> PackagePinsLoader::load(const QString &fileName) {
   const auto &[success, content] = getFileContent(fileName);
   if (!success) return std::make_pair(success, content);
 
-  InternalPins &internalPins = m_model->internalPinsRef();
+  PinTable &table = m_model->pinTable();
+  table.clear();
   QStringList lines = QtUtils::StringSplit(content, '\n');
   parseHeader(lines.takeFirst());
   PackagePinGroup group{};
-  QSet<QString> uniquePins;
+  QSet<int> uniquePins;
+  std::vector<QStringView> fields;
   for (const auto &line : lines) {
-    QStringList data = line.split(",");
-    if (!data.first().isEmpty()) {
-      if (!group.name.isEmpty() && (group.name != data.first())) {
+    // split into views, strings are created for user groups only
+    fields.clear();
+    for (const auto &field : QStringView{line}.split(u','))
+      fields.push_back(field);
+    if (!fields.front().isEmpty()) {
+      if (!group.name.isEmpty() && (group.name != fields.front())) {
         if (m_model->userGroups().contains(group.name)) m_model->append(group);
         group.pinData.clear();
         uniquePins.clear();
       }
-      group.name = data.first();
+      group.name = fields.front().toString();
     }
-    data.pop_front();
-    // internal pins parsing
-    for (int i = ModeFirst; (i <= ModeLast) && (i < data.count()); i++) {
-      if (data.at(i) == "Y") {
-        internalPins[data.at(BallName)][i].append(data.at(InternalPinName));
-        m_model->insertBallData(data.at(BallName), data.at(BallId));
-      }
-    }
-    // -------------
-    if (uniquePins.contains(data.at(BallName))) continue;
-    uniquePins.insert(data.at(BallName));
+    fields.erase(fields.begin());
+    const int ball = table.addLine(fields);
+    if (ball == PinTable::NoBall || uniquePins.contains(ball)) continue;
+    uniquePins.insert(ball);
+    if (!m_model->userGroups().contains(group.name)) continue;
+    QStringList data;
+    data.reserve(static_cast<int>(fields.size()));
+    for (const auto &field : fields) data.append(field.toString());
     group.pinData.append({data});
   }
   if (m_model->userGroups().contains(group.name))
@@ -65,12 +65,15 @@ void PackagePinsModel::insertMode(int id, const QString &mode) {
   m_modes.insert(mode, id);
 }
 
-InternalPins &PackagePinsModel::internalPinsRef() { return m_internalPinsData; }
+PinTable &PackagePinsModel::pinTable() { return m_pinTable; }
+
+const PinTable &PackagePinsModel::pinTable() const { return m_pinTable; }
 
 QStringList PackagePinsModel::GetInternalPinsList(
     const QString &pin, const QString &mode, const QString &current) const {
-  int modeId = m_modes.value(mode);
-  auto v = m_internalPinsData.value(convertPinName(pin)).value(modeId);
+  const int ball = useBallId() ? m_pinTable.ballById(pin)
+                               : m_pinTable.ballByName(pin);
+  auto v = m_pinTable.internalPins(ball, m_modes.value(mode));
   if (m_baseModel) {
     const auto ports = m_baseModel->getPort(pin);
     for (const auto &p : ports) {
@@ -82,17 +85,23 @@ QStringList PackagePinsModel::GetInternalPinsList(
 }
 
 int PackagePinsModel::internalPinMax() const {
-  qsizetype max{0};
-  for (const auto &modes : m_internalPinsData) {
-    for (const auto &intPins : modes) {
-      max = std::max(max, intPins.count());
+  return m_pinTable.internalPinMax();
+}
+
+void PackagePinsModel::append(const PackagePinGroup &g) {
+  m_pinData.append(g);
+  std::vector<QStringView> fields;
+  for (const auto &pin : g.pinData) {
+    int ball = m_pinTable.ballByName(pin.data.value(BallName));
+    if (ball == PinTable::NoBall) {
+      // pins which are not loaded by PackagePinsLoader
+      fields.assign(pin.data.cbegin(), pin.data.cend());
+      ball = m_pinTable.addLine(fields);
     }
+    m_listBalls.push_back(ball);
   }
-  return static_cast<int>(max);
 }
 
-void PackagePinsModel::append(const PackagePinGroup &g) { m_pinData.append(g); }
-
 const QVector<PackagePinGroup> &PackagePinsModel::pinData() const {
   return m_pinData;
 }
@@ -107,6 +116,14 @@ QString PackagePinsModel::internalPin(const QString &port) const {
 
 QStringListModel *PackagePinsModel::listModel() const { return m_listModel; }
 
+QStringList PackagePinsModel::filter(const QString &text) {
+  const int column = useBallId() ? BallId : BallName;
+  QStringList pins;
+  for (int ball : m_pinFilter.setText(text))
+    pins.append(m_pinTable.value(ball, column));
+  return pins;
+}
+
 QStringListModel *PackagePinsModel::modeModelTx() const {
   return m_modeModelTx;
 }
@@ -124,6 +141,8 @@ void PackagePinsModel::initListModel() {
     }
   }
   m_listModel->setStringList(pinsList);
+  m_pinFilter = PinFilter{&m_pinTable, useBallId() ? BallId : BallName, -1,
+                          &m_listBalls};
 }
 
 const QVector<QString> &PackagePinsModel::userGroups() const {
@@ -148,27 +167,13 @@ bool PackagePinsModel::useBallId() const { return m_useBallId; }
 
 QString PackagePinsModel::convertPinName(const QString &name) const {
   if (!useBallId()) return name;
-  return m_ballData.value(name);
+  return m_pinTable.value(m_pinTable.ballById(name), BallName);
 }
 
-void PackagePinsModel::insertBallData(const QString &name, const QString &id) {
-  m_ballData[id] = name;
-}
-
-QString PackagePinsModel::convertPinNameUsage(const QString &nameOrId) {
-  auto iter = m_ballData.cbegin();
-  while (iter != m_ballData.cend()) {
-    if (iter.key() == nameOrId) {  // ball id detected
-      if (useBallId()) return nameOrId;
-      return iter.value();
-    }
-    if (iter.value() == nameOrId) {  // ball name detected
-      if (useBallId()) return iter.key();
-      return nameOrId;
-    }
-    iter++;
-  }
-  return QString{};
+QString PackagePinsModel::convertPinNameUsage(const QString &nameOrId) const {
+  int ball = m_pinTable.ballById(nameOrId);  // ball id detected
+  if (ball == PinTable::NoBall) ball = m_pinTable.ballByName(nameOrId);
+  return m_pinTable.value(ball, useBallId() ? BallId : BallName);
 }
 
 }  // namespace FOEDAG
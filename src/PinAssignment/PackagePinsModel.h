@@ -24,28 +24,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QStringListModel>
 #include <QVector>
 
-namespace FOEDAG {
+#include "PinTable.h"
 
-enum PinData {
-  PinName = 0,
-  BallName = 1,
-  BallId = 2,
-  InternalPinName = 12,
-  ModeFirst = 13,
-  ModeLast = 46,
-  RefClock = 57,
-  Bank = 58,
-  ALT = 59,
-  DebugMode = 60,
-  ScanMode = 61,
-  MbistMode = 62,
-  Type = 63,
-  Dir = 64,
-  Voltage = 65,
-  PowerPad = 66,
-  Discription = 67,
-  Voltage2 = 68,
-};
+namespace FOEDAG {
 
 struct PackagePinData {
   QStringList data;
@@ -63,8 +44,6 @@ struct HeaderData {
   bool visible;
 };
 
-using BallData = QMap<QString, QString>;  // <id, name>
-using InternalPins = QMap<QString, QMap<int, QStringList>>;
 class PinsBaseModel;
 class PackagePinsModel : public QObject {
   Q_OBJECT
@@ -76,7 +55,8 @@ class PackagePinsModel : public QObject {
   QString getMode(const QString &pin) const;
   void updateInternalPin(const QString &port, const QString &intPin);
   void insertMode(int id, const QString &mode);
-  InternalPins &internalPinsRef();
+  PinTable &pinTable();
+  const PinTable &pinTable() const;
   QStringList GetInternalPinsList(const QString &pin, const QString &mode,
                                   const QString &current = QString{}) const;
   int internalPinMax() const;
@@ -87,6 +67,8 @@ class PackagePinsModel : public QObject {
   QString internalPin(const QString &port) const;
 
   QStringListModel *listModel() const;
+  // pins of list model which contain text, incremental while typing
+  QStringList filter(const QString &text);
   QStringListModel *modeModelTx() const;
   QStringListModel *modeModelRx() const;
   void initListModel();
@@ -104,8 +86,7 @@ class PackagePinsModel : public QObject {
   bool useBallId() const;
 
   QString convertPinName(const QString &name) const;
-  void insertBallData(const QString &name, const QString &id);
-  QString convertPinNameUsage(const QString &nameOrId);
+  QString convertPinNameUsage(const QString &nameOrId) const;
 
  signals:
   void modeHasChanged(const QString &pin, const QString &mode);
@@ -122,10 +103,11 @@ class PackagePinsModel : public QObject {
   QMap<QString, QString> m_modeMap;
   QMap<QString, QString> m_internalPinMap;
   QMap<QString, int> m_modes;
-  InternalPins m_internalPinsData;  // <PinName, <ModeId, InternalPins>>
+  PinTable m_pinTable;
+  std::vector<int> m_listBalls;
+  PinFilter m_pinFilter{&m_pinTable, BallName, -1, &m_listBalls};
   PinsBaseModel *m_baseModel;
   bool m_useBallId{false};
-  BallData m_ballData;
 };
 
 }  // namespace FOEDAG
@@ -20,7 +20,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "PackagePinsView.h"
 
-#include <QCompleter>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QLabel>
@@ -312,10 +311,9 @@ void PackagePinsView::initLine(QTreeWidgetItem *item) {
   auto combo = new BufferedComboBox;
   combo->setModel(m_model->portsModel()->listModel());
   combo->setAutoFillBackground(true);
-  combo->setEditable(true);
-  auto completer{new QCompleter{m_model->portsModel()->listModel()}};
-  completer->setFilterMode(Qt::MatchContains);
-  combo->setCompleter(completer);
+  combo->setFilter([model = m_model->portsModel()](const QString &text) {
+    return model->filter(text);
+  });
   combo->setInsertPolicy(QComboBox::NoInsert);
   connect(combo, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
           [=]() { ioPortsSelectionHasChanged(indexFromItem(item, PortsCol)); });
@@ -0,0 +1,223 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "PinTable.h"
+
+#include <algorithm>
+
+namespace FOEDAG {
+
+static constexpr int ModeCount{ModeLast - ModeFirst + 1};
+
+static bool testBit(const std::vector<quint64> &bits, int index) {
+  const size_t word = static_cast<size_t>(index) / 64;
+  return word < bits.size() && (bits[word] >> (index % 64)) & 1u;
+}
+
+static void setBit(std::vector<quint64> &bits, int index) {
+  const size_t word = static_cast<size_t>(index) / 64;
+  if (word >= bits.size()) bits.resize(word + 1);
+  bits[word] |= quint64{1} << (index % 64);
+}
+
+PinTable::PinTable(int keyColumn, int idColumn)
+    : m_keyColumn(keyColumn), m_idColumn(idColumn) {
+  clear();
+}
+
+void PinTable::clear() {
+  m_strings.clear();
+  m_stringIds.clear();
+  m_columns.clear();
+  m_ballCount = 0;
+  m_ballsByName.clear();
+  m_ballsById.clear();
+  m_modeBalls.assign(ModeCount, {});
+  m_internalPins.clear();
+  m_internalPinMax = 0;
+  intern(QStringView{});  // empty string has id 0
+}
+
+int PinTable::intern(QStringView str) {
+  const QString value = str.toString();
+  auto it = m_stringIds.constFind(value);
+  if (it != m_stringIds.cend()) return it.value();
+  const int id = m_strings.size();
+  m_strings.append(value);
+  m_stringIds.insert(value, id);
+  return id;
+}
+
+quint64 PinTable::key(int ball, int mode) {
+  return (static_cast<quint64>(ball) << 32) | static_cast<quint32>(mode);
+}
+
+bool PinTable::isMode(int column) {
+  return column >= ModeFirst && column <= ModeLast;
+}
+
+int PinTable::addLine(const std::vector<QStringView> &fields) {
+  const int last = std::max(m_keyColumn, m_idColumn);
+  if (static_cast<int>(fields.size()) <= last) return NoBall;
+  const int name = intern(fields[m_keyColumn]);
+  int ball = m_ballsByName.value(name, NoBall);
+  if (ball == NoBall) {
+    ball = m_ballCount++;
+    m_ballsByName.insert(name, ball);
+    if (m_columns.size() < fields.size()) {
+      m_columns.resize(fields.size());
+      for (auto &column : m_columns) column.resize(ball, 0);
+    }
+    for (size_t column = 0; column < m_columns.size(); column++) {
+      m_columns[column].push_back(
+          column < fields.size() ? intern(fields[column]) : 0);
+    }
+    if (m_idColumn != NoColumn && !fields[m_idColumn].isEmpty())
+      m_ballsById.insert(intern(fields[m_idColumn]), ball);
+  }
+  const int lastMode =
+      std::min(static_cast<int>(fields.size()) - 1, ModeLast);
+  for (int mode = ModeFirst; mode <= lastMode; mode++) {
+    if (fields[mode] != QLatin1String{"Y"}) continue;
+    setBit(m_modeBalls[mode - ModeFirst], ball);
+    auto &pins = m_internalPins[key(ball, mode)];
+    pins.push_back(intern(fields[InternalPinName]));
+    m_internalPinMax =
+        std::max(m_internalPinMax, static_cast<int>(pins.size()));
+  }
+  return ball;
+}
+
+int PinTable::ballByName(const QString &name) const {
+  const int id = m_stringIds.value(name, -1);
+  return (id == -1) ? NoBall : m_ballsByName.value(id, NoBall);
+}
+
+int PinTable::ballById(const QString &id) const {
+  const int stringId = m_stringIds.value(id, -1);
+  return (stringId == -1) ? NoBall : m_ballsById.value(stringId, NoBall);
+}
+
+QString PinTable::value(int ball, int column) const {
+  if (ball < 0 || ball >= m_ballCount || column < 0 ||
+      column >= static_cast<int>(m_columns.size()))
+    return {};
+  return m_strings.at(m_columns[column][ball]);
+}
+
+QStringList PinTable::row(int ball) const {
+  QStringList values;
+  values.reserve(static_cast<int>(m_columns.size()));
+  for (int column = 0; column < static_cast<int>(m_columns.size()); column++)
+    values.append(value(ball, column));
+  return values;
+}
+
+bool PinTable::available(int ball, int mode) const {
+  return isMode(mode) && testBit(m_modeBalls[mode - ModeFirst], ball);
+}
+
+const std::vector<quint64> &PinTable::modeBalls(int mode) const {
+  static const std::vector<quint64> empty;
+  return isMode(mode) ? m_modeBalls[mode - ModeFirst] : empty;
+}
+
+QStringList PinTable::internalPins(int ball, int mode) const {
+  QStringList pins;
+  auto it = m_internalPins.constFind(key(ball, mode));
+  if (it == m_internalPins.cend()) return pins;
+  for (int id : it.value()) pins.append(m_strings.at(id));
+  return pins;
+}
+
+std::vector<int> PinTable::filter(const QString &text, int column, int mode,
+                                  const std::vector<int> *within) const {
+  std::vector<int> result;
+  if (column < 0 || column >= static_cast<int>(m_columns.size())) return result;
+  const std::vector<int> &values = m_columns[column];
+  // every distinct value is compared once
+  std::vector<signed char> matches(m_strings.size(), -1);
+  auto check = [&](int ball) {
+    if (mode != -1 && !available(ball, mode)) return;
+    signed char &match = matches[values[ball]];
+    if (match == -1)
+      match = m_strings.at(values[ball]).contains(text, Qt::CaseInsensitive);
+    if (match) result.push_back(ball);
+  };
+  if (within) {
+    for (int ball : *within) check(ball);
+  } else {
+    for (int ball = 0; ball < m_ballCount; ball++) check(ball);
+  }
+  return result;
+}
+
+QStringList PinTable::validate(const QVector<Assignment> &assignments,
+                               bool useBallId) const {
+  QStringList errors;
+  std::vector<quint64> used;
+  for (const auto &assignment : assignments) {
+    const int ball = useBallId ? ballById(assignment.pin)
+                               : ballByName(assignment.pin);
+    if (ball == NoBall) {
+      errors.append(QString{"Unknown pin %1"}.arg(assignment.pin));
+      continue;
+    }
+    if (testBit(used, ball)) {
+      errors.append(QString{"Pin %1 is assigned more than once"}.arg(
+          assignment.pin));
+      continue;
+    }
+    setBit(used, ball);
+    if (assignment.mode == -1) continue;
+    if (!available(ball, assignment.mode)) {
+      errors.append(QString{"Pin %1 is not available in mode %2"}.arg(
+          assignment.pin, QString::number(assignment.mode)));
+      continue;
+    }
+    if (assignment.internalPin.isEmpty()) continue;
+    const int internalPin = m_stringIds.value(assignment.internalPin, -1);
+    auto pins = m_internalPins.constFind(key(ball, assignment.mode));
+    if (pins == m_internalPins.cend() ||
+        std::find(pins->cbegin(), pins->cend(), internalPin) == pins->cend()) {
+      errors.append(QString{"Internal pin %1 is not available on pin %2"}.arg(
+          assignment.internalPin, assignment.pin));
+    }
+  }
+  return errors;
+}
+
+PinFilter::PinFilter(const PinTable *table, int column, int mode,
+                     const std::vector<int> *balls)
+    : m_table(table), m_column(column), m_mode(mode), m_balls(balls) {}
+
+const std::vector<int> &PinFilter::setText(const QString &text) {
+  if (m_valid && text == m_text) return m_result;
+  // longer text can only match subset of previous result
+  const bool narrow =
+      m_valid && text.startsWith(m_text, Qt::CaseInsensitive);
+  m_result = m_table->filter(text, m_column, m_mode,
+                             narrow ? &m_result : m_balls);
+  m_text = text;
+  m_valid = true;
+  return m_result;
+}
+
+}  // namespace FOEDAG
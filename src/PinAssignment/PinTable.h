@@ -0,0 +1,153 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+
+namespace FOEDAG {
+
+enum PinData {
+  PinName = 0,
+  BallName = 1,
+  BallId = 2,
+  InternalPinName = 12,
+  ModeFirst = 13,
+  ModeLast = 46,
+  RefClock = 57,
+  Bank = 58,
+  ALT = 59,
+  DebugMode = 60,
+  ScanMode = 61,
+  MbistMode = 62,
+  Type = 63,
+  Dir = 64,
+  Voltage = 65,
+  PowerPad = 66,
+  Discription = 67,
+  Voltage2 = 68,
+};
+
+/*!
+ * \brief The PinTable class
+ * Columnar storage of package pins. Every ball is one row, every csv column is
+ * a vector of interned string ids. Availability of balls in every mode is kept
+ * as bitset and internal pins are kept per ball and mode, so lookups, mode
+ * checks and assignment validation don't depend on package size.
+ * Rows are looked up by \a keyColumn and \a idColumn, so the same table
+ * indexes design ports too.
+ */
+class PinTable {
+ public:
+  static constexpr int NoBall{-1};
+  static constexpr int NoColumn{-1};
+
+  struct Assignment {
+    QString pin;
+    int mode{-1};  // mode column, -1 if no mode is set
+    QString internalPin;
+  };
+
+  explicit PinTable(int keyColumn = BallName, int idColumn = BallId);
+  void clear();
+
+  /*!
+   * \brief addLine
+   * Adds csv line without group column. Line of ball which is already in the
+   * table adds modes and internal pins only. Returns ball index or NoBall if
+   * line is too short.
+   */
+  int addLine(const std::vector<QStringView> &fields);
+
+  int ballCount() const { return m_ballCount; }
+  int ballByName(const QString &name) const;
+  int ballById(const QString &id) const;
+  QString value(int ball, int column) const;
+  QStringList row(int ball) const;
+
+  bool available(int ball, int mode) const;
+  // bit per ball, set if ball is available in the mode
+  const std::vector<quint64> &modeBalls(int mode) const;
+  QStringList internalPins(int ball, int mode) const;
+  int internalPinMax() const { return m_internalPinMax; }
+
+  /*!
+   * \brief filter
+   * Balls which \a column contains \a text, case insensitive. Only balls from
+   * \a within are checked if it is set, and only balls available in \a mode
+   * if mode is not -1.
+   */
+  std::vector<int> filter(const QString &text, int column, int mode = -1,
+                          const std::vector<int> *within = nullptr) const;
+
+  /*!
+   * \brief validate
+   * Checks that every pin exists, is assigned once and is available in its
+   * mode with given internal pin. Returns error for every wrong assignment.
+   */
+  QStringList validate(const QVector<Assignment> &assignments,
+                       bool useBallId = false) const;
+
+ private:
+  int intern(QStringView str);
+  static quint64 key(int ball, int mode);
+  static bool isMode(int column);
+
+  QVector<QString> m_strings;
+  QHash<QString, int> m_stringIds;
+  std::vector<std::vector<int>> m_columns;
+  int m_ballCount{0};
+  QHash<int, int> m_ballsByName;  // string id, ball
+  QHash<int, int> m_ballsById;    // string id, ball
+  int m_keyColumn;
+  int m_idColumn;
+  std::vector<std::vector<quint64>> m_modeBalls;
+  QHash<quint64, std::vector<int>> m_internalPins;
+  int m_internalPinMax{0};
+};
+
+/*!
+ * \brief The PinFilter class
+ * Incremental filter over PinTable. When new text extends previous one only
+ * previous result is checked. If \a balls is set only these balls are
+ * filtered, in their order.
+ */
+class PinFilter {
+ public:
+  PinFilter(const PinTable *table, int column, int mode = -1,
+            const std::vector<int> *balls = nullptr);
+  const std::vector<int> &setText(const QString &text);
+  const std::vector<int> &result() const { return m_result; }
+
+ private:
+  const PinTable *m_table;
+  int m_column;
+  int m_mode;
+  const std::vector<int> *m_balls;
+  QString m_text;
+  std::vector<int> m_result;
+  bool m_valid{false};
+};
+
+}  // namespace FOEDAG
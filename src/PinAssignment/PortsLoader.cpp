@@ -54,35 +54,32 @@ std::pair<bool, QString> PortsLoader::load(const QString &file) {
       const auto range = it->at("range");
       const int msb = range["msb"];
       const int lsb = range["lsb"];
+      const QString name = QString::fromStdString(it->at("name"));
+      const QString dir = QString::fromStdString(it->at("direction"));
+      const QString type = QString::fromStdString(it->at("type"));
+      const QString rangeStr =
+          QString("Msb: %1, lsb: %2")
+              .arg(QString::number(msb), QString::number(lsb));
 
-      IOPort ioport{QString::fromStdString(it->at("name")),
-                    QString::fromStdString(it->at("direction")),
-                    QString(),
-                    QString::fromStdString(it->at("type")),
-                    QString("Msb: %1, lsb: %2")
-                        .arg(QString::number(msb), QString::number(lsb)),
-                    (msb != lsb),
-                    {}};
+      IOPort ioport{name, dir, QString(), type, rangeStr, (msb != lsb), {}};
       if (ioport.isBus) {
         const int step = msb > lsb ? -1 : 1;
         const int end = lsb + step;
         ioport.ports.reserve(std::abs(msb - lsb) + 1);
         for (int i{msb}; i != end; i += step) {
-          const IOPort port{
-              QString("%1[%2]").arg(QString::fromStdString(it->at("name")),
-                                    QString::number(i)),
-              QString::fromStdString(it->at("direction")),
-              QString(),
-              QString::fromStdString(it->at("type")),
-              QString("Msb: %1, lsb: %2")
-                  .arg(QString::number(msb), QString::number(lsb)),
-              false,
-              {}};
+          const IOPort port{QString("%1[%2]").arg(name, QString::number(i)),
+                            dir,
+                            QString(),
+                            type,
+                            rangeStr,
+                            false,
+                            {}};
           ioport.ports.append(port);
         }
       }
       group.ports.append(ioport);
     }
+    // ports are indexed for Pin Planner filters here
     m_model->append(group);
   }
   m_model->initListModel();
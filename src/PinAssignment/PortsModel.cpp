@@ -29,7 +29,20 @@ QStringList PortsModel::headerList() const {
   return {"Name", "Dir", "Package Pin", "Mode", "Internal pins", "Type"};
 }
 
-void PortsModel::append(const IOPortGroup &p) { m_ioPorts.append(p); }
+void PortsModel::append(const IOPortGroup &p) {
+  m_ioPorts.append(p);
+  for (const auto &port : p.ports) {
+    if (port.isBus) {
+      for (const auto &sub : port.ports) index(sub);
+    } else {
+      index(port);
+    }
+  }
+}
+
+void PortsModel::index(const IOPort &port) {
+  m_portTable.addLine({port.name});
+}
 
 const QVector<IOPortGroup> &PortsModel::ports() const { return m_ioPorts; }
 
@@ -45,6 +58,7 @@ void PortsModel::initListModel() {
       }
     };
   m_model->setStringList(portsList);
+  m_portFilter = PinFilter{&m_portTable, 0};
 }
 
 IOPort PortsModel::GetPort(const QString &portName) const {
@@ -68,4 +82,13 @@ IOPort PortsModel::GetPort(const QString &portName) const {
 
 QStringListModel *PortsModel::listModel() const { return m_model; }
 
+QStringList PortsModel::filter(const QString &text) {
+  QStringList ports;
+  for (int port : m_portFilter.setText(text))
+    ports.append(m_portTable.value(port, 0));
+  return ports;
+}
+
+const PinTable &PortsModel::portTable() const { return m_portTable; }
+
 }  // namespace FOEDAG
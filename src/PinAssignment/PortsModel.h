@@ -25,6 +25,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QStringListModel>
 #include <QVector>
 
+#include "PinTable.h"
+
 namespace FOEDAG {
 
 struct IOPort {
@@ -53,10 +55,18 @@ class PortsModel : public QObject {
   IOPort GetPort(const QString &portName) const;
 
   QStringListModel *listModel() const;
+  // ports of list model which contain text, incremental while typing
+  QStringList filter(const QString &text);
+  const PinTable &portTable() const;
 
  private:
+  void index(const IOPort &port);
+
   QVector<IOPortGroup> m_ioPorts;
   QStringListModel *m_model;
+  // one row per port name, bus ports are indexed by their bits
+  PinTable m_portTable{0, PinTable::NoColumn};
+  PinFilter m_portFilter{&m_portTable, 0};
 };
 
 }  // namespace FOEDAG
@@ -20,7 +20,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "PortsView.h"
 
-#include <QCompleter>
 #include <QHeaderView>
 #include <QStringListModel>
 
@@ -129,10 +128,9 @@ void PortsView::insertTableItem(QTreeWidgetItem *parent, const IOPort &port) {
   auto combo = new BufferedComboBox{this};
   combo->setModel(m_model->packagePinModel()->listModel());
   combo->setAutoFillBackground(true);
-  combo->setEditable(true);
-  auto completer{new QCompleter{m_model->packagePinModel()->listModel()}};
-  completer->setFilterMode(Qt::MatchContains);
-  combo->setCompleter(completer);
+  combo->setFilter([model = m_model->packagePinModel()](const QString &text) {
+    return model->filter(text);
+  });
   combo->setInsertPolicy(QComboBox::NoInsert);
   connect(combo, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
           [=]() {
@@ -0,0 +1,187 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "HierarchyIndex.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "Utils/StringUtils.h"
+#include "nlohmann_json/json.hpp"
+
+namespace FOEDAG {
+
+// search stops after that many instances to keep it responsive for huge trees
+static constexpr size_t MaxVisited{10000000};
+
+static std::string toLower(std::string str) {
+  std::transform(str.begin(), str.end(), str.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return str;
+}
+
+std::shared_ptr<HierarchyIndex> HierarchyIndex::parse(
+    const std::string &content, const std::filesystem::path &base,
+    std::string *error) {
+  auto index = std::make_shared<HierarchyIndex>();
+  try {
+    const nlohmann::json root = nlohmann::json::parse(content);
+    std::unordered_map<int, uint32_t> fileIds;
+    for (const auto &[key, value] : root.at("fileIDs").items()) {
+      const auto &[id, ok] = StringUtils::to_number<int>(key);
+      if (!ok) continue;
+      auto file = std::filesystem::path{value.get<std::string>()};
+      if (file.is_relative()) file = (base / file).lexically_normal();
+      fileIds[id] = static_cast<uint32_t>(index->m_files.size());
+      index->m_files.push_back(file.string());
+    }
+    auto fileOf = [&fileIds](const nlohmann::json &object) -> uint32_t {
+      auto file = object.find("file");
+      if (file == object.end()) return None;
+      int id{0};
+      if (file->is_number_integer()) {
+        id = file->get<int>();
+      } else {
+        const auto &[number, ok] =
+            StringUtils::to_number<int>(file->get<std::string>());
+        if (!ok) return None;
+        id = number;
+      }
+      auto it = fileIds.find(id);
+      return (it != fileIds.end()) ? it->second : None;
+    };
+    auto addModule = [&index, &fileOf](uint32_t name,
+                                       const nlohmann::json &object) {
+      ModuleDef def{name, fileOf(object), object.value("line", 0),
+                    static_cast<uint32_t>(index->m_instances.size()), 0};
+      auto instances = object.find("moduleInsts");
+      if (instances != object.end()) {
+        for (const auto &inst : *instances) {
+          index->m_instances.push_back(
+              {index->intern(inst.at("instName").get<std::string>()),
+               index->intern(inst.at("module").get<std::string>()),
+               fileOf(inst), inst.value("line", 0)});
+        }
+      }
+      def.instanceCount =
+          static_cast<uint32_t>(index->m_instances.size()) - def.firstInstance;
+      index->m_modules.push_back(def);
+      return static_cast<uint32_t>(index->m_modules.size() - 1);
+    };
+
+    for (const auto &[key, value] : root.at("modules").items()) {
+      const uint32_t name = index->intern(key);
+      index->m_definitions.emplace(name, addModule(name, value));
+    }
+    for (const auto &top : root.at("hierTree")) {
+      const uint32_t name =
+          index->intern(top.at("topModule").get<std::string>());
+      index->m_tops.push_back(addModule(name, top));
+    }
+  } catch (std::exception &e) {
+    if (error) *error = e.what();
+    return nullptr;
+  }
+  return index;
+}
+
+uint32_t HierarchyIndex::intern(const std::string &name) {
+  auto [it, inserted] =
+      m_nameIds.emplace(name, static_cast<uint32_t>(m_names.size()));
+  if (inserted) m_names.push_back(name);
+  return it->second;
+}
+
+const std::string &HierarchyIndex::name(uint32_t id) const {
+  static const std::string empty;
+  return (id < m_names.size()) ? m_names[id] : empty;
+}
+
+const std::string &HierarchyIndex::file(uint32_t id) const {
+  static const std::string empty;
+  return (id < m_files.size()) ? m_files[id] : empty;
+}
+
+const HierarchyIndex::Instance &HierarchyIndex::instance(uint32_t def,
+                                                         uint32_t row) const {
+  return m_instances.at(m_modules.at(def).firstInstance + row);
+}
+
+uint32_t HierarchyIndex::definition(uint32_t moduleName) const {
+  auto it = m_definitions.find(moduleName);
+  return (it != m_definitions.end()) ? it->second : None;
+}
+
+uint32_t HierarchyIndex::definition(const Instance &instance) const {
+  return definition(instance.module);
+}
+
+std::vector<std::vector<uint32_t>> HierarchyIndex::find(
+    const std::string &text, size_t maxResults) const {
+  std::vector<std::vector<uint32_t>> results;
+  if (text.empty()) return results;
+  // every name is compared once, tree walk checks flags only
+  const std::string lower = toLower(text);
+  std::vector<bool> matches(m_names.size());
+  for (size_t i = 0; i < m_names.size(); i++)
+    matches[i] = toLower(m_names[i]).find(lower) != std::string::npos;
+
+  struct Frame {
+    uint32_t def;
+    uint32_t next;
+  };
+  std::vector<bool> onPath(m_modules.size());
+  std::vector<Frame> stack;
+  std::vector<uint32_t> path;
+  size_t visited{0};
+  for (uint32_t top = 0; top < m_tops.size(); top++) {
+    path = {top};
+    stack = {{m_tops[top], 0}};
+    onPath[m_tops[top]] = true;
+    if (matches[m_modules[m_tops[top]].name]) results.push_back(path);
+    while (!stack.empty()) {
+      Frame &frame = stack.back();
+      const ModuleDef &def = m_modules[frame.def];
+      if (frame.next == def.instanceCount || results.size() >= maxResults ||
+          visited >= MaxVisited) {
+        onPath[frame.def] = false;
+        stack.pop_back();
+        path.pop_back();
+        continue;
+      }
+      const uint32_t row = frame.next++;
+      const Instance &inst = m_instances[def.firstInstance + row];
+      visited++;
+      path.push_back(row);
+      if (matches[inst.name] || matches[inst.module]) results.push_back(path);
+      const uint32_t child = definition(inst);
+      if (child != None && !onPath[child]) {
+        onPath[child] = true;
+        stack.push_back({child, 0});
+      } else {
+        path.pop_back();
+      }
+    }
+    if (results.size() >= maxResults) break;
+  }
+  return results;
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,108 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The HierarchyIndex class
+ * Compact form of hier_info.json. Every module is stored once with its
+ * instances in one array and all names are interned, so the index is small
+ * even for designs with many instances. Instance tree is never built, it is
+ * walked through module definitions: children of an instance are the
+ * instances of its module.
+ */
+class HierarchyIndex {
+ public:
+  static constexpr uint32_t None{UINT32_MAX};
+
+  struct Instance {
+    uint32_t name{None};
+    uint32_t module{None};  // module name
+    // instantiation place
+    uint32_t file{None};
+    int line{0};
+  };
+
+  struct ModuleDef {
+    uint32_t name{None};
+    uint32_t file{None};
+    int line{0};
+    uint32_t firstInstance{0};
+    uint32_t instanceCount{0};
+  };
+
+  /*!
+   * \brief parse
+   * \param content - hier_info.json content
+   * \param base - base directory for relative file names
+   * \param error - receives error message if return value is nullptr
+   */
+  static std::shared_ptr<HierarchyIndex> parse(
+      const std::string &content, const std::filesystem::path &base,
+      std::string *error = nullptr);
+
+  const std::string &name(uint32_t id) const;
+  // empty string for unknown file
+  const std::string &file(uint32_t id) const;
+
+  // top modules are definitions too, with instances from 'hierTree'
+  const std::vector<uint32_t> &tops() const { return m_tops; }
+  const ModuleDef &module(uint32_t def) const { return m_modules.at(def); }
+  const Instance &instance(uint32_t def, uint32_t row) const;
+  // definition of module with given name, None if module is unknown
+  uint32_t definition(uint32_t moduleName) const;
+  // definition which instance children come from
+  uint32_t definition(const Instance &instance) const;
+
+  size_t moduleCount() const { return m_modules.size(); }
+  size_t instanceCount() const { return m_instances.size(); }
+
+  /*!
+   * \brief find
+   * Instances, which name or module name contains \a text (case insensitive),
+   * in tree order. Every result is a path of rows starting with top row.
+   * Recursive instantiation is not followed.
+   */
+  std::vector<std::vector<uint32_t>> find(const std::string &text,
+                                          size_t maxResults = 1000) const;
+
+ private:
+  uint32_t intern(const std::string &name);
+
+  std::vector<std::string> m_names;
+  std::unordered_map<std::string, uint32_t> m_nameIds;
+  std::vector<std::string> m_files;
+  std::vector<ModuleDef> m_modules;
+  std::vector<Instance> m_instances;
+  std::vector<uint32_t> m_tops;
+  // module name id -> definition
+  std::unordered_map<uint32_t, uint32_t> m_definitions;
+};
+
+}  // namespace FOEDAG
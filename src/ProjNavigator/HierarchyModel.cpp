@@ -0,0 +1,175 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "HierarchyModel.h"
+
+namespace FOEDAG {
+
+HierarchyModel::HierarchyModel(QObject *parent)
+    : QAbstractItemModel(parent), m_root(std::make_unique<Node>()) {}
+
+HierarchyModel::~HierarchyModel() = default;
+
+void HierarchyModel::setHierarchyIndex(
+    std::shared_ptr<const HierarchyIndex> index) {
+  beginResetModel();
+  m_index = std::move(index);
+  m_root = std::make_unique<Node>();
+  if (m_index) {
+    // top modules are few, they are always created
+    const auto &tops = m_index->tops();
+    for (size_t row = 0; row < tops.size(); row++) {
+      auto top = std::make_unique<Node>();
+      top->parent = m_root.get();
+      top->row = static_cast<int>(row);
+      top->def = tops.at(row);
+      m_root->children.push_back(std::move(top));
+    }
+  }
+  endResetModel();
+}
+
+std::shared_ptr<const HierarchyIndex> HierarchyModel::hierarchyIndex() const {
+  return m_index;
+}
+
+HierarchyModel::Node *HierarchyModel::node(const QModelIndex &index) const {
+  return index.isValid() ? static_cast<Node *>(index.internalPointer())
+                         : m_root.get();
+}
+
+uint32_t HierarchyModel::childCount(const Node *node) const {
+  if (node == m_root.get()) return static_cast<uint32_t>(node->children.size());
+  if (node->def == HierarchyIndex::None) return 0;
+  return m_index->module(node->def).instanceCount;
+}
+
+QModelIndex HierarchyModel::index(int row, int column,
+                                  const QModelIndex &parent) const {
+  Node *parentNode = node(parent);
+  if (column != 0 || row < 0 ||
+      row >= static_cast<int>(parentNode->children.size()))
+    return {};
+  return createIndex(row, column, parentNode->children.at(row).get());
+}
+
+QModelIndex HierarchyModel::parent(const QModelIndex &child) const {
+  if (!child.isValid()) return {};
+  Node *parentNode = node(child)->parent;
+  if (parentNode == m_root.get()) return {};
+  return createIndex(parentNode->row, 0, parentNode);
+}
+
+int HierarchyModel::rowCount(const QModelIndex &parent) const {
+  if (parent.column() > 0) return 0;
+  return static_cast<int>(node(parent)->children.size());
+}
+
+int HierarchyModel::columnCount(const QModelIndex &parent) const { return 1; }
+
+QVariant HierarchyModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid()) return {};
+  const Node *item = node(index);
+  const bool top = item->instance == nullptr;
+  const HierarchyIndex::ModuleDef *def =
+      (item->def != HierarchyIndex::None) ? &m_index->module(item->def)
+                                          : nullptr;
+  const QString file =
+      def ? QString::fromStdString(m_index->file(def->file)) : QString{};
+  switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole: {
+      const QString fileName = QString::fromStdString(
+          std::filesystem::path{file.toStdString()}.filename().string());
+      if (top)
+        return QString{"%1 (%2)"}.arg(
+            QString::fromStdString(m_index->name(def->name)), fileName);
+      return QString{"%1 : %2 (%3)"}.arg(
+          QString::fromStdString(m_index->name(item->instance->name)),
+          QString::fromStdString(m_index->name(item->instance->module)),
+          fileName);
+    }
+    case FileRole:
+      return file;
+    case LineRole:
+      return def ? def->line : 0;
+    case InstFileRole:
+      return top ? QString{}
+                 : QString::fromStdString(m_index->file(item->instance->file));
+    case InstLineRole:
+      return top ? 0 : item->instance->line;
+    case TopItemRole:
+      return top;
+    default:
+      break;
+  }
+  return {};
+}
+
+bool HierarchyModel::hasChildren(const QModelIndex &parent) const {
+  if (parent.column() > 0) return false;
+  return childCount(node(parent)) > 0;
+}
+
+bool HierarchyModel::canFetchMore(const QModelIndex &parent) const {
+  const Node *item = node(parent);
+  return item->children.size() < childCount(item);
+}
+
+void HierarchyModel::fetchMore(const QModelIndex &parent) {
+  Node *item = node(parent);
+  fetch(parent, item,
+        std::min<uint32_t>(item->children.size() + FetchBatch,
+                           childCount(item)));
+}
+
+void HierarchyModel::fetch(const QModelIndex &parent, Node *item,
+                           uint32_t count) {
+  const uint32_t first = static_cast<uint32_t>(item->children.size());
+  if (count <= first) return;
+  beginInsertRows(parent, first, count - 1);
+  item->children.reserve(count);
+  for (uint32_t row = first; row < count; row++) {
+    auto child = std::make_unique<Node>();
+    child->parent = item;
+    child->row = static_cast<int>(row);
+    child->instance = &m_index->instance(item->def, row);
+    child->def = m_index->definition(*child->instance);
+    item->children.push_back(std::move(child));
+  }
+  endInsertRows();
+}
+
+QModelIndex HierarchyModel::indexForPath(const std::vector<uint32_t> &path) {
+  QModelIndex current;
+  for (uint32_t row : path) {
+    Node *item = node(current);
+    if (row >= childCount(item)) return {};
+    // whole batch containing the row is fetched, as view would do
+    if (row >= item->children.size())
+      fetch(current, item,
+            std::min<uint32_t>((row / FetchBatch + 1) * FetchBatch,
+                               childCount(item)));
+    current = index(static_cast<int>(row), 0, current);
+  }
+  return current;
+}
+
+}  // namespace FOEDAG
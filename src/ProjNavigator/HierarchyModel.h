@@ -0,0 +1,86 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QAbstractItemModel>
+#include <memory>
+#include <vector>
+
+#include "HierarchyIndex.h"
+
+namespace FOEDAG {
+
+/*!
+ * \brief The HierarchyModel class
+ * Instance tree on top of HierarchyIndex. Tree nodes are created only when
+ * view asks for children (canFetchMore/fetchMore) and in batches, so
+ * expanding instance with many children or deep hierarchy stays cheap.
+ */
+class HierarchyModel : public QAbstractItemModel {
+  Q_OBJECT
+
+ public:
+  enum Roles {
+    FileRole = Qt::UserRole + 1,
+    LineRole,
+    InstFileRole,
+    InstLineRole,
+    TopItemRole
+  };
+  static constexpr int FetchBatch{256};
+
+  explicit HierarchyModel(QObject *parent = nullptr);
+  ~HierarchyModel() override;
+
+  void setHierarchyIndex(std::shared_ptr<const HierarchyIndex> index);
+  std::shared_ptr<const HierarchyIndex> hierarchyIndex() const;
+
+  QModelIndex index(int row, int column,
+                    const QModelIndex &parent = {}) const override;
+  QModelIndex parent(const QModelIndex &child) const override;
+  int rowCount(const QModelIndex &parent = {}) const override;
+  int columnCount(const QModelIndex &parent = {}) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  bool hasChildren(const QModelIndex &parent = {}) const override;
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
+
+  // index of node at \a path of rows, nodes along the path are fetched
+  QModelIndex indexForPath(const std::vector<uint32_t> &path);
+
+ private:
+  struct Node {
+    Node *parent{nullptr};
+    int row{0};
+    uint32_t def{HierarchyIndex::None};
+    // not set for top module
+    const HierarchyIndex::Instance *instance{nullptr};
+    std::vector<std::unique_ptr<Node>> children;
+  };
+  Node *node(const QModelIndex &index) const;
+  uint32_t childCount(const Node *node) const;
+  void fetch(const QModelIndex &parent, Node *node, uint32_t count);
+
+  std::shared_ptr<const HierarchyIndex> m_index;
+  std::unique_ptr<Node> m_root;
+};
+
+}  // namespace FOEDAG
@@ -20,60 +20,74 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
-#include <QMap>
 #include <QObject>
 #include <QString>
-#include <QVector>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
 
-#include "nlohmann_json/json.hpp"
-using json = nlohmann::ordered_json;
-
-class QTreeWidget;
-class QTreeWidgetItem;
+class QLineEdit;
+class QModelIndex;
+class QTreeView;
+class QWidget;
 
 namespace FOEDAG {
 
-struct Module {
-  QString name;
-  QString instName;
-  QString file;
-  QString line;
-  QString instFile;
-  QString instLine;
-  QVector<Module *> moduleInst;
-};
+class HierarchyIndex;
+class HierarchyModel;
 
 class HierarchyView : public QObject {
   Q_OBJECT
 
  public:
   HierarchyView(const std::filesystem::path &ports);
+  ~HierarchyView() override;
   void setPortsFile(const std::filesystem::path &ports);
+  // hier_info.json is parsed on worker thread, loaded() is emitted when done
   void update();
   void clean();
+  bool isLoading() const;
+
+  QWidget *widget();
+  QTreeView *treeView();
+  HierarchyModel *model();
 
-  QTreeWidget *widget();
+  /*!
+   * \brief find
+   * Selects next instance which name or module contains \a text. Search runs
+   * on hierarchy index, only path to the found instance is created.
+   */
+  bool find(const QString &text);
 
  signals:
   void openFile(const QString &file, int line);
   void topModuleFile(const QString &);
+  void loaded();
 
  private slots:
   void treeWidgetContextMenu(const QPoint &pos);
-  void OpenModuleInstance(QTreeWidgetItem *item, int column);
+  void OpenModuleInstance(const QModelIndex &index);
 
  private:
-  QTreeWidgetItem *addItem(QTreeWidgetItem *parent, Module *module);
-  void parseJson(json &jsonObject);
-  void emitOpenFile(QTreeWidgetItem *item, int column);
-  void emitOpenInstFile(QTreeWidgetItem *item, int column);
+  struct LoadState {
+    std::mutex lock;
+    bool cancelled{false};
+  };
+  void setHierarchyIndex(std::shared_ptr<HierarchyIndex> index);
+  void emitOpenFile(const QModelIndex &index);
+  void emitOpenInstFile(const QModelIndex &index);
 
  private:
-  QTreeWidget *m_treeWidget{};
+  QWidget *m_widget{};
+  QTreeView *m_treeView{};
+  QLineEdit *m_search{};
+  HierarchyModel *m_model{};
   std::filesystem::path m_portsFile;
-  QMap<int, QString> m_files;
-  QVector<Module> m_topVector;
+  std::shared_ptr<LoadState> m_load;
+  QString m_searchText;
+  std::vector<std::vector<uint32_t>> m_searchResults;
+  size_t m_searchPos{0};
 };
 
 }  // namespace FOEDAG
@@ -0,0 +1,122 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "SimulationRegression.h"
+
+#include <QProcess>
+#include <algorithm>
+#include <chrono>
+
+#include "Utils/ProcessUtils.h"
+
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+void SimulationRegression::AddRun(const std::string& name,
+                                  const std::string& command,
+                                  const fs::path& log) {
+  RegressionRun run;
+  run.name = name;
+  run.command = command;
+  run.log = log;
+  m_runs.push_back(run);
+}
+
+bool SimulationRegression::Run(const fs::path& workingDir,
+                               const Finished& finished) {
+  m_summary = {};
+  if (m_runs.empty()) return true;
+  auto start = std::chrono::steady_clock::now();
+  for (auto& run : m_runs) {
+    run.dir = workingDir / run.name;
+    std::error_code ec;
+    fs::create_directories(run.dir, ec);
+    if (run.log.is_relative() && !run.log.empty()) run.log = run.dir / run.log;
+  }
+  m_pool.Run(
+      m_runs.size(), [this](size_t index) { execute(m_runs[index]); },
+      [this, &finished](size_t index) {
+        const RegressionRun& run = m_runs.at(index);
+        // runs are parallel, wall time is measured for all of them below
+        m_summary.append(run.utils);
+        if (finished) finished(run);
+      });
+
+  m_summary.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  return Failed() == 0;
+}
+
+uint32_t SimulationRegression::Passed() const {
+  return static_cast<uint32_t>(
+      std::count_if(m_runs.begin(), m_runs.end(),
+                    [](const RegressionRun& run) { return run.passed; }));
+}
+
+uint32_t SimulationRegression::Failed() const {
+  return static_cast<uint32_t>(m_runs.size()) - Passed();
+}
+
+void SimulationRegression::execute(RegressionRun& run) {
+  auto start = std::chrono::steady_clock::now();
+  QStringList args =
+      QProcess::splitCommand(QString::fromStdString(run.command));
+  if (args.isEmpty()) return;
+  const QString program = args.takeFirst();
+
+  // process is owned by this thread, no event loop needed with waitFor*
+  QProcess process;
+  process.setWorkingDirectory(QString::fromStdString(run.dir.string()));
+  process.setProcessChannelMode(QProcess::MergedChannels);
+  if (!run.log.empty())
+    process.setStandardOutputFile(QString::fromStdString(run.log.string()));
+  process.start(program, args);
+  ProcessUtils utils;
+  if (process.waitForStarted(-1)) {
+    utils.Start(process.processId());
+    while (process.state() != QProcess::NotRunning &&
+           !process.waitForFinished(100)) {
+      if (m_pool.Stopped()) {
+        process.kill();
+        process.waitForFinished(-1);
+        break;
+      }
+    }
+    utils.Stop();
+  }
+
+  run.exitCode = (process.exitStatus() == QProcess::NormalExit &&
+                  process.error() != QProcess::FailedToStart)
+                     ? process.exitCode()
+                     : -1;
+  run.passed = !m_pool.Stopped() && (run.exitCode == 0);
+  run.utils.utilization = utils.Utilization();
+  run.utils.cpuTime = utils.CpuTime();
+  run.utils.peakRss = utils.PeakRss();
+  run.utils.readBytes = utils.ReadBytes();
+  run.utils.writeBytes = utils.WriteBytes();
+  run.utils.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,90 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Compiler/Task.h"
+#include "Utils/JobPool.h"
+
+namespace FOEDAG {
+
+struct RegressionRun {
+  std::string name;
+  std::string command;
+  std::filesystem::path log;  // relative to dir
+  std::filesystem::path dir;  // own working directory of the run
+  int exitCode{-1};
+  bool passed{false};
+  ProcessUtilization utils{};
+};
+
+/*!
+ * \brief The SimulationRegression class
+ * Runs several simulation commands against one compiled model with at most
+ * Jobs() processes at the same time. Every run works in its own directory
+ * below the regression working directory, named after the run, so files the
+ * testbench writes don't collide. The 'finished' callback is always called
+ * from the thread that called Run().
+ */
+class SimulationRegression {
+ public:
+  using Finished = std::function<void(const RegressionRun&)>;
+
+  // 0 means number of hardware threads
+  void Jobs(uint32_t jobs) { m_pool.Threads(jobs); }
+  uint32_t Jobs() const { return m_pool.Threads(); }
+
+  void AddRun(const std::string& name, const std::string& command,
+              const std::filesystem::path& log);
+  const std::vector<RegressionRun>& Runs() const { return m_runs; }
+
+  /*!
+   * \brief Run
+   * \return true if all runs have passed
+   */
+  bool Run(const std::filesystem::path& workingDir,
+           const Finished& finished = {});
+  // thread safe, running simulations are killed by their worker threads
+  void Stop() { m_pool.Stop(); }
+
+  uint32_t Passed() const;
+  uint32_t Failed() const;
+
+  /*!
+   * \brief Summary
+   * Wall clock duration of the whole regression and max utilization of the
+   * single run, same accounting as for sequential simulation steps.
+   */
+  ProcessUtilization Summary() const { return m_summary; }
+
+ private:
+  void execute(RegressionRun& run);
+
+  std::vector<RegressionRun> m_runs;
+  JobPool m_pool;
+  ProcessUtilization m_summary{};
+};
+
+}  // namespace FOEDAG
@@ -25,12 +25,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <sys/types.h>
 
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QProcess>
 #include <charconv>
 #include <chrono>
 #include <ctime>
 #include <filesystem>
+#include <fstream>
+#include <functional>
+#include <set>
 #include <sstream>
 #include <thread>
 
@@ -38,8 +42,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Compiler/Log.h"
 #include "NewProject/ProjectManager/project_manager.h"
 #include "ProjNavigator/tcl_command_integration.h"
+#include "SimulationRegression.h"
 #include "Utils/FileUtils.h"
 #include "Utils/StringUtils.h"
+#include "scope_guard.hpp"
 
 using namespace FOEDAG;
 
@@ -169,6 +175,11 @@ void Simulator::SetSimulatorSimulationOption(const std::string& simulation,
 
 void Simulator::ResetGateSimulationModel() { m_gateSimulationModels.clear(); }
 
+std::vector<std::string> Simulator::CommandNames() {
+  return {"set_top_testbench", "simulation_options", "simulation_model_cache",
+          "simulate_regression"};
+}
+
 bool Simulator::RegisterCommands(TclInterpreter* interp) {
   bool ok = true;
   auto set_top_testbench = [](void* clientData, Tcl_Interp* interp, int argc,
@@ -253,6 +264,74 @@ bool Simulator::RegisterCommands(TclInterpreter* interp) {
   };
   interp->registerCmd("simulation_options", simulation_options, this, 0);
 
+  auto simulation_model_cache = [](void* clientData, Tcl_Interp* interp,
+                                   int argc, const char* argv[]) -> int {
+    Simulator* simulator = (Simulator*)clientData;
+    if (argc == 2) {
+      std::string arg = argv[1];
+      if (arg == "on" || arg == "off") {
+        simulator->ModelCache(arg == "on");
+        return TCL_OK;
+      }
+    }
+    simulator->ErrorMessage(
+        "Invalid arguments. Usage: simulation_model_cache on|off");
+    return TCL_ERROR;
+  };
+  interp->registerCmd("simulation_model_cache", simulation_model_cache, this,
+                      0);
+
+  auto simulate_regression = [](void* clientData, Tcl_Interp* interp,
+                                int argc, const char* argv[]) -> int {
+    Simulator* simulator = (Simulator*)clientData;
+    const std::string usage{
+        "Usage: simulate_regression <level> ?<simulator>? ?-jobs <num>? "
+        "-run <name> <options> ?-run <name> <options>...?"};
+    bool levelValid{false};
+    Simulator::SimulationType level{Simulator::SimulationType::RTL};
+    bool simulatorValid{false};
+    Simulator::SimulatorType sim_tool{Simulator::SimulatorType::Icarus};
+    uint32_t jobs{0};
+    Simulator::RegressionRuns runs;
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      bool ok{false};
+      if (arg == "-jobs" && i + 1 < argc) {
+        auto [value, valid] = StringUtils::to_number<uint32_t>(argv[++i]);
+        if (!valid) {
+          simulator->ErrorMessage("Invalid number of jobs: " +
+                                  std::string{argv[i]});
+          return TCL_ERROR;
+        }
+        jobs = value;
+      } else if (arg == "-run" && i + 2 < argc) {
+        runs.push_back({argv[i + 1], argv[i + 2]});
+        i += 2;
+      } else if (auto type = Simulator::ToSimulationType(arg, ok); ok) {
+        level = type;
+        levelValid = true;
+      } else if (auto tool = Simulator::ToSimulatorType(arg, ok); ok) {
+        sim_tool = tool;
+        simulatorValid = true;
+      } else {
+        simulator->ErrorMessage("Invalid argument: " + arg + ". " + usage);
+        return TCL_ERROR;
+      }
+    }
+    if (!levelValid || runs.empty()) {
+      simulator->ErrorMessage("Wrong arguments. " + usage);
+      return TCL_ERROR;
+    }
+    if (!simulatorValid) {
+      bool ok{false};
+      auto simTool = simulator->UserSimulationType(level, ok);
+      if (ok) sim_tool = simTool;
+    }
+    return simulator->Regression(level, sim_tool, runs, jobs) ? TCL_OK
+                                                               : TCL_ERROR;
+  };
+  interp->registerCmd("simulate_regression", simulate_regression, this, 0);
+
   return ok;
 }
 
@@ -789,15 +868,18 @@ std::string Simulator::SimulatorRunCommand(SimulationType simulation,
   auto simulationTop{ProjManager()->SimulationTopModule()};
   switch (type) {
     case SimulatorType::Verilator: {
-      std::string command = "obj_dir/V" + simulationTop;
+      std::string command =
+          (m_modelDir / "obj_dir" / ("V" + simulationTop)).string();
       if (!GetSimulatorSimulationOption(simulation, type).empty())
         command += " " + GetSimulatorSimulationOption(simulation, type);
       if (!m_waveFile.empty()) command += " " + m_waveFile;
       return command;
     }
     case SimulatorType::Icarus: {
-      std::string command =
-          (SimulatorExecPath(type) / "vvp").string() + " ./a.out";
+      const std::string model =
+          m_modelDir.empty() ? "./a.out" : (m_modelDir / "a.out").string();
+      std::string command = (SimulatorExecPath(type) / "vvp").string() + " " +
+                            model;
       if (m_waveType == WaveformType::FST) {
         command += " -fst";
       }
@@ -835,7 +917,7 @@ std::string Simulator::SimulatorRunCommand(SimulationType simulation,
     case SimulatorType::Questa:
       return "Todo";
     case SimulatorType::VCS:
-      return "simv";
+      return (m_modelDir / "simv").string();
     case SimulatorType::Xcelium:
       return "Todo";
   }
@@ -970,9 +1052,7 @@ int Simulator::SimulationJob(SimulationType simulation, SimulatorType type,
   */
   ProcessUtilization summaryUtils{};
   auto appendSumUtils = [&summaryUtils](const ProcessUtilization& utils) {
-    summaryUtils.duration += utils.duration;
-    summaryUtils.utilization =
-        std::max(summaryUtils.utilization, utils.utilization);
+    summaryUtils.append(utils);
   };
 
   std::string log{LogFile(simulation)};
@@ -986,52 +1066,28 @@ int Simulator::SimulationJob(SimulationType simulation, SimulatorType type,
   command += " " + fileList;
   std::string workingDir =
       m_compiler->FilePath(Compiler::ToCompilerAction(simulation)).string();
-  FileUtils::WriteToFile(CommandLogFile("comp"), command);
-  int status = m_compiler->ExecuteAndMonitorSystemCommand(command, log, false,
-                                                          workingDir);
-  appendSumUtils(m_compiler->m_utils);
-  if (status) {
-    ErrorMessage("Design " + ProjManager()->projectName() +
-                 " simulation compilation failed!\n");
-    return status;
-  }
+  const std::filesystem::path commandLogDir{workingDir};
 
   // Extra Simulator Model compilation step (Elaboration or C++ compilation)
+  std::string elaboration;
   auto simulationTop{ProjManager()->SimulationTopModule()};
   switch (type) {
     case SimulatorType::Verilator: {
-      std::string command =
+      elaboration =
           "make -j -C obj_dir/ -f V" + simulationTop + ".mk V" + simulationTop;
       if (!GetSimulatorElaborationOption(simulation, type).empty())
-        command += " " + GetSimulatorElaborationOption(simulation, type);
-      FileUtils::WriteToFile(CommandLogFile("make"), command);
-      status = m_compiler->ExecuteAndMonitorSystemCommand(command, log, true,
-                                                          workingDir);
-      appendSumUtils(m_compiler->m_utils);
-      if (status) {
-        ErrorMessage("Design " + ProjManager()->projectName() +
-                     " simulation compilation failed!\n");
-        return status;
-      }
+        elaboration += " " + GetSimulatorElaborationOption(simulation, type);
       break;
     }
     case SimulatorType::GHDL: {
-      std::string command = execPath + " -e -fsynopsys -fexplicit";
+      elaboration = execPath + " -e -fsynopsys -fexplicit";
       if (!GetSimulatorElaborationOption(simulation, type).empty())
-        command += " " + GetSimulatorElaborationOption(simulation, type);
-      command += " --workdir=" +
-                 m_compiler->FilePath(Compiler::Action::SimulateRTL).string();
+        elaboration += " " + GetSimulatorElaborationOption(simulation, type);
+      elaboration +=
+          " --workdir=" +
+          m_compiler->FilePath(Compiler::Action::SimulateRTL).string();
       if (!simulationTop.empty()) {
-        command += TopModuleCmd(type) + simulationTop;
-      }
-      FileUtils::WriteToFile(CommandLogFile("make"), command);
-      status = m_compiler->ExecuteAndMonitorSystemCommand(command, log, true,
-                                                          workingDir);
-      appendSumUtils(m_compiler->m_utils);
-      if (status) {
-        ErrorMessage("Design " + ProjManager()->projectName() +
-                     " simulation compilation failed!\n");
-        return status;
+        elaboration += TopModuleCmd(type) + simulationTop;
       }
       break;
     }
@@ -1039,16 +1095,266 @@ int Simulator::SimulationJob(SimulationType simulation, SimulatorType type,
       break;
   }
 
+  // Compiled model is reused while commands, sources and simulator are same
+  const std::filesystem::path hashFile =
+      std::filesystem::path{workingDir} /
+      ("simulation_model_" + ToString(type) + ".sha1");
+  std::string modelHash;
+  if (m_modelCache) {
+    modelHash =
+        ModelHash({command, elaboration}, workingDir, SimulatorVersion(type));
+    const auto model = ModelFile(type, workingDir);
+    if (!modelHash.empty() &&
+        FileUtils::GetFileContent(hashFile) == modelHash &&
+        (model.empty() || FileUtils::FileExists(model))) {
+      Message("Simulation model is up to date, skipping compilation");
+      modelHash.clear();
+      command.clear();
+      elaboration.clear();
+    }
+  }
+
+  int status{0};
+  if (!command.empty()) {
+    FileUtils::removeFile(hashFile);
+    FileUtils::WriteToFile(commandLogDir / CommandLogFile("comp"), command);
+    status = m_compiler->ExecuteAndMonitorSystemCommand(command, log, false,
+                                                        workingDir);
+    appendSumUtils(m_compiler->Context().Utilization());
+    if (status) {
+      ErrorMessage("Design " + ProjManager()->projectName() +
+                   " simulation compilation failed!\n");
+      return status;
+    }
+  }
+
+  if (!elaboration.empty()) {
+    FileUtils::WriteToFile(commandLogDir / CommandLogFile("make"), elaboration);
+    status = m_compiler->ExecuteAndMonitorSystemCommand(elaboration, log, true,
+                                                        workingDir);
+    appendSumUtils(m_compiler->Context().Utilization());
+    if (status) {
+      ErrorMessage("Design " + ProjManager()->projectName() +
+                   " simulation compilation failed!\n");
+      return status;
+    }
+  }
+  if (!modelHash.empty()) FileUtils::WriteToFile(hashFile, modelHash, false);
+
+  if (!m_regressionRuns.empty()) {
+    status = RunRegression(simulation, type, workingDir, summaryUtils);
+    m_compiler->Context().Utilization(summaryUtils);
+    return status;
+  }
+
   // Actual simulation
   command = SimulatorRunCommand(simulation, type);
-  FileUtils::WriteToFile(CommandLogFile(std::string{}), command);
+  FileUtils::WriteToFile(commandLogDir / CommandLogFile(std::string{}),
+                         command);
   status = m_compiler->ExecuteAndMonitorSystemCommand(command, log, true,
                                                       workingDir);
-  appendSumUtils(m_compiler->m_utils);
-  m_compiler->m_utils = summaryUtils;
+  appendSumUtils(m_compiler->Context().Utilization());
+  m_compiler->Context().Utilization(summaryUtils);
   return status;
 }
 
+int Simulator::RunRegression(SimulationType simulation, SimulatorType type,
+                             const std::filesystem::path& workingDir,
+                             ProcessUtilization& utils) {
+  SimulationRegression regression;
+  regression.Jobs(m_regressionJobs);
+  const std::string waveFile = m_waveFile;
+  // runs work in their own directories, the model stays in workingDir
+  m_modelDir = std::filesystem::absolute(workingDir);
+  for (const auto& [name, options] : m_regressionRuns) {
+    // every run needs its own waveform, it is written where the single
+    // simulation writes it, with the run name in front of the file name
+    if (!waveFile.empty()) {
+      std::filesystem::path wave = m_modelDir / waveFile;
+      wave.replace_filename(name + "_" + wave.filename().string());
+      m_waveFile = wave.string();
+    }
+    std::string command = SimulatorRunCommand(simulation, type);
+    if (!options.empty()) command += " " + options;
+    regression.AddRun(name, command, LogFile(simulation));
+  }
+  m_waveFile = waveFile;
+  m_modelDir.clear();
+  FileUtils::WriteToFile(workingDir / CommandLogFile("regression"),
+                         regression.Runs().front().command);
+
+  Message("Regression: " + std::to_string(regression.Runs().size()) +
+          " run(s)");
+  regression.Run(workingDir, [this](const RegressionRun& run) {
+    Message("Regression run " + run.name + ": " +
+            (run.passed ? "PASSED" : "FAILED") + " (" +
+            std::to_string(run.utils.duration) + " ms, log " +
+            (std::filesystem::path{run.name} / run.log.filename()).string() +
+            ")");
+  });
+  utils.append(regression.Summary());
+  Message("Regression: " + std::to_string(regression.Passed()) +
+          " passed, " + std::to_string(regression.Failed()) + " failed");
+  return regression.Failed() == 0 ? 0 : 1;
+}
+
+bool Simulator::Regression(SimulationType action, SimulatorType type,
+                           const RegressionRuns& runs, uint32_t jobs) {
+  if (runs.empty()) {
+    ErrorMessage("Regression: no runs specified");
+    return false;
+  }
+  m_regressionRuns = runs;
+  m_regressionJobs = jobs;
+  auto guard = sg::make_scope_guard([this] {
+    m_regressionRuns.clear();
+    m_regressionJobs = 0;
+  });
+  return Simulate(action, type, std::string{});
+}
+
+// HDL and model sources, hashed by content
+static bool IsModelSource(const std::filesystem::path& path) {
+  static const std::set<std::string> extensions{
+      ".v", ".sv", ".vh", ".svh", ".vhd", ".vhdl", ".inc", ".vo",
+      ".f", ".c",  ".cc", ".cpp", ".h",   ".hpp",  ".vlt"};
+  return extensions.count(StringUtils::toLower(path.extension().string())) !=
+         0;
+}
+
+std::string Simulator::ModelHash(const std::vector<std::string>& commands,
+                                 const std::filesystem::path& workingDir,
+                                 const std::string& version) {
+  namespace fs = std::filesystem;
+  QCryptographicHash hash{QCryptographicHash::Sha1};
+  auto add = [&hash](const std::string& field) {
+    hash.addData(QByteArray::fromStdString(field));
+    hash.addData(QByteArray{1, '\0'});  // field separator
+  };
+  add(version);
+  const fs::path workDir = workingDir.lexically_normal();
+  std::set<fs::path> files;
+  std::set<fs::path> directories;  // include and library directories
+  std::set<fs::path> filelists;
+  // tokens of a command or a filelist, relative paths are against \a base
+  std::function<void(const std::vector<std::string>&, const fs::path&)>
+      collect;
+  collect = [&](const std::vector<std::string>& tokens, const fs::path& base) {
+    for (size_t i = 0; i < tokens.size(); i++) {
+      const std::string& token = tokens.at(i);
+      // GHDL library directory is an output of compilation
+      if (StringUtils::startsWith(token, "--workdir=")) continue;
+      // file or directory, possibly behind directive like -I, +incdir+, -y
+      std::vector<std::string> candidates{token};
+      if (auto pos = token.find_last_of("+="); pos != std::string::npos)
+        candidates.push_back(token.substr(pos + 1));
+      if (token.size() > 2 && token.front() == '-')
+        candidates.push_back(token.substr(2));
+      for (size_t c = 0; c < candidates.size(); c++) {
+        if (candidates.at(c).empty()) continue;
+        fs::path path{candidates.at(c)};
+        if (path.is_relative()) path = base / path;
+        std::error_code ec;
+        if (!fs::exists(path, ec)) continue;
+        path = path.lexically_normal();
+        const bool directory = fs::is_directory(path, ec);
+        // generated files in working directory (obj_dir, a.out) are outputs,
+        // sources and directories behind directives are inputs there too
+        const fs::path relative = path.lexically_relative(workDir);
+        const bool inWorkDir = !relative.empty() && *relative.begin() != "..";
+        if (inWorkDir && !(directory ? (c != 0) : IsModelSource(path))) break;
+        if (directory) {
+          directories.insert(path);
+          break;
+        }
+        files.insert(path);
+        const std::string option = (i > 0) ? tokens.at(i - 1) : std::string{};
+        const bool filelist = (option == "-f") || (option == "-F");
+        if (filelist && filelists.insert(path).second) {
+          std::vector<std::string> entries;
+          std::ifstream stream{path};
+          std::string line;
+          while (std::getline(stream, line)) {
+            line = line.substr(0, line.find("//"));
+            std::istringstream words{line};
+            std::string word;
+            while (words >> word) {
+              if (word.front() == '#') break;
+              entries.push_back(word);
+            }
+          }
+          // -F entries are relative to the filelist itself
+          collect(entries, (option == "-F") ? path.parent_path() : base);
+        }
+        break;
+      }
+    }
+  };
+  for (const auto& command : commands) {
+    add(command);
+    std::vector<std::string> tokens;
+    StringUtils::tokenize(command, " ", tokens);
+    collect(tokens, workingDir);
+  }
+
+  // sources below include and library directories at any depth, sources
+  // next to design files for `include relative to the including file
+  std::set<fs::path> sources{files};
+  auto addSources = [&sources](const auto& iterator) {
+    std::error_code ec;
+    for (const auto& entry : iterator) {
+      if (entry.is_regular_file(ec) && IsModelSource(entry.path()))
+        sources.insert(entry.path().lexically_normal());
+    }
+  };
+  std::error_code ec;
+  for (const auto& directory : directories)
+    addSources(fs::recursive_directory_iterator{directory, ec});
+  for (const auto& file : files) {
+    if (IsModelSource(file) && directories.count(file.parent_path()) == 0)
+      addSources(fs::directory_iterator{file.parent_path(), ec});
+  }
+  for (const auto& directory : directories) add(directory.string());
+  for (const auto& source : sources) {
+    add(source.string());
+    const std::string fileHash = FileUtils::FileHash(source);
+    if (fileHash.empty()) return {};
+    add(fileHash);
+  }
+  return hash.result().toHex().toStdString();
+}
+
+std::string Simulator::SimulatorVersion(SimulatorType type) {
+  static std::map<std::string, std::string> versions;
+  const auto exec = SimulatorExecPath(type) / SimulatorName(type);
+  const std::string key =
+      exec.string() + ":" + std::to_string(FileUtils::Mtime(exec));
+  auto it = versions.find(key);
+  if (it != versions.end()) return it->second;
+  std::ostringstream out;
+  const std::string option =
+      (type == SimulatorType::Icarus) ? std::string{"-V"} : "--version";
+  // version is printed even when exit code is not zero (iverilog -V)
+  FileUtils::ExecuteSystemCommand(exec.string(), {option}, &out, 10000);
+  const std::string version = ToString(type) + ":" + out.str();
+  versions.emplace(key, version);
+  return version;
+}
+
+std::filesystem::path Simulator::ModelFile(
+    SimulatorType type, const std::filesystem::path& workingDir) {
+  switch (type) {
+    case SimulatorType::Verilator:
+      return workingDir / "obj_dir" /
+             ("V" + ProjManager()->SimulationTopModule());
+    case SimulatorType::Icarus:
+      return workingDir / "a.out";
+    default:
+      break;
+  }
+  return {};
+}
+
 bool Simulator::SimulateRTL(SimulatorType type) {
   if (!m_compiler->HasTargetDevice()) return false;
 
@@ -1209,7 +1515,7 @@ bool Simulator::SimulatePNR(SimulatorType type) {
       }
       // Icarus does not support vectors in SDF files, both the netlist and the
       // sdf have to get bit blasted
-      const auto& path = std::filesystem::current_path();
+      const auto& path = m_compiler->Context().WorkingDir();
       std::string workingDir =
           std::filesystem::path(path / ProjManager()->projectName()).string();
       std::filesystem::path bitblast_exe =
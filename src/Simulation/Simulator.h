@@ -34,6 +34,7 @@ class TclInterpreter;
 class TclInterpreterHandler;
 class Session;
 class Compiler;
+struct ProcessUtilization;
 
 class Simulator {
  public:
@@ -69,6 +70,8 @@ class Simulator {
                 const std::string& wave_file);
   TclInterpreter* TclInterp() { return m_interp; }
   bool RegisterCommands(TclInterpreter* interp);
+  // names of the commands RegisterCommands() creates
+  static std::vector<std::string> CommandNames();
   bool Clean(SimulationType action);
 
   std::string& getResult() { return m_result; }
@@ -118,6 +121,32 @@ class Simulator {
   bool IsTimedSimulation() { return m_timed_simulation; }
   void SetTimedSimulation(bool timed) { m_timed_simulation = timed; }
 
+  void ModelCache(bool enable) { m_modelCache = enable; }
+  bool ModelCache() const { return m_modelCache; }
+
+  using RegressionRuns = std::vector<std::pair<std::string, std::string>>;
+  /*!
+   * \brief Regression
+   * Compiles the model once (or reuses the cached one) and simulates it once
+   * per \a runs entry {name, options}, \a jobs simulations at a time. Options
+   * are appended to the simulation command, e.g. testbench plusargs. Every
+   * run works in its own <name> directory with its own log and waveform,
+   * Compiler::Stop() kills running simulations.
+   */
+  bool Regression(SimulationType action, SimulatorType type,
+                  const RegressionRuns& runs, uint32_t jobs);
+
+  /*!
+   * \brief ModelHash
+   * \return hash of model compilation \a commands, of the simulator \a version
+   * and of the content of every source the commands refer to (relative to
+   * \a workingDir): files, files in -f/-F filelists, sources below include
+   * and library directories and sources next to design files.
+   */
+  static std::string ModelHash(const std::vector<std::string>& commands,
+                               const std::filesystem::path& workingDir,
+                               const std::string& version);
+
  protected:
   virtual bool SimulateRTL(SimulatorType type);
   virtual bool SimulateGate(SimulatorType type);
@@ -145,6 +174,12 @@ class Simulator {
                                           SimulatorType type);
   virtual std::string SimulatorCompilationOptions(SimulationType simulation,
                                                   SimulatorType type);
+  virtual std::string SimulatorVersion(SimulatorType type);
+  std::filesystem::path ModelFile(SimulatorType type,
+                                  const std::filesystem::path& workingDir);
+  int RunRegression(SimulationType simulation, SimulatorType type,
+                    const std::filesystem::path& workingDir,
+                    ProcessUtilization& utils);
   class ProjectManager* ProjManager() const;
   std::string FileList(SimulationType action);
   static std::string LogFile(SimulationType type);
@@ -174,6 +209,11 @@ class Simulator {
   std::map<SimulationType, SimulatorType> m_simulatorTypes;
   SimulationType m_simType = SimulationType::RTL;
   bool m_timed_simulation = false;
+  bool m_modelCache = false;
+  RegressionRuns m_regressionRuns;
+  uint32_t m_regressionJobs = 0;
+  // directory of the compiled model when simulation runs in another one
+  std::filesystem::path m_modelDir;
 };
 
 }  // namespace FOEDAG
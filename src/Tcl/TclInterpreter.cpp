@@ -22,6 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QString>
 #include <QSysInfo>
+#include <set>
+
+#include "Utils/StartupProfiler.h"
+#include "Utils/Tracer.h"
 
 using namespace FOEDAG;
 
@@ -41,6 +45,12 @@ TclInterpreter::TclInterpreter(const char *argv0) : interp(nullptr) {
 
 TclInterpreter::~TclInterpreter() {
   if (interp) Tcl_DeleteInterp(interp);
+  // commands which were never created are deleted here
+  for (const auto& subsystem : m_lazySubsystems) {
+    if (subsystem->materialized) continue;
+    for (const auto& cmd : subsystem->cmds)
+      if (cmd.deleteProc) cmd.deleteProc(cmd.clientData);
+  }
 }
 
 std::string TclInterpreter::evalFile(const std::string &filename, int *ret) {
@@ -66,7 +76,184 @@ std::string TclInterpreter::evalCmd(const std::string cmd, int *ret) {
 void TclInterpreter::registerCmd(const std::string &cmdName, Tcl_CmdProc proc,
                                  ClientData clientData,
                                  Tcl_CmdDeleteProc *deleteProc) {
-  Tcl_CreateCommand(interp, cmdName.c_str(), proc, clientData, deleteProc);
+  if (m_recording) {
+    m_recording->cmds.push_back({cmdName, proc, clientData, deleteProc});
+    // deferred subsystem is being materialized, its stubs exist already
+    if (m_recording->registerFn) return;
+    m_recording->names.push_back(cmdName);
+    Tcl_CreateObjCommand(interp, cmdName.c_str(), lazyCmdProc, m_recording,
+                         nullptr);
+    return;
+  }
+  createCmd({cmdName, proc, clientData, deleteProc});
+}
+
+void TclInterpreter::createCmd(const LazyCmd &cmd) {
+  m_cmdNames.insert(cmd.name);
+  if (!m_traceCmds) {
+    Tcl_CreateCommand(interp, cmd.name.c_str(), cmd.proc, cmd.clientData,
+                      cmd.deleteProc);
+    return;
+  }
+  // owned by the command, released by tracedCmdDelete
+  Tcl_CreateCommand(interp, cmd.name.c_str(), tracedCmdProc, new LazyCmd{cmd},
+                    tracedCmdDelete);
+}
+
+void TclInterpreter::traceCmds(bool enable) {
+  if (m_traceCmds == enable) return;
+  m_traceCmds = enable;
+  // existing commands are swapped in place, renamed or replaced ones are
+  // left alone
+  for (const auto &name : m_cmdNames) {
+    Tcl_CmdInfo info;
+    if (!Tcl_GetCommandInfo(interp, name.c_str(), &info) ||
+        info.isNativeObjectProc)
+      continue;
+    LazyCmd *traced{nullptr};
+    if (info.proc == tracedCmdProc) {
+      if (enable) continue;
+      traced = static_cast<LazyCmd *>(info.clientData);
+      info.proc = traced->proc;
+      info.clientData = traced->clientData;
+      info.deleteProc = traced->deleteProc;
+      info.deleteData = traced->clientData;
+    } else {
+      if (!enable || info.deleteData != info.clientData) continue;
+      info.clientData = new LazyCmd{name, info.proc, info.clientData,
+                                    info.deleteProc};
+      info.proc = tracedCmdProc;
+      info.deleteProc = tracedCmdDelete;
+      info.deleteData = info.clientData;
+    }
+    Tcl_SetCommandInfo(interp, name.c_str(), &info);
+    // running command does not touch its wrapper after the call
+    delete traced;
+  }
+}
+
+int TclInterpreter::tracedCmdProc(ClientData clientData, Tcl_Interp *interp,
+                                  int argc, const char *argv[]) {
+  auto cmd = static_cast<LazyCmd *>(clientData);
+  TraceScope scope{cmd->name, "tcl"};
+  return cmd->proc(cmd->clientData, interp, argc, argv);
+}
+
+void TclInterpreter::tracedCmdDelete(ClientData clientData) {
+  auto cmd = static_cast<LazyCmd *>(clientData);
+  if (cmd->deleteProc) cmd->deleteProc(cmd->clientData);
+  delete cmd;
+}
+
+void TclInterpreter::registerLazyCmds(const std::string &subsystem,
+                                      const std::function<void()> &registerFn,
+                                      const std::function<void()> &init) {
+  if (!m_deferCmds) {
+    if (init) init();
+    registerFn();
+    return;
+  }
+  auto lazy = std::make_unique<LazySubsystem>();
+  lazy->owner = this;
+  lazy->name = subsystem;
+  lazy->init = init;
+  LazySubsystem *previous = m_recording;
+  m_recording = lazy.get();
+  registerFn();
+  m_recording = previous;
+  m_lazySubsystems.push_back(std::move(lazy));
+}
+
+void TclInterpreter::registerLazyCmds(const std::string &subsystem,
+                                      const std::vector<std::string> &cmdNames,
+                                      const std::function<void()> &init,
+                                      const std::function<void()> &registerFn) {
+  if (!m_deferCmds) {
+    if (init) init();
+    registerFn();
+    return;
+  }
+  auto lazy = std::make_unique<LazySubsystem>();
+  lazy->owner = this;
+  lazy->name = subsystem;
+  lazy->init = init;
+  lazy->registerFn = registerFn;
+  lazy->names = cmdNames;
+  for (const auto &name : cmdNames)
+    Tcl_CreateObjCommand(interp, name.c_str(), lazyCmdProc, lazy.get(),
+                         nullptr);
+  m_lazySubsystems.push_back(std::move(lazy));
+}
+
+bool TclInterpreter::materialize(const std::string &subsystem) {
+  bool found{false};
+  for (const auto &lazy : m_lazySubsystems) {
+    if (lazy->name != subsystem) continue;
+    materialize(*lazy);
+    found = true;
+  }
+  return found;
+}
+
+bool TclInterpreter::isMaterialized(const std::string &subsystem) const {
+  for (const auto &lazy : m_lazySubsystems)
+    if (lazy->name == subsystem && !lazy->materialized) return false;
+  return true;
+}
+
+bool TclInterpreter::isStub(const std::string &cmdName,
+                            const LazySubsystem &subsystem) const {
+  Tcl_CmdInfo info;
+  return Tcl_GetCommandInfo(interp, cmdName.c_str(), &info) &&
+         info.isNativeObjectProc && info.objProc == lazyCmdProc &&
+         info.objClientData == &subsystem;
+}
+
+void TclInterpreter::materialize(LazySubsystem &subsystem) {
+  if (subsystem.materialized) return;
+  subsystem.materialized = true;
+  const std::string traceName = "materialize " + subsystem.name;
+  StartupScope scope{traceName, "lazy"};
+  if (subsystem.init) subsystem.init();
+  // command could be registered again after the stub was created, newer
+  // registration wins as it would without lazy registration
+  std::set<std::string> stubs;
+  for (const auto &name : subsystem.names)
+    if (isStub(name, subsystem)) stubs.insert(name);
+  if (subsystem.registerFn) {
+    LazySubsystem *previous = m_recording;
+    m_recording = &subsystem;
+    subsystem.registerFn();
+    m_recording = previous;
+  }
+  // command without stub is created unless something else took the name
+  const std::set<std::string> names{subsystem.names.begin(),
+                                    subsystem.names.end()};
+  for (const auto &cmd : subsystem.cmds) {
+    Tcl_CmdInfo info;
+    if ((names.count(cmd.name) == 0) &&
+        !Tcl_GetCommandInfo(interp, cmd.name.c_str(), &info))
+      stubs.insert(cmd.name);
+  }
+  for (const auto &cmd : subsystem.cmds) {
+    if (stubs.count(cmd.name) != 0)
+      createCmd(cmd);
+    else if (cmd.deleteProc)
+      cmd.deleteProc(cmd.clientData);
+  }
+}
+
+int TclInterpreter::lazyCmdProc(ClientData clientData, Tcl_Interp *interp,
+                                int objc, Tcl_Obj *const objv[]) {
+  auto subsystem = static_cast<LazySubsystem *>(clientData);
+  subsystem->owner->materialize(*subsystem);
+  const std::string cmdName{Tcl_GetString(objv[0])};
+  if (subsystem->owner->isStub(cmdName, *subsystem)) {
+    Tcl_AppendResult(interp, "Command ", cmdName.c_str(),
+                     " is not provided by ", subsystem->name.c_str(), nullptr);
+    return TCL_ERROR;
+  }
+  return Tcl_EvalObjv(interp, objc, objv, 0);
 }
 
 std::string TclInterpreter::evalGuiTestFile(const std::string &filename) {
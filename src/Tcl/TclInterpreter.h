@@ -39,6 +39,8 @@ extern "C" {
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -71,11 +73,80 @@ class TclInterpreter {
   void registerCmd(const std::string& cmdName, Tcl_CmdProc proc,
                    ClientData clientData, Tcl_CmdDeleteProc* deleteProc);
 
+  /*!
+   * \brief registerLazyCmds
+   * Commands registered by \a registerFn are not created right away, stub
+   * commands with the same names are created instead. First call of any stub
+   * runs \a init, creates real commands of the \a subsystem and forwards the
+   * call to the real command.
+   */
+  void registerLazyCmds(const std::string& subsystem,
+                        const std::function<void()>& registerFn,
+                        const std::function<void()>& init = {});
+  /*!
+   * \brief registerLazyCmds
+   * Stub commands named \a cmdNames are created right away, nothing else of
+   * the \a subsystem exists yet. First call of any stub runs \a init, which
+   * constructs the subsystem, then \a registerFn, which registers its commands,
+   * and forwards the call to the real command.
+   */
+  void registerLazyCmds(const std::string& subsystem,
+                        const std::vector<std::string>& cmdNames,
+                        const std::function<void()>& init,
+                        const std::function<void()>& registerFn);
+  // while disabled, registerLazyCmds constructs the subsystem and creates its
+  // commands right away
+  void deferCmds(bool enable) { m_deferCmds = enable; }
+  // create real commands of lazy subsystem, false if subsystem is unknown
+  bool materialize(const std::string& subsystem);
+  bool isMaterialized(const std::string& subsystem) const;
+  /*!
+   * \brief traceCmds
+   * While enabled, calls of commands created by \a registerCmd are recorded
+   * by Tracer as spans named after the command. Commands are wrapped only
+   * while enabled, so calls cost nothing extra when tracing is off.
+   */
+  void traceCmds(bool enable);
+
   Tcl_Interp* getInterp() { return interp; }
 
  private:
   std::string TclHistoryScript();
   std::string TclStackTrace(int code) const;
+
+  struct LazyCmd {
+    std::string name;
+    Tcl_CmdProc* proc{nullptr};
+    ClientData clientData{nullptr};
+    Tcl_CmdDeleteProc* deleteProc{nullptr};
+  };
+  struct LazySubsystem {
+    TclInterpreter* owner{nullptr};
+    std::string name;
+    std::function<void()> init;
+    // commands registered on first use, stubs are created for names
+    std::function<void()> registerFn;
+    std::vector<std::string> names;
+    std::vector<LazyCmd> cmds;
+    bool materialized{false};
+  };
+  static int lazyCmdProc(ClientData clientData, Tcl_Interp* interp, int objc,
+                         Tcl_Obj* const objv[]);
+  void materialize(LazySubsystem& subsystem);
+  // wrapped by tracedCmdProc if commands are traced
+  void createCmd(const LazyCmd& cmd);
+  static int tracedCmdProc(ClientData clientData, Tcl_Interp* interp,
+                           int argc, const char* argv[]);
+  static void tracedCmdDelete(ClientData clientData);
+  bool isStub(const std::string& cmdName,
+              const LazySubsystem& subsystem) const;
+
+  std::vector<std::unique_ptr<LazySubsystem>> m_lazySubsystems;
+  LazySubsystem* m_recording{nullptr};
+  // commands created by createCmd, wrapped or unwrapped by traceCmds
+  std::set<std::string> m_cmdNames;
+  bool m_traceCmds{false};
+  bool m_deferCmds{true};
 };
 
 }  // namespace FOEDAG
@@ -0,0 +1,247 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "log_file_index.h"
+
+#include <QByteArrayMatcher>
+#include <algorithm>
+#include <cstring>
+
+using namespace FOEDAG;
+
+// text matched by regular expression without any special constructs
+static bool literalText(const QString& pattern, QString& text) {
+  static const QString special{"^$.|?*+()[]{}"};
+  text.clear();
+  for (int i = 0; i < pattern.size(); i++) {
+    QChar c = pattern.at(i);
+    if (c == QLatin1Char{'\\'}) {
+      // escaped letters and digits are classes or references
+      if (++i == pattern.size() || pattern.at(i).isLetterOrNumber())
+        return false;
+      c = pattern.at(i);
+    } else if (special.contains(c)) {
+      return false;
+    }
+    text.append(c);
+  }
+  return !text.isEmpty();
+}
+
+// line ending is not part of the line text
+static void chopLineEnding(QByteArray& line) {
+  if (line.endsWith('\n')) line.chop(1);
+  if (line.endsWith('\r')) line.chop(1);
+}
+
+LogFileIndex::~LogFileIndex() { close(); }
+
+bool LogFileIndex::open(const QString& fileName, QString* error) {
+  std::scoped_lock lock{m_lock};
+  reset();
+  m_file.setFileName(fileName);
+  if (!m_file.open(QFile::ReadOnly)) {
+    if (error) *error = m_file.errorString();
+    return false;
+  }
+  m_size = m_file.size();
+  m_head = readLocked(0, std::min(m_size, HeadSize));
+  return true;
+}
+
+void LogFileIndex::close() {
+  std::scoped_lock lock{m_lock};
+  reset();
+}
+
+QString LogFileIndex::fileName() const {
+  std::scoped_lock lock{m_lock};
+  return m_file.fileName();
+}
+
+void LogFileIndex::reset() {
+  m_head.clear();
+  m_size = 0;
+  m_indexed = 0;
+  m_offsets = {0};
+  if (m_file.isOpen()) m_file.close();
+}
+
+QByteArray LogFileIndex::readLocked(qint64 pos, qint64 length) const {
+  if (length <= 0 || !m_file.seek(pos)) return {};
+  return m_file.read(length);
+}
+
+bool LogFileIndex::buildIndex(const std::atomic_bool& stop) {
+  while (!stop) {
+    // lock is held for one chunk only so lines are readable meanwhile
+    std::scoped_lock lock{m_lock};
+    if (m_indexed >= m_size) return true;
+    const QByteArray chunk =
+        readLocked(m_indexed, std::min(ChunkSize, m_size - m_indexed));
+    // file was truncated, refresh() notices it
+    if (chunk.isEmpty()) {
+      m_size = m_indexed;
+      return true;
+    }
+    const char* begin = chunk.constData();
+    const char* pos = begin;
+    const char* last = begin + chunk.size();
+    while (pos < last) {
+      auto newLine =
+          static_cast<const char*>(std::memchr(pos, '\n', last - pos));
+      if (!newLine) break;
+      pos = newLine + 1;
+      m_offsets.push_back(m_indexed + (pos - begin));
+    }
+    m_indexed += chunk.size();
+  }
+  return false;
+}
+
+LogFileIndex::Update LogFileIndex::refresh() {
+  std::scoped_lock lock{m_lock};
+  if (!m_file.isOpen()) return Update::None;
+  const QString fileName = m_file.fileName();
+  QFile current{fileName};
+  bool replaced = !current.open(QFile::ReadOnly) || current.size() < m_size;
+  // file written again from scratch has different beginning most likely
+  if (!replaced) replaced = current.read(m_head.size()) != m_head;
+  if (replaced) {
+    reset();
+    m_file.setFileName(fileName);
+    if (m_file.open(QFile::ReadOnly)) {
+      m_size = m_file.size();
+      m_head = readLocked(0, std::min(m_size, HeadSize));
+    }
+    return Update::Reset;
+  }
+  const qint64 size = current.size();
+  if (size == m_size) return Update::None;
+  // offsets stay valid, appended content is indexed next
+  m_size = size;
+  if (m_head.size() < HeadSize)
+    m_head = readLocked(0, std::min(m_size, HeadSize));
+  return Update::Appended;
+}
+
+int LogFileIndex::lineCountLocked() const {
+  int count = static_cast<int>(m_offsets.size()) - 1;
+  // last line without line ending is known only when everything is indexed
+  if (m_indexed == m_size && m_offsets.back() < m_size) count++;
+  return count;
+}
+
+qint64 LogFileIndex::lineEndLocked(size_t index) const {
+  return (index + 1 < m_offsets.size()) ? m_offsets.at(index + 1) : m_size;
+}
+
+int LogFileIndex::lineCount() const {
+  std::scoped_lock lock{m_lock};
+  return lineCountLocked();
+}
+
+int LogFileIndex::completeLineCount() const {
+  std::scoped_lock lock{m_lock};
+  return static_cast<int>(m_offsets.size()) - 1;
+}
+
+bool LogFileIndex::indexed() const {
+  std::scoped_lock lock{m_lock};
+  return m_indexed == m_size;
+}
+
+qint64 LogFileIndex::size() const {
+  std::scoped_lock lock{m_lock};
+  return m_size;
+}
+
+QByteArray LogFileIndex::line(int line) const {
+  std::scoped_lock lock{m_lock};
+  if (line < 0 || line >= lineCountLocked()) return {};
+  const size_t index = static_cast<size_t>(line);
+  const qint64 begin = m_offsets.at(index);
+  QByteArray text = readLocked(begin, lineEndLocked(index) - begin);
+  chopLineEnding(text);
+  return text;
+}
+
+QString LogFileIndex::lineText(int line) const {
+  return QString::fromUtf8(this->line(line));
+}
+
+std::vector<QByteArray> LogFileIndex::lines(int from, int to) const {
+  std::scoped_lock lock{m_lock};
+  to = std::min(to, lineCountLocked());
+  if (from < 0 || from >= to) return {};
+  const qint64 begin = m_offsets.at(static_cast<size_t>(from));
+  size_t last = static_cast<size_t>(from) + 1;
+  while (last < static_cast<size_t>(to) &&
+         lineEndLocked(last) - begin <= ChunkSize)
+    last++;
+  const QByteArray block = readLocked(begin, lineEndLocked(last - 1) - begin);
+  std::vector<QByteArray> result;
+  result.reserve(last - static_cast<size_t>(from));
+  for (size_t i = static_cast<size_t>(from); i < last; i++) {
+    const qint64 end = std::min<qint64>(lineEndLocked(i) - begin, block.size());
+    const qint64 start = std::min<qint64>(m_offsets.at(i) - begin, end);
+    QByteArray text = block.mid(static_cast<int>(start),
+                                static_cast<int>(end - start));
+    chopLineEnding(text);
+    result.push_back(text);
+  }
+  return result;
+}
+
+void LogFileIndex::find(
+    const QRegularExpression& regexp, int from, int to,
+    const std::function<bool(const std::vector<int>&)>& found,
+    const std::atomic_bool& stop, size_t batch) const {
+  if (!regexp.isValid()) return;
+  to = std::min(to, lineCount());
+  // plain text is searched in raw bytes, no conversion is needed then
+  QString text;
+  const bool literal =
+      !(regexp.patternOptions() & QRegularExpression::CaseInsensitiveOption) &&
+      literalText(regexp.pattern(), text);
+  const QByteArrayMatcher matcher{text.toUtf8()};
+  std::vector<int> matches;
+  int i = std::max(from, 0);
+  while (i < to && !stop) {
+    // lines are read block by block, lock is held for one block only
+    const std::vector<QByteArray> block = lines(i, to);
+    if (block.empty()) break;
+    for (const QByteArray& bytes : block) {
+      if (stop) return;
+      const bool match =
+          literal ? matcher.indexIn(bytes) != -1
+                  : regexp.match(QString::fromUtf8(bytes)).hasMatch();
+      if (match) {
+        matches.push_back(i);
+        if (matches.size() >= batch) {
+          if (!found(matches)) return;
+          matches.clear();
+        }
+      }
+      i++;
+    }
+  }
+  if (!matches.empty() && !stop) found(matches);
+}
@@ -0,0 +1,112 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOG_FILE_INDEX_H
+#define LOG_FILE_INDEX_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QRegularExpression>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The LogFileIndex class
+ * Read-only view of large text file. Line start offsets are collected by
+ * buildIndex(), which is meant to run on worker thread while lines indexed so
+ * far are already available. Content is read on demand, not mapped, so file
+ * truncated by the tool writing it yields short lines, not a crash. All
+ * methods are thread safe.
+ */
+class LogFileIndex {
+ public:
+  enum class Update { None, Appended, Reset };
+
+  LogFileIndex() = default;
+  ~LogFileIndex();
+  LogFileIndex(const LogFileIndex&) = delete;
+  LogFileIndex& operator=(const LogFileIndex&) = delete;
+
+  bool open(const QString& fileName, QString* error = nullptr);
+  void close();
+  QString fileName() const;
+
+  /*!
+   * \brief buildIndex
+   * Indexes content which is not indexed yet. Returns false if \a stop was
+   * raised before the end of the content.
+   */
+  bool buildIndex(const std::atomic_bool& stop);
+
+  /*!
+   * \brief refresh
+   * Picks up content appended to the file since last call. Returns Reset if
+   * file was truncated or replaced, index is rebuilt from scratch then.
+   */
+  Update refresh();
+
+  // number of indexed lines, last line may have no line ending
+  int lineCount() const;
+  // number of indexed lines with line ending, they don't change on append
+  int completeLineCount() const;
+  bool indexed() const;
+  qint64 size() const;
+  // line text without line ending, \a line is zero based
+  QByteArray line(int line) const;
+  QString lineText(int line) const;
+
+  /*!
+   * \brief find
+   * Zero based numbers of lines in [from, to) matching \a regexp. \a found is
+   * called for every \a batch matches, search stops if it returns false.
+   */
+  void find(const QRegularExpression& regexp, int from, int to,
+            const std::function<bool(const std::vector<int>&)>& found,
+            const std::atomic_bool& stop, size_t batch = 1000) const;
+
+ private:
+  void reset();
+  int lineCountLocked() const;
+  qint64 lineEndLocked(size_t index) const;
+  // content at [pos, pos + length), shorter if file was truncated meanwhile
+  QByteArray readLocked(qint64 pos, qint64 length) const;
+  // lines [from, to) read at once, fewer if they exceed ChunkSize
+  std::vector<QByteArray> lines(int from, int to) const;
+
+  static constexpr qint64 ChunkSize{4 * 1024 * 1024};
+  static constexpr qint64 HeadSize{256};
+
+  mutable std::mutex m_lock;
+  mutable QFile m_file;
+  // beginning of the file, replaced file is recognized by it
+  QByteArray m_head;
+  qint64 m_size{0};
+  qint64 m_indexed{0};
+  // start offset of every line, the last one is start of unfinished line
+  std::vector<qint64> m_offsets{0};
+};
+
+}  // namespace FOEDAG
+
+#endif  // LOG_FILE_INDEX_H
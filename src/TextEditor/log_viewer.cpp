@@ -0,0 +1,513 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "log_viewer.h"
+
+#include <QApplication>
+#include <QCheckBox>
+#include <QClipboard>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QKeyEvent>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPainter>
+#include <QScrollBar>
+#include <QShortcut>
+#include <QToolButton>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <chrono>
+
+using namespace FOEDAG;
+
+// longer lines are cut when painted
+static constexpr int MaxPaintedLength{2000};
+// copying more lines than that would hang the application
+static constexpr int MaxCopiedLines{100000};
+
+LogView::LogView(const LogFileIndex* index, QWidget* parent)
+    : QAbstractScrollArea(parent), m_index(index) {
+  setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  setFocusPolicy(Qt::StrongFocus);
+  verticalScrollBar()->setSingleStep(1);
+  connect(verticalScrollBar(), &QScrollBar::valueChanged, viewport(),
+          qOverload<>(&QWidget::update));
+  connect(horizontalScrollBar(), &QScrollBar::valueChanged, viewport(),
+          qOverload<>(&QWidget::update));
+}
+
+bool LogView::updateLineCount() {
+  const int count = m_index->lineCount();
+  const bool changed = count != m_lineCount;
+  m_lineCount = count;
+  verticalScrollBar()->setRange(0, std::max(0, m_lineCount - visibleLines()));
+  verticalScrollBar()->setPageStep(visibleLines());
+  if (changed) viewport()->update();
+  return changed;
+}
+
+void LogView::setMarker(int line, Marker marker) {
+  m_markers[line] = marker;
+  viewport()->update();
+}
+
+void LogView::clearMarkers() {
+  m_markers.clear();
+  viewport()->update();
+}
+
+void LogView::setMatches(const std::vector<int> *matches) {
+  m_matches = matches;
+  viewport()->update();
+}
+
+void LogView::selectLines(int from, int to) {
+  m_selectionStart = from;
+  m_selectionEnd = to;
+  viewport()->update();
+}
+
+void LogView::showLine(int line) {
+  updateLineCount();
+  verticalScrollBar()->setValue(line - visibleLines() / 2);
+}
+
+void LogView::scrollToEnd() {
+  verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+bool LogView::atEnd() const {
+  return verticalScrollBar()->value() == verticalScrollBar()->maximum();
+}
+
+int LogView::firstVisibleLine() const { return verticalScrollBar()->value(); }
+
+int LogView::visibleLines() const {
+  return std::max(1, viewport()->height() / fontMetrics().height());
+}
+
+int LogView::lineAt(const QPoint& pos) const {
+  const int line = firstVisibleLine() + pos.y() / fontMetrics().height();
+  return std::clamp(line, 0, std::max(0, m_lineCount - 1));
+}
+
+int LogView::gutterWidth() const {
+  const int digits = QString::number(std::max(m_lineCount, 1)).size();
+  return fontMetrics().horizontalAdvance(QLatin1Char{'9'}) * digits + 8;
+}
+
+void LogView::paintEvent(QPaintEvent* event) {
+  QPainter painter{viewport()};
+  const QFontMetrics metrics = fontMetrics();
+  const int height = metrics.height();
+  const int width = viewport()->width();
+  const int gutter = gutterWidth();
+  const int first = firstVisibleLine();
+  const int offset = horizontalScrollBar()->value();
+  const int selectionFrom = std::min(m_selectionStart, m_selectionEnd);
+  const int selectionTo = std::max(m_selectionStart, m_selectionEnd);
+  painter.fillRect(QRect{0, 0, gutter, viewport()->height()},
+                   palette().alternateBase());
+  int maxWidth = m_maxWidth;
+  for (int row = 0; row <= visibleLines(); row++) {
+    const int line = first + row;
+    if (line >= m_lineCount) break;
+    const QRect rect{gutter, row * height, width - gutter, height};
+    const bool selected = line >= selectionFrom && line <= selectionTo;
+    auto marker = m_markers.find(line);
+    if (selected) {
+      painter.fillRect(rect, palette().highlight());
+    } else if (marker != m_markers.end()) {
+      painter.fillRect(rect, marker->second == Error ? QColor{255, 220, 220}
+                                                     : QColor{255, 245, 200});
+    } else if (m_matches &&
+               std::binary_search(m_matches->cbegin(), m_matches->cend(),
+                                  line)) {
+      painter.fillRect(rect, QColor{210, 230, 255});
+    }
+    painter.setPen(palette().color(QPalette::Dark));
+    painter.drawText(QRect{0, row * height, gutter - 4, height},
+                     Qt::AlignRight | Qt::AlignVCenter,
+                     QString::number(line + 1));
+
+    QString text = m_index->lineText(line);
+    if (text.size() > MaxPaintedLength) text.truncate(MaxPaintedLength);
+    text.replace(QLatin1Char{'\t'}, QLatin1String{"    "});
+    maxWidth = std::max(maxWidth, metrics.horizontalAdvance(text));
+    painter.setClipRect(rect);
+    painter.setPen(palette().color(selected ? QPalette::HighlightedText
+                                            : QPalette::Text));
+    painter.drawText(gutter + 4 - offset, row * height + metrics.ascent(),
+                     text);
+    painter.setClipping(false);
+  }
+  if (maxWidth != m_maxWidth) {
+    // only lines seen so far are measured, whole file is never scanned
+    m_maxWidth = maxWidth;
+    horizontalScrollBar()->setRange(0,
+                                    std::max(0, m_maxWidth + gutter - width));
+    horizontalScrollBar()->setPageStep(width);
+  }
+}
+
+void LogView::resizeEvent(QResizeEvent* event) {
+  QAbstractScrollArea::resizeEvent(event);
+  updateLineCount();
+}
+
+void LogView::mousePressEvent(QMouseEvent* event) {
+  if (event->button() != Qt::LeftButton || m_lineCount == 0) return;
+  const int line = lineAt(event->pos());
+  if (!(event->modifiers() & Qt::ShiftModifier) || m_selectionStart == -1)
+    m_selectionStart = line;
+  m_selectionEnd = line;
+  viewport()->update();
+}
+
+void LogView::mouseMoveEvent(QMouseEvent* event) {
+  if (!(event->buttons() & Qt::LeftButton) || m_selectionStart == -1) return;
+  m_selectionEnd = lineAt(event->pos());
+  viewport()->update();
+}
+
+void LogView::keyPressEvent(QKeyEvent* event) {
+  if (event->matches(QKeySequence::Copy)) {
+    copySelection();
+    return;
+  }
+  if (event->matches(QKeySequence::MoveToStartOfDocument)) {
+    verticalScrollBar()->setValue(0);
+    return;
+  }
+  if (event->matches(QKeySequence::MoveToEndOfDocument)) {
+    scrollToEnd();
+    return;
+  }
+  QAbstractScrollArea::keyPressEvent(event);
+}
+
+void LogView::copySelection() const {
+  if (m_selectionStart == -1) return;
+  const int from = std::min(m_selectionStart, m_selectionEnd);
+  const int to = std::min(std::max(m_selectionStart, m_selectionEnd),
+                          from + MaxCopiedLines - 1);
+  QStringList lines;
+  for (int line = from; line <= to; line++)
+    lines.append(m_index->lineText(line));
+  QApplication::clipboard()->setText(lines.join(QLatin1Char{'\n'}));
+}
+
+LogViewer::LogViewer(const QString& fileName, QWidget* parent)
+    : QWidget(parent), m_fileName(fileName) {
+  m_view = new LogView{&m_index, this};
+  m_view->setMatches(&m_matches);
+
+  m_searchEdit = new QLineEdit{this};
+  m_searchEdit->setPlaceholderText(tr("Search"));
+  m_searchEdit->setClearButtonEnabled(true);
+  m_regexp = new QCheckBox{tr("Regular expression"), this};
+  auto previous = new QToolButton{this};
+  previous->setArrowType(Qt::UpArrow);
+  previous->setToolTip(tr("Previous match (Shift+F3)"));
+  auto next = new QToolButton{this};
+  next->setArrowType(Qt::DownArrow);
+  next->setToolTip(tr("Next match (F3)"));
+  m_status = new QLabel{this};
+
+  auto searchBar = new QHBoxLayout;
+  searchBar->setContentsMargins(4, 2, 4, 2);
+  searchBar->addWidget(m_searchEdit, 1);
+  searchBar->addWidget(m_regexp);
+  searchBar->addWidget(previous);
+  searchBar->addWidget(next);
+  searchBar->addWidget(m_status, 1);
+  auto box = new QVBoxLayout{this};
+  box->setContentsMargins(0, 0, 0, 0);
+  box->setSpacing(0);
+  box->addLayout(searchBar);
+  box->addWidget(m_view);
+  setLayout(box);
+
+  // search starts when typing pauses
+  m_searchDelay.setSingleShot(true);
+  m_searchDelay.setInterval(300);
+  connect(&m_searchDelay, &QTimer::timeout, this, [this]() {
+    find(m_searchEdit->text(), m_regexp->isChecked());
+  });
+  connect(m_searchEdit, &QLineEdit::textChanged, &m_searchDelay,
+          qOverload<>(&QTimer::start));
+  connect(m_regexp, &QCheckBox::toggled, &m_searchDelay,
+          qOverload<>(&QTimer::start));
+  connect(m_searchEdit, &QLineEdit::returnPressed, this, [this]() {
+    findNext(!(QApplication::keyboardModifiers() & Qt::ShiftModifier));
+  });
+  connect(previous, &QToolButton::clicked, this, [this]() { findNext(false); });
+  connect(next, &QToolButton::clicked, this, [this]() { findNext(true); });
+  auto find = new QShortcut{QKeySequence::Find, this};
+  find->setContext(Qt::WidgetWithChildrenShortcut);
+  connect(find, &QShortcut::activated, this, [this]() {
+    m_searchEdit->setFocus();
+    m_searchEdit->selectAll();
+  });
+  auto findNext = new QShortcut{QKeySequence::FindNext, this};
+  findNext->setContext(Qt::WidgetWithChildrenShortcut);
+  connect(findNext, &QShortcut::activated, this,
+          [this]() { this->findNext(true); });
+  auto findPrevious = new QShortcut{QKeySequence::FindPrevious, this};
+  findPrevious->setContext(Qt::WidgetWithChildrenShortcut);
+  connect(findPrevious, &QShortcut::activated, this,
+          [this]() { this->findNext(false); });
+
+  m_pollTimer.setInterval(100);
+  connect(&m_pollTimer, &QTimer::timeout, this, &LogViewer::poll);
+  m_tailTimer.setInterval(1000);
+  connect(&m_tailTimer, &QTimer::timeout, this, &LogViewer::tail);
+
+  QString error;
+  m_loaded = m_index.open(m_fileName, &error);
+  if (m_loaded) {
+    startIndexing();
+    m_tailTimer.start();
+  } else {
+    m_status->setText(error);
+  }
+}
+
+LogViewer::~LogViewer() {
+  stopSearch();
+  stopIndexing();
+}
+
+QString LogViewer::getFileName() const { return m_fileName; }
+
+bool LogViewer::fileLoaded() const { return m_loaded; }
+
+void LogViewer::markLineError(int line) {
+  m_view->setMarker(line - 1, LogView::Error);
+  m_pendingLine = line - 1;
+  showPendingLine();
+}
+
+void LogViewer::markLineWarning(int line) {
+  m_view->setMarker(line - 1, LogView::Warning);
+  m_pendingLine = line - 1;
+  showPendingLine();
+}
+
+void LogViewer::clearMarkers() { m_view->clearMarkers(); }
+
+void LogViewer::selectLines(int lineFrom, int lineTo) {
+  m_view->selectLines(lineFrom - 1, lineTo - 1);
+  m_pendingLine = lineFrom - 1;
+  showPendingLine();
+}
+
+void LogViewer::reload() {
+  stopSearch();
+  stopIndexing();
+  QString error;
+  m_loaded = m_index.open(m_fileName, &error);
+  m_matches.clear();
+  m_currentMatch = -1;
+  m_view->clearMarkers();
+  m_view->updateLineCount();
+  if (!m_loaded) {
+    m_status->setText(error);
+    return;
+  }
+  startIndexing();
+  if (!m_searchExp.pattern().isEmpty()) startSearch(0);
+}
+
+void LogViewer::find(const QString& pattern, bool regexp) {
+  stopSearch();
+  m_matches.clear();
+  m_currentMatch = -1;
+  m_searchExp.setPattern(regexp ? pattern
+                                : QRegularExpression::escape(pattern));
+  m_view->setMatches(&m_matches);
+  if (!pattern.isEmpty() && m_searchExp.isValid()) startSearch(0);
+  updateSearchStatus();
+}
+
+void LogViewer::findNext(bool forward) {
+  if (m_matches.empty()) return;
+  const int size = static_cast<int>(m_matches.size());
+  if (m_currentMatch == -1) {
+    // start from the top of the view
+    auto it = std::lower_bound(m_matches.cbegin(), m_matches.cend(),
+                               m_view->firstVisibleLine());
+    m_currentMatch = static_cast<int>(it - m_matches.cbegin());
+    if (!forward) m_currentMatch--;
+  } else {
+    m_currentMatch += forward ? 1 : -1;
+  }
+  m_currentMatch = (m_currentMatch + size) % size;
+  const int line = m_matches.at(m_currentMatch);
+  m_view->selectLines(line, line);
+  m_view->showLine(line);
+  updateSearchStatus();
+}
+
+void LogViewer::poll() {
+  if (m_view->updateLineCount() && m_follow) m_view->scrollToEnd();
+  showPendingLine();
+  updateSearchStatus();
+  if (m_index.indexed() && !m_searching) m_pollTimer.stop();
+}
+
+void LogViewer::tail() {
+  const bool follow = m_view->atEnd();
+  const LogFileIndex::Update update = m_index.refresh();
+  if (update == LogFileIndex::Update::None) return;
+  m_follow = follow;
+  if (update == LogFileIndex::Update::Reset) {
+    stopSearch();
+    m_matches.clear();
+    m_currentMatch = -1;
+    m_view->clearMarkers();
+    m_view->selectLines(-1, -1);
+  }
+  // indexing continues from where it stopped
+  stopIndexing();
+  startIndexing();
+  if (m_searchExp.pattern().isEmpty() || m_searching) return;
+  startSearch(update == LogFileIndex::Update::Reset ? 0 : m_searchedTo);
+}
+
+void LogViewer::searchBatch(const std::vector<int> &lines) {
+  m_matches.insert(m_matches.end(), lines.cbegin(), lines.cend());
+  if (m_currentMatch == -1) {
+    // first match below the top of the view is shown as it comes
+    auto it = std::lower_bound(lines.cbegin(), lines.cend(),
+                               m_view->firstVisibleLine());
+    if (it != lines.cend()) {
+      m_currentMatch = static_cast<int>(m_matches.size() - (lines.cend() - it));
+      m_view->selectLines(*it, *it);
+      m_view->showLine(*it);
+    }
+  }
+  m_view->viewport()->update();
+}
+
+void LogViewer::searchDone(int searchedTo) {
+  m_searchedTo = searchedTo;
+  // lines could be appended while search was finishing
+  if (!m_index.indexed() || m_searchedTo < m_index.completeLineCount()) {
+    startSearch(m_searchedTo);
+    return;
+  }
+  m_searching = false;
+  if (m_currentMatch == -1 && !m_matches.empty()) findNext(true);
+  updateSearchStatus();
+}
+
+void LogViewer::startIndexing() {
+  m_stopIndex = false;
+  m_indexThread = std::thread{[this]() { m_index.buildIndex(m_stopIndex); }};
+  m_pollTimer.start();
+}
+
+void LogViewer::stopIndexing() {
+  m_stopIndex = true;
+  if (m_indexThread.joinable()) m_indexThread.join();
+}
+
+void LogViewer::startSearch(int from) {
+  stopSearch();
+  // search is resumed at unfinished last line, its old result is dropped
+  m_matches.erase(
+      std::lower_bound(m_matches.begin(), m_matches.end(), from),
+      m_matches.end());
+  if (m_currentMatch >= static_cast<int>(m_matches.size())) m_currentMatch = -1;
+  m_searching = true;
+  m_stopSearch = false;
+  m_pollTimer.start();
+  const int id = m_searchId;
+  m_searchThread = std::thread{[this, id, from, regexp = m_searchExp]() {
+    // results are handed over to GUI thread, stale ones are dropped there
+    auto found = [this, id](const std::vector<int> &lines) {
+      QMetaObject::invokeMethod(
+          this,
+          [this, id, lines]() {
+            if (id == m_searchId) searchBatch(lines);
+          },
+          Qt::QueuedConnection);
+      return true;
+    };
+    int next = from;
+    while (!m_stopSearch) {
+      // index grows meanwhile, search follows it
+      const bool complete = m_index.indexed();
+      const int to = m_index.lineCount();
+      m_index.find(regexp, next, to, found, m_stopSearch);
+      if (m_stopSearch) return;
+      next = to;
+      if (complete) {
+        // last line without line ending is searched again when it grows
+        next = std::min(to, m_index.completeLineCount());
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    }
+    QMetaObject::invokeMethod(
+        this,
+        [this, id, next]() {
+          if (id == m_searchId) searchDone(next);
+        },
+        Qt::QueuedConnection);
+  }};
+}
+
+void LogViewer::stopSearch() {
+  m_stopSearch = true;
+  if (m_searchThread.joinable()) m_searchThread.join();
+  m_searchId++;
+  m_searching = false;
+}
+
+void LogViewer::showPendingLine() {
+  if (m_pendingLine < 0) return;
+  if (m_pendingLine < m_index.lineCount() || m_index.indexed()) {
+    m_view->showLine(m_pendingLine);
+    m_pendingLine = -1;
+  }
+}
+
+void LogViewer::updateSearchStatus() {
+  QString status;
+  if (!m_searchExp.pattern().isEmpty()) {
+    if (!m_searchExp.isValid()) {
+      status = tr("Invalid expression");
+    } else {
+      status = (m_currentMatch == -1)
+                   ? tr("%1 matches").arg(m_matches.size())
+                   : tr("%1 of %2 matches")
+                         .arg(m_currentMatch + 1)
+                         .arg(m_matches.size());
+      if (m_searching) status += tr(", searching...");
+    }
+  } else if (!m_index.indexed()) {
+    status = tr("Indexing...");
+  }
+  m_status->setText(status);
+  emit searchUpdated(static_cast<int>(m_matches.size()));
+}
@@ -0,0 +1,162 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOG_VIEWER_H
+#define LOG_VIEWER_H
+
+#include <QAbstractScrollArea>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QWidget>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "log_file_index.h"
+
+class QLabel;
+class QLineEdit;
+class QCheckBox;
+
+namespace FOEDAG {
+
+/*!
+ * \brief The LogView class
+ * Paints only visible lines of LogFileIndex.
+ */
+class LogView : public QAbstractScrollArea {
+  Q_OBJECT
+ public:
+  enum Marker { Error, Warning };
+
+  explicit LogView(const LogFileIndex* index, QWidget* parent = nullptr);
+
+  // returns true if number of lines changed
+  bool updateLineCount();
+  void setMarker(int line, Marker marker);
+  void clearMarkers();
+  // sorted search results, highlighted by the view
+  void setMatches(const std::vector<int>* matches);
+  void selectLines(int from, int to);
+  // zero based line is scrolled into the middle of the view
+  void showLine(int line);
+  void scrollToEnd();
+  bool atEnd() const;
+  int firstVisibleLine() const;
+
+ protected:
+  void paintEvent(QPaintEvent* event) override;
+  void resizeEvent(QResizeEvent* event) override;
+  void mousePressEvent(QMouseEvent* event) override;
+  void mouseMoveEvent(QMouseEvent* event) override;
+  void keyPressEvent(QKeyEvent* event) override;
+
+ private:
+  int visibleLines() const;
+  int lineAt(const QPoint& pos) const;
+  int gutterWidth() const;
+  void copySelection() const;
+
+  const LogFileIndex* m_index;
+  int m_lineCount{0};
+  int m_selectionStart{-1};
+  int m_selectionEnd{-1};
+  int m_maxWidth{0};
+  std::map<int, Marker> m_markers;
+  const std::vector<int>* m_matches{nullptr};
+};
+
+/*!
+ * \brief The LogViewer class
+ * Read-only viewer for log files too large for Editor. File is indexed on
+ * worker thread, search runs on worker thread as well and results are shown
+ * as they come. Lines appended to the file are picked up
+ * periodically, view follows the end of file if it was scrolled there.
+ */
+class LogViewer : public QWidget {
+  Q_OBJECT
+ public:
+  explicit LogViewer(const QString& fileName, QWidget* parent = nullptr);
+  ~LogViewer() override;
+
+  QString getFileName() const;
+  bool fileLoaded() const;
+  // line numbers are one based, same as in Editor
+  void markLineError(int line);
+  void markLineWarning(int line);
+  void clearMarkers();
+  void selectLines(int lineFrom, int lineTo);
+  void reload();
+
+  void find(const QString& pattern, bool regexp);
+  void findNext(bool forward = true);
+  const std::vector<int>& matches() const { return m_matches; }
+  bool searchFinished() const { return !m_searching; }
+
+ signals:
+  void searchUpdated(int matches);
+
+ private slots:
+  void poll();
+  void tail();
+
+ private:
+  void searchBatch(const std::vector<int>& lines);
+  void searchDone(int searchedTo);
+  void startIndexing();
+  void stopIndexing();
+  void startSearch(int from);
+  void stopSearch();
+  void showPendingLine();
+  void updateSearchStatus();
+
+  QString m_fileName;
+  bool m_loaded{false};
+  LogFileIndex m_index;
+  LogView* m_view{nullptr};
+  QLineEdit* m_searchEdit{nullptr};
+  QCheckBox* m_regexp{nullptr};
+  QLabel* m_status{nullptr};
+  QTimer m_pollTimer;
+  QTimer m_tailTimer;
+  QTimer m_searchDelay;
+  // view is scrolled to the end when lines are appended
+  bool m_follow{false};
+
+  std::thread m_indexThread;
+  std::atomic_bool m_stopIndex{false};
+
+  std::thread m_searchThread;
+  std::atomic_bool m_stopSearch{false};
+  QRegularExpression m_searchExp;
+  int m_searchId{0};
+  int m_searchedTo{0};
+  bool m_searching{false};
+  std::vector<int> m_matches;
+  int m_currentMatch{-1};
+
+  // line waiting for index to reach it, zero based
+  int m_pendingLine{-1};
+};
+
+}  // namespace FOEDAG
+
+#endif  // LOG_VIEWER_H
@@ -63,10 +63,18 @@ int TextEditorForm::OpenFile(const QString &strFileName) {
     m_tab_editor->setCurrentIndex(index);
     return ret;
   }
+  auto logViewer = m_logViewers.value(strFileName);
+  if (logViewer) {
+    m_tab_editor->setCurrentWidget(logViewer);
+    return ret;
+  }
 
   int filetype{FILE_TYPE_UNKOWN};
   QFileInfo fileInfo(strFileName);
   if (!fileInfo.exists()) return -1;
+  // QScintilla needs whole file in memory, large logs are mapped instead
+  if (fileInfo.size() >= m_logViewerThreshold)
+    return OpenLogViewer(strFileName);
   QString filename = fileInfo.fileName();
   QString suffix = fileInfo.suffix();
   static const std::map<FileType, QStringList> types{
@@ -112,11 +120,32 @@ int TextEditorForm::OpenFile(const QString &strFileName) {
   return editor->fileLoaded() ? 0 : -1;
 }
 
+int TextEditorForm::OpenLogViewer(const QString &strFileName) {
+  QFileInfo fileInfo(strFileName);
+  auto viewer = new LogViewer{strFileName, this};
+  if (!viewer->fileLoaded()) {
+    delete viewer;
+    return -1;
+  }
+  int index = m_tab_editor->addTab(viewer, fileInfo.fileName());
+  m_tab_editor->setCurrentIndex(index);
+  m_tab_editor->setTabToolTip(index, fileInfo.absoluteFilePath());
+  m_logViewers.insert(strFileName, viewer);
+  return 0;
+}
+
 int TextEditorForm::OpenFileWithLine(const QString &strFileName, int line,
                                      bool error) {
   int res = OpenFile(strFileName);
   if (res == 0) {
-    if (line != -1) {
+    auto logViewer = m_logViewers.value(strFileName);
+    if (logViewer && line != -1) {
+      logViewer->clearMarkers();
+      if (error)
+        logViewer->markLineError(line);
+      else
+        logViewer->markLineWarning(line);
+    } else if (line != -1) {
       auto pair = m_map_file_tabIndex_editor.value(strFileName);
       pair.second->clearMarkers();
       if (error)
@@ -133,6 +162,12 @@ int TextEditorForm::OpenFileWithSelection(const QString &strFileName,
                                           int lineFrom, int lineTo) {
   int res = OpenFile(strFileName);
   if (res == 0) {
+    auto logViewer = m_logViewers.value(strFileName);
+    if (logViewer) {
+      logViewer->clearMarkers();
+      logViewer->selectLines(lineFrom, lineTo);
+      return 0;
+    }
     auto pair = m_map_file_tabIndex_editor.value(strFileName);
     pair.second->clearMarkers();
     pair.second->selectLines(lineFrom, lineTo);
@@ -146,7 +181,12 @@ void TextEditorForm::SlotTabCloseRequested(int index) {
 }
 
 void TextEditorForm::SlotCurrentChanged(int index) {
-  Editor *tabEditor = qobject_cast<Editor *>(m_tab_editor->widget(index));
+  QWidget *widget = m_tab_editor->widget(index);
+  if (auto logViewer = qobject_cast<LogViewer *>(widget)) {
+    emit CurrentFileChanged(logViewer->getFileName());
+    return;
+  }
+  Editor *tabEditor = qobject_cast<Editor *>(widget);
   emit CurrentFileChanged(tabEditor ? tabEditor->getFileName() : QString{});
 }
 
@@ -171,7 +211,7 @@ void TextEditorForm::SlotShowSearchDialog(const QString &strWord) {
 
 void TextEditorForm::SlotFind(const QString &strFindWord) {
 #ifndef USE_MONACO_EDITOR
-  Editor *tabEditor = (Editor *)m_tab_editor->currentWidget();
+  Editor *tabEditor = qobject_cast<Editor *>(m_tab_editor->currentWidget());
   if (tabEditor) {
     tabEditor->FindFirst(strFindWord);
   }
@@ -180,7 +220,7 @@ void TextEditorForm::SlotFind(const QString &strFindWord) {
 
 void TextEditorForm::SlotFindNext(const QString &strFindWord) {
 #ifndef USE_MONACO_EDITOR
-  Editor *tabEditor = (Editor *)m_tab_editor->currentWidget();
+  Editor *tabEditor = qobject_cast<Editor *>(m_tab_editor->currentWidget());
   if (tabEditor) {
     tabEditor->FindNext(strFindWord);
   }
@@ -190,7 +230,7 @@ void TextEditorForm::SlotFindNext(const QString &strFindWord) {
 void TextEditorForm::SlotReplace(const QString &strFindWord,
                                  const QString &strDesWord) {
 #ifndef USE_MONACO_EDITOR
-  Editor *tabEditor = (Editor *)m_tab_editor->currentWidget();
+  Editor *tabEditor = qobject_cast<Editor *>(m_tab_editor->currentWidget());
   if (tabEditor) {
     tabEditor->Replace(strFindWord, strDesWord);
   }
@@ -200,7 +240,7 @@ void TextEditorForm::SlotReplace(const QString &strFindWord,
 void TextEditorForm::SlotReplaceAndFind(const QString &strFindWord,
                                         const QString &strDesWord) {
 #ifndef USE_MONACO_EDITOR
-  Editor *tabEditor = (Editor *)m_tab_editor->currentWidget();
+  Editor *tabEditor = qobject_cast<Editor *>(m_tab_editor->currentWidget());
   if (tabEditor) {
     tabEditor->ReplaceAndFind(strFindWord, strDesWord);
   }
@@ -210,7 +250,7 @@ void TextEditorForm::SlotReplaceAndFind(const QString &strFindWord,
 void TextEditorForm::SlotReplaceAll(const QString &strFindWord,
                                     const QString &strDesWord) {
 #ifndef USE_MONACO_EDITOR
-  Editor *tabEditor = (Editor *)m_tab_editor->currentWidget();
+  Editor *tabEditor = qobject_cast<Editor *>(m_tab_editor->currentWidget());
   if (tabEditor) {
     tabEditor->ReplaceAll(strFindWord, strDesWord);
   }
@@ -251,6 +291,13 @@ void TextEditorForm::fileModifiedOnDisk(const QString &path) {
 bool TextEditorForm::TabCloseRequested(int index) {
   if (index == -1) return false;
 
+  if (auto logViewer = qobject_cast<LogViewer *>(m_tab_editor->widget(index))) {
+    m_logViewers.remove(logViewer->getFileName());
+    m_tab_editor->removeTab(index);
+    delete logViewer;
+    return true;
+  }
+
   Editor *tabItem = qobject_cast<Editor *>(m_tab_editor->widget(index));
   if (!tabItem) {
     m_tab_editor->removeTab(index);
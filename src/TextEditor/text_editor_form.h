@@ -10,6 +10,7 @@
 #else  // #ifdef USE_MONACO_EDITOR
 #include "editor.h"
 #endif  // #ifdef USE_MONACO_EDITOR
+#include "log_viewer.h"
 #include "search_dialog.h"
 
 namespace FOEDAG {
@@ -40,6 +41,10 @@ class TextEditorForm : public QWidget {
   TabWidget *GetTabWidget() { return m_tab_editor; }
   bool TabCloseRequested(int index);
 
+  // files of this size or larger are opened in read-only LogViewer
+  void SetLogViewerThreshold(qint64 size) { m_logViewerThreshold = size; }
+  qint64 LogViewerThreshold() const { return m_logViewerThreshold; }
+
  signals:
   void CurrentFileChanged(QString);
   void FileChanged(const QString &);
@@ -61,8 +66,12 @@ class TextEditorForm : public QWidget {
   void fileModifiedOnDisk(const QString &path);
 
  private:
+  int OpenLogViewer(const QString &strFileName);
+
   TabWidget *m_tab_editor;
   QMap<QString, QPair<int, Editor *>> m_map_file_tabIndex_editor;
+  QMap<QString, LogViewer *> m_logViewers;
+  qint64 m_logViewerThreshold{64 * 1024 * 1024};
 
 #ifndef USE_MONACO_EDITOR
   SearchDialog *m_searchDialog;
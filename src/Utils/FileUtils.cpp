@@ -28,7 +28,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string.h>
 #include <sys/stat.h>
 
+#include <QCryptographicHash>
+#include <QDeadlineTimer>
 #include <QDebug>
+#include <QFile>
 #include <QProcess>
 #include <algorithm>
 #include <filesystem>
@@ -40,7 +43,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Utils/StringUtils.h"
 
-std::vector<QProcess*> FOEDAG::FileUtils::m_processes{};
+std::atomic_uint32_t FOEDAG::FileUtils::m_terminateRequests{0};
 
 namespace FOEDAG {
 
@@ -297,14 +300,23 @@ Return FileUtils::ExecuteSystemCommand(const std::string& command,
     auto success = process.startDetached(program, args_);
     return {success ? 0 : -1,
             QString{"%1: Failed to start."}.arg(program).toStdString()};
-  } else {
-    m_processes.push_back(&process);
-    process.start(program, args_);
   }
-
-  bool finished = process.waitForFinished(timeout_ms);
-  auto it = std::find(m_processes.begin(), m_processes.end(), &process);
-  if (it != m_processes.end()) m_processes.erase(it);
+  const uint32_t terminateRequests = m_terminateRequests;
+  process.start(program, args_);
+
+  // QProcess can only be used from the thread that created it
+  QDeadlineTimer deadline{timeout_ms};
+  while (process.state() != QProcess::NotRunning &&
+         !process.waitForFinished(100)) {
+    if (m_terminateRequests != terminateRequests) {
+      process.terminate();
+      process.waitForFinished(-1);
+    } else if (deadline.hasExpired()) {
+      break;
+    }
+  }
+  const bool finished = process.state() == QProcess::NotRunning &&
+                        process.error() != QProcess::FailedToStart;
 
   std::string message{};
   if (!finished) {
@@ -329,6 +341,14 @@ time_t FileUtils::Mtime(const std::filesystem::path& path) {
   return statbuf.st_mtime;
 }
 
+std::string FileUtils::FileHash(const std::filesystem::path& path) {
+  QFile file{QString::fromStdString(path.string())};
+  if (!file.open(QFile::ReadOnly)) return {};
+  QCryptographicHash hash{QCryptographicHash::Sha1};
+  if (!hash.addData(&file)) return {};
+  return hash.result().toHex().toStdString();
+}
+
 bool FileUtils::IsUptoDate(const std::string& sourceFile,
                            const std::string& outputFile) {
   time_t time_output = -1;
@@ -379,9 +399,7 @@ void FileUtils::printArgs(int argc, const char* argv[]) {
   qDebug() << res.c_str();
 }
 
-void FileUtils::terminateSystemCommand() {
-  for (auto pr : m_processes) pr->terminate();
-}
+void FileUtils::terminateSystemCommand() { m_terminateRequests++; }
 
 bool FileUtils::removeFile(const std::string& file) noexcept {
   const std::filesystem::path path{file};
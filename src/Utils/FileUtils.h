@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <filesystem>
 #include <regex>
@@ -86,6 +87,10 @@ class FileUtils final {
 
   static time_t Mtime(const std::filesystem::path& path);
 
+  // return hex encoded SHA-1 of the file content or empty string if the file
+  // can't be read
+  static std::string FileHash(const std::filesystem::path& path);
+
   static bool IsUptoDate(const std::string& sourceFile,
                          const std::string& outputFile);
 
@@ -109,6 +114,8 @@ class FileUtils final {
   // for the debug purposes, this function prints arguments
   static void printArgs(int argc, const char* argv[]);
 
+  // thread safe, running commands are terminated by the threads that run
+  // them
   static void terminateSystemCommand();
 
   static bool convertPstoNsInSDFFile(const std::filesystem::path& in_path,
@@ -119,7 +126,9 @@ class FileUtils final {
   FileUtils(const FileUtils& orig) = delete;
   ~FileUtils() = delete;
 
-  static std::vector<QProcess*> m_processes;
+  // commands can be executed from several threads at once, every command
+  // polls this counter and terminates its own process when it changes
+  static std::atomic_uint32_t m_terminateRequests;
 };
 
 };  // namespace FOEDAG
@@ -0,0 +1,91 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "JobPool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <queue>
+#include <thread>
+
+namespace FOEDAG {
+
+std::set<JobPool*> JobPool::m_running{};
+std::mutex JobPool::m_runningLock{};
+
+void JobPool::Run(size_t count, const Job& job, const Finished& finished) {
+  Groups groups(count);
+  for (size_t i = 0; i < count; i++) groups[i].push_back(i);
+  Run(groups, job, finished);
+}
+
+void JobPool::Run(const Groups& groups, const Job& job,
+                  const Finished& finished) {
+  {
+    std::scoped_lock guard{m_runningLock};
+    m_stop = false;
+    m_running.insert(this);
+  }
+  size_t count{0};
+  for (const auto& group : groups) count += group.size();
+  uint32_t threads =
+      (m_threads == 0) ? std::thread::hardware_concurrency() : m_threads;
+  threads = static_cast<uint32_t>(
+      std::clamp<size_t>(threads, 1, std::max<size_t>(groups.size(), 1)));
+
+  std::mutex lock;
+  std::condition_variable cv;
+  std::queue<size_t> done;
+  std::atomic_size_t next{0};
+  auto worker = [&]() {
+    for (size_t g = next++; g < groups.size(); g = next++) {
+      for (size_t index : groups[g]) {
+        if (!m_stop) job(index);
+        {
+          std::scoped_lock guard{lock};
+          done.push(index);
+        }
+        cv.notify_one();
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  if (count != 0)
+    for (uint32_t i = 0; i < threads; i++) workers.emplace_back(worker);
+  for (size_t reported = 0; reported < count; reported++) {
+    std::unique_lock guard{lock};
+    cv.wait(guard, [&done]() { return !done.empty(); });
+    const size_t index = done.front();
+    done.pop();
+    guard.unlock();
+    if (finished) finished(index);
+  }
+  for (auto& w : workers) w.join();
+
+  std::scoped_lock guard{m_runningLock};
+  m_running.erase(this);
+}
+
+void JobPool::StopAll() {
+  std::scoped_lock guard{m_runningLock};
+  for (auto pool : m_running) pool->Stop();
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,76 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The JobPool class
+ * Runs indexed jobs on at most Threads() worker threads. Jobs of one group
+ * depend on each other and run one after another in the given order, groups
+ * run in parallel. 'finished' is called for every job from the thread that
+ * called Run(), in completion order, so it may report and touch state that is
+ * not thread safe. Stop() only skips jobs that have not started yet, running
+ * jobs check Stopped() and stop their own processes, a process is never
+ * terminated from a thread that doesn't own it.
+ */
+class JobPool {
+ public:
+  using Job = std::function<void(size_t index)>;
+  using Finished = std::function<void(size_t index)>;
+  using Groups = std::vector<std::vector<size_t>>;
+
+  // 0 means number of hardware threads
+  explicit JobPool(uint32_t threads = 0) : m_threads(threads) {}
+  JobPool(const JobPool&) = delete;
+  JobPool& operator=(const JobPool&) = delete;
+
+  void Threads(uint32_t threads) { m_threads = threads; }
+  uint32_t Threads() const { return m_threads; }
+
+  // every job is its own group
+  void Run(size_t count, const Job& job, const Finished& finished = {});
+  void Run(const Groups& groups, const Job& job,
+           const Finished& finished = {});
+
+  // thread safe
+  void Stop() { m_stop = true; }
+  bool Stopped() const { return m_stop; }
+
+  // stop all pools that are running now, used by Compiler::Stop()
+  static void StopAll();
+
+ private:
+  uint32_t m_threads{0};
+  std::atomic_bool m_stop{false};
+
+  static std::set<JobPool*> m_running;
+  static std::mutex m_runningLock;
+};
+
+}  // namespace FOEDAG
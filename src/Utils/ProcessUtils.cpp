@@ -20,6 +20,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "ProcessUtils.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <string>
 
@@ -33,41 +35,98 @@ ProcessUtils::uint ProcessUtils::Utilization() const {
 
 void ProcessUtils::Frequency(uint p) { m_frequency = p; }
 
-void process_mem_usage(int64_t processId, const char *proccessIdStr,
-                       double &vm_usage /*in kiB*/) {
+struct ProcessSample {
+  double vm{0};  // kiB
+  uint64_t cpuTime{0};  // ms
+  uint64_t peakRss{0};  // kiB
+  uint64_t readBytes{0};
+  uint64_t writeBytes{0};
+};
+
+// values are left unchanged if process is gone already
+void process_sample(int64_t processId, const std::string &procDir,
+                    ProcessSample &sample) {
 #if (defined(_MSC_VER) || defined(__CYGWIN__))
   PROCESS_MEMORY_COUNTERS_EX pmc;
   auto p = OpenProcess(PROCESS_ALL_ACCESS, FALSE, processId);
-  GetProcessMemoryInfo(p, (PROCESS_MEMORY_COUNTERS *)&pmc, sizeof(pmc));
-  vm_usage = pmc.PrivateUsage / 1024.0;
+  if (!p) return;
+  if (GetProcessMemoryInfo(p, (PROCESS_MEMORY_COUNTERS *)&pmc, sizeof(pmc))) {
+    sample.vm = pmc.PrivateUsage / 1024.0;
+    sample.peakRss = pmc.PeakWorkingSetSize / 1024;
+  }
+  FILETIME creation, exit, kernel, user;
+  if (GetProcessTimes(p, &creation, &exit, &kernel, &user)) {
+    auto ticks = [](const FILETIME &t) {
+      return (uint64_t{t.dwHighDateTime} << 32) | t.dwLowDateTime;
+    };
+    // 100 ns units
+    sample.cpuTime = (ticks(kernel) + ticks(user)) / 10000;
+  }
+  IO_COUNTERS io;
+  if (GetProcessIoCounters(p, &io)) {
+    sample.readBytes = io.ReadTransferCount;
+    sample.writeBytes = io.WriteTransferCount;
+  }
+  CloseHandle(p);
 #else
-  std::ifstream stat_stream(proccessIdStr, std::ios_base::in);
+  std::ifstream stat_stream(procDir + "stat", std::ios_base::in);
+  if (!stat_stream.is_open()) return;
 
   // dummy vars for leading entries in stat that we don't care about
   std::string pid, comm, state, ppid, pgrp, session, tty_nr;
   std::string tpgid, flags, minflt, cminflt, majflt, cmajflt;
-  std::string utime, stime, cutime, cstime, priority, nice;
+  std::string priority, nice;
   std::string O, itrealvalue, starttime;
 
-  unsigned long vsize;
+  unsigned long utime{0}, stime{0}, cutime{0}, cstime{0};
+  unsigned long vsize{0};
 
   stat_stream >> pid >> comm >> state >> ppid >> pgrp >> session >> tty_nr >>
       tpgid >> flags >> minflt >> cminflt >> majflt >> cmajflt >> utime >>
       stime >> cutime >> cstime >> priority >> nice >> O >> itrealvalue >>
       starttime >> vsize;  // don't care about the rest
-
+  if (!stat_stream) return;
   stat_stream.close();
-  vm_usage = vsize / 1024.0;
+  sample.vm = vsize / 1024.0;
+  static const long ticks = sysconf(_SC_CLK_TCK);
+  // children the tool waited for count as well
+  if (ticks > 0)
+    sample.cpuTime = (utime + stime + cutime + cstime) * 1000 / ticks;
+
+  std::ifstream status_stream(procDir + "status", std::ios_base::in);
+  std::string line;
+  while (std::getline(status_stream, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      sample.peakRss = std::strtoull(line.c_str() + 6, nullptr, 10);
+      break;
+    }
+  }
+
+  // not readable if process belongs to another user
+  std::ifstream io_stream(procDir + "io", std::ios_base::in);
+  std::string key;
+  uint64_t value{0};
+  while (io_stream >> key >> value) {
+    if (key == "read_bytes:")
+      sample.readBytes = value;
+    else if (key == "write_bytes:")
+      sample.writeBytes = value;
+  }
 #endif
 }
 
 void ProcessUtils::Start(int64_t processId) {
   auto start = [processId, this]() {
-    auto str = ("/proc/" + std::to_string(processId) + "/stat");
+    const std::string procDir = "/proc/" + std::to_string(processId) + "/";
+    ProcessSample sample;
     while (!m_stop) {
-      double vm;
-      process_mem_usage(processId, str.c_str(), vm);
-      m_vm = std::max(m_vm, vm);
+      process_sample(processId, procDir, sample);
+      m_vm = std::max(m_vm, sample.vm);
+      // cumulative counters, last sample is the closest to the final value
+      m_cpuTime = static_cast<uint>(sample.cpuTime);
+      m_peakRss = std::max(m_peakRss, static_cast<uint>(sample.peakRss));
+      m_readBytes = sample.readBytes;
+      m_writeBytes = sample.writeBytes;
 
       std::chrono::milliseconds dura(m_frequency);
       std::this_thread::sleep_for(dura);
@@ -43,6 +43,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <unistd.h>
 #endif
 
+#include <cstdint>
 #include <thread>
 
 namespace FOEDAG {
@@ -59,6 +60,15 @@ class ProcessUtils {
    */
   uint Utilization() const;
 
+  // user + system time of the process and the children it waited for in ms,
+  // as of the last sample
+  uint CpuTime() const { return m_cpuTime; }
+  // max resident set size in kiB
+  uint PeakRss() const { return m_peakRss; }
+  // bytes the process read from and wrote to storage
+  uint64_t ReadBytes() const { return m_readBytes; }
+  uint64_t WriteBytes() const { return m_writeBytes; }
+
   /*!
    * \brief Period sets the frequency of measurment
    */
@@ -74,6 +84,10 @@ class ProcessUtils {
   bool m_stop{false};
   std::thread *m_thread{nullptr};
   double m_vm{0};
+  uint m_cpuTime{0};
+  uint m_peakRss{0};
+  uint64_t m_readBytes{0};
+  uint64_t m_writeBytes{0};
 };
 
 }  // namespace FOEDAG
@@ -0,0 +1,93 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "StartupProfiler.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace FOEDAG {
+
+StartupProfiler::StartupProfiler() {
+  const char* traceFile = std::getenv("FOEDAG_STARTUP_TRACE");
+  if (traceFile && *traceFile) Enable(traceFile);
+}
+
+StartupProfiler* StartupProfiler::Instance() {
+  static StartupProfiler profiler;
+  return &profiler;
+}
+
+void StartupProfiler::Enable(const std::filesystem::path& traceFile) {
+  std::scoped_lock lock{m_lock};
+  m_traceFile = traceFile;
+  m_enabled = true;
+  Tracer::Instance()->Enable(0);
+}
+
+void StartupProfiler::Disable() {
+  std::scoped_lock lock{m_lock};
+  if (m_enabled) Tracer::Instance()->Disable();
+  m_enabled = false;
+}
+
+int64_t StartupProfiler::Now() const { return Tracer::Instance()->Now(); }
+
+void StartupProfiler::Mark(const char* name, const char* category) {
+  if (!m_enabled) return;
+  Tracer::Instance()->Instant(name, category);
+}
+
+void StartupProfiler::Prompt() {
+  int64_t notReached{-1};
+  if (!m_timeToPrompt.compare_exchange_strong(notReached, Now())) return;
+  if (!m_enabled) return;
+  Mark("prompt");
+  std::filesystem::path file;
+  {
+    std::scoped_lock lock{m_lock};
+    file = m_traceFile;
+  }
+  if (file.empty()) return;
+  const bool ok = Write(file);
+  // session is traced only on request, see perf_trace
+  Disable();
+  std::cerr << "Time to prompt: " << TimeToPrompt() / 1000 << " ms";
+  if (ok)
+    std::cerr << ", startup trace: " << file.string();
+  else
+    std::cerr << ", failed to write startup trace: " << file.string();
+  std::cerr << std::endl;
+}
+
+std::string StartupProfiler::TraceJson() const {
+  return Tracer::Instance()->TraceJson();
+}
+
+bool StartupProfiler::Write(const std::filesystem::path& file) const {
+  return Tracer::Instance()->Write(file);
+}
+
+void StartupProfiler::Clear() {
+  Tracer::Instance()->Clear();
+  m_timeToPrompt = -1;
+}
+
+}  // namespace FOEDAG
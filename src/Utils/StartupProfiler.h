@@ -0,0 +1,91 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+#include "Utils/Tracer.h"
+
+namespace FOEDAG {
+
+/*!
+ * \brief The StartupProfiler class
+ * Traces startup phases with Tracer and writes the trace when the first
+ * prompt is ready. Enabled when FOEDAG_STARTUP_TRACE environment variable
+ * names the trace file. Disabled profiler only costs a flag check per scope.
+ */
+class StartupProfiler {
+ public:
+  static StartupProfiler* Instance();
+
+  bool Enabled() const { return m_enabled; }
+  // enables Tracer without memory sampling
+  void Enable(const std::filesystem::path& traceFile);
+  void Disable();
+
+  // microseconds since process start, same as Tracer::Now()
+  int64_t Now() const;
+
+  // name and category must be string literals
+  void Mark(const char* name, const char* category = "startup");
+
+  /*!
+   * \brief Prompt
+   * Called when the first prompt is ready. Records time to prompt, writes
+   * the trace file and stops tracing started by the profiler, only the first
+   * call matters.
+   */
+  void Prompt();
+  // microseconds, -1 if prompt is not reached yet
+  int64_t TimeToPrompt() const { return m_timeToPrompt; }
+
+  std::string TraceJson() const;
+  bool Write(const std::filesystem::path& file) const;
+  void Clear();
+
+ private:
+  StartupProfiler();
+  std::atomic_bool m_enabled{false};
+  std::filesystem::path m_traceFile;
+  std::atomic<int64_t> m_timeToPrompt{-1};
+  mutable std::mutex m_lock;
+};
+
+/*!
+ * \brief The StartupScope class
+ * Records its lifetime as a startup span.
+ */
+class StartupScope : public TraceScope {
+ public:
+  // name and category must be string literals
+  explicit StartupScope(const char* name, const char* category = "startup")
+      : TraceScope(name, category) {}
+  // name is copied only if tracer is enabled
+  explicit StartupScope(const std::string& name,
+                        const char* category = "startup")
+      : TraceScope(name, category) {}
+};
+
+}  // namespace FOEDAG
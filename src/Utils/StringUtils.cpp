@@ -268,6 +268,28 @@ std::string StringUtils::toUpper(const std::string& text) {
   return result;
 }
 
+std::string StringUtils::jsonEscape(const std::string& text) {
+  std::string result;
+  result.reserve(text.size());
+  for (char c : text) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        result += c;
+    }
+  }
+  return result;
+}
+
 void StringUtils::setArgumentValue(StringVector& stringVector,
                                    const std::string& arg,
                                    const std::string& value) {
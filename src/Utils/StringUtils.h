@@ -135,6 +135,9 @@ class StringUtils final {
   // Converts the input text to upper case
   static std::string toUpper(const std::string& text);
 
+  // Escapes the input text for json string, control characters are dropped
+  static std::string jsonEscape(const std::string& text);
+
   // append or modify argument 'arg' with value 'value' inside 'stringVector'
   static void setArgumentValue(StringVector& stringVector,
                                const std::string& arg,
@@ -0,0 +1,344 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Tracer.h"
+
+#include <QCoreApplication>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "Utils/StringUtils.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace FOEDAG {
+
+using Clock = std::chrono::steady_clock;
+
+// static initialization is close enough to the process start
+static const Clock::time_point s_processStart{Clock::now()};
+
+// kiB, -1 if not available
+static int64_t residentMemory() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return pmc.WorkingSetSize / 1024;
+#elif defined(__linux__)
+  std::ifstream statm{"/proc/self/statm"};
+  int64_t size{0}, resident{0};
+  if (statm >> size >> resident)
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+  return -1;
+}
+
+Tracer* Tracer::Instance() {
+  // never destroyed, threads may record events during exit
+  static Tracer* tracer = new Tracer;
+  return tracer;
+}
+
+void Tracer::Enable(uint32_t memorySampling) {
+  std::scoped_lock control{m_controlLock};
+  if (m_enabled) return;
+  m_enabled = true;
+  if (memorySampling == 0) return;
+  {
+    std::scoped_lock lock{m_samplerLock};
+    m_samplerStop = false;
+  }
+  m_sampler = std::thread{&Tracer::sampler, this, memorySampling};
+}
+
+void Tracer::Disable() {
+  std::scoped_lock control{m_controlLock};
+  m_enabled = false;
+  {
+    std::scoped_lock lock{m_samplerLock};
+    m_samplerStop = true;
+  }
+  m_samplerWait.notify_all();
+  if (m_sampler.joinable()) m_sampler.join();
+}
+
+int64_t Tracer::Now() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                               s_processStart)
+      .count();
+}
+
+Tracer::Buffer* Tracer::threadBuffer() {
+  // hands the buffer over when the thread exits
+  struct Owner {
+    Buffer* buffer{nullptr};
+    ~Owner() {
+      if (buffer) buffer->retired.store(true, std::memory_order_release);
+      buffer = nullptr;
+    }
+  };
+  thread_local Owner owner;
+  if (owner.buffer) return owner.buffer;
+  for (Buffer* buffer = m_buffers.load(std::memory_order_acquire); buffer;
+       buffer = buffer->next) {
+    bool retired{true};
+    if (buffer->retired.compare_exchange_strong(retired, false,
+                                                std::memory_order_acquire)) {
+      owner.buffer = buffer;
+      return buffer;
+    }
+  }
+  Buffer* buffer = new Buffer;
+  buffer->thread = ++m_threads;
+  buffer->head = buffer->tail = new Chunk;
+  // buffers are never removed, reader may walk the list any time
+  buffer->next = m_buffers.load(std::memory_order_relaxed);
+  while (!m_buffers.compare_exchange_weak(buffer->next, buffer,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+  }
+  owner.buffer = buffer;
+  return buffer;
+}
+
+Tracer::Event* Tracer::append() {
+  Buffer* buffer = threadBuffer();
+  const size_t count = buffer->count.load(std::memory_order_relaxed);
+  if (count - buffer->cleared.load(std::memory_order_relaxed) >=
+      MaxThreadEvents) {
+    m_dropped++;
+    return nullptr;
+  }
+  if (count != 0 && count % Chunk::Size == 0) {
+    // linked before the event is published, reader sees it after acquire
+    buffer->tail->next = new Chunk;
+    buffer->tail = buffer->tail->next;
+  }
+  return &buffer->tail->events[count % Chunk::Size];
+}
+
+void Tracer::publish() {
+  Buffer* buffer = threadBuffer();
+  buffer->count.store(buffer->count.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_release);
+}
+
+void Tracer::Complete(const char* name, const char* category, int64_t start,
+                      int64_t duration) {
+  if (!Enabled()) return;
+  Event* event = append();
+  if (!event) return;
+  event->name = name;
+  event->category = category;
+  event->phase = 'X';
+  event->start = start;
+  event->value = duration;
+  publish();
+}
+
+void Tracer::Complete(const std::string& name, const char* category,
+                      int64_t start, int64_t duration) {
+  if (!Enabled()) return;
+  Event* event = append();
+  if (!event) return;
+  event->label = name;
+  event->category = category;
+  event->phase = 'X';
+  event->start = start;
+  event->value = duration;
+  publish();
+}
+
+void Tracer::Counter(const char* name, int64_t value) {
+  if (!Enabled()) return;
+  Event* event = append();
+  if (!event) return;
+  event->name = name;
+  event->phase = 'C';
+  event->start = Now();
+  event->value = value;
+  publish();
+}
+
+void Tracer::Instant(const char* name, const char* category) {
+  if (!Enabled()) return;
+  Event* event = append();
+  if (!event) return;
+  event->name = name;
+  event->category = category;
+  event->phase = 'i';
+  event->start = Now();
+  publish();
+}
+
+void Tracer::Process(int64_t pid, const std::string& command, int64_t start,
+                     int64_t duration, int exitCode, uint32_t peakRss) {
+  if (!Enabled()) return;
+  Event* event = append();
+  if (!event) return;
+  const std::string program = command.substr(0, command.find(' '));
+  event->label = std::filesystem::path{program}.filename().string();
+  event->category = "process";
+  event->phase = 'X';
+  event->start = start;
+  event->value = duration;
+  event->pid = pid;
+  std::ostringstream args;
+  args << "\"command\":\"" << StringUtils::jsonEscape(command)
+       << "\",\"exit_code\":" << exitCode << ",\"peak_rss_kib\":" << peakRss;
+  event->args = args.str();
+  publish();
+}
+
+void Tracer::SampleMemory() {
+  const int64_t memory = residentMemory();
+  if (memory >= 0) Counter("rss_kib", memory);
+}
+
+void Tracer::sampler(uint32_t interval) {
+  std::unique_lock lock{m_samplerLock};
+  while (!m_samplerStop) {
+    lock.unlock();
+    SampleMemory();
+    lock.lock();
+    m_samplerWait.wait_for(lock, std::chrono::milliseconds{interval},
+                           [this]() { return m_samplerStop; });
+  }
+}
+
+std::string Tracer::TraceJson() const {
+  const int64_t pid = QCoreApplication::applicationPid();
+  std::ostringstream stream;
+  stream << "{\"traceEvents\":[";
+  bool first{true};
+  auto next = [&stream, &first]() -> std::ostringstream& {
+    if (!first) stream << ",";
+    first = false;
+    stream << "\n";
+    return stream;
+  };
+  std::map<int64_t, std::string> processes;
+  std::scoped_lock lock{m_readLock};
+  for (Buffer* buffer = m_buffers.load(std::memory_order_acquire); buffer;
+       buffer = buffer->next) {
+    const size_t count = buffer->count.load(std::memory_order_acquire);
+    const size_t cleared = buffer->cleared.load(std::memory_order_relaxed);
+    if (count <= cleared) continue;
+    next() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"tid\":" << buffer->thread << ",\"args\":{\"name\":\"thread "
+           << buffer->thread << "\"}}";
+    const Chunk* chunk = buffer->head;
+    for (size_t i = buffer->headStart; i < count; i++) {
+      if (i != buffer->headStart && i % Chunk::Size == 0) chunk = chunk->next;
+      if (i < cleared) continue;
+      const Event& event = chunk->events[i % Chunk::Size];
+      const std::string name = event.name ? event.name : event.label;
+      // child process is its own process and thread
+      next() << "{\"name\":\"" << StringUtils::jsonEscape(name)
+             << "\",\"cat\":\"" << event.category << "\",\"ph\":\""
+             << event.phase << "\",\"ts\":" << event.start
+             << ",\"pid\":" << (event.pid ? event.pid : pid)
+             << ",\"tid\":" << (event.pid ? event.pid : buffer->thread);
+      if (event.phase == 'X') {
+        stream << ",\"dur\":" << event.value;
+        if (!event.args.empty()) stream << ",\"args\":{" << event.args << "}";
+      } else if (event.phase == 'C') {
+        stream << ",\"args\":{\"value\":" << event.value << "}";
+      } else {
+        stream << ",\"s\":\"t\"";
+      }
+      stream << "}";
+      if (event.pid) processes.emplace(event.pid, name);
+    }
+  }
+  for (const auto& [processId, name] : processes) {
+    next() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << processId
+           << ",\"tid\":" << processId << ",\"args\":{\"name\":\""
+           << StringUtils::jsonEscape(name) << "\"}}";
+  }
+  stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return stream.str();
+}
+
+bool Tracer::Write(const std::filesystem::path& file) const {
+  std::ofstream stream{file};
+  if (!stream.is_open()) return false;
+  stream << TraceJson();
+  return stream.good();
+}
+
+void Tracer::Clear() {
+  std::scoped_lock lock{m_readLock};
+  for (Buffer* buffer = m_buffers.load(std::memory_order_acquire); buffer;
+       buffer = buffer->next) {
+    const size_t count = buffer->count.load(std::memory_order_acquire);
+    buffer->cleared.store(count, std::memory_order_relaxed);
+    // writer appends past the chunk once it published the next event
+    while (buffer->headStart + Chunk::Size < count) {
+      Chunk* chunk = buffer->head;
+      buffer->head = chunk->next;
+      buffer->headStart += Chunk::Size;
+      delete chunk;
+    }
+  }
+}
+
+size_t Tracer::EventCount() const {
+  size_t count{0};
+  std::scoped_lock lock{m_readLock};
+  for (Buffer* buffer = m_buffers.load(std::memory_order_acquire); buffer;
+       buffer = buffer->next)
+    count += buffer->count.load(std::memory_order_acquire) -
+             buffer->cleared.load(std::memory_order_relaxed);
+  return count;
+}
+
+TraceScope::TraceScope(const char* name, const char* category)
+    : m_name(name), m_category(category) {
+  Tracer* tracer = Tracer::Instance();
+  if (tracer->Enabled()) m_start = tracer->Now();
+}
+
+TraceScope::TraceScope(const std::string& name, const char* category)
+    : m_category(category) {
+  Tracer* tracer = Tracer::Instance();
+  if (!tracer->Enabled()) return;
+  m_label = name;
+  m_start = tracer->Now();
+}
+
+TraceScope::~TraceScope() {
+  if (m_start < 0) return;
+  Tracer* tracer = Tracer::Instance();
+  const int64_t duration = tracer->Now() - m_start;
+  if (m_name)
+    tracer->Complete(m_name, m_category, m_start, duration);
+  else
+    tracer->Complete(m_label, m_category, m_start, duration);
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,149 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The Tracer class
+ * Hierarchical span tracer for any flow. Every thread appends events to its
+ * own buffer without locks, buffers are read only by TraceJson(). Spans nest
+ * by time on the thread track. Buffer of an exited thread is taken over by the
+ * next new thread, its track continues there. Child processes get their own
+ * tracks and the process memory is sampled periodically while tracing is on.
+ * Output uses Chrome trace event format (chrome://tracing, Perfetto),
+ * StartupProfiler writes its startup trace with it. Disabled tracer costs one
+ * atomic load per scope.
+ */
+class Tracer {
+ public:
+  // events per thread since Clear(), later events are dropped
+  static constexpr size_t MaxThreadEvents{1 << 20};
+
+  static Tracer* Instance();
+
+  bool Enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+  // memorySampling - interval of memory samples in ms, 0 disables them
+  void Enable(uint32_t memorySampling = 100);
+  void Disable();
+
+  // microseconds since process start
+  int64_t Now() const;
+
+  // name and category must be string literals
+  void Complete(const char* name, const char* category, int64_t start,
+                int64_t duration);
+  void Complete(const std::string& name, const char* category, int64_t start,
+                int64_t duration);
+  void Counter(const char* name, int64_t value);
+  void Instant(const char* name, const char* category = "");
+  // lifetime of the child process, shown as separate process
+  void Process(int64_t pid, const std::string& command, int64_t start,
+               int64_t duration, int exitCode, uint32_t peakRss);
+  // resident memory of this process, kiB
+  void SampleMemory();
+
+  std::string TraceJson() const;
+  bool Write(const std::filesystem::path& file) const;
+  // events recorded so far are not exported anymore, their memory is freed
+  void Clear();
+  size_t EventCount() const;
+  size_t Dropped() const { return m_dropped; }
+
+ private:
+  Tracer() = default;
+  struct Event {
+    const char* name{nullptr};  // literal, label is used if null
+    std::string label;
+    const char* category{""};
+    char phase{'X'};
+    int64_t start{0};
+    int64_t value{0};  // duration or counter value
+    int64_t pid{0};    // child process, 0 for this process
+    std::string args;  // json object members
+  };
+  struct Chunk {
+    static constexpr size_t Size{1024};
+    Event events[Size];
+    Chunk* next{nullptr};
+  };
+  struct Buffer {
+    uint64_t thread{0};
+    // reader only, guarded by m_readLock
+    Chunk* head{nullptr};
+    size_t headStart{0};   // index of the first event in head
+    Chunk* tail{nullptr};  // writer only
+    // events visible to the reader, published with release
+    std::atomic<size_t> count{0};
+    // events before are not exported, set by the reader
+    std::atomic<size_t> cleared{0};
+    // owner thread exited, a new thread may take the buffer
+    std::atomic_bool retired{false};
+    Buffer* next{nullptr};
+  };
+  Buffer* threadBuffer();
+  Event* append();
+  void publish();
+  void sampler(uint32_t interval);
+
+  std::atomic_bool m_enabled{false};
+  std::atomic<Buffer*> m_buffers{nullptr};
+  std::atomic<uint64_t> m_threads{0};
+  std::atomic<size_t> m_dropped{0};
+  mutable std::mutex m_readLock;
+  std::mutex m_controlLock;  // enable and disable
+  std::mutex m_samplerLock;
+  std::condition_variable m_samplerWait;
+  std::thread m_sampler;
+  bool m_samplerStop{false};
+};
+
+/*!
+ * \brief The TraceScope class
+ * Records its lifetime as a span of the current thread if tracer is enabled
+ * when the scope starts.
+ */
+class TraceScope {
+ public:
+  // name and category must be string literals
+  explicit TraceScope(const char* name, const char* category = "");
+  // name is copied only if tracer is enabled
+  explicit TraceScope(const std::string& name, const char* category = "");
+  ~TraceScope();
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* m_name{nullptr};
+  std::string m_label;
+  const char* m_category;
+  int64_t m_start{-1};
+};
+
+}  // namespace FOEDAG
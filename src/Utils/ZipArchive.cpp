@@ -0,0 +1,819 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ZipArchive.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "Utils/FileUtils.h"
+
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+static constexpr uint32_t LocalHeaderSignature{0x04034b50};
+static constexpr uint32_t CentralHeaderSignature{0x02014b50};
+static constexpr uint32_t EndSignature{0x06054b50};
+static constexpr uint32_t Zip64EndSignature{0x06064b50};
+static constexpr uint32_t Zip64LocatorSignature{0x07064b50};
+static constexpr uint16_t Zip64ExtraId{0x0001};
+static constexpr uint16_t Stored{0};
+static constexpr uint16_t Deflated{8};
+static constexpr uint16_t Utf8Flag{0x0800};
+static constexpr uint16_t Version{20};
+static constexpr uint16_t Version64{45};
+static constexpr uint16_t UnixHost{3};
+static constexpr uint32_t Max32{0xffffffff};
+static constexpr uint16_t Max16{0xffff};
+// deflate window, end of the previous chunk is dictionary of the next one
+static constexpr size_t Window{32 * 1024};
+// local header of larger file gets zip64 sizes, compressed size is not known
+// when the header is written and incompressible data grows a little
+static constexpr uint64_t Zip64Limit{0xff000000};
+static constexpr size_t IoSize{256 * 1024};
+
+static void put16(std::string& out, uint16_t value) {
+  out.push_back(static_cast<char>(value & 0xff));
+  out.push_back(static_cast<char>(value >> 8));
+}
+
+static void put32(std::string& out, uint32_t value) {
+  put16(out, static_cast<uint16_t>(value & 0xffff));
+  put16(out, static_cast<uint16_t>(value >> 16));
+}
+
+static void put64(std::string& out, uint64_t value) {
+  put32(out, static_cast<uint32_t>(value & Max32));
+  put32(out, static_cast<uint32_t>(value >> 32));
+}
+
+static uint16_t get16(const char* data) {
+  auto bytes = reinterpret_cast<const unsigned char*>(data);
+  return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+static uint32_t get32(const char* data) {
+  return get16(data) | (static_cast<uint32_t>(get16(data + 2)) << 16);
+}
+
+static uint64_t get64(const char* data) {
+  return get32(data) | (static_cast<uint64_t>(get32(data + 4)) << 32);
+}
+
+static unsigned threadCount(unsigned threads, size_t jobs) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<unsigned>(
+      std::max<size_t>(1, std::min<size_t>(threads, jobs)));
+}
+
+static void setError(std::string* error, const std::string& message) {
+  if (error) *error = message;
+}
+
+// whole name against pattern, '*' matches any run of characters, '?' any one
+static bool matches(const std::string& name, const std::string& pattern) {
+  size_t n{0}, p{0};
+  size_t star{std::string::npos}, starName{0};
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      n++;
+      p++;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      starName = n;
+    } else if (star != std::string::npos) {
+      // let the last star take one more character
+      p = star + 1;
+      n = ++starName;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') p++;
+  return p == pattern.size();
+}
+
+bool ArchivePolicy::Excluded(const fs::path& path) const {
+  const std::string extension = path.extension().string();
+  for (const auto& excluded : excludedExtensions)
+    if (extension == excluded) return true;
+  const std::string name = path.filename().string();
+  for (const auto& excluded : excludedNames)
+    if (matches(name, excluded)) return true;
+  return false;
+}
+
+ArchivePolicy ArchivePolicy::WithoutArtifacts() {
+  return {{".net", ".place", ".route"}, {"rr_graph*.xml", "rr_graph*.bin"}};
+}
+
+namespace {
+
+struct Entry {
+  fs::path source;
+  std::string name;  // directory names end with '/'
+  uint64_t size{0};  // expected, file could change while archived
+  uint16_t time{0};
+  uint16_t date{0};
+  uint32_t mode{0};  // unix file type and permissions
+  size_t firstChunk{0};
+  size_t chunks{0};  // 0 for directories
+  bool zip64Header{false};
+  // known when written
+  uint64_t offset{0};
+  uint32_t crc{0};
+  uint64_t compressed{0};
+  uint64_t uncompressed{0};
+  uint16_t method{Deflated};
+};
+
+struct Chunk {
+  size_t entry{0};
+  uint64_t offset{0};
+  size_t length{0};
+  std::string data;  // deflated, raw file data if stored
+  size_t read{0};
+  uint32_t crc{0};
+  bool stored{false};
+  bool done{false};
+};
+
+class Writer {
+ public:
+  Writer(const fs::path& archive, unsigned threads)
+      : m_archive(archive), m_threads(threads) {}
+
+  bool add(const fs::path& path, const ArchivePolicy& policy);
+  bool write();
+  const std::string& error() const { return m_error; }
+
+ private:
+  void addEntry(const fs::path& path, const std::string& name, bool directory);
+  void compress();
+  bool compress(size_t index);
+  bool writeEntry(std::ofstream& out, Entry& entry);
+  std::string localHeader(const Entry& entry) const;
+  std::string centralHeader(const Entry& entry) const;
+  void fail(const std::string& message);
+
+  fs::path m_archive;
+  unsigned m_threads{1};
+  std::vector<Entry> m_entries;
+  std::vector<Chunk> m_chunks;
+  std::atomic<size_t> m_next{0};
+  size_t m_written{0};  // chunks written, guarded by m_lock
+  std::mutex m_lock;
+  std::condition_variable m_wait;
+  std::atomic_bool m_failed{false};
+  std::string m_error;
+};
+
+void Writer::fail(const std::string& message) {
+  std::unique_lock lock{m_lock};
+  if (m_error.empty()) m_error = message;
+  m_failed = true;
+  m_wait.notify_all();
+}
+
+void Writer::addEntry(const fs::path& path, const std::string& name,
+                      bool directory) {
+  Entry entry;
+  entry.source = path;
+  entry.name = directory ? name + "/" : name;
+  std::error_code ec;
+  if (!directory) entry.size = fs::file_size(path, ec);
+  entry.mode = static_cast<uint32_t>(fs::status(path, ec).permissions()) &
+               0777;
+  entry.mode |= directory ? 0040000 : 0100000;
+  const time_t mtime = FileUtils::Mtime(path);
+  if (const std::tm* local = std::localtime(&mtime)) {
+    // dos time starts in 1980
+    entry.time = static_cast<uint16_t>((local->tm_hour << 11) |
+                                       (local->tm_min << 5) |
+                                       (local->tm_sec / 2));
+    entry.date = static_cast<uint16_t>(
+        (std::max(local->tm_year - 80, 0) << 9) | ((local->tm_mon + 1) << 5) |
+        local->tm_mday);
+  }
+  if (!directory) {
+    entry.firstChunk = m_chunks.size();
+    const size_t chunkSize = ZipArchive::ChunkSize;
+    entry.chunks =
+        std::max<size_t>(1, (entry.size + chunkSize - 1) / chunkSize);
+    entry.zip64Header = entry.size > Zip64Limit;
+    for (size_t i = 0; i < entry.chunks; i++) {
+      Chunk chunk;
+      chunk.entry = m_entries.size();
+      chunk.offset = i * chunkSize;
+      chunk.length = std::min<uint64_t>(chunkSize, entry.size - chunk.offset);
+      m_chunks.push_back(std::move(chunk));
+    }
+  }
+  m_entries.push_back(std::move(entry));
+}
+
+bool Writer::add(const fs::path& path, const ArchivePolicy& policy) {
+  std::error_code ec;
+  if (!fs::exists(path, ec)) {
+    m_error = "File not found " + path.string();
+    return false;
+  }
+  const fs::path archive = fs::weakly_canonical(m_archive, ec);
+  const std::string root = path.filename().string();
+  if (!fs::is_directory(path, ec)) {
+    addEntry(path, root, false);
+    return true;
+  }
+  addEntry(path, root, true);
+  // sorted, archive content doesn't depend on the file system order
+  std::vector<fs::path> files;
+  fs::recursive_directory_iterator it{path, ec}, end;
+  for (; !ec && it != end; it.increment(ec)) {
+    if (policy.Excluded(it->path())) {
+      if (it->is_directory(ec)) it.disable_recursion_pending();
+      continue;
+    }
+    if (!it->is_directory(ec) && !it->is_regular_file(ec)) continue;
+    // archive written into the directory being archived
+    if (fs::weakly_canonical(it->path(), ec) == archive) continue;
+    files.push_back(it->path());
+  }
+  if (ec) {
+    m_error = "Failed to read " + path.string() + ": " + ec.message();
+    return false;
+  }
+  std::sort(files.begin(), files.end());
+  for (const auto& file : files) {
+    const std::string name =
+        root + "/" + file.lexically_relative(path).generic_string();
+    addEntry(file, name, fs::is_directory(file, ec));
+  }
+  return true;
+}
+
+bool Writer::compress(size_t index) {
+  Chunk& chunk = m_chunks[index];
+  const Entry& entry = m_entries[chunk.entry];
+  std::ifstream in{entry.source, std::ios::binary};
+  if (!in) {
+    fail("Failed to open " + entry.source.string());
+    return false;
+  }
+  const uint64_t start = chunk.offset > Window ? chunk.offset - Window : 0;
+  std::string buffer(chunk.offset - start + chunk.length, '\0');
+  in.seekg(start);
+  in.read(buffer.data(), buffer.size());
+  const size_t read = static_cast<size_t>(std::max<std::streamsize>(
+      in.gcount(), 0));
+  // file could get shorter after the listing
+  const size_t dictionary =
+      std::min<size_t>(read, static_cast<size_t>(chunk.offset - start));
+  chunk.read = read - dictionary;
+  auto input = reinterpret_cast<Bytef*>(buffer.data());
+  chunk.crc = crc32(0, input + dictionary, static_cast<uInt>(chunk.read));
+
+  const bool last = index + 1 == entry.firstChunk + entry.chunks;
+  z_stream stream{};
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    fail("Failed to initialize compression");
+    return false;
+  }
+  if (dictionary != 0)
+    deflateSetDictionary(&stream, input, static_cast<uInt>(dictionary));
+  // sync flush adds empty stored block
+  chunk.data.resize(deflateBound(&stream, chunk.read) + 16);
+  stream.next_in = input + dictionary;
+  stream.avail_in = static_cast<uInt>(chunk.read);
+  stream.next_out = reinterpret_cast<Bytef*>(chunk.data.data());
+  stream.avail_out = static_cast<uInt>(chunk.data.size());
+  const int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+  chunk.data.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (result != (last ? Z_STREAM_END : Z_OK) || stream.avail_in != 0) {
+    fail("Failed to compress " + entry.source.string());
+    return false;
+  }
+  // incompressible file in single chunk
+  if (entry.chunks == 1 && chunk.data.size() >= chunk.read) {
+    chunk.data.assign(buffer, dictionary, chunk.read);
+    chunk.stored = true;
+  }
+  return true;
+}
+
+void Writer::compress() {
+  // chunks compressed ahead of the writer, limits memory
+  const size_t ahead = m_threads * 4;
+  for (;;) {
+    const size_t index = m_next++;
+    if (index >= m_chunks.size()) return;
+    {
+      std::unique_lock lock{m_lock};
+      m_wait.wait(lock,
+                  [&]() { return m_failed || index < m_written + ahead; });
+      if (m_failed) return;
+    }
+    if (!compress(index)) return;
+    std::unique_lock lock{m_lock};
+    m_chunks[index].done = true;
+    m_wait.notify_all();
+  }
+}
+
+std::string Writer::localHeader(const Entry& entry) const {
+  std::string header;
+  put32(header, LocalHeaderSignature);
+  put16(header, entry.zip64Header ? Version64 : Version);
+  put16(header, Utf8Flag);
+  put16(header, entry.method);
+  put16(header, entry.time);
+  put16(header, entry.date);
+  put32(header, entry.crc);
+  put32(header, entry.zip64Header ? Max32
+                                  : static_cast<uint32_t>(entry.compressed));
+  put32(header, entry.zip64Header ? Max32
+                                  : static_cast<uint32_t>(entry.uncompressed));
+  put16(header, static_cast<uint16_t>(entry.name.size()));
+  put16(header, entry.zip64Header ? 20 : 0);
+  header += entry.name;
+  if (entry.zip64Header) {
+    put16(header, Zip64ExtraId);
+    put16(header, 16);
+    put64(header, entry.uncompressed);
+    put64(header, entry.compressed);
+  }
+  return header;
+}
+
+std::string Writer::centralHeader(const Entry& entry) const {
+  std::string extra;
+  if (entry.uncompressed >= Max32) put64(extra, entry.uncompressed);
+  if (entry.compressed >= Max32) put64(extra, entry.compressed);
+  if (entry.offset >= Max32) put64(extra, entry.offset);
+  if (!extra.empty()) {
+    std::string field;
+    put16(field, Zip64ExtraId);
+    put16(field, static_cast<uint16_t>(extra.size()));
+    extra = field + extra;
+  }
+  const bool zip64 = !extra.empty() || entry.zip64Header;
+  std::string header;
+  put32(header, CentralHeaderSignature);
+  put16(header, (UnixHost << 8) | Version64);
+  put16(header, zip64 ? Version64 : Version);
+  put16(header, Utf8Flag);
+  put16(header, entry.method);
+  put16(header, entry.time);
+  put16(header, entry.date);
+  put32(header, entry.crc);
+  put32(header, static_cast<uint32_t>(std::min<uint64_t>(entry.compressed,
+                                                         Max32)));
+  put32(header, static_cast<uint32_t>(std::min<uint64_t>(entry.uncompressed,
+                                                         Max32)));
+  put16(header, static_cast<uint16_t>(entry.name.size()));
+  put16(header, static_cast<uint16_t>(extra.size()));
+  put16(header, 0);  // comment
+  put16(header, 0);  // disk
+  put16(header, 0);  // internal attributes
+  // unix mode, ms-dos directory attribute
+  put32(header, (entry.mode << 16) | (entry.chunks == 0 ? 0x10 : 0));
+  put32(header,
+        static_cast<uint32_t>(std::min<uint64_t>(entry.offset, Max32)));
+  header += entry.name;
+  header += extra;
+  return header;
+}
+
+bool Writer::writeEntry(std::ofstream& out, Entry& entry) {
+  entry.offset = static_cast<uint64_t>(out.tellp());
+  if (entry.chunks == 0) {
+    entry.method = Stored;
+    const std::string header = localHeader(entry);
+    out.write(header.data(), header.size());
+    return true;
+  }
+  const std::string header = localHeader(entry);
+  bool headerWritten{false};
+  for (size_t i = entry.firstChunk; i < entry.firstChunk + entry.chunks; i++) {
+    Chunk& chunk = m_chunks[i];
+    {
+      std::unique_lock lock{m_lock};
+      m_wait.wait(lock, [&]() { return m_failed || chunk.done; });
+      if (m_failed) return false;
+    }
+    entry.crc = crc32_combine(entry.crc, chunk.crc,
+                              static_cast<z_off_t>(chunk.read));
+    entry.compressed += chunk.data.size();
+    entry.uncompressed += chunk.read;
+    if (entry.chunks == 1) {
+      // everything is known, header is written once
+      entry.method = chunk.stored ? Stored : Deflated;
+      const std::string complete = localHeader(entry);
+      out.write(complete.data(), complete.size());
+      headerWritten = true;
+    } else if (!headerWritten) {
+      out.write(header.data(), header.size());
+      headerWritten = true;
+    }
+    out.write(chunk.data.data(), chunk.data.size());
+    std::string{}.swap(chunk.data);
+    std::unique_lock lock{m_lock};
+    m_written = i + 1;
+    m_wait.notify_all();
+  }
+  if (entry.chunks > 1) {
+    // crc and sizes known after the last chunk
+    const auto end = out.tellp();
+    const std::string complete = localHeader(entry);
+    out.seekp(static_cast<std::streamoff>(entry.offset));
+    out.write(complete.data(), complete.size());
+    out.seekp(end);
+  }
+  return true;
+}
+
+bool Writer::write() {
+  std::ofstream out{m_archive, std::ios::binary | std::ios::trunc};
+  if (!out) {
+    m_error = "Failed to create " + m_archive.string();
+    return false;
+  }
+  const unsigned threads = threadCount(m_threads, m_chunks.size());
+  m_threads = threads;
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < threads; i++)
+    workers.emplace_back([this]() { compress(); });
+  bool ok{true};
+  for (auto& entry : m_entries) {
+    if (!writeEntry(out, entry) || !out) {
+      ok = false;
+      break;
+    }
+  }
+  if (!ok) fail("Failed to write " + m_archive.string());
+  for (auto& worker : workers) worker.join();
+  if (!ok) return false;
+
+  const uint64_t directoryOffset = static_cast<uint64_t>(out.tellp());
+  for (const auto& entry : m_entries) {
+    const std::string header = centralHeader(entry);
+    out.write(header.data(), header.size());
+  }
+  const uint64_t endOffset = static_cast<uint64_t>(out.tellp());
+  const uint64_t directorySize = endOffset - directoryOffset;
+  const uint64_t count = m_entries.size();
+  std::string end;
+  if (count >= Max16 || directorySize >= Max32 || directoryOffset >= Max32) {
+    put32(end, Zip64EndSignature);
+    put64(end, 44);  // size of the remaining record
+    put16(end, (UnixHost << 8) | Version64);
+    put16(end, Version64);
+    put32(end, 0);  // disk
+    put32(end, 0);  // disk with central directory
+    put64(end, count);
+    put64(end, count);
+    put64(end, directorySize);
+    put64(end, directoryOffset);
+    put32(end, Zip64LocatorSignature);
+    put32(end, 0);  // disk with zip64 end record
+    put64(end, endOffset);
+    put32(end, 1);  // disks
+  }
+  put32(end, EndSignature);
+  put16(end, 0);  // disk
+  put16(end, 0);  // disk with central directory
+  put16(end, static_cast<uint16_t>(std::min<uint64_t>(count, Max16)));
+  put16(end, static_cast<uint16_t>(std::min<uint64_t>(count, Max16)));
+  put32(end, static_cast<uint32_t>(std::min<uint64_t>(directorySize, Max32)));
+  put32(end, static_cast<uint32_t>(std::min<uint64_t>(directoryOffset, Max32)));
+  put16(end, 0);  // comment
+  out.write(end.data(), end.size());
+  out.close();
+  if (!out) {
+    m_error = "Failed to write " + m_archive.string();
+    return false;
+  }
+  return true;
+}
+
+struct ArchiveEntry {
+  std::string name;
+  uint16_t method{0};
+  uint32_t crc{0};
+  uint64_t compressed{0};
+  uint64_t uncompressed{0};
+  uint64_t offset{0};
+  uint32_t mode{0};  // 0 if not known
+};
+
+bool readDirectory(std::ifstream& in, std::vector<ArchiveEntry>& entries,
+                   std::string& error) {
+  in.seekg(0, std::ios::end);
+  const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+  // end record is followed by comment up to 64k long
+  const uint64_t tail = std::min<uint64_t>(fileSize, 22 + 0xffff);
+  std::string buffer(tail, '\0');
+  in.seekg(static_cast<std::streamoff>(fileSize - tail));
+  in.read(buffer.data(), buffer.size());
+  size_t end = std::string::npos;
+  for (size_t i = tail >= 22 ? tail - 22 + 1 : 0; i-- > 0;) {
+    if (get32(buffer.data() + i) == EndSignature) {
+      end = i;
+      break;
+    }
+  }
+  if (end == std::string::npos) {
+    error = "Not a zip archive";
+    return false;
+  }
+  uint64_t count = get16(buffer.data() + end + 10);
+  uint64_t directorySize = get32(buffer.data() + end + 12);
+  uint64_t directoryOffset = get32(buffer.data() + end + 16);
+  const uint64_t endOffset = fileSize - tail + end;
+  if ((count == Max16 || directorySize == Max32 || directoryOffset == Max32) &&
+      endOffset >= 20) {
+    char locator[20];
+    in.seekg(static_cast<std::streamoff>(endOffset - 20));
+    in.read(locator, sizeof(locator));
+    if (in && get32(locator) == Zip64LocatorSignature) {
+      char record[56];
+      in.seekg(static_cast<std::streamoff>(get64(locator + 8)));
+      in.read(record, sizeof(record));
+      if (!in || get32(record) != Zip64EndSignature) {
+        error = "Broken zip64 end record";
+        return false;
+      }
+      count = get64(record + 32);
+      directorySize = get64(record + 40);
+      directoryOffset = get64(record + 48);
+    }
+  }
+  if (directoryOffset + directorySize > fileSize) {
+    error = "Broken central directory";
+    return false;
+  }
+  std::string directory(directorySize, '\0');
+  in.seekg(static_cast<std::streamoff>(directoryOffset));
+  in.read(directory.data(), directory.size());
+  if (!in) {
+    error = "Failed to read central directory";
+    return false;
+  }
+  size_t pos{0};
+  for (uint64_t i = 0; i < count; i++) {
+    if (pos + 46 > directory.size() ||
+        get32(directory.data() + pos) != CentralHeaderSignature) {
+      error = "Broken central directory";
+      return false;
+    }
+    const char* header = directory.data() + pos;
+    const size_t nameSize = get16(header + 28);
+    const size_t extraSize = get16(header + 30);
+    const size_t commentSize = get16(header + 32);
+    if (pos + 46 + nameSize + extraSize + commentSize > directory.size()) {
+      error = "Broken central directory";
+      return false;
+    }
+    ArchiveEntry entry;
+    entry.method = get16(header + 10);
+    entry.crc = get32(header + 16);
+    entry.compressed = get32(header + 20);
+    entry.uncompressed = get32(header + 24);
+    entry.offset = get32(header + 42);
+    if ((get16(header + 4) >> 8) == UnixHost)
+      entry.mode = get32(header + 38) >> 16;
+    entry.name.assign(header + 46, nameSize);
+    // zip64 values are present only for the fields which don't fit
+    const char* extra = header + 46 + nameSize;
+    for (size_t field = 0; field + 4 <= extraSize;) {
+      const uint16_t id = get16(extra + field);
+      const size_t size = get16(extra + field + 2);
+      if (field + 4 + size > extraSize) break;
+      if (id == Zip64ExtraId) {
+        const char* value = extra + field + 4;
+        const char* valueEnd = value + size;
+        for (uint64_t* target :
+             {&entry.uncompressed, &entry.compressed, &entry.offset}) {
+          if (*target != Max32 || value + 8 > valueEnd) continue;
+          *target = get64(value);
+          value += 8;
+        }
+      }
+      field += 4 + size;
+    }
+    entries.push_back(std::move(entry));
+    pos += 46 + nameSize + extraSize + commentSize;
+  }
+  return true;
+}
+
+// relative path inside destination, empty if entry name is not safe
+fs::path safePath(const std::string& name) {
+  const fs::path path = fs::path{name}.lexically_normal();
+  if (name.empty() || path.is_absolute() || path.has_root_name() ||
+      path.has_root_directory())
+    return {};
+  for (const auto& part : path)
+    if (part == "..") return {};
+  return path;
+}
+
+bool extractEntry(std::ifstream& in, const ArchiveEntry& entry,
+                  const fs::path& target, std::string& error) {
+  char header[30];
+  in.seekg(static_cast<std::streamoff>(entry.offset));
+  in.read(header, sizeof(header));
+  if (!in || get32(header) != LocalHeaderSignature) {
+    error = "Broken local header of " + entry.name;
+    return false;
+  }
+  in.seekg(get16(header + 26) + get16(header + 28), std::ios::cur);
+  if (entry.method != Stored && entry.method != Deflated) {
+    error = "Unsupported compression method of " + entry.name;
+    return false;
+  }
+  std::ofstream out{target, std::ios::binary | std::ios::trunc};
+  if (!out) {
+    error = "Failed to create " + target.string();
+    return false;
+  }
+  z_stream stream{};
+  if (entry.method == Deflated && inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+    error = "Failed to initialize decompression";
+    return false;
+  }
+  std::string input(IoSize, '\0');
+  std::string output(IoSize, '\0');
+  uint64_t left = entry.compressed;
+  uint64_t written{0};
+  uLong crc = crc32(0, nullptr, 0);
+  bool ok{true};
+  int result{Z_OK};
+  while (ok && left != 0 && result != Z_STREAM_END) {
+    const size_t size = static_cast<size_t>(std::min<uint64_t>(left, IoSize));
+    in.read(input.data(), size);
+    if (static_cast<size_t>(in.gcount()) != size) {
+      ok = false;
+      break;
+    }
+    left -= size;
+    if (entry.method == Stored) {
+      crc = crc32(crc, reinterpret_cast<Bytef*>(input.data()),
+                  static_cast<uInt>(size));
+      out.write(input.data(), size);
+      written += size;
+      continue;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(input.data());
+    stream.avail_in = static_cast<uInt>(size);
+    do {
+      stream.next_out = reinterpret_cast<Bytef*>(output.data());
+      stream.avail_out = static_cast<uInt>(output.size());
+      result = inflate(&stream, Z_NO_FLUSH);
+      if (result != Z_OK && result != Z_STREAM_END) {
+        ok = false;
+        break;
+      }
+      const size_t produced = output.size() - stream.avail_out;
+      crc = crc32(crc, reinterpret_cast<Bytef*>(output.data()),
+                  static_cast<uInt>(produced));
+      out.write(output.data(), produced);
+      written += produced;
+    } while (stream.avail_out == 0 && result != Z_STREAM_END);
+  }
+  if (entry.method == Deflated) {
+    if (result != Z_STREAM_END) ok = false;
+    inflateEnd(&stream);
+  }
+  out.close();
+  if (!ok || !out || written != entry.uncompressed || crc != entry.crc) {
+    error = "Broken data of " + entry.name;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ZipArchive::Compress(const fs::path& archive,
+                          const std::vector<fs::path>& paths,
+                          const ArchivePolicy& policy, unsigned threads,
+                          std::string* error) {
+  Writer writer{archive, threads};
+  for (const auto& path : paths) {
+    if (!writer.add(path, policy)) {
+      setError(error, writer.error());
+      return false;
+    }
+  }
+  if (!writer.write()) {
+    std::error_code ec;
+    fs::remove(archive, ec);
+    setError(error, writer.error());
+    return false;
+  }
+  return true;
+}
+
+bool ZipArchive::Extract(const fs::path& archive, const fs::path& destination,
+                         unsigned threads, std::string* error) {
+  std::ifstream in{archive, std::ios::binary};
+  if (!in) {
+    setError(error, "Failed to open " + archive.string());
+    return false;
+  }
+  std::vector<ArchiveEntry> entries;
+  std::string message;
+  if (!readDirectory(in, entries, message)) {
+    setError(error, message + ": " + archive.string());
+    return false;
+  }
+  std::vector<fs::path> targets;
+  std::error_code ec;
+  for (const auto& entry : entries) {
+    const fs::path relative = safePath(entry.name);
+    if (relative.empty()) {
+      setError(error, "Unsafe entry " + entry.name);
+      return false;
+    }
+    const bool directory = entry.name.back() == '/';
+    // directories are created upfront, files in parallel
+    fs::create_directories(
+        directory ? destination / relative
+                  : (destination / relative).parent_path(),
+        ec);
+    if (ec) {
+      setError(error, "Failed to create directory for " + entry.name);
+      return false;
+    }
+    targets.push_back(directory ? fs::path{} : destination / relative);
+  }
+
+  std::atomic<size_t> next{0};
+  std::atomic_bool failed{false};
+  std::mutex lock;
+  auto extract = [&]() {
+    std::ifstream stream{archive, std::ios::binary};
+    for (;;) {
+      const size_t index = next++;
+      if (index >= entries.size() || failed) return;
+      if (targets[index].empty()) continue;
+      std::string entryError;
+      if (!stream || !extractEntry(stream, entries[index], targets[index],
+                                   entryError)) {
+        std::unique_lock guard{lock};
+        if (!failed) message = entryError.empty() ? "Failed to read archive"
+                                                  : entryError;
+        failed = true;
+        return;
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  const unsigned count = threadCount(threads, entries.size());
+  for (unsigned i = 0; i < count; i++) workers.emplace_back(extract);
+  for (auto& worker : workers) worker.join();
+  if (failed) {
+    setError(error, message);
+    return false;
+  }
+#ifndef _WIN32
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (entries[i].mode == 0) continue;
+    const fs::path target = targets[i].empty()
+                                ? destination / safePath(entries[i].name)
+                                : targets[i];
+    fs::permissions(target, static_cast<fs::perms>(entries[i].mode & 0777),
+                    ec);
+  }
+#endif
+  return true;
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,81 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The ArchivePolicy struct
+ * Files and directories left out of the archive. Default policy archives
+ * everything.
+ */
+struct ArchivePolicy {
+  // extensions with leading dot
+  std::vector<std::string> excludedExtensions;
+  // file or directory names, '*' and '?' wildcards are supported
+  std::vector<std::string> excludedNames;
+
+  bool Excluded(const std::filesystem::path& path) const;
+  // artifacts regenerated by the flow: netlists of packing, placement and
+  // routing, routing resource graph dumps
+  static ArchivePolicy WithoutArtifacts();
+};
+
+/*!
+ * \brief The ZipArchive class
+ * Zip archives written and read in process with zlib. Files are split in
+ * chunks which are deflated by a pool of threads, chunks of one file are
+ * joined into single deflate stream. Archive is written in order while the
+ * next chunks are being compressed, so memory use doesn't depend on the size
+ * of the files. Zip64 records are written when sizes or offsets need them.
+ */
+class ZipArchive {
+ public:
+  static constexpr size_t ChunkSize{4 << 20};
+
+  /*!
+   * \brief Compress
+   * Write \a paths into \a archive. Directories are added recursively. Every
+   * path is stored under its file name, like zip -r run in its parent
+   * directory would do.
+   * \param threads - compression threads, hardware concurrency if 0
+   */
+  static bool Compress(const std::filesystem::path& archive,
+                       const std::vector<std::filesystem::path>& paths,
+                       const ArchivePolicy& policy = {}, unsigned threads = 0,
+                       std::string* error = nullptr);
+
+  /*!
+   * \brief Extract
+   * Extract all entries of \a archive into \a destination. Entries pointing
+   * outside of \a destination are rejected. Unix permissions are restored.
+   */
+  static bool Extract(const std::filesystem::path& archive,
+                      const std::filesystem::path& destination,
+                      unsigned threads = 0, std::string* error = nullptr);
+};
+
+}  // namespace FOEDAG
@@ -0,0 +1,78 @@
+#Copyright 2021 The Foedag team
+
+#GPL License
+
+#Copyright (c) 2021 The Open-Source FPGA Foundation
+
+#This program is free software: you can redistribute it and/or modify
+#it under the terms of the GNU General Public License as published by
+#the Free Software Foundation, either version 3 of the License, or
+#(at your option) any later version.
+
+#This program is distributed in the hope that it will be useful,
+#but WITHOUT ANY WARRANTY; without even the implied warranty of
+#MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#GNU General Public License for more details.
+
+#You should have received a copy of the GNU General Public License
+#along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Starts a batch server, runs jobs with foedag-client and stops the server.
+# Run with: foedag --batch --script tests/TestBatch/test_batch_server.tcl
+
+set bin_dir [file dirname [info nameofexecutable]]
+set foedag [file join $bin_dir foedag]
+set client [file join $bin_dir foedag-client]
+set dir [file normalize test_batch_server]
+file delete -force $dir
+file mkdir $dir
+set socket [file join $dir server.sock]
+
+proc check {condition message} {
+  if {![uplevel 1 [list expr $condition]]} {
+    puts "ERROR: $message"
+    exit 1
+  }
+}
+
+set server [exec $foedag --batch --server $socket --cmd "set warm 42" \
+  >& [file join $dir server.log] &]
+for {set i 0} {$i < 100 && ![file exists $socket]} {incr i} {
+  after 100
+}
+check {[file exists $socket]} "batch server didn't start"
+
+# job sees the warm up state
+set out [exec $client --socket $socket --cmd {puts "warm=$warm"}]
+check {$out eq "warm=42"} "unexpected job output: $out"
+
+# job changes don't reach the server
+exec $client --socket $socket --cmd {set warm 7}
+set out [exec $client --socket $socket --cmd {puts "warm=$warm"}]
+check {$out eq "warm=42"} "job changed server state: $out"
+
+# script runs in the client working directory
+set script [file join $dir job.tcl]
+set fid [open $script w]
+puts $fid {puts "pwd=[pwd]"}
+close $fid
+set cwd [pwd]
+cd $dir
+set out [exec $client --socket $socket --script $script]
+cd $cwd
+check {$out eq "pwd=$dir"} "unexpected working directory: $out"
+
+# failing job sets client exit status
+set status 0
+if {[catch {exec $client --socket $socket --cmd {error boom}} msg opts]} {
+  lassign [dict get $opts -errorcode] kind pid status
+}
+check {$status != 0} "failing job reported success"
+
+# server finishes on SIGTERM and removes its socket
+exec kill -TERM $server
+for {set i 0} {$i < 100 && [file exists $socket]} {incr i} {
+  after 100
+}
+check {![file exists $socket]} "batch server didn't stop"
+puts "Batch server test passed"
@@ -0,0 +1,92 @@
+#Copyright 2024 The Foedag team
+
+#GPL License
+
+#Copyright (c) 2024 The Open-Source FPGA Foundation
+
+#This program is free software: you can redistribute it and/or modify
+#it under the terms of the GNU General Public License as published by
+#the Free Software Foundation, either version 3 of the License, or
+#(at your option) any later version.
+
+#This program is distributed in the hope that it will be useful,
+#but WITHOUT ANY WARRANTY; without even the implied warranty of
+#MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#GNU General Public License for more details.
+
+#You should have received a copy of the GNU General Public License
+#along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+proc readLog {} {
+    set fp [open "foedag.log" r]
+    set file_data [read $fp]
+    close $fp
+    return $file_data
+}
+
+set platform $::tcl_platform(platform)
+if { $platform == "windows" } {
+    # TODO @skyler-rs Oct2022 Enable in windows once GH-661 is resolved
+    puts "SKIPPING ON WINDOWS: This test requires python which FileUtils::ExecuteSystemCommand() currently fails to find on Windows. Disabling windows run of test until python issues on windows are resolved.\n"
+    # returning a pass condition because this is an expected failure for now
+    exit 0
+} else {
+    # This test creates and uses cache files so we need to delete them otherwise the test will fail on re-run
+    file delete -force ip_gen_parallel
+
+    create_design ip_gen_parallel
+    architecture ../../Arch/k6_frac_N10_tileable_40nm.xml ../../Arch/k6_N10_40nm_openfpga.xml
+    add_litex_ip_catalog ./IP_Catalog
+
+    foreach inst {inst1 inst2 inst3 inst4} {
+        configure_ip axis_converter_V1_0 -mod_name $inst -version V1_0 -Pcore_in_width=128 -Pcore_out_width=64 -Pcore_user_width=0 -Pcore_reverse=0 -out_file rs_ips/$inst
+    }
+
+    # ensure -jobs throws an error without a number
+    if {![catch {ipgenerate -jobs} error]} {
+        puts "TEST FAILED, ipgenerate -jobs w/o number should error out"
+        exit 1
+    }
+
+    # Generate all 4 IPs, 3 at a time
+    ipgenerate -jobs 3
+
+    set file_data [readLog]
+    foreach inst {inst1 inst2 inst3 inst4} {
+        if { ![regexp "generated IP \[^\n\]*V1_0/$inst" $file_data] } {
+            puts "TEST FAILED: ipgenerate -jobs 3 failed to generate $inst"
+            exit 1
+        }
+        if { [llength [glob -nocomplain ./ip_gen_parallel/run_1/IPs/*/*/*/V1_0/$inst/ipgenerate.log]] != 1 } {
+            puts "TEST FAILED: missing generator log for $inst"
+            exit 1
+        }
+    }
+    if { ![regexp {\[4/4\]} $file_data] } {
+        puts "TEST FAILED: ipgenerate should report progress of each IP"
+        exit 1
+    }
+    if { [regexp "reusing IP" $file_data] } {
+        puts "TEST FAILED: ipgenerate shouldn't have reused an IP at this stage"
+        exit 1
+    }
+
+    # Nothing changed, every IP is reused
+    ipgenerate -jobs 3
+    set foundCount [regexp -all "reusing IP" [readLog]]
+    if { $foundCount != 4 } {
+        puts "TEST FAILED: ipgenerate should have re-used 4 IPs, re-used $foundCount"
+        exit 1
+    }
+
+    # Changed parameters invalidate only the changed IP
+    configure_ip axis_converter_V1_0 -mod_name inst2 -version V1_0 -Pcore_in_width=64 -Pcore_out_width=64 -Pcore_user_width=0 -Pcore_reverse=0 -out_file rs_ips/inst2
+    ipgenerate -jobs 3
+    set foundCount [regexp -all "reusing IP" [readLog]]
+    if { $foundCount != 7 } {
+        puts "TEST FAILED: ipgenerate should have re-used 3 more IPs"
+        exit 1
+    }
+
+    exit 0
+}
@@ -21,6 +21,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Configuration/CFGCommon/CFGCommon.h"
 
+#include <fstream>
+#include <thread>
+
 #include "compiler_tcl_infra_common.h"
 #include "gtest/gtest.h"
 
@@ -404,3 +407,360 @@ TEST(CFGCommon, test_python_mgr) {
                          std::vector<CFG_Python_OBJ>({}));
   EXPECT_EQ(results.size(), 0);
 }
+
+TEST(CFGCommon, test_python_interpreter) {
+  std::filesystem::path file =
+      std::filesystem::absolute("python_interpreter_test.py");
+  std::ofstream(file.string()) << "counter = 0\n"
+                                  "def bump(step):\n"
+                                  "  global counter\n"
+                                  "  counter += step\n"
+                                  "  return [counter]\n";
+  CFG_Python_Interpreter& interpreter = CFG_Python_Interpreter::get();
+  uint32_t compile_count = interpreter.compile_count();
+  CFG_Python_MGR mgr0(file.string());
+  CFG_Python_MGR mgr1(file.string());
+  // Compiled once, but each manager has its own globals
+  EXPECT_EQ(interpreter.compile_count(), compile_count + 1);
+  std::vector<CFG_Python_OBJ> results = mgr0.run_file(
+      "python_interpreter_test", "bump",
+      std::vector<CFG_Python_OBJ>({CFG_Python_OBJ(uint32_t(5))}));
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].get_u32(), 5);
+  results = mgr1.run_file(
+      "python_interpreter_test", "bump",
+      std::vector<CFG_Python_OBJ>({CFG_Python_OBJ(uint32_t(1))}));
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].get_u32(), 1);
+  // Batch
+  std::vector<std::vector<CFG_Python_OBJ>> batch = mgr0.run_file_batch(
+      "python_interpreter_test", "bump",
+      std::vector<std::vector<CFG_Python_OBJ>>(
+          {{CFG_Python_OBJ(uint32_t(1))},
+           {CFG_Python_OBJ(uint32_t(2))},
+           {CFG_Python_OBJ(uint32_t(3))}}));
+  ASSERT_EQ(batch.size(), 3);
+  EXPECT_EQ(batch[0][0].get_u32(), 6);
+  EXPECT_EQ(batch[1][0].get_u32(), 8);
+  EXPECT_EQ(batch[2][0].get_u32(), 11);
+  // Modified file is compiled again, loaded modules are untouched
+  std::ofstream(file.string()) << "def bump(step):\n"
+                                  "  return [step * 100]\n";
+  CFG_Python_MGR mgr2(file.string());
+  EXPECT_EQ(interpreter.compile_count(), compile_count + 2);
+  results = mgr2.run_file(
+      "python_interpreter_test", "bump",
+      std::vector<CFG_Python_OBJ>({CFG_Python_OBJ(uint32_t(2))}));
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].get_u32(), 200);
+  results = mgr0.run_file(
+      "python_interpreter_test", "bump",
+      std::vector<CFG_Python_OBJ>({CFG_Python_OBJ(uint32_t(1))}));
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].get_u32(), 12);
+  std::filesystem::remove(file);
+}
+
+TEST(CFGCommon, test_python_interpreter_imports) {
+  std::filesystem::path file =
+      std::filesystem::absolute("python_top_test.py");
+  std::filesystem::path sibling =
+      std::filesystem::absolute("python_sibling_test.py");
+  std::filesystem::path shared_dir =
+      std::filesystem::absolute("python_shared_test");
+  std::filesystem::create_directories(shared_dir);
+  std::filesystem::path shared = shared_dir / "python_shared_test.py";
+  std::ofstream(sibling.string()) << "VALUE = 1\n"
+                                     "LOADS = []\n";
+  std::ofstream(shared.string()) << "VALUE = 3\n";
+  std::ofstream(file.string())
+      << "import sys\n"
+      << "shared_dir = '"
+      << CFG_change_directory_to_linux_format(shared_dir.string()) << "'\n"
+      << "if shared_dir not in sys.path:\n"
+         "  sys.path.append(shared_dir)\n"
+      << "import python_sibling_test\n"
+         "import python_shared_test\n"
+         "python_sibling_test.LOADS.append(1)\n"
+         "def value():\n"
+         "  return [python_sibling_test.VALUE,\n"
+         "          len(python_sibling_test.LOADS),\n"
+         "          python_shared_test.VALUE]\n";
+  CFG_Python_MGR mgr0(file.string());
+  std::vector<CFG_Python_OBJ> results = mgr0.run_file(
+      "python_top_test", "value", std::vector<CFG_Python_OBJ>({}));
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_EQ(results[0].get_u32(), 1);
+  EXPECT_EQ(results[1].get_u32(), 1);
+  EXPECT_EQ(results[2].get_u32(), 3);
+  CFG_Python_MGR count;
+  count.run({"import sys", "count = len(sys.path)"}, {"count"});
+  uint32_t path_count = count.result_u32("count");
+  // Sibling is imported again by every load, shared module once it changed
+  std::ofstream(sibling.string()) << "VALUE = 22\n"
+                                     "LOADS = []\n";
+  std::ofstream(shared.string()) << "VALUE = 33\n";
+  CFG_Python_MGR mgr1(file.string());
+  results = mgr1.run_file("python_top_test", "value",
+                          std::vector<CFG_Python_OBJ>({}));
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_EQ(results[0].get_u32(), 22);
+  // Loaders do not share globals of the sibling
+  EXPECT_EQ(results[1].get_u32(), 1);
+  EXPECT_EQ(results[2].get_u32(), 33);
+  results = mgr0.run_file("python_top_test", "value",
+                          std::vector<CFG_Python_OBJ>({}));
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_EQ(results[0].get_u32(), 1);
+  EXPECT_EQ(results[1].get_u32(), 1);
+  // Directory is added to sys.path only once
+  count.run({"count = len(sys.path)"}, {"count"});
+  EXPECT_EQ(count.result_u32("count"), path_count);
+  std::filesystem::remove(file);
+  std::filesystem::remove(sibling);
+  std::filesystem::remove_all(shared_dir);
+}
+
+TEST(CFGCommon, DISABLED_Benchmark_python_mgr) {
+  std::filesystem::path file =
+      std::filesystem::absolute("python_benchmark_test.py");
+  std::ofstream(file.string()) << "TABLE = {i: i * i for i in range(1000)}\n"
+                                  "def square(value):\n"
+                                  "  return [TABLE[value % 1000]]\n";
+  constexpr uint32_t N = 1000;
+  auto elapsed = [](std::chrono::steady_clock::time_point start) {
+    return (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+  // Manager per call, like rules and instances in ModelConfig
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < N; i++) {
+    CFG_Python_MGR python;
+    std::string module = python.set_file(file.string());
+    python.run_file(module, "square",
+                    std::vector<CFG_Python_OBJ>({CFG_Python_OBJ(i)}));
+  }
+  printf("%u managers: %lld us\n", N, elapsed(start));
+  CFG_Python_MGR python;
+  std::string module = python.set_file(file.string());
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < N; i++) {
+    python.run_file(module, "square",
+                    std::vector<CFG_Python_OBJ>({CFG_Python_OBJ(i)}));
+  }
+  printf("%u run_file calls: %lld us\n", N, elapsed(start));
+  std::vector<std::vector<CFG_Python_OBJ>> args_list;
+  for (uint32_t i = 0; i < N; i++) {
+    args_list.push_back({CFG_Python_OBJ(i)});
+  }
+  start = std::chrono::steady_clock::now();
+  std::vector<std::vector<CFG_Python_OBJ>> results =
+      python.run_file_batch(module, "square", args_list);
+  printf("%u batched calls: %lld us\n", N, elapsed(start));
+  EXPECT_EQ(results.size(), N);
+  std::filesystem::remove(file);
+}
+
+static std::vector<uint8_t> synthetic_bitstream(size_t size, uint32_t seed) {
+  std::vector<uint8_t> data(size);
+  uint32_t state = seed;
+  for (auto& byte : data) {
+    state = state * 1103515245 + 12345;
+    byte = uint8_t(state >> 16);
+  }
+  return data;
+}
+
+TEST(CFGCommon, test_crc32) {
+  const std::string text = "123456789";
+  EXPECT_EQ(CFG_crc32((const uint8_t*)(text.data()), text.size()),
+            0xCBF43926);
+  EXPECT_EQ(CFG_crc32(nullptr, 0), 0);
+  // Continue from previous result
+  std::vector<uint8_t> data = synthetic_bitstream(100003, 1);
+  uint32_t crc = CFG_crc32(data.data(), 12345);
+  crc = CFG_crc32(&data[12345], data.size() - 12345, crc);
+  EXPECT_EQ(crc, CFG_crc32(data.data(), data.size()));
+}
+
+TEST(CFGCommon, test_mapped_file) {
+  std::string file =
+      std::filesystem::absolute("mapped_file_test.bin").string();
+  std::vector<uint8_t> data = synthetic_bitstream((1 << 20) + 7, 2);
+  CFG_write_binary_file(file, data.data(), data.size());
+  {
+    CFG_Mapped_File mapped(file);
+    EXPECT_TRUE(mapped.mapped());
+    ASSERT_EQ(mapped.size(), data.size());
+    EXPECT_EQ(memcmp(mapped.data(), data.data(), data.size()), 0);
+  }
+  std::vector<uint8_t> read;
+  CFG_read_binary_file(file, read);
+  EXPECT_EQ(read, data);
+  {
+    std::unique_ptr<CFG_Mapped_File> view = CFG_map_binary_file(file);
+    ASSERT_EQ(view->size(), data.size());
+    EXPECT_EQ(memcmp(view->data(), data.data(), data.size()), 0);
+  }
+  // Empty file can not be mapped
+  std::ofstream(file, std::ios::out | std::ios::binary).close();
+  {
+    CFG_Mapped_File mapped(file);
+    EXPECT_FALSE(mapped.mapped());
+    EXPECT_EQ(mapped.size(), 0);
+  }
+  EXPECT_THROW(CFG_map_binary_file(file), std::exception);
+  std::filesystem::remove(file);
+  EXPECT_THROW(CFG_Mapped_File mapped(file), std::exception);
+}
+
+TEST(CFGCommon, test_binary_writer) {
+  std::string file =
+      std::filesystem::absolute("binary_writer_test.bin").string();
+  const size_t chunk_size = 100000;
+  const size_t chunk_count = 64;
+  std::vector<uint8_t> data =
+      synthetic_bitstream(chunk_size * chunk_count + 10, 3);
+  {
+    CFG_Binary_Writer writer(file, 4096);
+    writer.write(data.data(), 10);
+    // Chunks are produced out of order by several threads
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+      threads.emplace_back([&, t]() {
+        for (size_t n = t; n < chunk_count; n += 4) {
+          size_t i = chunk_count - 1 - n;
+          const uint8_t* chunk = &data[10 + i * chunk_size];
+          writer.write_chunk(i,
+                             std::vector<uint8_t>(chunk, chunk + chunk_size));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(writer.size(), data.size());
+    writer.close();
+  }
+  std::vector<uint8_t> read;
+  CFG_read_binary_file(file, read);
+  EXPECT_EQ(read, data);
+  // Missing chunk
+  {
+    CFG_Binary_Writer writer(file);
+    writer.write_chunk(1, std::vector<uint8_t>(10, 1));
+    EXPECT_THROW(writer.write_chunk(1, std::vector<uint8_t>(10, 1)),
+                 std::exception);
+    EXPECT_THROW(writer.close(), std::exception);
+  }
+  std::filesystem::remove(file);
+}
+
+TEST(CFGCommon, test_compare_bitstream) {
+  // Large synthetic bitstream, flipped bits spread over several blocks
+  std::vector<uint8_t> data1 = synthetic_bitstream(48 << 20, 4);
+  std::vector<uint8_t> data2 = data1;
+  CFG_Bitstream_Diff diff = CFG_compare_bitstream(
+      data1.data(), data1.size(), data2.data(), data2.size());
+  EXPECT_TRUE(diff.equal);
+  EXPECT_EQ(diff.diff_bits, 0);
+  EXPECT_EQ(diff.crc1, CFG_crc32(data1.data(), data1.size()));
+  EXPECT_EQ(diff.crc1, diff.crc2);
+  EXPECT_EQ(diff.bits.size(), 0);
+
+  const std::vector<uint64_t> flipped = {
+      uint64_t(30 << 20) * 8 + 5, uint64_t(30 << 20) * 8 + 6,
+      uint64_t(30 << 20) * 8 + 70, uint64_t(40 << 20) * 8 + 1,
+      uint64_t(48 << 20) * 8 - 1};
+  for (auto bit : flipped) {
+    data2[bit / 8] ^= uint8_t(1 << (bit % 8));
+  }
+  diff = CFG_compare_bitstream(data1.data(), data1.size(), data2.data(),
+                               data2.size(), 32, 3);
+  EXPECT_FALSE(diff.equal);
+  EXPECT_EQ(diff.diff_bits, flipped.size());
+  EXPECT_NE(diff.crc1, diff.crc2);
+  EXPECT_EQ(diff.crc2, CFG_crc32(data2.data(), data2.size()));
+  EXPECT_EQ(diff.first_bit, flipped[0]);
+  EXPECT_EQ(diff.first_frame, flipped[0] / 32);
+  EXPECT_EQ(diff.first_frame_bit, 5);
+  EXPECT_EQ(diff.bits,
+            std::vector<uint64_t>(flipped.begin(), flipped.begin() + 3));
+
+  // Frame size of the device
+  diff = CFG_compare_bitstream(data1.data(), data1.size(), data2.data(),
+                               data2.size(), 1000, 0);
+  EXPECT_EQ(diff.first_frame, flipped[0] / 1000);
+  EXPECT_EQ(diff.first_frame_bit, flipped[0] % 1000);
+  EXPECT_EQ(diff.bits.size(), 0);
+
+  // Every bit is different
+  std::vector<uint8_t> inverted = data1;
+  for (auto& byte : inverted) {
+    byte = ~byte;
+  }
+  diff = CFG_compare_bitstream(data1.data(), data1.size(), inverted.data(),
+                               inverted.size());
+  EXPECT_EQ(diff.diff_bits, uint64_t(data1.size()) * 8);
+  EXPECT_EQ(diff.first_bit, 0);
+  EXPECT_EQ(diff.bits.size(), 16);
+
+  // Only the size is different
+  diff = CFG_compare_bitstream(data1.data(), data1.size(), data1.data(),
+                               data1.size() - 3);
+  EXPECT_FALSE(diff.equal);
+  EXPECT_EQ(diff.diff_bits, 0);
+  EXPECT_EQ(diff.first_bit, uint64_t(data1.size() - 3) * 8);
+  EXPECT_EQ(diff.crc1, CFG_crc32(data1.data(), data1.size()));
+  EXPECT_EQ(diff.crc2, CFG_crc32(data1.data(), data1.size() - 3));
+
+  // Files
+  std::string file1 = std::filesystem::absolute("compare_test1.bin").string();
+  std::string file2 = std::filesystem::absolute("compare_test2.bin").string();
+  CFG_write_binary_file(file1, data1.data(), data1.size());
+  CFG_write_binary_file(file2, data2.data(), data2.size());
+  EXPECT_TRUE(CFG_compare_two_binary_files(file1, file1));
+  EXPECT_FALSE(CFG_compare_two_binary_files(file1, file2));
+  diff = CFG_compare_bitstream(file1, file2);
+  EXPECT_EQ(diff.diff_bits, flipped.size());
+  EXPECT_EQ(diff.first_bit, flipped[0]);
+  std::filesystem::remove(file1);
+  std::filesystem::remove(file2);
+}
+
+TEST(CFGCommon, DISABLED_Benchmark_compare_bitstream) {
+  std::vector<uint8_t> data1 = synthetic_bitstream(256 << 20, 5);
+  std::string file1 = std::filesystem::absolute("benchmark_test1.bin").string();
+  std::string file2 = std::filesystem::absolute("benchmark_test2.bin").string();
+  auto elapsed = [](std::chrono::steady_clock::time_point start) {
+    return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+  auto start = std::chrono::steady_clock::now();
+  CFG_write_binary_file(file1, data1.data(), data1.size());
+  CFG_write_binary_file(file2, data1.data(), data1.size());
+  printf("write: %lld ms\n", elapsed(start));
+  start = std::chrono::steady_clock::now();
+  std::vector<uint8_t> read1;
+  std::vector<uint8_t> read2;
+  CFG_read_binary_file(file1, read1);
+  CFG_read_binary_file(file2, read2);
+  printf("read: %lld ms\n", elapsed(start));
+  start = std::chrono::steady_clock::now();
+  {
+    std::unique_ptr<CFG_Mapped_File> view1 = CFG_map_binary_file(file1);
+    std::unique_ptr<CFG_Mapped_File> view2 = CFG_map_binary_file(file2);
+    printf("map: %lld ms\n", elapsed(start));
+  }
+  start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(CFG_compare_two_binary_files(file1, file2));
+  printf("compare files: %lld ms\n", elapsed(start));
+  start = std::chrono::steady_clock::now();
+  CFG_Bitstream_Diff diff = CFG_compare_bitstream(file1, file2);
+  printf("compare bitstream with CRC: %lld ms\n", elapsed(start));
+  EXPECT_TRUE(diff.equal);
+  std::filesystem::remove(file1);
+  std::filesystem::remove(file2);
+}
@@ -78,4 +78,35 @@ TEST(CFGCompiler, test_static_function_Compile) {
   CFGCompiler::Compile(cfgcompiler, true);
 }
 
+TEST(CFGCompiler, test_compare_bitstream_command) {
+  Compiler* compiler = compiler_tcl_common_compiler();
+  std::vector<uint8_t> data(1 << 20, 0x5A);
+  CFG_write_binary_file("compare_bitstream1.bin", data.data(), data.size());
+  data[1000] ^= 0x10;
+  CFG_write_binary_file("compare_bitstream2.bin", data.data(), data.size());
+  int status = -1;
+  std::string result = compiler->TclInterp()->evalCmd(
+      "compare_bitstream compare_bitstream1.bin compare_bitstream1.bin",
+      &status);
+  EXPECT_EQ(status, TCL_OK);
+  EXPECT_EQ(result.find("equal 1 size1 1048576 size2 1048576"), 0);
+  result = compiler->TclInterp()->evalCmd(
+      "compare_bitstream -frame_bits 64 compare_bitstream1.bin "
+      "compare_bitstream2.bin",
+      &status);
+  EXPECT_EQ(status, TCL_OK);
+  EXPECT_EQ(result.find("equal 0"), 0);
+  EXPECT_NE(result.find(" diff_bits 1 first_bit 8004 first_frame 125 "
+                        "first_frame_bit 4 bits {8004}"),
+            std::string::npos);
+  compiler->TclInterp()->evalCmd(
+      "compare_bitstream compare_bitstream1.bin missing.bin", &status);
+  EXPECT_EQ(status, TCL_ERROR);
+  compiler->TclInterp()->evalCmd("compare_bitstream compare_bitstream1.bin",
+                                 &status);
+  EXPECT_EQ(status, TCL_ERROR);
+  std::filesystem::remove("compare_bitstream1.bin");
+  std::filesystem::remove("compare_bitstream2.bin");
+}
+
 }  // namespace FOEDAG
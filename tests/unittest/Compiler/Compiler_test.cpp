@@ -20,9 +20,27 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "Compiler/Compiler.h"
+
+#include <chrono>
+#include <future>
+#include <sstream>
+#include <thread>
+
+#include "Command/CommandStack.h"
+#include "Compiler/CompilerDefines.h"
 #include "Compiler/CompilerOpenFPGA.h"
+#include "Compiler/Constraints.h"
+#include "Main/CommandLine.h"
+#include "MainWindow/Session.h"
+#include "NewProject/ProjectManager/project_manager.h"
+#include "ProjNavigator/tcl_command_integration.h"
+#include "Tcl/TclInterpreter.h"
+#include "Utils/FileUtils.h"
 #include "gtest/gtest.h"
 
+extern FOEDAG::Session* GlobalSession;
+
+namespace fs = std::filesystem;
 using namespace FOEDAG;
 using namespace Design;
 
@@ -32,3 +50,279 @@ TEST(Compiler, Init) {
   EXPECT_EQ(compiler->GetConfiguration(), nullptr);
   delete compiler;
 }
+
+TEST(Compiler, LazySubsystems) {
+  for (bool batchMode : {true, false}) {
+    TclInterpreter eagerInterp;
+    eagerInterp.deferCmds(false);
+    std::stringstream out;
+    Compiler eager{&eagerInterp, &out};
+    eager.RegisterCommands(&eagerInterp, batchMode);
+    EXPECT_NE(eager.GetConfiguration(), nullptr);
+    const std::string eagerCommands =
+        eagerInterp.evalCmd("lsort [info commands]");
+
+    TclInterpreter interp;
+    Compiler compiler{&interp, &out};
+    compiler.RegisterCommands(&interp, batchMode);
+    EXPECT_EQ(compiler.GetConfiguration(), nullptr);
+    // stubs have the names of the commands subsystems register
+    EXPECT_EQ(interp.evalCmd("lsort [info commands]"), eagerCommands)
+        << "batch mode " << batchMode;
+    for (auto subsystem : {"simulator", "ip_generator", "design_query",
+                           "configuration", "device_modeling"})
+      EXPECT_TRUE(interp.materialize(subsystem)) << subsystem;
+    EXPECT_NE(compiler.GetConfiguration(), nullptr);
+    EXPECT_EQ(interp.evalCmd("lsort [info commands]"), eagerCommands)
+        << "batch mode " << batchMode;
+  }
+}
+
+TEST(Compiler, IpAddToDesignBeforeIpCommands) {
+  const QString name = Project::Instance()->projectName();
+  const QString path = Project::Instance()->projectPath();
+  const fs::path dir = fs::absolute("compiler_ip_add_to_design");
+  FileUtils::removeAll(dir);
+  ProjectManager* pm = new ProjectManager{};
+  pm->CreateProject("ip_add", QString::fromStdString(dir.string()));
+  pm->setProjectType(RTL);
+  TclInterpreter interp;
+  std::stringstream out;
+  Compiler compiler{&interp, &out};
+  compiler.SetErrStream(&out);
+  compiler.setGuiTclSync(new TclCommandIntegration{pm, nullptr});
+  compiler.RegisterCommands(&interp, true);
+  int res{TCL_OK};
+  interp.evalCmd("ip_add_to_design missing", &res);
+  EXPECT_EQ(res, TCL_ERROR);
+  // same as with IP generator constructed by an earlier IP command
+  EXPECT_NE(out.str().find("No IP generated with name missing"),
+            std::string::npos)
+      << out.str();
+
+  FileUtils::removeAll(dir);
+  Project::Instance()->setProjectName(name);
+  Project::Instance()->setProjectPath(path);
+}
+
+namespace {
+class TelemetryCompiler : public Compiler {
+ public:
+  using Compiler::Compiler;
+  using Compiler::RecordTelemetry;
+};
+}  // namespace
+
+TEST(Compiler, Telemetry) {
+  const QString name = Project::Instance()->projectName();
+  const QString path = Project::Instance()->projectPath();
+  const fs::path dir = fs::absolute("compiler_telemetry");
+  FileUtils::removeAll(dir);
+  ProjectManager* pm = new ProjectManager{};
+  Project::Instance()->setProjectName("telemetry");
+  Project::Instance()->setProjectPath(QString::fromStdString(dir.string()));
+  TclInterpreter interp;
+  std::stringstream out;
+  TelemetryCompiler compiler{&interp, &out};
+  compiler.SetErrStream(&out);
+  compiler.setGuiTclSync(new TclCommandIntegration{pm, nullptr});
+  compiler.RegisterCommands(&interp, true);
+  ProcessUtilization total;
+  total.duration = 2000;
+  total.cpuTime = 3000;
+  total.peakRss = 1000;
+
+  // off by default
+  compiler.RecordTelemetry(Compiler::Action::Synthesis, true, 2000, total);
+  EXPECT_FALSE(FileUtils::FileExists(compiler.Telemetry().File()));
+  int res{TCL_ERROR};
+  interp.evalCmd("telemetry on", &res);
+  EXPECT_EQ(res, TCL_OK);
+  for (int i = 0; i < 3; i++) {
+    compiler.RecordTelemetry(Compiler::Action::Synthesis, true, 2000, total);
+    compiler.RecordTelemetry(Compiler::Action::Routing, true, 2000, total);
+  }
+  // action which ran no tool
+  compiler.RecordTelemetry(Compiler::Action::Routing, true, 10, {});
+  EXPECT_TRUE(FileUtils::FileExists(compiler.Telemetry().File()));
+  EXPECT_EQ(interp.evalCmd("llength [telemetry history]"), "6");
+  // flow starts over with synthesis
+  EXPECT_EQ(interp.evalCmd("lindex [telemetry history -stage routing] 2 1"),
+            "3");
+  EXPECT_EQ(interp.evalCmd("telemetry check"), "0");
+
+  // routing run after routing starts the next run
+  compiler.RecordTelemetry(Compiler::Action::Routing, true, 5000, total);
+  EXPECT_NE(out.str().find("WARNING: routing slowdown wall_ms: 5000"),
+            std::string::npos)
+      << out.str();
+  EXPECT_EQ(interp.evalCmd("lindex [telemetry history -last 1] 0 1"), "4");
+  EXPECT_EQ(interp.evalCmd("telemetry check"), "1");
+  EXPECT_EQ(interp.evalCmd("telemetry -threshold 1000; telemetry check"), "0");
+
+  interp.evalCmd("telemetry unknown", &res);
+  EXPECT_EQ(res, TCL_ERROR);
+  interp.evalCmd("telemetry clear", &res);
+  EXPECT_EQ(res, TCL_OK);
+  EXPECT_EQ(interp.evalCmd("telemetry history"), "");
+
+  FileUtils::removeAll(dir);
+  Project::Instance()->setProjectName(name);
+  Project::Instance()->setProjectPath(path);
+}
+
+TEST(Compiler, DISABLED_Benchmark_register_commands) {
+  constexpr int N = 20;
+  auto elapsed = [](std::chrono::steady_clock::time_point start) {
+    return (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+  for (bool defer : {false, true}) {
+    long long total{0};
+    for (int i = 0; i < N; i++) {
+      TclInterpreter interp;
+      interp.deferCmds(defer);
+      std::stringstream out;
+      auto start = std::chrono::steady_clock::now();
+      Compiler compiler{&interp, &out};
+      compiler.RegisterCommands(&interp, true);
+      total += elapsed(start);
+    }
+    printf("%s registration: %lld us\n", defer ? "lazy" : "eager", total / N);
+  }
+}
+
+namespace {
+// timing analysis body waits until released, the stages surely overlap
+class BlockingCompiler : public Compiler {
+ public:
+  std::promise<void> staStarted;
+  std::shared_future<void> release;
+
+ protected:
+  bool TimingAnalysis() override {
+    staStarted.set_value();
+    release.wait();
+    return Compiler::TimingAnalysis();
+  }
+};
+}  // namespace
+
+TEST(Compiler, ConcurrentStages) {
+  const QString name = Project::Instance()->projectName();
+  const QString path = Project::Instance()->projectPath();
+  const fs::path dir = fs::absolute("compiler_concurrent_stages");
+  FileUtils::removeAll(dir);
+  ProjectManager* pm = new ProjectManager{};
+  Project::Instance()->setProjectName("concurrent");
+  Project::Instance()->setProjectPath(QString::fromStdString(dir.string()));
+  BlockingCompiler compiler;
+  compiler.setGuiTclSync(new TclCommandIntegration{pm, nullptr});
+  std::stringstream out;
+  compiler.SetOutStream(&out);
+  compiler.SetErrStream(&out);
+  std::promise<void> release;
+  compiler.release = release.get_future().share();
+  const fs::path cwd = fs::current_path();
+  const fs::path staLog =
+      compiler.FilePath(Compiler::Action::STA, TIMING_ANALYSIS_LOG);
+  const fs::path powerLog =
+      compiler.FilePath(Compiler::Action::Power, POWER_ANALYSIS_LOG);
+
+  bool sta{false};
+  std::thread staThread{
+      [&compiler, &sta]() { sta = compiler.Compile(Compiler::Action::STA); }};
+  compiler.staStarted.get_future().wait();
+  // one stage never runs twice at the same time
+  EXPECT_FALSE(compiler.Compile(Compiler::Action::STA));
+  // other stage completes while timing analysis is in progress
+  EXPECT_TRUE(compiler.Compile(Compiler::Action::Power));
+  EXPECT_TRUE(FileUtils::FileExists(powerLog));
+  EXPECT_FALSE(FileUtils::FileExists(staLog));
+  release.set_value();
+  staThread.join();
+  EXPECT_TRUE(sta);
+  EXPECT_TRUE(FileUtils::FileExists(staLog));
+  EXPECT_EQ(fs::current_path(), cwd);
+  EXPECT_NE(out.str().find("sta is already running"), std::string::npos);
+
+  FileUtils::removeAll(dir);
+  Project::Instance()->setProjectName(name);
+  Project::Instance()->setProjectPath(path);
+}
+
+TEST(Compiler, RtlCheckpoint) {
+  const QString name = Project::Instance()->projectName();
+  const QString path = Project::Instance()->projectPath();
+  Session* globalSession = GlobalSession;
+  const fs::path dir = fs::absolute("compiler_rtl_checkpoint");
+  FileUtils::removeAll(dir);
+  FileUtils::MkDirs(dir / "bin");
+  const fs::path source = dir / "top.v";
+  FileUtils::WriteToFile(source, "module top(); endmodule");
+  // stand-in yosys creates the checkpoint the script writes
+  const fs::path yosys = dir / "bin" / "yosys";
+  FileUtils::WriteToFile(yosys,
+                         "#!/bin/sh\n"
+                         "sed -n 's/^write_rtlil //p' \"$2\" | xargs -r touch\n"
+                         "echo '[]' > port_info.json\n");
+  fs::permissions(yosys, fs::perms::owner_all, fs::perm_options::add);
+
+  ProjectManager* pm = new ProjectManager{};
+  const fs::path project = dir / "checkpoint";
+  pm->CreateProject("checkpoint", QString::fromStdString(project.string()));
+  pm->setDesignFiles({}, {}, {QString::fromStdString(source.string())},
+                     VERILOG_2001, {}, false, false);
+  CompilerOpenFPGA compiler;
+  TclInterpreter* interp = new TclInterpreter;
+  Session session{nullptr,
+                  interp,
+                  new CommandStack{interp, project.string()},
+                  new CommandLine{0, nullptr},
+                  nullptr,
+                  &compiler,
+                  nullptr};
+  GlobalSession = &session;
+  compiler.setGuiTclSync(new TclCommandIntegration{pm, nullptr});
+  compiler.SetConstraints(new Constraints{&compiler});
+  std::stringstream out;
+  compiler.SetOutStream(&out);
+  compiler.SetErrStream(&out);
+  compiler.ArchitectureFile(source);
+  compiler.AnalyzeExecPath(dir / "bin" / "analyze");
+  compiler.YosysExecPath(yosys);
+  compiler.RtlCheckpointEnabled(true);
+  const fs::path checkpoint = compiler.FilePath(Compiler::Action::Analyze,
+                                                "checkpoint_analyzed.il");
+  const fs::path analysisScript = compiler.FilePath(
+      Compiler::Action::Analyze, "checkpoint_analyzer.cmd");
+  const fs::path synthesisScript =
+      compiler.FilePath(Compiler::Action::Synthesis, "checkpoint.ys");
+
+  ASSERT_TRUE(compiler.Compile(Compiler::Action::Analyze)) << out.str();
+  EXPECT_TRUE(FileUtils::FileExists(checkpoint));
+  // checkpoint holds the elaborated design
+  std::string script = FileUtils::GetFileContent(analysisScript);
+  EXPECT_LT(script.find("hierarchy -auto-top"), script.find("write_rtlil"));
+  ASSERT_TRUE(compiler.Compile(Compiler::Action::Analyze)) << out.str();
+  EXPECT_NE(out.str().find("skipping analysis"), std::string::npos);
+
+  ASSERT_TRUE(compiler.Compile(Compiler::Action::Synthesis)) << out.str();
+  script = FileUtils::GetFileContent(synthesisScript);
+  EXPECT_NE(script.find("read_rtlil " + checkpoint.string()),
+            std::string::npos);
+  EXPECT_EQ(script.find("read_verilog"), std::string::npos);
+  // edited source is read again
+  fs::last_write_time(
+      source, fs::file_time_type::clock::now() + std::chrono::hours{1});
+  ASSERT_TRUE(compiler.Compile(Compiler::Action::Synthesis)) << out.str();
+  script = FileUtils::GetFileContent(synthesisScript);
+  EXPECT_EQ(script.find("read_rtlil"), std::string::npos);
+  EXPECT_NE(script.find("read_verilog"), std::string::npos);
+
+  GlobalSession = globalSession;
+  FileUtils::removeAll(dir);
+  Project::Instance()->setProjectName(name);
+  Project::Instance()->setProjectPath(path);
+}
@@ -0,0 +1,169 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Compiler/ExecutionContext.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Utils/FileUtils.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+using namespace FOEDAG;
+
+class ExecutionContextTest : public testing::Test {
+ public:
+  void SetUp() override {
+    FileUtils::removeFile(m_dir);
+    FileUtils::MkDirs(m_dir);
+  }
+  void TearDown() override { FileUtils::removeFile(m_dir); }
+
+ protected:
+  fs::path m_dir{fs::absolute("execution_context_test")};
+};
+
+TEST_F(ExecutionContextTest, PathIsAbsolute) {
+  ExecutionContext context{"execution_context_test"};
+  EXPECT_TRUE(context.WorkingDir().is_absolute());
+  EXPECT_EQ(context.Path("file.log"), context.WorkingDir() / "file.log");
+  EXPECT_EQ(context.Path(m_dir / "file.log"), m_dir / "file.log");
+}
+
+TEST_F(ExecutionContextTest, ScopeBindsCurrent) {
+  ExecutionContext outer{m_dir};
+  ExecutionContext inner{m_dir};
+  EXPECT_EQ(ExecutionContext::Current(), nullptr);
+  {
+    ExecutionContext::Scope outerScope{outer};
+    EXPECT_EQ(ExecutionContext::Current(), &outer);
+    {
+      ExecutionContext::Scope innerScope{inner};
+      EXPECT_EQ(ExecutionContext::Current(), &inner);
+      // other threads don't see the binding
+      ExecutionContext* other{&inner};
+      std::thread{[&other]() { other = ExecutionContext::Current(); }}.join();
+      EXPECT_EQ(other, nullptr);
+    }
+    EXPECT_EQ(ExecutionContext::Current(), &outer);
+  }
+  EXPECT_EQ(ExecutionContext::Current(), nullptr);
+}
+
+TEST_F(ExecutionContextTest, ErrorStopsExecution) {
+  ExecutionContext context{m_dir};
+  context.SetError("error");
+  EXPECT_TRUE(context.HasError());
+  EXPECT_EQ(context.Error(), "error");
+  context.ResetError();
+  EXPECT_FALSE(context.HasError());
+  context.Stop();
+  EXPECT_TRUE(context.Stopped());
+  EXPECT_EQ(context.Execute("echo stopped"), -1);
+  context.ResetStop();
+  EXPECT_FALSE(context.Stopped());
+}
+
+#ifndef _WIN32
+TEST_F(ExecutionContextTest, ExecuteInWorkingDirectory) {
+  const fs::path cwd = fs::current_path();
+  std::stringstream out;
+  std::stringstream err;
+  ExecutionContext context{m_dir / "run", &out, &err};
+  context.SetEnvironmentVariable("FOEDAG_CONTEXT_TEST", "old");
+  context.SetEnvironmentVariable("FOEDAG_CONTEXT_TEST", "value");
+  EXPECT_EQ(context.Environment().at("FOEDAG_CONTEXT_TEST"), "value");
+  EXPECT_EQ(context.Execute("sh -c \"pwd; echo $FOEDAG_CONTEXT_TEST\"",
+                            "run.log"),
+            0);
+  EXPECT_EQ(fs::current_path(), cwd);
+  EXPECT_NE(out.str().find(fs::canonical(m_dir / "run").string()),
+            std::string::npos);
+  EXPECT_NE(out.str().find("value"), std::string::npos);
+  EXPECT_TRUE(FileUtils::FileExists(m_dir / "run" / "run.log"));
+
+  // relative directory is resolved against the context one, log follows it
+  EXPECT_EQ(context.Execute("sh -c \"echo error 1>&2; exit 3\"", "sub.log",
+                            false, "sub"),
+            3);
+  EXPECT_NE(err.str().find("error"), std::string::npos);
+  EXPECT_TRUE(FileUtils::FileExists(m_dir / "run" / "sub" / "sub.log"));
+  EXPECT_EQ(context.Execute("missing_program_for_context_test"), -1);
+}
+
+TEST_F(ExecutionContextTest, StopTerminatesCommand) {
+  std::stringstream out;
+  ExecutionContext context{m_dir, &out, &out};
+  int result{0};
+  std::thread worker{
+      [&context, &result]() { result = context.Execute("sleep 30"); }};
+  std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  context.Stop();
+  worker.join();
+  EXPECT_EQ(result, -1);
+}
+
+// Several stages running concurrently, each one in its own directory with its
+// own sinks. Nothing may leak between contexts.
+TEST_F(ExecutionContextTest, ConcurrentContexts) {
+  const fs::path cwd = fs::current_path();
+  constexpr int Count{8};
+  constexpr int Iterations{5};
+  std::stringstream outputs[Count];
+  int failures[Count]{};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < Count; i++) {
+    threads.emplace_back([this, i, &outputs, &failures]() {
+      const std::string stage = "stage" + std::to_string(i);
+      ExecutionContext context{m_dir / stage, &outputs[i], &outputs[i]};
+      ExecutionContext::Scope scope{context};
+      for (int j = 0; j < Iterations; j++) {
+        const std::string command =
+            "sh -c \"echo " + stage + " > result.txt; pwd\"";
+        if (context.Execute(command, stage + ".log", true) != 0 ||
+            ExecutionContext::Current() != &context)
+          failures[i]++;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(fs::current_path(), cwd);
+  for (int i = 0; i < Count; i++) {
+    const std::string stage = "stage" + std::to_string(i);
+    const fs::path dir = m_dir / stage;
+    EXPECT_EQ(failures[i], 0) << stage;
+    std::ifstream result{dir / "result.txt"};
+    std::string line;
+    std::getline(result, line);
+    EXPECT_EQ(line, stage);
+    EXPECT_TRUE(FileUtils::FileExists(dir / (stage + ".log")));
+    for (int j = 0; j < Count; j++) {
+      if (j == i) continue;
+      const std::string other = "stage" + std::to_string(j);
+      EXPECT_EQ(outputs[i].str().find(other + " "), std::string::npos);
+      EXPECT_EQ(outputs[i].str().find("/" + other + "\n"), std::string::npos);
+    }
+  }
+}
+#endif
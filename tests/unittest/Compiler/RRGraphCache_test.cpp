@@ -0,0 +1,166 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Compiler/RRGraphCache.h"
+
+#include "Utils/FileUtils.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+using namespace FOEDAG;
+
+class RRGraphCacheTest : public testing::Test {
+ public:
+  void SetUp() override {
+    FileUtils::removeFile(m_dir);
+    FileUtils::MkDirs(m_dir);
+    FileUtils::WriteToFile(m_arch, "<architecture/>");
+    m_cache.Directory(m_dir / "cache");
+    FileUtils::MkDirs(m_cache.Directory());
+    m_key.architecture = m_arch;
+    m_key.channelWidth = 160;
+    m_key.deviceSize = "10x8";
+    m_key.vprVersion = "vpr 8.1.0";
+  }
+  void TearDown() override { FileUtils::removeFile(m_dir); }
+
+  fs::path addEntry(const RRGraphCache::Key& key) {
+    auto hash = m_cache.Hash(key);
+    auto pending = m_cache.PendingFile(hash);
+    FileUtils::WriteToFile(pending, "rr_graph");
+    EXPECT_TRUE(m_cache.Commit(pending, hash, key));
+    EXPECT_FALSE(FileUtils::FileExists(pending));
+    return m_cache.Lookup(hash);
+  }
+
+ protected:
+  fs::path m_dir{fs::absolute("rr_graph_cache_test")};
+  fs::path m_arch{m_dir / "arch.xml"};
+  RRGraphCache m_cache;
+  RRGraphCache::Key m_key;
+};
+
+TEST_F(RRGraphCacheTest, HashDependsOnKey) {
+  auto hash = m_cache.Hash(m_key);
+  EXPECT_FALSE(hash.empty());
+  EXPECT_EQ(hash, m_cache.Hash(m_key));
+
+  auto key = m_key;
+  key.channelWidth = 200;
+  EXPECT_NE(hash, m_cache.Hash(key));
+  key = m_key;
+  key.deviceSize = "12x8";
+  EXPECT_NE(hash, m_cache.Hash(key));
+  key = m_key;
+  key.vprVersion = "vpr 9.0.0";
+  EXPECT_NE(hash, m_cache.Hash(key));
+
+  FileUtils::WriteToFile(m_arch, "<architecture></architecture>");
+  EXPECT_NE(hash, m_cache.Hash(m_key));
+}
+
+TEST_F(RRGraphCacheTest, HashMissingArchitecture) {
+  m_key.architecture = m_dir / "missing.xml";
+  EXPECT_TRUE(m_cache.Hash(m_key).empty());
+}
+
+TEST_F(RRGraphCacheTest, CommitAndLookup) {
+  auto hash = m_cache.Hash(m_key);
+  EXPECT_TRUE(m_cache.Lookup(hash).empty());
+  auto graph = addEntry(m_key);
+  EXPECT_FALSE(graph.empty());
+  EXPECT_EQ(graph.filename().string(), hash + RRGraphCache::GraphExtension);
+  EXPECT_EQ(m_cache.Statistics().entries, 1u);
+}
+
+TEST_F(RRGraphCacheTest, CommitEmptyGraph) {
+  auto hash = m_cache.Hash(m_key);
+  auto pending = m_cache.PendingFile(hash);
+  FileUtils::WriteToFile(pending, "", false);
+  EXPECT_FALSE(m_cache.Commit(pending, hash, m_key));
+  EXPECT_FALSE(FileUtils::FileExists(pending));
+  EXPECT_TRUE(m_cache.Lookup(hash).empty());
+}
+
+TEST_F(RRGraphCacheTest, PendingFileIsUnique) {
+  auto hash = m_cache.Hash(m_key);
+  // concurrent stages building the same graph must not share the file
+  auto first = m_cache.PendingFile(hash);
+  auto second = m_cache.PendingFile(hash);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first.parent_path(), second.parent_path());
+}
+
+TEST_F(RRGraphCacheTest, EvictLeastRecentlyUsed) {
+  m_cache.MaxEntries(2);
+  auto key1 = m_key;
+  auto key2 = m_key;
+  key2.channelWidth = 200;
+  auto key3 = m_key;
+  key3.channelWidth = 300;
+  addEntry(key1);
+  auto graph2 = addEntry(key2);
+  // make key1 the most recently used one
+  fs::last_write_time(graph2,
+                      fs::file_time_type::clock::now() - std::chrono::hours{1});
+  EXPECT_FALSE(m_cache.Lookup(m_cache.Hash(key1)).empty());
+  addEntry(key3);
+  EXPECT_EQ(m_cache.Statistics().entries, 2u);
+  EXPECT_FALSE(m_cache.Lookup(m_cache.Hash(key1)).empty());
+  EXPECT_TRUE(m_cache.Lookup(m_cache.Hash(key2)).empty());
+  EXPECT_FALSE(m_cache.Lookup(m_cache.Hash(key3)).empty());
+}
+
+TEST_F(RRGraphCacheTest, EvictBySize) {
+  m_cache.MaxEntries(0);
+  addEntry(m_key);
+  auto key = m_key;
+  key.channelWidth = 200;
+  addEntry(key);
+  EXPECT_EQ(m_cache.Statistics().entries, 2u);
+  m_cache.MaxSizeBytes(m_cache.Statistics().sizeBytes - 1);
+  EXPECT_EQ(m_cache.Evict(), 1u);
+  EXPECT_EQ(m_cache.Statistics().entries, 1u);
+}
+
+TEST_F(RRGraphCacheTest, DisabledByDefault) {
+  EXPECT_FALSE(RRGraphCache{}.Enabled());
+}
+
+TEST_F(RRGraphCacheTest, EvictStalePending) {
+  auto hash = m_cache.Hash(m_key);
+  auto running = m_cache.PendingFile(hash);
+  auto killed = m_cache.PendingFile(hash);
+  FileUtils::WriteToFile(running, "rr_graph");
+  FileUtils::WriteToFile(killed, "rr_graph");
+  fs::last_write_time(killed, fs::file_time_type::clock::now() -
+                                  RRGraphCache::PendingLifetime -
+                                  std::chrono::hours{1});
+  EXPECT_EQ(m_cache.Evict(), 0u);
+  EXPECT_TRUE(FileUtils::FileExists(running));
+  EXPECT_FALSE(FileUtils::FileExists(killed));
+}
+
+TEST_F(RRGraphCacheTest, Clear) {
+  addEntry(m_key);
+  EXPECT_EQ(m_cache.Clear(), 1u);
+  EXPECT_EQ(m_cache.Statistics().entries, 0u);
+}
@@ -0,0 +1,229 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Compiler/StaSession.h"
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+#ifndef _WIN32
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// Stand-in for OpenSTA: answers framed commands, logs design reads
+static constexpr const char* StandInSta{R"sh(#!/bin/sh
+echo "OpenSTA stand-in"
+while IFS= read -r line; do
+  case "$line" in
+    "foedag_frame "*)
+      id=$(echo "$line" | cut -d' ' -f2)
+      cmd=$(echo "$line" | sed -e 's/^foedag_frame [0-9]* {//' -e 's/}$//')
+      echo "@@FOEDAG_BEGIN $id"
+      status=0
+      case "$cmd" in
+        read_*|link_design*) echo "$cmd" >> reads.log ;;
+        report_checks*)
+          echo "Startpoint: a (rising edge-triggered flip-flop)"
+          echo "   1.25   slack (MET)" ;;
+        fail*) echo "Error: no such command"; status=1 ;;
+        sleep*) sleep 30 ;;
+        crash*) exit 3 ;;
+      esac
+      echo "@@FOEDAG_END $id $status" ;;
+    exit) exit 0 ;;
+  esac
+done
+)sh"};
+
+class StaSessionTest : public testing::Test {
+ public:
+  void SetUp() override {
+    fs::remove_all(m_dir);
+    fs::create_directories(m_dir);
+    std::ofstream{m_sta} << StandInSta;
+    fs::permissions(m_sta, fs::perms::owner_all, fs::perm_options::add);
+    m_design = {m_dir / "design.lib", m_dir / "design.v", m_dir / "design.sdf",
+                m_dir / "design.sdc", "design"};
+    for (const auto& file : {m_design.liberty, m_design.netlist,
+                             m_design.sdf, m_design.sdc})
+      write(file, "content");
+    m_session.WorkingDir(m_dir);
+    m_session.Timeout(10000);
+  }
+  void TearDown() override {
+    m_session.Stop();
+    fs::remove_all(m_dir);
+  }
+
+  static void write(const fs::path& file, const std::string& content) {
+    std::ofstream{file} << content;
+  }
+
+  // design reads since the previous call
+  std::vector<std::string> reads() {
+    std::vector<std::string> lines;
+    std::ifstream stream{m_dir / "reads.log"};
+    std::string line;
+    while (std::getline(stream, line)) lines.push_back(line);
+    fs::remove(m_dir / "reads.log");
+    return lines;
+  }
+
+ protected:
+  fs::path m_dir{fs::absolute("sta_session_test")};
+  fs::path m_sta{m_dir / "sta"};
+  StaDesign m_design;
+  StaSession m_session{m_sta};
+};
+
+TEST_F(StaSessionTest, LoadOnceQueryMany) {
+  std::string error;
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  EXPECT_TRUE(m_session.Running());
+  const std::vector<std::string> expected{
+      "read_liberty {" + m_design.liberty.string() + "}",
+      "read_verilog {" + m_design.netlist.string() + "}",
+      "link_design {design}", "read_sdf {" + m_design.sdf.string() + "}",
+      "read_sdc {" + m_design.sdc.string() + "}"};
+  EXPECT_EQ(reads(), expected);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+    std::string output;
+    ASSERT_TRUE(
+        m_session.Query("report_checks -path_delay max", output, &error))
+        << error;
+    EXPECT_EQ(output,
+              "Startpoint: a (rising edge-triggered flip-flop)\n"
+              "   1.25   slack (MET)\n");
+  }
+  EXPECT_TRUE(reads().empty());
+  auto stats = m_session.Statistics();
+  EXPECT_EQ(stats.starts, 1);
+  EXPECT_EQ(stats.links, 1);
+  EXPECT_EQ(stats.sdfReads, 1);
+  EXPECT_EQ(stats.queries, 20);
+}
+
+TEST_F(StaSessionTest, ReloadChangedInputs) {
+  std::string error;
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  reads();
+  // SDF only is annotated again
+  write(m_design.sdf, "new delays");
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  EXPECT_EQ(reads(), std::vector<std::string>{"read_sdf {" +
+                                              m_design.sdf.string() + "}"});
+  // netlist and constraints re-link the design in the same process
+  write(m_design.netlist, "new netlist");
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  EXPECT_EQ(reads().size(), 4);
+  write(m_design.sdc, "new constraints");
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  EXPECT_EQ(reads().size(), 4);
+  auto stats = m_session.Statistics();
+  EXPECT_EQ(stats.starts, 1);
+  EXPECT_EQ(stats.links, 3);
+  EXPECT_EQ(stats.sdfReads, 4);
+  // liberty restarts the session
+  write(m_design.liberty, "new library");
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  EXPECT_EQ(reads().size(), 5);
+  EXPECT_EQ(m_session.Statistics().starts, 2);
+}
+
+TEST_F(StaSessionTest, RewrittenInputs) {
+  std::string error;
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  reads();
+  // flow rewrites its outputs with the same content
+  for (const auto& file : {m_design.liberty, m_design.netlist,
+                           m_design.sdf, m_design.sdc})
+    write(file, "content");
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  EXPECT_TRUE(reads().empty());
+  // same size, different content
+  write(m_design.sdf, "CONTENT");
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  EXPECT_EQ(reads(), std::vector<std::string>{"read_sdf {" +
+                                              m_design.sdf.string() + "}"});
+  auto stats = m_session.Statistics();
+  EXPECT_EQ(stats.starts, 1);
+  EXPECT_EQ(stats.links, 1);
+  EXPECT_EQ(stats.sdfReads, 2);
+}
+
+TEST_F(StaSessionTest, FailedCommands) {
+  std::string output;
+  std::string error;
+  EXPECT_FALSE(m_session.Query("report_checks", output, &error));
+  EXPECT_FALSE(error.empty());
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  // Tcl error keeps the session
+  EXPECT_FALSE(m_session.Query("fail", output, &error));
+  EXPECT_EQ(output, "Error: no such command\n");
+  EXPECT_NE(error.find("fail failed"), std::string::npos);
+  EXPECT_FALSE(m_session.Query("report_checks {", output, &error));
+  EXPECT_TRUE(m_session.Running());
+  EXPECT_TRUE(m_session.Query("report_checks", output, &error)) << error;
+  // lost session is restarted by the next load
+  EXPECT_FALSE(m_session.Query("crash", output, &error));
+  EXPECT_EQ(error, "STA session terminated");
+  EXPECT_FALSE(m_session.Running());
+  ASSERT_TRUE(m_session.Load(m_design, &error)) << error;
+  EXPECT_EQ(m_session.Statistics().starts, 2);
+  m_session.Timeout(300);
+  EXPECT_FALSE(m_session.Query("sleep", output, &error));
+  EXPECT_EQ(error, "STA command timed out");
+  EXPECT_FALSE(m_session.Running());
+}
+
+TEST_F(StaSessionTest, MissingInputs) {
+  std::string error;
+  fs::remove(m_design.sdf);
+  EXPECT_FALSE(m_session.Load(m_design, &error));
+  EXPECT_NE(error.find("design.sdf"), std::string::npos);
+  EXPECT_FALSE(m_session.Running());
+  write(m_design.sdf, "content");
+  m_session.Executable(m_dir / "missing_sta");
+  EXPECT_FALSE(m_session.Load(m_design, &error));
+  EXPECT_NE(error.find("Cannot execute"), std::string::npos);
+  EXPECT_FALSE(m_session.Running());
+}
+
+TEST_F(StaSessionTest, ExitedAtStart) {
+  const fs::path broken{m_dir / "broken_sta"};
+  write(broken, "#!/bin/sh\necho \"no license\"\n");
+  fs::permissions(broken, fs::perms::owner_all, fs::perm_options::add);
+  m_session.Executable(broken);
+  // tool may be gone before or after the frame procedure is sent
+  for (int i = 0; i < 10; i++) {
+    std::string error;
+    EXPECT_FALSE(m_session.Load(m_design, &error));
+    EXPECT_NE(error.find("Cannot start STA session"), std::string::npos);
+    EXPECT_NE(error.find("no license"), std::string::npos) << error;
+    EXPECT_FALSE(m_session.Running());
+  }
+}
+#endif
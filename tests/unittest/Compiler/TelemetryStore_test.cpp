@@ -0,0 +1,235 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Compiler/TelemetryStore.h"
+
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+using namespace FOEDAG;
+
+class TelemetryStoreTest : public testing::Test {
+ public:
+  void SetUp() override {
+    fs::remove_all(m_dir);
+    m_store.File(m_dir / "test.telemetry");
+  }
+  void TearDown() override { fs::remove_all(m_dir); }
+
+  static TelemetryRecord record(uint32_t run, uint32_t wallTime,
+                                double fmax) {
+    TelemetryRecord r;
+    r.run = run;
+    r.stage = "routing";
+    r.success = true;
+    r.wallTime = wallTime;
+    r.cpuTime = wallTime;
+    r.peakRss = 1000;
+    r.qor["fmax"] = fmax;
+    r.qor["lut"] = 100;
+    return r;
+  }
+
+ protected:
+  fs::path m_dir{fs::absolute("telemetry_store_test")};
+  TelemetryStore m_store;
+};
+
+TEST_F(TelemetryStoreTest, AppendRead) {
+  EXPECT_FALSE(m_store.Enabled());
+  EXPECT_EQ(m_store.NextRun(), 1);
+  TelemetryRecord synth;
+  synth.run = 1;
+  synth.timestamp = 1700000000000;
+  synth.stage = "synthesis";
+  synth.success = true;
+  synth.wallTime = 1500;
+  synth.cpuTime = 2500;
+  synth.peakRss = 204800;
+  synth.readBytes = 1ull << 33;
+  synth.writeBytes = 42;
+  synth.qor["lut"] = 320;
+  EXPECT_TRUE(m_store.Append(synth));
+  EXPECT_TRUE(m_store.Append(record(1, 2000, 150)));
+  EXPECT_TRUE(m_store.Append(record(2, 2100, 151)));
+
+  auto all = m_store.Read();
+  ASSERT_EQ(all.size(), 3);
+  EXPECT_EQ(all.front().stage, "synthesis");
+  EXPECT_EQ(all.front().timestamp, synth.timestamp);
+  EXPECT_EQ(all.front().cpuTime, 2500);
+  EXPECT_EQ(all.front().peakRss, 204800);
+  EXPECT_EQ(all.front().readBytes, 1ull << 33);
+  EXPECT_EQ(all.front().writeBytes, 42);
+  EXPECT_EQ(all.front().qor, synth.qor);
+
+  auto routing = m_store.Read("routing", 1);
+  ASSERT_EQ(routing.size(), 1);
+  EXPECT_EQ(routing.front().run, 2);
+  EXPECT_EQ(m_store.Read("routing").size(), 2);
+  EXPECT_EQ(m_store.NextRun(), 3);
+
+  EXPECT_TRUE(m_store.Clear());
+  EXPECT_TRUE(m_store.Read().empty());
+}
+
+TEST_F(TelemetryStoreTest, TruncatedRecord) {
+  EXPECT_TRUE(m_store.Append(record(1, 2000, 150)));
+  {
+    // interrupted write, record frame of 60 bytes with 3 bytes written
+    std::ofstream out{m_store.File(), std::ios::binary | std::ios::app};
+    out.write("\x02\x3c\x00\x00\x00\x02\x00\x00", 8);
+  }
+  EXPECT_EQ(m_store.Read().size(), 1);
+  EXPECT_TRUE(m_store.Append(record(3, 2000, 150)));
+  auto records = m_store.Read();
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records.back().run, 3);
+  EXPECT_EQ(TelemetryStore{m_store.File()}.Read().size(), 2);
+}
+
+TEST_F(TelemetryStoreTest, SharedFile) {
+  EXPECT_TRUE(m_store.Append(record(1, 2000, 150)));
+  const auto size = fs::file_size(m_store.File());
+  EXPECT_TRUE(m_store.Append(record(2, 2000, 150)));
+  // names are stored once: 47 bytes of fields, 12 per QoR metric, 9 of frame
+  EXPECT_EQ(fs::file_size(m_store.File()) - size, 80u);
+
+  // store of other session appends to the same file
+  TelemetryStore other{m_store.File()};
+  EXPECT_EQ(other.NextRun(), 3);
+  EXPECT_TRUE(other.Append(record(3, 2000, 150)));
+  EXPECT_EQ(m_store.NextRun(), 4);
+  EXPECT_EQ(m_store.Read("routing").size(), 3);
+}
+
+TEST_F(TelemetryStoreTest, SessionsAddNames) {
+  TelemetryStore other{m_store.File()};
+  EXPECT_TRUE(m_store.Append(record(1, 2000, 150)));
+  EXPECT_EQ(other.Read().size(), 1);
+  // both sessions write names the other one hasn't seen
+  auto placement = record(1, 1000, 150);
+  placement.stage = "placement";
+  placement.qor = {{"ff", 10}};
+  EXPECT_TRUE(other.Append(placement));
+  auto synthesis = record(1, 3000, 150);
+  synthesis.stage = "synthesis";
+  synthesis.qor = {{"dsp", 2}};
+  EXPECT_TRUE(m_store.Append(synthesis));
+
+  for (const TelemetryStore* store :
+       {&m_store, &other, new TelemetryStore{m_store.File()}}) {
+    auto records = store->Read();
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_EQ(records.at(0).stage, "routing");
+    EXPECT_EQ(records.at(1).stage, "placement");
+    EXPECT_EQ(records.at(1).qor, placement.qor);
+    EXPECT_EQ(records.at(2).stage, "synthesis");
+    EXPECT_EQ(records.at(2).qor, synthesis.qor);
+    if (store != &m_store && store != &other) delete store;
+  }
+}
+
+TEST_F(TelemetryStoreTest, ConcurrentSessions) {
+  constexpr uint32_t N = 300;
+  auto append = [this](const std::string& stage) {
+    TelemetryStore store{m_store.File()};
+    for (uint32_t i = 0; i < N; i++) {
+      auto r = record(i + 1, 2000, 150);
+      r.stage = stage;
+      r.qor = {{stage + "_metric", double(i)}};
+      store.Append(r);
+    }
+  };
+  const std::vector<std::string> stages{"s1", "s2", "s3", "s4",
+                                        "s5", "s6", "s7", "s8"};
+  std::vector<std::thread> sessions;
+  for (const auto& stage : stages) sessions.emplace_back(append, stage);
+  for (auto& session : sessions) session.join();
+  for (const auto& stage : stages) {
+    auto records = m_store.Read(stage);
+    ASSERT_EQ(records.size(), N);
+    for (uint32_t i = 0; i < N; i++) {
+      EXPECT_EQ(records.at(i).run, i + 1);
+      EXPECT_EQ(records.at(i).qor.at(stage + "_metric"), i);
+    }
+  }
+}
+
+TEST_F(TelemetryStoreTest, ForeignFile) {
+  fs::create_directories(m_dir);
+  {
+    std::ofstream out{m_store.File()};
+    out << "{\"run\":1,\"stage\":\"routing\"}\n";
+  }
+  EXPECT_TRUE(m_store.Read().empty());
+  std::string error;
+  EXPECT_FALSE(m_store.Append(record(1, 2000, 150), &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_TRUE(m_store.Clear());
+  EXPECT_TRUE(m_store.Append(record(1, 2000, 150)));
+  EXPECT_EQ(m_store.Read().size(), 1);
+}
+
+TEST_F(TelemetryStoreTest, Check) {
+  // no baseline yet
+  EXPECT_TRUE(m_store.Check(record(1, 10000, 150)).empty());
+  for (uint32_t run = 1; run <= 6; run++)
+    m_store.Append(record(run, 10000 + run * 100, 150));
+  // failed run is not part of the baseline
+  auto failed = record(7, 100000, 10);
+  failed.success = false;
+  m_store.Append(failed);
+
+  EXPECT_TRUE(m_store.Check(record(8, 11000, 140)).empty());
+
+  auto slow = record(8, 20000, 150);
+  slow.qor["lut"] = 200;
+  auto flags = m_store.Check(slow);
+  ASSERT_EQ(flags.size(), 3);
+  EXPECT_EQ(flags.at(0).kind, TelemetryFlag::Slowdown);
+  EXPECT_EQ(flags.at(0).metric, "wall_ms");
+  // median of runs 2..6
+  EXPECT_DOUBLE_EQ(flags.at(0).baseline, 10400);
+  EXPECT_EQ(flags.at(1).metric, "cpu_ms");
+  EXPECT_EQ(flags.at(2).kind, TelemetryFlag::Regression);
+  EXPECT_EQ(flags.at(2).metric, "lut");
+  EXPECT_DOUBLE_EQ(flags.at(2).change, 100);
+
+  flags = m_store.Check(record(8, 10000, 100));
+  ASSERT_EQ(flags.size(), 1);
+  EXPECT_EQ(flags.front().metric, "fmax");
+  EXPECT_EQ(TelemetryStore::ToString(flags.front()),
+            "regression fmax: 100 (baseline 150, 33.3% worse)");
+
+  m_store.Threshold(50);
+  EXPECT_TRUE(m_store.Check(record(8, 10000, 100)).empty());
+}
+
+TEST_F(TelemetryStoreTest, NoiseFloor) {
+  for (uint32_t run = 1; run <= 3; run++) m_store.Append(record(run, 100, 150));
+  EXPECT_TRUE(m_store.Check(record(4, 900, 150)).empty());
+  EXPECT_EQ(m_store.Check(record(4, 1500, 150)).size(), 2);
+}
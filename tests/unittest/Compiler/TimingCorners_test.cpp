@@ -0,0 +1,268 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Compiler/TimingCorners.h"
+
+#include "Compiler/ExecutionContext.h"
+#include "Compiler/Reports/TimingAnalysisReportManager.h"
+#include "gtest/gtest.h"
+#include "nlohmann_json/json.hpp"
+
+using namespace FOEDAG;
+
+#ifndef _WIN32
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using json = nlohmann::ordered_json;
+
+// Stand-in timing tool: canned OpenSTA report of the corner and mode
+static constexpr const char* StandInTool{R"sh(#!/bin/sh
+sleep 1
+case "$1_$2" in
+  slow_func) setup=-0.40; hold=0.30; out=0.50 ;;
+  slow_scan) setup=-0.30; hold=0.30; out=-0.20 ;;
+  fast_func) setup=0.90; hold=-0.05; out=1.50 ;;
+  fast_scan) setup=0.90; hold=-0.10; out=1.50 ;;
+  *) echo "Error: no liberty for corner $1"; exit 1 ;;
+esac
+path() {
+  status=MET
+  case "$3" in -*) status=VIOLATED ;; esac
+  echo "Startpoint: a (input port clocked by clk)"
+  echo "Endpoint: $1 (rising edge-triggered flip-flop clocked by clk)"
+  echo "Path Group: clk"
+  echo "Path Type: $2"
+  echo ""
+  echo "  Delay    Time   Description"
+  echo "   0.00    0.00   clock clk (rise edge)"
+  echo "           $3   slack ($status)"
+  echo ""
+}
+echo "Corner $1, mode $2"
+path q_reg/D max $setup
+path q_reg/D min $hold
+path out max $out
+echo "Endpoint: b (output port)"
+echo "Path Type: max"
+echo "(Path is unconstrained)"
+)sh"};
+
+class TimingCornersTest : public testing::Test {
+ public:
+  void SetUp() override {
+    fs::remove_all(m_dir);
+    fs::create_directories(m_dir);
+    std::ofstream{m_tool} << StandInTool;
+    fs::permissions(m_tool, fs::perms::owner_all, fs::perm_options::add);
+  }
+  void TearDown() override { fs::remove_all(m_dir); }
+
+  TimingCornerAnalysis::Prepare prepare() const {
+    return [this](CornerRun& run) {
+      run.command = m_tool.string() + " " + run.corner.name + " " +
+                    run.mode.name;
+      return true;
+    };
+  }
+
+ protected:
+  fs::path m_dir{fs::absolute("timing_corners_test")};
+  fs::path m_tool{m_dir / "timing.sh"};
+};
+
+TEST_F(TimingCornersTest, ParseReports) {
+  std::ofstream{m_dir / "opensta.rpt"}
+      << "Startpoint: a (input port clocked by clk)\n"
+         "Endpoint: q_reg/D (rising edge-triggered flip-flop)\n"
+         "Path Type: max\n"
+         "           0.75   slack (MET)\n"
+         "Endpoint: q_reg/D (rising edge-triggered flip-flop)\n"
+         "Path Type: max\n"
+         "          -0.25   slack (VIOLATED)\n"
+         "Endpoint: q_reg/D (rising edge-triggered flip-flop)\n"
+         "Path Type: min\n"
+         "           0.10   slack (MET)\n";
+  std::ofstream{m_dir / "vpr.rpt"}
+      << "#Path 1\n"
+         "Startpoint: a.inpad[0] (.input clocked by clk)\n"
+         "Endpoint  : out:b.outpad[0] (.output clocked by clk)\n"
+         "Path Type : setup\n"
+         "slack (VIOLATED)                                      -1.234\n"
+         "#Path 2\n"
+         "Endpoint  : q.D[0] (dffre clocked by clk)\n"
+         "Path Type : hold\n"
+         "slack (MET)                                            0.050\n";
+
+  auto slacks =
+      TimingAnalysisReportManager::ParseEndpointSlacks(m_dir / "opensta.rpt");
+  ASSERT_EQ(slacks.size(), 2);
+  EXPECT_EQ(slacks[0].endpoint, "q_reg/D");
+  EXPECT_EQ(slacks[0].check, "setup");
+  EXPECT_DOUBLE_EQ(slacks[0].slack, -0.25);
+  EXPECT_EQ(slacks[1].check, "hold");
+  EXPECT_DOUBLE_EQ(slacks[1].slack, 0.10);
+
+  slacks = TimingAnalysisReportManager::ParseEndpointSlacks(m_dir / "vpr.rpt");
+  ASSERT_EQ(slacks.size(), 2);
+  EXPECT_EQ(slacks[0].endpoint, "out:b.outpad[0]");
+  EXPECT_EQ(slacks[0].check, "setup");
+  EXPECT_DOUBLE_EQ(slacks[0].slack, -1.234);
+  EXPECT_EQ(slacks[1].endpoint, "q.D[0]");
+  EXPECT_EQ(slacks[1].check, "hold");
+  EXPECT_DOUBLE_EQ(slacks[1].slack, 0.05);
+
+  EXPECT_TRUE(
+      TimingAnalysisReportManager::ParseEndpointSlacks(m_dir / "missing.rpt")
+          .empty());
+}
+
+TEST_F(TimingCornersTest, MergeWorstSlacks) {
+  TimingCornerAnalysis analysis;
+  analysis.Jobs(4);
+  analysis.AddCorner({"slow", m_dir / "slow.lib", m_dir / "slow.sdf"});
+  analysis.AddCorner({"fast", m_dir / "fast.lib", {}});
+  analysis.AddMode({"func", m_dir / "func.sdc"});
+  analysis.AddMode({"scan", m_dir / "scan.sdc"});
+  // same name replaces the corner
+  analysis.AddCorner({"fast", m_dir / "fast.lib", m_dir / "fast.sdf"});
+  EXPECT_EQ(analysis.Corners().size(), 2);
+
+  std::vector<std::string> finished;
+  EXPECT_TRUE(analysis.Run(m_dir / "runs", prepare(),
+                           [&finished](const CornerRun& run) {
+                             finished.push_back(run.corner.name + "_" +
+                                                run.mode.name);
+                           }));
+  EXPECT_EQ(finished.size(), 4);
+  ASSERT_EQ(analysis.Runs().size(), 4);
+  for (const auto& run : analysis.Runs()) {
+    EXPECT_TRUE(run.passed);
+    EXPECT_EQ(run.dir,
+              m_dir / "runs" / (run.corner.name + "_" + run.mode.name));
+    EXPECT_TRUE(fs::exists(run.log));
+    EXPECT_EQ(run.slacks.size(), 3);
+  }
+  // four runs of one second each, run at the same time
+  EXPECT_LT(analysis.Utilization().duration, 3500);
+
+  auto slacks = analysis.WorstSlacks();
+  ASSERT_EQ(slacks.size(), 3);
+  EXPECT_EQ(slacks[0].endpoint, "q_reg/D");
+  EXPECT_EQ(slacks[0].check, "setup");
+  EXPECT_DOUBLE_EQ(slacks[0].slack, -0.40);
+  EXPECT_EQ(slacks[0].corner, "slow");
+  EXPECT_EQ(slacks[0].mode, "func");
+  EXPECT_EQ(slacks[1].endpoint, "out");
+  EXPECT_DOUBLE_EQ(slacks[1].slack, -0.20);
+  EXPECT_EQ(slacks[1].mode, "scan");
+  EXPECT_EQ(slacks[2].endpoint, "q_reg/D");
+  EXPECT_EQ(slacks[2].check, "hold");
+  EXPECT_DOUBLE_EQ(slacks[2].slack, -0.10);
+  EXPECT_EQ(slacks[2].corner, "fast");
+
+  const std::string table = analysis.Table();
+  EXPECT_NE(table.find("Endpoint"), std::string::npos);
+  EXPECT_NE(table.find("-0.400  slow"), std::string::npos);
+
+  const json summary = json::parse(analysis.Summary());
+  EXPECT_EQ(summary["runs"].size(), 4);
+  EXPECT_EQ(summary["endpoints"], 3);
+  EXPECT_DOUBLE_EQ(summary["setup"]["worst_slack"].get<double>(), -0.40);
+  EXPECT_DOUBLE_EQ(summary["setup"]["tns"].get<double>(), -0.60);
+  EXPECT_EQ(summary["setup"]["violations"], 2);
+  EXPECT_EQ(summary["setup"]["corner"], "slow");
+  EXPECT_DOUBLE_EQ(summary["hold"]["worst_slack"].get<double>(), -0.10);
+  EXPECT_EQ(summary["hold"]["mode"], "scan");
+}
+
+TEST_F(TimingCornersTest, FailedRun) {
+  TimingCornerAnalysis analysis;
+  analysis.Jobs(2);
+  analysis.AddCorner({"slow", {}, {}});
+  analysis.AddCorner({"broken", {}, {}});
+  analysis.AddMode({"func", {}});
+  EXPECT_FALSE(analysis.Run(m_dir, prepare()));
+  ASSERT_EQ(analysis.Runs().size(), 2);
+  EXPECT_TRUE(analysis.Runs()[0].passed);
+  EXPECT_FALSE(analysis.Runs()[1].passed);
+  EXPECT_EQ(analysis.Runs()[1].exitCode, 1);
+  // failed run is not merged
+  for (const auto& slack : analysis.WorstSlacks())
+    EXPECT_EQ(slack.corner, "slow");
+
+  const json summary = json::parse(analysis.Summary());
+  EXPECT_FALSE(summary["runs"][1]["passed"].get<bool>());
+  EXPECT_EQ(summary["runs"][1]["exit_code"], 1);
+}
+
+TEST_F(TimingCornersTest, ChangesRejectedWhileRunning) {
+  TimingCornerAnalysis analysis;
+  analysis.AddCorner({"slow", {}, {}});
+  analysis.AddMode({"func", {}});
+  bool rejected{false};
+  auto changing = [this, &analysis, &rejected](CornerRun& run) {
+    rejected = analysis.Running() && !analysis.AddCorner({"fast", {}, {}}) &&
+               !analysis.AddMode({"scan", {}}) && !analysis.Jobs(1) &&
+               !analysis.Clear() && !analysis.Run(m_dir, prepare());
+    return prepare()(run);
+  };
+  // registered contexts are stopped like Compiler::Stop() does
+  int added{0};
+  int removed{0};
+  auto hook = [&added, &removed](ExecutionContext* context, bool add) {
+    if (add) {
+      added++;
+      context->Stop();
+    } else {
+      removed++;
+    }
+  };
+  EXPECT_FALSE(analysis.Run(m_dir, changing, {}, hook));
+  EXPECT_TRUE(rejected);
+  EXPECT_FALSE(analysis.Running());
+  EXPECT_EQ(added, 1);
+  EXPECT_EQ(removed, 1);
+  ASSERT_EQ(analysis.Runs().size(), 1);
+  EXPECT_FALSE(analysis.Runs()[0].passed);
+  EXPECT_EQ(analysis.Corners().size(), 1);
+  EXPECT_EQ(analysis.Modes().size(), 1);
+  EXPECT_TRUE(analysis.Clear());
+}
+
+TEST_F(TimingCornersTest, DefaultCornerAndMode) {
+  TimingCornerAnalysis analysis;
+  EXPECT_TRUE(analysis.Empty());
+  bool called{false};
+  auto failing = [&called](CornerRun&) {
+    called = true;
+    return false;
+  };
+  EXPECT_FALSE(analysis.Run(m_dir, failing));
+  EXPECT_TRUE(called);
+  ASSERT_EQ(analysis.Runs().size(), 1);
+  EXPECT_EQ(analysis.Runs()[0].corner.name, "default");
+  EXPECT_EQ(analysis.Runs()[0].mode.name, "default");
+  EXPECT_FALSE(analysis.Runs()[0].passed);
+  EXPECT_TRUE(analysis.WorstSlacks().empty());
+}
+#endif
@@ -21,6 +21,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Compiler/Constraints.h"
 
+#include <filesystem>
+
+#include "Compiler/ExecutionContext.h"
+#include "Utils/FileUtils.h"
+
 #include "compiler_tcl_infra_common.h"
 
 using namespace FOEDAG;
@@ -126,3 +131,20 @@ TEST_F(ConstraintsTest, compare_result) {
                 CFG_print("%s/property.golden.json", current_dir.c_str())),
             true);
 }
+
+TEST_F(ConstraintsTest, write_in_stage_directory) {
+  const std::filesystem::path stage =
+      std::filesystem::absolute("constraints_stage_test");
+  FileUtils::MkDirs(stage);
+  {
+    // stage runs without changing the process current directory
+    ExecutionContext context{stage};
+    ExecutionContext::Scope scope{context};
+    compiler_tcl_common_run("write_property stage_property.json");
+    compiler_tcl_common_run("write_sdc stage.sdc");
+  }
+  EXPECT_TRUE(FileUtils::FileExists(stage / "stage_property.json"));
+  EXPECT_TRUE(FileUtils::FileExists(stage / "stage.sdc"));
+  EXPECT_FALSE(FileUtils::FileExists("stage_property.json"));
+  FileUtils::removeAll(stage);
+}
@@ -0,0 +1,72 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DesignQuery/sdtgen.h"
+
+#include <QFile>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct GoldenSdt {
+  int nodes;
+  const char *file;
+};
+
+QByteArray readResource(const QString &name) {
+  QFile file{":/DesignQuery/" + name};
+  return file.open(QFile::ReadOnly) ? file.readAll() : QByteArray{};
+}
+
+// golden files are written by sdt_gen_* commands before they were moved to
+// sdt_gen_device_tree(), output must stay byte-identical
+class SdtGenTest : public ::testing::TestWithParam<GoldenSdt> {};
+
+}  // namespace
+
+TEST_P(SdtGenTest, Golden) {
+  const QByteArray json = readResource("sdt_example_soc.json");
+  const QByteArray golden = readResource(QString{"golden/"} + GetParam().file);
+  ASSERT_FALSE(json.isEmpty());
+  ASSERT_FALSE(golden.isEmpty());
+  const nlohmann::json data = nlohmann::json::parse(json.toStdString());
+
+  // verbose nodes are built sequentially, others concurrently
+  for (int verbose : {0, 1}) {
+    string output;
+    testing::internal::CaptureStdout();
+    const int status =
+        sdt_gen_device_tree(data, GetParam().nodes, output, verbose);
+    testing::internal::GetCapturedStdout();
+    EXPECT_EQ(status, 1) << "verbose " << verbose;
+    EXPECT_EQ(output, golden.toStdString()) << "verbose " << verbose;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SdtNodes, SdtGenTest,
+    testing::Values(GoldenSdt{SDT_ROOTMETADATA_NODE, "rootmetadata.sdt"},
+                    GoldenSdt{SDT_CPUS_NODE, "cpus.sdt"},
+                    GoldenSdt{SDT_CPUS_CLUSTER_NODE, "cpus_cluster.sdt"},
+                    GoldenSdt{SDT_MEMORY_NODE, "memory.sdt"},
+                    GoldenSdt{SDT_SOC_NODE, "soc.sdt"},
+                    GoldenSdt{SDT_ALL_NODES, "system_device_tree.sdt"}));
@@ -2,6 +2,8 @@
 #include "DeviceModeling/Model.h"
 #include "gtest/gtest.h"
 
+#include <chrono>
+
 class DeviceModelerTest : public ::testing::Test {
  protected:
   // This function runs before each test
@@ -439,3 +441,202 @@ TEST_F(DeviceModelerTest, get_deleted_device_model) {
   ASSERT_EQ(model, nullptr);
 }
 
+
+// expand_name_range
+TEST_F(DeviceModelerTest, expand_name_range) {
+  auto& modeler = Model::get_modler();
+  std::vector<std::string> names;
+  modeler.expand_name_range("u_io_[0:3]", names);
+  EXPECT_EQ(names, (std::vector<std::string>{"u_io_0", "u_io_1", "u_io_2",
+                                             "u_io_3"}));
+  names.clear();
+  modeler.expand_name_range("b[3:0:2]_[0:1].o", names);
+  EXPECT_EQ(names, (std::vector<std::string>{"b3_0.o", "b3_1.o", "b1_0.o",
+                                             "b1_1.o"}));
+  names.clear();
+  modeler.expand_name_range("a[3]", names);
+  EXPECT_EQ(names, (std::vector<std::string>{"a[3]"}));
+  EXPECT_EQ(modeler.expand_name_list("x y_[1:2]"),
+            (std::vector<std::string>{"x", "y_1", "y_2"}));
+  EXPECT_THROW(modeler.expand_name_range("a[1::2]", names),
+               std::invalid_argument);
+  EXPECT_THROW(modeler.expand_name_range("a[1:2:0]", names),
+               std::invalid_argument);
+}
+
+// bulk commands
+TEST_F(DeviceModelerTest, bulk_commands) {
+  auto& modeler = Model::get_modler();
+  const char* device_argv[] = {"device_name", "BULK_DEVICE"};
+  modeler.device_name(2, device_argv);
+  const char* io_argv[] = {"define_block", "-name", "BULK_IO"};
+  modeler.define_block(3, io_argv);
+  const char* ports_argv[] = {"define_ports", "-block", "BULK_IO", "-in",
+                              "i",            "-out",   "o_[0:1]", "-expand"};
+  modeler.define_ports(8, ports_argv);
+  // names are taken as they are without -expand
+  const char* bus_argv[] = {"define_ports", "-block", "BULK_IO", "-in",
+                            "d[3:0]"};
+  modeler.define_ports(5, bus_argv);
+  auto io_block = modeler.get_current_device()->get_block("BULK_IO");
+  ASSERT_NE(io_block, nullptr);
+  EXPECT_NE(io_block->get_port("d[3:0]"), nullptr);
+  EXPECT_NE(io_block->get_port("o_1"), nullptr);
+  const char* bank_argv[] = {"define_block", "-name", "BULK_BANK"};
+  modeler.define_block(3, bank_argv);
+
+  const char* inst_argv[] = {"create_instances", "-block",
+                             "BULK_IO",          "-name",
+                             "u_io_[0:7]",       "-parent",
+                             "BULK_BANK",        "-logic_address",
+                             "100",              "-address_stride",
+                             "4",                "-logic_location",
+                             "1 2 0",            "-location_stride",
+                             "1 0 0"};
+  EXPECT_TRUE(modeler.create_instances(15, inst_argv));
+  const char* existing_argv[] = {"create_instances", "-block", "BULK_IO",
+                                 "-name", "u_io_[7:9]", "-parent",
+                                 "BULK_BANK"};
+  EXPECT_THROW(modeler.create_instances(7, existing_argv),
+               std::invalid_argument);
+  const char* repeated_argv[] = {"create_instances", "-block", "BULK_IO",
+                                 "-name", "u_x u_x", "-parent", "BULK_BANK"};
+  EXPECT_THROW(modeler.create_instances(7, repeated_argv),
+               std::invalid_argument);
+  auto bank = modeler.get_current_device()->get_block("BULK_BANK");
+  ASSERT_NE(bank, nullptr);
+  ASSERT_EQ(bank->instance_vector().size(), 8);
+  auto io5 = bank->get_instance("u_io_5");
+  ASSERT_NE(io5, nullptr);
+  EXPECT_EQ(io5->get_instance_id(), 5);
+  EXPECT_EQ(io5->get_logic_address(), 120);
+  EXPECT_EQ(io5->get_logic_location_x(), 6);
+  EXPECT_EQ(io5->get_logic_location_y(), 2);
+  EXPECT_EQ(io5->get_logic_location_z(), 0);
+  ASSERT_NE(io5->get_net("o_1"), nullptr);
+
+  const char* net_argv[] = {"define_nets", "-parent", "BULK_BANK",
+                            "-name",       "n_[0:7]", "-drive",
+                            "u_io_[0:7].o_0", "-load", "u_io_[7:0].i"};
+  EXPECT_TRUE(modeler.define_nets(9, net_argv));
+  auto net = bank->get_net("n_2");
+  ASSERT_NE(net, nullptr);
+  EXPECT_EQ(net->get_source(), bank->get_instance("u_io_2")->get_net("o_0"));
+  ASSERT_EQ(net->get_sink_set().size(), 1);
+  EXPECT_EQ(*net->get_sink_set().begin(),
+            bank->get_instance("u_io_5")->get_net("i"));
+  const char* bad_net_argv[] = {"define_nets", "-parent", "BULK_BANK",
+                                "-name", "m_[0:3]", "-drive", "u_io_[0:1].i"};
+  EXPECT_THROW(modeler.define_nets(7, bad_net_argv), std::invalid_argument);
+
+  const char* phy_argv[] = {"set_phy_addresses", "-inst",
+                            "BULK_BANK.u_io_[0:7]", "-address", "64",
+                            "-stride", "2"};
+  EXPECT_TRUE(modeler.set_phy_addresses(7, phy_argv));
+  EXPECT_EQ(bank->get_instance("u_io_0")->get_phy_address(), 64);
+  EXPECT_EQ(io5->get_phy_address(), 74);
+  const char* missing_argv[] = {"set_phy_addresses", "-inst",
+                                "BULK_BANK.u_io_[7:8]", "-address", "0"};
+  EXPECT_THROW(modeler.set_phy_addresses(5, missing_argv), std::runtime_error);
+  EXPECT_EQ(bank->get_instance("u_io_7")->get_phy_address(), 78);
+
+  const char* chain_argv[] = {"define_chain", "-name", "BULK_CHAIN"};
+  modeler.define_chain(3, chain_argv);
+  const char* append_argv[] = {"append_instances_to_chain", "-chain",
+                               "BULK_CHAIN", "-instance",
+                               "BULK_BANK.u_io_[3:0]"};
+  EXPECT_TRUE(modeler.append_instances_to_chain(5, append_argv));
+  EXPECT_EQ(modeler.get_current_device()->get_chain("BULK_CHAIN"),
+            (std::vector<std::string>{
+                "BULK_BANK.u_io_3", "BULK_BANK.u_io_2", "BULK_BANK.u_io_1",
+                "BULK_BANK.u_io_0"}));
+
+  const char* undefine_argv[] = {"undefine_device", "BULK_DEVICE"};
+  modeler.undefine_device(2, undefine_argv);
+}
+
+// device load time of single object and bulk commands
+TEST_F(DeviceModelerTest, DISABLED_Benchmark_bulk_commands) {
+  auto& modeler = Model::get_modler();
+  constexpr int count = 16384;
+  auto build = [&modeler](const std::string& device_name, bool bulk) {
+    const char* device_argv[] = {"device_name", device_name.c_str()};
+    modeler.device_name(2, device_argv);
+    const char* io_argv[] = {"define_block", "-name", "IO"};
+    modeler.define_block(3, io_argv);
+    const char* ports_argv[] = {"define_ports", "-block", "IO",     "-in",
+                                "i_[0:7]",      "-out",   "o_[0:7]", "-expand"};
+    modeler.define_ports(8, ports_argv);
+    const char* bank_argv[] = {"define_block", "-name", "BANK"};
+    modeler.define_block(3, bank_argv);
+    const char* chain_argv[] = {"define_chain", "-name", "IO_CHAIN"};
+    modeler.define_chain(3, chain_argv);
+    const std::string last = std::to_string(count - 1);
+    if (bulk) {
+      const std::string names = "u_io_[0:" + last + "]";
+      const std::string hier_names = "BANK." + names;
+      const char* inst_argv[] = {
+          "create_instances", "-block",  "IO",        "-name",
+          names.c_str(),      "-parent", "BANK",      "-logic_address",
+          "0",                "-address_stride",      "42"};
+      modeler.create_instances(11, inst_argv);
+      const std::string drivers = names + ".o_0";
+      const std::string loads = names + ".i_0";
+      const std::string nets = "n_[0:" + last + "]";
+      const char* net_argv[] = {"define_nets",  "-parent",       "BANK",
+                                "-name",        nets.c_str(),    "-drive",
+                                drivers.c_str(), "-load",        loads.c_str()};
+      modeler.define_nets(9, net_argv);
+      const char* phy_argv[] = {"set_phy_addresses", "-inst",
+                                hier_names.c_str(),  "-address",
+                                "0",                 "-stride",
+                                "42"};
+      modeler.set_phy_addresses(7, phy_argv);
+      const char* append_argv[] = {"append_instances_to_chain", "-chain",
+                                   "IO_CHAIN", "-instance",
+                                   hier_names.c_str()};
+      modeler.append_instances_to_chain(5, append_argv);
+      return;
+    }
+    for (int i = 0; i < count; i++) {
+      const std::string name = "u_io_" + std::to_string(i);
+      const std::string hier_name = "BANK." + name;
+      const std::string address = std::to_string(i * 42);
+      const char* inst_argv[] = {"create_instance", "-block", "IO",
+                                 "-name",           name.c_str(), "-parent",
+                                 "BANK",            "-logic_address",
+                                 address.c_str()};
+      modeler.create_instance(9, inst_argv);
+      const std::string net = "n_" + std::to_string(i);
+      const std::string driver = name + ".o_0";
+      const std::string load = name + ".i_0";
+      const char* net_argv[] = {"define_net", "-parent",       "BANK",
+                                "-name",      net.c_str(),     "-drive",
+                                driver.c_str(), "-load",       load.c_str()};
+      modeler.define_net(9, net_argv);
+      const char* phy_argv[] = {"set_phy_address", "-inst", hier_name.c_str(),
+                                "-address", address.c_str()};
+      modeler.set_phy_address(5, phy_argv);
+      const char* append_argv[] = {"append_instance_to_chain", "-chain",
+                                   "IO_CHAIN", "-instance", hier_name.c_str()};
+      modeler.append_instance_to_chain(5, append_argv);
+    }
+  };
+  // undefined device stays in memory, the second build runs on a busier heap
+  // and is penalized, so the bulk commands go first
+  for (bool bulk : {true, false}) {
+    const std::string name = bulk ? "BENCH_BULK" : "BENCH_SINGLE";
+    auto start = std::chrono::steady_clock::now();
+    build(name, bulk);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    auto bank = modeler.get_current_device()->get_block("BANK");
+    EXPECT_EQ(bank->instance_vector().size(), count);
+    EXPECT_EQ(bank->get_instance("u_io_7")->get_phy_address(), 7 * 42);
+    std::cout << (bulk ? "bulk" : "single") << " commands, " << count
+              << " instances: " << ms << " ms" << std::endl;
+    const char* undefine_argv[] = {"undefine_device", name.c_str()};
+    modeler.undefine_device(2, undefine_argv);
+  }
+}
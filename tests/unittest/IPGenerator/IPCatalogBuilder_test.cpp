@@ -0,0 +1,137 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "IPGenerate/IPCatalogBuilder.h"
+
+#include <sstream>
+
+#include "Compiler/Compiler.h"
+#include "IPGenerate/IPCatalog.h"
+#include "Utils/FileUtils.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+using namespace FOEDAG;
+
+class IPCatalogBuilderTest : public testing::Test {
+ public:
+  void SetUp() override {
+    FileUtils::removeFile(m_dir);
+    FileUtils::MkDirs(m_dir);
+    m_compiler.SetOutStream(&m_out);
+    m_compiler.SetErrStream(&m_out);
+  }
+  void TearDown() override { FileUtils::removeFile(m_dir); }
+
+ protected:
+  // generator of IP <name>_v1_0, it records every probe in 'probes' file,
+  // takes 'delay' seconds to answer and fails if 'code' is not 0
+  fs::path generator(const std::string& name, double delay, int code = 0) {
+    const fs::path file = m_dir / "ips" / name / "v1_0" / (name + "_gen.py");
+    FileUtils::MkDirs(file.parent_path());
+    std::ostringstream script;
+    script << "import sys, time\n"
+           << "with open('" << (m_dir / "probes").string()
+           << "', 'a') as f: f.write('" << name << "\\n')\n"
+           << "time.sleep(" << delay << ")\n"
+           << "if " << code << ": sys.exit(" << code << ")\n"
+           << "print('{\"build_name\": \"" << name
+           << "\", \"parameters\": []}')\n";
+    FileUtils::WriteToFile(file, script.str());
+    return file;
+  }
+
+  std::vector<std::string> build(IPCatalog& catalog) {
+    IPCatalogBuilder builder{&m_compiler};
+    builder.Jobs(4);
+    builder.IndexFile(m_dir / "index.json");
+    EXPECT_TRUE(builder.buildLiteXCatalog(&catalog, m_dir / "ips"));
+    std::vector<std::string> names;
+    for (auto def : catalog.Definitions()) names.push_back(def->Name());
+    return names;
+  }
+
+  std::vector<std::string> probes() {
+    std::vector<std::string> names;
+    std::istringstream stream{FileUtils::GetFileContent(m_dir / "probes")};
+    for (std::string line; std::getline(stream, line);) names.push_back(line);
+    FileUtils::removeFile(m_dir / "probes");
+    return names;
+  }
+
+  Compiler m_compiler;
+  std::ostringstream m_out;
+  fs::path m_dir{fs::absolute("ip_catalog_builder_test")};
+};
+
+#ifndef _WIN32
+TEST_F(IPCatalogBuilderTest, ProbeAndIndex) {
+  if (FileUtils::LocateExecFile("python3").empty()) GTEST_SKIP();
+  // first generators answer last, catalog order must not depend on it
+  generator("alpha", 0.6);
+  generator("beta", 0.3);
+  const fs::path gamma = generator("gamma", 0);
+
+  std::vector<std::string> enumerated;
+  for (const auto& entry : fs::recursive_directory_iterator(m_dir / "ips")) {
+    const std::string stem = entry.path().stem().string();
+    if (entry.path().extension() == ".py")
+      enumerated.push_back(stem.substr(0, stem.size() - 4) + "_v1_0");
+  }
+
+  IPCatalog probed;
+  const auto names = build(probed);
+  EXPECT_EQ(names, enumerated);
+  EXPECT_EQ(probes().size(), 3u);
+
+  // unchanged generators come from the index in the same order
+  IPCatalog indexed;
+  EXPECT_EQ(build(indexed), names);
+  EXPECT_TRUE(probes().empty());
+
+  // only modified generator is probed again
+  FileUtils::WriteToFile(gamma,
+                         FileUtils::GetFileContent(gamma) + "# modified\n");
+  IPCatalog modified;
+  EXPECT_EQ(build(modified), names);
+  EXPECT_EQ(probes(), std::vector<std::string>{"gamma"});
+}
+
+TEST_F(IPCatalogBuilderTest, FailedProbe) {
+  if (FileUtils::LocateExecFile("python3").empty()) GTEST_SKIP();
+  generator("alpha", 0);
+  generator("broken", 0, 2);
+
+  IPCatalog catalog;
+  IPCatalogBuilder builder{&m_compiler};
+  builder.IndexFile(m_dir / "index.json");
+  EXPECT_FALSE(builder.buildLiteXCatalog(&catalog, m_dir / "ips"));
+  EXPECT_NE(catalog.Definition("alpha_v1_0"), nullptr);
+  EXPECT_EQ(catalog.Definition("broken_v1_0"), nullptr);
+  EXPECT_NE(m_out.str().find("no IP information for"), std::string::npos);
+  EXPECT_EQ(probes().size(), 2u);
+
+  // failed generator is not indexed and is probed again
+  IPCatalog again;
+  EXPECT_FALSE(builder.buildLiteXCatalog(&again, m_dir / "ips"));
+  EXPECT_EQ(probes(), std::vector<std::string>{"broken"});
+}
+#endif
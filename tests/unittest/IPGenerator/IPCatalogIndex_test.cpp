@@ -0,0 +1,126 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "IPGenerate/IPCatalogIndex.h"
+
+#include "Utils/FileUtils.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+using namespace FOEDAG;
+
+class IPCatalogIndexTest : public testing::Test {
+ public:
+  void SetUp() override {
+    FileUtils::removeFile(m_dir);
+    FileUtils::MkDirs(m_dir / "gen");
+    FileUtils::WriteToFile(m_generator, "print('{}')");
+  }
+  void TearDown() override { FileUtils::removeFile(m_dir); }
+
+ protected:
+  fs::path m_dir{fs::absolute("ip_catalog_index_test")};
+  fs::path m_file{m_dir / "index" / "ip_catalog_index.json"};
+  fs::path m_generator{m_dir / "gen" / "fifo_gen.py"};
+  const std::string m_interpreter{"python 3.10"};
+};
+
+TEST_F(IPCatalogIndexTest, LookupAfterUpdate) {
+  IPCatalogIndex index{m_file};
+  const std::string hash = FileUtils::FileHash(m_generator);
+  EXPECT_EQ(index.Lookup(m_generator, hash, m_interpreter), nullptr);
+  index.Update(m_generator, {hash, m_interpreter, "{\"name\":\"fifo\"}"});
+  auto json = index.Lookup(m_generator, hash, m_interpreter);
+  ASSERT_NE(json, nullptr);
+  EXPECT_EQ(*json, "{\"name\":\"fifo\"}");
+  EXPECT_EQ(index.Lookup(m_generator, hash, "python 3.11"), nullptr);
+  EXPECT_EQ(index.Lookup(m_generator, {}, m_interpreter), nullptr);
+}
+
+TEST_F(IPCatalogIndexTest, SaveAndLoad) {
+  const std::string hash = FileUtils::FileHash(m_generator);
+  IPCatalogIndex index{m_file};
+  index.Update(m_generator, {hash, m_interpreter, "{}"});
+  EXPECT_TRUE(index.Save());
+  EXPECT_TRUE(FileUtils::FileExists(m_file));
+
+  IPCatalogIndex loaded{m_file};
+  EXPECT_TRUE(loaded.Load());
+  EXPECT_EQ(loaded.Size(), 1u);
+  EXPECT_NE(loaded.Lookup(m_generator, hash, m_interpreter), nullptr);
+}
+
+TEST_F(IPCatalogIndexTest, ChangedGenerator) {
+  const std::string hash = FileUtils::FileHash(m_generator);
+  IPCatalogIndex index{m_file};
+  index.Update(m_generator, {hash, m_interpreter, "{}"});
+  FileUtils::WriteToFile(m_generator, "print('{\"a\":1}')");
+  EXPECT_EQ(index.Lookup(m_generator, FileUtils::FileHash(m_generator),
+                         m_interpreter),
+            nullptr);
+}
+
+TEST_F(IPCatalogIndexTest, CorruptedFile) {
+  FileUtils::MkDirs(m_file.parent_path());
+  FileUtils::WriteToFile(m_file, "{\"version\":1,\"entries\":");
+  IPCatalogIndex index{m_file};
+  EXPECT_FALSE(index.Load());
+  EXPECT_EQ(index.Size(), 0u);
+}
+
+TEST_F(IPCatalogIndexTest, Prune) {
+  IPCatalogIndex index{m_file};
+  const fs::path removed{m_dir / "gen" / "removed_gen.py"};
+  const fs::path outside{m_dir / "other" / "removed_gen.py"};
+  index.Update(m_generator, {"1", m_interpreter, "{}"});
+  index.Update(removed, {"2", m_interpreter, "{}"});
+  index.Update(outside, {"3", m_interpreter, "{}"});
+  EXPECT_EQ(index.Prune(m_dir / "gen"), 1u);
+  EXPECT_EQ(index.Size(), 2u);
+  EXPECT_NE(index.Lookup(outside, "3", m_interpreter), nullptr);
+}
+
+TEST_F(IPCatalogIndexTest, SessionsMergeChanges) {
+  const fs::path other{m_dir / "gen" / "other_gen.py"};
+  const fs::path removed{m_dir / "gen" / "removed_gen.py"};
+  IPCatalogIndex initial{m_file};
+  initial.Update(removed, {"3", m_interpreter, "{}"});
+  EXPECT_TRUE(initial.Save());
+
+  // both sessions load the same index and save their own changes
+  IPCatalogIndex first{m_file};
+  IPCatalogIndex second{m_file};
+  first.Load();
+  second.Load();
+  first.Update(m_generator, {"1", m_interpreter, "{}"});
+  second.Update(other, {"2", m_interpreter, "{}"});
+  EXPECT_EQ(second.Prune(m_dir / "gen"), 1u);
+  EXPECT_TRUE(first.Save());
+  EXPECT_TRUE(second.Save());
+
+  IPCatalogIndex loaded{m_file};
+  EXPECT_TRUE(loaded.Load());
+  EXPECT_EQ(loaded.Size(), 2u);
+  EXPECT_NE(loaded.Lookup(m_generator, "1", m_interpreter), nullptr);
+  EXPECT_NE(loaded.Lookup(other, "2", m_interpreter), nullptr);
+  EXPECT_EQ(loaded.Lookup(removed, "3", m_interpreter), nullptr);
+  EXPECT_FALSE(FileUtils::FileExists(m_file.string() + ".lock"));
+}
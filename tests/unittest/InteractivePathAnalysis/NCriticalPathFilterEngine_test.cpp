@@ -0,0 +1,160 @@
+/**
+  * @file NCriticalPathFilterEngine_test.cpp
+  * @copyright Copyright 2021 The Foedag team
+
+  * GPL License
+
+  * Copyright (c) 2021 The Open-Source FPGA Foundation
+
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "InteractivePathAnalysis/NCriticalPathFilterEngine.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+namespace {
+
+QString startPoint(int i) { return QString("Startpoint: count[%1].Q[0] (dffsre clocked by clk)").arg(i); }
+QString endPoint(int i) { return QString("Endpoint  : out:count[%1].outpad[0] (.output clocked by clk)").arg(i); }
+
+} // namespace
+
+TEST(FilterBitset, SetTestAnd)
+{
+    FilterBitset bits{130};
+    bits.set(0);
+    bits.set(64);
+    bits.set(129);
+    EXPECT_TRUE(bits.test(0));
+    EXPECT_FALSE(bits.test(1));
+    EXPECT_TRUE(bits.test(129));
+    EXPECT_FALSE(bits.test(130));
+    EXPECT_EQ(3, bits.count());
+
+    FilterBitset other{130};
+    other.set(64);
+    bits &= other;
+    EXPECT_EQ(1, bits.count());
+    EXPECT_TRUE(bits.test(64));
+}
+
+TEST(CompiledFilterCriteria, Matches)
+{
+    EXPECT_FALSE(CompiledFilterCriteria{}.isSet());
+    EXPECT_TRUE(CompiledFilterCriteria{}.matches("anything"));
+
+    CompiledFilterCriteria insensitive{FilterCriteriaConf{"CoUnT[1]", false, false}};
+    EXPECT_TRUE(insensitive.matches(startPoint(1)));
+    EXPECT_FALSE(insensitive.matches(startPoint(2)));
+
+    CompiledFilterCriteria sensitive{FilterCriteriaConf{"CoUnT[1]", true, false}};
+    EXPECT_FALSE(sensitive.matches(startPoint(1)));
+
+    CompiledFilterCriteria regExp{FilterCriteriaConf{"COUNT\\[\\d{2}\\]", false, true}};
+    EXPECT_TRUE(regExp.matches(startPoint(12)));
+    EXPECT_FALSE(regExp.matches(startPoint(1)));
+
+    CompiledFilterCriteria regExpSensitive{FilterCriteriaConf{"COUNT\\[\\d{2}\\]", true, true}};
+    EXPECT_FALSE(regExpSensitive.matches(startPoint(12)));
+}
+
+TEST(NCriticalPathFilterIndex, Evaluate)
+{
+    // rows 0 and 5 are not paths
+    NCriticalPathFilterIndex index;
+    for (int row = 1; row < 5; ++row) {
+        index.addPath(row, startPoint(row % 2), endPoint(row));
+    }
+    index.addPath(6, startPoint(1), endPoint(1));
+    EXPECT_EQ(7, index.rowCount());
+    EXPECT_EQ(5, index.pathCount());
+    EXPECT_EQ(2, index.startPointCount());
+    EXPECT_EQ(4, index.endPointCount());
+
+    FilterBitset all = index.evaluate(CompiledFilterCriteria{}, CompiledFilterCriteria{});
+    EXPECT_EQ(5, all.count());
+    EXPECT_FALSE(all.test(0));
+    EXPECT_FALSE(all.test(5));
+
+    CompiledFilterCriteria input{FilterCriteriaConf{"count[1]", true, false}};
+    FilterBitset bits = index.evaluate(input, CompiledFilterCriteria{});
+    EXPECT_EQ(3, bits.count());
+    EXPECT_TRUE(bits.test(1));
+    EXPECT_TRUE(bits.test(3));
+    EXPECT_TRUE(bits.test(6));
+
+    CompiledFilterCriteria output{FilterCriteriaConf{"count\\[[13]\\]", true, true}};
+    bits = index.evaluate(input, output);
+    EXPECT_EQ(3, bits.count());
+    output = CompiledFilterCriteria{FilterCriteriaConf{"count[3]", true, false}};
+    bits = index.evaluate(input, output);
+    EXPECT_EQ(1, bits.count());
+    EXPECT_TRUE(bits.test(3));
+}
+
+TEST(NCriticalPathFilterIndex, EvaluateCancelled)
+{
+    NCriticalPathFilterIndex index;
+    for (int i = 0; i < 1000; ++i) {
+        index.addPath(i, startPoint(i), endPoint(i));
+    }
+    const CompiledFilterCriteria input{FilterCriteriaConf{"count", false, false}};
+
+    int checks = 0;
+    FilterBitset bits = index.evaluate(input, CompiledFilterCriteria{}, [&checks]() { return ++checks > 1; });
+    EXPECT_EQ(2, checks);
+    EXPECT_LT(bits.count(), 1000u);
+
+    bits = index.evaluate(input, CompiledFilterCriteria{}, []() { return false; });
+    EXPECT_EQ(1000u, bits.count());
+}
+
+TEST(NCriticalPathFilterIndex, DISABLED_Benchmark)
+{
+    // report with 10k paths from 500 start points to 2000 end points
+    const int pathNum = 10000;
+    NCriticalPathFilterIndex index;
+    std::vector<std::pair<QString, QString>> lines;
+    for (int i = 0; i < pathNum; ++i) {
+        lines.emplace_back(startPoint(i % 500), endPoint(i % 2000));
+        index.addPath(i, lines.back().first, lines.back().second);
+    }
+    const FilterCriteriaConf inputConf{"count\\[1\\d\\]", false, true};
+    const FilterCriteriaConf outputConf{"OUTPAD", false, false};
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    std::size_t naive = 0;
+    for (const auto& [input, output]: lines) {
+        // what filterAcceptsRow did for every row before
+        QRegularExpression pattern(inputConf.criteria());
+        if (pattern.match(input).hasMatch() && output.contains(outputConf.criteria(), outputConf.caseSensetive())) {
+            naive++;
+        }
+    }
+    auto naiveUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    start = Clock::now();
+    FilterBitset bits = index.evaluate(CompiledFilterCriteria{inputConf}, CompiledFilterCriteria{outputConf});
+    auto indexUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    EXPECT_EQ(naive, bits.count());
+    std::cout << "per row " << naiveUs << " us, indexed " << indexUs << " us" << std::endl;
+}
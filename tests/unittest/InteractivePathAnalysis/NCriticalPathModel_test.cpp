@@ -331,7 +331,9 @@ TEST(NCriticalPathFilterModel, InputFilterCriteriaExactMatchCaseInsensitive)
         FilterCriteriaConf inputConf{"CoUnT[1]", false, false};
         FilterCriteriaConf outputConf;
 
+        QSignalSpy filterAppliedSpy(&filter, &NCriticalPathFilterModel::filterApplied);
         filter.setFilterCriteria(inputConf, outputConf);
+        EXPECT_TRUE(waitSignal(filterAppliedSpy));
 
         int pathsCounter = 0;
         int otherCounter = 0;
@@ -401,7 +403,9 @@ TEST(NCriticalPathFilterModel, InputFilterCriteriaExactMatchCaseSensitive)
         FilterCriteriaConf inputConf{"CoUnT[1]", true, false};
         FilterCriteriaConf outputConf;
 
+        QSignalSpy filterAppliedSpy(&filter, &NCriticalPathFilterModel::filterApplied);
         filter.setFilterCriteria(inputConf, outputConf);
+        EXPECT_TRUE(waitSignal(filterAppliedSpy));
 
         auto [pathItems, otherItems] = collectVisibleItems(filter);
 
@@ -415,7 +419,9 @@ TEST(NCriticalPathFilterModel, InputFilterCriteriaExactMatchCaseSensitive)
         FilterCriteriaConf inputConf{"count[1]", true, false};
         FilterCriteriaConf outputConf;
 
+        QSignalSpy filterAppliedSpy(&filter, &NCriticalPathFilterModel::filterApplied);
         filter.setFilterCriteria(inputConf, outputConf);
+        EXPECT_TRUE(waitSignal(filterAppliedSpy));
 
         int pathsCounter = 0;
         int otherCounter = 0;
@@ -489,7 +495,9 @@ TEST(NCriticalPathFilterModel, OutputFilterCriteriaRegexp)
     FilterCriteriaConf inputConf;
     FilterCriteriaConf outputConf{"count\\[\\d{2}\\]", false, true};
 
+    QSignalSpy filterAppliedSpy(&filter, &NCriticalPathFilterModel::filterApplied);
     filter.setFilterCriteria(inputConf, outputConf);
+    EXPECT_TRUE(waitSignal(filterAppliedSpy));
 
     int pathsCounter = 0;
     int otherCounter = 0;
@@ -527,3 +535,73 @@ TEST(NCriticalPathFilterModel, OutputFilterCriteriaRegexp)
     EXPECT_EQ(0, source.rowCount());
     EXPECT_EQ(0, filter.rowCount());
 }
+
+TEST(NCriticalPathFilterModel, InputAndOutputFilterCriteria)
+{
+    NCriticalPathModel source;
+    NCriticalPathFilterModel filter;
+    filter.setSourceModel(&source);
+
+    // criteria are set before the data is loaded
+    FilterCriteriaConf inputConf{"count\\[1\\]", false, true};
+    FilterCriteriaConf outputConf{"COUNT[1", false, false};
+    filter.setFilterCriteria(inputConf, outputConf);
+
+    QSignalSpy filterAppliedSpy(&filter, &NCriticalPathFilterModel::filterApplied);
+    QSignalSpy loadFinishedSpy(&source, &NCriticalPathModel::loadFinished);
+    source.loadFromString(getRawModelDataString());
+    EXPECT_TRUE(waitSignal(loadFinishedSpy));
+    EXPECT_TRUE(waitSignal(filterAppliedSpy));
+
+    auto [pathItems, otherItems] = collectVisibleItems(filter);
+    EXPECT_FALSE(pathItems.isEmpty());
+    for (NCriticalPathItem* item: pathItems) {
+        EXPECT_TRUE(item->startPointLine().contains("count[1]"));
+        EXPECT_TRUE(item->endPointLine().contains("count[1"));
+    }
+    EXPECT_EQ(getOtherExpected().size(), otherItems.size());
+
+    // the same number of paths as with the naive evaluation
+    int expectedPathNum = 0;
+    for (int i=0; i<source.rowCount(); ++i) {
+        NCriticalPathItem* item = static_cast<NCriticalPathItem*>(source.index(i, 0).internalPointer());
+        if (item && item->isPath() && item->startPointLine().contains("count[1]") &&
+            item->endPointLine().contains("count[1", Qt::CaseInsensitive)) {
+            expectedPathNum++;
+        }
+    }
+    EXPECT_EQ(expectedPathNum, pathItems.size());
+
+    // CLEAR DATA
+    QSignalSpy clearedSpy(&source, &NCriticalPathModel::cleared);
+    source.clear();
+    EXPECT_TRUE(waitSignal(clearedSpy));
+    EXPECT_EQ(0, filter.rowCount());
+}
+
+TEST(NCriticalPathFilterModel, RapidCriteriaChangesApplyLatest)
+{
+    NCriticalPathModel source;
+    NCriticalPathFilterModel filter;
+    filter.setSourceModel(&source);
+
+    QSignalSpy loadFinishedSpy(&source, &NCriticalPathModel::loadFinished);
+    source.loadFromString(getRawModelDataString());
+    EXPECT_TRUE(waitSignal(loadFinishedSpy));
+
+    // every change supersedes the previous one, the same worker serves all of them
+    QSignalSpy filterAppliedSpy(&filter, &NCriticalPathFilterModel::filterApplied);
+    for (int i=0; i<10; ++i) {
+        filter.setFilterCriteria(FilterCriteriaConf{QString("count[%1]").arg(i), false, false}, FilterCriteriaConf{});
+    }
+    filter.setFilterCriteria(FilterCriteriaConf{"count\\[1\\]", false, true}, FilterCriteriaConf{});
+    EXPECT_TRUE(waitSignal(filterAppliedSpy));
+    EXPECT_EQ(1, filter.findChildren<NCriticalPathFilterWorker*>().size());
+
+    auto [pathItems, otherItems] = collectVisibleItems(filter);
+    EXPECT_EQ(2, pathItems.size());
+    for (NCriticalPathItem* item: pathItems) {
+        EXPECT_TRUE(item->startPointLine().contains("count[1]"));
+    }
+    EXPECT_EQ(getOtherExpected().size(), otherItems.size());
+}
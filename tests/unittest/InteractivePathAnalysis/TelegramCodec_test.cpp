@@ -0,0 +1,224 @@
+/**
+  * @file TelegramCodec_test.cpp
+  * @copyright Copyright 2021 The Foedag team
+
+  * GPL License
+
+  * Copyright (c) 2021 The Open-Source FPGA Foundation
+
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "InteractivePathAnalysis/client/TelegramCodec.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "InteractivePathAnalysis/client/CommConstants.h"
+#include "InteractivePathAnalysis/client/ZlibUtils.h"
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+namespace {
+
+// path list in the VPR report_timing format
+std::string syntheticReport(int pathNum)
+{
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<int> dist{0, 999};
+    std::string report{"#Timing report of worst " + std::to_string(pathNum) + " path(s)\n"};
+    for (int i = 1; i <= pathNum; ++i) {
+        report += "#Path " + std::to_string(i) + "\n";
+        report += "Startpoint: count[" + std::to_string(dist(gen) % 32) + "].Q[0] (dffsre clocked by clk)\n";
+        report += "Endpoint  : count[" + std::to_string(dist(gen) % 32) + "].D[0] (dffsre clocked by clk)\n";
+        report += "Path Type : setup\n\n";
+        for (int j = 0; j < 12; ++j) {
+            report += "$auto$alumacc.cc:485$" + std::to_string(dist(gen)) + ".lut_out[0] (.names at (" +
+                      std::to_string(dist(gen) % 64) + "," + std::to_string(dist(gen) % 64) + "))    0." +
+                      std::to_string(dist(gen)) + "     1." + std::to_string(dist(gen)) + "\n";
+        }
+        report += "slack (MET)    " + std::to_string(dist(gen)) + ".000\n\n";
+    }
+    return report;
+}
+
+std::vector<uint8_t> allCodecIds()
+{
+    return {comm::NONE_COMPRESSOR_ID, comm::ZLIB_COMPRESSOR_ID, comm::LZ4_COMPRESSOR_ID};
+}
+
+} // namespace
+
+TEST(TelegramCodec, create)
+{
+    for (uint8_t id: allCodecIds()) {
+        auto codec = comm::TelegramCodec::create(id);
+        ASSERT_TRUE(codec);
+        EXPECT_EQ(id, codec->id());
+    }
+    EXPECT_FALSE(comm::TelegramCodec::create('?'));
+
+    comm::TelegramCodecPool pool;
+    comm::TelegramCodec* codec = pool.codec(comm::ZLIB_COMPRESSOR_ID);
+    EXPECT_EQ(codec, pool.codec(comm::ZLIB_COMPRESSOR_ID));
+    EXPECT_EQ(nullptr, pool.codec('?'));
+}
+
+TEST(TelegramCodec, roundTrip)
+{
+    const std::vector<std::string> payloads{
+        "", "a", "short message", std::string(100000, 'x'), syntheticReport(500)};
+    for (uint8_t id: allCodecIds()) {
+        auto codec = comm::TelegramCodec::create(id);
+        for (const std::string& payload: payloads) {
+            std::string compressed;
+            ASSERT_TRUE(codec->compress(payload, compressed)) << codec->name();
+            std::string decompressed;
+            ASSERT_TRUE(codec->decompress(compressed, decompressed)) << codec->name();
+            EXPECT_EQ(payload, decompressed) << codec->name();
+            if (id != comm::NONE_COMPRESSOR_ID && payload.size() > 1000) {
+                EXPECT_LT(compressed.size(), payload.size() / 4) << codec->name();
+            }
+        }
+    }
+}
+
+TEST(TelegramCodec, incompressible)
+{
+    std::mt19937 gen{2};
+    std::string payload(200000, '\0');
+    for (char& c: payload) {
+        c = static_cast<char>(gen());
+    }
+    for (uint8_t id: allCodecIds()) {
+        auto codec = comm::TelegramCodec::create(id);
+        std::string compressed, decompressed;
+        ASSERT_TRUE(codec->compress(payload, compressed));
+        ASSERT_TRUE(codec->decompress(compressed, decompressed));
+        EXPECT_EQ(payload, decompressed) << codec->name();
+    }
+}
+
+TEST(TelegramCodec, chunkedStream)
+{
+    const std::string payload = syntheticReport(300);
+    std::mt19937 gen{3};
+    std::uniform_int_distribution<std::size_t> chunkDist{1, 70000};
+    auto feed = [&gen, &chunkDist](comm::TelegramCodec& codec, comm::TelegramCodec::Mode mode,
+                                   const std::string& input, std::string& output) {
+        if (!codec.begin(mode)) {
+            return false;
+        }
+        for (std::size_t pos = 0; pos < input.size();) {
+            const std::size_t size = std::min(chunkDist(gen), input.size() - pos);
+            if (!codec.update(input.data() + pos, size, output)) {
+                return false;
+            }
+            pos += size;
+        }
+        return codec.end(output);
+    };
+    for (uint8_t id: {comm::ZLIB_COMPRESSOR_ID, comm::LZ4_COMPRESSOR_ID}) {
+        auto codec = comm::TelegramCodec::create(id);
+        // the same codec object serves several streams
+        for (int i = 0; i < 3; ++i) {
+            std::string compressed, decompressed;
+            ASSERT_TRUE(feed(*codec, comm::TelegramCodec::Mode::COMPRESS, payload, compressed));
+            ASSERT_TRUE(feed(*codec, comm::TelegramCodec::Mode::DECOMPRESS, compressed, decompressed));
+            EXPECT_EQ(payload, decompressed) << codec->name();
+
+            std::string oneShot;
+            ASSERT_TRUE(codec->decompress(compressed, oneShot));
+            EXPECT_EQ(payload, oneShot) << codec->name();
+        }
+    }
+}
+
+TEST(TelegramCodec, brokenStream)
+{
+    const std::string payload = syntheticReport(50);
+    for (uint8_t id: {comm::ZLIB_COMPRESSOR_ID, comm::LZ4_COMPRESSOR_ID}) {
+        auto codec = comm::TelegramCodec::create(id);
+        std::string compressed;
+        ASSERT_TRUE(codec->compress(payload, compressed));
+
+        std::string decompressed;
+        EXPECT_FALSE(codec->decompress(compressed.substr(0, compressed.size() / 2), decompressed))
+            << codec->name();
+
+        std::string corrupted = compressed;
+        for (std::size_t i = 8; i < corrupted.size(); i += 7) {
+            corrupted[i] = static_cast<char>(~corrupted[i]);
+        }
+        decompressed.clear();
+        EXPECT_FALSE(codec->decompress(corrupted, decompressed)) << codec->name();
+
+        decompressed.clear();
+        EXPECT_TRUE(codec->decompress(compressed, decompressed)) << codec->name();
+        EXPECT_EQ(payload, decompressed);
+    }
+}
+
+TEST(TelegramCodec, zlibLevels)
+{
+    const std::string payload = syntheticReport(200);
+    std::size_t fastSize = 0;
+    std::size_t bestSize = 0;
+    for (int level: {1, 9}) {
+        comm::ZlibCodec codec{level};
+        std::string compressed, decompressed;
+        ASSERT_TRUE(codec.compress(payload, compressed));
+        ASSERT_TRUE(codec.decompress(compressed, decompressed));
+        EXPECT_EQ(payload, decompressed);
+        (level == 1 ? fastSize : bestSize) = compressed.size();
+    }
+    EXPECT_LT(bestSize, fastSize);
+
+    // compatible with one-shot helpers
+    comm::ZlibCodec codec;
+    std::string compressed;
+    ASSERT_TRUE(codec.compress(payload, compressed));
+    EXPECT_EQ(payload, tryDecompress(compressed).value());
+    std::string decompressed;
+    ASSERT_TRUE(codec.decompress(tryCompress(payload).value(), decompressed));
+    EXPECT_EQ(payload, decompressed);
+}
+
+TEST(TelegramCodec, DISABLED_Benchmark)
+{
+    const std::string payload = syntheticReport(comm::CRITICAL_PATH_NUM_THRESHOLD);
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    };
+    std::cout << "payload " << payload.size() / 1024 << " KiB" << std::endl;
+    for (uint8_t id: {comm::ZLIB_COMPRESSOR_ID, comm::LZ4_COMPRESSOR_ID}) {
+        auto codec = comm::TelegramCodec::create(id);
+        std::string compressed, decompressed;
+        auto start = Clock::now();
+        ASSERT_TRUE(codec->compress(payload, compressed));
+        const auto compressMs = ms(start);
+        start = Clock::now();
+        for (int i = 0; i < 10; ++i) {
+            decompressed.clear();
+            ASSERT_TRUE(codec->decompress(compressed, decompressed));
+        }
+        const auto decompressMs = ms(start) / 10;
+        EXPECT_EQ(payload, decompressed);
+        std::cout << codec->name() << ": " << compressed.size() / 1024 << " KiB, compress "
+                  << compressMs << " ms, decompress " << decompressMs << " ms" << std::endl;
+    }
+}
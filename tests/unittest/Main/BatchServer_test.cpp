@@ -0,0 +1,213 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Main/BatchServer.h"
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+TEST(BatchProtocolTest, EncodeDecode) {
+  BatchRequest request{"/tmp/work", "/tmp/work/test.tcl", "puts hello",
+                       {"A=1", "B=two=2"}};
+  BatchRequest decoded;
+  EXPECT_TRUE(BatchProtocol::Decode(BatchProtocol::Encode(request), decoded));
+  EXPECT_EQ(decoded.workingDir, request.workingDir);
+  EXPECT_EQ(decoded.script, request.script);
+  EXPECT_EQ(decoded.command, request.command);
+  EXPECT_EQ(decoded.environment, request.environment);
+
+  auto data = BatchProtocol::Encode(request);
+  EXPECT_FALSE(BatchProtocol::Decode(data.substr(0, data.size() - 1), decoded));
+  EXPECT_FALSE(BatchProtocol::Decode(data + "x", decoded));
+  EXPECT_FALSE(BatchProtocol::Decode("FDGX" + data.substr(4), decoded));
+}
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class BatchServerTest : public testing::Test {
+ public:
+  void SetUp() override {
+    fs::remove_all(m_dir);
+    fs::create_directories(m_dir);
+    // job writes to its standard output, which is the client one
+    m_server.reset(new BatchServer{
+        m_socket.string(), [](const BatchRequest& request) {
+          std::cout << "cwd=" << fs::current_path().string() << std::endl;
+          const char* value = std::getenv("BATCH_SERVER_TEST");
+          std::cout << "env=" << (value ? value : "") << std::endl;
+          std::cout << "cmd=" << request.command << std::endl;
+          if (request.command == "sleep")
+            std::this_thread::sleep_for(std::chrono::seconds{30});
+          return request.command == "fail" ? 3 : 0;
+        }});
+    std::string error;
+    ASSERT_TRUE(m_server->Listen(&error)) << error;
+    m_thread = std::thread{[this]() { m_server->Run(); }};
+  }
+  void TearDown() override {
+    m_server->Stop();
+    if (m_thread.joinable()) m_thread.join();
+    m_server.reset();
+    EXPECT_FALSE(fs::exists(m_socket));
+    fs::remove_all(m_dir);
+  }
+
+  // run job with standard output redirected into file
+  int run(const BatchRequest& request, const fs::path& output) {
+    std::cout.flush();
+    int saved = ::dup(STDOUT_FILENO);
+    FILE* file = std::fopen(output.c_str(), "w");
+    ::dup2(::fileno(file), STDOUT_FILENO);
+    std::string error;
+    int status = BatchProtocol::RunClient(m_socket.string(), request, &error);
+    ::dup2(saved, STDOUT_FILENO);
+    ::close(saved);
+    std::fclose(file);
+    EXPECT_TRUE(error.empty()) << error;
+    return status;
+  }
+
+  static std::string content(const fs::path& file) {
+    std::ifstream stream{file};
+    return {std::istreambuf_iterator<char>{stream},
+            std::istreambuf_iterator<char>{}};
+  }
+
+ protected:
+  fs::path m_dir{fs::absolute("batch_server_test")};
+  fs::path m_socket{m_dir / "server.sock"};
+  std::unique_ptr<BatchServer> m_server;
+  std::thread m_thread;
+};
+
+TEST_F(BatchServerTest, RunJob) {
+  const fs::path cwd = fs::current_path();
+  fs::create_directories(m_dir / "job");
+  BatchRequest request{
+      (m_dir / "job").string(), {}, "hello", {"BATCH_SERVER_TEST=value"}};
+  EXPECT_EQ(run(request, m_dir / "out.txt"), 0);
+  const std::string output = content(m_dir / "out.txt");
+  EXPECT_NE(output.find("cwd=" + (m_dir / "job").string()), std::string::npos);
+  EXPECT_NE(output.find("env=value\n"), std::string::npos);
+  EXPECT_NE(output.find("cmd=hello"), std::string::npos);
+  // server process state is untouched
+  EXPECT_EQ(fs::current_path(), cwd);
+  EXPECT_EQ(std::getenv("BATCH_SERVER_TEST"), nullptr);
+}
+
+TEST_F(BatchServerTest, ExitStatus) {
+  BatchRequest request{m_dir.string(), {}, "fail", {}};
+  EXPECT_EQ(run(request, m_dir / "out.txt"), 3);
+  request.workingDir = (m_dir / "missing").string();
+  request.command = "hello";
+  EXPECT_EQ(run(request, m_dir / "out.txt"), 1);
+}
+
+TEST_F(BatchServerTest, ConcurrentJobs) {
+  constexpr int Count{8};
+  int statuses[Count]{};
+  std::vector<std::thread> clients;
+  for (int i = 0; i < Count; i++) {
+    clients.emplace_back([this, i, &statuses]() {
+      BatchRequest request{m_dir.string(), {}, i % 2 ? "fail" : "hello", {}};
+      statuses[i] = BatchProtocol::RunClient(m_socket.string(), request);
+    });
+  }
+  for (auto& client : clients) client.join();
+  for (int i = 0; i < Count; i++) EXPECT_EQ(statuses[i], i % 2 ? 3 : 0);
+}
+
+TEST_F(BatchServerTest, MaxJobs) {
+  EXPECT_EQ(m_server->MaxJobs(), BatchServer::DefaultMaxJobs());
+  EXPECT_GT(BatchServer::DefaultMaxJobs(), 0u);
+  const fs::path socket = m_dir / "limited.sock";
+  BatchServer server{socket.string(), [](const BatchRequest&) {
+                       std::this_thread::sleep_for(
+                           std::chrono::milliseconds{300});
+                       return 0;
+                     }};
+  server.MaxJobs(1);
+  std::string error;
+  ASSERT_TRUE(server.Listen(&error)) << error;
+  std::thread thread{[&server]() { server.Run(); }};
+  constexpr int Count{3};
+  int statuses[Count]{};
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> clients;
+  for (int i = 0; i < Count; i++) {
+    clients.emplace_back([this, i, &socket, &statuses]() {
+      BatchRequest request{m_dir.string(), {}, "hello", {}};
+      statuses[i] = BatchProtocol::RunClient(socket.string(), request);
+    });
+  }
+  for (auto& client : clients) client.join();
+  // jobs ran one after another
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds{300 * Count});
+  for (int i = 0; i < Count; i++) EXPECT_EQ(statuses[i], 0);
+  server.Stop();
+  thread.join();
+}
+
+TEST_F(BatchServerTest, SecondServer) {
+  BatchServer server{m_socket.string(), [](const BatchRequest&) { return 0; }};
+  std::string error;
+  EXPECT_FALSE(server.Listen(&error));
+  EXPECT_FALSE(error.empty());
+}
+
+TEST_F(BatchServerTest, ClientGone) {
+  // client must be a separate process, job process forked from this one
+  // would keep client socket open otherwise
+  pid_t client = ::fork();
+  ASSERT_GE(client, 0);
+  if (client == 0) {
+    int socket = BatchProtocol::Connect(m_socket.string());
+    const int fds[BatchProtocol::DescriptorCount]{STDIN_FILENO, STDOUT_FILENO,
+                                                  STDERR_FILENO};
+    BatchRequest request{m_dir.string(), {}, "sleep", {}};
+    BatchProtocol::SendRequest(socket, request, fds);
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+    ::_exit(0);
+  }
+  ::waitpid(client, nullptr, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds{500});
+  // server waits for running jobs on stop, job must be terminated already
+  auto start = std::chrono::steady_clock::now();
+  m_server->Stop();
+  m_thread.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{10});
+}
+#endif
@@ -0,0 +1,148 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Main/ProjectFile/ProjectFileLoader.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QXmlStreamReader>
+
+#include "NewProject/ProjectManager/project.h"
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+class CounterComponent : public ProjectFileComponent {
+ public:
+  explicit CounterComponent(const QString &name) : m_name(name) {}
+  void Save(QXmlStreamWriter *writer) override {
+    m_saveCount++;
+    writer->writeStartElement(m_name);
+    writer->writeAttribute("Value", QString::number(m_value));
+    writer->writeEndElement();
+  }
+  void Change() {
+    m_value++;
+    emit saveFile();
+  }
+  int saveCount() const { return m_saveCount; }
+
+ private:
+  QString m_name;
+  int m_value{0};
+  int m_saveCount{0};
+};
+
+class ProjectFileLoaderTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(m_dir.isValid());
+    Project::Instance()->setProjectName("loader_test");
+    Project::Instance()->setProjectPath(m_dir.path());
+    m_loader.reset(new ProjectFileLoader{Project::Instance()});
+    m_loader->setSaveDelay(50, 500);
+    m_loader->registerComponent(m_first, ComponentId::ProjectManager);
+    m_loader->registerComponent(m_second, ComponentId::TaskManager);
+  }
+  void TearDown() override {
+    m_loader.reset();
+    Project::Instance()->setProjectName({});
+    Project::Instance()->setProjectPath({});
+  }
+
+  QString content() const {
+    QFile file{m_dir.filePath("loader_test.ospr")};
+    if (!file.open(QFile::ReadOnly)) return {};
+    return QString::fromUtf8(file.readAll());
+  }
+
+ protected:
+  QTemporaryDir m_dir;
+  std::unique_ptr<ProjectFileLoader> m_loader;
+  CounterComponent *m_first{new CounterComponent{"First"}};
+  CounterComponent *m_second{new CounterComponent{"Second"}};
+};
+
+TEST_F(ProjectFileLoaderTest, BulkEditsWrittenOnce) {
+  for (int i = 0; i < 1000; i++) m_first->Change();
+  EXPECT_EQ(m_loader->writeCount(), 0u);
+  EXPECT_TRUE(m_loader->hasPendingSave());
+  m_loader->Flush();
+  EXPECT_FALSE(m_loader->hasPendingSave());
+  EXPECT_EQ(m_loader->writeCount(), 1u);
+  EXPECT_EQ(m_first->saveCount(), 1);
+
+  const QString data = content();
+  EXPECT_TRUE(data.contains("<First Value=\"1000\"/>"));
+  EXPECT_TRUE(data.contains("<Second Value=\"0\"/>"));
+  QXmlStreamReader reader{data};
+  while (!reader.atEnd()) reader.readNext();
+  EXPECT_FALSE(reader.hasError()) << reader.errorString().toStdString();
+}
+
+TEST_F(ProjectFileLoaderTest, CleanComponentNotSerialized) {
+  m_first->Change();
+  m_loader->Flush();
+  EXPECT_EQ(m_second->saveCount(), 1);
+  for (int i = 0; i < 10; i++) {
+    m_first->Change();
+    m_loader->Flush();
+    EXPECT_TRUE(content().contains(
+        QString{"<First Value=\"%1\"/>"}.arg(i + 2)));
+  }
+  EXPECT_EQ(m_loader->writeCount(), 11u);
+  EXPECT_EQ(m_first->saveCount(), 11);
+  EXPECT_EQ(m_second->saveCount(), 1);
+}
+
+TEST_F(ProjectFileLoaderTest, SaveWritesNow) {
+  m_first->Change();
+  m_loader->Save();
+  EXPECT_FALSE(m_loader->hasPendingSave());
+  EXPECT_EQ(m_loader->writeCount(), 1u);
+  EXPECT_TRUE(content().contains("<First Value=\"1\"/>"));
+  // same content, file is not touched
+  m_loader->Save();
+  EXPECT_EQ(m_loader->writeCount(), 1u);
+}
+
+TEST_F(ProjectFileLoaderTest, MaxDelayWithoutEventLoop) {
+  // pending save is always overdue
+  m_loader->setSaveDelay(50, 0);
+  m_first->Change();
+  // timer could not fire, next change writes both
+  m_second->Change();
+  EXPECT_EQ(m_loader->writeCount(), 1u);
+  EXPECT_FALSE(m_loader->hasPendingSave());
+  EXPECT_TRUE(content().contains("<Second Value=\"1\"/>"));
+}
+
+TEST_F(ProjectFileLoaderTest, FlushWithoutPendingChanges) {
+  m_loader->Flush();
+  EXPECT_EQ(m_loader->writeCount(), 0u);
+  EXPECT_TRUE(content().isEmpty());
+}
+
+TEST_F(ProjectFileLoaderTest, FlushOnDestruction) {
+  m_second->Change();
+  m_loader.reset();
+  EXPECT_TRUE(content().contains("<Second Value=\"1\"/>"));
+}
@@ -0,0 +1,219 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NewProject/ProjectManager/DesignFileWatcher.h"
+
+#include <QTest>
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+namespace fs = std::filesystem;
+
+// parameter: native watcher
+class DesignFileWatcherTest : public testing::TestWithParam<bool> {
+ public:
+  void SetUp() override {
+    fs::remove_all(m_dir);
+    fs::create_directories(m_dir / "constr");
+    write(m_design, "module top; endmodule\n");
+    write(m_sdc, "create_clock -period 5 clk\n");
+    m_watcher.init(GetParam());
+    m_watcher.setSettleDelay(50, 1000);
+    m_watcher.setFiles(
+        {{QString::fromStdString(m_design.string()), "source_1",
+          DesignFile::Design},
+         {QString::fromStdString(m_sdc.string()), "constrs_1",
+          DesignFile::Constraint}});
+    // files are hashed in the background
+    QTest::qWaitFor([this]() { return !m_watcher.hasPendingChanges(); }, 5000);
+    QObject::connect(&m_watcher, &DesignFileWatcher::designChanged,
+                     [this](const DesignChangeSet& changes) {
+                       m_batches.push_back(changes);
+                     });
+  }
+  void TearDown() override { fs::remove_all(m_dir); }
+
+  static void write(const fs::path& file, const std::string& content) {
+    std::ofstream stream{file, std::ios::binary | std::ios::trunc};
+    stream << content;
+  }
+  bool waitBatch() {
+    return QTest::qWaitFor([this]() { return !m_batches.empty(); }, 5000);
+  }
+  // change of the file, nullptr if file didn't change
+  static const DesignFileChange* find(const DesignChangeSet& changes,
+                                      const fs::path& file) {
+    for (const auto& change : changes)
+      if (change.file.toStdString() == file.string()) return &change;
+    return nullptr;
+  }
+
+ protected:
+  fs::path m_dir{fs::absolute("design_file_watcher_test")};
+  fs::path m_design{m_dir / "top.v"};
+  fs::path m_sdc{m_dir / "constr" / "top.sdc"};
+  DesignFileWatcher m_watcher;
+  std::vector<DesignChangeSet> m_batches;
+};
+
+TEST_P(DesignFileWatcherTest, BurstIsOneBatch) {
+  ASSERT_EQ(m_watcher.isNative(), GetParam());
+  for (int i = 0; i < 5; i++)
+    write(m_design, "module top; wire w" + std::to_string(i) + "; endmodule\n");
+  write(m_sdc, "create_clock -period 4 clk\n");
+  ASSERT_TRUE(waitBatch());
+  QTest::qWait(200);
+  ASSERT_EQ(m_batches.size(), 1);
+  const auto& changes = m_batches.front();
+  EXPECT_EQ(changes.size(), 2);
+  auto design = find(changes, m_design);
+  ASSERT_NE(design, nullptr);
+  EXPECT_EQ(design->fileSet, "source_1");
+  EXPECT_EQ(design->source, DesignFile::Design);
+  EXPECT_EQ(design->kind, DesignFileChange::Content);
+  auto sdc = find(changes, m_sdc);
+  ASSERT_NE(sdc, nullptr);
+  EXPECT_EQ(sdc->fileSet, "constrs_1");
+  EXPECT_EQ(sdc->source, DesignFile::Constraint);
+  EXPECT_EQ(sdc->kind, DesignFileChange::Content);
+}
+
+TEST_P(DesignFileWatcherTest, SaveWithoutChange) {
+  write(m_design, "module top; endmodule\n");
+  fs::last_write_time(m_sdc, fs::file_time_type::clock::now());
+  // file next to the watched one
+  write(m_dir / "other.v", "module other; endmodule\n");
+  QTest::qWait(500);
+  EXPECT_TRUE(m_batches.empty());
+  EXPECT_FALSE(m_watcher.hasPendingChanges());
+}
+
+#ifndef _WIN32
+TEST_P(DesignFileWatcherTest, Permissions) {
+  fs::permissions(m_design, fs::perms::owner_exec, fs::perm_options::add);
+  ASSERT_TRUE(waitBatch());
+  ASSERT_EQ(m_batches.front().size(), 1);
+  EXPECT_EQ(m_batches.front().front().kind, DesignFileChange::Metadata);
+}
+#endif
+
+TEST_P(DesignFileWatcherTest, ReplaceAndRemove) {
+  // editor saves into temporary file and renames it over the original
+  const fs::path temp{m_dir / "top.v.tmp"};
+  write(temp, "module top(input a); endmodule\n");
+  fs::rename(temp, m_design);
+  ASSERT_TRUE(waitBatch());
+  ASSERT_EQ(m_batches.back().size(), 1);
+  EXPECT_EQ(m_batches.back().front().kind, DesignFileChange::Content);
+
+  // replaced file is still watched
+  write(m_design, "module top(input b); endmodule\n");
+  ASSERT_TRUE(
+      QTest::qWaitFor([this]() { return m_batches.size() == 2; }, 5000));
+  ASSERT_EQ(m_batches.back().size(), 1);
+  EXPECT_EQ(m_batches.back().front().kind, DesignFileChange::Content);
+
+  fs::remove(m_sdc);
+  ASSERT_TRUE(
+      QTest::qWaitFor([this]() { return m_batches.size() == 3; }, 5000));
+  ASSERT_EQ(m_batches.back().size(), 1);
+  auto removed = find(m_batches.back(), m_sdc);
+  ASSERT_NE(removed, nullptr);
+  EXPECT_EQ(removed->kind, DesignFileChange::Removed);
+
+  // file created again
+  write(m_sdc, "create_clock -period 5 clk\n");
+  ASSERT_TRUE(
+      QTest::qWaitFor([this]() { return m_batches.size() == 4; }, 5000));
+  EXPECT_EQ(m_batches.back().front().kind, DesignFileChange::Content);
+}
+
+TEST_P(DesignFileWatcherTest, FileListChange) {
+  int changed{0};
+  QObject::connect(&m_watcher, &DesignFileWatcher::designFilesChanged,
+                   [&changed]() { changed++; });
+  const fs::path sim{m_dir / "tb.v"};
+  write(sim, "module tb; endmodule\n");
+  m_watcher.setFiles({{QString::fromStdString(m_design.string()), "source_1",
+                       DesignFile::Design},
+                      {QString::fromStdString(sim.string()), "sim_1",
+                       DesignFile::Simulation}});
+  EXPECT_EQ(changed, 1);
+  // same list
+  m_watcher.setFiles({{QString::fromStdString(m_design.string()), "source_1",
+                       DesignFile::Design},
+                      {QString::fromStdString(sim.string()), "sim_1",
+                       DesignFile::Simulation}});
+  EXPECT_EQ(changed, 1);
+
+  // file not watched anymore
+  write(m_sdc, "create_clock -period 3 clk\n");
+  write(sim, "module tb; initial $finish; endmodule\n");
+  ASSERT_TRUE(waitBatch());
+  ASSERT_EQ(m_batches.front().size(), 1);
+  EXPECT_EQ(m_batches.front().front().source, DesignFile::Simulation);
+  EXPECT_EQ(m_batches.front().front().fileSet, "sim_1");
+  // content changes are reported by designChanged only
+  EXPECT_EQ(changed, 1);
+}
+
+TEST_P(DesignFileWatcherTest, EditBeforeBaselineHash) {
+  const fs::path sim{m_dir / "tb.v"};
+  write(sim, "module tb; endmodule\n");
+  m_watcher.setFiles({{QString::fromStdString(m_design.string()), "source_1",
+                       DesignFile::Design},
+                      {QString::fromStdString(sim.string()), "sim_1",
+                       DesignFile::Simulation}});
+  // edited while the baseline of the new file is being hashed
+  write(sim, "module tb; initial $finish; endmodule\n");
+  ASSERT_TRUE(waitBatch());
+  // reported once, by the baseline or by the watch
+  QTest::qWait(200);
+  ASSERT_EQ(m_batches.size(), 1);
+  ASSERT_EQ(m_batches.front().size(), 1);
+  EXPECT_EQ(m_batches.front().front().source, DesignFile::Simulation);
+  EXPECT_EQ(m_batches.front().front().kind, DesignFileChange::Content);
+}
+
+TEST_P(DesignFileWatcherTest, HashedOnWorker) {
+  write(m_design, "module top; wire w; endmodule\n");
+  ASSERT_TRUE(QTest::qWaitFor(
+      [this]() { return m_watcher.hasPendingChanges(); }, 5000));
+  m_watcher.flush();
+  // result comes back through the event loop
+  EXPECT_TRUE(m_batches.empty());
+  EXPECT_TRUE(m_watcher.hasPendingChanges());
+  ASSERT_TRUE(waitBatch());
+  EXPECT_FALSE(m_watcher.hasPendingChanges());
+  ASSERT_EQ(m_batches.front().size(), 1);
+  EXPECT_EQ(m_batches.front().front().kind, DesignFileChange::Content);
+}
+
+INSTANTIATE_TEST_SUITE_P(DesignFileWatcher, DesignFileWatcherTest,
+#ifdef __linux__
+                         testing::Values(true, false)
+#else
+                         testing::Values(false)
+#endif
+);
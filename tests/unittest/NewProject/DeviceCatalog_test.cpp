@@ -0,0 +1,151 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NewProject/ProjectManager/DeviceCatalog.h"
+
+#include "Utils/FileUtils.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+using namespace FOEDAG;
+
+static const char *DeviceXml = R"(<device_list>
+  <device name="dev1" series="s" family="f" package="p" pin_count="10">
+    <internal type="vpr_arch" file="arch/vpr.xml"/>
+    <internal type="device_size" name="10x8"/>
+    <resource type="lut" label="LUTs" num="100"/>
+  </device>
+  <device name="dev2" series="s" family="f" package="p2">
+    <resource type="io" num="20"/>
+  </device>
+</device_list>
+)";
+
+class DeviceCatalogTest : public testing::Test {
+ public:
+  void SetUp() override {
+    FileUtils::removeFile(m_dir);
+    FileUtils::MkDirs(m_dir);
+    FileUtils::WriteToFile(m_xml, DeviceXml);
+    m_catalog.cacheDirectory(m_dir / "cache");
+  }
+  void TearDown() override { FileUtils::removeFile(m_dir); }
+
+ protected:
+  fs::path m_dir{fs::absolute("device_catalog_test")};
+  fs::path m_xml{m_dir / "device.xml"};
+  DeviceCatalog m_catalog;
+};
+
+TEST_F(DeviceCatalogTest, Parse) {
+  std::string error;
+  auto list = m_catalog.load(m_xml, m_dir, &error);
+  ASSERT_NE(list, nullptr);
+  EXPECT_TRUE(error.empty());
+  EXPECT_EQ(list->devices().size(), 2u);
+
+  auto dev1 = list->find("dev1");
+  ASSERT_NE(dev1, nullptr);
+  EXPECT_EQ(dev1->pinCount, "10");
+  ASSERT_EQ(dev1->internals.size(), 2u);
+  EXPECT_EQ(dev1->internals.at(0).fullPath, m_dir / "arch/vpr.xml");
+  EXPECT_TRUE(dev1->internals.at(1).fullPath.empty());
+  EXPECT_EQ(dev1->internals.at(1).name, "10x8");
+  ASSERT_EQ(dev1->resources.size(), 1u);
+  EXPECT_EQ(dev1->resources.at(0).label, "LUTs");
+
+  auto dev2 = list->find("dev2");
+  ASSERT_NE(dev2, nullptr);
+  EXPECT_EQ(dev2->package, "p2");
+  EXPECT_EQ(list->find("dev3"), nullptr);
+}
+
+TEST_F(DeviceCatalogTest, DuplicateNameAndPaths) {
+  // relative file is resolved against devices base even if it exists in the
+  // current directory
+  FileUtils::MkDirs("arch");
+  FileUtils::WriteToFile("arch/vpr.xml", "");
+  FileUtils::WriteToFile(m_xml, R"(<device_list>
+  <device name="dev1" package="first">
+    <internal type="vpr_arch" file="arch/vpr.xml"/>
+  </device>
+  <device name="dev1" package="last">
+    <internal type="vpr_arch" file="/opt/arch/vpr.xml"/>
+  </device>
+</device_list>
+)");
+  auto list = m_catalog.load(m_xml, m_dir / "base");
+  FileUtils::removeFile(fs::path{"arch"});
+  ASSERT_NE(list, nullptr);
+  EXPECT_EQ(list->devices().at(0).internals.at(0).fullPath,
+            m_dir / "base/arch/vpr.xml");
+  auto dev1 = list->find("dev1");
+  ASSERT_NE(dev1, nullptr);
+  EXPECT_EQ(dev1->package, "last");
+  EXPECT_EQ(dev1->internals.at(0).fullPath, "/opt/arch/vpr.xml");
+}
+
+TEST_F(DeviceCatalogTest, Errors) {
+  std::string error;
+  EXPECT_EQ(m_catalog.load(m_dir / "missing.xml", m_dir, &error), nullptr);
+  EXPECT_NE(error.find("Cannot open device file"), std::string::npos);
+
+  FileUtils::WriteToFile(m_xml, "<device_list><device>");
+  EXPECT_EQ(m_catalog.load(m_xml, m_dir, &error), nullptr);
+  EXPECT_NE(error.find("Incorrect device file"), std::string::npos);
+}
+
+TEST_F(DeviceCatalogTest, MemoryCache) {
+  auto list1 = m_catalog.load(m_xml, m_dir);
+  auto list2 = m_catalog.load(m_xml, m_dir);
+  EXPECT_EQ(list1, list2);
+}
+
+TEST_F(DeviceCatalogTest, BinaryCache) {
+  auto list1 = m_catalog.load(m_xml, m_dir);
+  ASSERT_NE(list1, nullptr);
+  EXPECT_FALSE(FileUtils::FindFileByExtension(m_dir / "cache", ".bin").empty());
+
+  // new session reads the binary cache
+  DeviceCatalog catalog;
+  catalog.cacheDirectory(m_dir / "cache");
+  auto list2 = catalog.load(m_xml, m_dir);
+  ASSERT_NE(list2, nullptr);
+  EXPECT_NE(list1, list2);
+  ASSERT_NE(list2->find("dev1"), nullptr);
+  EXPECT_EQ(list2->find("dev1")->internals.at(0).fullPath,
+            m_dir / "arch/vpr.xml");
+}
+
+TEST_F(DeviceCatalogTest, CacheInvalidation) {
+  ASSERT_NE(m_catalog.load(m_xml, m_dir), nullptr);
+  std::string xml{DeviceXml};
+  // different size, mtime granularity could hide the change
+  xml.replace(xml.find("dev2"), 4, "device3");
+  FileUtils::WriteToFile(m_xml, xml);
+
+  DeviceCatalog catalog;
+  catalog.cacheDirectory(m_dir / "cache");
+  auto list = catalog.load(m_xml, m_dir);
+  ASSERT_NE(list, nullptr);
+  EXPECT_EQ(list->find("dev2"), nullptr);
+  EXPECT_NE(list->find("device3"), nullptr);
+}
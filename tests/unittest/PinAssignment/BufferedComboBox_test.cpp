@@ -21,6 +21,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "gtest/gtest.h"
 #include "PinAssignment/BufferedComboBox.h"
+#include <QCompleter>
+#include <QLineEdit>
 #include <QStringListModel>
 
 using namespace FOEDAG;
@@ -43,3 +45,20 @@ TEST(BufferedComboBox, PreviousText) {
   combo.setCurrentIndex(2);
   EXPECT_EQ(combo.previousText(), "test2");
 }
+
+TEST(BufferedComboBox, Filter) {
+  BufferedComboBox combo;
+  QStringListModel model;
+  model.setStringList({"", "pin1", "pin12", "other"});
+  combo.setModel(&model);
+  QStringList texts;
+  combo.setFilter([&texts](const QString &text) {
+    texts.append(text);
+    return QStringList{"pin1", "pin12"};
+  });
+  EXPECT_TRUE(combo.isEditable());
+  emit combo.lineEdit()->textEdited("pin");
+  EXPECT_EQ(texts, QStringList{"pin"});
+  EXPECT_EQ(combo.completer()->model()->rowCount(), 2);
+  EXPECT_EQ(combo.count(), 4);
+}
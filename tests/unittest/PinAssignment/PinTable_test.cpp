@@ -0,0 +1,248 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PinAssignment/PinTable.h"
+
+#include <QMap>
+#include <QSet>
+#include <bitset>
+#include <chrono>
+#include <iostream>
+
+#include "PinAssignment/PackagePinsModel.h"
+#include "gtest/gtest.h"
+using namespace FOEDAG;
+
+static constexpr int ColumnCount{Voltage2 + 1};
+
+// ball B<n>, id <n>, two internal pins per ball, every second ball is
+// available in mode ModeFirst and every third in ModeFirst + 1
+static QStringList syntheticLine(int ball, int internal) {
+  QStringList line;
+  for (int i = 0; i < ColumnCount; i++) line.append(QString{});
+  line[PinName] = QString{"P%1"}.arg(ball);
+  line[BallName] = QString{"B%1"}.arg(ball);
+  line[BallId] = QString::number(ball);
+  line[InternalPinName] = QString{"I%1_%2"}.arg(ball).arg(internal);
+  if (ball % 2 == 0) line[ModeFirst] = "Y";
+  if (ball % 3 == 0) line[ModeFirst + 1] = "Y";
+  line[Bank] = QString{"Bank%1"}.arg(ball % 8);
+  return line;
+}
+
+static void addLine(PinTable &table, const QStringList &line) {
+  std::vector<QStringView> fields;
+  for (const auto &field : line) fields.push_back(field);
+  table.addLine(fields);
+}
+
+static void fillTable(PinTable &table, int balls) {
+  for (int ball = 0; ball < balls; ball++) {
+    addLine(table, syntheticLine(ball, 0));
+    addLine(table, syntheticLine(ball, 1));
+  }
+}
+
+TEST(PinTable, Lookup) {
+  PinTable table;
+  fillTable(table, 2000);
+  EXPECT_EQ(table.ballCount(), 2000);
+  const int ball = table.ballByName("B42");
+  EXPECT_NE(ball, PinTable::NoBall);
+  EXPECT_EQ(table.ballById("42"), ball);
+  EXPECT_EQ(table.value(ball, PinName), "P42");
+  EXPECT_EQ(table.value(ball, Bank), "Bank2");
+  EXPECT_EQ(table.row(ball).count(), ColumnCount);
+  EXPECT_EQ(table.ballByName("B2000"), PinTable::NoBall);
+  EXPECT_EQ(table.value(PinTable::NoBall, PinName), QString{});
+}
+
+TEST(PinTable, Modes) {
+  PinTable table;
+  fillTable(table, 2000);
+  const int b2 = table.ballByName("B2");
+  const int b3 = table.ballByName("B3");
+  EXPECT_TRUE(table.available(b2, ModeFirst));
+  EXPECT_FALSE(table.available(b2, ModeFirst + 1));
+  EXPECT_FALSE(table.available(b3, ModeFirst));
+  EXPECT_TRUE(table.available(b3, ModeFirst + 1));
+  EXPECT_FALSE(table.available(b2, PinName));
+  EXPECT_EQ(table.internalPins(b2, ModeFirst),
+            (QStringList{"I2_0", "I2_1"}));
+  EXPECT_TRUE(table.internalPins(b2, ModeFirst + 1).isEmpty());
+  EXPECT_EQ(table.internalPinMax(), 2);
+
+  int count{0};
+  for (auto word : table.modeBalls(ModeFirst))
+    count += std::bitset<64>{word}.count();
+  EXPECT_EQ(count, 1000);
+}
+
+TEST(PinTable, Filter) {
+  PinTable table;
+  fillTable(table, 2000);
+  EXPECT_EQ(table.filter("b199", BallName).size(), 11u);  // B199, B1990..9
+  EXPECT_EQ(table.filter("bank3", Bank).size(), 250u);
+  EXPECT_EQ(table.filter("bank3", Bank, ModeFirst).size(), 0u);
+  EXPECT_EQ(table.filter("", BallName, ModeFirst + 1).size(), 667u);
+  EXPECT_TRUE(table.filter("B1", ColumnCount).empty());
+}
+
+TEST(PinTable, IncrementalFilter) {
+  PinTable table;
+  fillTable(table, 2000);
+  PinFilter filter{&table, BallName};
+  EXPECT_EQ(filter.setText("B1").size(), 1111u);
+  EXPECT_EQ(filter.setText("B19").size(), 111u);
+  EXPECT_EQ(filter.setText("B199").size(), 11u);
+  // shorter text, full search again
+  EXPECT_EQ(filter.setText("B1").size(), 1111u);
+  EXPECT_EQ(filter.setText("B5").size(), 111u);
+  EXPECT_EQ(filter.result().size(), 111u);
+}
+
+TEST(PinTable, Validate) {
+  PinTable table;
+  fillTable(table, 2000);
+  EXPECT_TRUE(table.validate({{"B2", ModeFirst, "I2_1"},
+                              {"B3", ModeFirst + 1, {}},
+                              {"B5", -1, {}}})
+                  .isEmpty());
+  EXPECT_TRUE(table.validate({{"2", ModeFirst, "I2_0"}}, true).isEmpty());
+  const QStringList errors = table.validate({{"B2", ModeFirst, {}},
+                                             {"B2", ModeFirst, {}},
+                                             {"B3", ModeFirst, {}},
+                                             {"B4", ModeFirst, "I2_0"},
+                                             {"X1", -1, {}}});
+  EXPECT_EQ(errors.count(), 4);
+}
+
+TEST(PinTable, KeyColumn) {
+  PinTable table{0, PinTable::NoColumn};
+  for (const QString name : {"clk", "data[0]", "data[1]", "clk"})
+    table.addLine({name});
+  EXPECT_EQ(table.ballCount(), 3);
+  EXPECT_EQ(table.ballByName("data[1]"), 2);
+  EXPECT_EQ(table.ballById("data[1]"), PinTable::NoBall);
+  EXPECT_EQ(table.filter("DATA", 0), (std::vector<int>{1, 2}));
+}
+
+TEST(PinTable, ScopedFilter) {
+  PinTable table;
+  fillTable(table, 2000);
+  const std::vector<int> balls{table.ballByName("B1001"),
+                               table.ballByName("B10"),
+                               table.ballByName("B5")};
+  PinFilter filter{&table, BallName, -1, &balls};
+  EXPECT_EQ(filter.setText("B1"), (std::vector<int>{balls[0], balls[1]}));
+  EXPECT_EQ(filter.setText("B10"), (std::vector<int>{balls[0], balls[1]}));
+  EXPECT_EQ(filter.setText("B"), balls);
+}
+
+TEST(PinTable, ModelFilter) {
+  PackagePinsModel model;
+  fillTable(model.pinTable(), 2000);
+  PackagePinGroup group{"user", {}};
+  for (int ball : {10, 100, 1000, 1001})
+    group.pinData.append({syntheticLine(ball, 0)});
+  model.append(group);
+  model.initListModel();
+  EXPECT_EQ(model.filter("b10"),
+            (QStringList{"B10", "B100", "B1000", "B1001"}));
+  EXPECT_EQ(model.filter("b100"), (QStringList{"B100", "B1000", "B1001"}));
+  EXPECT_EQ(model.filter("B1001"), QStringList{"B1001"});
+  model.setUseBallId(true);
+  EXPECT_EQ(model.filter("100"), (QStringList{"100", "1000", "1001"}));
+}
+
+// before: csv lines split into string lists with internal pins in nested maps
+// and combo box completer searching the whole pin list for every key press,
+// as Pin Planner did before PinTable
+TEST(PinTable, DISABLED_Benchmark2000Pins) {
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start)
+        .count();
+  };
+  auto report = [](const char *name, double before, double after) {
+    std::cout << name << ": before " << before << " ms, after " << after
+              << " ms" << std::endl;
+  };
+  QStringList lines;
+  for (int ball = 0; ball < 2000; ball++)
+    for (int internal = 0; internal < 8; internal++)
+      lines.append(syntheticLine(ball, internal).join(','));
+  const QStringList texts{"B", "B1", "B19", "B199", "B1999"};
+  QVector<PinTable::Assignment> assignments;
+  for (int ball = 0; ball < 2000; ball += 2)
+    assignments.append({QString{"B%1"}.arg(ball), ModeFirst,
+                        QString{"I%1_7"}.arg(ball)});
+
+  auto start = Clock::now();
+  QStringList pins;
+  QMap<QString, QMap<int, QStringList>> internalPins;
+  QSet<QString> uniquePins;
+  for (const auto &line : lines) {
+    const QStringList data = line.split(',');
+    for (int i = ModeFirst; (i <= ModeLast) && (i < data.count()); i++) {
+      if (data.at(i) == "Y")
+        internalPins[data.at(BallName)][i].append(data.at(InternalPinName));
+    }
+    if (uniquePins.contains(data.at(BallName))) continue;
+    uniquePins.insert(data.at(BallName));
+    pins.append(data.at(BallName));
+  }
+  const double buildBefore = ms(start);
+
+  start = Clock::now();
+  PinTable table;
+  std::vector<QStringView> fields;
+  for (const auto &line : lines) {
+    fields.clear();
+    for (const auto &field : QStringView{line}.split(u','))
+      fields.push_back(field);
+    table.addLine(fields);
+  }
+  report("build", buildBefore, ms(start));
+
+  start = Clock::now();
+  for (const auto &text : texts) pins.filter(text, Qt::CaseInsensitive);
+  const double filterBefore = ms(start);
+  start = Clock::now();
+  PinFilter filter{&table, BallName};
+  for (const auto &text : texts) filter.setText(text);
+  report("filter while typing", filterBefore, ms(start));
+
+  start = Clock::now();
+  int valid{0};
+  for (const auto &assignment : assignments) {
+    if (pins.indexOf(assignment.pin) != -1 &&
+        internalPins.value(assignment.pin)
+            .value(assignment.mode)
+            .contains(assignment.internalPin))
+      valid++;
+  }
+  const double validateBefore = ms(start);
+  EXPECT_EQ(valid, assignments.count());
+  start = Clock::now();
+  EXPECT_TRUE(table.validate(assignments).isEmpty());
+  report("validate 1000 pins", validateBefore, ms(start));
+}
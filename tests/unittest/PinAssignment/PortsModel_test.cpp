@@ -43,3 +43,14 @@ TEST(PortsModel, GetPort) {
     EXPECT_EQ(p.type, "REG");
   }
 }
+
+TEST(PortsModel, Filter) {
+  PortsModel model;
+  PortsLoader loader{&model};
+  loader.load(":/PinAssignment/ports_test.json");
+  EXPECT_EQ(model.portTable().ballCount(), 9);
+  EXPECT_EQ(model.filter("inp"), QStringList{"inp1"});
+  EXPECT_EQ(model.filter("OUT").count(), 8);
+  EXPECT_EQ(model.filter("out1[4]"), QStringList{"out1[4]"});
+  EXPECT_EQ(model.filter("").count(), 9);
+}
@@ -0,0 +1,83 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ProjNavigator/HierarchyIndex.h"
+
+#include <QFile>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+static std::shared_ptr<HierarchyIndex> load(const QString &file) {
+  QFile json{file};
+  if (!json.open(QFile::ReadOnly)) return nullptr;
+  return HierarchyIndex::parse(json.readAll().toStdString(), "/base");
+}
+
+TEST(HierarchyIndex, parse) {
+  auto index = load(":/ProjNavigator/hier_info_1.json");
+  ASSERT_NE(index, nullptr);
+  ASSERT_EQ(index->tops().size(), 1u);
+  const auto &top = index->module(index->tops().front());
+  EXPECT_EQ(index->name(top.name), "wrapper");
+  ASSERT_EQ(top.instanceCount, 1u);
+
+  const auto &inst = index->instance(index->tops().front(), 0);
+  EXPECT_EQ(index->name(inst.name), "U1");
+  EXPECT_EQ(index->name(inst.module), "decrypt");
+  EXPECT_GT(inst.line, 0);
+  const uint32_t def = index->definition(inst);
+  ASSERT_NE(def, HierarchyIndex::None);
+  EXPECT_EQ(index->module(def).instanceCount, 4u);
+  EXPECT_EQ(index->file(index->module(def).file).find("/base/"), 0u);
+}
+
+TEST(HierarchyIndex, find) {
+  auto index = load(":/ProjNavigator/hier_info_1.json");
+  ASSERT_NE(index, nullptr);
+  auto results = index->find("INVSBOX");
+  ASSERT_FALSE(results.empty());
+  // path of rows leads to matching instance
+  for (const auto &path : results) {
+    ASSERT_GE(path.size(), 2u);
+    uint32_t def = index->tops().at(path.front());
+    const HierarchyIndex::Instance *inst{nullptr};
+    for (size_t i = 1; i < path.size(); i++) {
+      inst = &index->instance(def, path.at(i));
+      def = index->definition(*inst);
+    }
+    const QString names = QString::fromStdString(index->name(inst->name) +
+                                                 index->name(inst->module));
+    EXPECT_TRUE(names.contains("invsbox", Qt::CaseInsensitive))
+        << names.toStdString();
+  }
+  EXPECT_EQ(index->find("INVSBOX", 3).size(), 3u);
+  EXPECT_TRUE(index->find("no_such_instance").empty());
+  EXPECT_TRUE(index->find("").empty());
+}
+
+TEST(HierarchyIndex, corrupted) {
+  std::string error;
+  EXPECT_EQ(HierarchyIndex::parse("{\"fileIDs\": {}", "/", &error), nullptr);
+  EXPECT_FALSE(error.empty());
+  EXPECT_EQ(load(":/ProjNavigator/hier_info_corrupted.json"), nullptr);
+}
@@ -21,9 +21,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "ProjNavigator/HierarchyView.h"
 
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QtTest/QSignalSpy>
 
+#include "ProjNavigator/HierarchyModel.h"
 #include "gtest/gtest.h"
 
 using namespace FOEDAG;
@@ -34,60 +35,112 @@ static const fs::path FilePathProj2{":/ProjNavigator/hier_info_1.json"};
 static const fs::path FilePathCorrupted{
     ":/ProjNavigator/hier_info_corrupted.json"};
 
+static void waitLoaded(HierarchyView &view) {
+  if (view.isLoading()) {
+    QSignalSpy spy{&view, &HierarchyView::loaded};
+    ASSERT_TRUE(spy.wait());
+  }
+}
+
+static int childCount(HierarchyModel *model, const QModelIndex &parent) {
+  while (model->canFetchMore(parent)) model->fetchMore(parent);
+  return model->rowCount(parent);
+}
+
 TEST(HierarchyView, constructor) {
   HierarchyView view{FilePathProj1};
   ASSERT_NE(view.widget(), nullptr);
-  ASSERT_EQ(view.widget()->topLevelItemCount(), 1);
-  ASSERT_EQ(view.widget()->topLevelItem(0)->childCount(), 0);
+  waitLoaded(view);
+  auto model = view.model();
+  ASSERT_EQ(model->rowCount(), 1);
+  ASSERT_EQ(childCount(model, model->index(0, 0)), 0);
 }
 
 TEST(HierarchyView, setPortsFileCorruptedFile) {
   HierarchyView view{{}};
   view.setPortsFile(FilePathCorrupted);
   ASSERT_NE(view.widget(), nullptr);
-  ASSERT_EQ(view.widget()->topLevelItemCount(), 0);
+  waitLoaded(view);
+  ASSERT_EQ(view.model()->rowCount(), 0);
 }
 
 TEST(HierarchyView, setPortsFile) {
   HierarchyView view{FilePathProj1};
   ASSERT_NE(view.widget(), nullptr);
-  ASSERT_EQ(view.widget()->topLevelItemCount(), 1);
-  ASSERT_EQ(view.widget()->topLevelItem(0)->childCount(), 0);
+  waitLoaded(view);
+  auto model = view.model();
+  ASSERT_EQ(model->rowCount(), 1);
+  ASSERT_EQ(childCount(model, model->index(0, 0)), 0);
 
   view.setPortsFile(FilePathProj2);
-  ASSERT_EQ(view.widget()->topLevelItemCount(), 1);
-  ASSERT_EQ(view.widget()->topLevelItem(0)->childCount(), 1);
-  ASSERT_EQ(view.widget()->topLevelItem(0)->child(0)->childCount(), 4);
-
-  auto child = view.widget()->topLevelItem(0)->child(0);
-  EXPECT_EQ(child->child(0)->childCount(), 0);
-  EXPECT_EQ(child->child(1)->childCount(), 4);
-  EXPECT_EQ(child->child(2)->childCount(), 0);
-  EXPECT_EQ(child->child(3)->childCount(), 16);
+  waitLoaded(view);
+  ASSERT_EQ(model->rowCount(), 1);
+  const QModelIndex top = model->index(0, 0);
+  ASSERT_EQ(childCount(model, top), 1);
+  auto child = model->index(0, 0, top);
+  ASSERT_EQ(childCount(model, child), 4);
+
+  EXPECT_EQ(childCount(model, model->index(0, 0, child)), 0);
+  EXPECT_EQ(childCount(model, model->index(1, 0, child)), 4);
+  EXPECT_EQ(childCount(model, model->index(2, 0, child)), 0);
+  EXPECT_EQ(childCount(model, model->index(3, 0, child)), 16);
+
+  auto sub = model->index(1, 0, child);
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(childCount(model, model->index(i, 0, sub)), 4);
+
+  sub = model->index(3, 0, child);
+  for (int i = 0; i < 16; i++)
+    EXPECT_EQ(childCount(model, model->index(i, 0, sub)), 28);
+}
 
-  child = view.widget()->topLevelItem(0)->child(0)->child(1);
-  for (int i = 0; i < 4; i++) EXPECT_EQ(child->child(i)->childCount(), 4);
+TEST(HierarchyView, lazyFetch) {
+  HierarchyView view{FilePathProj2};
+  waitLoaded(view);
+  auto model = view.model();
+  const QModelIndex top = model->index(0, 0);
+  // children are created when view asks for them
+  const QModelIndex child = model->index(0, 0, top);
+  ASSERT_TRUE(child.isValid());
+  EXPECT_TRUE(model->hasChildren(child));
+  EXPECT_EQ(model->rowCount(child), 0);
+  EXPECT_TRUE(model->canFetchMore(child));
+  EXPECT_EQ(child.data(HierarchyModel::TopItemRole).toBool(), false);
+  EXPECT_EQ(top.data(HierarchyModel::TopItemRole).toBool(), true);
+  EXPECT_TRUE(child.data().toString().startsWith("U1 : decrypt"))
+      << child.data().toString().toStdString();
+}
 
-  child = view.widget()->topLevelItem(0)->child(0)->child(3);
-  for (int i = 0; i < 16; i++) EXPECT_EQ(child->child(i)->childCount(), 28);
+TEST(HierarchyView, find) {
+  HierarchyView view{FilePathProj2};
+  waitLoaded(view);
+  EXPECT_TRUE(view.find("invsbox"));
+  const QString first = view.treeView()->currentIndex().data().toString();
+  EXPECT_TRUE(first.contains("InvSbox", Qt::CaseInsensitive))
+      << first.toStdString();
+  EXPECT_TRUE(view.find("invsbox"));
+  EXPECT_NE(view.treeView()->currentIndex().data().toString(), QString{});
+  EXPECT_FALSE(view.find("no_such_instance"));
 }
 
 TEST(HierarchyView, clean) {
   HierarchyView view{FilePathProj1};
   ASSERT_NE(view.widget(), nullptr);
-  ASSERT_EQ(view.widget()->topLevelItemCount(), 1);
-  ASSERT_EQ(view.widget()->topLevelItem(0)->childCount(), 0);
+  waitLoaded(view);
+  ASSERT_EQ(view.model()->rowCount(), 1);
 
   view.clean();
-  ASSERT_EQ(view.widget()->topLevelItemCount(), 0);
+  ASSERT_EQ(view.model()->rowCount(), 0);
 }
 
 TEST(HierarchyView, topModuleFile) {
   HierarchyView view{{}};
+  waitLoaded(view);
   fs::path expectedPath{":/ProjNavigator/dut.v"};
   expectedPath = expectedPath.lexically_normal();
   QSignalSpy signalSpy{&view, &HierarchyView::topModuleFile};
   view.setPortsFile(FilePathProj1);
+  waitLoaded(view);
 
   EXPECT_EQ(signalSpy.count(), 1);
   auto arguments = signalSpy.takeFirst();
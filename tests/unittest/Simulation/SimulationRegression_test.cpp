@@ -0,0 +1,168 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Simulation/SimulationRegression.h"
+
+#include <chrono>
+#include <thread>
+
+#include "Simulation/Simulator.h"
+#include "Utils/FileUtils.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+using namespace FOEDAG;
+
+class SimulationRegressionTest : public testing::Test {
+ public:
+  void SetUp() override {
+    FileUtils::removeFile(m_dir);
+    FileUtils::MkDirs(m_dir);
+  }
+  void TearDown() override { FileUtils::removeFile(m_dir); }
+
+ protected:
+  fs::path m_dir{fs::absolute("simulation_regression_test")};
+};
+
+#ifndef _WIN32
+TEST_F(SimulationRegressionTest, RunParallel) {
+  SimulationRegression regression;
+  regression.Jobs(2);
+  regression.AddRun("pass1", "sh -c \"echo pass1\"", m_dir / "pass1.log");
+  regression.AddRun("fail", "sh -c \"exit 3\"", m_dir / "fail.log");
+  regression.AddRun("pass2", "sh -c \"echo pass2\"", m_dir / "pass2.log");
+  std::vector<std::string> finished;
+  EXPECT_FALSE(regression.Run(m_dir, [&finished](const RegressionRun& run) {
+    finished.push_back(run.name);
+  }));
+  EXPECT_EQ(finished.size(), 3u);
+  EXPECT_EQ(regression.Passed(), 2u);
+  EXPECT_EQ(regression.Failed(), 1u);
+  EXPECT_EQ(regression.Runs().at(1).exitCode, 3);
+  EXPECT_EQ(FileUtils::GetFileContent(m_dir / "pass2.log"), "pass2\n");
+}
+
+TEST_F(SimulationRegressionTest, WorkingDirectory) {
+  SimulationRegression regression;
+  regression.Jobs(2);
+  regression.AddRun("first", "sh -c \"echo first > out.txt\"", "sim.log");
+  regression.AddRun("second", "sh -c \"echo second > out.txt\"", "sim.log");
+  EXPECT_TRUE(regression.Run(m_dir));
+  // every run has its own directory, same file names don't collide
+  EXPECT_EQ(FileUtils::GetFileContent(m_dir / "first" / "out.txt"), "first\n");
+  EXPECT_EQ(FileUtils::GetFileContent(m_dir / "second" / "out.txt"),
+            "second\n");
+  EXPECT_EQ(regression.Runs().front().log, m_dir / "first" / "sim.log");
+  EXPECT_TRUE(FileUtils::FileExists(m_dir / "second" / "sim.log"));
+  EXPECT_FALSE(FileUtils::FileExists(m_dir / "out.txt"));
+}
+
+TEST_F(SimulationRegressionTest, StopKillsRuns) {
+  SimulationRegression regression;
+  regression.Jobs(1);
+  regression.AddRun("long", "sleep 30", {});
+  regression.AddRun("pending", "sleep 30", {});
+  auto start = std::chrono::steady_clock::now();
+  std::thread stop{[]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    // called by Compiler::Stop()
+    JobPool::StopAll();
+  }};
+  EXPECT_FALSE(regression.Run(m_dir));
+  stop.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+  EXPECT_EQ(regression.Failed(), 2u);
+  EXPECT_NE(regression.Runs().front().exitCode, 0);
+}
+#endif
+
+TEST_F(SimulationRegressionTest, MissingProgram) {
+  SimulationRegression regression;
+  regression.AddRun("missing", "no_such_simulator_binary", {});
+  EXPECT_FALSE(regression.Run(m_dir));
+  EXPECT_EQ(regression.Runs().front().exitCode, -1);
+}
+
+TEST_F(SimulationRegressionTest, ModelHash) {
+  const fs::path source = m_dir / "src" / "top.v";
+  const fs::path include = m_dir / "inc";
+  FileUtils::MkDirs(include);
+  FileUtils::WriteToFile(source, "module top; endmodule");
+  FileUtils::WriteToFile(include / "defs.vh", "`define A 1");
+  const fs::path work = m_dir / "sim";
+  FileUtils::MkDirs(work);
+  const std::string command =
+      "iverilog -I" + include.string() + " " + source.string();
+
+  auto hash = Simulator::ModelHash({command}, work, "v1");
+  EXPECT_FALSE(hash.empty());
+  EXPECT_EQ(hash, Simulator::ModelHash({command}, work, "v1"));
+  EXPECT_NE(hash, Simulator::ModelHash({command}, work, "v2"));
+  EXPECT_NE(hash, Simulator::ModelHash({command + " -DB"}, work, "v1"));
+
+  // generated files in working directory don't change the hash
+  const std::string output = command + " -o a.out";
+  auto outputHash = Simulator::ModelHash({output}, work, "v1");
+  FileUtils::WriteToFile(work / "a.out", "model");
+  EXPECT_EQ(outputHash, Simulator::ModelHash({output}, work, "v1"));
+
+  FileUtils::WriteToFile(include / "more.vh", "`define B 1");
+  EXPECT_NE(hash, Simulator::ModelHash({command}, work, "v1"));
+  hash = Simulator::ModelHash({command}, work, "v1");
+
+  FileUtils::WriteToFile(source, "module top(input a); endmodule");
+  EXPECT_NE(hash, Simulator::ModelHash({command}, work, "v1"));
+}
+
+TEST_F(SimulationRegressionTest, ModelHashDependencies) {
+  const fs::path work = m_dir / "sim";
+  const fs::path nested = m_dir / "inc" / "nested";
+  FileUtils::MkDirs(nested);
+  FileUtils::WriteToFile(nested / "deep.vh", "`define A 1");
+  FileUtils::WriteToFile(m_dir / "src" / "top.v", "`include \"local.vh\"");
+  FileUtils::WriteToFile(m_dir / "src" / "local.vh", "`define L 1");
+  FileUtils::WriteToFile(m_dir / "src" / "files.f", "top.v // design\n");
+  FileUtils::WriteToFile(work / "tb.v", "module tb; endmodule");
+  const std::string command = "iverilog -I" + (m_dir / "inc").string() +
+                              " -F " + (m_dir / "src" / "files.f").string() +
+                              " tb.v -o a.out";
+  auto hash = [&command, &work]() {
+    return Simulator::ModelHash({command}, work, "v1");
+  };
+
+  auto previous = hash();
+  EXPECT_FALSE(previous.empty());
+  // every change below is a dependency of the model
+  const std::vector<std::pair<fs::path, std::string>> edits{
+      {nested / "deep.vh", "`define A 2"},
+      {m_dir / "src" / "top.v", "module top; endmodule"},
+      {m_dir / "src" / "local.vh", "`define L 2"},
+      {work / "tb.v", "module tb(); endmodule"}};
+  for (const auto& [file, content] : edits) {
+    FileUtils::WriteToFile(file, content);
+    const auto current = hash();
+    EXPECT_NE(previous, current) << file;
+    previous = current;
+  }
+  FileUtils::WriteToFile(work / "a.out", "model");
+  EXPECT_EQ(previous, hash());
+}
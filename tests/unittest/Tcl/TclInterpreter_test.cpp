@@ -19,11 +19,13 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "Tcl/TclInterpreter.h"
+#include "Utils/Tracer.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -49,5 +51,134 @@ TEST(TclInterpreter, TestTclError) {
   EXPECT_EQ(result, expected);
 }
 
+int lazyCmd(void* clientData, Tcl_Interp* interp, int argc,
+            const char* argv[]) {
+  Tcl_SetObjResult(interp, Tcl_NewIntObj(argc));
+  return TCL_OK;
+}
+
+int otherCmd(void* clientData, Tcl_Interp* interp, int argc,
+             const char* argv[]) {
+  Tcl_SetResult(interp, (char*)"other", TCL_STATIC);
+  return TCL_OK;
+}
+
+TEST(TclInterpreter, LazyCommands) {
+  TclInterpreter interpreter;
+  int init{0};
+  interpreter.registerLazyCmds(
+      "subsystem",
+      [&interpreter]() {
+        interpreter.registerCmd("lazy_first", lazyCmd, nullptr, nullptr);
+        interpreter.registerCmd("lazy_second", lazyCmd, nullptr, nullptr);
+      },
+      [&init]() { init++; });
+  EXPECT_FALSE(interpreter.isMaterialized("subsystem"));
+  EXPECT_EQ(interpreter.evalCmd("info commands lazy_first"), "lazy_first");
+  EXPECT_EQ(init, 0);
+
+  // first call creates real commands and is forwarded to them
+  EXPECT_EQ(interpreter.evalCmd("lazy_first 1 2 3"), "4");
+  EXPECT_EQ(init, 1);
+  EXPECT_TRUE(interpreter.isMaterialized("subsystem"));
+  EXPECT_EQ(interpreter.evalCmd("lazy_second a"), "2");
+  EXPECT_EQ(init, 1);
+  EXPECT_FALSE(interpreter.materialize("unknown"));
+}
+
+TEST(TclInterpreter, LazyCommandsOverridden) {
+  TclInterpreter interpreter;
+  interpreter.registerLazyCmds("subsystem", [&interpreter]() {
+    interpreter.registerCmd("lazy_first", lazyCmd, nullptr, nullptr);
+    interpreter.registerCmd("lazy_second", lazyCmd, nullptr, nullptr);
+  });
+  // later registration wins, same as without lazy registration
+  interpreter.registerCmd("lazy_first", otherCmd, nullptr, nullptr);
+  EXPECT_EQ(interpreter.evalCmd("lazy_second"), "1");
+  EXPECT_EQ(interpreter.evalCmd("lazy_first"), "other");
+}
+
+TEST(TclInterpreter, LazyCommandMissing) {
+  TclInterpreter interpreter;
+  interpreter.registerLazyCmds(
+      "subsystem",
+      [&interpreter]() {
+        interpreter.registerCmd("lazy_first", lazyCmd, nullptr, nullptr);
+      },
+      [&interpreter]() { interpreter.evalCmd("rename lazy_first {}"); });
+  int ret{TCL_OK};
+  interpreter.evalCmd("lazy_first", &ret);
+  EXPECT_EQ(ret, TCL_ERROR);
+}
+
+TEST(TclInterpreter, LazySubsystem) {
+  TclInterpreter interpreter;
+  std::unique_ptr<int> subsystem;
+  interpreter.registerLazyCmds(
+      "subsystem", {"lazy_first"},
+      [&subsystem]() { subsystem = std::make_unique<int>(0); },
+      [&interpreter, &subsystem]() {
+        interpreter.registerCmd("lazy_first", lazyCmd, subsystem.get(),
+                                nullptr);
+        interpreter.registerCmd("lazy_other", otherCmd, subsystem.get(),
+                                nullptr);
+      });
+  EXPECT_EQ(interpreter.evalCmd("info commands lazy_first"), "lazy_first");
+  EXPECT_EQ(interpreter.evalCmd("info commands lazy_other"), "");
+  EXPECT_EQ(subsystem, nullptr);
+
+  // subsystem is constructed by the first call
+  EXPECT_EQ(interpreter.evalCmd("lazy_first 1 2"), "3");
+  EXPECT_NE(subsystem, nullptr);
+  EXPECT_EQ(interpreter.evalCmd("lazy_other"), "other");
+}
+
+TEST(TclInterpreter, LazySubsystemOverridden) {
+  TclInterpreter interpreter;
+  interpreter.registerLazyCmds("subsystem", {"lazy_first", "lazy_second"}, {},
+                               [&interpreter]() {
+                                 interpreter.registerCmd("lazy_first", lazyCmd,
+                                                         nullptr, nullptr);
+                                 interpreter.registerCmd("lazy_second", lazyCmd,
+                                                         nullptr, nullptr);
+                               });
+  interpreter.registerCmd("lazy_first", otherCmd, nullptr, nullptr);
+  EXPECT_EQ(interpreter.evalCmd("lazy_second"), "1");
+  EXPECT_EQ(interpreter.evalCmd("lazy_first"), "other");
+}
+
+void countDelete(ClientData clientData) { (*static_cast<int*>(clientData))++; }
+
+TEST(TclInterpreter, TracedCommands) {
+  int deleted{0};
+  {
+    TclInterpreter interpreter;
+    interpreter.registerCmd("traced", lazyCmd, &deleted, countDelete);
+    Tcl_CmdInfo info;
+    ASSERT_TRUE(Tcl_GetCommandInfo(interpreter.getInterp(), "traced", &info));
+    EXPECT_EQ(info.proc, lazyCmd);
+
+    // commands are wrapped only while tracing
+    Tracer* tracer = Tracer::Instance();
+    tracer->Enable(0);
+    tracer->Clear();
+    interpreter.traceCmds(true);
+    ASSERT_TRUE(Tcl_GetCommandInfo(interpreter.getInterp(), "traced", &info));
+    EXPECT_NE(info.proc, lazyCmd);
+    EXPECT_EQ(interpreter.evalCmd("traced 1"), "2");
+    EXPECT_NE(tracer->TraceJson().find("\"name\":\"traced\",\"cat\":\"tcl\""),
+              std::string::npos);
+    interpreter.traceCmds(false);
+    tracer->Disable();
+    ASSERT_TRUE(Tcl_GetCommandInfo(interpreter.getInterp(), "traced", &info));
+    EXPECT_EQ(info.proc, lazyCmd);
+    EXPECT_EQ(info.clientData, &deleted);
+    EXPECT_EQ(interpreter.evalCmd("traced 1 2"), "3");
+    EXPECT_EQ(deleted, 0);
+    interpreter.traceCmds(true);
+  }
+  EXPECT_EQ(deleted, 1);
+}
+
 }  // namespace
 }  // namespace FOEDAG
@@ -0,0 +1,143 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextEditor/log_file_index.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+class LogFileIndexTest : public testing::Test {
+ public:
+  void SetUp() override { write("", false); }
+  void TearDown() override {
+    m_index.close();
+    std::filesystem::remove(m_file);
+  }
+
+  void write(const std::string& content, bool append = true) {
+    std::ofstream stream{m_file, append ? std::ios::app : std::ios::trunc};
+    stream << content;
+  }
+
+  std::vector<int> find(const QRegularExpression& regexp) {
+    std::vector<int> lines;
+    std::atomic_bool stop{false};
+    m_index.find(
+        regexp, 0, m_index.lineCount(),
+        [&lines](const std::vector<int>& found) {
+          lines.insert(lines.end(), found.cbegin(), found.cend());
+          return true;
+        },
+        stop, 2);
+    return lines;
+  }
+
+ protected:
+  std::filesystem::path m_file{"log_file_index_test.log"};
+  LogFileIndex m_index;
+  std::atomic_bool m_stop{false};
+};
+
+TEST_F(LogFileIndexTest, Lines) {
+  write("first\nsecond\r\n\nlast");
+  ASSERT_TRUE(m_index.open(QString::fromStdString(m_file.string())));
+  EXPECT_TRUE(m_index.buildIndex(m_stop));
+  EXPECT_TRUE(m_index.indexed());
+  EXPECT_EQ(m_index.lineCount(), 4);
+  EXPECT_EQ(m_index.line(0), "first");
+  EXPECT_EQ(m_index.line(1), "second");
+  EXPECT_EQ(m_index.line(2), "");
+  EXPECT_EQ(m_index.line(3), "last");
+  EXPECT_EQ(m_index.line(4), "");
+}
+
+TEST_F(LogFileIndexTest, EmptyFile) {
+  ASSERT_TRUE(m_index.open(QString::fromStdString(m_file.string())));
+  EXPECT_TRUE(m_index.buildIndex(m_stop));
+  EXPECT_EQ(m_index.lineCount(), 0);
+}
+
+TEST_F(LogFileIndexTest, MissingFile) {
+  QString error;
+  EXPECT_FALSE(m_index.open("missing_log_file_index_test.log", &error));
+  EXPECT_FALSE(error.isEmpty());
+}
+
+TEST_F(LogFileIndexTest, Tail) {
+  write("one\ntw");
+  ASSERT_TRUE(m_index.open(QString::fromStdString(m_file.string())));
+  m_index.buildIndex(m_stop);
+  EXPECT_EQ(m_index.refresh(), LogFileIndex::Update::None);
+  EXPECT_EQ(m_index.lineCount(), 2);
+  EXPECT_EQ(m_index.completeLineCount(), 1);
+
+  write("o\nthree\n");
+  EXPECT_EQ(m_index.refresh(), LogFileIndex::Update::Appended);
+  m_index.buildIndex(m_stop);
+  EXPECT_EQ(m_index.lineCount(), 3);
+  EXPECT_EQ(m_index.line(1), "two");
+  EXPECT_EQ(m_index.line(2), "three");
+
+  // file written again
+  write("new\n", false);
+  EXPECT_EQ(m_index.refresh(), LogFileIndex::Update::Reset);
+  m_index.buildIndex(m_stop);
+  EXPECT_EQ(m_index.lineCount(), 1);
+  EXPECT_EQ(m_index.line(0), "new");
+}
+
+TEST_F(LogFileIndexTest, TruncatedBeforeRefresh) {
+  write("one\ntwo\nthree\n");
+  ASSERT_TRUE(m_index.open(QString::fromStdString(m_file.string())));
+  m_index.buildIndex(m_stop);
+  // indexed lines are gone, reading them must not crash
+  write("", false);
+  EXPECT_EQ(m_index.lineCount(), 3);
+  EXPECT_EQ(m_index.line(2), "");
+  EXPECT_TRUE(find(QRegularExpression{"t"}).empty());
+  EXPECT_EQ(m_index.refresh(), LogFileIndex::Update::Reset);
+  EXPECT_EQ(m_index.lineCount(), 0);
+}
+
+TEST_F(LogFileIndexTest, Find) {
+  write("Error: a\ninfo\nerror: b\nWarning (1)\nError: c\n");
+  ASSERT_TRUE(m_index.open(QString::fromStdString(m_file.string())));
+  m_index.buildIndex(m_stop);
+  EXPECT_EQ(find(QRegularExpression{"Error:"}), (std::vector<int>{0, 4}));
+  EXPECT_EQ(find(QRegularExpression{"error:",
+                                    QRegularExpression::CaseInsensitiveOption}),
+            (std::vector<int>{0, 2, 4}));
+  EXPECT_EQ(find(QRegularExpression{"^[a-z]+$"}), (std::vector<int>{1}));
+  EXPECT_EQ(find(QRegularExpression{
+                QRegularExpression::escape("Warning (1)")}),
+            (std::vector<int>{3}));
+
+  std::atomic_bool stop{true};
+  int calls{0};
+  m_index.find(
+      QRegularExpression{"Error"}, 0, m_index.lineCount(),
+      [&calls](const std::vector<int>&) { return ++calls > 0; }, stop);
+  EXPECT_EQ(calls, 0);
+}
@@ -0,0 +1,107 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextEditor/log_viewer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+#include "TextEditor/text_editor_form.h"
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+class LogViewerTest : public testing::Test {
+ public:
+  void SetUp() override { write("", false); }
+  void TearDown() override { std::filesystem::remove(m_file); }
+
+  void write(const std::string& content, bool append = true) {
+    std::ofstream stream{m_file, append ? std::ios::app : std::ios::trunc};
+    stream << content;
+  }
+
+  // events are processed until \a done returns true or time runs out
+  static bool wait(const std::function<bool()>& done) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!done()) {
+      if (timer.elapsed() > 10000) return false;
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    }
+    return true;
+  }
+
+ protected:
+  std::filesystem::path m_file{"log_viewer_test.log"};
+};
+
+TEST_F(LogViewerTest, SearchFollowsAppend) {
+  write("first needle\nsecond\nthird nee");
+  LogViewer viewer{QString::fromStdString(m_file.string())};
+  ASSERT_TRUE(viewer.fileLoaded());
+  viewer.find("needle", false);
+  ASSERT_TRUE(wait([&viewer]() { return viewer.searchFinished(); }));
+  EXPECT_EQ(viewer.matches(), std::vector<int>({0}));
+
+  // unfinished last line is searched again when it grows
+  write("dle\nfourth needle\n");
+  ASSERT_TRUE(wait([&viewer]() {
+    return viewer.searchFinished() && viewer.matches().size() == 3;
+  }));
+  EXPECT_EQ(viewer.matches(), std::vector<int>({0, 2, 3}));
+}
+
+TEST_F(LogViewerTest, Truncated) {
+  std::string content;
+  for (int i = 0; i < 10000; i++)
+    content += "line " + std::to_string(i) + "\n";
+  write(content);
+  LogViewer viewer{QString::fromStdString(m_file.string())};
+  ASSERT_TRUE(viewer.fileLoaded());
+  viewer.find("line", false);
+  ASSERT_TRUE(wait([&viewer]() { return viewer.searchFinished(); }));
+  EXPECT_EQ(viewer.matches().size(), 10000u);
+
+  // tool started writing the log again
+  write("other\n", false);
+  ASSERT_TRUE(wait([&viewer]() {
+    return viewer.searchFinished() && viewer.matches().empty();
+  }));
+}
+
+TEST_F(LogViewerTest, OpenFailureAddsNoTab) {
+  auto form = TextEditorForm::Instance();
+  form->InitForm();
+  const qint64 threshold = form->LogViewerThreshold();
+  form->SetLogViewerThreshold(0);
+  const std::filesystem::path dir{"log_viewer_test_dir"};
+  std::filesystem::create_directories(dir);
+  const int tabs = form->GetTabWidget()->count();
+  // directory can't be opened as file
+  EXPECT_EQ(form->OpenFile(QString::fromStdString(dir.string())), -1);
+  EXPECT_EQ(form->GetTabWidget()->count(), tabs);
+  form->SetLogViewerThreshold(threshold);
+  std::filesystem::remove(dir);
+}
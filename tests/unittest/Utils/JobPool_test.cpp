@@ -0,0 +1,104 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Utils/JobPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+TEST(JobPool, RunsAllJobs) {
+  JobPool pool{3};
+  std::vector<int> results(10, 0);
+  std::vector<size_t> finished;
+  const auto caller = std::this_thread::get_id();
+  bool sameThread{true};
+  pool.Run(
+      results.size(), [&results](size_t i) { results[i] = int(i) * 2; },
+      [&](size_t i) {
+        sameThread = sameThread && (std::this_thread::get_id() == caller);
+        finished.push_back(i);
+      });
+  EXPECT_TRUE(sameThread);
+  ASSERT_EQ(finished.size(), results.size());
+  std::sort(finished.begin(), finished.end());
+  for (size_t i = 0; i < results.size(); i++) {
+    EXPECT_EQ(finished[i], i);
+    EXPECT_EQ(results[i], int(i) * 2);
+  }
+}
+
+TEST(JobPool, Empty) {
+  JobPool pool;
+  size_t calls{0};
+  pool.Run(
+      0, [&calls](size_t) { calls++; }, [&calls](size_t) { calls++; });
+  pool.Run(JobPool::Groups{}, [&calls](size_t) { calls++; });
+  EXPECT_EQ(calls, 0);
+}
+
+TEST(JobPool, GroupRunsInOrder) {
+  JobPool pool{4};
+  std::mutex lock;
+  std::vector<size_t> order;
+  // 0, 2 and 4 depend on each other, the rest is independent
+  JobPool::Groups groups{{4, 0, 2}, {1}, {3}, {5}};
+  pool.Run(groups, [&](size_t i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::scoped_lock guard{lock};
+    order.push_back(i);
+  });
+  ASSERT_EQ(order.size(), 6);
+  auto pos = [&order](size_t i) {
+    return std::find(order.begin(), order.end(), i) - order.begin();
+  };
+  EXPECT_LT(pos(4), pos(0));
+  EXPECT_LT(pos(0), pos(2));
+}
+
+TEST(JobPool, StopSkipsPendingJobs) {
+  JobPool pool{1};
+  size_t started{0};
+  size_t finished{0};
+  pool.Run(
+      5,
+      [&](size_t) {
+        started++;
+        // running job sees the flag and finishes by itself
+        JobPool::StopAll();
+        EXPECT_TRUE(pool.Stopped());
+      },
+      [&finished](size_t) { finished++; });
+  EXPECT_EQ(started, 1);
+  EXPECT_EQ(finished, 5);
+
+  // next run starts again
+  started = 0;
+  pool.Run(3, [&started](size_t) { started++; });
+  EXPECT_EQ(started, 3);
+  EXPECT_FALSE(pool.Stopped());
+}
@@ -0,0 +1,83 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Utils/StartupProfiler.h"
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+class StartupProfilerTest : public testing::Test {
+ public:
+  void SetUp() override { StartupProfiler::Instance()->Clear(); }
+  void TearDown() override {
+    StartupProfiler::Instance()->Disable();
+    StartupProfiler::Instance()->Clear();
+  }
+};
+
+TEST_F(StartupProfilerTest, Disabled) {
+  auto profiler = StartupProfiler::Instance();
+  profiler->Disable();
+  { StartupScope scope{"disabled"}; }
+  EXPECT_EQ(profiler->TraceJson().find("disabled"), std::string::npos);
+  // time to prompt is known even without trace
+  profiler->Prompt();
+  EXPECT_GE(profiler->TimeToPrompt(), 0);
+}
+
+TEST_F(StartupProfilerTest, ChromeTrace) {
+  auto profiler = StartupProfiler::Instance();
+  profiler->Enable({});
+  {
+    StartupScope outer{"outer"};
+    StartupScope inner{"inner \"quoted\"", "lazy"};
+    TraceScope span{"span", "tcl"};
+  }
+  profiler->Mark("marker");
+  const std::string json = profiler->TraceJson();
+  EXPECT_EQ(json.find("{\"traceEvents\":["), 0u);
+  EXPECT_NE(json.find("\"name\":\"outer\",\"cat\":\"startup\",\"ph\":\"X\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"inner \\\"quoted\\\"\",\"cat\":\"lazy\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"marker\",\"cat\":\"startup\",\"ph\":\"i\""),
+            std::string::npos);
+  // other spans share the trace
+  EXPECT_NE(json.find("\"name\":\"span\",\"cat\":\"tcl\""), std::string::npos);
+}
+
+TEST_F(StartupProfilerTest, PromptWritesTrace) {
+  const std::filesystem::path file{"startup_profiler_test.json"};
+  std::filesystem::remove(file);
+  auto profiler = StartupProfiler::Instance();
+  profiler->Enable(file);
+  { StartupScope scope{"phase"}; }
+  profiler->Prompt();
+  const int64_t timeToPrompt = profiler->TimeToPrompt();
+  EXPECT_GT(timeToPrompt, 0);
+  EXPECT_TRUE(std::filesystem::exists(file));
+  EXPECT_FALSE(Tracer::Instance()->Enabled());
+  // only first prompt counts
+  profiler->Prompt();
+  EXPECT_EQ(profiler->TimeToPrompt(), timeToPrompt);
+  std::filesystem::remove(file);
+}
@@ -0,0 +1,169 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Utils/Tracer.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nlohmann_json/json.hpp"
+
+using namespace FOEDAG;
+using json = nlohmann::json;
+
+class TracerTest : public testing::Test {
+ public:
+  void SetUp() override { Tracer::Instance()->Clear(); }
+  void TearDown() override {
+    Tracer::Instance()->Disable();
+    Tracer::Instance()->Clear();
+  }
+
+  static json events(const std::string& name) {
+    json result = json::array();
+    json trace = json::parse(Tracer::Instance()->TraceJson());
+    for (const auto& event : trace["traceEvents"])
+      if (event["name"] == name) result.push_back(event);
+    return result;
+  }
+};
+
+TEST_F(TracerTest, Disabled) {
+  auto tracer = Tracer::Instance();
+  { TraceScope scope{"disabled"}; }
+  tracer->Counter("disabled", 1);
+  EXPECT_EQ(tracer->EventCount(), 0u);
+}
+
+TEST_F(TracerTest, NestedSpans) {
+  auto tracer = Tracer::Instance();
+  tracer->Enable(0);
+  {
+    TraceScope outer{"outer", "test"};
+    TraceScope inner{std::string{"inner \"quoted\""}, "test"};
+    tracer->Instant("marker");
+  }
+  tracer->Counter("items", 42);
+  auto outer = events("outer");
+  auto inner = events("inner \"quoted\"");
+  ASSERT_EQ(outer.size(), 1u);
+  ASSERT_EQ(inner.size(), 1u);
+  EXPECT_EQ(outer[0]["ph"], "X");
+  EXPECT_EQ(outer[0]["cat"], "test");
+  EXPECT_EQ(outer[0]["tid"], inner[0]["tid"]);
+  // inner span lies within the outer one
+  EXPECT_GE(inner[0]["ts"].get<int64_t>(), outer[0]["ts"].get<int64_t>());
+  EXPECT_LE(inner[0]["ts"].get<int64_t>() + inner[0]["dur"].get<int64_t>(),
+            outer[0]["ts"].get<int64_t>() + outer[0]["dur"].get<int64_t>());
+  ASSERT_EQ(events("marker").size(), 1u);
+  EXPECT_EQ(events("marker")[0]["ph"], "i");
+  ASSERT_EQ(events("items").size(), 1u);
+  EXPECT_EQ(events("items")[0]["args"]["value"], 42);
+}
+
+TEST_F(TracerTest, ThreadsAndDumpWhileRecording) {
+  auto tracer = Tracer::Instance();
+  tracer->Enable(0);
+  constexpr int Threads{4};
+  constexpr int Spans{5000};  // more than one buffer chunk
+  std::vector<std::thread> threads;
+  for (int i = 0; i < Threads; i++) {
+    threads.emplace_back([]() {
+      for (int j = 0; j < Spans; j++) TraceScope scope{"span"};
+    });
+  }
+  // reader runs concurrently with writers
+  for (int i = 0; i < 10; i++)
+    EXPECT_TRUE(json::parse(tracer->TraceJson())["traceEvents"].is_array());
+  for (auto& thread : threads) thread.join();
+  auto spans = events("span");
+  EXPECT_EQ(spans.size(), size_t{Threads * Spans});
+  EXPECT_EQ(tracer->Dropped(), 0u);
+}
+
+TEST_F(TracerTest, ChildProcess) {
+  auto tracer = Tracer::Instance();
+  tracer->Enable(0);
+  tracer->Process(12345, "/usr/bin/vpr design.blif --route", 10, 20, 0, 512);
+  auto processes = events("vpr");
+  ASSERT_EQ(processes.size(), 1u);
+  EXPECT_EQ(processes[0]["pid"], 12345);
+  EXPECT_EQ(processes[0]["dur"], 20);
+  EXPECT_EQ(processes[0]["args"]["command"],
+            "/usr/bin/vpr design.blif --route");
+  EXPECT_EQ(processes[0]["args"]["peak_rss_kib"], 512);
+  auto names = events("process_name");
+  ASSERT_EQ(names.size(), 1u);
+  EXPECT_EQ(names[0]["args"]["name"], "vpr");
+}
+
+TEST_F(TracerTest, Clear) {
+  auto tracer = Tracer::Instance();
+  tracer->Enable(0);
+  { TraceScope scope{"before"}; }
+  tracer->Clear();
+  { TraceScope scope{"after"}; }
+  EXPECT_EQ(tracer->EventCount(), 1u);
+  EXPECT_TRUE(events("before").empty());
+  EXPECT_EQ(events("after").size(), 1u);
+}
+
+TEST_F(TracerTest, ClearFreesChunks) {
+  auto tracer = Tracer::Instance();
+  tracer->Enable(0);
+  std::thread thread{[tracer]() {
+    for (int i = 0; i < 5000; i++) TraceScope scope{"before"};
+    tracer->Clear();
+    for (int i = 0; i < 3000; i++) TraceScope scope{"after"};
+  }};
+  thread.join();
+  EXPECT_EQ(tracer->EventCount(), 3000u);
+  EXPECT_TRUE(events("before").empty());
+  EXPECT_EQ(events("after").size(), 3000u);
+  tracer->Clear();
+  EXPECT_EQ(tracer->EventCount(), 0u);
+}
+
+TEST_F(TracerTest, ExitedThreadBufferReused) {
+  auto tracer = Tracer::Instance();
+  tracer->Enable(0);
+  std::thread{[]() { TraceScope scope{"first"}; }}.join();
+  std::thread{[]() { TraceScope scope{"second"}; }}.join();
+  auto first = events("first");
+  auto second = events("second");
+  ASSERT_EQ(first.size(), 1u);
+  ASSERT_EQ(second.size(), 1u);
+  EXPECT_EQ(first[0]["tid"], second[0]["tid"]);
+}
+
+#ifdef __linux__
+TEST_F(TracerTest, MemorySamples) {
+  auto tracer = Tracer::Instance();
+  tracer->Enable(5);
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  tracer->Disable();
+  auto samples = events("rss_kib");
+  EXPECT_GE(samples.size(), 2u);
+  for (const auto& sample : samples)
+    EXPECT_GT(sample["args"]["value"].get<int64_t>(), 0);
+}
+#endif
@@ -0,0 +1,267 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Utils/ZipArchive.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+namespace fs = std::filesystem;
+
+class ZipArchiveTest : public testing::Test {
+ public:
+  void SetUp() override {
+    fs::remove_all(m_dir);
+    fs::create_directories(m_dir);
+  }
+  void TearDown() override { fs::remove_all(m_dir); }
+
+  static void write(const fs::path& file, const std::string& content) {
+    fs::create_directories(file.parent_path());
+    std::ofstream stream{file, std::ios::binary | std::ios::trunc};
+    stream << content;
+  }
+  static std::string content(const fs::path& file) {
+    std::ifstream stream{file, std::ios::binary};
+    return {std::istreambuf_iterator<char>{stream},
+            std::istreambuf_iterator<char>{}};
+  }
+  // compressible text mixed with random bytes
+  static std::string data(size_t size, unsigned seed) {
+    std::mt19937 random{seed};
+    std::string text;
+    text.reserve(size);
+    while (text.size() < size) {
+      if (random() % 4 == 0) {
+        for (int i = 0; i < 64; i++)
+          text.push_back(static_cast<char>(random() & 0xff));
+      } else {
+        text += "net_" + std::to_string(random() % 1000) + " clb_" +
+                std::to_string(random() % 100) + "\n";
+      }
+    }
+    text.resize(size);
+    return text;
+  }
+
+ protected:
+  fs::path m_dir{fs::absolute("zip_archive_test")};
+};
+
+TEST_F(ZipArchiveTest, CompressExtract) {
+  const fs::path project{m_dir / "project"};
+  const std::string large = data(ZipArchive::ChunkSize * 2 + 12345, 1);
+  write(project / "top.v", "module top; endmodule\n");
+  write(project / "run_1" / "synth_1_1" / "large.log", large);
+  write(project / "run_1" / "empty.txt", "");
+  // incompressible, stored
+  std::string noise;
+  std::mt19937 random{2};
+  for (int i = 0; i < 1000; i++)
+    noise.push_back(static_cast<char>(random() & 0xff));
+  write(project / "run_1" / "random.bin", noise);
+  fs::create_directories(project / "empty_dir");
+  write(project / "run.sh", "#!/bin/sh\n");
+  fs::permissions(project / "run.sh", fs::perms::owner_exec,
+                  fs::perm_options::add);
+  write(m_dir / "extra.txt", "extra");
+
+  const fs::path archive{m_dir / "project.zip"};
+  std::string error;
+  ASSERT_TRUE(ZipArchive::Compress(archive, {project, m_dir / "extra.txt"}, {},
+                                   4, &error))
+      << error;
+  const fs::path out{m_dir / "out"};
+  ASSERT_TRUE(ZipArchive::Extract(archive, out, 4, &error)) << error;
+  EXPECT_EQ(content(out / "project" / "top.v"), "module top; endmodule\n");
+  EXPECT_EQ(content(out / "project" / "run_1" / "synth_1_1" / "large.log"),
+            large);
+  EXPECT_TRUE(fs::exists(out / "project" / "run_1" / "empty.txt"));
+  EXPECT_EQ(fs::file_size(out / "project" / "run_1" / "empty.txt"), 0);
+  EXPECT_EQ(content(out / "project" / "run_1" / "random.bin"), noise);
+  EXPECT_TRUE(fs::is_directory(out / "project" / "empty_dir"));
+  EXPECT_EQ(content(out / "extra.txt"), "extra");
+#ifndef _WIN32
+  EXPECT_NE(fs::status(out / "project" / "run.sh").permissions() &
+                fs::perms::owner_exec,
+            fs::perms::none);
+  // archive is readable by other tools
+  if (std::system("unzip -v > /dev/null 2>&1") == 0) {
+    const std::string command = "unzip -tqq " + archive.string();
+    EXPECT_EQ(std::system(command.c_str()), 0);
+  }
+#endif
+}
+
+TEST_F(ZipArchiveTest, Policy) {
+  const fs::path project{m_dir / "project"};
+  write(project / "top.v", "module top; endmodule\n");
+  write(project / "run_1" / "top.net", "net");
+  write(project / "run_1" / "top.place", "place");
+  write(project / "run_1" / "top.route", "route");
+  write(project / "run_1" / "rr_graph.xml", "graph");
+  write(project / "run_1" / "rr_graph_1.bin", "graph");
+  // names are matched as a whole
+  write(project / "rtl" / "rr_graph_ctrl.v", "module ctrl; endmodule\n");
+  write(project / "run_1" / "top_post_synth.v", "module top; endmodule\n");
+  // archive written into the archived directory is not archived
+  const fs::path archive{project / "project.zip"};
+  std::string error;
+  ASSERT_TRUE(ZipArchive::Compress(archive, {project},
+                                   ArchivePolicy::WithoutArtifacts(), 0,
+                                   &error))
+      << error;
+  const fs::path out{m_dir / "out"};
+  ASSERT_TRUE(ZipArchive::Extract(archive, out, 0, &error)) << error;
+  EXPECT_TRUE(fs::exists(out / "project" / "top.v"));
+  EXPECT_TRUE(fs::exists(out / "project" / "run_1" / "top_post_synth.v"));
+  EXPECT_FALSE(fs::exists(out / "project" / "project.zip"));
+  EXPECT_FALSE(fs::exists(out / "project" / "run_1" / "top.net"));
+  EXPECT_FALSE(fs::exists(out / "project" / "run_1" / "top.place"));
+  EXPECT_FALSE(fs::exists(out / "project" / "run_1" / "top.route"));
+  EXPECT_FALSE(fs::exists(out / "project" / "run_1" / "rr_graph.xml"));
+  EXPECT_FALSE(fs::exists(out / "project" / "run_1" / "rr_graph_1.bin"));
+  EXPECT_TRUE(fs::exists(out / "project" / "rtl" / "rr_graph_ctrl.v"));
+}
+
+TEST(ArchivePolicy, Excluded) {
+  const ArchivePolicy policy{{".log"}, {"build", "*.tmp", "run_?", "a*b*c"}};
+  EXPECT_TRUE(policy.Excluded("dir/top.log"));
+  EXPECT_TRUE(policy.Excluded("dir/build"));
+  EXPECT_FALSE(policy.Excluded("dir/build_1"));
+  EXPECT_FALSE(policy.Excluded("build/top.v"));
+  EXPECT_TRUE(policy.Excluded("top.v.tmp"));
+  EXPECT_FALSE(policy.Excluded("top.tmp.v"));
+  EXPECT_TRUE(policy.Excluded("run_1"));
+  EXPECT_FALSE(policy.Excluded("run_12"));
+  EXPECT_TRUE(policy.Excluded("abbcbc"));
+  EXPECT_FALSE(policy.Excluded("abcb"));
+}
+
+TEST_F(ZipArchiveTest, Errors) {
+  std::string error;
+  EXPECT_FALSE(ZipArchive::Compress(m_dir / "a.zip", {m_dir / "missing"}, {},
+                                    0, &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(fs::exists(m_dir / "a.zip"));
+
+  write(m_dir / "broken.zip", "not a zip archive");
+  error.clear();
+  EXPECT_FALSE(ZipArchive::Extract(m_dir / "broken.zip", m_dir / "out", 0,
+                                   &error));
+  EXPECT_FALSE(error.empty());
+
+  // archive with stored entry ../evil.txt
+  const std::string name{"../evil.txt"};
+  std::string zip;
+  auto put = [&zip](uint32_t value, int size) {
+    for (int i = 0; i < size; i++) zip.push_back((value >> (8 * i)) & 0xff);
+  };
+  put(0x04034b50, 4);
+  put(20, 2);
+  put(0, 2);  // flags
+  put(0, 2);  // stored
+  put(0, 4);  // time and date
+  put(0, 4);  // crc of empty data
+  put(0, 4);
+  put(0, 4);
+  put(name.size(), 2);
+  put(0, 2);
+  zip += name;
+  const size_t directory = zip.size();
+  put(0x02014b50, 4);
+  put(20, 2);
+  put(20, 2);
+  for (int i = 0; i < 4; i++) put(0, 2);  // flags, method, time, date
+  for (int i = 0; i < 3; i++) put(0, 4);  // crc, sizes
+  put(name.size(), 2);
+  for (int i = 0; i < 4; i++) put(0, 2);  // extra, comment, disk, internal
+  put(0, 4);                              // external attributes
+  put(0, 4);                              // offset
+  zip += name;
+  const size_t directorySize = zip.size() - directory;
+  put(0x06054b50, 4);
+  put(0, 4);
+  put(1, 2);
+  put(1, 2);
+  put(directorySize, 4);
+  put(directory, 4);
+  put(0, 2);
+  write(m_dir / "evil.zip", zip);
+  error.clear();
+  EXPECT_FALSE(ZipArchive::Extract(m_dir / "evil.zip", m_dir / "out" / "dir",
+                                   0, &error));
+  EXPECT_NE(error.find("../evil.txt"), std::string::npos);
+  EXPECT_FALSE(fs::exists(m_dir / "out" / "evil.txt"));
+}
+
+#ifndef _WIN32
+// run with --gtest_also_run_disabled_tests
+TEST_F(ZipArchiveTest, DISABLED_Benchmark) {
+  // run directory like tree, many small reports and few large files
+  const fs::path project{m_dir / "project"};
+  for (int i = 0; i < 400; i++)
+    write(project / "run_1" / ("dir" + std::to_string(i % 20)) /
+              ("report" + std::to_string(i) + ".rpt"),
+          data(64 * 1024, i));
+  for (int i = 0; i < 4; i++)
+    write(project / "run_1" / ("netlist" + std::to_string(i) + ".v"),
+          data(96 << 20, 1000 + i));
+
+  auto measure = [](const std::function<bool()>& run) {
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(run());
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+  if (std::system("zip -v > /dev/null 2>&1") == 0) {
+    const std::string command = "cd " + m_dir.string() +
+                                " && zip -qr external.zip project";
+    const auto time = measure([&command]() {
+      return std::system(command.c_str()) == 0;
+    });
+    std::cout << "zip: " << time << " ms, "
+              << fs::file_size(m_dir / "external.zip") << " bytes"
+              << std::endl;
+  }
+  for (unsigned threads : {1u, 0u}) {
+    const fs::path archive{m_dir / "internal.zip"};
+    const auto time = measure([&archive, &project, threads]() {
+      return ZipArchive::Compress(archive, {project}, {}, threads);
+    });
+    std::cout << "ZipArchive, " << (threads ? "1 thread" : "all threads")
+              << ": " << time << " ms, " << fs::file_size(archive) << " bytes"
+              << std::endl;
+  }
+  const auto time = measure([this]() {
+    return ZipArchive::Extract(m_dir / "internal.zip", m_dir / "out");
+  });
+  std::cout << "extract: " << time << " ms" << std::endl;
+}
+#endif